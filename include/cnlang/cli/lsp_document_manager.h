@@ -31,13 +31,23 @@ bool cn_lsp_document_open(
     const char *text,
     size_t length);
 
-// 文档内容变更（当前实现等价于重新加载全文）
+// 文档内容变更（全量同步：等价于重新加载全文）
 bool cn_lsp_document_change(
     CnLspDocumentManager *manager,
     const char *uri,
     const char *text,
     size_t length);
 
+// 文档增量变更（增量同步）：将 range（LSP 行列，列按 UTF-16 计）覆盖的文本替换为 text
+// 行首索引按编辑区间增量更新，然后重新分析文档
+// 返回：true 表示成功；文档未打开或范围非法时返回 false，文档保持不变
+bool cn_lsp_document_apply_edit(
+    CnLspDocumentManager *manager,
+    const char *uri,
+    CnLspRange range,
+    const char *text,
+    size_t length);
+
 // 关闭文档并释放其缓存
 bool cn_lsp_document_close(
     CnLspDocumentManager *manager,
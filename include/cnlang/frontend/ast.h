@@ -43,7 +43,9 @@ typedef enum CnAstExprKind {
     // 泛型编程支持（阶段13 - 模板支持）
     CN_AST_EXPR_TEMPLATE_INSTANTIATION,  // 模板实例化 名称<类型参数>
     // 类型转换表达式
-    CN_AST_EXPR_CAST            // 类型转换表达式 (类型)表达式
+    CN_AST_EXPR_CAST,           // 类型转换表达式 (类型)表达式
+    // 编译时资源嵌入
+    CN_AST_EXPR_EMBED           // 嵌入文件内容 嵌入("路径")
 } CnAstExprKind;
 
 // AST 节点种类（语句）
@@ -131,6 +133,7 @@ typedef struct CnAstVarDecl {
     const char *name;
     size_t name_length;
     struct CnType *declared_type;  // 显式声明的类型，如果是"变量"则为 NULL 或特定类型
+    struct CnType *source_type;    // 源码中写出的类型（declared_type 会被语义分析改写为解析或推断后的类型）
     struct CnAstExpr *initializer; // 可以为 NULL
     CnVisibility visibility;       // 可见性（用于模块成员）
     int is_const;                  // 是否为常量声明（使用"常量"关键字）
@@ -443,6 +446,9 @@ typedef struct CnAstParameter {
     int is_const;                 // 是否为常量参数（使用"常量"关键字）
 } CnAstParameter;
 
+// 跳读模式下尚未解析的函数体（结构由解析器私有，见 cn_frontend_parse_function_body）
+typedef struct CnAstLazyBody CnAstLazyBody;
+
 // 函数声明
 typedef struct CnAstFunctionDecl {
     const char *name;
@@ -458,6 +464,7 @@ typedef struct CnAstFunctionDecl {
     int is_override;              // 是否为重写函数（使用"重写"关键字）
     int is_static;                // 是否为静态方法（使用"静态"关键字）
     struct CnSemScope *owning_scope;  // 函数作用域（由 scope_builder 创建，包含参数和局部变量符号）
+    CnAstLazyBody *lazy_body;     // 跳读模式下待解析的函数体词元（非NULL时 body 尚未解析）
 } CnAstFunctionDecl;
 
 // 程序根节点
@@ -482,6 +489,11 @@ typedef struct CnAstProgram {
     struct CnAstStmt **template_funcs; // 模板函数声明列表
     size_t template_struct_count; // 模板结构体数量
     struct CnAstStmt **template_structs; // 模板结构体声明列表
+    // 解析器创建的程序：所有节点、子数组与字符串副本都分配在 arena 中，随程序一次性释放
+    struct CnArena *arena;        // 节点 Arena（手工构造的程序为 NULL，按节点逐个释放）
+    struct CnSemScope **owned_scopes; // 挂在节点上的作用域（arena 模式下由程序统一释放）
+    size_t owned_scope_count;
+    size_t owned_scope_capacity;
 } CnAstProgram;
 
 // 各种表达式节点定义
@@ -500,6 +512,10 @@ typedef struct CnAstCallExpr {
 typedef struct CnAstIdentifierExpr {
     const char *name;
     size_t name_length;
+    // 名字查找缓存（见 cn_sem_scope_lookup_identifier），symbol_scope_id 为 0 表示尚未缓存
+    struct CnSemSymbol *symbol;   // 解析得到的符号（未找到时为 NULL）
+    uint32_t symbol_scope_id;     // 查找起点作用域的编号
+    uint32_t symbol_stamp;        // 查找时的作用域时间戳
 } CnAstIdentifierExpr;
 
 typedef struct CnAstIntegerLiteralExpr {
@@ -646,13 +662,27 @@ typedef struct CnAstCastExpr {
     struct CnAstExpr *operand;       // 要转换的表达式
 } CnAstCastExpr;
 
+// 嵌入资源表达式 嵌入("路径")，用作全局字符数组的初始值
+// 解析器只记录路径，文件内容在语义分析时经模块加载器的搜索路径定位，
+// 由共享源文件管理器读入（不经过词法与语法分析），节点只引用不持有
+#define CN_AST_EMBED_NAME "嵌入"
+
+typedef struct CnAstEmbedExpr {
+    const char *path;                // 资源路径（相对引用方源文件或模块搜索路径）
+    size_t path_length;
+    const unsigned char *data;       // 文件内容（语义分析填充，未解析时为 NULL）
+    size_t size;                     // 文件字节数
+} CnAstEmbedExpr;
+
 // 表达式统一节点
+// 解析器按种类分配节点，只包含公共头部与该种类的联合体成员（见 cn_frontend_ast_expr_node_size），
+// 因此节点分配后不能改变 kind，也不能按值复制整个节点
 typedef struct CnAstExpr {
     CnAstExprKind kind;
+    uint8_t is_this_pointer;  // 标记是否为自身指针（this/self），用于语义检查和代码生成
+    uint8_t is_base_pointer;  // 标记是否为基类指针（base），用于语义检查和代码生成
     struct CnType *type; // 语义分析阶段填充的类型信息
     CnSourceLocation loc; // 源位置信息
-    int is_this_pointer;  // 标记是否为自身指针（this/self），用于语义检查和代码生成
-    int is_base_pointer;  // 标记是否为基类指针（base），用于语义检查和代码生成
     union {
         CnAstBinaryExpr binary;
         CnAstCallExpr call;
@@ -679,6 +709,7 @@ typedef struct CnAstExpr {
         CnAstInlineAsmExpr inline_asm;     // 内联汇编
         CnAstTemplateInstantiationExpr template_inst; // 模板实例化
         CnAstCastExpr cast;                // 类型转换
+        CnAstEmbedExpr embed;              // 嵌入资源
     } as;
 } CnAstExpr;
 
@@ -686,7 +717,7 @@ typedef struct CnAstExpr {
 struct CnAstClassDecl;
 struct CnAstInterfaceDecl;
 
-// 语句统一节点
+// 语句统一节点（与表达式相同，按种类分配，见 cn_frontend_ast_stmt_node_size）
 typedef struct CnAstStmt {
     CnAstStmtKind kind;
     CnSourceLocation loc; // 源位置信息
@@ -715,13 +746,65 @@ typedef struct CnAstStmt {
     } as;
 } CnAstStmt;
 
-// 内存管理接口，仅负责释放由解析器创建的 AST
+// 内存管理接口
+// 解析器创建的程序（arena 非 NULL）释放时不遍历节点，直接释放整个 Arena；
+// 其余释放函数只用于 malloc 逐个构造的节点，不能用于 Arena 中的节点
 void cn_frontend_ast_program_free(CnAstProgram *program);
+
+/*
+ * 登记挂在程序节点上的作用域（owning_scope），由程序释放时统一释放
+ * 程序不使用 Arena 时作用域仍随节点释放，此时不登记
+ * @return 成功返回 1，内存不足返回 0（作用域未登记）
+ */
+int cn_frontend_ast_program_adopt_scope(CnAstProgram *program, struct CnSemScope *scope);
+
 void cn_frontend_ast_function_free(CnAstFunctionDecl *function_decl);
 void cn_frontend_ast_block_free(CnAstBlockStmt *block);
 void cn_frontend_ast_stmt_free(CnAstStmt *stmt);
 void cn_frontend_ast_expr_free(CnAstExpr *expr);
 
+// 节点按种类分配的字节数：公共头部加上该种类使用的联合体成员
+size_t cn_frontend_ast_expr_node_size(CnAstExprKind kind);
+size_t cn_frontend_ast_stmt_node_size(CnAstStmtKind kind);
+
+/*
+ * 左结合运算链：a + b + ... 或 p && q && ... 沿左操作数形成与项数等深的链，
+ * 遍历器先循环收集链上的运算节点，再自底向上逐个处理，递归深度只取决于右操作数
+ */
+typedef struct CnAstExprChain {
+    CnAstExpr **nodes;               // nodes[0] 为链顶，nodes[count - 1] 为最底层的运算节点
+    size_t count;
+    size_t capacity;
+    CnAstExpr *inline_nodes[16];     // 短链不分配堆内存
+} CnAstExprChain;
+
+// 从 expr 起沿左操作数收集与 expr 同种类（二元或逻辑表达式）的运算节点；内存不足返回 0
+int cn_frontend_ast_expr_chain_collect(CnAstExprChain *chain, CnAstExpr *expr);
+// 链底：最底层运算节点的左操作数
+CnAstExpr *cn_frontend_ast_expr_chain_leaf(const CnAstExprChain *chain);
+// nodes[index] 的右操作数
+CnAstExpr *cn_frontend_ast_expr_chain_right(const CnAstExprChain *chain, size_t index);
+void cn_frontend_ast_expr_chain_free(CnAstExprChain *chain);
+
+// "否则 如果" 解析为只含一条如果语句的否则块；返回该如果语句，else 分支不是这种形式时返回 NULL
+CnAstStmt *cn_frontend_ast_else_if(const CnAstIfStmt *if_stmt);
+
+// 常量字面量：整数/浮点/字符/布尔/字符串字面量、数值字面量取负，以及字段全为此类值的结构体字面量
+int cn_frontend_ast_is_constant_literal(const CnAstExpr *expr);
+// 元素全部为常量字面量的非空数组字面量（大型查找表等），可整体打包，不必逐元素处理
+int cn_frontend_ast_array_literal_is_constant(const CnAstExpr *expr);
+
+// 把子树中所有源位置的行号平移 line_delta（列号不变），供增量解析复用编辑点之后的声明
+void cn_frontend_ast_function_shift_lines(CnAstFunctionDecl *function_decl, int line_delta);
+void cn_frontend_ast_stmt_shift_lines(CnAstStmt *stmt, int line_delta);
+
+/*
+ * 清除语义分析写入节点的信息，使程序可以再次分析：
+ * 释放挂在节点上的作用域，清空表达式类型（解析器给出的字面量与类型转换类型除外），
+ * 变量声明类型恢复为源码中写出的类型，并清除类型对象上记录的结构体字段与声明作用域
+ */
+void cn_frontend_ast_program_reset_semantics(CnAstProgram *program);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,86 @@
+#ifndef CN_FRONTEND_AST_CACHE_H
+#define CN_FRONTEND_AST_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "cnlang/frontend/ast.h"
+
+/*
+ * CN Language 二进制 AST 缓存
+ * 把解析得到的 CnAstProgram 序列化为可重定位的映像：节点之间以映像内偏移
+ * 互相引用，不含任何指针，可以直接内存映射后读取。缓存文件按
+ * （编译器版本 + 源码内容）的哈希命名，导入模块命中缓存时跳过预处理与语法分析，
+ * 从映像重建的 AST 与解析器产出的 AST 完全一致（名字同样驻留在全局字符串池）。
+ *
+ * 包含类或接口声明的模块不写入缓存（其成员结构由 class_node 单独管理）。
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 映像格式版本，节点编码变化时递增
+#define CN_AST_CACHE_FORMAT_VERSION 3
+
+// 缓存键：编译器版本与源码内容的 64 位哈希
+uint64_t cn_ast_cache_key(const char *source, size_t length);
+
+// =============================================================================
+// 映像编解码
+// =============================================================================
+
+/*
+ * 把程序序列化为映像
+ * @param program 解析器产出的程序（尚未经过作用域构建）
+ * @param source_key 源码的缓存键（写入文件头用于校验）
+ * @param source_length 源码长度
+ * @param out_size 输出映像字节数
+ * @return malloc 分配的映像，程序含类/接口声明、尚未解析的跳读函数体或内存不足时返回 NULL
+ */
+void *cn_ast_cache_serialize(const CnAstProgram *program, uint64_t source_key,
+                             size_t source_length, size_t *out_size);
+
+/*
+ * 从映像重建程序，节点分配在新程序自己的 Arena 中，映像可在返回后释放
+ * @param data 映像（可以是只读内存映射，无对齐要求）
+ * @param size 映像字节数
+ * @param source_key 期望的缓存键
+ * @param source_length 期望的源码长度
+ * @param filename 重建节点源位置使用的文件名（需在程序使用期间保持有效）
+ * @return 程序，映像损坏、版本或键不匹配时返回 NULL
+ */
+CnAstProgram *cn_ast_cache_deserialize(const void *data, size_t size, uint64_t source_key,
+                                       size_t source_length, const char *filename);
+
+// =============================================================================
+// 缓存目录
+// =============================================================================
+
+/*
+ * 设置缓存目录（不存在时创建），NULL 或空串关闭缓存
+ * @return 目录可用返回 true
+ */
+bool cn_ast_cache_set_directory(const char *directory);
+
+// 当前缓存目录，未启用返回 NULL
+const char *cn_ast_cache_get_directory(void);
+
+/*
+ * 按源码内容查找缓存（缓存文件经共享源文件管理器映射）
+ * @return 命中返回重建的程序，未启用、未命中或缓存无效返回 NULL
+ */
+CnAstProgram *cn_ast_cache_load(const char *source, size_t length, const char *filename);
+
+/*
+ * 把程序写入缓存（先写临时文件再改名，并发编译不会读到半个文件）
+ * @return 写入成功返回 true；未启用缓存或程序不可缓存返回 false
+ */
+bool cn_ast_cache_store(const char *source, size_t length, const CnAstProgram *program);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CN_FRONTEND_AST_CACHE_H */
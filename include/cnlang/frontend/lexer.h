@@ -3,6 +3,7 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "cnlang/frontend/token.h"
 
@@ -20,12 +21,92 @@ typedef struct CnLexer {
     int line;
     int column;
     struct CnDiagnostics *diagnostics;
+    // 是否逐字节维护 line/column（整文件预词法化时关闭，行列改为按需计算）
+    bool track_positions;
+    // 关闭逐字节跟踪时，按需计算行列所用的扫描起点缓存
+    size_t position_hint_offset;
+    size_t position_hint_line_start;
+    int position_hint_line;
 } CnLexer;
 
 void cn_frontend_lexer_init(CnLexer *lexer, const char *source, size_t length, const char *filename);
 bool cn_frontend_lexer_next_token(CnLexer *lexer, CnToken *out_token);
 void cn_frontend_lexer_set_diagnostics(CnLexer *lexer, struct CnDiagnostics *diagnostics);
 
+// 空白/注释/字符串扫描所用的实现级别（运行时按 CPU 能力选择）
+typedef enum CnLexerScanLevel {
+    CN_LEXER_SCAN_SCALAR = 0,   // 逐字节标量实现
+    CN_LEXER_SCAN_SSE2 = 1,     // 16 字节步长
+    CN_LEXER_SCAN_AVX2 = 2      // 32 字节步长
+} CnLexerScanLevel;
+
+CnLexerScanLevel cn_frontend_lexer_scan_level(void);
+// 限制扫描实现不高于 level（用于测试与基准对比），返回实际生效的级别
+CnLexerScanLevel cn_frontend_lexer_set_scan_level(CnLexerScanLevel level);
+
+/*
+ * 整文件预词法化的词元流（结构数组布局）
+ *
+ * 一次性将整个缓冲区切分为并行数组（种类、偏移、长度、后缀），
+ * 解析器可直接按下标访问，获得任意前瞻与廉价回溯。
+ * 行列号不在词法分析时逐字节维护，而是在需要时通过行首偏移表
+ * 二分查找得到（行首表在第一次查询位置时构建）。
+ */
+typedef struct CnTokenStream {
+    const char *source;
+    const char *filename;
+    size_t length;
+    size_t count;             // 词元数量（末尾总是一个 EOF 词元）
+    size_t capacity;
+    uint8_t *kinds;           // CnTokenKind
+    uint32_t *offsets;        // 词素起始偏移
+    uint32_t *lengths;        // 词素长度
+    uint8_t *suffixes;        // 数字字面量后缀（同 CnToken.number_suffix）
+    size_t *line_starts;      // 行首偏移表（按需构建）
+    size_t line_count;
+    size_t line_cursor;       // 顺序访问时的行号缓存
+    size_t chunk_count;       // 并行词法分析的分块数（串行构建为 0）
+    size_t relexed_chunks;    // 接缝校验失败、从正确位置重新分析的块数
+} CnTokenStream;
+
+// 对整个缓冲区进行词法分析，生成词元流；词法错误报告到 diagnostics（可为NULL）
+bool cn_frontend_token_stream_build(CnTokenStream *stream, const char *source, size_t length,
+                                    const char *filename, struct CnDiagnostics *diagnostics);
+void cn_frontend_token_stream_free(CnTokenStream *stream);
+
+/*
+ * 推测式并行词法分析
+ *
+ * 缓冲区在换行处切分为若干块，每块假设起始处不在字符串或注释内部，
+ * 在各自的线程上独立词法分析。随后按顺序校验块间接缝：上一块越过块尾的
+ * 第一个词元必须恰好是本块产生的某个词元的起点，否则说明起始状态猜错，
+ * 从正确偏移重新串行分析该块。最后拼接各块的词元数组。
+ * 任一被采用的词元报告词法错误时，整体退回串行构建，以保证诊断与串行路径一致。
+ * 生成的词元流与 cn_frontend_token_stream_build 逐词元相同。
+ */
+typedef struct CnLexerParallelOptions {
+    unsigned thread_count;      // 线程数（含调用线程），0 表示按 CPU 核数
+    size_t min_source_length;   // 源码小于该字节数时直接串行分析
+    size_t min_chunk_length;    // 每块的最小字节数
+} CnLexerParallelOptions;
+
+#define CN_LEXER_PARALLEL_MIN_SOURCE ((size_t)4 * 1024 * 1024)
+#define CN_LEXER_PARALLEL_MIN_CHUNK ((size_t)512 * 1024)
+
+void cn_frontend_lexer_parallel_options_default(CnLexerParallelOptions *options);
+
+// 并行构建词元流；options 为 NULL 时使用默认选项，未达阈值时等同于串行构建
+bool cn_frontend_token_stream_build_parallel(CnTokenStream *stream, const char *source, size_t length,
+                                             const char *filename, struct CnDiagnostics *diagnostics,
+                                             const CnLexerParallelOptions *options);
+
+// 取出第 index 个词元（超出范围时返回 EOF 词元），行列号按需计算
+void cn_frontend_token_stream_get(CnTokenStream *stream, size_t index, CnToken *out_token);
+
+// 将字节偏移转换为行列号（行列均从1开始，列按字节计）
+void cn_frontend_token_stream_position(CnTokenStream *stream, size_t offset,
+                                       int *out_line, int *out_column);
+
 #ifdef __cplusplus
 }
 #endif
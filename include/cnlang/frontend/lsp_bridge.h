@@ -4,8 +4,11 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include "cnlang/frontend/ast.h"
+#include "cnlang/frontend/lexer.h"
+#include "cnlang/frontend/parser.h"
 #include "cnlang/frontend/semantics.h"
 #include "cnlang/support/diagnostics.h"
+#include "cnlang/support/line_index.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -24,7 +27,8 @@ typedef struct CnLspRange {
 
 // LSP 符号信息
 typedef struct CnLspSymbolInfo {
-    const char *name;           // 符号名称
+    const char *name;           // 符号名称（指向源码文本，不以 '\0' 结尾）
+    size_t name_length;         // 符号名称长度
     CnSemSymbolKind kind;       // 符号类型（变量/函数）
     CnLspRange definition_range; // 定义位置
     CnType *type;               // 类型信息（可选）
@@ -42,7 +46,7 @@ typedef enum CnLspDiagnosticSeverity {
 typedef struct CnLspDiagnostic {
     CnLspRange range;
     CnLspDiagnosticSeverity severity;
-    const char *message;
+    const char *message; // 由分析结果持有，随 cn_lsp_free_analysis 释放
     const char *source; // 固定为 "CN_Language"
 } CnLspDiagnostic;
 
@@ -54,6 +58,12 @@ typedef struct CnLspDocumentAnalysis {
     CnSemScope *global_scope;   // 全局作用域（含符号表）
     CnLspDiagnostic *diagnostics; // 诊断信息数组
     size_t diagnostic_count;
+    CnTokenStream tokens;        // 词元流（定义、引用、语义高亮按偏移二分查找，无需重新词法分析）
+    CnParseItemList items;       // 顶层声明区间（文本编辑后据此增量解析）
+    char **source_snapshots;     // 解析所用的源码副本：AST 中的名称指向副本，增量复用的声明仍引用较早的副本
+    size_t snapshot_count;
+    const CnLineIndex *line_index; // 行首索引（LSP 行列与字节偏移换算）
+    CnLineIndex owned_line_index;  // 调用方未提供索引时由分析自行构建
 } CnLspDocumentAnalysis;
 
 // 分析文档：执行 Lexer + Parser + Semantics，返回分析结果
@@ -69,9 +79,56 @@ CnLspDocumentAnalysis *cn_lsp_analyze_document(
     const char *uri
 );
 
+// 使用调用方维护的行首索引分析文档（索引须描述同一份文本，且在分析结果释放前保持有效）
+// line_index 为 NULL 时等同于 cn_lsp_analyze_document
+CnLspDocumentAnalysis *cn_lsp_analyze_document_with_index(
+    const char *source,
+    size_t source_length,
+    const char *uri,
+    const CnLineIndex *line_index
+);
+
+// 大纲分析：只做词法分析与跳读模式的语法分析，不解析函数体、不做语义分析，
+// 供大纲、补全等只需要声明与签名的请求使用（诊断只含声明部分的语法错误，global_scope 为 NULL）
+// 函数体可在需要时用 cn_frontend_parse_function_body 解析；line_index 可为 NULL
+CnLspDocumentAnalysis *cn_lsp_analyze_document_outline(
+    const char *source,
+    size_t source_length,
+    const char *uri,
+    const CnLineIndex *line_index
+);
+
+// 文本编辑后重新分析：previous 的文本中 [edit_offset, edit_offset + removed_length) 被替换为
+// inserted_length 字节后得到 source。只重新解析与编辑相交的顶层声明，其余声明的 AST 从 previous
+// 接管（平移行号），再对整个程序重新做语义分析；无法增量解析时退回完整分析
+// previous 可为 NULL；无论成败都会被释放（其引用的旧文本可能已被改写，不再读取）
+CnLspDocumentAnalysis *cn_lsp_reanalyze_document(
+    CnLspDocumentAnalysis *previous,
+    const char *source,
+    size_t source_length,
+    const char *uri,
+    const CnLineIndex *line_index,
+    size_t edit_offset,
+    size_t removed_length,
+    size_t inserted_length
+);
+
 // 释放分析结果
 void cn_lsp_free_analysis(CnLspDocumentAnalysis *analysis);
 
+// LSP 位置（UTF-16 列）-> 字节偏移；行号越界返回 false，列越界截断到行尾
+bool cn_lsp_position_to_offset(
+    const CnLspDocumentAnalysis *analysis,
+    CnLspPosition position,
+    size_t *out_offset
+);
+
+// 字节偏移 -> LSP 位置（UTF-16 列）
+CnLspPosition cn_lsp_offset_to_position(
+    const CnLspDocumentAnalysis *analysis,
+    size_t offset
+);
+
 // 查找指定位置的符号定义
 // 参数：
 //   analysis: 文档分析结果
@@ -100,10 +157,11 @@ bool cn_lsp_find_references(
     size_t *out_count
 );
 
-// 获取文档符号列表（函数、变量等）
+// 获取文档符号列表（顶层的函数、全局变量、结构体、枚举、类、接口与模板，按源码顺序）
+// 完整分析与大纲分析均可；definition_range 为声明名称所在的词元
 // 参数：
 //   analysis: 文档分析结果
-//   out_symbols: 输出符号信息数组（调用者需释放）
+//   out_symbols: 输出符号信息数组（调用者需释放，无符号时为 NULL）
 //   out_count: 输出符号数量
 // 返回：
 //   成功返回 true，否则返回 false
@@ -116,10 +174,13 @@ bool cn_lsp_get_document_symbols(
 // 转换诊断信息：CnDiagnostics -> CnLspDiagnostic[]
 // 参数：
 //   diagnostics: 编译器诊断信息
+//   analysis: 提供源码、行首索引与词元流，用于把字节列换算为 UTF-16 列
+//             并将范围扩展到整个词元（为 NULL 时按字节列直接转换）
 //   out_diagnostics: 输出 LSP 诊断数组（调用者需释放）
 //   out_count: 输出诊断数量
 void cn_lsp_convert_diagnostics(
     const CnDiagnostics *diagnostics,
+    const CnLspDocumentAnalysis *analysis,
     CnLspDiagnostic **out_diagnostics,
     size_t *out_count
 );
@@ -424,6 +424,23 @@ int cn_module_loader_resolve_path_typed(CnModuleLoader *loader,
                                          char **out_path,
                                          int target_type);
 
+/**
+ * @brief 定位编译时嵌入的资源文件
+ * 
+ * 绝对路径直接使用；相对路径依次在引用方源文件所在目录、项目根目录、
+ * 自定义搜索路径（按优先级）和标准库路径下查找。
+ * 
+ * @param loader 加载器（可为 NULL，此时只在引用方源文件所在目录与当前目录下查找）
+ * @param importing_file 引用资源的源文件路径（可为 NULL）
+ * @param resource_path 资源路径
+ * @param out_path 输出的文件路径（调用者负责释放）
+ * @return 成功返回 1，失败返回 0
+ */
+int cn_module_loader_resolve_resource(CnModuleLoader *loader,
+                                      const char *importing_file,
+                                      const char *resource_path,
+                                      char **out_path);
+
 /**
  * @brief 检测循环导入
  * @param loader 加载器
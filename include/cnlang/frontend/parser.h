@@ -11,19 +11,93 @@ extern "C" {
 #endif
 
 struct CnDiagnostics;
+struct CnPreprocessor;
 
 // 前向声明解析器上下文
 typedef struct CnParser CnParser;
 
 // 创建 / 销毁解析器上下文
 CnParser *cn_frontend_parser_new(CnLexer *lexer);
+// 基于整文件预词法化的词元流创建解析器（词元流需在解析器释放前保持有效）
+CnParser *cn_frontend_parser_new_from_stream(CnTokenStream *stream);
+// 基于逐词元预处理器创建解析器：按需拉取词元，不生成预处理后的整份输出
+// （预处理器需在 AST 使用完毕前保持有效，解析后检查 stream_failed 判断预处理是否出错）
+CnParser *cn_frontend_parser_new_from_preprocessor(struct CnPreprocessor *preprocessor);
 void cn_frontend_parser_free(CnParser *parser);
 void cn_frontend_parser_set_diagnostics(CnParser *parser, struct CnDiagnostics *diagnostics);
 
+// 递归解析的默认嵌套层数上限（括号、前缀运算符、右结合运算与代码块各计一层）
+#define CN_PARSER_DEFAULT_MAX_NESTING 256
+
+// 设置嵌套层数上限（0 表示恢复默认值）；超过上限时报告错误并越过该部分，避免深层嵌套耗尽调用栈
+// 左结合运算链（a + b + ...）与 "否则 如果" 链按循环解析，不受此限制
+void cn_frontend_parser_set_max_nesting(CnParser *parser, size_t max_nesting);
+
 // 解析整个程序，生成 AST 根节点
 // 返回值：true 表示解析成功（可能带有可恢复错误），false 表示发生致命错误
 bool cn_frontend_parse_program(CnParser *parser, CnAstProgram **out_program);
 
+// 跳读模式：顶层函数只解析签名，函数体按花括号配对越过并保存其词元，首次需要时再解析
+// （用于导入模块与 LSP 大纲；词元引用的源码需在函数体解析前保持有效）
+void cn_frontend_parser_set_skim_bodies(CnParser *parser, bool skim);
+
+// 解析跳读时保存的函数体，节点分配在程序的 Arena 中；函数体已解析或无函数体时直接返回 true
+// 语法错误报告到 diagnostics（可为NULL），此时保留恢复出的部分函数体并返回 false
+bool cn_frontend_parse_function_body(CnAstFunctionDecl *function_decl, struct CnDiagnostics *diagnostics);
+
+// 解析程序中所有尚未解析的函数体
+bool cn_frontend_parse_lazy_bodies(CnAstProgram *program, struct CnDiagnostics *diagnostics);
+
+// 顶层声明种类（增量解析按种类把声明放回程序的对应列表）
+typedef enum CnParseItemKind {
+    CN_PARSE_ITEM_FUNCTION,        // node 为 CnAstFunctionDecl
+    CN_PARSE_ITEM_STRUCT,          // 以下 node 均为 CnAstStmt
+    CN_PARSE_ITEM_ENUM,
+    CN_PARSE_ITEM_IMPORT,
+    CN_PARSE_ITEM_GLOBAL_VAR,
+    CN_PARSE_ITEM_CLASS,
+    CN_PARSE_ITEM_INTERFACE,
+    CN_PARSE_ITEM_TEMPLATE_FUNC,
+    CN_PARSE_ITEM_TEMPLATE_STRUCT,
+    CN_PARSE_ITEM_OTHER            // 解析出但不加入程序的声明（如模板接口）
+} CnParseItemKind;
+
+// 一个顶层声明在源码中的区间（不含其前的 公开:/私有: 标签）
+typedef struct CnParseItem {
+    size_t begin;                  // 首个词元的字节偏移
+    size_t end;                    // 末个词元结束处的字节偏移
+    int line;                      // 首个词元所在行
+    CnVisibility visibility;       // 解析该声明时的文件级可见性
+    CnParseItemKind kind;
+    void *node;
+} CnParseItem;
+
+// 按源码顺序排列的顶层声明区间，由词元流模式的解析填写，供下次增量解析使用
+typedef struct CnParseItemList {
+    CnParseItem *items;
+    size_t count;
+    size_t capacity;
+    bool reusable;                 // 上次解析无任何诊断且到达文件末尾，可作为增量解析的基础
+    size_t arena_baseline;         // 完整解析后程序 Arena 的用量，用于限制增量解析遗留的废弃节点
+} CnParseItemList;
+
+// 解析时记录顶层声明区间（仅词元流模式；list 为 NULL 时不记录）
+void cn_frontend_parser_set_item_list(CnParser *parser, CnParseItemList *list);
+void cn_frontend_parse_item_list_free(CnParseItemList *list);
+
+/*
+ * 增量解析：源码的 [edit_offset, edit_offset + removed_length) 被替换为 inserted_length 字节后，
+ * 只重新解析与编辑区间相交（含相邻）的顶层声明，其余声明的子树原样复用，
+ * 编辑点之后的声明按新旧行差平移源位置
+ * parser 基于编辑后整份文本的词元流创建；program 与 items 来自上一次解析（完整或增量）
+ * 新节点分配在 program 的 Arena 中，program 的各声明列表按源码顺序重建
+ * 返回 false 表示无法增量完成（编辑区间内有语法错误、影响到相邻声明的划分、
+ * 废弃节点过多等），此时 program 与 items 不变，调用方可用同一解析器改为完整解析
+ * 复用的节点保留上次语义分析写入的信息，再次分析前需调用 cn_frontend_ast_program_reset_semantics
+ */
+bool cn_frontend_parse_program_incremental(CnParser *parser, CnAstProgram *program, CnParseItemList *items,
+                                           size_t edit_offset, size_t removed_length, size_t inserted_length);
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,12 +3,33 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
+
+#include "cnlang/frontend/lexer.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 struct CnDiagnostics;
+struct CnArena;
+
+/*
+ * 函数宏替换模板片段
+ * 函数宏在定义时把替换文本切分为文本片段与形参槽位，展开时按顺序拼接，无需重新扫描
+ */
+typedef enum CnMacroSegmentKind {
+    CN_MACRO_SEGMENT_TEXT,          // 原样输出 replacement 中的一段文本
+    CN_MACRO_SEGMENT_PARAM,         // 替换为实参
+    CN_MACRO_SEGMENT_STRINGIFY      // 替换为字符串化的实参 (#形参)
+} CnMacroSegmentKind;
+
+typedef struct CnMacroSegment {
+    CnMacroSegmentKind kind;        // 片段类型
+    size_t offset;                  // 文本片段在 replacement 中的偏移
+    size_t length;                  // 文本片段长度
+    size_t param_index;             // 形参序号 (PARAM / STRINGIFY)
+} CnMacroSegment;
 
 /*
  * 预处理器宏定义
@@ -17,10 +38,13 @@ struct CnDiagnostics;
 typedef struct CnMacro {
     char *name;                     // 宏名称
     size_t name_length;             // 宏名称长度
+    uint32_t name_hash;             // 宏名称哈希 (宏表索引)
     char *replacement;              // 替换文本
     size_t replacement_length;      // 替换文本长度
     char **params;                  // 参数列表 (NULL 表示对象宏)
     size_t param_count;             // 参数数量
+    CnMacroSegment *segments;       // 函数宏替换模板 (对象宏为 NULL)
+    size_t segment_count;           // 模板片段数量
     bool is_function_like;          // 是否是函数宏
     int defined_line;               // 定义位置 (用于诊断)
 } CnMacro;
@@ -45,10 +69,17 @@ typedef struct CnPreprocessor {
     char *output;                   // 预处理后的输出
     size_t output_length;           // 输出长度
     size_t output_capacity;         // 输出缓冲区容量
+    bool output_borrowed;           // 输出是否直接引用 source（无需预处理时零拷贝）
     
     CnMacro *macros;                // 宏定义表
     size_t macro_count;             // 宏数量
     size_t macro_capacity;          // 宏表容量
+    uint32_t *macro_slots;          // 宏名哈希表 (开放寻址，存放宏下标 + 1，0 表示空槽)
+    size_t macro_slot_count;        // 哈希表槽数 (2 的幂)
+    
+    bool collect_stats;             // 是否统计宏展开耗时
+    size_t macro_expansion_count;   // 宏展开次数
+    uint64_t macro_expansion_time_us; // 宏展开累计耗时 (微秒，仅 collect_stats 时统计)
     
     CnConditionFrame *condition_stack;  // 条件编译栈
     size_t condition_depth;         // 条件栈深度
@@ -58,6 +89,15 @@ typedef struct CnPreprocessor {
     int current_line;               // 当前行号
     int current_column;             // 当前列号
     
+    /* 逐词元模式 (cn_frontend_preprocessor_next_token) 状态 */
+    CnLexer token_lexer;            // 在原始源码上切分词元
+    CnLexer expansion_lexer;        // 切分当前宏展开文本
+    bool in_expansion;              // 是否还有未取完的展开词元
+    int expansion_line;             // 宏调用位置 (展开出的词元沿用)
+    int expansion_column;
+    struct CnArena *expansion_arena; // 宏展开文本存储 (词素在预处理器释放前有效)
+    bool stream_failed;             // 逐词元模式下遇到预处理错误
+    
     struct CnDiagnostics *diagnostics; // 诊断信息
 } CnPreprocessor;
 
@@ -84,6 +124,14 @@ void cn_frontend_preprocessor_set_diagnostics(
     struct CnDiagnostics *diagnostics
 );
 
+/*
+ * 启用/禁用宏展开耗时统计（展开次数总是统计）
+ */
+void cn_frontend_preprocessor_set_collect_stats(
+    CnPreprocessor *preprocessor,
+    bool enabled
+);
+
 /*
  * 执行预处理
  * 
@@ -92,9 +140,31 @@ void cn_frontend_preprocessor_set_diagnostics(
  * 
  * 成功后，预处理结果存储在 preprocessor->output 中，
  * 调用者负责在使用完成后调用 cn_frontend_preprocessor_free
+ *
+ * 源码中不含 '#' 且未定义任何宏时不做复制，output 直接指向 source
+ * （output_borrowed 为 true），此时 source 必须在 output 使用期间保持有效
  */
 bool cn_frontend_preprocessor_process(CnPreprocessor *preprocessor);
 
+/*
+ * 逐词元预处理：取出下一个词元
+ * 
+ * @param preprocessor 预处理器上下文
+ * @param out_token 输出词元，到达末尾或出错时为 EOF 词元
+ * @return false 如果遇到预处理错误 (stream_failed 同时置位)，否则 true
+ * 
+ * 与 cn_frontend_preprocessor_process 二选一使用：指令与条件编译在取词元时即时处理，
+ * 不生成展开后的整份输出。源码中的词元保留原始行列号，宏展开出的词元使用宏调用位置。
+ * 词素指向 source 或预处理器持有的展开文本，在 cn_frontend_preprocessor_free 前有效。
+ */
+bool cn_frontend_preprocessor_next_token(CnPreprocessor *preprocessor, CnToken *out_token);
+
+/*
+ * 检查源码是否无需预处理 (没有指令、宏与块注释)
+ * 此时可以直接对 source 做词法分析
+ */
+bool cn_frontend_preprocessor_is_passthrough(const CnPreprocessor *preprocessor);
+
 /*
  * 释放预处理器资源
  * 
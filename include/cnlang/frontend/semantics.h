@@ -57,9 +57,14 @@ typedef struct CnSemSymbol CnSemSymbol;
 typedef struct CnStructField CnStructField;
 struct CnDiagnostics;
 
+// 类型节点标志
+#define CN_TYPE_FLAG_INTERNED 0x1  // 类型上下文中的规范节点，可能被多处共享，不可修改
+#define CN_TYPE_FLAG_CLOSED   0x2  // 规范节点且不含具名类型：结构相等当且仅当节点相同
+
 // 类型描述结构
 typedef struct CnType {
     CnTypeKind kind;
+    unsigned char flags;               // CN_TYPE_FLAG_*
     union {
         struct CnType *pointer_to;      // 指针指向的元素类型
         struct {
@@ -126,16 +131,46 @@ struct CnSemSymbol {
     } as;
 };
 
+// 类型上下文：cn_type_new_* 创建的类型节点都分配在进程级共享上下文中，随上下文一起释放。
+// 结构相同的基本、指针、数组与函数类型共享同一个规范节点；
+// 结构体、枚举、类与接口按名字区分，每次创建仍得到独立节点
+typedef struct CnTypeContext CnTypeContext;
+
+// 类型上下文统计信息
+typedef struct CnTypeContextStats {
+    size_t node_count;             // 已分配的类型节点数量
+    size_t interned_count;         // 驻留的指针、数组、函数类型数量
+    size_t intern_calls;           // 指针、数组、函数类型构造次数
+    size_t hit_count;              // 命中已有节点的次数
+    size_t table_bytes;            // 驻留表占用字节数
+    size_t arena_bytes;            // Arena 已分配字节数
+} CnTypeContextStats;
+
+CnTypeContext *cn_type_context_new(void);
+void cn_type_context_free(CnTypeContext *context);
+// 获取进程级共享类型上下文（首次调用时创建）
+CnTypeContext *cn_type_context_default(void);
+// 释放进程级共享类型上下文；此后之前创建的所有类型均失效
+void cn_type_context_release_default(void);
+void cn_type_context_get_stats(const CnTypeContext *context, CnTypeContextStats *stats);
+// 并发模式：主驻留表冻结为只读，多个线程可同时构造类型，新类型在锁内写入暂存表；
+// 退出时并入主表，调用 end 前所有并发线程必须已经结束
+bool cn_type_context_begin_concurrent(CnTypeContext *context);
+void cn_type_context_end_concurrent(CnTypeContext *context);
+
 // 类型管理接口
 CnType *cn_type_new_primitive(CnTypeKind kind);
 CnType *cn_type_new_pointer(CnType *base);
 CnType *cn_type_new_array(CnType *element, size_t length);
+// 函数类型复制 param_types 中的参数类型，数组仍归调用者所有
 CnType *cn_type_new_function(CnType *return_type, CnType **param_types, size_t param_count);
 CnType *cn_type_new_struct(const char *name, size_t name_length, CnStructField *fields, size_t field_count, CnSemScope *decl_scope, const char *owner_func_name, size_t owner_func_name_length);
 CnType *cn_type_new_enum(const char *name, size_t name_length);
 CnType *cn_type_new_memory_address(void);
 bool cn_type_equals(CnType *a, CnType *b);
 bool cn_type_compatible(CnType *a, CnType *b); // 检查 a 是否可以隐式转换为 b 或等价
+// 与 cn_type_equals 一致的结构哈希：等价的类型哈希值相同（具名类型按名称计算）
+size_t cn_type_hash(CnType *type);
 
 // 类型深度复制：用于模块导入时复制完整的类型信息
 // 确保导入的类型信息不会因为原模块被重新编译而丢失
@@ -178,6 +213,21 @@ CnSemSymbol *cn_sem_scope_lookup_by_kind(CnSemScope *scope,
                                          size_t name_length,
                                          CnSemSymbolKind preferred_kind);
 
+// 查找标识符表达式引用的符号，语义同 cn_sem_scope_lookup / cn_sem_scope_lookup_by_kind。
+// 结果缓存在标识符节点上：之后各阶段从同一作用域查找时直接返回，
+// 作用域链上插入新符号后缓存失效；名字在作用域链上有多个同名符号时不缓存
+CnSemSymbol *cn_sem_scope_lookup_identifier(CnSemScope *scope, struct CnAstExpr *ident_expr);
+CnSemSymbol *cn_sem_scope_lookup_identifier_by_kind(CnSemScope *scope,
+                                                    struct CnAstExpr *ident_expr,
+                                                    CnSemSymbolKind preferred_kind);
+
+// 语义缓存校验模式（调试用）：命中标识符符号缓存或表达式类型缓存时重新计算并比较，
+// 不一致时输出到 stderr、计数并返回重新计算的结果
+void cn_sem_cache_set_verify(bool enabled);
+bool cn_sem_cache_verify_enabled(void);
+size_t cn_sem_cache_verify_failures(void);
+void cn_sem_cache_report_mismatch(const char *what, const struct CnAstExpr *expr);
+
 // 检查两个符号是否是同一个符号（来自同一模块的同一声明）
 // 用于解决跨编译会话的符号唯一性问题
 int cn_sem_symbol_is_same(const CnSemSymbol *sym1, const CnSemSymbol *sym2);
@@ -190,8 +240,21 @@ void cn_sem_scope_foreach_symbol(CnSemScope *scope,
                                   CnSemScopeSymbolCallback callback,
                                   void *user_data);
 
-// 设置动态解析的作用域（供 semantic_passes.c 调用）
+// 设置动态解析的作用域（供 semantic_passes.c 调用，每个线程各自设置）
 void cn_type_set_resolution_scope(CnSemScope *scope);
+CnSemScope *cn_type_get_resolution_scope(void);
+
+// 类型补全日志：并行类型检查时，结构体占位节点的字段补全与字段类型改写不直接修改共享节点，
+// 而是记录在各线程的日志中，检查结束后按函数顺序应用
+typedef struct CnTypePatchLog CnTypePatchLog;
+CnTypePatchLog *cn_type_patch_log_new(void);
+void cn_type_patch_log_free(CnTypePatchLog *log);
+// 应用并清空日志；目标已被先前的条目改写时跳过，与串行检查的结果一致
+void cn_type_patch_log_apply(CnTypePatchLog *log);
+// 设置当前线程的补全日志；NULL 表示直接修改类型节点
+void cn_type_set_patch_log(CnTypePatchLog *log);
+// 改写结构体字段的类型（设置了补全日志时仅记录）
+void cn_type_patch_field_type(CnStructField *field, CnType *type);
 
 // 结构体成员查找：在结构体类型中查找成员字段
 CnStructField *cn_type_struct_find_field(CnType *struct_type,
@@ -253,12 +316,22 @@ CnType *cn_type_infer_member_access(CnSemScope *scope, struct CnAstExpr *member_
  */
 CnType *cn_type_infer_identifier(CnSemScope *scope, struct CnAstExpr *ident_expr);
 
+// 编译上下文：一次编译中作用域构建的状态，包括检测循环导入的模块编译栈、
+// 已编译的导入模块缓存及正在构建作用域的程序。不同编译使用各自的上下文，互不影响
+typedef struct CnSemCompilation CnSemCompilation;
+
+CnSemCompilation *cn_sem_compilation_new(void);
+// 释放编译上下文；导入模块的作用域、AST 与 IR 被符号和生成的代码引用，不在此释放
+void cn_sem_compilation_free(CnSemCompilation *compilation);
+
 // 基于当前 AST 构建作用域链，返回全局作用域指针；失败时返回 NULL
 CnSemScope *cn_sem_build_scopes(CnAstProgram *program, struct CnDiagnostics *diagnostics);
 
 // 带模块加载器的作用域构建（支持 Python 风格跨文件模块导入）
+// 导入的模块缓存在 compilation 中，供之后生成各模块的代码；
 // source_file 是当前编译的源文件路径，用于设置模块加载器的搜索路径
-CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program, 
+CnSemScope *cn_sem_build_scopes_with_loader(CnSemCompilation *compilation,
+                                             CnAstProgram *program, 
                                              struct CnDiagnostics *diagnostics,
                                              struct CnModuleLoader *loader,
                                              const char *source_file);
@@ -273,6 +346,23 @@ bool cn_sem_check_types(CnSemScope *global_scope,
                         CnAstProgram *program,
                         struct CnDiagnostics *diagnostics);
 
+// 并行类型检查选项
+typedef struct CnSemParallelOptions {
+    unsigned thread_count;         // 工作线程数（含调用线程，0 表示 CPU 核数）
+    size_t min_function_count;     // 函数数少于该值时串行检查
+} CnSemParallelOptions;
+
+// 获取默认并行类型检查选项
+void cn_sem_parallel_options_default(CnSemParallelOptions *options);
+
+// 并行类型检查：类、全局变量与返回类型推断仍串行完成，之后全局与模块作用域只读，
+// 各函数体在工作线程中检查，诊断写入各自的缓冲区并按函数顺序合并，输出与串行检查逐字节一致。
+// options 为 NULL 时使用默认选项；返回值含义同 cn_sem_check_types
+bool cn_sem_check_types_parallel(CnSemScope *global_scope,
+                                 CnAstProgram *program,
+                                 struct CnDiagnostics *diagnostics,
+                                 const CnSemParallelOptions *options);
+
 // Freestanding 模式检查：检查程序是否符合 freestanding 模式约束；返回 true 表示成功
 bool cn_sem_check_freestanding(CnAstProgram *program,
                                struct CnDiagnostics *diagnostics,
@@ -284,37 +374,42 @@ bool cn_sem_check_freestanding(CnAstProgram *program,
 
 /**
  * @brief 获取缓存的模块数量
- * @return 缓存中的模块数量
+ * @param compilation 编译上下文
+ * @return 缓存中的模块数量，compilation 为 NULL 时返回 0
  */
-int cn_sem_get_cached_module_count(void);
+int cn_sem_get_cached_module_count(const CnSemCompilation *compilation);
 
 /**
  * @brief 获取缓存的模块文件路径
+ * @param compilation 编译上下文
  * @param index 模块索引（0 到 cn_sem_get_cached_module_count() - 1）
  * @return 模块文件路径，索引无效时返回 NULL
  */
-const char *cn_sem_get_cached_module_path(int index);
+const char *cn_sem_get_cached_module_path(const CnSemCompilation *compilation, int index);
 
 /**
  * @brief 获取缓存的模块AST程序
+ * @param compilation 编译上下文
  * @param index 模块索引
  * @return AST程序指针，索引无效时返回 NULL
  */
-CnAstProgram *cn_sem_get_cached_module_program(int index);
+CnAstProgram *cn_sem_get_cached_module_program(const CnSemCompilation *compilation, int index);
 
 /**
  * @brief 获取缓存的模块IR
+ * @param compilation 编译上下文
  * @param index 模块索引
  * @return IR模块指针，索引无效时返回 NULL
  */
-struct CnIrModule *cn_sem_get_cached_module_ir(int index);
+struct CnIrModule *cn_sem_get_cached_module_ir(const CnSemCompilation *compilation, int index);
 
 /**
  * @brief 设置缓存的模块IR
+ * @param compilation 编译上下文
  * @param index 模块索引
  * @param ir_module IR模块指针
  */
-void cn_sem_set_cached_module_ir(int index, struct CnIrModule *ir_module);
+void cn_sem_set_cached_module_ir(CnSemCompilation *compilation, int index, struct CnIrModule *ir_module);
 
 // ============================================================================
 // 阶段D：跨文件模块语义分析 API
@@ -73,9 +73,41 @@ typedef enum CnIrOperandKind {
     CN_IR_OP_IMM_STR,  // 字符串字面量
     CN_IR_OP_SYMBOL,   // 全局符号（变量名、函数名）
     CN_IR_OP_LABEL,    // 跳转目标（指向 BasicBlock）
-    CN_IR_OP_AST_EXPR  // AST表达式（用于复杂字面量如结构体）
+    CN_IR_OP_AST_EXPR, // AST表达式（用于复杂字面量如结构体）
+    CN_IR_OP_CONST_ARRAY // 打包的常量数组（全常量的数组初始化列表）
 } CnIrOperandKind;
 
+// 常量数组元素值的种类
+typedef enum CnIrConstKind {
+    CN_IR_CONST_INT,   // 整数（字符、布尔按整数存放）
+    CN_IR_CONST_FLOAT, // 浮点数
+    CN_IR_CONST_STR    // 字符串字面量
+} CnIrConstKind;
+
+// 常量数组中的单个值
+typedef struct CnIrConstValue {
+    CnIrConstKind kind;
+    union {
+        long long i;
+        double f;
+        const char *s; // 由所属常量数组持有
+    } as;
+} CnIrConstValue;
+
+// 打包的常量数组：初始化列表全部由常量字面量组成时，所有值按行连续存放在一块内存中，
+// 代码生成时整体输出为一个 C 数组初始化器，不再逐元素生成 IR 指令与运行时初始化代码
+typedef struct CnIrConstArray {
+    int id;                       // 模块内编号，局部数组初始化使用的只读表名为 cn_const_<id>
+    CnType *element_type;         // 元素类型
+    size_t element_count;         // 元素个数
+    size_t field_count;           // 结构体元素的字段数，标量元素为 0
+    char **field_names;           // 结构体元素按名初始化时的各字段名，按位置初始化时为 NULL
+    CnIrConstValue *values;       // element_count * (field_count ? field_count : 1) 个值，字节数组为 NULL
+    const unsigned char *bytes;   // 嵌入资源的原始字节（element_count 个，不持有，由源文件管理器持有）
+    int emit_table;               // 需要在文件作用域输出只读表 cn_const_<id>（局部数组从表中复制初始值）
+    struct CnIrConstArray *next;  // 模块内常量数组链表
+} CnIrConstArray;
+
 // IR 操作数结构
 typedef struct CnIrOperand {
     CnIrOperandKind kind;
@@ -87,6 +119,7 @@ typedef struct CnIrOperand {
         const char *sym_name;
         struct CnIrBasicBlock *label;
         struct CnAstExpr *ast_expr;  // 用于结构体字面量等复杂表达式
+        CnIrConstArray *const_array; // 由模块持有
     } as;
     CnType *type; // 与操作数关联的类型信息
 } CnIrOperand;
@@ -181,6 +214,9 @@ typedef struct CnIrModule {
     CnIrFunction *last_func;
     CnIrGlobalVar *first_global;  // 全局变量链表
     CnIrGlobalVar *last_global;
+    CnIrConstArray *first_const_array;  // 常量数组链表
+    CnIrConstArray *last_const_array;
+    int const_array_count;
     CnTargetTriple target;      // 目标三元组信息，用于后端映射和数据布局
     CnCompileMode compile_mode; // 编译模式：宿主 / freestanding
 } CnIrModule;
@@ -201,6 +237,12 @@ void cn_ir_basic_block_connect(CnIrBasicBlock *from, CnIrBasicBlock *to);
 
 CnIrInst *cn_ir_inst_new(CnIrInstKind kind, CnIrOperand dest, CnIrOperand src1, CnIrOperand src2);
 
+// 常量数组：值区按元素个数与字段数一次分配（清零），加入模块后由模块释放
+CnIrConstArray *cn_ir_const_array_new(CnType *element_type, size_t element_count, size_t field_count);
+CnIrConstArray *cn_ir_const_array_new_bytes(CnType *element_type, const unsigned char *bytes, size_t size);
+void cn_ir_const_array_free(CnIrConstArray *array);
+void cn_ir_module_add_const_array(CnIrModule *module, CnIrConstArray *array);
+
 // IR 打印工具
 void cn_ir_dump_module(CnIrModule *module);
 void cn_ir_dump_module_to_file(CnIrModule *module, FILE *file);
@@ -222,6 +264,7 @@ CnIrOperand cn_ir_op_imm_str(const char *val, CnType *type);  // 新增：创建
 CnIrOperand cn_ir_op_label(CnIrBasicBlock *block);
 CnIrOperand cn_ir_op_symbol(const char *name, CnType *type);
 CnIrOperand cn_ir_op_ast_expr(struct CnAstExpr *expr, CnType *type);
+CnIrOperand cn_ir_op_const_array(CnIrConstArray *array, CnType *type);
 
 #ifdef __cplusplus
 }
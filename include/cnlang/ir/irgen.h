@@ -13,6 +13,7 @@ extern "C" {
 // 前向声明
 struct CnIrGenStaticVar;
 struct CnIrLocalVarEntry;
+struct CnDiagnostics;
 
 // IR 生成上下文
 typedef struct CnIrGenContext {
@@ -36,11 +37,22 @@ typedef struct CnIrGenContext {
     
     // 当前函数中的局部变量名映射表（原始名 -> 唯一名）
     struct CnIrLocalVarEntry *local_var_map;
+
+    // 诊断信息（可为NULL）：跳读模式下延迟解析的函数体出错时由解析器报告到此处
+    struct CnDiagnostics *diagnostics;
+
+    // 是否有函数因函数体存在语法错误而未生成 IR
+    bool has_error;
 } CnIrGenContext;
 
 // 主入口：将 AST 程序转换为 IR 模块
 CnIrModule *cn_ir_gen_program(CnAstProgram *program, CnSemScope *global_scope, CnTargetTriple target, CnCompileMode mode);
 
+// 同上，延迟解析的函数体中的语法错误报告到 diagnostics；存在此类错误时返回 NULL
+CnIrModule *cn_ir_gen_program_with_diagnostics(CnAstProgram *program, CnSemScope *global_scope,
+                                               CnTargetTriple target, CnCompileMode mode,
+                                               struct CnDiagnostics *diagnostics);
+
 // 辅助接口（内部使用，但可用于单元测试）
 CnIrGenContext *cn_ir_gen_context_new();
 void cn_ir_gen_context_free(CnIrGenContext *ctx);
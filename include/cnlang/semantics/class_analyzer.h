@@ -18,6 +18,8 @@
 #include "cnlang/frontend/semantics.h"
 #include "cnlang/support/diagnostics.h"
 
+struct CnInheritanceResolver;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -38,6 +40,7 @@ typedef struct CnClassAnalyzerContext {
     CnAccessLevel current_access;   ///< 当前访问级别上下文
     CnDiagnostics *diagnostics;     ///< 诊断信息收集器
     struct CnAstProgram *program;   ///< 程序AST（用于查找基类）
+    struct CnInheritanceResolver *hierarchy;  ///< 类层次缓存（可为NULL，为NULL时逐级在程序中查找基类）
 } CnClassAnalyzerContext;
 
 /* ============================================================================
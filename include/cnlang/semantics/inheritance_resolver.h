@@ -7,6 +7,7 @@
  * - 类注册与关系构建
  * - 循环继承检测
  * - 继承链遍历
+ * - 类层次缓存（线性化祖先列表、祖先位集、方法槽位表）
  */
 
 #ifndef CNLANG_SEMANTICS_INHERITANCE_RESOLVER_H
@@ -14,6 +15,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <cnlang/frontend/ast/class_node.h>
 #include <cnlang/support/diagnostics.h>
 
@@ -25,10 +27,24 @@ extern "C" {
  * 继承层次结构节点
  * ============================================================================ */
 
+/**
+ * @brief 方法槽位
+ *
+ * 类的方法表中的一项：类自身及所有基类中同名方法按MRO顺序合并为一个槽位
+ */
+typedef struct CnMethodSlot {
+    const char *name;                        ///< 方法名
+    size_t name_length;                      ///< 方法名长度
+    CnClassMember *method;                   ///< 按MRO顺序找到的第一个同名方法
+    CnAstClassDecl *owner;                   ///< method 所属的类
+    CnClassMember *virtual_method;           ///< 按MRO顺序找到的第一个同名虚函数（可为NULL）
+} CnMethodSlot;
+
 /**
  * @brief 继承层次结构节点
  * 
- * 表示继承层次中的一个类节点，包含指向派生类的引用
+ * 表示继承层次中的一个类节点，包含指向派生类的引用。
+ * 类层次缓存字段在首次查询时一次性计算（见 cn_inheritance_resolver_build_hierarchy）
  */
 typedef struct CnInheritanceNode {
     CnAstClassDecl *class_decl;              ///< 类声明AST节点
@@ -37,6 +53,17 @@ typedef struct CnInheritanceNode {
     size_t derived_capacity;                 ///< 派生类列表容量
     int depth;                               ///< 继承深度（0表示根类）
     bool visited;                            ///< 遍历标记（用于循环检测）
+
+    /* 类层次缓存 */
+    size_t id;                               ///< 稠密类编号（节点在解析器中的下标）
+    struct CnInheritanceNode **ancestors;    ///< 线性化祖先列表（MRO顺序，不含自身）
+    size_t ancestor_count;                   ///< 祖先数量
+    uint64_t *ancestor_bits;                 ///< 祖先位集（按类编号索引）
+    CnMethodSlot *method_slots;              ///< 方法槽位表（按槽位号排列）
+    size_t method_slot_count;                ///< 槽位数量
+    uint32_t *method_index;                  ///< 方法名哈希索引（存放槽位号+1，0表示空位）
+    size_t method_index_capacity;            ///< 哈希索引容量（2的幂）
+    int hierarchy_state;                     ///< 缓存计算状态（0未计算，1计算中，2已完成）
 } CnInheritanceNode;
 
 /* ============================================================================
@@ -53,6 +80,10 @@ typedef struct CnInheritanceResolver {
     size_t node_count;                       ///< 节点数量
     size_t node_capacity;                    ///< 节点数组容量
     CnDiagnostics *diagnostics;              ///< 诊断信息收集器
+    uint32_t *name_index;                    ///< 类名哈希索引（存放节点下标+1，0表示空位）
+    size_t name_index_capacity;              ///< 类名哈希索引容量（2的幂）
+    size_t bitset_words;                     ///< 每个祖先位集的 64 位字数
+    bool hierarchy_ready;                    ///< 类层次缓存是否已计算
 } CnInheritanceResolver;
 
 /* ============================================================================
@@ -128,9 +159,76 @@ bool cn_inheritance_resolver_check_circular(CnInheritanceResolver *resolver);
 CnInheritanceNode *cn_inheritance_resolver_get_node(CnInheritanceResolver *resolver,
                                                      const char *class_name);
 
+/**
+ * @brief 按名称（带长度）获取类的继承层次节点
+ *
+ * 通过类名哈希索引查找，同名类以先注册者为准
+ *
+ * @param resolver 解析器
+ * @param class_name 类名
+ * @param class_name_length 类名长度
+ * @return CnInheritanceNode* 找到返回节点指针，未找到返回NULL
+ */
+CnInheritanceNode *cn_inheritance_resolver_find_node(CnInheritanceResolver *resolver,
+                                                      const char *class_name,
+                                                      size_t class_name_length);
+
+/**
+ * @brief 获取类声明对应的继承层次节点
+ *
+ * @param resolver 解析器
+ * @param class_decl 类声明
+ * @return CnInheritanceNode* 找到返回节点指针，类未注册返回NULL
+ */
+CnInheritanceNode *cn_inheritance_resolver_node_of(CnInheritanceResolver *resolver,
+                                                    const CnAstClassDecl *class_decl);
+
+/**
+ * @brief 计算类层次缓存
+ *
+ * 为每个类一次性计算线性化祖先列表、稠密类编号、祖先位集与方法槽位表，
+ * 之后的派生关系判断为 O(1)，方法查找为一次哈希查找。
+ * 查询函数在缓存失效时会自动调用；注册新类会使缓存失效。
+ * 存在循环继承时，环上的边被忽略（循环继承由 check_circular 报告）。
+ *
+ * @param resolver 解析器
+ * @return bool 成功返回true，内存不足返回false
+ */
+bool cn_inheritance_resolver_build_hierarchy(CnInheritanceResolver *resolver);
+
+/**
+ * @brief 检查节点间的派生关系（O(1)）
+ *
+ * @param resolver 解析器
+ * @param derived 派生类节点
+ * @param base 基类节点
+ * @return bool derived 直接或间接继承自 base 返回true（同一节点返回false）
+ */
+bool cn_inheritance_node_is_derived_from(CnInheritanceResolver *resolver,
+                                          const CnInheritanceNode *derived,
+                                          const CnInheritanceNode *base);
+
+/**
+ * @brief 在类的方法槽位表中查找方法
+ *
+ * 结果与按MRO顺序逐个类查找一致
+ *
+ * @param resolver 解析器
+ * @param class_decl 类声明
+ * @param method_name 方法名
+ * @param method_name_len 方法名长度
+ * @return const CnMethodSlot* 找到返回槽位，类未注册或无此方法返回NULL
+ */
+const CnMethodSlot *cn_inheritance_resolver_find_method_slot(CnInheritanceResolver *resolver,
+                                                              const CnAstClassDecl *class_decl,
+                                                              const char *method_name,
+                                                              size_t method_name_len);
+
 /**
  * @brief 获取类的所有基类（包括间接基类）
  * 
+ * 按MRO顺序返回，每个基类只出现一次
+ * 
  * @param resolver 解析器
  * @param class_decl 类声明
  * @param count 输出参数，返回基类数量
@@ -61,6 +61,7 @@ typedef struct CnTemplateInstance {
     size_t mangled_name_length;   // 名称长度
     
     // 原模板信息
+    const void *template_decl;    // 原模板声明（不同模块的同名模板各自成键，NULL 时仅按名称区分）
     const char *template_name;    // 原模板名称
     size_t template_name_length;  // 模板名称长度
     
@@ -72,17 +73,27 @@ typedef struct CnTemplateInstance {
     CnAstFunctionDecl *instantiated_function;  // 实例化的函数（函数模板）
     CnAstStructDecl *instantiated_struct;      // 实例化的结构体（结构体模板）
     CnType *instantiated_type;                 // 实例化的类型
+
+    size_t hash;                  // (模板声明, 模板名, 类型实参) 的哈希，加入缓存时计算
 } CnTemplateInstance;
 
 /**
  * @brief 模板实例化缓存表
  *
- * 管理所有已实例化的模板，避免重复实例化
+ * 管理所有已实例化的模板，避免重复实例化。
+ * 实例按加入顺序保存在 instances 中（代码生成按此顺序输出），
+ * 另以 (模板声明, 模板名, 类型实参) 的哈希建立开放寻址索引，查找不再线性扫描。
  */
 typedef struct CnTemplateCache {
     CnTemplateInstance **instances;  // 实例数组
     size_t instance_count;           // 实例数量
     size_t capacity;                 // 容量
+
+    CnTemplateInstance **slots;      // 哈希索引（线性探测，负载因子不超过 1/2）
+    size_t slot_count;               // 索引槽数（2 的幂）
+
+    size_t hit_count;                // 实例化请求命中缓存的次数
+    size_t miss_count;               // 实例化请求未命中、需要新建实例的次数
 } CnTemplateCache;
 
 /* ============================================================================
@@ -176,6 +187,7 @@ void cn_template_cache_free(CnTemplateCache *cache);
 /**
  * @brief 在缓存中查找已实例化的模板
  * @param cache 模板缓存
+ * @param template_decl 模板声明（NULL 表示只按名称查找未登记声明的实例）
  * @param template_name 模板名称
  * @param template_name_len 名称长度
  * @param type_args 类型实参数组
@@ -183,6 +195,7 @@ void cn_template_cache_free(CnTemplateCache *cache);
  * @return 找到返回实例化项，未找到返回NULL
  */
 CnTemplateInstance *cn_template_cache_find(const CnTemplateCache *cache,
+                                           const void *template_decl,
                                            const char *template_name,
                                            size_t template_name_len,
                                            CnType **type_args,
@@ -196,6 +209,32 @@ CnTemplateInstance *cn_template_cache_find(const CnTemplateCache *cache,
  */
 bool cn_template_cache_add(CnTemplateCache *cache, CnTemplateInstance *instance);
 
+/**
+ * @brief 获取进程级共享模板缓存（首次调用时创建）
+ *
+ * 一次编译中所有模块使用同一缓存，同一实例只替换、生成一次
+ *
+ * @return 共享缓存，创建失败返回NULL
+ */
+CnTemplateCache *cn_template_cache_default(void);
+
+/**
+ * @brief 释放进程级共享模板缓存
+ */
+void cn_template_cache_release_default(void);
+
+/**
+ * @brief 计算模板缓存键 (模板声明, 模板名, 类型实参) 的哈希
+ *
+ * 与 cn_template_cache_find 的比较规则一致：等价的类型实参哈希相同，
+ * 共享缓存中不同模块的同名模板因声明不同而分属不同的键
+ */
+size_t cn_template_cache_hash(const void *template_decl,
+                              const char *template_name,
+                              size_t template_name_len,
+                              CnType **type_args,
+                              size_t type_arg_count);
+
 /* ============================================================================
  * 模板注册表接口
  * ============================================================================ */
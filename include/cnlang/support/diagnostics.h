@@ -77,7 +77,12 @@ typedef enum CnDiagCode {
     // 抽象类相关语义错误
     CN_DIAG_CODE_SEM_ABSTRACT_INSTANTIATION,  // 尝试实例化抽象类
     CN_DIAG_CODE_SEM_PURE_VIRTUAL_NOT_IMPL,   // 派生类未实现所有纯虚函数
-    CN_DIAG_CODE_SEM_PURE_VIRTUAL_CALL        // 调用纯虚函数
+    CN_DIAG_CODE_SEM_PURE_VIRTUAL_CALL,       // 调用纯虚函数
+    // 解析器资源限制（追加在末尾，保持已有诊断编号不变）
+    CN_DIAG_CODE_PARSE_NESTING_TOO_DEEP,      // 嵌套层数超过解析器上限
+    // 编译时资源嵌入
+    CN_DIAG_CODE_SEM_EMBED_NOT_FOUND,         // 嵌入的资源文件不存在或无法读取
+    CN_DIAG_CODE_SEM_EMBED_INVALID_TARGET     // 嵌入资源不是全局字符数组的初始值，或数组长度不足
 } CnDiagCode;
 
 /* ==================== 前向声明 ==================== */
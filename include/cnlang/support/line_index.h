@@ -0,0 +1,126 @@
+#ifndef CN_SUPPORT_LINE_INDEX_H
+#define CN_SUPPORT_LINE_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/*
+ * CN Language 行首索引
+ * 为一份文本记录每行的起始字节偏移，字节偏移与（行，UTF-8 字节列，UTF-16 列）
+ * 之间的换算为二分查找定位行 + 行内扫描；纯 ASCII 行的列换算为 O(1)。
+ * 文本编辑后可按编辑区间增量更新，不必重新扫描整份文本。
+ * 诊断打印、REPL 和 LSP 共用该索引（LSP 的列按 UTF-16 代码单元计）。
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 文本位置（行列均从 0 开始）
+typedef struct CnTextPosition {
+    uint32_t line;                 // 行号
+    uint32_t byte_column;          // 行内字节偏移（UTF-8 列）
+    uint32_t utf16_column;         // 行内 UTF-16 代码单元偏移（LSP 列）
+} CnTextPosition;
+
+// 行首索引
+typedef struct CnLineIndex {
+    uint32_t *line_starts;         // 每行起始字节偏移（第 0 行为 0）
+    uint8_t *line_ascii;           // 每行是否全为 ASCII（UTF-16 列等于字节列）
+    size_t line_count;             // 行数（至少为 1）
+    size_t capacity;               // 数组容量
+    size_t length;                 // 文本长度
+} CnLineIndex;
+
+// =============================================================================
+// 构建与释放
+// =============================================================================
+
+/*
+ * 为文本构建行首索引
+ * @param index 索引
+ * @param text 文本（无需以 '\0' 结尾）
+ * @param length 文本长度（不超过 UINT32_MAX）
+ * @return 成功返回 true
+ */
+bool cn_line_index_init(CnLineIndex *index, const char *text, size_t length);
+
+/*
+ * 释放行首索引
+ */
+void cn_line_index_free(CnLineIndex *index);
+
+/*
+ * 文本编辑后增量更新索引：旧文本 [offset, offset + removed_length) 被替换为
+ * 新文本 [offset, offset + inserted_length)。编辑点之前的行保持不变，
+ * 之后的行整体平移，只重新扫描插入的内容。
+ * @param index 索引（描述编辑前的文本）
+ * @param text 编辑后的文本
+ * @return 成功返回 true；参数与索引不一致时返回 false，索引保持不变
+ */
+bool cn_line_index_apply_edit(CnLineIndex *index, const char *text,
+                              size_t offset, size_t removed_length, size_t inserted_length);
+
+// =============================================================================
+// 位置换算
+// =============================================================================
+
+/*
+ * 字节偏移所在的行号（从 0 开始），超出文本长度时返回最后一行
+ */
+size_t cn_line_index_line_of(const CnLineIndex *index, size_t offset);
+
+/*
+ * 行的起始偏移与内容结束偏移（不含行尾的 '\n' 与 '\r'）
+ * 行号超出范围时返回 false
+ */
+bool cn_line_index_line_span(const CnLineIndex *index, const char *text, size_t line,
+                             size_t *out_begin, size_t *out_end);
+
+/*
+ * 字节偏移 -> 文本位置（超出文本长度时截断到文本末尾）
+ */
+CnTextPosition cn_line_index_position(const CnLineIndex *index, const char *text, size_t offset);
+
+/*
+ * （行，UTF-16 列）-> 字节偏移
+ * 列超出行长度时截断到行内容末尾；列落在代理对中间时返回该字符的起始偏移。
+ * 行号超出范围时返回文本长度。
+ */
+size_t cn_line_index_offset_from_utf16(const CnLineIndex *index, const char *text,
+                                       size_t line, size_t utf16_column);
+
+/*
+ * （行，字节列）-> 字节偏移，列超出行长度时截断到行内容末尾
+ */
+size_t cn_line_index_offset_from_byte_column(const CnLineIndex *index, const char *text,
+                                             size_t line, size_t byte_column);
+
+/*
+ * 编译器诊断位置（行列从 1 开始，列按字节计）-> 字节偏移
+ */
+static inline size_t cn_line_index_offset_from_diag(const CnLineIndex *index, const char *text,
+                                                    int line, int column)
+{
+    return cn_line_index_offset_from_byte_column(index, text,
+                                                  line > 0 ? (size_t)(line - 1) : 0,
+                                                  column > 0 ? (size_t)(column - 1) : 0);
+}
+
+// =============================================================================
+// 终端显示
+// =============================================================================
+
+/*
+ * 输出与行内前 prefix_length 字节等宽的空白（制表符保留，中日韩全角字符占两列），
+ * 用于在源码行下方对齐 '^' 标记
+ */
+void cn_line_index_write_padding(FILE *out, const char *line_begin, size_t prefix_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CN_SUPPORT_LINE_INDEX_H */
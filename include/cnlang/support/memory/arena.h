@@ -76,6 +76,27 @@ void *cn_arena_alloc(CnArena *arena, size_t size);
  */
 void *cn_arena_alloc_aligned(CnArena *arena, size_t size, size_t alignment);
 
+/*
+ * 扩展 Arena 中的一段内存（用于增长的数组）
+ * 若 ptr 是当前块中最后一次分配且剩余空间足够则原地扩展，否则分配新空间并复制旧内容，
+ * 旧空间随 Arena 一起回收
+ * @param arena Arena 指针
+ * @param ptr 原内存指针（可为 NULL，等同于 cn_arena_alloc）
+ * @param old_size 原大小
+ * @param new_size 新大小（不大于 old_size 时直接返回 ptr）
+ * @return 内存指针，失败返回 NULL（原内存保持不变）
+ */
+void *cn_arena_realloc(CnArena *arena, void *ptr, size_t old_size, size_t new_size);
+
+/*
+ * 在 Arena 中复制字符串（结果以 '\0' 结尾）
+ * @param arena Arena 指针
+ * @param str 源字符串
+ * @param length 复制的字节数
+ * @return 字符串副本，失败返回 NULL
+ */
+char *cn_arena_strndup(CnArena *arena, const char *str, size_t length);
+
 /*
  * 重置 Arena，释放所有块但保留第一个块供复用
  * @param arena Arena 指针
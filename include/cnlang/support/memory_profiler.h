@@ -20,6 +20,7 @@ typedef enum {
     CN_MEM_CATEGORY_SYMBOL,      /* 符号表 */
     CN_MEM_CATEGORY_IR,          /* IR 中间表示 */
     CN_MEM_CATEGORY_DIAGNOSTICS, /* 诊断信息 */
+    CN_MEM_CATEGORY_STRING_POOL, /* 字符串驻留池 */
     CN_MEM_CATEGORY_OTHER,       /* 其他 */
     CN_MEM_CATEGORY_COUNT        /* 类别总数 */
 } CnMemCategory;
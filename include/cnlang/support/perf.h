@@ -45,6 +45,12 @@ typedef struct {
     bool enabled;            /* 是否启用性能测量 */
     const char *source_file; /* 源文件名 */
     size_t source_size;      /* 源文件大小（字节） */
+    size_t macro_count;              /* 预处理结束时的宏定义数量 */
+    size_t macro_expansion_count;    /* 宏展开次数 */
+    uint64_t macro_expansion_time_us; /* 宏展开累计耗时（微秒） */
+    size_t template_instance_count;  /* 模板缓存中的实例数量 */
+    size_t template_cache_hits;      /* 模板实例化请求命中缓存的次数 */
+    size_t template_cache_misses;    /* 模板实例化请求未命中的次数 */
 } CnPerfStats;
 
 /* 获取当前时间戳（微秒） */
@@ -62,6 +68,14 @@ void cn_perf_start(CnPerfStats *stats, CnPerfPhase phase);
 /* 结束测量某个阶段 */
 void cn_perf_end(CnPerfStats *stats, CnPerfPhase phase);
 
+/* 记录预处理器的宏统计 */
+void cn_perf_record_macro_stats(CnPerfStats *stats, size_t macro_count,
+                                size_t expansion_count, uint64_t expansion_time_us);
+
+/* 记录模板实例化缓存统计 */
+void cn_perf_record_template_stats(CnPerfStats *stats, size_t instance_count,
+                                   size_t hit_count, size_t miss_count);
+
 /* 获取某个阶段的耗时（微秒） */
 uint64_t cn_perf_get_duration(const CnPerfStats *stats, CnPerfPhase phase);
 
@@ -0,0 +1,96 @@
+#ifndef CN_SUPPORT_SOURCE_MANAGER_H
+#define CN_SUPPORT_SOURCE_MANAGER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * CN Language 源文件管理器
+ * 每个源文件只读入一次（优先使用内存映射），按规范化路径去重，
+ * 向词法分析、预处理、诊断等阶段提供在管理器生命周期内稳定的只读视图。
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 源文件视图
+typedef struct CnSourceFile {
+    char *path;                    // 规范化后的绝对路径（用于去重）
+    const char *data;              // 文件内容，保证 data[length] == '\0'
+    size_t length;                 // 文件内容长度（不含终止符）
+    uint32_t path_hash;            // 规范化路径的哈希值
+    bool is_mapped;                // 是否为内存映射（否则为堆缓冲区）
+    void *map_base;                // 映射/缓冲区基址（用于释放）
+    size_t map_size;               // 映射长度
+#ifdef _WIN32
+    void *file_handle;             // Windows 文件句柄
+    void *mapping_handle;          // Windows 映射对象句柄
+#endif
+} CnSourceFile;
+
+// 源文件管理器
+typedef struct CnSourceManager {
+    CnSourceFile **files;          // 已加载文件（按加载顺序）
+    size_t file_count;             // 已加载文件数量
+    size_t file_capacity;          // 文件数组容量
+    uint32_t *slots;               // 开放寻址哈希表：文件下标 + 1，0 表示空槽
+    size_t slot_count;             // 哈希表槽数（2 的幂）
+    size_t total_bytes;            // 已加载源文件总字节数
+} CnSourceManager;
+
+// =============================================================================
+// 管理器生命周期
+// =============================================================================
+
+/*
+ * 创建源文件管理器
+ * @return 管理器指针，失败返回 NULL
+ */
+CnSourceManager *cn_source_manager_new(void);
+
+/*
+ * 释放管理器及其持有的全部映射和缓冲区
+ * 注意：此后所有由该管理器返回的视图均失效
+ * @param manager 管理器指针
+ */
+void cn_source_manager_free(CnSourceManager *manager);
+
+/*
+ * 获取进程级共享管理器（首次调用时创建）
+ * 编译驱动和跨模块导入共用该实例，使同一文件只映射一次
+ * @return 共享管理器，失败返回 NULL
+ */
+CnSourceManager *cn_source_manager_default(void);
+
+/*
+ * 释放进程级共享管理器
+ */
+void cn_source_manager_release_default(void);
+
+// =============================================================================
+// 文件访问
+// =============================================================================
+
+/*
+ * 加载源文件，已加载过的文件（按规范化路径）直接返回已有视图
+ * @param manager 管理器指针
+ * @param path 文件路径（相对或绝对）
+ * @return 源文件视图，文件不存在或读取失败返回 NULL
+ */
+const CnSourceFile *cn_source_manager_load(CnSourceManager *manager, const char *path);
+
+/*
+ * 查找已加载的源文件，不触发磁盘读取
+ * @param manager 管理器指针
+ * @param path 文件路径（相对或绝对）
+ * @return 源文件视图，未加载返回 NULL
+ */
+const CnSourceFile *cn_source_manager_lookup(const CnSourceManager *manager, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CN_SUPPORT_SOURCE_MANAGER_H */
@@ -0,0 +1,159 @@
+#ifndef CN_SUPPORT_STRING_POOL_H
+#define CN_SUPPORT_STRING_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "cnlang/support/memory/arena.h"
+
+/*
+ * CN Language 字符串驻留池
+ * 标识符、结构体/类名、模块路径段等名字在池中只保存一份，并预先计算哈希。
+ * 同一个池返回的两个指针相等当且仅当字符串内容相等，查找时可直接比较指针。
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 驻留字符串头部，紧贴在字符串内容之前
+typedef struct CnInternHeader {
+    uint32_t hash;                 // 预计算的哈希值
+    uint32_t length;               // 字符串长度（不含终止符）
+} CnInternHeader;
+
+// 哈希表槽位
+typedef struct CnInternSlot {
+    const char *str;               // 驻留字符串（NULL 表示空槽）
+    uint32_t hash;                 // 哈希值（避免探测时回读头部）
+    uint32_t length;               // 字符串长度
+} CnInternSlot;
+
+// 字符串池统计信息
+typedef struct CnStringPoolStats {
+    size_t unique_count;           // 驻留的不同字符串数量
+    size_t intern_calls;           // 驻留请求次数
+    size_t hit_count;              // 命中已有字符串的次数
+    size_t string_bytes;           // 字符串内容总字节数
+    size_t table_bytes;            // 哈希表占用字节数
+    size_t arena_bytes;            // Arena 已分配字节数
+} CnStringPoolStats;
+
+// 字符串池
+typedef struct CnStringPool {
+    CnArena *arena;                // 字符串存储
+    CnInternSlot *slots;           // 开放寻址哈希表
+    size_t slot_count;             // 槽数（2 的幂）
+    size_t count;                  // 已驻留字符串数量
+    size_t intern_calls;           // 驻留请求次数
+    size_t hit_count;              // 命中次数
+    size_t string_bytes;           // 字符串内容总字节数
+    struct CnStringPool *overflow; // 并发模式下新字符串的暂存池
+    void *lock;                    // 并发模式下保护暂存池的互斥锁（CnMutex）
+    bool concurrent;               // 是否处于并发模式
+} CnStringPool;
+
+// =============================================================================
+// 池生命周期
+// =============================================================================
+
+/*
+ * 创建字符串池
+ * @return 字符串池指针，失败返回 NULL
+ */
+CnStringPool *cn_string_pool_new(void);
+
+/*
+ * 释放字符串池及其全部字符串
+ * @param pool 字符串池指针
+ */
+void cn_string_pool_free(CnStringPool *pool);
+
+/*
+ * 获取进程级共享字符串池（首次调用时创建）
+ * 解析器与语义分析共用该实例，使跨模块的同名标识符指向同一地址
+ * @return 共享字符串池，失败返回 NULL
+ */
+CnStringPool *cn_string_pool_default(void);
+
+/*
+ * 释放进程级共享字符串池
+ * 注意：此后所有驻留字符串均失效
+ */
+void cn_string_pool_release_default(void);
+
+// =============================================================================
+// 驻留与查找
+// =============================================================================
+
+/*
+ * 计算字符串哈希（FNV-1a）
+ */
+uint32_t cn_string_hash(const char *str, size_t length);
+
+/*
+ * 驻留字符串，内容相同的字符串返回同一指针
+ * @param pool 字符串池指针
+ * @param str 字符串（无需以 '\0' 结尾）
+ * @param length 字符串长度
+ * @return 以 '\0' 结尾的驻留字符串，失败返回 NULL
+ */
+const char *cn_string_pool_intern(CnStringPool *pool, const char *str, size_t length);
+
+/*
+ * 查找已驻留的字符串，不插入
+ * @return 驻留字符串，未驻留返回 NULL
+ */
+const char *cn_string_pool_find(const CnStringPool *pool, const char *str, size_t length);
+
+/*
+ * 进入并发模式：主哈希表冻结为只读，多个线程可同时驻留与查找。
+ * 命中主表的请求不加锁（也不计入统计），新字符串在互斥锁保护下写入暂存池。
+ * @return 成功返回 true
+ */
+bool cn_string_pool_begin_concurrent(CnStringPool *pool);
+
+/*
+ * 退出并发模式：把暂存池中的字符串并入主表，之前返回的指针仍然有效
+ * 调用前所有并发线程必须已经结束
+ */
+void cn_string_pool_end_concurrent(CnStringPool *pool);
+
+/*
+ * 获取字符串池统计信息
+ */
+void cn_string_pool_get_stats(const CnStringPool *pool, CnStringPoolStats *stats);
+
+/*
+ * 读取驻留字符串的预计算哈希（仅对池返回的指针有效）
+ */
+static inline uint32_t cn_interned_hash(const char *interned)
+{
+    return ((const CnInternHeader *)interned)[-1].hash;
+}
+
+/*
+ * 名字比较：驻留字符串命中指针相等快速路径，否则回退到逐字节比较
+ */
+static inline bool cn_name_equals(const char *a, size_t a_length,
+                                  const char *b, size_t b_length)
+{
+    if (a_length != b_length) {
+        return false;
+    }
+    if (a == b) {
+        return true;
+    }
+    if (!a || !b) {
+        return false;
+    }
+    return memcmp(a, b, a_length) == 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CN_SUPPORT_STRING_POOL_H */
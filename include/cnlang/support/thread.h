@@ -0,0 +1,141 @@
+#ifndef CN_SUPPORT_THREAD_H
+#define CN_SUPPORT_THREAD_H
+
+#include <stdbool.h>
+
+/*
+ * CN Language 线程与互斥锁的最小封装
+ * POSIX 平台使用 pthread，Windows 使用系统线程 API（与词法分析器的并行模式一致）。
+ * 仅提供编译器内部并行阶段需要的启动/等待线程、互斥锁、原子计数器与 CPU 核数查询。
+ */
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*CnThreadFunc)(void *arg);
+
+// 原子计数器：只用于编号与统计，不提供内存顺序保证
+typedef volatile long CnAtomicCounter;
+
+#ifdef _WIN32
+typedef CRITICAL_SECTION CnMutex;
+
+typedef struct CnThread {
+    HANDLE handle;
+    CnThreadFunc func;
+    void *arg;
+} CnThread;
+
+static inline DWORD WINAPI cn_thread_entry(LPVOID arg)
+{
+    CnThread *thread = (CnThread *)arg;
+    thread->func(thread->arg);
+    return 0;
+}
+
+static inline bool cn_thread_start(CnThread *thread, CnThreadFunc func, void *arg)
+{
+    thread->func = func;
+    thread->arg = arg;
+    thread->handle = CreateThread(NULL, 0, cn_thread_entry, thread, 0, NULL);
+    return thread->handle != NULL;
+}
+
+static inline void cn_thread_join(CnThread *thread)
+{
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+}
+
+static inline unsigned cn_thread_cpu_count(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (unsigned)info.dwNumberOfProcessors : 1;
+}
+
+static inline bool cn_mutex_init(CnMutex *mutex)
+{
+    InitializeCriticalSection(mutex);
+    return true;
+}
+
+static inline void cn_mutex_destroy(CnMutex *mutex) { DeleteCriticalSection(mutex); }
+static inline void cn_mutex_lock(CnMutex *mutex) { EnterCriticalSection(mutex); }
+static inline void cn_mutex_unlock(CnMutex *mutex) { LeaveCriticalSection(mutex); }
+
+// 递增计数器并返回递增后的值
+static inline long cn_atomic_increment(CnAtomicCounter *counter) { return InterlockedIncrement(counter); }
+static inline long cn_atomic_load(CnAtomicCounter *counter) { return InterlockedCompareExchange(counter, 0, 0); }
+#else
+typedef pthread_mutex_t CnMutex;
+
+typedef struct CnThread {
+    pthread_t handle;
+    CnThreadFunc func;
+    void *arg;
+} CnThread;
+
+static inline void *cn_thread_entry(void *arg)
+{
+    CnThread *thread = (CnThread *)arg;
+    thread->func(thread->arg);
+    return NULL;
+}
+
+// thread 在线程结束前必须保持有效
+static inline bool cn_thread_start(CnThread *thread, CnThreadFunc func, void *arg)
+{
+    thread->func = func;
+    thread->arg = arg;
+    return pthread_create(&thread->handle, NULL, cn_thread_entry, thread) == 0;
+}
+
+static inline void cn_thread_join(CnThread *thread)
+{
+    pthread_join(thread->handle, NULL);
+}
+
+static inline unsigned cn_thread_cpu_count(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (unsigned)count : 1;
+}
+
+static inline bool cn_mutex_init(CnMutex *mutex)
+{
+    return pthread_mutex_init(mutex, NULL) == 0;
+}
+
+static inline void cn_mutex_destroy(CnMutex *mutex) { pthread_mutex_destroy(mutex); }
+static inline void cn_mutex_lock(CnMutex *mutex) { pthread_mutex_lock(mutex); }
+static inline void cn_mutex_unlock(CnMutex *mutex) { pthread_mutex_unlock(mutex); }
+
+// 递增计数器并返回递增后的值
+static inline long cn_atomic_increment(CnAtomicCounter *counter)
+{
+    return __atomic_add_fetch(counter, 1, __ATOMIC_RELAXED);
+}
+
+static inline long cn_atomic_load(CnAtomicCounter *counter)
+{
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CN_SUPPORT_THREAD_H */
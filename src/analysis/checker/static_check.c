@@ -1,6 +1,7 @@
 #include "cnlang/analysis/static_check.h"
 #include "cnlang/frontend/lexer.h"
 #include "cnlang/frontend/parser.h"
+#include "cnlang/support/source_manager.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -425,24 +426,14 @@ bool cn_check_file(
     }
 
     // 读取文件内容
-    FILE *fp = fopen(filename, "rb");
-    if (!fp) {
+    CnSourceManager *sources = cn_source_manager_new();
+    const CnSourceFile *source_file = cn_source_manager_load(sources, filename);
+    if (!source_file) {
+        cn_source_manager_free(sources);
         return false;
     }
-
-    fseek(fp, 0, SEEK_END);
-    long size = ftell(fp);
-    fseek(fp, 0, SEEK_SET);
-
-    char *source = (char *)malloc(size + 1);
-    if (!source) {
-        fclose(fp);
-        return false;
-    }
-
-    size_t length = fread(source, 1, size, fp);
-    fclose(fp);
-    source[length] = '\0';
+    const char *source = source_file->data;
+    size_t length = source_file->length;
 
     // 执行前端解析
     CnLexer lexer;
@@ -451,7 +442,7 @@ bool cn_check_file(
 
     CnParser *parser = cn_frontend_parser_new(&lexer);
     if (!parser) {
-        free(source);
+        cn_source_manager_free(sources);
         return false;
     }
     cn_frontend_parser_set_diagnostics(parser, diagnostics);
@@ -470,7 +461,7 @@ bool cn_check_file(
         cn_frontend_ast_program_free(program);
     }
     cn_frontend_parser_free(parser);
-    free(source);
+    cn_source_manager_free(sources);
 
     return success;
 }
@@ -13,6 +13,8 @@
 #include <assert.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <limits.h>
+#include <math.h>
 #if !defined(_WIN32) && !defined(_WIN64)
 #include <sys/mman.h>
 #endif
@@ -335,6 +337,69 @@ static bool names_match_with_suffix(const char *name1, const char *name2) {
     return false;
 }
 
+/* 当前函数的 ALLOCA 变量名（按块与指令顺序），在 cn_cgen_function 生成函数体期间有效。
+ * print_operand 对每个符号操作数都要判断其是否为局部变量，逐条遍历函数的指令
+ * 会使长表达式的代码生成随指令数平方增长。 */
+static CnIrFunction *g_alloca_names_func = NULL;
+static const char **g_alloca_names = NULL;
+static size_t g_alloca_name_count = 0;
+
+static void alloca_names_free(void) {
+    free(g_alloca_names);
+    g_alloca_names = NULL;
+    g_alloca_name_count = 0;
+    g_alloca_names_func = NULL;
+}
+
+static void alloca_names_build(CnIrFunction *func) {
+    size_t capacity = 0;
+
+    alloca_names_free();
+    for (CnIrBasicBlock *block = func->first_block; block; block = block->next) {
+        for (CnIrInst *inst = block->first_inst; inst; inst = inst->next) {
+            if (inst->kind != CN_IR_INST_ALLOCA || inst->dest.kind != CN_IR_OP_SYMBOL ||
+                !inst->dest.as.sym_name) {
+                continue;
+            }
+            if (g_alloca_name_count == capacity) {
+                size_t new_capacity = capacity ? capacity * 2 : 16;
+                const char **names = (const char **)realloc((void *)g_alloca_names,
+                                                            new_capacity * sizeof(const char *));
+                if (!names) {
+                    // 内存不足时不使用缓存，查找退回逐条遍历
+                    alloca_names_free();
+                    return;
+                }
+                g_alloca_names = names;
+                capacity = new_capacity;
+            }
+            g_alloca_names[g_alloca_name_count++] = inst->dest.as.sym_name;
+        }
+    }
+    g_alloca_names_func = func;
+}
+
+// 在 func 的 ALLOCA 变量中按顺序查找第一个与 sym_name 匹配的名称（规则同 names_match_with_suffix）
+static const char *find_alloca_name(CnIrFunction *func, const char *sym_name) {
+    if (func == g_alloca_names_func) {
+        for (size_t i = 0; i < g_alloca_name_count; i++) {
+            if (names_match_with_suffix(g_alloca_names[i], sym_name)) {
+                return g_alloca_names[i];
+            }
+        }
+        return NULL;
+    }
+    for (CnIrBasicBlock *block = func->first_block; block; block = block->next) {
+        for (CnIrInst *inst = block->first_inst; inst; inst = inst->next) {
+            if (inst->kind == CN_IR_INST_ALLOCA && inst->dest.kind == CN_IR_OP_SYMBOL &&
+                inst->dest.as.sym_name && names_match_with_suffix(inst->dest.as.sym_name, sym_name)) {
+                return inst->dest.as.sym_name;
+            }
+        }
+    }
+    return NULL;
+}
+
 /* 运行时库函数冲突检测：检测函数名是否与运行时库函数冲突 */
 static bool is_runtime_function_conflict(const char *func_name) {
     if (!func_name) return false;
@@ -791,6 +856,155 @@ static const char *get_c_variable_name(const char *name) {
 // 前向声明
 static void cn_cgen_expr_simple(CnCCodeGenContext *ctx, CnAstExpr *expr);
 
+// 常量数组中的单个值输出为 C 常量
+static void cn_cgen_const_value(FILE *file, const CnIrConstValue *value) {
+    switch (value->kind) {
+        case CN_IR_CONST_INT:
+            if (value->as.i == LLONG_MIN) {
+                fprintf(file, "(-%lldLL - 1)", LLONG_MAX);
+            } else {
+                fprintf(file, "%lld", value->as.i);
+            }
+            break;
+        case CN_IR_CONST_FLOAT:
+            if (isinf(value->as.f)) {
+                fprintf(file, value->as.f < 0 ? "-1e999" : "1e999");
+            } else {
+                fprintf(file, "%.17g", value->as.f);
+            }
+            break;
+        case CN_IR_CONST_STR:
+            fputc('"', file);
+            for (const char *p = value->as.s; p && *p; p++) {
+                switch (*p) {
+                    case '\\': fputs("\\\\", file); break;
+                    case '\"': fputs("\\\"", file); break;
+                    case '\n': fputs("\\n", file); break;
+                    case '\r': fputs("\\r", file); break;
+                    case '\t': fputs("\\t", file); break;
+                    default: fputc(*p, file); break;
+                }
+            }
+            fputc('"', file);
+            break;
+    }
+}
+
+// MSVC 拼接后的字符串字面量不得超过 65535 字节（C2026），更大的资源改用初始化列表
+#define CN_CGEN_MAX_STRING_LITERAL 65535
+
+// 超过字符串字面量上限的资源逐字节输出为八进制字符常量列表（对有/无符号 char 均不溢出）
+static void cn_cgen_const_byte_list(FILE *file, const unsigned char *bytes, size_t size) {
+    char line[7 * 32 + 8];
+
+    fputc('{', file);
+    for (size_t offset = 0; offset < size; offset += 32) {
+        size_t end = size - offset < 32 ? size : offset + 32;
+        size_t length = 0;
+
+        line[length++] = '\n';
+        for (size_t i = offset; i < end; i++) {
+            unsigned char c = bytes[i];
+            line[length++] = '\'';
+            line[length++] = '\\';
+            line[length++] = (char)('0' + (c >> 6));
+            line[length++] = (char)('0' + ((c >> 3) & 7));
+            line[length++] = (char)('0' + (c & 7));
+            line[length++] = '\'';
+            if (i + 1 < size) {
+                line[length++] = ',';
+            }
+        }
+        fwrite(line, 1, length, file);
+    }
+    fputs("\n}", file);
+}
+
+// 嵌入资源的字节输出为相邻拼接的字符串字面量（C 编译器处理字符串远快于逐元素初始化列表）；
+// 可打印字符原样输出，其余一律用三位八进制转义，避免与后续数字字符连读
+static void cn_cgen_const_bytes(FILE *file, const unsigned char *bytes, size_t size) {
+    char line[4 * 64 + 8];
+
+    if (size >= CN_CGEN_MAX_STRING_LITERAL) {
+        cn_cgen_const_byte_list(file, bytes, size);
+        return;
+    }
+
+    for (size_t offset = 0; offset < size; offset += 64) {
+        size_t end = size - offset < 64 ? size : offset + 64;
+        size_t length = 0;
+
+        line[length++] = '\n';
+        line[length++] = '"';
+        for (size_t i = offset; i < end; i++) {
+            unsigned char c = bytes[i];
+            if (c >= 0x20 && c < 0x7f && c != '\\' && c != '"' && c != '?') {
+                line[length++] = (char)c;
+            } else {
+                line[length++] = '\\';
+                line[length++] = (char)('0' + (c >> 6));
+                line[length++] = (char)('0' + ((c >> 3) & 7));
+                line[length++] = (char)('0' + (c & 7));
+            }
+        }
+        line[length++] = '"';
+        fwrite(line, 1, length, file);
+    }
+}
+
+// 常量数组初始化器 {v0, v1, ...}，结构体元素输出为 {.字段 = 值, ...}（按位置初始化时省略字段名）
+static void cn_cgen_const_array_initializer(FILE *file, const CnIrConstArray *array) {
+    const CnIrConstValue *value = array->values;
+    size_t per_line = array->field_count ? 4 : 16;
+
+    if (array->bytes) {
+        cn_cgen_const_bytes(file, array->bytes, array->element_count);
+        return;
+    }
+
+    fputc('{', file);
+    for (size_t i = 0; i < array->element_count; i++) {
+        fputs(i == 0 ? "\n    " : (i % per_line == 0 ? ",\n    " : ", "), file);
+        if (array->field_count == 0) {
+            cn_cgen_const_value(file, value++);
+            continue;
+        }
+        fputc('{', file);
+        for (size_t f = 0; f < array->field_count; f++) {
+            if (f > 0) {
+                fputs(", ", file);
+            }
+            if (array->field_names) {
+                fprintf(file, ".%s = ", array->field_names[f]);
+            }
+            cn_cgen_const_value(file, value++);
+        }
+        fputc('}', file);
+    }
+    fputs("\n}", file);
+}
+
+// 局部数组初始化使用的只读表（文件作用域，按表整体复制初始值）
+static void cn_cgen_const_array_tables(FILE *file, const CnIrModule *module) {
+    bool has_table = false;
+    for (const CnIrConstArray *array = module->first_const_array; array; array = array->next) {
+        if (!array->emit_table) {
+            continue;
+        }
+        if (!has_table) {
+            fprintf(file, "// Constant Array Tables\n");
+            has_table = true;
+        }
+        fprintf(file, "static %s const cn_const_%d[%zu] = ",
+                get_c_type_string(array->element_type), array->id, array->element_count);
+        cn_cgen_const_array_initializer(file, array);
+        fprintf(file, ";\n");
+    }
+    if (has_table) {
+        fprintf(file, "\n");
+    }
+}
+
 static void print_operand(CnCCodeGenContext *ctx, CnIrOperand op) {
     switch (op.kind) {
         // 【P3-4修复】NONE操作数在C中不是有效表达式，替换为NULL
@@ -919,22 +1133,7 @@ static void print_operand(CnCCodeGenContext *ctx, CnIrOperand op) {
                 // 如果符号名不匹配任何ALLOCA变量和函数参数，且不是枚举成员，
                 // 则可能是类型名
                 if (!is_struct_type_name && ctx->current_func) {
-                    bool is_alloca_var = false;
-                    CnIrBasicBlock *chk_block = ctx->current_func->first_block;
-                    while (chk_block && !is_alloca_var) {
-                        CnIrInst *chk_inst = chk_block->first_inst;
-                        while (chk_inst) {
-                            if (chk_inst->kind == CN_IR_INST_ALLOCA &&
-                                chk_inst->dest.kind == CN_IR_OP_SYMBOL &&
-                                chk_inst->dest.as.sym_name &&
-                                names_match_with_suffix(chk_inst->dest.as.sym_name, op.as.sym_name)) {
-                                is_alloca_var = true;
-                                break;
-                            }
-                            chk_inst = chk_inst->next;
-                        }
-                        chk_block = chk_block->next;
-                    }
+                    bool is_alloca_var = find_alloca_name(ctx->current_func, op.as.sym_name) != NULL;
                     // 也检查函数参数
                     if (!is_alloca_var) {
                         for (size_t p = 0; p < ctx->current_func->param_count; p++) {
@@ -1075,23 +1274,8 @@ static void print_operand(CnCCodeGenContext *ctx, CnIrOperand op) {
                     
                     if (needs_suffix_lookup && ctx->current_func) {
                         // 在当前函数的ALLOCA指令中查找带后缀的匹配变量名
-                        const char *matched_name = NULL;
-                        CnIrBasicBlock *lookup_block = ctx->current_func->first_block;
-                        while (lookup_block && !matched_name) {
-                            CnIrInst *lookup_inst = lookup_block->first_inst;
-                            while (lookup_inst) {
-                                if (lookup_inst->kind == CN_IR_INST_ALLOCA &&
-                                    lookup_inst->dest.kind == CN_IR_OP_SYMBOL &&
-                                    lookup_inst->dest.as.sym_name &&
-                                    names_match_with_suffix(lookup_inst->dest.as.sym_name, op.as.sym_name)) {
-                                    // 找到匹配的ALLOCA变量，使用其完整名称（带后缀）
-                                    matched_name = lookup_inst->dest.as.sym_name;
-                                    break;
-                                }
-                                lookup_inst = lookup_inst->next;
-                            }
-                            lookup_block = lookup_block->next;
-                        }
+                        // 找到匹配的ALLOCA变量时使用其完整名称（带后缀）
+                        const char *matched_name = find_alloca_name(ctx->current_func, op.as.sym_name);
                         
                         // 也检查函数参数
                         if (!matched_name) {
@@ -1124,12 +1308,60 @@ static void print_operand(CnCCodeGenContext *ctx, CnIrOperand op) {
             // AST表达式：直接生成 C 代码（用于结构体字面量等）
             cn_cgen_expr_simple(ctx, op.as.ast_expr);
             break;
+        case CN_IR_OP_CONST_ARRAY:
+            fprintf(ctx->output_file, "cn_const_%d", op.as.const_array->id);
+            break;
         default:
             fprintf(ctx->output_file, "/* unknown_op kind=%d */", op.kind);
             break;
     }
 }
 
+// 二元运算链：左结合长链（a + b + ...）先自顶向下输出各层的左括号，
+// 再输出链底，自底向上输出运算符与右操作数，不逐层递归
+static void cn_cgen_binary_chain(CnCCodeGenContext *ctx, CnAstExpr *expr) {
+    CnAstExprChain chain;
+
+    if (!cn_frontend_ast_expr_chain_collect(&chain, expr)) {
+        return;
+    }
+    for (size_t i = 0; i < chain.count; i++) {
+        // 检查是否为字符串拼接
+        fprintf(ctx->output_file, cgen_is_string_concat(chain.nodes[i]) ? "cn_rt_string_concat(" : "(");
+    }
+    cn_cgen_expr_simple(ctx, cn_frontend_ast_expr_chain_leaf(&chain));
+    for (size_t i = chain.count; i-- > 0;) {
+        CnAstExpr *node = chain.nodes[i];
+        if (cgen_is_string_concat(node)) {
+            fprintf(ctx->output_file, ", ");
+        } else {
+            // 生成运算符
+            switch (node->as.binary.op) {
+                case CN_AST_BINARY_OP_ADD: fprintf(ctx->output_file, " + "); break;
+                case CN_AST_BINARY_OP_SUB: fprintf(ctx->output_file, " - "); break;
+                case CN_AST_BINARY_OP_MUL: fprintf(ctx->output_file, " * "); break;
+                case CN_AST_BINARY_OP_DIV: fprintf(ctx->output_file, " / "); break;
+                case CN_AST_BINARY_OP_MOD: fprintf(ctx->output_file, " %% "); break;
+                case CN_AST_BINARY_OP_EQ: fprintf(ctx->output_file, " == "); break;
+                case CN_AST_BINARY_OP_NE: fprintf(ctx->output_file, " != "); break;
+                case CN_AST_BINARY_OP_LT: fprintf(ctx->output_file, " < "); break;
+                case CN_AST_BINARY_OP_GT: fprintf(ctx->output_file, " > "); break;
+                case CN_AST_BINARY_OP_LE: fprintf(ctx->output_file, " <= "); break;
+                case CN_AST_BINARY_OP_GE: fprintf(ctx->output_file, " >= "); break;
+                case CN_AST_BINARY_OP_BITWISE_AND: fprintf(ctx->output_file, " & "); break;
+                case CN_AST_BINARY_OP_BITWISE_OR: fprintf(ctx->output_file, " | "); break;
+                case CN_AST_BINARY_OP_BITWISE_XOR: fprintf(ctx->output_file, " ^ "); break;
+                case CN_AST_BINARY_OP_LEFT_SHIFT: fprintf(ctx->output_file, " << "); break;
+                case CN_AST_BINARY_OP_RIGHT_SHIFT: fprintf(ctx->output_file, " >> "); break;
+                default: fprintf(ctx->output_file, " ? "); break;
+            }
+        }
+        cn_cgen_expr_simple(ctx, node->as.binary.right);
+        fprintf(ctx->output_file, ")");
+    }
+    cn_frontend_ast_expr_chain_free(&chain);
+}
+
 // 生成简单表达式的 C 代码（用于模块变量初始化）
 static void cn_cgen_expr_simple(CnCCodeGenContext *ctx, CnAstExpr *expr) {
     if (!ctx || !expr) return;
@@ -1469,41 +1701,7 @@ static void cn_cgen_expr_simple(CnCCodeGenContext *ctx, CnAstExpr *expr) {
             }
             break;
         case CN_AST_EXPR_BINARY:
-            // 检查是否为字符串拼接
-            if (cgen_is_string_concat(expr)) {
-                fprintf(ctx->output_file, "cn_rt_string_concat(");
-                cn_cgen_expr_simple(ctx, expr->as.binary.left);
-                fprintf(ctx->output_file, ", ");
-                cn_cgen_expr_simple(ctx, expr->as.binary.right);
-                fprintf(ctx->output_file, ")");
-                break;
-            }
-            fprintf(ctx->output_file, "(");
-            cn_cgen_expr_simple(ctx, expr->as.binary.left);
-            
-            // 生成运算符
-            switch (expr->as.binary.op) {
-                case CN_AST_BINARY_OP_ADD: fprintf(ctx->output_file, " + "); break;
-                case CN_AST_BINARY_OP_SUB: fprintf(ctx->output_file, " - "); break;
-                case CN_AST_BINARY_OP_MUL: fprintf(ctx->output_file, " * "); break;
-                case CN_AST_BINARY_OP_DIV: fprintf(ctx->output_file, " / "); break;
-                case CN_AST_BINARY_OP_MOD: fprintf(ctx->output_file, " %% "); break;
-                case CN_AST_BINARY_OP_EQ: fprintf(ctx->output_file, " == "); break;
-                case CN_AST_BINARY_OP_NE: fprintf(ctx->output_file, " != "); break;
-                case CN_AST_BINARY_OP_LT: fprintf(ctx->output_file, " < "); break;
-                case CN_AST_BINARY_OP_GT: fprintf(ctx->output_file, " > "); break;
-                case CN_AST_BINARY_OP_LE: fprintf(ctx->output_file, " <= "); break;
-                case CN_AST_BINARY_OP_GE: fprintf(ctx->output_file, " >= "); break;
-                case CN_AST_BINARY_OP_BITWISE_AND: fprintf(ctx->output_file, " & "); break;
-                case CN_AST_BINARY_OP_BITWISE_OR: fprintf(ctx->output_file, " | "); break;
-                case CN_AST_BINARY_OP_BITWISE_XOR: fprintf(ctx->output_file, " ^ "); break;
-                case CN_AST_BINARY_OP_LEFT_SHIFT: fprintf(ctx->output_file, " << "); break;
-                case CN_AST_BINARY_OP_RIGHT_SHIFT: fprintf(ctx->output_file, " >> "); break;
-                default: fprintf(ctx->output_file, " ? "); break;
-            }
-            
-            cn_cgen_expr_simple(ctx, expr->as.binary.right);
-            fprintf(ctx->output_file, ")");
+            cn_cgen_binary_chain(ctx, expr);
             break;
         case CN_AST_EXPR_UNARY:
             // 一元运算
@@ -1843,6 +2041,15 @@ void cn_cgen_inst(CnCCodeGenContext *ctx, CnIrInst *inst) {
             // 根因：函数调用返回值未被捕获时，STORE的源操作数为NONE
             if (inst->src1.kind == CN_IR_OP_NONE) break;
             
+            // 全常量数组初始化：从文件作用域只读表整体复制
+            if (inst->src1.kind == CN_IR_OP_CONST_ARRAY) {
+                fprintf(ctx->output_file, "  cn_rt_mem_copy(");
+                print_operand(ctx, inst->dest);
+                fprintf(ctx->output_file, ", cn_const_%d, sizeof(cn_const_%d));\n",
+                        inst->src1.as.const_array->id, inst->src1.as.const_array->id);
+                break;
+            }
+            
             // 检查目标是否需要解引用
             // 情况1：目标操作数是寄存器（通过 GET_ELEMENT_PTR 获取的地址）- 需要解引用
             // 情况2：目标操作数是符号（变量名）- 不需要解引用
@@ -3275,6 +3482,90 @@ static CnType* lookup_struct_member_type_cgen(CnType *obj_type, const char *memb
     return NULL;  // 未找到
 }
 
+/* 寄存器引用索引：按指令顺序记录每个寄存器作为 dest 或 src1 出现的指令
+ * 二次类型推断的各条规则只匹配 dest/src1 为目标寄存器的指令，按索引遍历
+ * 与按块逐条扫描的顺序相同，避免每个寄存器都扫描整个函数（寄存器数 × 指令数）
+ */
+typedef struct RegUseIndex {
+    int reg_count;           // 出现过的最大寄存器编号 + 1
+    size_t *offsets;         // 寄存器 r 的指令为 insts[offsets[r], offsets[r + 1])
+    CnIrInst **insts;
+} RegUseIndex;
+
+static int reg_use_of(const CnIrOperand *op) {
+    return op->kind == CN_IR_OP_REG ? op->as.reg_id : -1;
+}
+
+static void reg_use_index_free(RegUseIndex *index) {
+    free(index->offsets);
+    free(index->insts);
+    index->offsets = NULL;
+    index->insts = NULL;
+    index->reg_count = 0;
+}
+
+static bool reg_use_index_build(RegUseIndex *index, CnIrFunction *func) {
+    size_t total = 0;
+    index->reg_count = 0;
+    index->offsets = NULL;
+    index->insts = NULL;
+
+    for (CnIrBasicBlock *block = func->first_block; block; block = block->next) {
+        for (CnIrInst *inst = block->first_inst; inst; inst = inst->next) {
+            int dest = reg_use_of(&inst->dest);
+            int src1 = reg_use_of(&inst->src1);
+            if (dest >= index->reg_count) index->reg_count = dest + 1;
+            if (src1 >= index->reg_count) index->reg_count = src1 + 1;
+        }
+    }
+    index->offsets = calloc((size_t)index->reg_count + 1, sizeof(size_t));
+    if (!index->offsets) return false;
+
+    /* 先计数，再按指令顺序填入；dest 与 src1 为同一寄存器时只记录一次 */
+    for (int pass = 0; pass < 2; pass++) {
+        for (CnIrBasicBlock *block = func->first_block; block; block = block->next) {
+            for (CnIrInst *inst = block->first_inst; inst; inst = inst->next) {
+                int regs[2] = { reg_use_of(&inst->dest), reg_use_of(&inst->src1) };
+                for (int k = 0; k < 2; k++) {
+                    if (regs[k] < 0 || (k == 1 && regs[1] == regs[0])) continue;
+                    if (pass == 0) {
+                        index->offsets[regs[k] + 1]++;
+                    } else {
+                        index->insts[index->offsets[regs[k]]++] = inst;
+                    }
+                }
+            }
+        }
+        if (pass == 0) {
+            for (int r = 0; r < index->reg_count; r++) {
+                index->offsets[r + 1] += index->offsets[r];
+            }
+            total = index->offsets[index->reg_count];
+            index->insts = malloc((total ? total : 1) * sizeof(CnIrInst *));
+            if (!index->insts) {
+                reg_use_index_free(index);
+                return false;
+            }
+        }
+    }
+    /* 填入时 offsets[r] 前移到了区间末尾（即 r + 1 的起点），整体右移一位复原 */
+    for (int r = index->reg_count; r > 0; r--) {
+        index->offsets[r] = index->offsets[r - 1];
+    }
+    index->offsets[0] = 0;
+    return true;
+}
+
+/* 寄存器 reg 的指令区间 [*out_begin, *out_end) */
+static void reg_use_range(const RegUseIndex *index, int reg, size_t *out_begin, size_t *out_end) {
+    if (reg < 0 || reg >= index->reg_count) {
+        *out_begin = *out_end = 0;
+        return;
+    }
+    *out_begin = index->offsets[reg];
+    *out_end = index->offsets[reg + 1];
+}
+
 /**
  * @brief 从MEMBER_ACCESS指令推断寄存器的结构体指针类型
  *
@@ -3287,117 +3578,111 @@ static CnType* lookup_struct_member_type_cgen(CnType *obj_type, const char *memb
  * @param alloca_types ALLOCA变量类型映射表
  * @return 推断出的类型，无法推断返回NULL
  */
-static CnType* infer_from_member_access(CnCCodeGenContext *ctx, CnIrFunction *func,
+static CnType* infer_from_member_access(CnCCodeGenContext *ctx, CnIrFunction *func, const RegUseIndex *uses,
                                          int reg_index, AllocaTypeEntry *alloca_types) {
-    CnIrBasicBlock *block = func->first_block;
-    while (block) {
-        CnIrInst *inst = block->first_inst;
-        while (inst) {
-            if (inst->kind == CN_IR_INST_MEMBER_ACCESS &&
-                inst->src1.kind == CN_IR_OP_REG &&
-                inst->src1.as.reg_id == reg_index) {
-                /* 寄存器被用作成员访问的base */
-                /* 检查是否应该使用 -> 语法（即base是指针类型） */
-                bool base_is_pointer = false;
-                CnType *pointer_type = NULL;
-                
-                /* 从src1.type判断 */
-                if (inst->src1.type) {
-                    CnType *check = (CnType *)inst->src1.type;
-                    if (check->kind >= 0 && check->kind <= CN_TYPE_UNKNOWN) {
-                        if (check->kind == CN_TYPE_POINTER) {
-                            base_is_pointer = true;
-                            pointer_type = inst->src1.type;
-                        } else if (check->kind == CN_TYPE_STRING) {
-                            /* char* 也是指针 */
-                            base_is_pointer = true;
-                            pointer_type = inst->src1.type;
-                        }
-                    } else {
-                        /* 可能是struct类型节点，检查指针层级 */
-                        long long *ptr_level = (long long *)((char *)inst->src1.type + 24);
-                        if (*ptr_level > 0) {
-                            base_is_pointer = true;
-                            pointer_type = inst->src1.type;
-                        }
+    size_t use, use_end;
+    reg_use_range(uses, reg_index, &use, &use_end);
+    for (; use < use_end; use++) {
+        CnIrInst *inst = uses->insts[use];
+        if (inst->kind == CN_IR_INST_MEMBER_ACCESS &&
+            inst->src1.kind == CN_IR_OP_REG &&
+            inst->src1.as.reg_id == reg_index) {
+            /* 寄存器被用作成员访问的base */
+            /* 检查是否应该使用 -> 语法（即base是指针类型） */
+            bool base_is_pointer = false;
+            CnType *pointer_type = NULL;
+            
+            /* 从src1.type判断 */
+            if (inst->src1.type) {
+                CnType *check = (CnType *)inst->src1.type;
+                if (check->kind >= 0 && check->kind <= CN_TYPE_UNKNOWN) {
+                    if (check->kind == CN_TYPE_POINTER) {
+                        base_is_pointer = true;
+                        pointer_type = inst->src1.type;
+                    } else if (check->kind == CN_TYPE_STRING) {
+                        /* char* 也是指针 */
+                        base_is_pointer = true;
+                        pointer_type = inst->src1.type;
                     }
-                }
-                
-                /* 从dest.type反推：如果dest是结构体成员类型，base可能是结构体指针 */
-                if (!base_is_pointer && inst->dest.type && inst->src1.type) {
-                    /* 如果src1.type是STRUCT类型，说明base应该是结构体指针 */
-                    CnType *src1_check = (CnType *)inst->src1.type;
-                    if (src1_check->kind >= 0 && src1_check->kind <= CN_TYPE_UNKNOWN &&
-                        src1_check->kind == CN_TYPE_STRUCT) {
-                        /* base是结构体值类型，需要升级为指针 */
-                        pointer_type = cn_type_new_pointer(inst->src1.type);
+                } else {
+                    /* 可能是struct类型节点，检查指针层级 */
+                    long long *ptr_level = (long long *)((char *)inst->src1.type + 24);
+                    if (*ptr_level > 0) {
                         base_is_pointer = true;
+                        pointer_type = inst->src1.type;
                     }
                 }
-                
-                /* 从reg_types查找 */
-                if (!base_is_pointer && inst->src1.kind == CN_IR_OP_REG) {
-                    /* 尝试从ctx->reg_types获取 */
-                    if (ctx->reg_types && reg_index < ctx->reg_types_count) {
-                        CnType *reg_type = ctx->reg_types[reg_index];
-                        if (reg_type && (reg_type->kind == CN_TYPE_POINTER ||
-                                         reg_type->kind == CN_TYPE_STRING)) {
-                            base_is_pointer = true;
-                            pointer_type = reg_type;
-                        }
+            }
+            
+            /* 从dest.type反推：如果dest是结构体成员类型，base可能是结构体指针 */
+            if (!base_is_pointer && inst->dest.type && inst->src1.type) {
+                /* 如果src1.type是STRUCT类型，说明base应该是结构体指针 */
+                CnType *src1_check = (CnType *)inst->src1.type;
+                if (src1_check->kind >= 0 && src1_check->kind <= CN_TYPE_UNKNOWN &&
+                    src1_check->kind == CN_TYPE_STRUCT) {
+                    /* base是结构体值类型，需要升级为指针 */
+                    pointer_type = cn_type_new_pointer(inst->src1.type);
+                    base_is_pointer = true;
+                }
+            }
+            
+            /* 从reg_types查找 */
+            if (!base_is_pointer && inst->src1.kind == CN_IR_OP_REG) {
+                /* 尝试从ctx->reg_types获取 */
+                if (ctx->reg_types && reg_index < ctx->reg_types_count) {
+                    CnType *reg_type = ctx->reg_types[reg_index];
+                    if (reg_type && (reg_type->kind == CN_TYPE_POINTER ||
+                                     reg_type->kind == CN_TYPE_STRING)) {
+                        base_is_pointer = true;
+                        pointer_type = reg_type;
                     }
                 }
-                
-                /* 【S3修复】当reg_types中寄存器类型为INT/NULL时，
-                 * 尝试追溯LOAD指令找到原始符号，从函数参数获取类型。
-                 * 这处理了：r1 = LOAD cn_var_类型1; r8 = r1->名称
-                 * 当r1的类型传播失败（仍为INT）时，通过LOAD追溯找到
-                 * cn_var_类型1是函数参数，类型为struct 类型信息* */
-                if (!base_is_pointer && inst->src1.kind == CN_IR_OP_REG && func) {
-                    CnIrBasicBlock *trace_block = func->first_block;
-                    while (trace_block && !base_is_pointer) {
-                        CnIrInst *trace_inst = trace_block->first_inst;
-                        while (trace_inst && !base_is_pointer) {
-                            if (trace_inst->kind == CN_IR_INST_LOAD &&
-                                trace_inst->dest.kind == CN_IR_OP_REG &&
-                                trace_inst->dest.as.reg_id == reg_index &&
-                                trace_inst->src1.kind == CN_IR_OP_SYMBOL &&
-                                trace_inst->src1.as.sym_name) {
-                                /* 找到LOAD指令，从函数参数查找符号类型 */
-                                const char *sym_name = trace_inst->src1.as.sym_name;
-                                for (size_t p = 0; p < func->param_count; p++) {
-                                    if (func->params[p].as.sym_name &&
-                                        names_match_with_suffix(func->params[p].as.sym_name, sym_name)) {
-                                        CnType *param_type = func->params[p].type;
-                                        if (param_type) {
-                                            if (param_type->kind == CN_TYPE_POINTER) {
-                                                base_is_pointer = true;
-                                                pointer_type = param_type;
-                                            } else if (param_type->kind == CN_TYPE_STRING) {
-                                                base_is_pointer = true;
-                                                pointer_type = param_type;
-                                            } else if (param_type->kind == CN_TYPE_STRUCT) {
-                                                pointer_type = cn_type_new_pointer(param_type);
-                                                base_is_pointer = true;
-                                            }
-                                        }
-                                        break;
+            }
+            
+            /* 【S3修复】当reg_types中寄存器类型为INT/NULL时，
+             * 尝试追溯LOAD指令找到原始符号，从函数参数获取类型。
+             * 这处理了：r1 = LOAD cn_var_类型1; r8 = r1->名称
+             * 当r1的类型传播失败（仍为INT）时，通过LOAD追溯找到
+             * cn_var_类型1是函数参数，类型为struct 类型信息* */
+            if (!base_is_pointer && inst->src1.kind == CN_IR_OP_REG && func) {
+                size_t trace_use, trace_end;
+                reg_use_range(uses, reg_index, &trace_use, &trace_end);
+                for (; trace_use < trace_end && !base_is_pointer; trace_use++) {
+                    CnIrInst *trace_inst = uses->insts[trace_use];
+                    if (trace_inst->kind == CN_IR_INST_LOAD &&
+                        trace_inst->dest.kind == CN_IR_OP_REG &&
+                        trace_inst->dest.as.reg_id == reg_index &&
+                        trace_inst->src1.kind == CN_IR_OP_SYMBOL &&
+                        trace_inst->src1.as.sym_name) {
+                        /* 找到LOAD指令，从函数参数查找符号类型 */
+                        const char *sym_name = trace_inst->src1.as.sym_name;
+                        for (size_t p = 0; p < func->param_count; p++) {
+                            if (func->params[p].as.sym_name &&
+                                names_match_with_suffix(func->params[p].as.sym_name, sym_name)) {
+                                CnType *param_type = func->params[p].type;
+                                if (param_type) {
+                                    if (param_type->kind == CN_TYPE_POINTER) {
+                                        base_is_pointer = true;
+                                        pointer_type = param_type;
+                                    } else if (param_type->kind == CN_TYPE_STRING) {
+                                        base_is_pointer = true;
+                                        pointer_type = param_type;
+                                    } else if (param_type->kind == CN_TYPE_STRUCT) {
+                                        pointer_type = cn_type_new_pointer(param_type);
+                                        base_is_pointer = true;
                                     }
                                 }
+                                break;
                             }
-                            trace_inst = trace_inst->next;
                         }
-                        trace_block = trace_block->next;
                     }
                 }
-                
-                if (base_is_pointer && pointer_type) {
-                    return pointer_type;
-                }
             }
-            inst = inst->next;
+            
+            if (base_is_pointer && pointer_type) {
+                return pointer_type;
+            }
         }
-        block = block->next;
     }
     return NULL;
 }
@@ -3560,87 +3845,84 @@ static CnType* lookup_func_param_type(CnCCodeGenContext *ctx,
  * @param reg_index 寄存器索引
  * @return 推断出的类型，无法推断返回NULL
  */
-static CnType* infer_from_call(CnCCodeGenContext *ctx, CnIrFunction *func, int reg_index) {
-    CnIrBasicBlock *block = func->first_block;
-    while (block) {
-        CnIrInst *inst = block->first_inst;
-        while (inst) {
-            if (inst->kind == CN_IR_INST_CALL &&
-                inst->dest.kind == CN_IR_OP_REG &&
-                inst->dest.as.reg_id == reg_index) {
-                
-                /* 优先使用dest.type（IR生成器设置的返回类型） */
-                if (inst->dest.type &&
-                    inst->dest.type->kind != CN_TYPE_INT &&
-                    inst->dest.type->kind != CN_TYPE_UNKNOWN &&
-                    inst->dest.type->kind != CN_TYPE_VOID) {
-                    return inst->dest.type;
-                }
+static CnType* infer_from_call(CnCCodeGenContext *ctx, CnIrFunction *func, const RegUseIndex *uses, int reg_index) {
+    size_t use, use_end;
+    reg_use_range(uses, reg_index, &use, &use_end);
+    for (; use < use_end; use++) {
+        CnIrInst *inst = uses->insts[use];
+        if (inst->kind == CN_IR_INST_CALL &&
+            inst->dest.kind == CN_IR_OP_REG &&
+            inst->dest.as.reg_id == reg_index) {
+            
+            /* 优先使用dest.type（IR生成器设置的返回类型） */
+            if (inst->dest.type &&
+                inst->dest.type->kind != CN_TYPE_INT &&
+                inst->dest.type->kind != CN_TYPE_UNKNOWN &&
+                inst->dest.type->kind != CN_TYPE_VOID) {
+                return inst->dest.type;
+            }
+            
+            /* 从全局符号表查找函数返回类型 */
+            if (inst->src1.kind == CN_IR_OP_SYMBOL && inst->src1.as.sym_name) {
+                const char *func_name = inst->src1.as.sym_name;
+                size_t func_name_len = strlen(func_name);
                 
-                /* 从全局符号表查找函数返回类型 */
-                if (inst->src1.kind == CN_IR_OP_SYMBOL && inst->src1.as.sym_name) {
-                    const char *func_name = inst->src1.as.sym_name;
-                    size_t func_name_len = strlen(func_name);
-                    
-                    /* 层级1：从全局符号表查找 */
-                    if (ctx->global_scope) {
-                        CnSemSymbol *func_sym = cn_sem_scope_lookup(ctx->global_scope, func_name, func_name_len);
-                        if (func_sym && func_sym->kind == CN_SEM_SYMBOL_FUNCTION && func_sym->type) {
-                            if (func_sym->type->kind == CN_TYPE_FUNCTION && func_sym->type->as.function.return_type) {
-                                CnType *ret_type = func_sym->type->as.function.return_type;
-                                /* 只返回非INT/UNKNOWN/VOID的精确类型 */
-                                if (ret_type->kind != CN_TYPE_INT &&
-                                    ret_type->kind != CN_TYPE_UNKNOWN &&
-                                    ret_type->kind != CN_TYPE_VOID) {
-                                    return ret_type;
-                                }
+                /* 层级1：从全局符号表查找 */
+                if (ctx->global_scope) {
+                    CnSemSymbol *func_sym = cn_sem_scope_lookup(ctx->global_scope, func_name, func_name_len);
+                    if (func_sym && func_sym->kind == CN_SEM_SYMBOL_FUNCTION && func_sym->type) {
+                        if (func_sym->type->kind == CN_TYPE_FUNCTION && func_sym->type->as.function.return_type) {
+                            CnType *ret_type = func_sym->type->as.function.return_type;
+                            /* 只返回非INT/UNKNOWN/VOID的精确类型 */
+                            if (ret_type->kind != CN_TYPE_INT &&
+                                ret_type->kind != CN_TYPE_UNKNOWN &&
+                                ret_type->kind != CN_TYPE_VOID) {
+                                return ret_type;
                             }
                         }
                     }
-                    
-                    /* 【RC1增强】层级2：从IR模块函数列表查找返回类型
-                     * 跨模块函数调用时，全局符号表可能不完整，
-                     * 但IR模块中包含了所有已编译函数的返回类型信息 */
-                    if (ctx->module) {
-                        CnIrFunction *mod_func = ctx->module->first_func;
-                        while (mod_func) {
-                            if (mod_func->name && strcmp(mod_func->name, func_name) == 0 &&
-                                mod_func->return_type &&
-                                mod_func->return_type->kind != CN_TYPE_INT &&
-                                mod_func->return_type->kind != CN_TYPE_UNKNOWN &&
-                                mod_func->return_type->kind != CN_TYPE_VOID) {
-                                return mod_func->return_type;
-                            }
-                            mod_func = mod_func->next;
+                }
+                
+                /* 【RC1增强】层级2：从IR模块函数列表查找返回类型
+                 * 跨模块函数调用时，全局符号表可能不完整，
+                 * 但IR模块中包含了所有已编译函数的返回类型信息 */
+                if (ctx->module) {
+                    CnIrFunction *mod_func = ctx->module->first_func;
+                    while (mod_func) {
+                        if (mod_func->name && strcmp(mod_func->name, func_name) == 0 &&
+                            mod_func->return_type &&
+                            mod_func->return_type->kind != CN_TYPE_INT &&
+                            mod_func->return_type->kind != CN_TYPE_UNKNOWN &&
+                            mod_func->return_type->kind != CN_TYPE_VOID) {
+                            return mod_func->return_type;
                         }
+                        mod_func = mod_func->next;
                     }
-                    
-                    /* 【RC1增强】层级3：运行时API函数名模式匹配
-                     * 常见的运行时函数有已知的返回类型模式，
-                     * 通过函数名前缀/后缀推断返回类型 */
-                    if (func_name_len > 4) {
-                        /* cn_rt_ 前缀的函数：运行时API */
-                        if (strncmp(func_name, "cn_rt_", 6) == 0) {
-                            /* cn_rt_strdup, cn_rt_strcat 等返回 char* */
-                            if (strstr(func_name, "str") || strstr(func_name, "path")) {
-                                return cn_type_new_primitive(CN_TYPE_STRING);
-                            }
-                            /* cn_rt_malloc, cn_rt_alloc 等返回 void* (用POINTER表示) */
-                            if (strstr(func_name, "alloc") || strstr(func_name, "malloc")) {
-                                return cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID));
-                            }
+                }
+                
+                /* 【RC1增强】层级3：运行时API函数名模式匹配
+                 * 常见的运行时函数有已知的返回类型模式，
+                 * 通过函数名前缀/后缀推断返回类型 */
+                if (func_name_len > 4) {
+                    /* cn_rt_ 前缀的函数：运行时API */
+                    if (strncmp(func_name, "cn_rt_", 6) == 0) {
+                        /* cn_rt_strdup, cn_rt_strcat 等返回 char* */
+                        if (strstr(func_name, "str") || strstr(func_name, "path")) {
+                            return cn_type_new_primitive(CN_TYPE_STRING);
                         }
-                        /* 中文创建函数：创建XXX 通常返回 XXX* 指针 */
-                        if (strncmp(func_name, "创建", 6) == 0) {
-                            /* 创建函数返回结构体指针，但无法确定具体类型，
-                             * 返回NULL让其他规则处理 */
+                        /* cn_rt_malloc, cn_rt_alloc 等返回 void* (用POINTER表示) */
+                        if (strstr(func_name, "alloc") || strstr(func_name, "malloc")) {
+                            return cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID));
                         }
                     }
+                    /* 中文创建函数：创建XXX 通常返回 XXX* 指针 */
+                    if (strncmp(func_name, "创建", 6) == 0) {
+                        /* 创建函数返回结构体指针，但无法确定具体类型，
+                         * 返回NULL让其他规则处理 */
+                    }
                 }
             }
-            inst = inst->next;
         }
-        block = block->next;
     }
     return NULL;
 }
@@ -3657,72 +3939,69 @@ static CnType* infer_from_call(CnCCodeGenContext *ctx, CnIrFunction *func, int r
  * @param alloca_types ALLOCA变量类型映射表
  * @return 推断出的类型，无法推断返回NULL
  */
-static CnType* infer_from_load(CnCCodeGenContext *ctx, CnIrFunction *func,
+static CnType* infer_from_load(CnCCodeGenContext *ctx, CnIrFunction *func, const RegUseIndex *uses,
                                 int reg_index, AllocaTypeEntry *alloca_types) {
-    CnIrBasicBlock *block = func->first_block;
-    while (block) {
-        CnIrInst *inst = block->first_inst;
-        while (inst) {
-            if (inst->kind == CN_IR_INST_LOAD &&
-                inst->dest.kind == CN_IR_OP_REG &&
-                inst->dest.as.reg_id == reg_index) {
-                
-                /* 从dest.type获取（IR生成器设置的类型） */
-                if (inst->dest.type &&
-                    inst->dest.type->kind != CN_TYPE_INT &&
-                    inst->dest.type->kind != CN_TYPE_UNKNOWN &&
-                    inst->dest.type->kind != CN_TYPE_VOID) {
-                    return inst->dest.type;
-                }
-                
-                /* 从ALLOCA映射表获取变量类型 */
-                if (inst->src1.kind == CN_IR_OP_SYMBOL && inst->src1.as.sym_name) {
-                    const char *sym_name = inst->src1.as.sym_name;
-                    AllocaTypeEntry *entry = alloca_types;
-                    while (entry) {
-                        if (entry->sym_name && names_match_with_suffix(entry->sym_name, sym_name)) {
-                            if (entry->type &&
-                                entry->type->kind != CN_TYPE_INT &&
-                                entry->type->kind != CN_TYPE_UNKNOWN &&
-                                entry->type->kind != CN_TYPE_VOID) {
-                                return entry->type;
-                            }
+    size_t use, use_end;
+    reg_use_range(uses, reg_index, &use, &use_end);
+    for (; use < use_end; use++) {
+        CnIrInst *inst = uses->insts[use];
+        if (inst->kind == CN_IR_INST_LOAD &&
+            inst->dest.kind == CN_IR_OP_REG &&
+            inst->dest.as.reg_id == reg_index) {
+            
+            /* 从dest.type获取（IR生成器设置的类型） */
+            if (inst->dest.type &&
+                inst->dest.type->kind != CN_TYPE_INT &&
+                inst->dest.type->kind != CN_TYPE_UNKNOWN &&
+                inst->dest.type->kind != CN_TYPE_VOID) {
+                return inst->dest.type;
+            }
+            
+            /* 从ALLOCA映射表获取变量类型 */
+            if (inst->src1.kind == CN_IR_OP_SYMBOL && inst->src1.as.sym_name) {
+                const char *sym_name = inst->src1.as.sym_name;
+                AllocaTypeEntry *entry = alloca_types;
+                while (entry) {
+                    if (entry->sym_name && names_match_with_suffix(entry->sym_name, sym_name)) {
+                        if (entry->type &&
+                            entry->type->kind != CN_TYPE_INT &&
+                            entry->type->kind != CN_TYPE_UNKNOWN &&
+                            entry->type->kind != CN_TYPE_VOID) {
+                            return entry->type;
                         }
-                        entry = entry->next;
                     }
+                    entry = entry->next;
                 }
-                
-                /* 从src1.type获取 */
-                if (inst->src1.type &&
-                    inst->src1.type->kind != CN_TYPE_INT &&
-                    inst->src1.type->kind != CN_TYPE_UNKNOWN &&
-                    inst->src1.type->kind != CN_TYPE_VOID) {
-                    return inst->src1.type;
-                }
-                
-                /* 【S2修复】从函数参数查找符号类型
-                 * 当LOAD指令的src1是符号操作数（如cn_var_类型1）时，
-                 * 从func->params查找该符号对应的参数类型。
-                 * 这是类型传播链的关键环节：函数参数类型通过LOAD传播到寄存器，
-                 * 如果此环节断裂，所有依赖该参数的成员访问类型都会失败 */
-                if (inst->src1.kind == CN_IR_OP_SYMBOL && inst->src1.as.sym_name) {
-                    const char *sym_name = inst->src1.as.sym_name;
-                    for (size_t p = 0; p < func->param_count; p++) {
-                        if (func->params[p].as.sym_name &&
-                            names_match_with_suffix(func->params[p].as.sym_name, sym_name)) {
-                            if (func->params[p].type &&
-                                func->params[p].type->kind != CN_TYPE_INT &&
-                                func->params[p].type->kind != CN_TYPE_UNKNOWN &&
-                                func->params[p].type->kind != CN_TYPE_VOID) {
-                                return func->params[p].type;
-                            }
+            }
+            
+            /* 从src1.type获取 */
+            if (inst->src1.type &&
+                inst->src1.type->kind != CN_TYPE_INT &&
+                inst->src1.type->kind != CN_TYPE_UNKNOWN &&
+                inst->src1.type->kind != CN_TYPE_VOID) {
+                return inst->src1.type;
+            }
+            
+            /* 【S2修复】从函数参数查找符号类型
+             * 当LOAD指令的src1是符号操作数（如cn_var_类型1）时，
+             * 从func->params查找该符号对应的参数类型。
+             * 这是类型传播链的关键环节：函数参数类型通过LOAD传播到寄存器，
+             * 如果此环节断裂，所有依赖该参数的成员访问类型都会失败 */
+            if (inst->src1.kind == CN_IR_OP_SYMBOL && inst->src1.as.sym_name) {
+                const char *sym_name = inst->src1.as.sym_name;
+                for (size_t p = 0; p < func->param_count; p++) {
+                    if (func->params[p].as.sym_name &&
+                        names_match_with_suffix(func->params[p].as.sym_name, sym_name)) {
+                        if (func->params[p].type &&
+                            func->params[p].type->kind != CN_TYPE_INT &&
+                            func->params[p].type->kind != CN_TYPE_UNKNOWN &&
+                            func->params[p].type->kind != CN_TYPE_VOID) {
+                            return func->params[p].type;
                         }
                     }
                 }
             }
-            inst = inst->next;
         }
-        block = block->next;
     }
     return NULL;
 }
@@ -3739,57 +4018,54 @@ static CnType* infer_from_load(CnCCodeGenContext *ctx, CnIrFunction *func,
  * @param alloca_types ALLOCA变量类型映射表
  * @return 推断出的类型，无法推断返回NULL
  */
-static CnType* infer_from_mov(CnCCodeGenContext *ctx, CnIrFunction *func,
+static CnType* infer_from_mov(CnCCodeGenContext *ctx, CnIrFunction *func, const RegUseIndex *uses,
                                int reg_index, AllocaTypeEntry *alloca_types) {
-    CnIrBasicBlock *block = func->first_block;
-    while (block) {
-        CnIrInst *inst = block->first_inst;
-        while (inst) {
-            if (inst->kind == CN_IR_INST_MOV &&
-                inst->dest.kind == CN_IR_OP_REG &&
-                inst->dest.as.reg_id == reg_index) {
-                
-                /* 从dest.type获取 */
-                if (inst->dest.type &&
-                    inst->dest.type->kind != CN_TYPE_INT &&
-                    inst->dest.type->kind != CN_TYPE_UNKNOWN &&
-                    inst->dest.type->kind != CN_TYPE_VOID) {
-                    return inst->dest.type;
-                }
-                
-                /* 从src1.type获取 */
-                if (inst->src1.type &&
-                    inst->src1.type->kind != CN_TYPE_INT &&
-                    inst->src1.type->kind != CN_TYPE_UNKNOWN &&
-                    inst->src1.type->kind != CN_TYPE_VOID) {
-                    return inst->src1.type;
-                }
-                
-                /* IMM_STR视为char* */
-                if (inst->src1.kind == CN_IR_OP_IMM_STR) {
-                    return cn_type_new_primitive(CN_TYPE_STRING);
-                }
-                
-                /* 从符号源查找ALLOCA映射表 */
-                if (inst->src1.kind == CN_IR_OP_SYMBOL && inst->src1.as.sym_name) {
-                    const char *sym_name = inst->src1.as.sym_name;
-                    AllocaTypeEntry *entry = alloca_types;
-                    while (entry) {
-                        if (entry->sym_name && names_match_with_suffix(entry->sym_name, sym_name)) {
-                            if (entry->type &&
-                                entry->type->kind != CN_TYPE_INT &&
-                                entry->type->kind != CN_TYPE_UNKNOWN &&
-                                entry->type->kind != CN_TYPE_VOID) {
-                                return entry->type;
-                            }
+    size_t use, use_end;
+    reg_use_range(uses, reg_index, &use, &use_end);
+    for (; use < use_end; use++) {
+        CnIrInst *inst = uses->insts[use];
+        if (inst->kind == CN_IR_INST_MOV &&
+            inst->dest.kind == CN_IR_OP_REG &&
+            inst->dest.as.reg_id == reg_index) {
+            
+            /* 从dest.type获取 */
+            if (inst->dest.type &&
+                inst->dest.type->kind != CN_TYPE_INT &&
+                inst->dest.type->kind != CN_TYPE_UNKNOWN &&
+                inst->dest.type->kind != CN_TYPE_VOID) {
+                return inst->dest.type;
+            }
+            
+            /* 从src1.type获取 */
+            if (inst->src1.type &&
+                inst->src1.type->kind != CN_TYPE_INT &&
+                inst->src1.type->kind != CN_TYPE_UNKNOWN &&
+                inst->src1.type->kind != CN_TYPE_VOID) {
+                return inst->src1.type;
+            }
+            
+            /* IMM_STR视为char* */
+            if (inst->src1.kind == CN_IR_OP_IMM_STR) {
+                return cn_type_new_primitive(CN_TYPE_STRING);
+            }
+            
+            /* 从符号源查找ALLOCA映射表 */
+            if (inst->src1.kind == CN_IR_OP_SYMBOL && inst->src1.as.sym_name) {
+                const char *sym_name = inst->src1.as.sym_name;
+                AllocaTypeEntry *entry = alloca_types;
+                while (entry) {
+                    if (entry->sym_name && names_match_with_suffix(entry->sym_name, sym_name)) {
+                        if (entry->type &&
+                            entry->type->kind != CN_TYPE_INT &&
+                            entry->type->kind != CN_TYPE_UNKNOWN &&
+                            entry->type->kind != CN_TYPE_VOID) {
+                            return entry->type;
                         }
-                        entry = entry->next;
                     }
+                    entry = entry->next;
                 }
             }
-            inst = inst->next;
         }
-        block = block->next;
     }
     return NULL;
 }
@@ -3805,36 +4081,33 @@ static CnType* infer_from_mov(CnCCodeGenContext *ctx, CnIrFunction *func,
  * @param reg_index 寄存器索引
  * @return 推断出的类型，无法推断返回NULL
  */
-static CnType* infer_from_store_addr(CnCCodeGenContext *ctx, CnIrFunction *func, int reg_index) {
-    CnIrBasicBlock *block = func->first_block;
-    while (block) {
-        CnIrInst *inst = block->first_inst;
-        while (inst) {
-            if (inst->kind == CN_IR_INST_STORE) {
-                /* 检查dest是否使用了该寄存器（作为地址） */
-                if (inst->dest.kind == CN_IR_OP_REG && inst->dest.as.reg_id == reg_index) {
-                    /* 寄存器被用作存储地址，应是指针类型 */
-                    if (inst->src1.type) {
-                        /* 创建指向源类型的指针 */
-                        return cn_type_new_pointer(inst->src1.type);
-                    }
-                    /* 无法确定指向类型，返回void* */
-                    return cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID));
+static CnType* infer_from_store_addr(CnCCodeGenContext *ctx, CnIrFunction *func, const RegUseIndex *uses, int reg_index) {
+    size_t use, use_end;
+    reg_use_range(uses, reg_index, &use, &use_end);
+    for (; use < use_end; use++) {
+        CnIrInst *inst = uses->insts[use];
+        if (inst->kind == CN_IR_INST_STORE) {
+            /* 检查dest是否使用了该寄存器（作为地址） */
+            if (inst->dest.kind == CN_IR_OP_REG && inst->dest.as.reg_id == reg_index) {
+                /* 寄存器被用作存储地址，应是指针类型 */
+                if (inst->src1.type) {
+                    /* 创建指向源类型的指针 */
+                    return cn_type_new_pointer(inst->src1.type);
                 }
-                /* 检查src1是否是该寄存器（值被存储） */
-                if (inst->src1.kind == CN_IR_OP_REG && inst->src1.as.reg_id == reg_index) {
-                    /* 寄存器的值被存储，其类型应与存储源类型一致 */
-                    if (inst->src1.type &&
-                        inst->src1.type->kind != CN_TYPE_INT &&
-                        inst->src1.type->kind != CN_TYPE_UNKNOWN &&
-                        inst->src1.type->kind != CN_TYPE_VOID) {
-                        return inst->src1.type;
-                    }
+                /* 无法确定指向类型，返回void* */
+                return cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID));
+            }
+            /* 检查src1是否是该寄存器（值被存储） */
+            if (inst->src1.kind == CN_IR_OP_REG && inst->src1.as.reg_id == reg_index) {
+                /* 寄存器的值被存储，其类型应与存储源类型一致 */
+                if (inst->src1.type &&
+                    inst->src1.type->kind != CN_TYPE_INT &&
+                    inst->src1.type->kind != CN_TYPE_UNKNOWN &&
+                    inst->src1.type->kind != CN_TYPE_VOID) {
+                    return inst->src1.type;
                 }
             }
-            inst = inst->next;
         }
-        block = block->next;
     }
     return NULL;
 }
@@ -3851,88 +4124,85 @@ static CnType* infer_from_store_addr(CnCCodeGenContext *ctx, CnIrFunction *func,
  * @param alloca_types ALLOCA变量类型映射表
  * @return 推断出的类型，无法推断返回NULL
  */
-static CnType* infer_from_gep(CnCCodeGenContext *ctx, CnIrFunction *func,
+static CnType* infer_from_gep(CnCCodeGenContext *ctx, CnIrFunction *func, const RegUseIndex *uses,
                                int reg_index, AllocaTypeEntry *alloca_types) {
-    CnIrBasicBlock *block = func->first_block;
-    while (block) {
-        CnIrInst *inst = block->first_inst;
-        while (inst) {
-            if (inst->kind == CN_IR_INST_GET_ELEMENT_PTR &&
-                inst->dest.kind == CN_IR_OP_REG &&
-                inst->dest.as.reg_id == reg_index) {
-                /* 从dest.type获取 */
-                /* 【第3轮修复P0】GEP结果始终是指针类型，当dest.type为非指针类型时
-                 * 需要升级为指针类型。例如dest.type=struct 诊断信息 → struct 诊断信息* */
-                if (inst->dest.type &&
-                    inst->dest.type->kind != CN_TYPE_INT &&
-                    inst->dest.type->kind != CN_TYPE_UNKNOWN &&
-                    inst->dest.type->kind != CN_TYPE_VOID) {
-                    /* 如果dest.type已经是指针类型，直接使用 */
-                    if (inst->dest.type->kind == CN_TYPE_POINTER ||
-                        inst->dest.type->kind == CN_TYPE_STRING) {
-                        return inst->dest.type;
-                    }
-                    /* 如果dest.type是非指针类型（STRUCT/ENUM/CHAR/BOOL/FLOAT等），
-                     * GEP返回的是指向该类型的指针，需要升级为POINTER类型 */
-                    return cn_type_new_pointer(inst->dest.type);
-                }
-                
-                /* 获取源操作数类型 */
-                CnType *src_type = inst->src1.type;
-                
-                /* 【RC1增强】如果src1.type为NULL，从reg_types查找 */
-                if (!src_type && inst->src1.kind == CN_IR_OP_REG &&
-                    inst->src1.as.reg_id >= 0 && ctx->reg_types &&
-                    inst->src1.as.reg_id < ctx->reg_types_count) {
-                    src_type = ctx->reg_types[inst->src1.as.reg_id];
+    size_t use, use_end;
+    reg_use_range(uses, reg_index, &use, &use_end);
+    for (; use < use_end; use++) {
+        CnIrInst *inst = uses->insts[use];
+        if (inst->kind == CN_IR_INST_GET_ELEMENT_PTR &&
+            inst->dest.kind == CN_IR_OP_REG &&
+            inst->dest.as.reg_id == reg_index) {
+            /* 从dest.type获取 */
+            /* 【第3轮修复P0】GEP结果始终是指针类型，当dest.type为非指针类型时
+             * 需要升级为指针类型。例如dest.type=struct 诊断信息 → struct 诊断信息* */
+            if (inst->dest.type &&
+                inst->dest.type->kind != CN_TYPE_INT &&
+                inst->dest.type->kind != CN_TYPE_UNKNOWN &&
+                inst->dest.type->kind != CN_TYPE_VOID) {
+                /* 如果dest.type已经是指针类型，直接使用 */
+                if (inst->dest.type->kind == CN_TYPE_POINTER ||
+                    inst->dest.type->kind == CN_TYPE_STRING) {
+                    return inst->dest.type;
                 }
-                
-                /* 【RC1增强】如果src1是符号，从ALLOCA映射表查找 */
-                if (!src_type && inst->src1.kind == CN_IR_OP_SYMBOL &&
-                    inst->src1.as.sym_name && alloca_types) {
-                    AllocaTypeEntry *entry = alloca_types;
-                    while (entry) {
-                        if (entry->sym_name && names_match_with_suffix(entry->sym_name, inst->src1.as.sym_name)) {
-                            src_type = entry->type;
-                            break;
-                        }
-                        entry = entry->next;
+                /* 如果dest.type是非指针类型（STRUCT/ENUM/CHAR/BOOL/FLOAT等），
+                 * GEP返回的是指向该类型的指针，需要升级为POINTER类型 */
+                return cn_type_new_pointer(inst->dest.type);
+            }
+            
+            /* 获取源操作数类型 */
+            CnType *src_type = inst->src1.type;
+            
+            /* 【RC1增强】如果src1.type为NULL，从reg_types查找 */
+            if (!src_type && inst->src1.kind == CN_IR_OP_REG &&
+                inst->src1.as.reg_id >= 0 && ctx->reg_types &&
+                inst->src1.as.reg_id < ctx->reg_types_count) {
+                src_type = ctx->reg_types[inst->src1.as.reg_id];
+            }
+            
+            /* 【RC1增强】如果src1是符号，从ALLOCA映射表查找 */
+            if (!src_type && inst->src1.kind == CN_IR_OP_SYMBOL &&
+                inst->src1.as.sym_name && alloca_types) {
+                AllocaTypeEntry *entry = alloca_types;
+                while (entry) {
+                    if (entry->sym_name && names_match_with_suffix(entry->sym_name, inst->src1.as.sym_name)) {
+                        src_type = entry->type;
+                        break;
                     }
+                    entry = entry->next;
                 }
-                
-                /* 从源类型推断元素指针类型 */
-                if (src_type) {
-                    if (src_type->kind == CN_TYPE_ARRAY && src_type->as.array.element_type) {
-                        return cn_type_new_pointer(src_type->as.array.element_type);
-                    } else if (src_type->kind == CN_TYPE_POINTER) {
-                        /* 【第2轮修复B】POINTER类型的GEP结果保持相同类型
-                         * 例如：char** 数组的 &arr[i] 结果是 char**（指向char*元素的指针）
-                         * 例如：struct X** 数组的 &arr[i] 结果是 struct X**
-                         * 关键：GEP返回的是"指向数组元素的指针"，元素类型就是指针指向的类型，
-                         * 所以GEP结果类型 = 指向(元素类型)的指针 = 与src_type相同 */
-                        return src_type;
-                    }
-                    /* 【RC1增强】STRING类型(char*)的GEP结果也是char*
-                     * 例如：char*指针的索引访问 char* p; p[i] 结果类型是char* */
-                    else if (src_type->kind == CN_TYPE_STRING) {
-                        return cn_type_new_primitive(CN_TYPE_STRING);
-                    }
-                    /* 【第2轮修复B】STRUCT类型的GEP结果是指向结构体的指针
-                     * 例如：struct X 数组的 &arr[i] 结果是 struct X*
-                     * 当src_type是结构体值类型（非指针）时，GEP返回指向该结构体的指针 */
-                    else if (src_type->kind == CN_TYPE_STRUCT) {
-                        return cn_type_new_pointer(src_type);
-                    }
-                    /* 【第2轮修复B】ENUM类型的GEP结果是指向枚举的指针
-                     * 例如：enum E 数组的 &arr[i] 结果是 enum E* */
-                    else if (src_type->kind == CN_TYPE_ENUM) {
-                        return cn_type_new_pointer(src_type);
-                    }
+            }
+            
+            /* 从源类型推断元素指针类型 */
+            if (src_type) {
+                if (src_type->kind == CN_TYPE_ARRAY && src_type->as.array.element_type) {
+                    return cn_type_new_pointer(src_type->as.array.element_type);
+                } else if (src_type->kind == CN_TYPE_POINTER) {
+                    /* 【第2轮修复B】POINTER类型的GEP结果保持相同类型
+                     * 例如：char** 数组的 &arr[i] 结果是 char**（指向char*元素的指针）
+                     * 例如：struct X** 数组的 &arr[i] 结果是 struct X**
+                     * 关键：GEP返回的是"指向数组元素的指针"，元素类型就是指针指向的类型，
+                     * 所以GEP结果类型 = 指向(元素类型)的指针 = 与src_type相同 */
+                    return src_type;
+                }
+                /* 【RC1增强】STRING类型(char*)的GEP结果也是char*
+                 * 例如：char*指针的索引访问 char* p; p[i] 结果类型是char* */
+                else if (src_type->kind == CN_TYPE_STRING) {
+                    return cn_type_new_primitive(CN_TYPE_STRING);
+                }
+                /* 【第2轮修复B】STRUCT类型的GEP结果是指向结构体的指针
+                 * 例如：struct X 数组的 &arr[i] 结果是 struct X*
+                 * 当src_type是结构体值类型（非指针）时，GEP返回指向该结构体的指针 */
+                else if (src_type->kind == CN_TYPE_STRUCT) {
+                    return cn_type_new_pointer(src_type);
+                }
+                /* 【第2轮修复B】ENUM类型的GEP结果是指向枚举的指针
+                 * 例如：enum E 数组的 &arr[i] 结果是 enum E* */
+                else if (src_type->kind == CN_TYPE_ENUM) {
+                    return cn_type_new_pointer(src_type);
                 }
             }
-            inst = inst->next;
         }
-        block = block->next;
     }
     return NULL;
 }
@@ -3948,64 +4218,61 @@ static CnType* infer_from_gep(CnCCodeGenContext *ctx, CnIrFunction *func,
  * @param alloca_types ALLOCA变量类型映射表
  * @return 推断出的类型，无法推断返回NULL
  */
-static CnType* infer_from_address_of(CnCCodeGenContext *ctx, CnIrFunction *func,
+static CnType* infer_from_address_of(CnCCodeGenContext *ctx, CnIrFunction *func, const RegUseIndex *uses,
                                       int reg_index, AllocaTypeEntry *alloca_types) {
-    CnIrBasicBlock *block = func->first_block;
-    while (block) {
-        CnIrInst *inst = block->first_inst;
-        while (inst) {
-            if (inst->kind == CN_IR_INST_ADDRESS_OF &&
-                inst->dest.kind == CN_IR_OP_REG &&
-                inst->dest.as.reg_id == reg_index) {
-                /* 从dest.type获取 */
-                if (inst->dest.type && inst->dest.type->kind == CN_TYPE_POINTER) {
-                    return inst->dest.type;
-                }
-                /* 从src1.type创建指针 */
-                if (inst->src1.type) {
-                    return cn_type_new_pointer(inst->src1.type);
-                }
-                /* 【第3轮修复P0】当src1.type为NULL时，从alloca_types查找符号类型
-                 * 典型场景：r53 = &cn_var_源码内容_4
-                 * cn_var_源码内容_4 的类型在alloca_types中为char[]，
-                 * 取地址后应为char* */
-                if (inst->src1.kind == CN_IR_OP_SYMBOL && inst->src1.as.sym_name) {
-                    /* 从alloca_types查找 */
-                    if (alloca_types) {
-                        AllocaTypeEntry *entry = alloca_types;
-                        while (entry) {
-                            if (entry->sym_name && entry->type &&
-                                names_match_with_suffix(entry->sym_name, inst->src1.as.sym_name)) {
-                                /* 数组类型取地址得到指向元素的指针
-                                 * char[] → char* */
-                                if (entry->type->kind == CN_TYPE_ARRAY &&
-                                    entry->type->as.array.element_type) {
-                                    return cn_type_new_pointer(entry->type->as.array.element_type);
-                                }
-                                /* 其他类型取地址得到指向该类型的指针 */
-                                return cn_type_new_pointer(entry->type);
+    size_t use, use_end;
+    reg_use_range(uses, reg_index, &use, &use_end);
+    for (; use < use_end; use++) {
+        CnIrInst *inst = uses->insts[use];
+        if (inst->kind == CN_IR_INST_ADDRESS_OF &&
+            inst->dest.kind == CN_IR_OP_REG &&
+            inst->dest.as.reg_id == reg_index) {
+            /* 从dest.type获取 */
+            if (inst->dest.type && inst->dest.type->kind == CN_TYPE_POINTER) {
+                return inst->dest.type;
+            }
+            /* 从src1.type创建指针 */
+            if (inst->src1.type) {
+                return cn_type_new_pointer(inst->src1.type);
+            }
+            /* 【第3轮修复P0】当src1.type为NULL时，从alloca_types查找符号类型
+             * 典型场景：r53 = &cn_var_源码内容_4
+             * cn_var_源码内容_4 的类型在alloca_types中为char[]，
+             * 取地址后应为char* */
+            if (inst->src1.kind == CN_IR_OP_SYMBOL && inst->src1.as.sym_name) {
+                /* 从alloca_types查找 */
+                if (alloca_types) {
+                    AllocaTypeEntry *entry = alloca_types;
+                    while (entry) {
+                        if (entry->sym_name && entry->type &&
+                            names_match_with_suffix(entry->sym_name, inst->src1.as.sym_name)) {
+                            /* 数组类型取地址得到指向元素的指针
+                             * char[] → char* */
+                            if (entry->type->kind == CN_TYPE_ARRAY &&
+                                entry->type->as.array.element_type) {
+                                return cn_type_new_pointer(entry->type->as.array.element_type);
                             }
-                            entry = entry->next;
+                            /* 其他类型取地址得到指向该类型的指针 */
+                            return cn_type_new_pointer(entry->type);
                         }
+                        entry = entry->next;
                     }
-                    /* 从函数参数查找 */
-                    if (func) {
-                        for (size_t p = 0; p < func->param_count; p++) {
-                            if (func->params[p].as.sym_name &&
-                                names_match_with_suffix(func->params[p].as.sym_name, inst->src1.as.sym_name)) {
-                                CnType *param_type = func->params[p].type;
-                                if (param_type) {
-                                    return cn_type_new_pointer(param_type);
-                                }
-                                break;
+                }
+                /* 从函数参数查找 */
+                if (func) {
+                    for (size_t p = 0; p < func->param_count; p++) {
+                        if (func->params[p].as.sym_name &&
+                            names_match_with_suffix(func->params[p].as.sym_name, inst->src1.as.sym_name)) {
+                            CnType *param_type = func->params[p].type;
+                            if (param_type) {
+                                return cn_type_new_pointer(param_type);
                             }
+                            break;
                         }
                     }
                 }
             }
-            inst = inst->next;
         }
-        block = block->next;
     }
     return NULL;
 }
@@ -4023,150 +4290,144 @@ static CnType* infer_from_address_of(CnCCodeGenContext *ctx, CnIrFunction *func,
  * @param alloca_types ALLOCA变量类型映射表
  * @return 推断出的成员类型，无法推断返回NULL
  */
-static CnType* infer_from_member_access_dest(CnCCodeGenContext *ctx, CnIrFunction *func,
+static CnType* infer_from_member_access_dest(CnCCodeGenContext *ctx, CnIrFunction *func, const RegUseIndex *uses,
                                               int reg_index, AllocaTypeEntry *alloca_types) {
-    CnIrBasicBlock *block = func->first_block;
-    while (block) {
-        CnIrInst *inst = block->first_inst;
-        while (inst) {
-            if (inst->kind == CN_IR_INST_MEMBER_ACCESS &&
-                inst->dest.kind == CN_IR_OP_REG &&
-                inst->dest.as.reg_id == reg_index) {
-                
-                /* 优先使用dest.type（IR生成器设置的成员类型） */
-                if (inst->dest.type &&
-                    inst->dest.type->kind != CN_TYPE_INT &&
-                    inst->dest.type->kind != CN_TYPE_UNKNOWN &&
-                    inst->dest.type->kind != CN_TYPE_VOID) {
-                    return inst->dest.type;
-                }
-                
-                /* 从src1的对象类型和src2的成员名推断成员类型 */
-                CnType *obj_type = NULL;
-                
-                /* 获取对象类型：从src1.type */
-                if (inst->src1.type) {
-                    obj_type = inst->src1.type;
-                }
-                /* 从reg_types获取（多遍扫描后的类型） */
-                if (!obj_type && inst->src1.kind == CN_IR_OP_REG &&
-                    inst->src1.as.reg_id >= 0 && ctx->reg_types &&
-                    inst->src1.as.reg_id < ctx->reg_types_count) {
-                    obj_type = ctx->reg_types[inst->src1.as.reg_id];
-                }
-                /* 从alloca_types查找 */
-                if (!obj_type && inst->src1.kind == CN_IR_OP_SYMBOL &&
-                    inst->src1.as.sym_name && alloca_types) {
-                    AllocaTypeEntry *entry = alloca_types;
-                    while (entry) {
-                        if (entry->sym_name && names_match_with_suffix(entry->sym_name, inst->src1.as.sym_name)) {
-                            obj_type = entry->type;
-                            break;
-                        }
-                        entry = entry->next;
+    size_t use, use_end;
+    reg_use_range(uses, reg_index, &use, &use_end);
+    for (; use < use_end; use++) {
+        CnIrInst *inst = uses->insts[use];
+        if (inst->kind == CN_IR_INST_MEMBER_ACCESS &&
+            inst->dest.kind == CN_IR_OP_REG &&
+            inst->dest.as.reg_id == reg_index) {
+            
+            /* 优先使用dest.type（IR生成器设置的成员类型） */
+            if (inst->dest.type &&
+                inst->dest.type->kind != CN_TYPE_INT &&
+                inst->dest.type->kind != CN_TYPE_UNKNOWN &&
+                inst->dest.type->kind != CN_TYPE_VOID) {
+                return inst->dest.type;
+            }
+            
+            /* 从src1的对象类型和src2的成员名推断成员类型 */
+            CnType *obj_type = NULL;
+            
+            /* 获取对象类型：从src1.type */
+            if (inst->src1.type) {
+                obj_type = inst->src1.type;
+            }
+            /* 从reg_types获取（多遍扫描后的类型） */
+            if (!obj_type && inst->src1.kind == CN_IR_OP_REG &&
+                inst->src1.as.reg_id >= 0 && ctx->reg_types &&
+                inst->src1.as.reg_id < ctx->reg_types_count) {
+                obj_type = ctx->reg_types[inst->src1.as.reg_id];
+            }
+            /* 从alloca_types查找 */
+            if (!obj_type && inst->src1.kind == CN_IR_OP_SYMBOL &&
+                inst->src1.as.sym_name && alloca_types) {
+                AllocaTypeEntry *entry = alloca_types;
+                while (entry) {
+                    if (entry->sym_name && names_match_with_suffix(entry->sym_name, inst->src1.as.sym_name)) {
+                        obj_type = entry->type;
+                        break;
                     }
+                    entry = entry->next;
                 }
-                
-                /* 【S3修复】当src1是符号操作数时，从函数参数查找对象类型
-                 * 处理MEMBER_ACCESS指令中src1为符号（如cn_var_类型1）的情况，
-                 * 从func->params获取参数类型作为obj_type，用于查找成员类型 */
-                if (!obj_type && inst->src1.kind == CN_IR_OP_SYMBOL &&
-                    inst->src1.as.sym_name && func) {
-                    const char *sym_name = inst->src1.as.sym_name;
-                    for (size_t p = 0; p < func->param_count; p++) {
-                        if (func->params[p].as.sym_name &&
-                            names_match_with_suffix(func->params[p].as.sym_name, sym_name)) {
-                            CnType *param_type = func->params[p].type;
-                            if (param_type) {
-                                obj_type = param_type;
-                            }
-                            break;
+            }
+            
+            /* 【S3修复】当src1是符号操作数时，从函数参数查找对象类型
+             * 处理MEMBER_ACCESS指令中src1为符号（如cn_var_类型1）的情况，
+             * 从func->params获取参数类型作为obj_type，用于查找成员类型 */
+            if (!obj_type && inst->src1.kind == CN_IR_OP_SYMBOL &&
+                inst->src1.as.sym_name && func) {
+                const char *sym_name = inst->src1.as.sym_name;
+                for (size_t p = 0; p < func->param_count; p++) {
+                    if (func->params[p].as.sym_name &&
+                        names_match_with_suffix(func->params[p].as.sym_name, sym_name)) {
+                        CnType *param_type = func->params[p].type;
+                        if (param_type) {
+                            obj_type = param_type;
                         }
+                        break;
                     }
                 }
-                
-                /* 【S3增强】当src1是寄存器且reg_types中类型为INT/NULL时，
-                 * 追溯LOAD指令找到原始符号，从函数参数获取对象类型。
-                 * 这处理了：r1 = LOAD cn_var_类型1; r5 = r1->名称
-                 * 当r1的类型传播失败（仍为INT）时，通过LOAD追溯找到
-                 * cn_var_类型1是函数参数，类型为struct 类型信息* */
-                if (!obj_type && inst->src1.kind == CN_IR_OP_REG && func) {
-                    int src1_reg_id = inst->src1.as.reg_id;
-                    CnIrBasicBlock *trace_block = func->first_block;
-                    while (trace_block && !obj_type) {
-                        CnIrInst *trace_inst = trace_block->first_inst;
-                        while (trace_inst && !obj_type) {
-                            if (trace_inst->kind == CN_IR_INST_LOAD &&
-                                trace_inst->dest.kind == CN_IR_OP_REG &&
-                                trace_inst->dest.as.reg_id == src1_reg_id &&
-                                trace_inst->src1.kind == CN_IR_OP_SYMBOL &&
-                                trace_inst->src1.as.sym_name) {
-                                /* 找到LOAD指令，从函数参数查找符号类型 */
-                                const char *sym_name = trace_inst->src1.as.sym_name;
-                                for (size_t p = 0; p < func->param_count; p++) {
-                                    if (func->params[p].as.sym_name &&
-                                        names_match_with_suffix(func->params[p].as.sym_name, sym_name)) {
-                                        CnType *param_type = func->params[p].type;
-                                        if (param_type) {
-                                            obj_type = param_type;
-                                        }
-                                        break;
-                                    }
+            }
+            
+            /* 【S3增强】当src1是寄存器且reg_types中类型为INT/NULL时，
+             * 追溯LOAD指令找到原始符号，从函数参数获取对象类型。
+             * 这处理了：r1 = LOAD cn_var_类型1; r5 = r1->名称
+             * 当r1的类型传播失败（仍为INT）时，通过LOAD追溯找到
+             * cn_var_类型1是函数参数，类型为struct 类型信息* */
+            if (!obj_type && inst->src1.kind == CN_IR_OP_REG && func) {
+                int src1_reg_id = inst->src1.as.reg_id;
+                size_t trace_use, trace_end;
+                reg_use_range(uses, src1_reg_id, &trace_use, &trace_end);
+                for (; trace_use < trace_end && !obj_type; trace_use++) {
+                    CnIrInst *trace_inst = uses->insts[trace_use];
+                    if (trace_inst->kind == CN_IR_INST_LOAD &&
+                        trace_inst->dest.kind == CN_IR_OP_REG &&
+                        trace_inst->dest.as.reg_id == src1_reg_id &&
+                        trace_inst->src1.kind == CN_IR_OP_SYMBOL &&
+                        trace_inst->src1.as.sym_name) {
+                        /* 找到LOAD指令，从函数参数查找符号类型 */
+                        const char *sym_name = trace_inst->src1.as.sym_name;
+                        for (size_t p = 0; p < func->param_count; p++) {
+                            if (func->params[p].as.sym_name &&
+                                names_match_with_suffix(func->params[p].as.sym_name, sym_name)) {
+                                CnType *param_type = func->params[p].type;
+                                if (param_type) {
+                                    obj_type = param_type;
                                 }
-                                /* 如果不是函数参数，从alloca_types查找 */
-                                if (!obj_type && alloca_types) {
-                                    AllocaTypeEntry *entry = alloca_types;
-                                    while (entry) {
-                                        if (entry->sym_name && names_match_with_suffix(entry->sym_name, sym_name)) {
-                                            obj_type = entry->type;
-                                            break;
-                                        }
-                                        entry = entry->next;
-                                    }
+                                break;
+                            }
+                        }
+                        /* 如果不是函数参数，从alloca_types查找 */
+                        if (!obj_type && alloca_types) {
+                            AllocaTypeEntry *entry = alloca_types;
+                            while (entry) {
+                                if (entry->sym_name && names_match_with_suffix(entry->sym_name, sym_name)) {
+                                    obj_type = entry->type;
+                                    break;
                                 }
+                                entry = entry->next;
                             }
-                            trace_inst = trace_inst->next;
                         }
-                        trace_block = trace_block->next;
                     }
                 }
+            }
+            
+            /* 如果对象是指针类型，解引用获取结构体类型 */
+            if (obj_type && obj_type->kind == CN_TYPE_POINTER && obj_type->as.pointer_to) {
+                obj_type = obj_type->as.pointer_to;
+            }
+            /* STRING类型(char*)的成员访问不适用于结构体成员查找 */
+            if (obj_type && obj_type->kind == CN_TYPE_STRING) {
+                inst = inst->next;
+                continue;
+            }
+            
+            /* 【修复1.2】如果对象是结构体类型，查找成员类型
+             * 使用lookup_struct_member_type_cgen支持"作为"前缀和"指针"后缀匹配 */
+            if (obj_type && obj_type->kind == CN_TYPE_STRUCT &&
+                obj_type->as.struct_type.fields && inst->src2.kind == CN_IR_OP_SYMBOL) {
+                const char *member_name = inst->src2.as.sym_name;
+                size_t member_name_len = strlen(member_name);
                 
-                /* 如果对象是指针类型，解引用获取结构体类型 */
-                if (obj_type && obj_type->kind == CN_TYPE_POINTER && obj_type->as.pointer_to) {
-                    obj_type = obj_type->as.pointer_to;
-                }
-                /* STRING类型(char*)的成员访问不适用于结构体成员查找 */
-                if (obj_type && obj_type->kind == CN_TYPE_STRING) {
-                    inst = inst->next;
-                    continue;
-                }
+                CnType *found = lookup_struct_member_type_cgen(obj_type, member_name, member_name_len);
+                if (found) return found;
                 
-                /* 【修复1.2】如果对象是结构体类型，查找成员类型
-                 * 使用lookup_struct_member_type_cgen支持"作为"前缀和"指针"后缀匹配 */
-                if (obj_type && obj_type->kind == CN_TYPE_STRUCT &&
-                    obj_type->as.struct_type.fields && inst->src2.kind == CN_IR_OP_SYMBOL) {
-                    const char *member_name = inst->src2.as.sym_name;
-                    size_t member_name_len = strlen(member_name);
-                    
-                    CnType *found = lookup_struct_member_type_cgen(obj_type, member_name, member_name_len);
-                    if (found) return found;
-                    
-                    /* 如果结构体没有字段信息，尝试从全局作用域查找完整定义 */
-                    if (ctx->global_scope && obj_type->as.struct_type.name) {
-                        CnSemSymbol *struct_sym = cn_sem_scope_lookup(ctx->global_scope,
-                                obj_type->as.struct_type.name, obj_type->as.struct_type.name_length);
-                        if (struct_sym && struct_sym->kind == CN_SEM_SYMBOL_STRUCT &&
-                            struct_sym->type && struct_sym->type->as.struct_type.fields) {
-                            CnType *full_type = struct_sym->type;
-                            found = lookup_struct_member_type_cgen(full_type, member_name, member_name_len);
-                            if (found) return found;
-                        }
+                /* 如果结构体没有字段信息，尝试从全局作用域查找完整定义 */
+                if (ctx->global_scope && obj_type->as.struct_type.name) {
+                    CnSemSymbol *struct_sym = cn_sem_scope_lookup(ctx->global_scope,
+                            obj_type->as.struct_type.name, obj_type->as.struct_type.name_length);
+                    if (struct_sym && struct_sym->kind == CN_SEM_SYMBOL_STRUCT &&
+                        struct_sym->type && struct_sym->type->as.struct_type.fields) {
+                        CnType *full_type = struct_sym->type;
+                        found = lookup_struct_member_type_cgen(full_type, member_name, member_name_len);
+                        if (found) return found;
                     }
                 }
             }
-            inst = inst->next;
         }
-        block = block->next;
     }
     return NULL;
 }
@@ -4179,46 +4440,48 @@ static CnType* infer_from_member_access_dest(CnCCodeGenContext *ctx, CnIrFunctio
  *
  * @param ctx 代码生成上下文
  * @param func 当前函数
+ * @param uses 寄存器引用索引
  * @param reg_index 寄存器索引
  * @param alloca_types ALLOCA变量类型映射表
  * @return 推断出的类型，无法推断返回NULL
  */
 static CnType* infer_reg_type_from_usage(CnCCodeGenContext *ctx, CnIrFunction *func,
-                                          int reg_index, AllocaTypeEntry *alloca_types) {
+                                          const RegUseIndex *uses, int reg_index,
+                                          AllocaTypeEntry *alloca_types) {
     CnType *result = NULL;
     
     /* 规则1：从MEMBER_ACCESS推断（最高优先级，因为指针类型最明确） */
-    result = infer_from_member_access(ctx, func, reg_index, alloca_types);
+    result = infer_from_member_access(ctx, func, uses, reg_index, alloca_types);
     if (result) return result;
     
     /* 【RC1新增】规则1b：从MEMBER_ACCESS的目标寄存器推断成员类型
      * 当寄存器是成员访问的结果时，从结构体类型和成员名推断成员类型
      * 例如：r5 = r3->名称，r5应该是char*类型而非long long */
-    result = infer_from_member_access_dest(ctx, func, reg_index, alloca_types);
+    result = infer_from_member_access_dest(ctx, func, uses, reg_index, alloca_types);
     if (result) return result;
     
     /* 规则2：从CALL返回值推断 */
-    result = infer_from_call(ctx, func, reg_index);
+    result = infer_from_call(ctx, func, uses, reg_index);
     if (result) return result;
     
     /* 规则3：从LOAD指令推断 */
-    result = infer_from_load(ctx, func, reg_index, alloca_types);
+    result = infer_from_load(ctx, func, uses, reg_index, alloca_types);
     if (result) return result;
     
     /* 规则4：从MOV指令推断 */
-    result = infer_from_mov(ctx, func, reg_index, alloca_types);
+    result = infer_from_mov(ctx, func, uses, reg_index, alloca_types);
     if (result) return result;
     
     /* 规则5：从STORE地址推断 */
-    result = infer_from_store_addr(ctx, func, reg_index);
+    result = infer_from_store_addr(ctx, func, uses, reg_index);
     if (result) return result;
     
     /* 规则6：从GET_ELEMENT_PTR推断 */
-    result = infer_from_gep(ctx, func, reg_index, alloca_types);
+    result = infer_from_gep(ctx, func, uses, reg_index, alloca_types);
     if (result) return result;
     
     /* 规则7：从ADDRESS_OF推断 */
-    result = infer_from_address_of(ctx, func, reg_index, alloca_types);
+    result = infer_from_address_of(ctx, func, uses, reg_index, alloca_types);
     if (result) return result;
     
     return NULL;
@@ -4231,6 +4494,71 @@ void cn_cgen_block(CnCCodeGenContext *ctx, CnIrBasicBlock *block) {
     while (inst) { cn_cgen_inst(ctx, inst); inst = inst->next; }
 }
 
+/* 预扫描用的基本块集合：链表中原有的块按地址排序后二分查找，预扫描补入链表的块另行记录（极少）
+ * 逐个比对链表判断跳转目标是否已链接是 跳转数 × 块数，"否则 如果" 长链生成的函数可有数十万个块
+ */
+typedef struct CgenBlockSet {
+    CnIrBasicBlock **sorted;     // NULL 表示内存不足，退回逐个比对链表
+    size_t sorted_count;
+    CnIrBasicBlock **extra;
+    size_t extra_count;
+    size_t extra_capacity;
+} CgenBlockSet;
+
+static int compare_block_address(const void *a, const void *b) {
+    uintptr_t x = (uintptr_t)*(CnIrBasicBlock *const *)a;
+    uintptr_t y = (uintptr_t)*(CnIrBasicBlock *const *)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static void cgen_block_set_init(CgenBlockSet *set, CnIrFunction *func) {
+    size_t count = 0;
+    memset(set, 0, sizeof(*set));
+    for (CnIrBasicBlock *b = func->first_block; b; b = b->next) count++;
+    set->sorted = malloc((count ? count : 1) * sizeof(CnIrBasicBlock *));
+    if (!set->sorted) return;
+    for (CnIrBasicBlock *b = func->first_block; b; b = b->next) set->sorted[set->sorted_count++] = b;
+    qsort(set->sorted, set->sorted_count, sizeof(CnIrBasicBlock *), compare_block_address);
+}
+
+static bool cgen_block_set_contains(const CgenBlockSet *set, CnIrFunction *func, CnIrBasicBlock *block) {
+    if (!set->sorted) {
+        for (CnIrBasicBlock *check = func->first_block; check; check = check->next) {
+            if (check == block) return true;
+        }
+        return false;
+    }
+    if (bsearch(&block, set->sorted, set->sorted_count, sizeof(CnIrBasicBlock *), compare_block_address)) {
+        return true;
+    }
+    for (size_t i = 0; i < set->extra_count; i++) {
+        if (set->extra[i] == block) return true;
+    }
+    return false;
+}
+
+static void cgen_block_set_add(CgenBlockSet *set, CnIrBasicBlock *block) {
+    if (!set->sorted) return;
+    if (set->extra_count == set->extra_capacity) {
+        size_t capacity = set->extra_capacity ? set->extra_capacity * 2 : 8;
+        CnIrBasicBlock **extra = realloc(set->extra, capacity * sizeof(CnIrBasicBlock *));
+        if (!extra) {
+            /* 无法记录时退回逐个比对链表（补入的块已在链表中） */
+            free(set->sorted);
+            set->sorted = NULL;
+            return;
+        }
+        set->extra = extra;
+        set->extra_capacity = capacity;
+    }
+    set->extra[set->extra_count++] = block;
+}
+
+static void cgen_block_set_free(CgenBlockSet *set) {
+    free(set->sorted);
+    free(set->extra);
+}
+
 void cn_cgen_function(CnCCodeGenContext *ctx, CnIrFunction *func) {
     if (!ctx || !func) return;
     ctx->current_func = func;
@@ -4343,6 +4671,17 @@ void cn_cgen_function(CnCCodeGenContext *ctx, CnIrFunction *func) {
         CnIrStaticVar *static_var = func->first_static_var;
         while (static_var) {
             const char *type_str = get_c_type_string(static_var->type);
+            // 全常量数组：生成 "static 元素类型 名称[长度] = {...};"
+            if (static_var->initializer.kind == CN_IR_OP_CONST_ARRAY &&
+                static_var->type && static_var->type->kind == CN_TYPE_ARRAY) {
+                fprintf(ctx->output_file, "    static %s cn_static_%s_%s[%zu] = ",
+                        get_c_type_string(static_var->type->as.array.element_type),
+                        func->name, static_var->name, static_var->type->as.array.length);
+                cn_cgen_const_array_initializer(ctx->output_file, static_var->initializer.as.const_array);
+                fprintf(ctx->output_file, ";\n");
+                static_var = static_var->next;
+                continue;
+            }
             // 生成静态变量名：cn_static_{函数名}_{变量名}
             fprintf(ctx->output_file, "    static %s cn_static_%s_%s",
                     type_str, func->name, static_var->name);
@@ -4398,6 +4737,8 @@ void cn_cgen_function(CnCCodeGenContext *ctx, CnIrFunction *func) {
     // 【重要】此修复必须在寄存器类型扫描之前执行，否则类型传播循环
     // 看不到未链接块中的指令，导致所有寄存器类型回退为long long。
     {
+        CgenBlockSet listed;
+        cgen_block_set_init(&listed, func);
         CnIrBasicBlock *fix_blk = func->first_block;
         while (fix_blk) {
             CnIrInst *fix_inst = fix_blk->first_inst;
@@ -4406,17 +4747,12 @@ void cn_cgen_function(CnCCodeGenContext *ctx, CnIrFunction *func) {
                 if (fix_inst->kind == CN_IR_INST_JUMP &&
                     fix_inst->dest.kind == CN_IR_OP_LABEL) {
                     CnIrBasicBlock *target = fix_inst->dest.as.label;
-                    bool in_list = false;
-                    CnIrBasicBlock *check = func->first_block;
-                    while (check) {
-                        if (check == target) { in_list = true; break; }
-                        check = check->next;
-                    }
-                    if (!in_list && target) {
+                    if (target && !cgen_block_set_contains(&listed, func, target)) {
                         CnIrBasicBlock *last = func->first_block;
                         while (last->next) last = last->next;
                         last->next = target;
                         target->prev = last;
+                        cgen_block_set_add(&listed, target);
                     }
                 }
                 // 检查BRANCH指令的两个目标块
@@ -4431,17 +4767,12 @@ void cn_cgen_function(CnCCodeGenContext *ctx, CnIrFunction *func) {
                     }
                     for (int t = 0; t < target_count; t++) {
                         CnIrBasicBlock *target = targets[t];
-                        bool in_list = false;
-                        CnIrBasicBlock *check = func->first_block;
-                        while (check) {
-                            if (check == target) { in_list = true; break; }
-                            check = check->next;
-                        }
-                        if (!in_list && target) {
+                        if (target && !cgen_block_set_contains(&listed, func, target)) {
                             CnIrBasicBlock *last = func->first_block;
                             while (last->next) last = last->next;
                             last->next = target;
                             target->prev = last;
+                            cgen_block_set_add(&listed, target);
                         }
                     }
                 }
@@ -4449,6 +4780,7 @@ void cn_cgen_function(CnCCodeGenContext *ctx, CnIrFunction *func) {
             }
             fix_blk = fix_blk->next;
         }
+        cgen_block_set_free(&listed);
     }
     
     // 声明虚拟寄存器：根据IR指令中的类型信息收集寄存器类型
@@ -5807,15 +6139,19 @@ void cn_cgen_function(CnCCodeGenContext *ctx, CnIrFunction *func) {
          * CALL返回值类型未传播等），这里通过分析寄存器的使用模式来推断类型。
          * 推断失败时回退到 long long int，不破坏现有功能。
          */
-        for (int i = 0; i < actual_reg_count; i++) {
-            if (!reg_types[i] || reg_types[i]->kind == CN_TYPE_INT ||
-                reg_types[i]->kind == CN_TYPE_UNKNOWN || reg_types[i]->kind == CN_TYPE_VOID) {
-                CnType *inferred = infer_reg_type_from_usage(ctx, func, i, alloca_types);
-                if (inferred && inferred->kind != CN_TYPE_INT &&
-                    inferred->kind != CN_TYPE_UNKNOWN && inferred->kind != CN_TYPE_VOID) {
-                    reg_types[i] = inferred;
+        RegUseIndex reg_uses;
+        if (reg_use_index_build(&reg_uses, func)) {
+            for (int i = 0; i < actual_reg_count; i++) {
+                if (!reg_types[i] || reg_types[i]->kind == CN_TYPE_INT ||
+                    reg_types[i]->kind == CN_TYPE_UNKNOWN || reg_types[i]->kind == CN_TYPE_VOID) {
+                    CnType *inferred = infer_reg_type_from_usage(ctx, func, &reg_uses, i, alloca_types);
+                    if (inferred && inferred->kind != CN_TYPE_INT &&
+                        inferred->kind != CN_TYPE_UNKNOWN && inferred->kind != CN_TYPE_VOID) {
+                        reg_types[i] = inferred;
+                    }
                 }
             }
+            reg_use_index_free(&reg_uses);
         }
         
         /* 【Fix5】恢复ctx->reg_types
@@ -5892,8 +6228,10 @@ void cn_cgen_function(CnCCodeGenContext *ctx, CnIrFunction *func) {
     // 【注意】P3-6基本块链表修复已移到寄存器类型扫描之前执行，
     // 确保类型传播循环能看到所有基本块中的指令。
 
+    alloca_names_build(func);
     CnIrBasicBlock *block = func->first_block;
     while (block) { cn_cgen_block(ctx, block); block = block->next; }
+    alloca_names_free();
     
     // 清除ctx中的reg_types（总是释放，因为要么是堆分配的，要么是从栈复制的）
     if (ctx->reg_types) {
@@ -6031,8 +6369,16 @@ static void collect_local_structs_from_block(CnAstBlockStmt *block, LocalStructI
         
         // 递归处理嵌套块
         if (stmt->kind == CN_AST_STMT_IF) {
-            collect_local_structs_from_block(stmt->as.if_stmt.then_block, struct_infos, count, capacity, func_name, func_name_len);
-            collect_local_structs_from_block(stmt->as.if_stmt.else_block, struct_infos, count, capacity, func_name, func_name_len);
+            // "否则 如果" 链逐段处理，不随链长递归
+            CnAstIfStmt *if_stmt = &stmt->as.if_stmt;
+            while (if_stmt) {
+                CnAstStmt *else_if = cn_frontend_ast_else_if(if_stmt);
+                collect_local_structs_from_block(if_stmt->then_block, struct_infos, count, capacity, func_name, func_name_len);
+                if (!else_if) {
+                    collect_local_structs_from_block(if_stmt->else_block, struct_infos, count, capacity, func_name, func_name_len);
+                }
+                if_stmt = else_if ? &else_if->as.if_stmt : NULL;
+            }
         } else if (stmt->kind == CN_AST_STMT_WHILE) {
             collect_local_structs_from_block(stmt->as.while_stmt.body, struct_infos, count, capacity, func_name, func_name_len);
         } else if (stmt->kind == CN_AST_STMT_FOR) {
@@ -6339,6 +6685,11 @@ int cn_cgen_module_with_structs_to_file(CnIrModule *module, CnAstProgram *progra
                     get_c_type_string(global->type->as.array.element_type),
                     global->name,
                     global->type->as.array.length);
+            // 全常量初始化列表：整体输出为数组初始化器，不需要运行时初始化代码
+            if (global->initializer.kind == CN_IR_OP_CONST_ARRAY) {
+                fprintf(file, " = ");
+                cn_cgen_const_array_initializer(file, global->initializer.as.const_array);
+            }
         } else {
             // 非数组类型：正常生成
             fprintf(file, "%s cn_var_%s",
@@ -6409,6 +6760,7 @@ int cn_cgen_module_with_structs_to_file(CnIrModule *module, CnAstProgram *progra
         global = global->next;
     }
     fprintf(file, "\n");
+    cn_cgen_const_array_tables(file, module);
     
     // 生成函数前置声明（Forward Declarations）
     fprintf(file, "// Forward Declarations\n");
@@ -6747,6 +7099,9 @@ static bool is_struct_variable_name(const char *name) {
     // cn_global_ 前缀的符号是全局变量
     if (strncmp(name, "cn_global_", 10) == 0) return true;
     
+    // cn_static_ 前缀的符号是静态局部变量
+    if (strncmp(name, "cn_static_", 10) == 0) return true;
+    
     return false;
 }
 
@@ -7787,6 +8142,11 @@ int cn_cgen_module_with_imports_to_file(CnIrModule *module, CnAstProgram *progra
                     get_c_type_string(global->type->as.array.element_type),
                     global->name,
                     global->type->as.array.length);
+            // 全常量初始化列表：整体输出为数组初始化器，不需要运行时初始化代码
+            if (global->initializer.kind == CN_IR_OP_CONST_ARRAY) {
+                fprintf(file, " = ");
+                cn_cgen_const_array_initializer(file, global->initializer.as.const_array);
+            }
         } else {
             // 非数组类型：正常生成
             fprintf(file, "%s cn_var_%s",
@@ -7853,6 +8213,7 @@ int cn_cgen_module_with_imports_to_file(CnIrModule *module, CnAstProgram *progra
         global = global->next;
     }
     fprintf(file, "\n");
+    cn_cgen_const_array_tables(file, module);
     
     // 生成函数前置声明（Forward Declarations）
     fprintf(file, "// Forward Declarations\n");
@@ -315,10 +315,12 @@ bool cn_cgen_template_instantiation_expr(CnCCodeGenContext *ctx,
     // 获取模板实例化表达式信息
     CnAstTemplateInstantiationExpr *inst_expr = &expr->as.template_inst;
     
-    // 在缓存中查找对应的实例化
+    // 在缓存中查找对应的实例化（表达式只携带模板名，未登记声明的实例才能按名称命中；
+    // 查不到时按相同规则修饰名称，与实例化时生成的名称一致）
     if (cache && inst_expr->template_name) {
         CnTemplateInstance *instance = cn_template_cache_find(
             cache,
+            NULL,
             inst_expr->template_name,
             inst_expr->template_name_length,
             inst_expr->type_args,
@@ -370,10 +372,11 @@ char *cn_cgen_get_template_mangled_name(const CnAstExpr *expr,
     
     CnAstTemplateInstantiationExpr *inst_expr = &expr->as.template_inst;
     
-    // 在缓存中查找
+    // 在缓存中查找（同上，按名称查找未登记声明的实例）
     if (cache && inst_expr->template_name) {
         CnTemplateInstance *instance = cn_template_cache_find(
             cache,
+            NULL,
             inst_expr->template_name,
             inst_expr->template_name_length,
             inst_expr->type_args,
@@ -16,6 +16,7 @@
 #include "cnlang/frontend/preprocessor.h"
 #include "cnlang/frontend/parser.h"
 #include "cnlang/frontend/ast.h"
+#include "cnlang/frontend/ast_cache.h"
 #include "cnlang/support/diagnostics.h"
 #include "cnlang/runtime/runtime.h"
 #include "cnlang/support/process/process.h"
@@ -23,10 +24,15 @@
 #include "cnlang/support/perf.h"
 #include "cnlang/support/memory_profiler.h"
 #include "cnlang/support/memory_estimator.h"
+#include "cnlang/support/source_manager.h"
+#include "cnlang/support/line_index.h"
+#include "cnlang/support/string_pool.h"
+#include "cnlang/support/memory/arena.h"
 #include "cnlang/ir/ir.h"
 #include "cnlang/ir/irgen.h"
 #include "cnlang/ir/pass.h"
 #include "cnlang/backend/cgen.h"
+#include "cnlang/semantics/template.h"
 #include "cnlang/frontend/module_loader.h"
 
 /*
@@ -174,53 +180,6 @@ const char* get_runtime_include_dir() {
     return include_dir;
 }
 
-// 读取整个源文件到内存缓冲区
-static char *read_file_to_buffer(const char *filename, size_t *out_length)
-{
-    FILE *fp;
-    char *buffer;
-    long size;
-    size_t length;
-
-    fp = fopen(filename, "rb");
-    if (!fp) {
-        return NULL;
-    }
-
-    if (fseek(fp, 0, SEEK_END) != 0) {
-        fclose(fp);
-        return NULL;
-    }
-
-    size = ftell(fp);
-    if (size < 0) {
-        fclose(fp);
-        return NULL;
-    }
-
-    if (fseek(fp, 0, SEEK_SET) != 0) {
-        fclose(fp);
-        return NULL;
-    }
-
-    buffer = (char *)malloc((size_t)size + 1);
-    if (!buffer) {
-        fclose(fp);
-        return NULL;
-    }
-
-    length = fread(buffer, 1, (size_t)size, fp);
-    fclose(fp);
-
-    buffer[length] = '\0';
-
-    if (out_length) {
-        *out_length = length;
-    }
-
-    return buffer;
-}
-
 /*
  * 目录扫描功能 - 递归扫描项目目录下的所有 .cn 文件
  */
@@ -441,8 +400,54 @@ static void print_function_summary(const CnAstProgram *program)
 }
 
 // 打印诊断信息
+// 在诊断下方打印源码行与列标记；源文件由默认源文件管理器持有，
+// 行首索引按文件缓存，同一文件的多条诊断只构建一次
+static void print_diagnostic_excerpt(const CnDiagnostic *d,
+                                     const CnSourceFile **indexed_file,
+                                     CnLineIndex *line_index)
+{
+    const CnSourceFile *file;
+    size_t line_begin;
+    size_t line_end;
+    size_t target;
+
+    if (!d->filename || d->line <= 0) {
+        return;
+    }
+
+    file = cn_source_manager_lookup(cn_source_manager_default(), d->filename);
+    if (!file) {
+        return;
+    }
+    if (file != *indexed_file) {
+        if (*indexed_file) {
+            cn_line_index_free(line_index);
+            *indexed_file = NULL;
+        }
+        if (!cn_line_index_init(line_index, file->data, file->length)) {
+            return;
+        }
+        *indexed_file = file;
+    }
+
+    if (!cn_line_index_line_span(line_index, file->data, (size_t)(d->line - 1),
+                                 &line_begin, &line_end) ||
+        line_end == line_begin) {
+        return;
+    }
+
+    fprintf(stderr, "    | ");
+    fwrite(file->data + line_begin, 1, line_end - line_begin, stderr);
+    fprintf(stderr, "\n    | ");
+    target = cn_line_index_offset_from_diag(line_index, file->data, d->line, d->column);
+    cn_line_index_write_padding(stderr, file->data + line_begin, target - line_begin);
+    fprintf(stderr, "^\n");
+}
+
 static void print_diagnostics(const CnDiagnostics *diagnostics)
 {
+    const CnSourceFile *indexed_file = NULL;
+    CnLineIndex line_index;
     size_t i;
 
     if (!diagnostics || diagnostics->count == 0) {
@@ -478,9 +483,14 @@ static void print_diagnostics(const CnDiagnostics *diagnostics)
                 line,
                 column,
                 message);
+        print_diagnostic_excerpt(d, &indexed_file, &line_index);
         fflush(stderr);
     }
     fflush(stderr);
+
+    if (indexed_file) {
+        cn_line_index_free(&line_index);
+    }
 }
 
 // 检查诊断中是否存在错误
@@ -505,14 +515,16 @@ static bool diagnostics_has_error(const CnDiagnostics *diagnostics)
 int main(int argc, char **argv)
 {
     const char *filename;
-    char *source;
+    const CnSourceFile *source_file;
+    const char *source;
     size_t source_length = 0;
     CnPreprocessor preprocessor;
-    CnLexer lexer;
+    CnTokenStream token_stream;
     CnParser *parser;
     CnAstProgram *program = NULL;
     CnSemScope *global_scope = NULL;
     CnModuleLoader *module_loader = NULL;  // 模块加载器（支持跨文件导入）
+    CnSemCompilation *sem_compilation = NULL;  // 编译上下文（缓存导入的模块）
     CnDiagnostics diagnostics;
     CnPerfStats perf_stats;
     CnMemStats mem_stats;
@@ -556,6 +568,11 @@ int main(int argc, char **argv)
     bool run_pipeline = false;
     bool dump_ir = false;
     bool dump_preprocessed = false;
+    unsigned lex_threads = 0;  // 0 表示串行词法分析
+    unsigned sem_threads = 1;  // 1 表示串行类型检查，0 表示按 CPU 核数并行
+    size_t max_nesting = 0;    // 0 表示使用解析器默认的嵌套层数上限
+    const char *ast_cache_dir = getenv("CN_AST_CACHE_DIR");  // NULL 表示不缓存导入模块的 AST
+    const char *verify_sem_cache = getenv("CN_VERIFY_SEM_CACHE");  // 非空时校验语义缓存（调试用）
     const char *cc_override = NULL;
     bool debug_info = false;
     const char *opt_level = NULL;
@@ -602,11 +619,17 @@ int main(int argc, char **argv)
             fprintf(stderr, "  --perf-output=<文件>  指定性能分析输出文件（支持 .json 或 .csv 格式）\n");
             fprintf(stderr, "  --mem-profile  启用内存占用分析\n");
             fprintf(stderr, "  --mem-output=<文件>  指定内存分析输出文件（支持 .json 或 .csv 格式）\n");
+            fprintf(stderr, "  --lex-threads=<n>  大文件（4MB 以上）使用 n 个线程并行词法分析\n");
+            fprintf(stderr, "  -j<n>/-j       使用 n 个线程（省略 n 时按 CPU 核数）并行检查函数体，诊断输出与串行一致\n");
+            fprintf(stderr, "  --ast-cache=<目录>  把导入模块的 AST 缓存到目录，源码未变化时跳过解析\n");
+            fprintf(stderr, "  --max-nesting=<n>  括号、代码块等的嵌套层数上限（默认 %d）\n", CN_PARSER_DEFAULT_MAX_NESTING);
             fprintf(stderr, "  --help/-h      显示此帮助信息\n\n");
             fprintf(stderr, "环境变量:\n");
             fprintf(stderr, "  CN_RUNTIME_PATH        指定运行时库路径\n");
             fprintf(stderr, "  CN_RUNTIME_HEADER_PATH 指定运行时头文件路径\n");
-            fprintf(stderr, "  CN_MODULE_PATH         指定模块搜索路径\n\n");
+            fprintf(stderr, "  CN_MODULE_PATH         指定模块搜索路径\n");
+            fprintf(stderr, "  CN_AST_CACHE_DIR       指定模块 AST 缓存目录（同 --ast-cache）\n");
+            fprintf(stderr, "  CN_VERIFY_SEM_CACHE    设为 1 时校验缓存的标识符符号与表达式类型（调试用）\n\n");
             fprintf(stderr, "示例:\n");
             fprintf(stderr, "  %s hello.cn                    # 仅进行语法和语义检查\n", argv[0]);
             fprintf(stderr, "  %s hello.cn -o hello            # 编译并生成 hello 可执行文件\n", argv[0]);
@@ -699,6 +722,16 @@ int main(int argc, char **argv)
             enable_mem_profile = true;
         } else if (strcmp(argv[i], "--dump-preprocessed") == 0 || strcmp(argv[i], "-E") == 0) {
             dump_preprocessed = true;
+        } else if (strncmp(argv[i], "--lex-threads=", 14) == 0) {
+            lex_threads = (unsigned)strtoul(argv[i] + 14, NULL, 10);
+        } else if (strcmp(argv[i], "-j") == 0) {
+            sem_threads = 0;
+        } else if (strncmp(argv[i], "-j", 2) == 0 && isdigit((unsigned char)argv[i][2])) {
+            sem_threads = (unsigned)strtoul(argv[i] + 2, NULL, 10);
+        } else if (strncmp(argv[i], "--ast-cache=", 12) == 0) {
+            ast_cache_dir = argv[i] + 12;
+        } else if (strncmp(argv[i], "--max-nesting=", 14) == 0) {
+            max_nesting = (size_t)strtoul(argv[i] + 14, NULL, 10);
         } else if (argv[i][0] != '-') {
             // F1: 支持多个源文件
             if (source_file_count >= source_file_capacity) {
@@ -715,6 +748,13 @@ int main(int argc, char **argv)
         }
     }
     
+    if (ast_cache_dir && ast_cache_dir[0] != '\0') {
+        cn_ast_cache_set_directory(ast_cache_dir);
+    }
+    if (verify_sem_cache && verify_sem_cache[0] != '\0') {
+        cn_sem_cache_set_verify(true);
+    }
+    
     // 处理 --project 参数：扫描项目目录
     CnFileList project_files;
     cn_file_list_init(&project_files);
@@ -795,12 +835,15 @@ int main(int argc, char **argv)
         }
     }
 
-    source = read_file_to_buffer(filename, &source_length);
-    if (!source) {
+    /* 源文件由共享源文件管理器映射，跨模块导入时同一文件不会重复读取 */
+    source_file = cn_source_manager_load(cn_source_manager_default(), filename);
+    if (!source_file) {
         fprintf(stderr, "无法读取文件: %s\n", filename);
         cn_file_list_free(&project_files);
         return 1;
     }
+    source = source_file->data;
+    source_length = source_file->length;
 
     /* 初始化性能统计 */
     cn_perf_stats_init(&perf_stats, filename, source_length);
@@ -819,19 +862,21 @@ int main(int argc, char **argv)
     cn_perf_start(&perf_stats, CN_PERF_PHASE_LEXER);
     cn_frontend_preprocessor_init(&preprocessor, source, source_length, filename);
     cn_frontend_preprocessor_set_diagnostics(&preprocessor, &diagnostics);
+    cn_frontend_preprocessor_set_collect_stats(&preprocessor, enable_perf);
     
-    if (!cn_frontend_preprocessor_process(&preprocessor)) {
-        cn_perf_end(&perf_stats, CN_PERF_PHASE_LEXER);
-        fprintf(stderr, "预处理失败\n");
-        print_diagnostics(&diagnostics);
-        cn_frontend_preprocessor_free(&preprocessor);
-        cn_support_diagnostics_free(&diagnostics);
-        free(source);
-        return 1;
-    }
-    
-    /* 如果只是导出预处理结果，直接输出并退出 */
+    /* 如果只是导出预处理结果，生成整份输出后直接输出并退出 */
     if (dump_preprocessed) {
+        if (!cn_frontend_preprocessor_process(&preprocessor)) {
+            cn_perf_end(&perf_stats, CN_PERF_PHASE_LEXER);
+            fprintf(stderr, "预处理失败\n");
+            print_diagnostics(&diagnostics);
+            cn_frontend_preprocessor_free(&preprocessor);
+            cn_support_diagnostics_free(&diagnostics);
+            cn_source_manager_release_default();
+            cn_type_context_release_default();
+            return 1;
+        }
+
         printf("=== 预处理后的输出 ===\n");
         
         const char *p = preprocessor.output;
@@ -869,35 +914,82 @@ int main(int argc, char **argv)
         
         cn_frontend_preprocessor_free(&preprocessor);
         cn_support_diagnostics_free(&diagnostics);
-        free(source);
+        cn_source_manager_release_default();
+        cn_type_context_release_default();
         return 0;
     }
     
-    /* 词法分析 - 使用预处理后的输出 */
-    cn_frontend_lexer_init(&lexer, preprocessor.output, preprocessor.output_length, filename);
-    cn_frontend_lexer_set_diagnostics(&lexer, &diagnostics);
+    memset(&token_stream, 0, sizeof(token_stream));
+    if (cn_frontend_preprocessor_is_passthrough(&preprocessor)) {
+        /* 词法分析 - 无需预处理时对源码整体预词法化，解析器直接按下标访问词元 */
+        bool lexed;
+        if (lex_threads > 1) {
+            CnLexerParallelOptions lex_options;
+            cn_frontend_lexer_parallel_options_default(&lex_options);
+            lex_options.thread_count = lex_threads;
+            lexed = cn_frontend_token_stream_build_parallel(&token_stream, source, source_length,
+                                                            filename, &diagnostics, &lex_options);
+        } else {
+            lexed = cn_frontend_token_stream_build(&token_stream, source, source_length,
+                                                   filename, &diagnostics);
+        }
+        if (!lexed) {
+            cn_perf_end(&perf_stats, CN_PERF_PHASE_LEXER);
+            fprintf(stderr, "词法分析失败\n");
+            cn_frontend_preprocessor_free(&preprocessor);
+            cn_support_diagnostics_free(&diagnostics);
+            cn_source_manager_release_default();
+            cn_type_context_release_default();
+            return 1;
+        }
+        parser = cn_frontend_parser_new_from_stream(&token_stream);
+    } else {
+        /* 逐词元预处理 - 解析器按需拉取词元，宏展开与条件编译在取词元时完成，
+         * 不生成展开后的整份输出，词元保留原始源码位置 */
+        parser = cn_frontend_parser_new_from_preprocessor(&preprocessor);
+    }
     cn_perf_end(&perf_stats, CN_PERF_PHASE_LEXER);
 
-    parser = cn_frontend_parser_new(&lexer);
     if (!parser) {
         fprintf(stderr, "创建解析器失败\n");
+        cn_frontend_token_stream_free(&token_stream);
         cn_support_diagnostics_free(&diagnostics);
-        free(source);
+        cn_source_manager_release_default();
+        cn_type_context_release_default();
         return 1;
     }
     cn_frontend_parser_set_diagnostics(parser, &diagnostics);
+    cn_frontend_parser_set_max_nesting(parser, max_nesting);
 
     /* 语法分析 */
     cn_perf_start(&perf_stats, CN_PERF_PHASE_PARSER);
     ok = cn_frontend_parse_program(parser, &program);
     cn_perf_end(&perf_stats, CN_PERF_PHASE_PARSER);
+    if (preprocessor.stream_failed) {
+        fprintf(stderr, "预处理失败\n");
+        print_diagnostics(&diagnostics);
+        if (program) {
+            cn_frontend_ast_program_free(program);
+        }
+        cn_frontend_parser_free(parser);
+        cn_frontend_preprocessor_free(&preprocessor);
+        cn_support_diagnostics_free(&diagnostics);
+        cn_source_manager_release_default();
+        cn_type_context_release_default();
+        return 1;
+    }
+    cn_perf_record_macro_stats(&perf_stats, preprocessor.macro_count,
+                               preprocessor.macro_expansion_count,
+                               preprocessor.macro_expansion_time_us);
     if (!ok || !program) {
         fprintf(stderr, "解析失败\n");
         print_diagnostics(&diagnostics);
         cn_support_diagnostics_free(&diagnostics);
         cn_frontend_parser_free(parser);
+        cn_frontend_token_stream_free(&token_stream);
         cn_frontend_preprocessor_free(&preprocessor);
-        free(source);
+        cn_source_manager_release_default();
+        cn_type_context_release_default();
         return 1;
     }
 
@@ -906,9 +998,11 @@ int main(int argc, char **argv)
         print_diagnostics(&diagnostics);
         cn_frontend_ast_program_free(program);
         cn_frontend_parser_free(parser);
+        cn_frontend_token_stream_free(&token_stream);
         cn_frontend_preprocessor_free(&preprocessor);
         cn_support_diagnostics_free(&diagnostics);
-        free(source);
+        cn_source_manager_release_default();
+        cn_type_context_release_default();
         return 1;
     }
 
@@ -918,9 +1012,10 @@ int main(int argc, char **argv)
     
     // 创建模块加载器以支持 Python 风格跨文件模块导入
     module_loader = cn_module_loader_create();
-    if (module_loader) {
+    sem_compilation = cn_sem_compilation_new();
+    if (module_loader && sem_compilation) {
         cn_module_loader_set_diagnostics(module_loader, &diagnostics);
-        global_scope = cn_sem_build_scopes_with_loader(program, &diagnostics, module_loader, filename);
+        global_scope = cn_sem_build_scopes_with_loader(sem_compilation, program, &diagnostics, module_loader, filename);
     } else {
         // 回退到不带模块加载器的版本
         global_scope = cn_sem_build_scopes(program, &diagnostics);
@@ -931,9 +1026,11 @@ int main(int argc, char **argv)
         fprintf(stderr, "构建作用域失败\n");
         cn_frontend_ast_program_free(program);
         cn_frontend_parser_free(parser);
+        cn_frontend_token_stream_free(&token_stream);
         cn_frontend_preprocessor_free(&preprocessor);
         cn_support_diagnostics_free(&diagnostics);
-        free(source);
+        cn_source_manager_release_default();
+        cn_type_context_release_default();
         return 1;
     }
 
@@ -949,16 +1046,27 @@ int main(int argc, char **argv)
         cn_sem_scope_free(global_scope);
         cn_frontend_ast_program_free(program);
         cn_frontend_parser_free(parser);
+        cn_frontend_token_stream_free(&token_stream);
         cn_frontend_preprocessor_free(&preprocessor);
         cn_support_diagnostics_free(&diagnostics);
-        free(source);
+        cn_source_manager_release_default();
+        cn_type_context_release_default();
         return 1;
     }
     cn_perf_end(&perf_stats, CN_PERF_PHASE_SEMANTIC_RESOLVE);
 
     /* 语义分析 - 类型检查 */
     cn_perf_start(&perf_stats, CN_PERF_PHASE_SEMANTIC_TYPECHECK);
-    if (!cn_sem_check_types(global_scope, program, &diagnostics)) {
+    bool types_ok;
+    if (sem_threads != 1) {
+        CnSemParallelOptions sem_options;
+        cn_sem_parallel_options_default(&sem_options);
+        sem_options.thread_count = sem_threads;
+        types_ok = cn_sem_check_types_parallel(global_scope, program, &diagnostics, &sem_options);
+    } else {
+        types_ok = cn_sem_check_types(global_scope, program, &diagnostics);
+    }
+    if (!types_ok) {
         cn_perf_end(&perf_stats, CN_PERF_PHASE_SEMANTIC_TYPECHECK);
         cn_perf_end(&perf_stats, CN_PERF_PHASE_SEMANTIC);
         fprintf(stderr, "类型检查失败\n");
@@ -968,9 +1076,11 @@ int main(int argc, char **argv)
         cn_sem_scope_free(global_scope);
         cn_frontend_ast_program_free(program);
         cn_frontend_parser_free(parser);
+        cn_frontend_token_stream_free(&token_stream);
         cn_frontend_preprocessor_free(&preprocessor);
         cn_support_diagnostics_free(&diagnostics);
-        free(source);
+        cn_source_manager_release_default();
+        cn_type_context_release_default();
         return 1;
     }
     cn_perf_end(&perf_stats, CN_PERF_PHASE_SEMANTIC_TYPECHECK);
@@ -984,9 +1094,11 @@ int main(int argc, char **argv)
             cn_sem_scope_free(global_scope);
             cn_frontend_ast_program_free(program);
             cn_frontend_parser_free(parser);
+            cn_frontend_token_stream_free(&token_stream);
             cn_frontend_preprocessor_free(&preprocessor);
             cn_support_diagnostics_free(&diagnostics);
-            free(source);
+            cn_source_manager_release_default();
+            cn_type_context_release_default();
             return 1;
         }
     }
@@ -1002,9 +1114,12 @@ int main(int argc, char **argv)
 
         /* IR 生成 */
         cn_perf_start(&perf_stats, CN_PERF_PHASE_IR_GEN);
-        CnIrModule *ir_module = cn_ir_gen_program(program, global_scope, target_triple, freestanding_mode ? CN_COMPILE_MODE_FREESTANDING : CN_COMPILE_MODE_HOSTED);
+        CnIrModule *ir_module = cn_ir_gen_program_with_diagnostics(program, global_scope, target_triple,
+                                                                   freestanding_mode ? CN_COMPILE_MODE_FREESTANDING : CN_COMPILE_MODE_HOSTED,
+                                                                   &diagnostics);
         cn_perf_end(&perf_stats, CN_PERF_PHASE_IR_GEN);
         if (!ir_module) {
+            print_diagnostics(&diagnostics);
             fprintf(stderr, "IR 生成失败\n");
             goto cleanup;
         }
@@ -1088,11 +1203,11 @@ int main(int argc, char **argv)
         // =====================================================================
         // 为缓存的导入模块生成IR和C代码
         // =====================================================================
-        int cached_count = cn_sem_get_cached_module_count();
+        int cached_count = cn_sem_get_cached_module_count(sem_compilation);
         for (int i = 0; i < cached_count; i++) {
-            const char *module_path = cn_sem_get_cached_module_path(i);
-            CnAstProgram *module_program = cn_sem_get_cached_module_program(i);
-            CnIrModule *module_ir = cn_sem_get_cached_module_ir(i);
+            const char *module_path = cn_sem_get_cached_module_path(sem_compilation, i);
+            CnAstProgram *module_program = cn_sem_get_cached_module_program(sem_compilation, i);
+            CnIrModule *module_ir = cn_sem_get_cached_module_ir(sem_compilation, i);
             
             
             if (!module_path || !module_program) {
@@ -1107,14 +1222,21 @@ int main(int argc, char **argv)
                 // 暂时使用全局作用域
                 module_scope = global_scope;
                 
-                module_ir = cn_ir_gen_program(module_program, module_scope, target_triple,
-                                              freestanding_mode ? CN_COMPILE_MODE_FREESTANDING : CN_COMPILE_MODE_HOSTED);
+                module_ir = cn_ir_gen_program_with_diagnostics(module_program, module_scope, target_triple,
+                                                               freestanding_mode ? CN_COMPILE_MODE_FREESTANDING : CN_COMPILE_MODE_HOSTED,
+                                                               &diagnostics);
                 if (module_ir) {
                     // IR优化
                     cn_ir_run_default_passes(module_ir);
                     // 缓存IR
-                    cn_sem_set_cached_module_ir(i, module_ir);
-                    } else {
+                    cn_sem_set_cached_module_ir(sem_compilation, i, module_ir);
+                } else if (diagnostics_has_error(&diagnostics)) {
+                    // 模块函数体存在语法错误（跳读模式下首次解析时发现）
+                    print_diagnostics(&diagnostics);
+                    fprintf(stderr, "模块 %s 的 IR 生成失败\n", module_path);
+                    cn_ir_module_free(ir_module);
+                    goto cleanup;
+                } else {
                     continue;
                 }
             }
@@ -1169,7 +1291,7 @@ int main(int argc, char **argv)
         
         // 遍历语义分析模块缓存，收集导入模块的 C 文件路径
         for (int i = 0; i < cached_count; i++) {
-            const char *module_path = cn_sem_get_cached_module_path(i);
+            const char *module_path = cn_sem_get_cached_module_path(sem_compilation, i);
             if (module_path) {
                 // 将 .cn 文件路径转换为 .c 文件路径
                 char module_c_path[1024];
@@ -1367,6 +1489,12 @@ int main(int argc, char **argv)
 
     /* 输出性能统计 */
     if (enable_perf) {
+        /* 所有模块共用同一模板缓存，统计即整个编译的实例化情况 */
+        CnTemplateCache *template_cache = cn_template_cache_default();
+        if (template_cache) {
+            cn_perf_record_template_stats(&perf_stats, template_cache->instance_count,
+                                          template_cache->hit_count, template_cache->miss_count);
+        }
         if (perf_output) {
             /* 根据文件扩展名判断输出格式 */
             size_t len = strlen(perf_output);
@@ -1396,11 +1524,20 @@ int main(int argc, char **argv)
         size_t ast_size = cn_mem_estimate_ast(program);
         size_t symbol_size = cn_mem_estimate_symbol_table(global_scope);
         size_t diag_size = cn_mem_estimate_diagnostics(&diagnostics);
+        CnStringPoolStats pool_stats;
+        size_t ast_arena_bytes = 0;
+        size_t ast_arena_blocks = 0;
+        cn_string_pool_get_stats(cn_string_pool_default(), &pool_stats);
+        if (program) {
+            cn_arena_get_stats(program->arena, &ast_arena_bytes, &ast_arena_blocks);
+        }
         
         /* 记录到统计中 */
         cn_mem_stats_record_alloc(&mem_stats, CN_MEM_CATEGORY_AST, ast_size);
         cn_mem_stats_record_alloc(&mem_stats, CN_MEM_CATEGORY_SYMBOL, symbol_size);
         cn_mem_stats_record_alloc(&mem_stats, CN_MEM_CATEGORY_DIAGNOSTICS, diag_size);
+        cn_mem_stats_record_alloc(&mem_stats, CN_MEM_CATEGORY_STRING_POOL,
+                                  pool_stats.arena_bytes + pool_stats.table_bytes);
         
         /* IR 占用需要在 IR 生成后统计，这里可能已经释放了 */
         /* 如果需要统计 IR，应在 IR 生成后、释放前调用 cn_mem_estimate_ir */
@@ -1426,6 +1563,13 @@ int main(int argc, char **argv)
         }
         /* 总是打印到控制台 */
         cn_mem_stats_print(&mem_stats, stdout);
+        printf("字符串池: %zu 个唯一字符串, %zu 次驻留请求, %zu 次命中, 字符串 %zu 字节, 哈希表 %zu 字节\n",
+               pool_stats.unique_count, pool_stats.intern_calls, pool_stats.hit_count,
+               pool_stats.string_bytes, pool_stats.table_bytes);
+        if (ast_arena_blocks > 0) {
+            printf("AST Arena: 节点与子数组 %zu 字节, %zu 个块\n",
+                   ast_arena_bytes, ast_arena_blocks);
+        }
     }
 
 cleanup:
@@ -1440,11 +1584,16 @@ cleanup:
         cn_module_loader_free(module_loader);
     }
     cn_sem_scope_free(global_scope);
+    cn_sem_compilation_free(sem_compilation);
     cn_frontend_ast_program_free(program);
     cn_frontend_parser_free(parser);
+    cn_frontend_token_stream_free(&token_stream);
     cn_frontend_preprocessor_free(&preprocessor);
     cn_support_diagnostics_free(&diagnostics);
-    free(source);
+    cn_source_manager_release_default();
+    cn_template_cache_release_default();
+    cn_type_context_release_default();
+    cn_string_pool_release_default();
     free((void*)source_files);
     free((void*)include_paths);
     cn_file_list_free(&project_files);  // 释放项目文件列表
@@ -7,6 +7,8 @@ struct CnLspDocumentEntry {
     char *uri;
     char *text;
     size_t length;
+    size_t capacity;                 // 文本缓冲区容量（含终止符）
+    CnLineIndex line_index;          // 行首索引，随增量编辑更新
     CnLspDocumentAnalysis *analysis;
 };
 
@@ -26,10 +28,12 @@ static void cn_lsp_document_entry_free(struct CnLspDocumentEntry *entry)
     if (entry->analysis) {
         cn_lsp_free_analysis(entry->analysis);
     }
+    cn_line_index_free(&entry->line_index);
     entry->uri = NULL;
     entry->text = NULL;
     entry->analysis = NULL;
     entry->length = 0;
+    entry->capacity = 0;
 }
 
 static int cn_lsp_document_manager_find_index(
@@ -87,12 +91,8 @@ static bool cn_lsp_document_manager_ensure_capacity(CnLspDocumentManager *manage
         return false;
     }
     // 初始化新分配的区域
-    for (size_t i = manager->capacity; i < new_capacity; i++) {
-        new_entries[i].uri = NULL;
-        new_entries[i].text = NULL;
-        new_entries[i].length = 0;
-        new_entries[i].analysis = NULL;
-    }
+    memset(new_entries + manager->capacity, 0,
+           (new_capacity - manager->capacity) * sizeof(struct CnLspDocumentEntry));
     manager->entries = new_entries;
     manager->capacity = new_capacity;
     return true;
@@ -136,9 +136,16 @@ bool cn_lsp_document_open(
     memcpy(entry->text, text, length);
     entry->text[length] = '\0';
     entry->length = length;
+    entry->capacity = length + 1;
+
+    if (!cn_line_index_init(&entry->line_index, entry->text, entry->length)) {
+        cn_lsp_document_entry_free(entry);
+        return false;
+    }
 
-    // 调用桥接层进行分析
-    entry->analysis = cn_lsp_analyze_document(entry->text, entry->length, entry->uri);
+    // 调用桥接层进行分析（复用文档的行首索引）
+    entry->analysis = cn_lsp_analyze_document_with_index(entry->text, entry->length, entry->uri,
+                                                         &entry->line_index);
 
     return entry->analysis != NULL;
 }
@@ -149,10 +156,74 @@ bool cn_lsp_document_change(
     const char *text,
     size_t length)
 {
-    // 当前实现：全文重载，行为与 open 相同
+    // 全量同步：全文重载，行为与 open 相同
     return cn_lsp_document_open(manager, uri, text, length);
 }
 
+bool cn_lsp_document_apply_edit(
+    CnLspDocumentManager *manager,
+    const char *uri,
+    CnLspRange range,
+    const char *text,
+    size_t length)
+{
+    if (!manager || !uri || (!text && length > 0) ||
+        range.start.line < 0 || range.end.line < 0) {
+        return false;
+    }
+
+    int index = cn_lsp_document_manager_find_index(manager, uri);
+    if (index < 0) {
+        return false;
+    }
+    struct CnLspDocumentEntry *entry = &manager->entries[index];
+
+    // LSP 范围 -> 字节偏移（行号越过末行时视为文档末尾）
+    size_t start = cn_line_index_offset_from_utf16(&entry->line_index, entry->text,
+                                                   (size_t)range.start.line,
+                                                   range.start.column > 0 ? (size_t)range.start.column : 0);
+    size_t end = cn_line_index_offset_from_utf16(&entry->line_index, entry->text,
+                                                 (size_t)range.end.line,
+                                                 range.end.column > 0 ? (size_t)range.end.column : 0);
+    if (end < start) {
+        return false;
+    }
+
+    size_t removed = end - start;
+    size_t new_length = entry->length - removed + length;
+    if (new_length + 1 > entry->capacity) {
+        size_t new_capacity = entry->capacity * 2 > new_length + 1 ? entry->capacity * 2 : new_length + 1;
+        char *new_text = (char *)realloc(entry->text, new_capacity);
+        if (!new_text) {
+            return false;
+        }
+        entry->text = new_text;
+        entry->capacity = new_capacity;
+    }
+
+    // 分析结果引用旧文本，编辑后不再查询，只交给增量分析接管其 AST
+    CnLspDocumentAnalysis *previous = entry->analysis;
+    entry->analysis = NULL;
+
+    memmove(entry->text + start + length, entry->text + end, entry->length - end);
+    memcpy(entry->text + start, text, length);
+    entry->length = new_length;
+    entry->text[new_length] = '\0';
+
+    if (!cn_line_index_apply_edit(&entry->line_index, entry->text, start, removed, length)) {
+        cn_line_index_free(&entry->line_index);
+        if (!cn_line_index_init(&entry->line_index, entry->text, entry->length)) {
+            cn_lsp_free_analysis(previous);
+            return false;
+        }
+    }
+
+    // 只重新解析受编辑影响的顶层声明
+    entry->analysis = cn_lsp_reanalyze_document(previous, entry->text, entry->length, entry->uri,
+                                                &entry->line_index, start, removed, length);
+    return entry->analysis != NULL;
+}
+
 bool cn_lsp_document_close(
     CnLspDocumentManager *manager,
     const char *uri)
@@ -91,6 +91,153 @@ static void lsp_write_response(int id, const char *result)
     fflush(stdout);
 }
 
+// 读取 4 位十六进制数，失败返回 -1
+static long json_hex4(const char *p)
+{
+    long value = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = p[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9') {
+            value |= c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            value |= c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            value |= c - 'A' + 10;
+        } else {
+            return -1;
+        }
+    }
+    return value;
+}
+
+// 解码 JSON 字符串（start 指向开引号之后），返回新分配的 UTF-8 文本；
+// out_end 指向闭引号。文档文本中的 \n、\" 与 \uXXXX（含代理对）都需要还原，
+// 否则行首索引与词法分析看到的不是编辑器中的文本
+static char *json_decode_string(const char *start, size_t *out_length, const char **out_end)
+{
+    const char *p = start;
+    size_t length = 0;
+    char *text;
+
+    // 第一遍：找到闭引号，解码后的长度不会超过原文长度
+    while (*p && *p != '"') {
+        if (*p == '\\' && p[1]) {
+            p++;
+        }
+        p++;
+    }
+    if (*p != '"') {
+        return NULL;
+    }
+    if (out_end) {
+        *out_end = p;
+    }
+
+    text = (char *)malloc((size_t)(p - start) + 1);
+    if (!text) {
+        return NULL;
+    }
+
+    for (const char *q = start; q < p; q++) {
+        unsigned long cp;
+
+        if (*q != '\\') {
+            text[length++] = *q;
+            continue;
+        }
+
+        q++;
+        switch (*q) {
+        case 'n': text[length++] = '\n'; continue;
+        case 't': text[length++] = '\t'; continue;
+        case 'r': text[length++] = '\r'; continue;
+        case 'b': text[length++] = '\b'; continue;
+        case 'f': text[length++] = '\f'; continue;
+        case 'u': break;
+        default: text[length++] = *q; continue;  // \" \\ \/
+        }
+
+        if (p - q < 5 || json_hex4(q + 1) < 0) {
+            text[length++] = 'u';
+            continue;
+        }
+        cp = (unsigned long)json_hex4(q + 1);
+        q += 4;
+        if (cp >= 0xD800 && cp <= 0xDBFF && p - q >= 7 && q[1] == '\\' && q[2] == 'u') {
+            long low = json_hex4(q + 3);
+            if (low >= 0xDC00 && low <= 0xDFFF) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + ((unsigned long)low - 0xDC00);
+                q += 6;
+            }
+        }
+
+        if (cp < 0x80) {
+            text[length++] = (char)cp;
+        } else if (cp < 0x800) {
+            text[length++] = (char)(0xC0 | (cp >> 6));
+            text[length++] = (char)(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            text[length++] = (char)(0xE0 | (cp >> 12));
+            text[length++] = (char)(0x80 | ((cp >> 6) & 0x3F));
+            text[length++] = (char)(0x80 | (cp & 0x3F));
+        } else {
+            text[length++] = (char)(0xF0 | (cp >> 18));
+            text[length++] = (char)(0x80 | ((cp >> 12) & 0x3F));
+            text[length++] = (char)(0x80 | ((cp >> 6) & 0x3F));
+            text[length++] = (char)(0x80 | (cp & 0x3F));
+        }
+    }
+
+    text[length] = '\0';
+    *out_length = length;
+    return text;
+}
+
+// 在 [from, limit) 内解析 "key":{"line":L,"character":C}
+static bool json_parse_position(const char *from, const char *limit, const char *key,
+                                CnLspPosition *out)
+{
+    const char *p = strstr(from, key);
+    const char *line_start;
+    const char *char_start;
+
+    if (!p || p >= limit) {
+        return false;
+    }
+    line_start = strstr(p, "\"line\":");
+    char_start = strstr(p, "\"character\":");
+    if (!line_start || !char_start || line_start >= limit || char_start >= limit) {
+        return false;
+    }
+    return sscanf(line_start + 7, "%d", &out->line) == 1 &&
+           sscanf(char_start + 12, "%d", &out->column) == 1;
+}
+
+// 从 '{' 起找到与之匹配的 '}'（跳过字符串内容），未找到时返回 NULL
+static const char *json_object_end(const char *p)
+{
+    int depth = 0;
+
+    for (; *p; p++) {
+        if (*p == '"') {
+            for (p++; *p && *p != '"'; p++) {
+                if (*p == '\\' && p[1]) {
+                    p++;
+                }
+            }
+            if (!*p) {
+                return NULL;
+            }
+        } else if (*p == '{') {
+            depth++;
+        } else if (*p == '}' && --depth == 0) {
+            return p;
+        }
+    }
+    return NULL;
+}
+
 // 处理 initialize 请求
 static void handle_initialize(CnLspServer *server, int id)
 {
@@ -101,6 +248,7 @@ static void handle_initialize(CnLspServer *server, int id)
         "\"textDocumentSync\":2,"  /* Incremental */
         "\"definitionProvider\":true,"
         "\"referencesProvider\":true,"
+        "\"documentSymbolProvider\":true,"
         "\"completionProvider\":{\"triggerCharacters\":[]},"
         "\"semanticTokensProvider\":{"
         "\"legend\":{"
@@ -128,10 +276,67 @@ static void handle_did_open(CnLspServer *server, const char *uri, const char *te
     }
 }
 
-// 处理 textDocument/didChange 通知（当前实现：全文重载）
-static void handle_did_change(CnLspServer *server, const char *uri, const char *text, size_t length)
+// 处理 textDocument/didChange 通知：依次应用 contentChanges 中的每一项，
+// 带 range 的为增量编辑（行首索引增量更新），否则为全文替换。
+// 每一项按对象边界解析，不依赖 range 与 text 的键顺序
+static void handle_did_change(CnLspServer *server, const char *uri, const char *changes)
 {
-    if (!cn_lsp_document_change(server->document_manager, uri, text, length)) {
+    const char *cursor = strchr(changes, '[');
+    bool changed = false;
+
+    if (!cursor) {
+        return;
+    }
+    cursor++;
+
+    for (;;) {
+        const char *object_end;
+        const char *text_start;
+        const char *range_key;
+        CnLspRange range;
+        size_t text_len = 0;
+        char *text;
+        bool ok;
+
+        while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r' || *cursor == '\n' ||
+               *cursor == ',') {
+            cursor++;
+        }
+        if (*cursor != '{') {
+            break;
+        }
+        object_end = json_object_end(cursor);
+        if (!object_end) {
+            break;
+        }
+
+        text_start = strstr(cursor, "\"text\":\"");
+        if (!text_start || text_start >= object_end) {
+            break;
+        }
+        text = json_decode_string(text_start + 8, &text_len, NULL);
+        if (!text) {
+            break;
+        }
+
+        range_key = strstr(cursor, "\"range\"");
+        if (range_key && range_key < object_end &&
+            json_parse_position(range_key, object_end, "\"start\"", &range.start) &&
+            json_parse_position(range_key, object_end, "\"end\"", &range.end)) {
+            ok = cn_lsp_document_apply_edit(server->document_manager, uri, range, text, text_len);
+        } else {
+            ok = cn_lsp_document_change(server->document_manager, uri, text, text_len);
+        }
+        free(text);
+
+        if (!ok) {
+            return;
+        }
+        changed = true;
+        cursor = object_end + 1;
+    }
+
+    if (!changed) {
         return;
     }
 
@@ -308,6 +513,88 @@ static void handle_references(CnLspServer *server, int id, const char *uri, int
     free(ranges);
 }
 
+// 符号类别 -> LSP SymbolKind
+static int lsp_symbol_kind(CnSemSymbolKind kind)
+{
+    switch (kind) {
+    case CN_SEM_SYMBOL_FUNCTION: return 12;  // Function
+    case CN_SEM_SYMBOL_STRUCT:   return 23;  // Struct
+    case CN_SEM_SYMBOL_ENUM:     return 10;  // Enum
+    case CN_SEM_SYMBOL_CLASS:    return 5;   // Class
+    default:                     return 13;  // Variable
+    }
+}
+
+// 处理 textDocument/documentSymbol 请求：文档符号只需要顶层声明，
+// 对当前文本做跳读函数体的大纲分析，不解析函数体、不做语义分析
+static void handle_document_symbol(CnLspServer *server, int id, const char *uri)
+{
+    if (!server || !uri) {
+        return;
+    }
+
+    const CnLspDocumentAnalysis *document = cn_lsp_document_get_analysis(server->document_manager, uri);
+    CnLspDocumentAnalysis *outline = NULL;
+    CnLspSymbolInfo *symbols = NULL;
+    size_t count = 0;
+
+    if (document) {
+        outline = cn_lsp_analyze_document_outline(document->source, document->source_length, uri,
+                                                  document->line_index);
+    }
+    if (!outline || !cn_lsp_get_document_symbols(outline, &symbols, &count) || count == 0) {
+        char response[128];
+        int len = snprintf(response, sizeof(response),
+                           "{\"jsonrpc\":\"2.0\",\"id\":%d,\"result\":[]}", id);
+        if (len > 0) {
+            cn_lsp_jsonrpc_write_message(stdout, response, (size_t)len);
+        }
+        free(symbols);
+        cn_lsp_free_analysis(outline);
+        return;
+    }
+
+    size_t capacity = 1024;
+    char *json = (char *)malloc(capacity);
+    int written = json ? snprintf(json, capacity, "{\"jsonrpc\":\"2.0\",\"id\":%d,\"result\":[", id) : -1;
+
+    for (size_t i = 0; i < count && written >= 0; i++) {
+        const CnLspSymbolInfo *symbol = &symbols[i];
+        const CnLspRange *r = &symbol->definition_range;
+        size_t needed = (size_t)written + symbol->name_length + strlen(uri) + 256;
+
+        if (needed >= capacity) {
+            while (needed >= capacity) {
+                capacity *= 2;
+            }
+            char *new_json = (char *)realloc(json, capacity);
+            if (!new_json) {
+                written = -1;
+                break;
+            }
+            json = new_json;
+        }
+
+        int n = snprintf(json + written, capacity - (size_t)written,
+                         "%s{\"name\":\"%.*s\",\"kind\":%d,\"location\":{\"uri\":\"%s\","
+                         "\"range\":{\"start\":{\"line\":%d,\"character\":%d},\"end\":{\"line\":%d,\"character\":%d}}}}",
+                         i > 0 ? "," : "",
+                         (int)symbol->name_length, symbol->name, lsp_symbol_kind(symbol->kind), uri,
+                         r->start.line, r->start.column, r->end.line, r->end.column);
+        written = n < 0 ? -1 : written + n;
+    }
+
+    if (written >= 0 && (size_t)written + 2 < capacity) {
+        json[written++] = ']';
+        json[written++] = '}';
+        cn_lsp_jsonrpc_write_message(stdout, json, (size_t)written);
+    }
+
+    free(json);
+    free(symbols);
+    cn_lsp_free_analysis(outline);
+}
+
 // 处理 textDocument/semanticTokens/full 请求
 static void handle_semantic_tokens_full(CnLspServer *server, int id, const char *uri)
 {
@@ -329,10 +616,8 @@ static void handle_semantic_tokens_full(CnLspServer *server, int id, const char
         return;
     }
 
-    CnLexer lexer;
-    cn_frontend_lexer_init(&lexer, analysis->source, analysis->source_length, uri);
-
-    CnToken token;
+    // 直接使用分析时生成的词元流，位置通过行首索引换算为 UTF-16 列
+    const CnTokenStream *tokens = &analysis->tokens;
     size_t data_capacity = 128;
     size_t data_count = 0;
     int *data = (int *)malloc(data_capacity * sizeof(int));
@@ -344,15 +629,16 @@ static void handle_semantic_tokens_full(CnLspServer *server, int id, const char
     int last_start = 0;
     int has_prev = 0;
 
-    while (cn_frontend_lexer_next_token(&lexer, &token)) {
-        if (token.kind == CN_TOKEN_EOF) {
+    for (size_t i = 0; i < tokens->count; i++) {
+        CnTokenKind kind = (CnTokenKind)tokens->kinds[i];
+        if (kind == CN_TOKEN_EOF) {
             break;
         }
 
         int token_type = -1;
-        if (token.kind == CN_TOKEN_IDENT) {
+        if (kind == CN_TOKEN_IDENT) {
             token_type = 1; // variable
-        } else if (token.kind >= CN_TOKEN_KEYWORD_IF && token.kind <= CN_TOKEN_KEYWORD_VOID) {
+        } else if (kind >= CN_TOKEN_KEYWORD_IF && kind <= CN_TOKEN_KEYWORD_VOID) {
             token_type = 0; // keyword
         }
 
@@ -360,9 +646,11 @@ static void handle_semantic_tokens_full(CnLspServer *server, int id, const char
             continue;
         }
 
-        int line0 = (token.line > 0) ? token.line - 1 : 0;
-        int col0 = (token.column > 0) ? token.column - 1 : 0;
-        int length = (int)token.lexeme_length;
+        CnLspPosition start = cn_lsp_offset_to_position(analysis, tokens->offsets[i]);
+        CnLspPosition end = cn_lsp_offset_to_position(analysis, (size_t)tokens->offsets[i] + tokens->lengths[i]);
+        int line0 = start.line;
+        int col0 = start.column;
+        int length = end.column - start.column;
 
         int delta_line = has_prev ? (line0 - last_line) : line0;
         int delta_start = (delta_line == 0 && has_prev) ? (col0 - last_start) : col0;
@@ -557,60 +845,46 @@ static void process_message(CnLspServer *server, const char *message)
             uri_start += 7;
             const char *uri_end = strchr(uri_start, '"');
             
-            text_start += 8;
-            const char *text_end = strstr(text_start, "\"}");
+            size_t text_len = 0;
+            char *text = json_decode_string(text_start + 8, &text_len, NULL);
             
-            if (uri_end && text_end) {
+            if (uri_end && text) {
                 size_t uri_len = uri_end - uri_start;
-                size_t text_len = text_end - text_start;
-                
                 char *uri = (char *)malloc(uri_len + 1);
-                char *text = (char *)malloc(text_len + 1);
                 
-                if (uri && text) {
+                if (uri) {
                     memcpy(uri, uri_start, uri_len);
                     uri[uri_len] = '\0';
-                    memcpy(text, text_start, text_len);
-                    text[text_len] = '\0';
                     
                     handle_did_open(server, uri, text, text_len);
                 }
                 
                 free(uri);
-                free(text);
             }
+            free(text);
         }
     }
     else if (strstr(message, "\"method\":\"textDocument/didChange\"")) {
-        // 极简解析 uri 和 text（假设使用全量同步，contentChanges[0].text）
+        // 极简解析 uri 和 contentChanges（增量同步：每项含 range 与替换文本）
         const char *uri_start = strstr(message, "\"uri\":\"");
-        const char *text_start = strstr(message, "\"text\":\"");
+        const char *changes = strstr(message, "\"contentChanges\"");
 
-        if (uri_start && text_start) {
+        if (uri_start && changes) {
             uri_start += 7;
             const char *uri_end = strchr(uri_start, '"');
 
-            text_start += 8;
-            const char *text_end = strstr(text_start, "\"}]");
-
-            if (uri_end && text_end) {
+            if (uri_end) {
                 size_t uri_len = uri_end - uri_start;
-                size_t text_len = text_end - text_start;
-
                 char *uri = (char *)malloc(uri_len + 1);
-                char *text = (char *)malloc(text_len + 1);
 
-                if (uri && text) {
+                if (uri) {
                     memcpy(uri, uri_start, uri_len);
                     uri[uri_len] = '\0';
-                    memcpy(text, text_start, text_len);
-                    text[text_len] = '\0';
 
-                    handle_did_change(server, uri, text, text_len);
+                    handle_did_change(server, uri, changes);
                 }
 
                 free(uri);
-                free(text);
             }
         }
     }
@@ -717,6 +991,28 @@ static void process_message(CnLspServer *server, const char *message)
             }
         }
     }
+    else if (strstr(message, "\"method\":\"textDocument/documentSymbol\"")) {
+        const char *id_str = strstr(message, "\"id\":");
+        const char *uri_start = strstr(message, "\"uri\":\"");
+        int id = 0;
+        if (id_str) {
+            sscanf(id_str + 5, "%d", &id);
+        }
+        if (uri_start) {
+            uri_start += 7;
+            const char *uri_end = strchr(uri_start, '"');
+            if (uri_end) {
+                size_t uri_len = uri_end - uri_start;
+                char *uri = (char *)malloc(uri_len + 1);
+                if (uri) {
+                    memcpy(uri, uri_start, uri_len);
+                    uri[uri_len] = '\0';
+                    handle_document_symbol(server, id, uri);
+                    free(uri);
+                }
+            }
+        }
+    }
     else if (strstr(message, "\"method\":\"textDocument/completion\"")) {
         const char *id_str = strstr(message, "\"id\":");
         const char *uri_start = strstr(message, "\"uri\":\"");
@@ -13,6 +13,7 @@
 #include "cnlang/frontend/ast.h"
 #include "cnlang/frontend/semantics.h"
 #include "cnlang/support/diagnostics.h"
+#include "cnlang/support/line_index.h"
 #include "cnlang/ir/ir.h"
 #include "cnlang/ir/irgen.h"
 #include "cnlang/backend/cgen.h"
@@ -41,8 +42,41 @@ typedef struct {
 typedef struct {
     CnSemScope *global_scope;      // 全局作用域，保存所有已定义的变量和函数
     CnAstProgram *accumulated_ast; // 累积的程序 AST，包含所有已定义的函数
+    CnAstProgram **programs;       // 累积函数所在的程序（函数节点位于各程序的 Arena 中）
+    size_t program_count;
+    size_t program_capacity;
 } ReplSession;
 
+/* 释放会话保留的程序 */
+static void repl_session_release_programs(ReplSession *session)
+{
+    for (size_t i = 0; i < session->program_count; i++) {
+        cn_frontend_ast_program_free(session->programs[i]);
+    }
+    free(session->programs);
+    session->programs = NULL;
+    session->program_count = 0;
+    session->program_capacity = 0;
+}
+
+/* 保留程序直到会话重置或销毁，使累积的函数指针保持有效 */
+static bool repl_session_retain_program(ReplSession *session, CnAstProgram *program)
+{
+    if (session->program_count == session->program_capacity) {
+        size_t new_capacity = session->program_capacity == 0 ? 8 : session->program_capacity * 2;
+        CnAstProgram **new_programs = (CnAstProgram **)realloc(
+            session->programs, sizeof(CnAstProgram *) * new_capacity);
+        if (!new_programs) {
+            return false;
+        }
+        session->programs = new_programs;
+        session->program_capacity = new_capacity;
+    }
+
+    session->programs[session->program_count++] = program;
+    return true;
+}
+
 /* 初始化 REPL 会话 */
 static ReplSession *repl_session_new(void)
 {
@@ -68,6 +102,9 @@ static ReplSession *repl_session_new(void)
 
     session->accumulated_ast->function_count = 0;
     session->accumulated_ast->functions = NULL;
+    session->programs = NULL;
+    session->program_count = 0;
+    session->program_capacity = 0;
 
     return session;
 }
@@ -91,6 +128,7 @@ static void repl_session_free(ReplSession *session)
         }
         free(session->accumulated_ast);
     }
+    repl_session_release_programs(session);
 
     free(session);
 }
@@ -118,6 +156,7 @@ static void repl_session_reset(ReplSession *session)
         session->accumulated_ast->function_count = 0;
         session->accumulated_ast->functions = NULL;
     }
+    repl_session_release_programs(session);
 }
 
 /* 打印欢迎信息 */
@@ -173,10 +212,18 @@ static void print_diagnostics_with_context(
     const CnDiagnostics *diagnostics,
     const char *source_code)
 {
+    CnLineIndex line_index;
+    bool has_index = false;
+
     if (!diagnostics || diagnostics->count == 0) {
         return;
     }
 
+    // 所有诊断共用一份行首索引，定位行与对齐标记不再逐字节扫描
+    if (source_code) {
+        has_index = cn_line_index_init(&line_index, source_code, strlen(source_code));
+    }
+
     for (size_t i = 0; i < diagnostics->count; ++i) {
         const CnDiagnostic *d = &diagnostics->items[i];
         const char *severity_str = (d->severity == CN_DIAG_SEVERITY_ERROR) ? "错误" : "警告";
@@ -187,39 +234,24 @@ static void print_diagnostics_with_context(
         fprintf(stderr, "  位置: 行 %d, 列 %d\n", d->line, d->column);
 
         // 显示代码片段（如果提供了源码）
-        if (source_code && d->line > 0) {
-            // 查找错误所在行
-            const char *line_start = source_code;
-            const char *line_end = source_code;
-            int current_line = 1;
-
-            // 定位到目标行
-            while (*line_end && current_line < d->line) {
-                if (*line_end == '\n') {
-                    current_line++;
-                    line_start = line_end + 1;
-                }
-                line_end++;
-            }
-
-            // 找到行尾
-            line_end = line_start;
-            while (*line_end && *line_end != '\n') {
-                line_end++;
-            }
-
+        size_t line_begin;
+        size_t line_end;
+        if (has_index && d->line > 0 &&
+            cn_line_index_line_span(&line_index, source_code, (size_t)(d->line - 1),
+                                    &line_begin, &line_end)) {
             // 显示该行代码
-            if (line_end > line_start) {
+            if (line_end > line_begin) {
                 fprintf(stderr, "  代码: ");
-                fwrite(line_start, 1, line_end - line_start, stderr);
+                fwrite(source_code + line_begin, 1, line_end - line_begin, stderr);
                 fprintf(stderr, "\n");
 
-                // 显示错误位置标记（用 ^ 符号）
+                // 显示错误位置标记（用 ^ 符号，列按字节计，中文字符占两列）
                 if (d->column > 0) {
+                    size_t target = cn_line_index_offset_from_diag(&line_index, source_code,
+                                                                   d->line, d->column);
                     fprintf(stderr, "        ");
-                    for (int j = 1; j < d->column; j++) {
-                        fprintf(stderr, " ");
-                    }
+                    cn_line_index_write_padding(stderr, source_code + line_begin,
+                                                target - line_begin);
                     fprintf(stderr, "^\n");
                 }
             }
@@ -247,6 +279,10 @@ static void print_diagnostics_with_context(
         }
     }
     fprintf(stderr, "\n");
+
+    if (has_index) {
+        cn_line_index_free(&line_index);
+    }
 }
 
 /* 检查诊断中是否存在错误 */
@@ -385,6 +421,7 @@ static void process_input(const char *input, const ReplConfig *config, ReplSessi
     CnLexer lexer;
     CnParser *parser = NULL;
     CnAstProgram *program = NULL;
+    bool program_retained = false;
     CnTargetTriple target_triple;
     char *code_to_parse = NULL;
     bool need_free_code = false;
@@ -494,9 +531,12 @@ static void process_input(const char *input, const ReplConfig *config, ReplSessi
             session->accumulated_ast->functions,
             sizeof(CnAstFunctionDecl *) * new_count
         );
-        
         if (new_functions) {
             session->accumulated_ast->functions = new_functions;
+        }
+        
+        if (new_functions && repl_session_retain_program(session, program)) {
+            program_retained = true;
             
             // 追加新函数
             for (size_t i = 0; i < program->function_count; i++) {
@@ -547,7 +587,9 @@ static void process_input(const char *input, const ReplConfig *config, ReplSessi
             0, 0,
             "IR 生成失败");
         cn_support_diagnostics_print(&diagnostics);
-        cn_frontend_ast_program_free(program);
+        if (!program_retained) {
+            cn_frontend_ast_program_free(program);
+        }
         cn_frontend_parser_free(parser);
         cn_support_diagnostics_free(&diagnostics);
         if (need_free_code) {
@@ -574,13 +616,10 @@ static void process_input(const char *input, const ReplConfig *config, ReplSessi
 
     // 清理资源
     cn_ir_module_free(ir_module);
-    // 注意：不释放 program 中的函数，因为它们已经被添加到 session->accumulated_ast
-    // 只释放 program 的顶层结构
-    if (program->functions) {
-        // 不要 free(program->functions)，因为指针已被会话保存
-        program->functions = NULL;
+    // 函数已加入 session->accumulated_ast 时，程序由会话保留到重置或退出
+    if (!program_retained) {
+        cn_frontend_ast_program_free(program);
     }
-    cn_frontend_ast_program_free(program);
     cn_frontend_parser_free(parser);
     cn_support_diagnostics_free(&diagnostics);
     if (need_free_code) {
@@ -2,6 +2,7 @@
 #include "cnlang/frontend/lexer.h"
 #include "cnlang/frontend/parser.h"
 #include "cnlang/support/diagnostics.h"
+#include "cnlang/support/source_manager.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -532,40 +533,6 @@ char *cn_format_program_to_string(
     return buffer;
 }
 
-// 读取文件内容
-static char *read_file(const char *filename, size_t *out_length)
-{
-    FILE *fp = fopen(filename, "rb");
-    if (!fp) {
-        return NULL;
-    }
-
-    fseek(fp, 0, SEEK_END);
-    long size = ftell(fp);
-    fseek(fp, 0, SEEK_SET);
-
-    if (size < 0) {
-        fclose(fp);
-        return NULL;
-    }
-
-    char *buffer = (char *)malloc(size + 1);
-    if (!buffer) {
-        fclose(fp);
-        return NULL;
-    }
-
-    size_t read_size = fread(buffer, 1, size, fp);
-    buffer[read_size] = '\0';
-    fclose(fp);
-
-    if (out_length) {
-        *out_length = read_size;
-    }
-
-    return buffer;
-}
-
 // 格式化文件
 bool cn_format_file(const char *input_file, const CnFormatOptions *options)
 {
@@ -573,13 +540,16 @@ bool cn_format_file(const char *input_file, const CnFormatOptions *options)
         return false;
     }
 
-    // 读取源文件
-    size_t source_length;
-    char *source = read_file(input_file, &source_length);
-    if (!source) {
+    // 读取源文件（只读映射，词法单元直接指向映射内容）
+    CnSourceManager *sources = cn_source_manager_new();
+    const CnSourceFile *source_file = cn_source_manager_load(sources, input_file);
+    if (!source_file) {
         fprintf(stderr, "无法读取文件: %s\n", input_file);
+        cn_source_manager_free(sources);
         return false;
     }
+    const char *source = source_file->data;
+    size_t source_length = source_file->length;
 
     // 初始化诊断系统
     CnDiagnostics diagnostics;
@@ -595,7 +565,7 @@ bool cn_format_file(const char *input_file, const CnFormatOptions *options)
     if (!parser) {
         fprintf(stderr, "创建解析器失败\n");
         cn_support_diagnostics_free(&diagnostics);
-        free(source);
+        cn_source_manager_free(sources);
         return false;
     }
     cn_frontend_parser_set_diagnostics(parser, &diagnostics);
@@ -609,7 +579,7 @@ bool cn_format_file(const char *input_file, const CnFormatOptions *options)
         }
         cn_frontend_parser_free(parser);
         cn_support_diagnostics_free(&diagnostics);
-        free(source);
+        cn_source_manager_free(sources);
         return false;
     }
 
@@ -620,7 +590,7 @@ bool cn_format_file(const char *input_file, const CnFormatOptions *options)
         cn_frontend_ast_program_free(program);
         cn_frontend_parser_free(parser);
         cn_support_diagnostics_free(&diagnostics);
-        free(source);
+        cn_source_manager_free(sources);
         return false;
     }
 
@@ -649,7 +619,7 @@ bool cn_format_file(const char *input_file, const CnFormatOptions *options)
                     cn_frontend_ast_program_free(program);
                     cn_frontend_parser_free(parser);
                     cn_support_diagnostics_free(&diagnostics);
-                    free(source);
+                    cn_source_manager_free(sources);
                     return false;
                 }
                 free(formatted2);
@@ -666,7 +636,7 @@ bool cn_format_file(const char *input_file, const CnFormatOptions *options)
         cn_frontend_ast_program_free(program);
         cn_frontend_parser_free(parser);
         cn_support_diagnostics_free(&diagnostics);
-        free(source);
+        cn_source_manager_free(sources);
         // 如果需要格式化，返回false（表示检查失败）
         if (needs_formatting) {
             fprintf(stderr, "文件需要格式化: %s\n", input_file);
@@ -674,6 +644,10 @@ bool cn_format_file(const char *input_file, const CnFormatOptions *options)
         return !needs_formatting;
     }
 
+    // 写回前释放源文件映射：原地格式化会覆盖或替换原文件（Windows 上映射中的文件无法删除）
+    cn_source_manager_free(sources);
+    sources = NULL;
+
     // 格式化
     FILE *output = NULL;
     bool success = false;
@@ -723,7 +697,7 @@ cleanup:
     cn_frontend_ast_program_free(program);
     cn_frontend_parser_free(parser);
     cn_support_diagnostics_free(&diagnostics);
-    free(source);
+    cn_source_manager_free(sources);
 
     return success;
 }
@@ -1,7 +1,11 @@
 #include "cnlang/frontend/ast.h"
 #include "cnlang/frontend/semantics.h"  // 用于 cn_sem_scope_free
+#include "cnlang/frontend/ast/class_node.h"
+#include "cnlang/support/memory/arena.h"
 
+#include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 
 static void cn_frontend_ast_stmt_array_free(CnAstStmt **stmts, size_t count);
 static void cn_frontend_ast_expr_array_free(CnAstExpr **exprs, size_t count);
@@ -32,6 +36,9 @@ void cn_frontend_ast_expr_free(CnAstExpr *expr)
         break;
     case CN_AST_EXPR_BOOL_LITERAL:
         break;
+    case CN_AST_EXPR_EMBED:
+        // 文件内容由源文件管理器持有
+        break;
     case CN_AST_EXPR_ASSIGN:
         cn_frontend_ast_expr_free(expr->as.assign.target);
         cn_frontend_ast_expr_free(expr->as.assign.value);
@@ -252,6 +259,17 @@ void cn_frontend_ast_program_free(CnAstProgram *program)
         return;
     }
 
+    // 解析器创建的程序：节点都在 Arena 中，只需释放挂在节点上的作用域
+    if (program->arena) {
+        for (i = 0; i < program->owned_scope_count; ++i) {
+            cn_sem_scope_free(program->owned_scopes[i]);
+        }
+        free(program->owned_scopes);
+        cn_arena_free(program->arena);
+        free(program);
+        return;
+    }
+
     for (i = 0; i < program->function_count; ++i) {
         cn_frontend_ast_function_free(program->functions[i]);
     }
@@ -293,6 +311,674 @@ void cn_frontend_ast_program_free(CnAstProgram *program)
     free(program);
 }
 
+int cn_frontend_ast_program_adopt_scope(CnAstProgram *program, struct CnSemScope *scope)
+{
+    if (!program || !scope || !program->arena) {
+        return 1;
+    }
+
+    if (program->owned_scope_count == program->owned_scope_capacity) {
+        size_t new_capacity = program->owned_scope_capacity == 0 ? 16 : program->owned_scope_capacity * 2;
+        struct CnSemScope **new_scopes = (struct CnSemScope **)realloc(
+            program->owned_scopes, new_capacity * sizeof(struct CnSemScope *));
+        if (!new_scopes) {
+            return 0;
+        }
+        program->owned_scopes = new_scopes;
+        program->owned_scope_capacity = new_capacity;
+    }
+
+    program->owned_scopes[program->owned_scope_count++] = scope;
+    return 1;
+}
+
+// 按种类的节点大小：联合体之前的公共头部加上该种类实际使用的成员
+#define CN_AST_EXPR_SIZE(member) (offsetof(CnAstExpr, as) + sizeof(((CnAstExpr *)0)->as.member))
+#define CN_AST_STMT_SIZE(member) (offsetof(CnAstStmt, as) + sizeof(((CnAstStmt *)0)->as.member))
+
+size_t cn_frontend_ast_expr_node_size(CnAstExprKind kind)
+{
+    switch (kind) {
+        case CN_AST_EXPR_BINARY: return CN_AST_EXPR_SIZE(binary);
+        case CN_AST_EXPR_CALL: return CN_AST_EXPR_SIZE(call);
+        case CN_AST_EXPR_IDENTIFIER: return CN_AST_EXPR_SIZE(identifier);
+        case CN_AST_EXPR_INTEGER_LITERAL: return CN_AST_EXPR_SIZE(integer_literal);
+        case CN_AST_EXPR_FLOAT_LITERAL: return CN_AST_EXPR_SIZE(float_literal);
+        case CN_AST_EXPR_STRING_LITERAL: return CN_AST_EXPR_SIZE(string_literal);
+        case CN_AST_EXPR_CHAR_LITERAL: return CN_AST_EXPR_SIZE(char_literal);
+        case CN_AST_EXPR_BOOL_LITERAL: return CN_AST_EXPR_SIZE(bool_literal);
+        case CN_AST_EXPR_ASSIGN: return CN_AST_EXPR_SIZE(assign);
+        case CN_AST_EXPR_LOGICAL: return CN_AST_EXPR_SIZE(logical);
+        case CN_AST_EXPR_UNARY: return CN_AST_EXPR_SIZE(unary);
+        case CN_AST_EXPR_TERNARY: return CN_AST_EXPR_SIZE(ternary);
+        case CN_AST_EXPR_ARRAY_LITERAL: return CN_AST_EXPR_SIZE(array_literal);
+        case CN_AST_EXPR_INDEX: return CN_AST_EXPR_SIZE(index);
+        case CN_AST_EXPR_MEMBER_ACCESS: return CN_AST_EXPR_SIZE(member);
+        case CN_AST_EXPR_STRUCT_LITERAL: return CN_AST_EXPR_SIZE(struct_lit);
+        case CN_AST_EXPR_MEMORY_READ: return CN_AST_EXPR_SIZE(memory_read);
+        case CN_AST_EXPR_MEMORY_WRITE: return CN_AST_EXPR_SIZE(memory_write);
+        case CN_AST_EXPR_MEMORY_COPY: return CN_AST_EXPR_SIZE(memory_copy);
+        case CN_AST_EXPR_MEMORY_SET: return CN_AST_EXPR_SIZE(memory_set);
+        case CN_AST_EXPR_MEMORY_MAP: return CN_AST_EXPR_SIZE(memory_map);
+        case CN_AST_EXPR_MEMORY_UNMAP: return CN_AST_EXPR_SIZE(memory_unmap);
+        case CN_AST_EXPR_INLINE_ASM: return CN_AST_EXPR_SIZE(inline_asm);
+        case CN_AST_EXPR_TEMPLATE_INSTANTIATION: return CN_AST_EXPR_SIZE(template_inst);
+        case CN_AST_EXPR_CAST: return CN_AST_EXPR_SIZE(cast);
+        case CN_AST_EXPR_EMBED: return CN_AST_EXPR_SIZE(embed);
+    }
+    return sizeof(CnAstExpr);
+}
+
+size_t cn_frontend_ast_stmt_node_size(CnAstStmtKind kind)
+{
+    switch (kind) {
+        case CN_AST_STMT_BLOCK: return CN_AST_STMT_SIZE(block);
+        case CN_AST_STMT_VAR_DECL: return CN_AST_STMT_SIZE(var_decl);
+        case CN_AST_STMT_EXPR: return CN_AST_STMT_SIZE(expr);
+        case CN_AST_STMT_RETURN: return CN_AST_STMT_SIZE(return_stmt);
+        case CN_AST_STMT_IF: return CN_AST_STMT_SIZE(if_stmt);
+        case CN_AST_STMT_WHILE: return CN_AST_STMT_SIZE(while_stmt);
+        case CN_AST_STMT_FOR: return CN_AST_STMT_SIZE(for_stmt);
+        case CN_AST_STMT_BREAK:
+        case CN_AST_STMT_CONTINUE: return offsetof(CnAstStmt, as);
+        case CN_AST_STMT_SWITCH: return CN_AST_STMT_SIZE(switch_stmt);
+        case CN_AST_STMT_STRUCT_DECL: return CN_AST_STMT_SIZE(struct_decl);
+        case CN_AST_STMT_ENUM_DECL: return CN_AST_STMT_SIZE(enum_decl);
+        case CN_AST_STMT_IMPORT: return CN_AST_STMT_SIZE(import_stmt);
+        case CN_AST_STMT_CLASS_DECL: return CN_AST_STMT_SIZE(class_decl);
+        case CN_AST_STMT_INTERFACE_DECL: return CN_AST_STMT_SIZE(interface_decl);
+        case CN_AST_STMT_TRY: return CN_AST_STMT_SIZE(try_stmt);
+        case CN_AST_STMT_THROW: return CN_AST_STMT_SIZE(throw_stmt);
+        case CN_AST_STMT_FINALLY: return CN_AST_STMT_SIZE(finally_stmt);
+        case CN_AST_STMT_TEMPLATE_FUNCTION_DECL: return CN_AST_STMT_SIZE(template_func_decl);
+        case CN_AST_STMT_TEMPLATE_STRUCT_DECL: return CN_AST_STMT_SIZE(template_struct_decl);
+        case CN_AST_STMT_CATCH: break;
+    }
+    return sizeof(CnAstStmt);
+}
+
+static CnAstExpr *chain_left(const CnAstExpr *expr)
+{
+    return expr->kind == CN_AST_EXPR_BINARY ? expr->as.binary.left : expr->as.logical.left;
+}
+
+int cn_frontend_ast_expr_chain_collect(CnAstExprChain *chain, CnAstExpr *expr)
+{
+    CnAstExpr *node = expr;
+
+    chain->nodes = chain->inline_nodes;
+    chain->count = 0;
+    chain->capacity = sizeof(chain->inline_nodes) / sizeof(chain->inline_nodes[0]);
+    if (!expr || (expr->kind != CN_AST_EXPR_BINARY && expr->kind != CN_AST_EXPR_LOGICAL)) {
+        return 1;
+    }
+
+    while (node && node->kind == expr->kind) {
+        if (chain->count == chain->capacity) {
+            size_t capacity = chain->capacity * 2;
+            CnAstExpr **nodes = (CnAstExpr **)malloc(capacity * sizeof(CnAstExpr *));
+            if (!nodes) {
+                cn_frontend_ast_expr_chain_free(chain);
+                return 0;
+            }
+            memcpy(nodes, chain->nodes, chain->count * sizeof(CnAstExpr *));
+            if (chain->nodes != chain->inline_nodes) {
+                free(chain->nodes);
+            }
+            chain->nodes = nodes;
+            chain->capacity = capacity;
+        }
+        chain->nodes[chain->count++] = node;
+        node = chain_left(node);
+    }
+    return 1;
+}
+
+CnAstExpr *cn_frontend_ast_expr_chain_leaf(const CnAstExprChain *chain)
+{
+    return chain->count > 0 ? chain_left(chain->nodes[chain->count - 1]) : NULL;
+}
+
+CnAstExpr *cn_frontend_ast_expr_chain_right(const CnAstExprChain *chain, size_t index)
+{
+    const CnAstExpr *node = chain->nodes[index];
+    return node->kind == CN_AST_EXPR_BINARY ? node->as.binary.right : node->as.logical.right;
+}
+
+void cn_frontend_ast_expr_chain_free(CnAstExprChain *chain)
+{
+    if (chain->nodes != chain->inline_nodes) {
+        free(chain->nodes);
+    }
+    chain->nodes = chain->inline_nodes;
+    chain->count = 0;
+    chain->capacity = sizeof(chain->inline_nodes) / sizeof(chain->inline_nodes[0]);
+}
+
+CnAstStmt *cn_frontend_ast_else_if(const CnAstIfStmt *if_stmt)
+{
+    const CnAstBlockStmt *else_block = if_stmt ? if_stmt->else_block : NULL;
+
+    if (else_block && else_block->stmt_count == 1 && else_block->stmts[0] &&
+        else_block->stmts[0]->kind == CN_AST_STMT_IF) {
+        return else_block->stmts[0];
+    }
+    return NULL;
+}
+
+static int is_scalar_constant_literal(const CnAstExpr *expr)
+{
+    if (!expr) {
+        return 0;
+    }
+    switch (expr->kind) {
+        case CN_AST_EXPR_INTEGER_LITERAL:
+        case CN_AST_EXPR_FLOAT_LITERAL:
+        case CN_AST_EXPR_CHAR_LITERAL:
+        case CN_AST_EXPR_BOOL_LITERAL:
+        case CN_AST_EXPR_STRING_LITERAL:
+            return 1;
+        case CN_AST_EXPR_UNARY:
+            return expr->as.unary.op == CN_AST_UNARY_OP_MINUS && expr->as.unary.operand &&
+                   (expr->as.unary.operand->kind == CN_AST_EXPR_INTEGER_LITERAL ||
+                    expr->as.unary.operand->kind == CN_AST_EXPR_FLOAT_LITERAL);
+        default:
+            return 0;
+    }
+}
+
+int cn_frontend_ast_is_constant_literal(const CnAstExpr *expr)
+{
+    if (expr && expr->kind == CN_AST_EXPR_STRUCT_LITERAL) {
+        for (size_t i = 0; i < expr->as.struct_lit.field_count; i++) {
+            if (!is_scalar_constant_literal(expr->as.struct_lit.fields[i].value)) {
+                return 0;
+            }
+        }
+        return 1;
+    }
+    return is_scalar_constant_literal(expr);
+}
+
+int cn_frontend_ast_array_literal_is_constant(const CnAstExpr *expr)
+{
+    if (!expr || expr->kind != CN_AST_EXPR_ARRAY_LITERAL ||
+        expr->as.array_literal.element_count == 0 || !expr->as.array_literal.elements) {
+        return 0;
+    }
+    for (size_t i = 0; i < expr->as.array_literal.element_count; i++) {
+        if (!cn_frontend_ast_is_constant_literal(expr->as.array_literal.elements[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// 子树遍历：平移行号（增量解析）与清除语义信息（重新分析）共用同一套节点访问逻辑
+typedef struct CnAstWalk {
+    int line_delta;        // 非 0 时平移行号
+    int reset_semantics;   // 清除语义分析写入的信息
+    int free_scopes;       // 清除时释放节点上的作用域（不使用 Arena 的程序，作用域未登记到程序）
+} CnAstWalk;
+
+static void walk_expr(const CnAstWalk *walk, CnAstExpr *expr);
+static void walk_stmt(const CnAstWalk *walk, CnAstStmt *stmt);
+static void walk_block(const CnAstWalk *walk, CnAstBlockStmt *block);
+
+static void walk_loc(const CnAstWalk *walk, CnSourceLocation *loc)
+{
+    // 行号为 0 表示未知，保持不变
+    if (walk->line_delta != 0 && loc->line > 0) {
+        loc->line += walk->line_delta;
+    }
+}
+
+static void walk_scope(const CnAstWalk *walk, struct CnSemScope **scope)
+{
+    if (!walk->reset_semantics) {
+        return;
+    }
+    if (walk->free_scopes && *scope) {
+        cn_sem_scope_free(*scope);
+    }
+    *scope = NULL;
+}
+
+// 解析器创建的结构体类型只有名字，字段与声明作用域由语义分析按名字查到后写入；
+// 指针的目标类型也可能被替换为符号表中的结构体类型，一并恢复为只有名字的状态
+static void walk_type(const CnAstWalk *walk, CnType *type)
+{
+    if (!walk->reset_semantics) {
+        return;
+    }
+
+    while (type) {
+        switch (type->kind) {
+        case CN_TYPE_STRUCT:
+            type->as.struct_type.fields = NULL;
+            type->as.struct_type.field_count = 0;
+            type->as.struct_type.decl_scope = NULL;
+            return;
+        case CN_TYPE_POINTER:
+            type = type->as.pointer_to;
+            break;
+        case CN_TYPE_ARRAY:
+            type = type->as.array.element_type;
+            break;
+        case CN_TYPE_FUNCTION:
+            for (size_t i = 0; i < type->as.function.param_count; i++) {
+                walk_type(walk, type->as.function.param_types[i]);
+            }
+            type = type->as.function.return_type;
+            break;
+        default:
+            return;
+        }
+    }
+}
+
+static void walk_expr_array(const CnAstWalk *walk, CnAstExpr **exprs, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        walk_expr(walk, exprs[i]);
+    }
+}
+
+static void walk_parameters(const CnAstWalk *walk, CnAstParameter *parameters, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        walk_type(walk, parameters[i].declared_type);
+    }
+}
+
+static void walk_template_params(const CnAstWalk *walk, CnAstTemplateParams *params)
+{
+    if (!params) {
+        return;
+    }
+    for (size_t i = 0; i < params->param_count; i++) {
+        walk_type(walk, params->params[i].constraint);
+        walk_type(walk, params->params[i].default_type);
+    }
+}
+
+static void walk_struct_fields(const CnAstWalk *walk, CnAstStructField *fields, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        walk_type(walk, fields[i].field_type);
+    }
+}
+
+static void walk_function(const CnAstWalk *walk, CnAstFunctionDecl *function_decl)
+{
+    if (!function_decl) {
+        return;
+    }
+
+    walk_scope(walk, &function_decl->owning_scope);
+    walk_parameters(walk, function_decl->parameters, function_decl->parameter_count);
+    walk_type(walk, function_decl->return_type);
+    walk_block(walk, function_decl->body);
+}
+
+static void walk_class_members(const CnAstWalk *walk, CnClassMember *members, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        CnClassMember *member = &members[i];
+
+        walk_type(walk, member->type);
+        walk_expr(walk, member->init_expr);
+        walk_block(walk, member->body);
+        walk_parameters(walk, member->parameters, member->parameter_count);
+        for (size_t j = 0; j < member->initializer_count; j++) {
+            walk_expr(walk, member->initializer_list[j].value);
+        }
+    }
+}
+
+// 单个表达式节点自身的位置与语义信息（不含子节点）
+static void walk_expr_node(const CnAstWalk *walk, CnAstExpr *expr)
+{
+    walk_loc(walk, &expr->loc);
+    if (walk->reset_semantics) {
+        // 字面量的类型由解析器按后缀给出，类型转换的类型即目标类型，其余由语义分析推断
+        switch (expr->kind) {
+        case CN_AST_EXPR_INTEGER_LITERAL:
+        case CN_AST_EXPR_FLOAT_LITERAL:
+        case CN_AST_EXPR_CHAR_LITERAL:
+            break;
+        case CN_AST_EXPR_CAST:
+            expr->type = expr->as.cast.target_type;
+            break;
+        case CN_AST_EXPR_EMBED:
+            expr->type = NULL;
+            expr->as.embed.data = NULL;
+            expr->as.embed.size = 0;
+            break;
+        default:
+            expr->type = NULL;
+            break;
+        }
+    }
+}
+
+static void walk_expr(const CnAstWalk *walk, CnAstExpr *expr)
+{
+    if (!expr) {
+        return;
+    }
+
+    walk_expr_node(walk, expr);
+    switch (expr->kind) {
+    case CN_AST_EXPR_BINARY:
+    case CN_AST_EXPR_LOGICAL:
+        // 左结合长链沿左侧循环遍历，各节点的处理互不依赖，与顺序无关
+        for (CnAstExpr *node = expr;;) {
+            CnAstExpr *left = node->kind == CN_AST_EXPR_BINARY ? node->as.binary.left : node->as.logical.left;
+            walk_expr(walk, node->kind == CN_AST_EXPR_BINARY ? node->as.binary.right : node->as.logical.right);
+            if (!left || left->kind != expr->kind) {
+                walk_expr(walk, left);
+                break;
+            }
+            walk_expr_node(walk, left);
+            node = left;
+        }
+        break;
+    case CN_AST_EXPR_CALL:
+        walk_expr(walk, expr->as.call.callee);
+        walk_expr_array(walk, expr->as.call.arguments, expr->as.call.argument_count);
+        break;
+    case CN_AST_EXPR_IDENTIFIER:
+    case CN_AST_EXPR_INTEGER_LITERAL:
+    case CN_AST_EXPR_FLOAT_LITERAL:
+    case CN_AST_EXPR_STRING_LITERAL:
+    case CN_AST_EXPR_CHAR_LITERAL:
+    case CN_AST_EXPR_BOOL_LITERAL:
+    case CN_AST_EXPR_EMBED:
+        break;
+    case CN_AST_EXPR_ASSIGN:
+        walk_expr(walk, expr->as.assign.target);
+        walk_expr(walk, expr->as.assign.value);
+        break;
+    case CN_AST_EXPR_UNARY:
+        walk_expr(walk, expr->as.unary.operand);
+        break;
+    case CN_AST_EXPR_TERNARY:
+        walk_expr(walk, expr->as.ternary.condition);
+        walk_expr(walk, expr->as.ternary.true_expr);
+        walk_expr(walk, expr->as.ternary.false_expr);
+        break;
+    case CN_AST_EXPR_ARRAY_LITERAL:
+        walk_expr_array(walk, expr->as.array_literal.elements, expr->as.array_literal.element_count);
+        break;
+    case CN_AST_EXPR_INDEX:
+        walk_expr(walk, expr->as.index.array);
+        walk_expr(walk, expr->as.index.index);
+        break;
+    case CN_AST_EXPR_MEMBER_ACCESS:
+        // 静态成员访问由语义分析识别（类名.成员）
+        if (walk->reset_semantics) {
+            expr->as.member.is_static_member = 0;
+            expr->as.member.class_name = NULL;
+            expr->as.member.class_name_length = 0;
+        }
+        walk_expr(walk, expr->as.member.object);
+        break;
+    case CN_AST_EXPR_STRUCT_LITERAL:
+        for (size_t i = 0; i < expr->as.struct_lit.field_count; i++) {
+            walk_expr(walk, expr->as.struct_lit.fields[i].value);
+        }
+        break;
+    case CN_AST_EXPR_MEMORY_READ:
+        walk_expr(walk, expr->as.memory_read.address);
+        break;
+    case CN_AST_EXPR_MEMORY_WRITE:
+        walk_expr(walk, expr->as.memory_write.address);
+        walk_expr(walk, expr->as.memory_write.value);
+        break;
+    case CN_AST_EXPR_MEMORY_COPY:
+        walk_expr(walk, expr->as.memory_copy.dest);
+        walk_expr(walk, expr->as.memory_copy.src);
+        walk_expr(walk, expr->as.memory_copy.size);
+        break;
+    case CN_AST_EXPR_MEMORY_SET:
+        walk_expr(walk, expr->as.memory_set.address);
+        walk_expr(walk, expr->as.memory_set.value);
+        walk_expr(walk, expr->as.memory_set.size);
+        break;
+    case CN_AST_EXPR_MEMORY_MAP:
+        walk_expr(walk, expr->as.memory_map.address);
+        walk_expr(walk, expr->as.memory_map.size);
+        walk_expr(walk, expr->as.memory_map.prot);
+        walk_expr(walk, expr->as.memory_map.flags);
+        break;
+    case CN_AST_EXPR_MEMORY_UNMAP:
+        walk_expr(walk, expr->as.memory_unmap.address);
+        walk_expr(walk, expr->as.memory_unmap.size);
+        break;
+    case CN_AST_EXPR_INLINE_ASM:
+        walk_expr(walk, expr->as.inline_asm.asm_code);
+        walk_expr_array(walk, expr->as.inline_asm.outputs, expr->as.inline_asm.output_count);
+        walk_expr_array(walk, expr->as.inline_asm.inputs, expr->as.inline_asm.input_count);
+        walk_expr(walk, expr->as.inline_asm.clobbers);
+        break;
+    case CN_AST_EXPR_TEMPLATE_INSTANTIATION:
+        for (size_t i = 0; i < expr->as.template_inst.type_arg_count; i++) {
+            walk_type(walk, expr->as.template_inst.type_args[i]);
+        }
+        break;
+    case CN_AST_EXPR_CAST:
+        walk_type(walk, expr->as.cast.target_type);
+        walk_expr(walk, expr->as.cast.operand);
+        break;
+    }
+}
+
+static void walk_block(const CnAstWalk *walk, CnAstBlockStmt *block)
+{
+    if (!block) {
+        return;
+    }
+
+    walk_scope(walk, &block->owning_scope);
+    for (size_t i = 0; i < block->stmt_count; i++) {
+        walk_stmt(walk, block->stmts[i]);
+    }
+}
+
+static void walk_stmt(const CnAstWalk *walk, CnAstStmt *stmt)
+{
+    if (!stmt) {
+        return;
+    }
+
+    walk_loc(walk, &stmt->loc);
+    switch (stmt->kind) {
+    case CN_AST_STMT_BLOCK:
+        walk_block(walk, stmt->as.block);
+        break;
+    case CN_AST_STMT_VAR_DECL:
+        // 语义分析把声明类型改写为解析或推断后的类型
+        if (walk->reset_semantics) {
+            stmt->as.var_decl.declared_type = stmt->as.var_decl.source_type;
+        }
+        walk_type(walk, stmt->as.var_decl.source_type);
+        walk_expr(walk, stmt->as.var_decl.initializer);
+        break;
+    case CN_AST_STMT_EXPR:
+        walk_expr(walk, stmt->as.expr.expr);
+        break;
+    case CN_AST_STMT_RETURN:
+        walk_expr(walk, stmt->as.return_stmt.expr);
+        break;
+    case CN_AST_STMT_IF:
+        // "否则 如果" 链逐段循环：包装块只处理其作用域与其中 如果 语句的位置
+        for (CnAstIfStmt *if_stmt = &stmt->as.if_stmt;;) {
+            CnAstStmt *else_if = cn_frontend_ast_else_if(if_stmt);
+            walk_expr(walk, if_stmt->condition);
+            walk_block(walk, if_stmt->then_block);
+            if (!else_if) {
+                walk_block(walk, if_stmt->else_block);
+                break;
+            }
+            walk_scope(walk, &if_stmt->else_block->owning_scope);
+            walk_loc(walk, &else_if->loc);
+            if_stmt = &else_if->as.if_stmt;
+        }
+        break;
+    case CN_AST_STMT_WHILE:
+        walk_expr(walk, stmt->as.while_stmt.condition);
+        walk_block(walk, stmt->as.while_stmt.body);
+        break;
+    case CN_AST_STMT_FOR:
+        walk_stmt(walk, stmt->as.for_stmt.init);
+        walk_expr(walk, stmt->as.for_stmt.condition);
+        walk_expr(walk, stmt->as.for_stmt.update);
+        walk_block(walk, stmt->as.for_stmt.body);
+        break;
+    case CN_AST_STMT_SWITCH:
+        walk_expr(walk, stmt->as.switch_stmt.expr);
+        for (size_t i = 0; i < stmt->as.switch_stmt.case_count; i++) {
+            walk_expr(walk, stmt->as.switch_stmt.cases[i].value);
+            walk_block(walk, stmt->as.switch_stmt.cases[i].body);
+        }
+        break;
+    case CN_AST_STMT_BREAK:
+    case CN_AST_STMT_CONTINUE:
+    case CN_AST_STMT_ENUM_DECL:
+    case CN_AST_STMT_IMPORT:
+    case CN_AST_STMT_CATCH:
+        break;
+    case CN_AST_STMT_STRUCT_DECL:
+        walk_struct_fields(walk, stmt->as.struct_decl.fields, stmt->as.struct_decl.field_count);
+        break;
+    case CN_AST_STMT_CLASS_DECL:
+        if (stmt->as.class_decl) {
+            CnAstClassDecl *class_decl = stmt->as.class_decl;
+
+            walk_loc(walk, &class_decl->base.loc);
+            for (size_t i = 0; i < class_decl->implemented_interface_count; i++) {
+                CnAstInterfaceInstantiation *inst = class_decl->implemented_interfaces[i];
+                if (walk->line_delta != 0 && inst->line > 0) {
+                    inst->line += walk->line_delta;
+                }
+                for (size_t j = 0; j < inst->type_arg_count; j++) {
+                    walk_type(walk, inst->type_args[j]);
+                }
+            }
+            walk_class_members(walk, class_decl->members, class_decl->member_count);
+        }
+        break;
+    case CN_AST_STMT_INTERFACE_DECL:
+        if (stmt->as.interface_decl) {
+            CnAstInterfaceDecl *interface_decl = stmt->as.interface_decl;
+
+            walk_loc(walk, &interface_decl->base.loc);
+            walk_template_params(walk, interface_decl->template_params);
+            walk_class_members(walk, interface_decl->methods, interface_decl->method_count);
+        }
+        break;
+    case CN_AST_STMT_TRY:
+        if (stmt->as.try_stmt) {
+            walk_block(walk, stmt->as.try_stmt->try_block);
+            for (size_t i = 0; i < stmt->as.try_stmt->catch_count; i++) {
+                walk_block(walk, stmt->as.try_stmt->catches[i].body);
+            }
+            walk_block(walk, stmt->as.try_stmt->finally_block);
+        }
+        break;
+    case CN_AST_STMT_THROW:
+        walk_expr(walk, stmt->as.throw_stmt.exception_expr);
+        break;
+    case CN_AST_STMT_FINALLY:
+        if (stmt->as.finally_stmt) {
+            walk_block(walk, stmt->as.finally_stmt->body);
+        }
+        break;
+    case CN_AST_STMT_TEMPLATE_FUNCTION_DECL:
+        if (stmt->as.template_func_decl) {
+            walk_template_params(walk, stmt->as.template_func_decl->template_params);
+            walk_function(walk, stmt->as.template_func_decl->function);
+        }
+        break;
+    case CN_AST_STMT_TEMPLATE_STRUCT_DECL:
+        if (stmt->as.template_struct_decl) {
+            walk_template_params(walk, stmt->as.template_struct_decl->template_params);
+            if (stmt->as.template_struct_decl->struct_decl) {
+                walk_struct_fields(walk, stmt->as.template_struct_decl->struct_decl->fields,
+                                   stmt->as.template_struct_decl->struct_decl->field_count);
+            }
+        }
+        break;
+    }
+}
+
+void cn_frontend_ast_function_shift_lines(CnAstFunctionDecl *function_decl, int line_delta)
+{
+    CnAstWalk walk = {line_delta, 0, 0};
+
+    if (line_delta != 0) {
+        walk_function(&walk, function_decl);
+    }
+}
+
+void cn_frontend_ast_stmt_shift_lines(CnAstStmt *stmt, int line_delta)
+{
+    CnAstWalk walk = {line_delta, 0, 0};
+
+    if (line_delta != 0) {
+        walk_stmt(&walk, stmt);
+    }
+}
+
+void cn_frontend_ast_program_reset_semantics(CnAstProgram *program)
+{
+    CnAstWalk walk = {0, 1, 0};
+    size_t i;
+
+    if (!program) {
+        return;
+    }
+
+    // Arena 程序的作用域登记在程序上，节点上的指针随后清空即可
+    if (program->arena) {
+        for (i = 0; i < program->owned_scope_count; ++i) {
+            cn_sem_scope_free(program->owned_scopes[i]);
+        }
+        program->owned_scope_count = 0;
+    } else {
+        walk.free_scopes = 1;
+    }
+
+    for (i = 0; i < program->function_count; ++i) {
+        walk_function(&walk, program->functions[i]);
+    }
+    for (i = 0; i < program->struct_count; ++i) {
+        walk_stmt(&walk, program->structs[i]);
+    }
+    for (i = 0; i < program->enum_count; ++i) {
+        walk_stmt(&walk, program->enums[i]);
+    }
+    for (i = 0; i < program->import_count; ++i) {
+        walk_stmt(&walk, program->imports[i]);
+    }
+    for (i = 0; i < program->global_var_count; ++i) {
+        walk_stmt(&walk, program->global_vars[i]);
+    }
+    for (i = 0; i < program->class_count; ++i) {
+        walk_stmt(&walk, program->classes[i]);
+    }
+    for (i = 0; i < program->interface_count; ++i) {
+        walk_stmt(&walk, program->interfaces[i]);
+    }
+    for (i = 0; i < program->template_func_count; ++i) {
+        walk_stmt(&walk, program->template_funcs[i]);
+    }
+    for (i = 0; i < program->template_struct_count; ++i) {
+        walk_stmt(&walk, program->template_structs[i]);
+    }
+}
+
 static void cn_frontend_ast_stmt_array_free(CnAstStmt **stmts, size_t count)
 {
     size_t i;
@@ -0,0 +1,2322 @@
+#include "cnlang/frontend/ast_cache.h"
+#include "cnlang/frontend/semantics.h"
+#include "cnlang/support/memory/arena.h"
+#include "cnlang/support/source_manager.h"
+#include "cnlang/support/string_pool.h"
+#include "cnlang/support/version.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#define cache_mkdir(path) _mkdir(path)
+#define cache_getpid() _getpid()
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#define cache_mkdir(path) mkdir(path, 0755)
+#define cache_getpid() getpid()
+#endif
+
+/*
+ * CN Language 二进制 AST 缓存实现
+ *
+ * 映像 = 文件头 + 记录区。每个节点、字符串和子数组都是一条记录，引用为
+ * 记录相对映像起点的 uint32 偏移，0 表示 NULL（文件头占据偏移 0）。
+ * 记录按后序写出：子记录总在父记录之前，读取时要求引用严格小于当前记录的
+ * 偏移，损坏的映像因此不会引发无限递归。被多处引用的节点（例如复合赋值
+ * 展开后共享的左值、共享的类型）只写一次，并在记录首字节标记为共享；
+ * 读取时只有共享记录进入备忘表，重建后仍然共享，其余记录无需查表。
+ *
+ * 数值按本机字节序写入，文件头记录字节序标记，不匹配时视为未命中。
+ */
+
+#define CN_AST_CACHE_MAGIC "CNAST\0\r\n"
+#define CN_AST_CACHE_BYTE_ORDER 0x01020304u
+#define CN_AST_CACHE_EXTENSION ".cnast"
+
+typedef struct CnAstCacheHeader {
+    char magic[8];
+    uint32_t format_version;
+    uint32_t byte_order;
+    uint64_t source_key;
+    uint64_t source_length;
+    char compiler_version[32];
+    uint32_t image_size;
+    uint32_t program_offset;
+    uint32_t string_count;     // 名字记录数（读取时每个名字只驻留一次）
+    uint32_t reserved;
+} CnAstCacheHeader;
+
+// 节点记录首字节的标志位
+#define LOC_HAS_FILENAME 0x01
+#define EXPR_IS_THIS     0x02
+#define EXPR_IS_BASE     0x04
+#define EXPR_HAS_TYPE    0x08
+#define RECORD_SHARED    0x80
+
+// 各类记录按种类只写出用到的引用与取值，未写出的视为 0
+static const uint8_t g_type_ref_counts[CN_TYPE_UNKNOWN + 1] = {
+    [CN_TYPE_POINTER] = 1,
+    [CN_TYPE_ARRAY] = 1,
+    [CN_TYPE_STRUCT] = 3,
+    [CN_TYPE_ENUM] = 1,
+    [CN_TYPE_FUNCTION] = 2,
+};
+
+static const uint8_t g_expr_ref_counts[CN_AST_EXPR_EMBED + 1] = {
+    [CN_AST_EXPR_BINARY] = 2,
+    [CN_AST_EXPR_CALL] = 2,
+    [CN_AST_EXPR_IDENTIFIER] = 1,
+    [CN_AST_EXPR_STRING_LITERAL] = 1,
+    [CN_AST_EXPR_ASSIGN] = 2,
+    [CN_AST_EXPR_LOGICAL] = 2,
+    [CN_AST_EXPR_UNARY] = 1,
+    [CN_AST_EXPR_TERNARY] = 3,
+    [CN_AST_EXPR_ARRAY_LITERAL] = 1,
+    [CN_AST_EXPR_INDEX] = 2,
+    [CN_AST_EXPR_MEMBER_ACCESS] = 3,
+    [CN_AST_EXPR_STRUCT_LITERAL] = 2,
+    [CN_AST_EXPR_MEMORY_READ] = 1,
+    [CN_AST_EXPR_MEMORY_WRITE] = 2,
+    [CN_AST_EXPR_MEMORY_COPY] = 3,
+    [CN_AST_EXPR_MEMORY_SET] = 3,
+    [CN_AST_EXPR_MEMORY_MAP] = 4,
+    [CN_AST_EXPR_MEMORY_UNMAP] = 2,
+    [CN_AST_EXPR_INLINE_ASM] = 4,
+    [CN_AST_EXPR_TEMPLATE_INSTANTIATION] = 2,
+    [CN_AST_EXPR_CAST] = 2,
+    [CN_AST_EXPR_EMBED] = 1,
+};
+
+typedef struct CnStmtLayout {
+    uint8_t ref_count;
+    uint8_t value_count;
+} CnStmtLayout;
+
+static const CnStmtLayout g_stmt_layouts[CN_AST_STMT_TEMPLATE_STRUCT_DECL + 1] = {
+    [CN_AST_STMT_BLOCK] = {1, 0},
+    [CN_AST_STMT_VAR_DECL] = {3, 3},
+    [CN_AST_STMT_EXPR] = {1, 0},
+    [CN_AST_STMT_RETURN] = {1, 0},
+    [CN_AST_STMT_IF] = {3, 0},
+    [CN_AST_STMT_WHILE] = {2, 0},
+    [CN_AST_STMT_FOR] = {4, 0},
+    [CN_AST_STMT_SWITCH] = {2, 0},
+    [CN_AST_STMT_STRUCT_DECL] = {2, 0},
+    [CN_AST_STMT_ENUM_DECL] = {2, 0},
+    [CN_AST_STMT_IMPORT] = {4, 4},
+    [CN_AST_STMT_TRY] = {3, 1},
+    [CN_AST_STMT_THROW] = {3, 0},
+    [CN_AST_STMT_FINALLY] = {1, 1},
+    [CN_AST_STMT_TEMPLATE_FUNCTION_DECL] = {2, 1},
+    [CN_AST_STMT_TEMPLATE_STRUCT_DECL] = {3, 2},
+};
+
+static char *g_cache_directory = NULL;
+
+// =============================================================================
+// 指针/偏移映射（开放寻址，键 0 表示空槽）
+// =============================================================================
+
+typedef struct CnPtrMapSlot {
+    uintptr_t key;
+    uintptr_t value;
+} CnPtrMapSlot;
+
+// 键值放在同一个槽里，一次探测只触及一条缓存行
+typedef struct CnPtrMap {
+    CnPtrMapSlot *slots;
+    size_t capacity;   // 2 的幂
+    size_t count;
+} CnPtrMap;
+
+static size_t ptr_map_slot(uintptr_t key, size_t capacity)
+{
+    uint64_t h = (uint64_t)key * 0x9E3779B97F4A7C15ull;
+    return (size_t)(h >> 32) & (capacity - 1);
+}
+
+static bool ptr_map_put(CnPtrMap *map, uintptr_t key, uintptr_t value);
+
+static bool ptr_map_grow(CnPtrMap *map)
+{
+    CnPtrMap grown;
+
+    grown.capacity = map->capacity == 0 ? 256 : map->capacity * 2;
+    grown.count = 0;
+    grown.slots = (CnPtrMapSlot *)calloc(grown.capacity, sizeof(CnPtrMapSlot));
+    if (!grown.slots) {
+        return false;
+    }
+
+    for (size_t i = 0; i < map->capacity; i++) {
+        if (map->slots[i].key != 0) {
+            ptr_map_put(&grown, map->slots[i].key, map->slots[i].value);
+        }
+    }
+    free(map->slots);
+    *map = grown;
+    return true;
+}
+
+static bool ptr_map_put(CnPtrMap *map, uintptr_t key, uintptr_t value)
+{
+    CnPtrMapSlot *slot;
+    size_t index;
+
+    if ((map->count + 1) * 4 > map->capacity * 3 && !ptr_map_grow(map)) {
+        return false;
+    }
+
+    index = ptr_map_slot(key, map->capacity);
+    while (map->slots[index].key != 0 && map->slots[index].key != key) {
+        index = (index + 1) & (map->capacity - 1);
+    }
+    slot = &map->slots[index];
+    if (slot->key == 0) {
+        slot->key = key;
+        map->count++;
+    }
+    slot->value = value;
+    return true;
+}
+
+static bool ptr_map_get(const CnPtrMap *map, uintptr_t key, uintptr_t *out_value)
+{
+    size_t index;
+
+    if (map->capacity == 0) {
+        return false;
+    }
+    index = ptr_map_slot(key, map->capacity);
+    while (map->slots[index].key != 0) {
+        if (map->slots[index].key == key) {
+            *out_value = map->slots[index].value;
+            return true;
+        }
+        index = (index + 1) & (map->capacity - 1);
+    }
+    return false;
+}
+
+static void ptr_map_free(CnPtrMap *map)
+{
+    free(map->slots);
+    memset(map, 0, sizeof(*map));
+}
+
+// =============================================================================
+// 缓存键
+// =============================================================================
+
+// FNV-1a 64 位哈希，先混入编译器版本与映像格式版本
+uint64_t cn_ast_cache_key(const char *source, size_t length)
+{
+    uint64_t hash = 14695981039346656037ull;
+    const char *version = CN_LANG_VERSION_STRING;
+
+    while (*version) {
+        hash ^= (unsigned char)*version++;
+        hash *= 1099511628211ull;
+    }
+    hash ^= CN_AST_CACHE_FORMAT_VERSION;
+    hash *= 1099511628211ull;
+
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)source[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// =============================================================================
+// 写入
+// =============================================================================
+
+typedef struct CnAstWriter {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+    CnPtrMap written;      // 节点指针 -> 记录偏移
+    CnPtrMap strings;      // 字符串指针 -> 记录偏移
+    uint32_t string_count;
+    bool failed;
+} CnAstWriter;
+
+// 子记录偏移的临时列表
+typedef struct CnRefList {
+    uint32_t *items;
+    size_t count;
+    size_t capacity;
+} CnRefList;
+
+static void ref_list_push(CnAstWriter *w, CnRefList *list, uint32_t ref)
+{
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity == 0 ? 16 : list->capacity * 2;
+        uint32_t *items = (uint32_t *)realloc(list->items, capacity * sizeof(uint32_t));
+        if (!items) {
+            w->failed = true;
+            return;
+        }
+        list->items = items;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = ref;
+}
+
+static void put_bytes(CnAstWriter *w, const void *bytes, size_t length)
+{
+    if (w->failed || length == 0) {
+        return;
+    }
+    if (w->size + length > w->capacity) {
+        size_t capacity = w->capacity == 0 ? 4096 : w->capacity;
+        unsigned char *data;
+        while (capacity < w->size + length) {
+            capacity *= 2;
+        }
+        if (capacity > UINT32_MAX) {
+            w->failed = true;
+            return;
+        }
+        data = (unsigned char *)realloc(w->data, capacity);
+        if (!data) {
+            w->failed = true;
+            return;
+        }
+        w->data = data;
+        w->capacity = capacity;
+    }
+    memcpy(w->data + w->size, bytes, length);
+    w->size += length;
+}
+
+static void put_u8(CnAstWriter *w, uint8_t value) { put_bytes(w, &value, sizeof(value)); }
+static void put_u32(CnAstWriter *w, uint32_t value) { put_bytes(w, &value, sizeof(value)); }
+static void put_i32(CnAstWriter *w, int32_t value) { put_bytes(w, &value, sizeof(value)); }
+static void put_u64(CnAstWriter *w, uint64_t value) { put_bytes(w, &value, sizeof(value)); }
+static void put_i64(CnAstWriter *w, int64_t value) { put_bytes(w, &value, sizeof(value)); }
+static void put_f64(CnAstWriter *w, double value) { put_bytes(w, &value, sizeof(value)); }
+
+// 节点已写出时返回其记录偏移，并把记录标记为共享
+static bool writer_lookup(CnAstWriter *w, const void *node, uint32_t *out_ref)
+{
+    uintptr_t found;
+    if (ptr_map_get(&w->written, (uintptr_t)node, &found)) {
+        w->data[found] |= RECORD_SHARED;
+        *out_ref = (uint32_t)found;
+        return true;
+    }
+    return false;
+}
+
+static void writer_remember(CnAstWriter *w, const void *node, uint32_t ref)
+{
+    if (!w->failed && !ptr_map_put(&w->written, (uintptr_t)node, ref)) {
+        w->failed = true;
+    }
+}
+
+// 字符串记录：长度 + 序号 + 字节 + '\0'；同一指针且长度相同的字符串只写一次
+static uint32_t write_string(CnAstWriter *w, const char *text, size_t length)
+{
+    uint32_t ref;
+
+    if (!text || length > UINT32_MAX) {
+        return 0;
+    }
+    {
+        uintptr_t found;
+        if (ptr_map_get(&w->strings, (uintptr_t)text, &found)) {
+            uint32_t stored;
+            memcpy(&stored, w->data + found, sizeof(stored));
+            if (stored == length) {
+                return (uint32_t)found;
+            }
+        }
+    }
+
+    ref = (uint32_t)w->size;
+    put_u32(w, (uint32_t)length);
+    put_u32(w, w->string_count++);
+    put_bytes(w, text, length);
+    put_u8(w, 0);
+    if (!w->failed && !ptr_map_put(&w->strings, (uintptr_t)text, ref)) {
+        w->failed = true;
+    }
+    return ref;
+}
+
+static uint32_t write_refs(CnAstWriter *w, const CnRefList *list)
+{
+    uint32_t ref = (uint32_t)w->size;
+    put_u32(w, (uint32_t)list->count);
+    put_bytes(w, list->items, list->count * sizeof(uint32_t));
+    return ref;
+}
+
+static uint32_t write_type(CnAstWriter *w, const CnType *type);
+static uint32_t write_expr(CnAstWriter *w, const CnAstExpr *expr);
+static uint32_t write_stmt(CnAstWriter *w, const CnAstStmt *stmt);
+static uint32_t write_block(CnAstWriter *w, const CnAstBlockStmt *block);
+static uint32_t write_function(CnAstWriter *w, const CnAstFunctionDecl *function_decl);
+
+static uint32_t write_type(CnAstWriter *w, const CnType *type)
+{
+    uint32_t ref;
+    uint32_t refs[3] = {0, 0, 0};
+    CnRefList list = {0};
+
+    if (!type || w->failed) {
+        return 0;
+    }
+    if (writer_lookup(w, type, &ref)) {
+        return ref;
+    }
+
+    switch (type->kind) {
+    case CN_TYPE_POINTER:
+        refs[0] = write_type(w, type->as.pointer_to);
+        break;
+    case CN_TYPE_ARRAY:
+        refs[0] = write_type(w, type->as.array.element_type);
+        break;
+    case CN_TYPE_STRUCT:
+        if (type->as.struct_type.decl_scope) {
+            w->failed = true;  // 作用域不可序列化
+            return 0;
+        }
+        for (size_t i = 0; i < type->as.struct_type.field_count; i++) {
+            const CnStructField *field = &type->as.struct_type.fields[i];
+            ref_list_push(w, &list, write_string(w, field->name, field->name_length));
+            ref_list_push(w, &list, write_type(w, field->field_type));
+            ref_list_push(w, &list, (uint32_t)field->is_const);
+        }
+        refs[0] = write_string(w, type->as.struct_type.name, type->as.struct_type.name_length);
+        refs[1] = write_string(w, type->as.struct_type.owner_func_name,
+                               type->as.struct_type.owner_func_name_length);
+        refs[2] = write_refs(w, &list);
+        break;
+    case CN_TYPE_ENUM:
+        if (type->as.enum_type.enum_scope) {
+            w->failed = true;
+            return 0;
+        }
+        refs[0] = write_string(w, type->as.enum_type.name, type->as.enum_type.name_length);
+        break;
+    case CN_TYPE_FUNCTION:
+        for (size_t i = 0; i < type->as.function.param_count; i++) {
+            ref_list_push(w, &list, write_type(w, type->as.function.param_types[i]));
+        }
+        refs[0] = write_type(w, type->as.function.return_type);
+        refs[1] = write_refs(w, &list);
+        break;
+    case CN_TYPE_CLASS:
+    case CN_TYPE_INTERFACE:
+    case CN_TYPE_PARAM:
+        w->failed = true;  // 解析器不产生这些类型，出现时不缓存
+        return 0;
+    default:
+        break;
+    }
+    free(list.items);
+
+    if ((unsigned)type->kind > CN_TYPE_UNKNOWN) {
+        w->failed = true;
+        return 0;
+    }
+
+    ref = (uint32_t)w->size;
+    put_u8(w, 0);
+    put_u8(w, (uint8_t)type->kind);
+    put_bytes(w, refs, g_type_ref_counts[type->kind] * sizeof(uint32_t));
+    if (type->kind == CN_TYPE_ARRAY) {
+        put_u64(w, (uint64_t)type->as.array.length);
+    }
+    writer_remember(w, type, ref);
+    return ref;
+}
+
+static uint32_t write_expr_list(CnAstWriter *w, CnAstExpr *const *exprs, size_t count)
+{
+    CnRefList list = {0};
+    uint32_t ref;
+
+    for (size_t i = 0; i < count; i++) {
+        ref_list_push(w, &list, write_expr(w, exprs[i]));
+    }
+    ref = write_refs(w, &list);
+    free(list.items);
+    return ref;
+}
+
+static uint8_t loc_flags(const CnSourceLocation *loc)
+{
+    return loc->filename ? LOC_HAS_FILENAME : 0;
+}
+
+// 二元/逻辑运算的左操作数是尚未写出的同种类运算（只查询，不标记共享）
+static bool writer_chain_pending(CnAstWriter *w, const CnAstExpr *expr)
+{
+    const CnAstExpr *left;
+    uintptr_t found;
+
+    if (expr->kind == CN_AST_EXPR_BINARY) {
+        left = expr->as.binary.left;
+    } else if (expr->kind == CN_AST_EXPR_LOGICAL) {
+        left = expr->as.logical.left;
+    } else {
+        return false;
+    }
+    return left && left->kind == expr->kind && !ptr_map_get(&w->written, (uintptr_t)left, &found);
+}
+
+static uint32_t write_expr(CnAstWriter *w, const CnAstExpr *expr)
+{
+    uint32_t ref;
+    uint32_t refs[4] = {0, 0, 0, 0};
+    uint32_t type_ref;
+    uint8_t flags;
+    CnRefList list = {0};
+
+    if (!expr || w->failed) {
+        return 0;
+    }
+    if (writer_lookup(w, expr, &ref)) {
+        return ref;
+    }
+    // 左结合长链（a + b + ...）：先自底向上写出链上各节点，之后每层的左操作数都已写出，
+    // 记录顺序与逐层递归相同，递归深度与链长无关（这些节点因此标记为共享）
+    if (writer_chain_pending(w, expr)) {
+        CnAstExprChain chain;
+        if (!cn_frontend_ast_expr_chain_collect(&chain, (CnAstExpr *)expr)) {
+            w->failed = true;
+            return 0;
+        }
+        for (size_t i = chain.count; i-- > 1;) {
+            write_expr(w, chain.nodes[i]);
+        }
+        cn_frontend_ast_expr_chain_free(&chain);
+    }
+
+    switch (expr->kind) {
+    case CN_AST_EXPR_BINARY:
+        refs[0] = write_expr(w, expr->as.binary.left);
+        refs[1] = write_expr(w, expr->as.binary.right);
+        break;
+    case CN_AST_EXPR_CALL:
+        refs[0] = write_expr(w, expr->as.call.callee);
+        refs[1] = write_expr_list(w, expr->as.call.arguments, expr->as.call.argument_count);
+        break;
+    case CN_AST_EXPR_IDENTIFIER:
+        refs[0] = write_string(w, expr->as.identifier.name, expr->as.identifier.name_length);
+        break;
+    case CN_AST_EXPR_STRING_LITERAL:
+        refs[0] = write_string(w, expr->as.string_literal.value, expr->as.string_literal.length);
+        break;
+    case CN_AST_EXPR_ASSIGN:
+        refs[0] = write_expr(w, expr->as.assign.target);
+        refs[1] = write_expr(w, expr->as.assign.value);
+        break;
+    case CN_AST_EXPR_LOGICAL:
+        refs[0] = write_expr(w, expr->as.logical.left);
+        refs[1] = write_expr(w, expr->as.logical.right);
+        break;
+    case CN_AST_EXPR_UNARY:
+        refs[0] = write_expr(w, expr->as.unary.operand);
+        break;
+    case CN_AST_EXPR_TERNARY:
+        refs[0] = write_expr(w, expr->as.ternary.condition);
+        refs[1] = write_expr(w, expr->as.ternary.true_expr);
+        refs[2] = write_expr(w, expr->as.ternary.false_expr);
+        break;
+    case CN_AST_EXPR_ARRAY_LITERAL:
+        refs[0] = write_expr_list(w, expr->as.array_literal.elements,
+                                  expr->as.array_literal.element_count);
+        break;
+    case CN_AST_EXPR_INDEX:
+        refs[0] = write_expr(w, expr->as.index.array);
+        refs[1] = write_expr(w, expr->as.index.index);
+        break;
+    case CN_AST_EXPR_MEMBER_ACCESS:
+        refs[0] = write_expr(w, expr->as.member.object);
+        refs[1] = write_string(w, expr->as.member.member_name, expr->as.member.member_name_length);
+        refs[2] = write_string(w, expr->as.member.class_name, expr->as.member.class_name_length);
+        break;
+    case CN_AST_EXPR_STRUCT_LITERAL:
+        for (size_t i = 0; i < expr->as.struct_lit.field_count; i++) {
+            const CnAstStructFieldInit *field = &expr->as.struct_lit.fields[i];
+            ref_list_push(w, &list, write_string(w, field->field_name, field->field_name_length));
+            ref_list_push(w, &list, write_expr(w, field->value));
+        }
+        refs[0] = write_string(w, expr->as.struct_lit.struct_name, expr->as.struct_lit.struct_name_length);
+        refs[1] = write_refs(w, &list);
+        break;
+    case CN_AST_EXPR_MEMORY_READ:
+        refs[0] = write_expr(w, expr->as.memory_read.address);
+        break;
+    case CN_AST_EXPR_MEMORY_WRITE:
+        refs[0] = write_expr(w, expr->as.memory_write.address);
+        refs[1] = write_expr(w, expr->as.memory_write.value);
+        break;
+    case CN_AST_EXPR_MEMORY_COPY:
+        refs[0] = write_expr(w, expr->as.memory_copy.dest);
+        refs[1] = write_expr(w, expr->as.memory_copy.src);
+        refs[2] = write_expr(w, expr->as.memory_copy.size);
+        break;
+    case CN_AST_EXPR_MEMORY_SET:
+        refs[0] = write_expr(w, expr->as.memory_set.address);
+        refs[1] = write_expr(w, expr->as.memory_set.value);
+        refs[2] = write_expr(w, expr->as.memory_set.size);
+        break;
+    case CN_AST_EXPR_MEMORY_MAP:
+        refs[0] = write_expr(w, expr->as.memory_map.address);
+        refs[1] = write_expr(w, expr->as.memory_map.size);
+        refs[2] = write_expr(w, expr->as.memory_map.prot);
+        refs[3] = write_expr(w, expr->as.memory_map.flags);
+        break;
+    case CN_AST_EXPR_MEMORY_UNMAP:
+        refs[0] = write_expr(w, expr->as.memory_unmap.address);
+        refs[1] = write_expr(w, expr->as.memory_unmap.size);
+        break;
+    case CN_AST_EXPR_INLINE_ASM:
+        refs[0] = write_expr(w, expr->as.inline_asm.asm_code);
+        refs[1] = write_expr_list(w, expr->as.inline_asm.outputs, expr->as.inline_asm.output_count);
+        refs[2] = write_expr_list(w, expr->as.inline_asm.inputs, expr->as.inline_asm.input_count);
+        refs[3] = write_expr(w, expr->as.inline_asm.clobbers);
+        break;
+    case CN_AST_EXPR_TEMPLATE_INSTANTIATION:
+        for (size_t i = 0; i < expr->as.template_inst.type_arg_count; i++) {
+            ref_list_push(w, &list, write_type(w, expr->as.template_inst.type_args[i]));
+        }
+        refs[0] = write_string(w, expr->as.template_inst.template_name,
+                               expr->as.template_inst.template_name_length);
+        refs[1] = write_refs(w, &list);
+        break;
+    case CN_AST_EXPR_CAST:
+        refs[0] = write_type(w, expr->as.cast.target_type);
+        refs[1] = write_expr(w, expr->as.cast.operand);
+        break;
+    case CN_AST_EXPR_EMBED:
+        // 只写出路径，文件内容由语义分析重新读入
+        refs[0] = write_string(w, expr->as.embed.path, expr->as.embed.path_length);
+        break;
+    default:
+        break;
+    }
+    free(list.items);
+    type_ref = write_type(w, expr->type);
+
+    if ((unsigned)expr->kind > CN_AST_EXPR_EMBED) {
+        w->failed = true;
+        return 0;
+    }
+
+    flags = loc_flags(&expr->loc);
+    if (type_ref) {
+        flags |= EXPR_HAS_TYPE;
+    }
+    if (expr->is_this_pointer) {
+        flags |= EXPR_IS_THIS;
+    }
+    if (expr->is_base_pointer) {
+        flags |= EXPR_IS_BASE;
+    }
+
+    ref = (uint32_t)w->size;
+    put_u8(w, flags);
+    put_u8(w, (uint8_t)expr->kind);
+    put_i32(w, expr->loc.line);
+    put_i32(w, expr->loc.column);
+    if (type_ref) {
+        put_u32(w, type_ref);
+    }
+
+    switch (expr->kind) {
+    case CN_AST_EXPR_BINARY:
+        put_u8(w, (uint8_t)expr->as.binary.op);
+        break;
+    case CN_AST_EXPR_LOGICAL:
+        put_u8(w, (uint8_t)expr->as.logical.op);
+        break;
+    case CN_AST_EXPR_UNARY:
+        put_u8(w, (uint8_t)expr->as.unary.op);
+        break;
+    case CN_AST_EXPR_INTEGER_LITERAL:
+        put_i64(w, (int64_t)expr->as.integer_literal.value);
+        break;
+    case CN_AST_EXPR_FLOAT_LITERAL:
+        put_f64(w, expr->as.float_literal.value);
+        break;
+    case CN_AST_EXPR_CHAR_LITERAL:
+        put_u8(w, (uint8_t)expr->as.char_literal.value);
+        break;
+    case CN_AST_EXPR_BOOL_LITERAL:
+        put_i32(w, expr->as.bool_literal.value);
+        break;
+    case CN_AST_EXPR_MEMBER_ACCESS:
+        put_u8(w, (uint8_t)expr->as.member.is_arrow);
+        put_u8(w, (uint8_t)expr->as.member.is_static_member);
+        break;
+    default:
+        break;
+    }
+    put_bytes(w, refs, g_expr_ref_counts[expr->kind] * sizeof(uint32_t));
+
+    writer_remember(w, expr, ref);
+    return ref;
+}
+
+static uint32_t write_block(CnAstWriter *w, const CnAstBlockStmt *block)
+{
+    CnRefList list = {0};
+    uint32_t ref;
+
+    if (!block || w->failed) {
+        return 0;
+    }
+    if (writer_lookup(w, block, &ref)) {
+        return ref;
+    }
+
+    for (size_t i = 0; i < block->stmt_count; i++) {
+        ref_list_push(w, &list, write_stmt(w, block->stmts[i]));
+    }
+    ref = (uint32_t)w->size;
+    put_u8(w, 0);
+    write_refs(w, &list);
+    free(list.items);
+    writer_remember(w, block, ref);
+    return ref;
+}
+
+static uint32_t write_template_params(CnAstWriter *w, const CnAstTemplateParams *params)
+{
+    CnRefList list = {0};
+    uint32_t ref;
+
+    if (!params) {
+        return 0;
+    }
+    for (size_t i = 0; i < params->param_count; i++) {
+        const CnAstTemplateParam *param = &params->params[i];
+        ref_list_push(w, &list, write_string(w, param->name, param->name_length));
+        ref_list_push(w, &list, write_type(w, param->constraint));
+        ref_list_push(w, &list, write_type(w, param->default_type));
+    }
+    ref = write_refs(w, &list);
+    free(list.items);
+    return ref;
+}
+
+static uint32_t write_struct_fields(CnAstWriter *w, const CnAstStructField *fields, size_t count)
+{
+    CnRefList list = {0};
+    uint32_t ref;
+
+    for (size_t i = 0; i < count; i++) {
+        ref_list_push(w, &list, write_string(w, fields[i].name, fields[i].name_length));
+        ref_list_push(w, &list, write_type(w, fields[i].field_type));
+        ref_list_push(w, &list, (uint32_t)fields[i].is_const);
+    }
+    ref = write_refs(w, &list);
+    free(list.items);
+    return ref;
+}
+
+static uint32_t write_module_path(CnAstWriter *w, const CnAstModulePath *path)
+{
+    CnRefList list = {0};
+    uint32_t ref;
+
+    if (!path) {
+        return 0;
+    }
+    ref_list_push(w, &list, (uint32_t)path->is_relative);
+    ref_list_push(w, &list, (uint32_t)path->relative_level);
+    for (size_t i = 0; i < path->segment_count; i++) {
+        ref_list_push(w, &list, write_string(w, path->segments[i].name, path->segments[i].name_length));
+    }
+    ref = write_refs(w, &list);
+    free(list.items);
+    return ref;
+}
+
+// "否则 如果" 链：从最内层起依次写出各段如果语句，之后每段的否则块都只引用已写出的语句
+static void write_else_if_chain(CnAstWriter *w, const CnAstIfStmt *if_stmt)
+{
+    const CnAstStmt **chain = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    const CnAstStmt *else_if = cn_frontend_ast_else_if(if_stmt);
+    uintptr_t found;
+
+    while (else_if && !ptr_map_get(&w->written, (uintptr_t)else_if, &found)) {
+        if (count == capacity) {
+            size_t new_capacity = capacity ? capacity * 2 : 16;
+            const CnAstStmt **items = (const CnAstStmt **)realloc(chain, new_capacity * sizeof(*chain));
+            if (!items) {
+                w->failed = true;
+                break;
+            }
+            chain = items;
+            capacity = new_capacity;
+        }
+        chain[count++] = else_if;
+        else_if = cn_frontend_ast_else_if(&else_if->as.if_stmt);
+    }
+    while (count > 0 && !w->failed) {
+        write_stmt(w, chain[--count]);
+    }
+    free(chain);
+}
+
+static uint32_t write_stmt(CnAstWriter *w, const CnAstStmt *stmt)
+{
+    uint32_t ref;
+    uint32_t refs[4] = {0, 0, 0, 0};
+    uint8_t values[4] = {0, 0, 0, 0};
+    CnRefList list = {0};
+
+    if (!stmt || w->failed) {
+        return 0;
+    }
+    if (writer_lookup(w, stmt, &ref)) {
+        return ref;
+    }
+
+    switch (stmt->kind) {
+    case CN_AST_STMT_BLOCK:
+        refs[0] = write_block(w, stmt->as.block);
+        break;
+    case CN_AST_STMT_VAR_DECL:
+        refs[0] = write_string(w, stmt->as.var_decl.name, stmt->as.var_decl.name_length);
+        refs[1] = write_type(w, stmt->as.var_decl.declared_type);
+        refs[2] = write_expr(w, stmt->as.var_decl.initializer);
+        values[0] = (uint8_t)stmt->as.var_decl.visibility;
+        values[1] = (uint8_t)stmt->as.var_decl.is_const;
+        values[2] = (uint8_t)stmt->as.var_decl.is_static;
+        break;
+    case CN_AST_STMT_EXPR:
+        refs[0] = write_expr(w, stmt->as.expr.expr);
+        break;
+    case CN_AST_STMT_RETURN:
+        refs[0] = write_expr(w, stmt->as.return_stmt.expr);
+        break;
+    case CN_AST_STMT_IF:
+        write_else_if_chain(w, &stmt->as.if_stmt);
+        refs[0] = write_expr(w, stmt->as.if_stmt.condition);
+        refs[1] = write_block(w, stmt->as.if_stmt.then_block);
+        refs[2] = write_block(w, stmt->as.if_stmt.else_block);
+        break;
+    case CN_AST_STMT_WHILE:
+        refs[0] = write_expr(w, stmt->as.while_stmt.condition);
+        refs[1] = write_block(w, stmt->as.while_stmt.body);
+        break;
+    case CN_AST_STMT_FOR:
+        refs[0] = write_stmt(w, stmt->as.for_stmt.init);
+        refs[1] = write_expr(w, stmt->as.for_stmt.condition);
+        refs[2] = write_expr(w, stmt->as.for_stmt.update);
+        refs[3] = write_block(w, stmt->as.for_stmt.body);
+        break;
+    case CN_AST_STMT_SWITCH:
+        for (size_t i = 0; i < stmt->as.switch_stmt.case_count; i++) {
+            ref_list_push(w, &list, write_expr(w, stmt->as.switch_stmt.cases[i].value));
+            ref_list_push(w, &list, write_block(w, stmt->as.switch_stmt.cases[i].body));
+        }
+        refs[0] = write_expr(w, stmt->as.switch_stmt.expr);
+        refs[1] = write_refs(w, &list);
+        break;
+    case CN_AST_STMT_STRUCT_DECL:
+        refs[0] = write_string(w, stmt->as.struct_decl.name, stmt->as.struct_decl.name_length);
+        refs[1] = write_struct_fields(w, stmt->as.struct_decl.fields, stmt->as.struct_decl.field_count);
+        break;
+    case CN_AST_STMT_ENUM_DECL:
+        for (size_t i = 0; i < stmt->as.enum_decl.member_count; i++) {
+            const CnAstEnumMember *member = &stmt->as.enum_decl.members[i];
+            int64_t value = (int64_t)member->value;
+            ref_list_push(w, &list, write_string(w, member->name, member->name_length));
+            ref_list_push(w, &list, (uint32_t)member->has_value);
+            ref_list_push(w, &list, (uint32_t)((uint64_t)value & 0xFFFFFFFFu));
+            ref_list_push(w, &list, (uint32_t)((uint64_t)value >> 32));
+        }
+        refs[0] = write_string(w, stmt->as.enum_decl.name, stmt->as.enum_decl.name_length);
+        refs[1] = write_refs(w, &list);
+        break;
+    case CN_AST_STMT_IMPORT: {
+        const CnAstImportStmt *import = &stmt->as.import_stmt;
+        for (size_t i = 0; i < import->member_count; i++) {
+            ref_list_push(w, &list, write_string(w, import->members[i].name, import->members[i].name_length));
+            ref_list_push(w, &list, write_string(w, import->members[i].alias, import->members[i].alias_length));
+        }
+        refs[0] = write_string(w, import->module_name, import->module_name_length);
+        refs[1] = write_string(w, import->alias, import->alias_length);
+        refs[2] = import->members ? write_refs(w, &list) : 0;
+        refs[3] = write_module_path(w, import->module_path);
+        values[0] = (uint8_t)import->kind;
+        values[1] = (uint8_t)import->is_wildcard;
+        values[2] = (uint8_t)import->use_from_syntax;
+        values[3] = (uint8_t)import->target_type;
+        break;
+    }
+    case CN_AST_STMT_TRY: {
+        const CnAstTryStmt *try_stmt = stmt->as.try_stmt;
+        if (!try_stmt) {
+            break;
+        }
+        for (size_t i = 0; i < try_stmt->catch_count; i++) {
+            const CnAstCatchClause *clause = &try_stmt->catches[i];
+            ref_list_push(w, &list, write_string(w, clause->exception_type, clause->exception_type_length));
+            ref_list_push(w, &list, write_string(w, clause->var_name, clause->var_name_length));
+            ref_list_push(w, &list, write_block(w, clause->body));
+        }
+        refs[0] = write_block(w, try_stmt->try_block);
+        refs[1] = write_refs(w, &list);
+        refs[2] = write_block(w, try_stmt->finally_block);
+        values[0] = 1;
+        break;
+    }
+    case CN_AST_STMT_THROW:
+        refs[0] = write_expr(w, stmt->as.throw_stmt.exception_expr);
+        refs[1] = write_string(w, stmt->as.throw_stmt.exception_type, stmt->as.throw_stmt.exception_type_length);
+        refs[2] = write_string(w, stmt->as.throw_stmt.message, stmt->as.throw_stmt.message_length);
+        break;
+    case CN_AST_STMT_FINALLY:
+        if (stmt->as.finally_stmt) {
+            refs[0] = write_block(w, stmt->as.finally_stmt->body);
+            values[0] = 1;
+        }
+        break;
+    case CN_AST_STMT_TEMPLATE_FUNCTION_DECL:
+        if (stmt->as.template_func_decl) {
+            refs[0] = write_template_params(w, stmt->as.template_func_decl->template_params);
+            refs[1] = write_function(w, stmt->as.template_func_decl->function);
+            values[0] = 1;
+        }
+        break;
+    case CN_AST_STMT_TEMPLATE_STRUCT_DECL:
+        if (stmt->as.template_struct_decl) {
+            const CnAstStructDecl *decl = stmt->as.template_struct_decl->struct_decl;
+            refs[0] = write_template_params(w, stmt->as.template_struct_decl->template_params);
+            if (decl) {
+                refs[1] = write_string(w, decl->name, decl->name_length);
+                refs[2] = write_struct_fields(w, decl->fields, decl->field_count);
+                values[1] = 1;
+            }
+            values[0] = 1;
+        }
+        break;
+    case CN_AST_STMT_CLASS_DECL:
+    case CN_AST_STMT_INTERFACE_DECL:
+        w->failed = true;  // 类与接口的成员结构不做缓存
+        return 0;
+    default:
+        break;
+    }
+    free(list.items);
+    if ((unsigned)stmt->kind > CN_AST_STMT_TEMPLATE_STRUCT_DECL) {
+        w->failed = true;
+        return 0;
+    }
+
+    ref = (uint32_t)w->size;
+    put_u8(w, loc_flags(&stmt->loc));
+    put_u8(w, (uint8_t)stmt->kind);
+    put_i32(w, stmt->loc.line);
+    put_i32(w, stmt->loc.column);
+    put_bytes(w, refs, g_stmt_layouts[stmt->kind].ref_count * sizeof(uint32_t));
+    put_bytes(w, values, g_stmt_layouts[stmt->kind].value_count);
+
+    writer_remember(w, stmt, ref);
+    return ref;
+}
+
+static uint32_t write_function(CnAstWriter *w, const CnAstFunctionDecl *function_decl)
+{
+    CnRefList list = {0};
+    uint32_t ref;
+    uint32_t name_ref;
+    uint32_t params_ref;
+    uint32_t return_ref;
+    uint32_t body_ref;
+
+    if (!function_decl || w->failed) {
+        return 0;
+    }
+    if (writer_lookup(w, function_decl, &ref)) {
+        return ref;
+    }
+    if (function_decl->lazy_body) {
+        w->failed = true;  // 跳读得到的函数体尚未解析，映像必须包含完整的树
+        return 0;
+    }
+
+    for (size_t i = 0; i < function_decl->parameter_count; i++) {
+        const CnAstParameter *param = &function_decl->parameters[i];
+        ref_list_push(w, &list, write_string(w, param->name, param->name_length));
+        ref_list_push(w, &list, write_type(w, param->declared_type));
+        ref_list_push(w, &list, (uint32_t)param->is_const);
+    }
+    name_ref = write_string(w, function_decl->name, function_decl->name_length);
+    params_ref = function_decl->parameters ? write_refs(w, &list) : 0;
+    free(list.items);
+    return_ref = write_type(w, function_decl->return_type);
+    body_ref = write_block(w, function_decl->body);
+
+    ref = (uint32_t)w->size;
+    put_u8(w, 0);
+    put_u32(w, name_ref);
+    put_u32(w, params_ref);
+    put_u32(w, return_ref);
+    put_u32(w, body_ref);
+    put_u8(w, (uint8_t)function_decl->visibility);
+    put_u8(w, (uint8_t)function_decl->is_interrupt_handler);
+    put_u32(w, function_decl->interrupt_vector);
+    put_u8(w, (uint8_t)function_decl->is_prototype);
+    put_u8(w, (uint8_t)function_decl->is_override);
+    put_u8(w, (uint8_t)function_decl->is_static);
+
+    writer_remember(w, function_decl, ref);
+    return ref;
+}
+
+static uint32_t write_stmt_list(CnAstWriter *w, CnAstStmt *const *stmts, size_t count)
+{
+    CnRefList list = {0};
+    uint32_t ref;
+
+    for (size_t i = 0; i < count; i++) {
+        ref_list_push(w, &list, write_stmt(w, stmts[i]));
+    }
+    ref = write_refs(w, &list);
+    free(list.items);
+    return ref;
+}
+
+void *cn_ast_cache_serialize(const CnAstProgram *program, uint64_t source_key,
+                             size_t source_length, size_t *out_size)
+{
+    CnAstWriter writer;
+    CnAstCacheHeader header;
+    CnRefList functions = {0};
+    uint32_t lists[7];
+
+    if (!program || !out_size || program->class_count > 0 || program->interface_count > 0) {
+        return NULL;
+    }
+
+    memset(&writer, 0, sizeof(writer));
+    memset(&header, 0, sizeof(header));
+    put_bytes(&writer, &header, sizeof(header));  // 占位，最后回填
+
+    for (size_t i = 0; i < program->function_count; i++) {
+        ref_list_push(&writer, &functions, write_function(&writer, program->functions[i]));
+    }
+    lists[0] = write_refs(&writer, &functions);
+    free(functions.items);
+    lists[1] = write_stmt_list(&writer, program->structs, program->struct_count);
+    lists[2] = write_stmt_list(&writer, program->enums, program->enum_count);
+    lists[3] = write_stmt_list(&writer, program->imports, program->import_count);
+    lists[4] = write_stmt_list(&writer, program->global_vars, program->global_var_count);
+    lists[5] = write_stmt_list(&writer, program->template_funcs, program->template_func_count);
+    lists[6] = write_stmt_list(&writer, program->template_structs, program->template_struct_count);
+
+    header.program_offset = (uint32_t)writer.size;
+    header.string_count = writer.string_count;
+    put_bytes(&writer, lists, sizeof(lists));
+    ptr_map_free(&writer.written);
+    ptr_map_free(&writer.strings);
+
+    if (writer.failed) {
+        free(writer.data);
+        return NULL;
+    }
+
+    memcpy(header.magic, CN_AST_CACHE_MAGIC, sizeof(header.magic));
+    header.format_version = CN_AST_CACHE_FORMAT_VERSION;
+    header.byte_order = CN_AST_CACHE_BYTE_ORDER;
+    header.source_key = source_key;
+    header.source_length = (uint64_t)source_length;
+    snprintf(header.compiler_version, sizeof(header.compiler_version), "%s", CN_LANG_VERSION_STRING);
+    header.image_size = (uint32_t)writer.size;
+    memcpy(writer.data, &header, sizeof(header));
+
+    *out_size = writer.size;
+    return writer.data;
+}
+
+// =============================================================================
+// 读取
+// =============================================================================
+
+typedef struct CnAstReader {
+    const unsigned char *data;
+    size_t size;
+    CnArena *arena;
+    CnPtrMap loaded;       // (记录偏移, 记录类别) -> 重建的对象
+    const char **names;    // 字符串序号 -> 已驻留的名字（每个不同名字只查一次字符串池）
+    uint32_t string_count;
+    const char *filename;
+    bool failed;
+} CnAstReader;
+
+static bool get_bytes(CnAstReader *r, size_t *pos, void *out, size_t length)
+{
+    if (r->failed || *pos > r->size || length > r->size - *pos) {
+        r->failed = true;
+        memset(out, 0, length);
+        return false;
+    }
+    memcpy(out, r->data + *pos, length);
+    *pos += length;
+    return true;
+}
+
+static uint8_t get_u8(CnAstReader *r, size_t *pos) { uint8_t v; get_bytes(r, pos, &v, sizeof(v)); return v; }
+static uint32_t get_u32(CnAstReader *r, size_t *pos) { uint32_t v; get_bytes(r, pos, &v, sizeof(v)); return v; }
+static int32_t get_i32(CnAstReader *r, size_t *pos) { int32_t v; get_bytes(r, pos, &v, sizeof(v)); return v; }
+static uint64_t get_u64(CnAstReader *r, size_t *pos) { uint64_t v; get_bytes(r, pos, &v, sizeof(v)); return v; }
+static int64_t get_i64(CnAstReader *r, size_t *pos) { int64_t v; get_bytes(r, pos, &v, sizeof(v)); return v; }
+static double get_f64(CnAstReader *r, size_t *pos) { double v; get_bytes(r, pos, &v, sizeof(v)); return v; }
+
+// 校验引用：只能指向当前记录之前的记录
+static bool ref_valid(CnAstReader *r, uint32_t ref, uint32_t owner)
+{
+    if (ref == 0) {
+        return true;
+    }
+    if (ref < sizeof(CnAstCacheHeader) || ref >= owner) {
+        r->failed = true;
+        return false;
+    }
+    return true;
+}
+
+static void *reader_alloc(CnAstReader *r, size_t size)
+{
+    void *memory;
+
+    if (size == 0) {
+        return NULL;
+    }
+    memory = cn_arena_alloc(r->arena, size);
+    if (!memory) {
+        r->failed = true;
+        return NULL;
+    }
+    memset(memory, 0, size);
+    return memory;
+}
+
+// 记录类别参与备忘键：损坏映像中同一偏移被当作不同类别引用时不会返回错误类型的对象
+typedef enum CnRecordClass {
+    RECORD_TYPE = 1,
+    RECORD_EXPR,
+    RECORD_STMT,
+    RECORD_BLOCK,
+    RECORD_FUNCTION
+} CnRecordClass;
+
+static uintptr_t record_key(uint32_t ref, CnRecordClass record_class)
+{
+    return ((uintptr_t)ref << 3) | (uintptr_t)record_class;
+}
+
+// 只有标记为共享的记录才查询/登记备忘表（调用前 ref 已通过校验）
+static bool record_shared(const CnAstReader *r, uint32_t ref)
+{
+    return (r->data[ref] & RECORD_SHARED) != 0;
+}
+
+static bool reader_lookup(CnAstReader *r, uint32_t ref, CnRecordClass record_class, void **out)
+{
+    uintptr_t found;
+    if (record_shared(r, ref) && ptr_map_get(&r->loaded, record_key(ref, record_class), &found)) {
+        *out = (void *)found;
+        return true;
+    }
+    return false;
+}
+
+static void reader_remember(CnAstReader *r, uint32_t ref, CnRecordClass record_class, const void *object)
+{
+    if (!r->failed && object && record_shared(r, ref) &&
+        !ptr_map_put(&r->loaded, record_key(ref, record_class), (uintptr_t)object)) {
+        r->failed = true;
+    }
+}
+
+// 名字驻留到全局字符串池（与解析器一致，可按指针比较）；字面量文本复制到 Arena
+static const char *read_string(CnAstReader *r, uint32_t ref, uint32_t owner, size_t *out_length, bool intern)
+{
+    size_t pos = ref;
+    uint32_t length;
+    uint32_t index;
+
+    *out_length = 0;
+    if (ref == 0 || !ref_valid(r, ref, owner)) {
+        return NULL;
+    }
+    length = get_u32(r, &pos);
+    index = get_u32(r, &pos);
+    if (r->failed || length > r->size - pos || pos + length >= owner || index >= r->string_count) {
+        r->failed = true;
+        return NULL;
+    }
+
+    *out_length = length;
+    if (intern) {
+        const char *interned = r->names[index];
+        if (interned) {
+            // 同一序号只会对应同一条字符串记录，长度不符说明映像损坏
+            if (strlen(interned) != length) {
+                r->failed = true;
+                return NULL;
+            }
+            return interned;
+        }
+        interned = cn_string_pool_intern(cn_string_pool_default(),
+                                         (const char *)r->data + pos, length);
+        if (!interned) {
+            r->failed = true;
+        }
+        r->names[index] = interned;
+        return interned;
+    }
+
+    {
+        char *copy = cn_arena_strndup(r->arena, (const char *)r->data + pos, length);
+        if (!copy) {
+            r->failed = true;
+        }
+        return copy;
+    }
+}
+
+// 读取引用列表，返回指向映像内引用数组的位置（数量写入 out_count）
+static size_t read_refs(CnAstReader *r, uint32_t ref, uint32_t owner, size_t *out_count)
+{
+    size_t pos = ref;
+    uint32_t count;
+
+    *out_count = 0;
+    if (ref == 0 || !ref_valid(r, ref, owner)) {
+        return 0;
+    }
+    count = get_u32(r, &pos);
+    if (r->failed || count > (r->size - pos) / sizeof(uint32_t)) {
+        r->failed = true;
+        return 0;
+    }
+    *out_count = count;
+    return pos;
+}
+
+static uint32_t ref_at(CnAstReader *r, size_t list_pos, size_t index)
+{
+    size_t pos = list_pos + index * sizeof(uint32_t);
+    return get_u32(r, &pos);
+}
+
+static CnType *read_type(CnAstReader *r, uint32_t ref, uint32_t owner);
+static CnAstExpr *read_expr(CnAstReader *r, uint32_t ref, uint32_t owner);
+static CnAstStmt *read_stmt(CnAstReader *r, uint32_t ref, uint32_t owner);
+static CnAstBlockStmt *read_block(CnAstReader *r, uint32_t ref, uint32_t owner);
+static CnAstFunctionDecl *read_function(CnAstReader *r, uint32_t ref, uint32_t owner);
+
+// 类型与解析器一样在堆上创建（类型系统独立管理其生命周期）
+static CnType *read_type(CnAstReader *r, uint32_t ref, uint32_t owner)
+{
+    void *found;
+    size_t pos = ref;
+    CnTypeKind kind;
+    uint32_t refs[3] = {0, 0, 0};
+    CnType *type = NULL;
+
+    if (ref == 0 || r->failed || !ref_valid(r, ref, owner)) {
+        return NULL;
+    }
+    if (reader_lookup(r, ref, RECORD_TYPE, &found)) {
+        return (CnType *)found;
+    }
+
+    get_u8(r, &pos);  // 标志
+    kind = (CnTypeKind)get_u8(r, &pos);
+    if (r->failed || (unsigned)kind > CN_TYPE_UNKNOWN) {
+        r->failed = true;
+        return NULL;
+    }
+    get_bytes(r, &pos, refs, g_type_ref_counts[kind] * sizeof(uint32_t));
+    if (r->failed) {
+        return NULL;
+    }
+
+    switch (kind) {
+    case CN_TYPE_POINTER:
+        type = cn_type_new_pointer(read_type(r, refs[0], ref));
+        break;
+    case CN_TYPE_ARRAY: {
+        uint64_t length = get_u64(r, &pos);
+        type = cn_type_new_array(read_type(r, refs[0], ref), (size_t)length);
+        break;
+    }
+    case CN_TYPE_STRUCT: {
+        size_t name_length;
+        size_t owner_length;
+        size_t count;
+        const char *name = read_string(r, refs[0], ref, &name_length, true);
+        const char *owner_func = read_string(r, refs[1], ref, &owner_length, true);
+        size_t list = read_refs(r, refs[2], ref, &count);
+        CnStructField *fields = NULL;
+        size_t field_count = count / 3;
+
+        if (field_count > 0) {
+            fields = (CnStructField *)calloc(field_count, sizeof(CnStructField));
+            if (!fields) {
+                r->failed = true;
+                return NULL;
+            }
+            for (size_t i = 0; i < field_count; i++) {
+                fields[i].name = read_string(r, ref_at(r, list, i * 3), ref, &fields[i].name_length, true);
+                fields[i].field_type = read_type(r, ref_at(r, list, i * 3 + 1), ref);
+                fields[i].is_const = (int)ref_at(r, list, i * 3 + 2);
+            }
+        }
+        type = cn_type_new_struct(name, name_length, fields, field_count, NULL, owner_func, owner_length);
+        break;
+    }
+    case CN_TYPE_ENUM: {
+        size_t name_length;
+        const char *name = read_string(r, refs[0], ref, &name_length, true);
+        type = cn_type_new_enum(name, name_length);
+        break;
+    }
+    case CN_TYPE_FUNCTION: {
+        size_t count;
+        size_t list = read_refs(r, refs[1], ref, &count);
+        CnType **param_types = NULL;
+
+        if (count > 0) {
+            param_types = (CnType **)malloc(count * sizeof(CnType *));
+            if (!param_types) {
+                r->failed = true;
+                return NULL;
+            }
+            for (size_t i = 0; i < count; i++) {
+                param_types[i] = read_type(r, ref_at(r, list, i), ref);
+            }
+        }
+        type = cn_type_new_function(read_type(r, refs[0], ref), param_types, count);
+        free(param_types);
+        break;
+    }
+    case CN_TYPE_CLASS:
+    case CN_TYPE_INTERFACE:
+    case CN_TYPE_PARAM:
+        r->failed = true;
+        return NULL;
+    default:
+        type = cn_type_new_primitive(kind);
+        break;
+    }
+
+    if (!type) {
+        r->failed = true;
+        return NULL;
+    }
+    reader_remember(r, ref, RECORD_TYPE, type);
+    return type;
+}
+
+static CnAstExpr **read_expr_list(CnAstReader *r, uint32_t ref, uint32_t owner, size_t *out_count)
+{
+    size_t count;
+    size_t list = read_refs(r, ref, owner, &count);
+    CnAstExpr **exprs;
+
+    *out_count = count;
+    if (count == 0) {
+        return NULL;
+    }
+    exprs = (CnAstExpr **)reader_alloc(r, count * sizeof(CnAstExpr *));
+    if (!exprs) {
+        return NULL;
+    }
+    for (size_t i = 0; i < count; i++) {
+        exprs[i] = read_expr(r, ref_at(r, list, i), owner);
+    }
+    return exprs;
+}
+
+static void read_loc(CnAstReader *r, uint8_t flags, int32_t line, int32_t column, CnSourceLocation *loc)
+{
+    loc->filename = (flags & LOC_HAS_FILENAME) ? r->filename : NULL;
+    loc->line = line;
+    loc->column = column;
+}
+
+static bool reader_ref_push(CnAstReader *r, CnRefList *list, uint32_t ref)
+{
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity == 0 ? 16 : list->capacity * 2;
+        uint32_t *items = (uint32_t *)realloc(list->items, capacity * sizeof(uint32_t));
+        if (!items) {
+            r->failed = true;
+            return false;
+        }
+        list->items = items;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = ref;
+    return true;
+}
+
+// 读取运算记录的种类与左操作数引用（不创建节点，ref 已通过校验）；不是二元/逻辑运算时返回 false
+static bool peek_operator(CnAstReader *r, uint32_t ref, CnAstExprKind *out_kind, uint32_t *out_left)
+{
+    size_t pos = ref;
+    uint8_t flags = get_u8(r, &pos);
+
+    *out_kind = (CnAstExprKind)get_u8(r, &pos);
+    pos += 2 * sizeof(int32_t);  // 行、列
+    if (flags & EXPR_HAS_TYPE) {
+        pos += sizeof(uint32_t);
+    }
+    pos += 1;                    // 运算符
+    if (r->failed || (*out_kind != CN_AST_EXPR_BINARY && *out_kind != CN_AST_EXPR_LOGICAL)) {
+        return false;
+    }
+    *out_left = get_u32(r, &pos);
+    return !r->failed;
+}
+
+// 左结合长链：从最底层起依次读取链上尚未读取的运算节点（写出时已标记为共享），
+// 之后每层的左操作数都可从备忘表取得，递归深度与链长无关
+static void read_operator_chain(CnAstReader *r, uint32_t ref)
+{
+    CnRefList chain = {0};  // items[i] 的所有者为 items[i - 1]，items[0] 的所有者为 ref
+    CnAstExprKind kind;
+    CnAstExprKind left_kind;
+    uint32_t node = ref;
+    uint32_t left;
+    uint32_t next;
+    void *found;
+
+    if (!peek_operator(r, ref, &kind, &left)) {
+        return;
+    }
+    while (left != 0 && ref_valid(r, left, node) && peek_operator(r, left, &left_kind, &next) &&
+           left_kind == kind && !reader_lookup(r, left, RECORD_EXPR, &found)) {
+        if (!reader_ref_push(r, &chain, left)) {
+            break;
+        }
+        node = left;
+        left = next;
+    }
+    for (size_t i = chain.count; i-- > 0 && !r->failed;) {
+        read_expr(r, chain.items[i], i > 0 ? chain.items[i - 1] : ref);
+    }
+    free(chain.items);
+}
+
+static CnAstExpr *read_expr(CnAstReader *r, uint32_t ref, uint32_t owner)
+{
+    void *found;
+    size_t pos = ref;
+    CnAstExpr *expr;
+    CnAstExprKind kind;
+    uint8_t flags;
+    int32_t line;
+    int32_t column;
+    uint32_t type_ref;
+    uint8_t op = 0;
+    uint8_t is_arrow = 0;
+    uint8_t is_static_member = 0;
+    int64_t int_value = 0;
+    double float_value = 0.0;
+    int32_t bool_value = 0;
+    uint32_t refs[4] = {0, 0, 0, 0};
+
+    if (ref == 0 || r->failed || !ref_valid(r, ref, owner)) {
+        return NULL;
+    }
+    if (reader_lookup(r, ref, RECORD_EXPR, &found)) {
+        return (CnAstExpr *)found;
+    }
+    read_operator_chain(r, ref);
+
+    flags = get_u8(r, &pos);
+    kind = (CnAstExprKind)get_u8(r, &pos);
+    line = get_i32(r, &pos);
+    column = get_i32(r, &pos);
+    type_ref = (flags & EXPR_HAS_TYPE) ? get_u32(r, &pos) : 0;
+    if (r->failed || (unsigned)kind > CN_AST_EXPR_EMBED) {
+        r->failed = true;
+        return NULL;
+    }
+    switch (kind) {
+    case CN_AST_EXPR_BINARY:
+    case CN_AST_EXPR_LOGICAL:
+    case CN_AST_EXPR_UNARY:
+    case CN_AST_EXPR_CHAR_LITERAL:
+        op = get_u8(r, &pos);
+        break;
+    case CN_AST_EXPR_INTEGER_LITERAL:
+        int_value = get_i64(r, &pos);
+        break;
+    case CN_AST_EXPR_FLOAT_LITERAL:
+        float_value = get_f64(r, &pos);
+        break;
+    case CN_AST_EXPR_BOOL_LITERAL:
+        bool_value = get_i32(r, &pos);
+        break;
+    case CN_AST_EXPR_MEMBER_ACCESS:
+        is_arrow = get_u8(r, &pos);
+        is_static_member = get_u8(r, &pos);
+        break;
+    default:
+        break;
+    }
+    get_bytes(r, &pos, refs, g_expr_ref_counts[kind] * sizeof(uint32_t));
+    if (r->failed) {
+        return NULL;
+    }
+
+    expr = (CnAstExpr *)reader_alloc(r, cn_frontend_ast_expr_node_size(kind));
+    if (!expr) {
+        return NULL;
+    }
+    expr->kind = kind;
+    expr->type = read_type(r, type_ref, ref);
+    read_loc(r, flags, line, column, &expr->loc);
+    expr->is_this_pointer = (flags & EXPR_IS_THIS) ? 1 : 0;
+    expr->is_base_pointer = (flags & EXPR_IS_BASE) ? 1 : 0;
+
+    switch (kind) {
+    case CN_AST_EXPR_BINARY:
+        expr->as.binary.op = (CnAstBinaryOp)op;
+        expr->as.binary.left = read_expr(r, refs[0], ref);
+        expr->as.binary.right = read_expr(r, refs[1], ref);
+        break;
+    case CN_AST_EXPR_CALL:
+        expr->as.call.callee = read_expr(r, refs[0], ref);
+        expr->as.call.arguments = read_expr_list(r, refs[1], ref, &expr->as.call.argument_count);
+        break;
+    case CN_AST_EXPR_IDENTIFIER:
+        expr->as.identifier.name = read_string(r, refs[0], ref, &expr->as.identifier.name_length, true);
+        break;
+    case CN_AST_EXPR_INTEGER_LITERAL:
+        expr->as.integer_literal.value = (long)int_value;
+        break;
+    case CN_AST_EXPR_FLOAT_LITERAL:
+        expr->as.float_literal.value = float_value;
+        break;
+    case CN_AST_EXPR_STRING_LITERAL:
+        expr->as.string_literal.value = read_string(r, refs[0], ref, &expr->as.string_literal.length, false);
+        break;
+    case CN_AST_EXPR_CHAR_LITERAL:
+        expr->as.char_literal.value = (char)op;
+        break;
+    case CN_AST_EXPR_BOOL_LITERAL:
+        expr->as.bool_literal.value = bool_value;
+        break;
+    case CN_AST_EXPR_ASSIGN:
+        expr->as.assign.target = read_expr(r, refs[0], ref);
+        expr->as.assign.value = read_expr(r, refs[1], ref);
+        break;
+    case CN_AST_EXPR_LOGICAL:
+        expr->as.logical.op = (CnAstLogicalOp)op;
+        expr->as.logical.left = read_expr(r, refs[0], ref);
+        expr->as.logical.right = read_expr(r, refs[1], ref);
+        break;
+    case CN_AST_EXPR_UNARY:
+        expr->as.unary.op = (CnAstUnaryOp)op;
+        expr->as.unary.operand = read_expr(r, refs[0], ref);
+        break;
+    case CN_AST_EXPR_TERNARY:
+        expr->as.ternary.condition = read_expr(r, refs[0], ref);
+        expr->as.ternary.true_expr = read_expr(r, refs[1], ref);
+        expr->as.ternary.false_expr = read_expr(r, refs[2], ref);
+        break;
+    case CN_AST_EXPR_ARRAY_LITERAL:
+        expr->as.array_literal.elements = read_expr_list(r, refs[0], ref,
+                                                         &expr->as.array_literal.element_count);
+        break;
+    case CN_AST_EXPR_INDEX:
+        expr->as.index.array = read_expr(r, refs[0], ref);
+        expr->as.index.index = read_expr(r, refs[1], ref);
+        break;
+    case CN_AST_EXPR_MEMBER_ACCESS:
+        expr->as.member.object = read_expr(r, refs[0], ref);
+        expr->as.member.member_name = read_string(r, refs[1], ref, &expr->as.member.member_name_length, true);
+        expr->as.member.class_name = read_string(r, refs[2], ref, &expr->as.member.class_name_length, true);
+        expr->as.member.is_arrow = is_arrow;
+        expr->as.member.is_static_member = is_static_member;
+        break;
+    case CN_AST_EXPR_STRUCT_LITERAL: {
+        size_t count;
+        size_t list = read_refs(r, refs[1], ref, &count);
+        size_t field_count = count / 2;
+
+        expr->as.struct_lit.struct_name = read_string(r, refs[0], ref,
+                                                      &expr->as.struct_lit.struct_name_length, true);
+        expr->as.struct_lit.field_count = field_count;
+        if (field_count > 0) {
+            CnAstStructFieldInit *fields = (CnAstStructFieldInit *)reader_alloc(
+                r, field_count * sizeof(CnAstStructFieldInit));
+            if (!fields) {
+                return NULL;
+            }
+            for (size_t i = 0; i < field_count; i++) {
+                fields[i].field_name = read_string(r, ref_at(r, list, i * 2), ref,
+                                                   &fields[i].field_name_length, true);
+                fields[i].value = read_expr(r, ref_at(r, list, i * 2 + 1), ref);
+            }
+            expr->as.struct_lit.fields = fields;
+        }
+        break;
+    }
+    case CN_AST_EXPR_MEMORY_READ:
+        expr->as.memory_read.address = read_expr(r, refs[0], ref);
+        break;
+    case CN_AST_EXPR_MEMORY_WRITE:
+        expr->as.memory_write.address = read_expr(r, refs[0], ref);
+        expr->as.memory_write.value = read_expr(r, refs[1], ref);
+        break;
+    case CN_AST_EXPR_MEMORY_COPY:
+        expr->as.memory_copy.dest = read_expr(r, refs[0], ref);
+        expr->as.memory_copy.src = read_expr(r, refs[1], ref);
+        expr->as.memory_copy.size = read_expr(r, refs[2], ref);
+        break;
+    case CN_AST_EXPR_MEMORY_SET:
+        expr->as.memory_set.address = read_expr(r, refs[0], ref);
+        expr->as.memory_set.value = read_expr(r, refs[1], ref);
+        expr->as.memory_set.size = read_expr(r, refs[2], ref);
+        break;
+    case CN_AST_EXPR_MEMORY_MAP:
+        expr->as.memory_map.address = read_expr(r, refs[0], ref);
+        expr->as.memory_map.size = read_expr(r, refs[1], ref);
+        expr->as.memory_map.prot = read_expr(r, refs[2], ref);
+        expr->as.memory_map.flags = read_expr(r, refs[3], ref);
+        break;
+    case CN_AST_EXPR_MEMORY_UNMAP:
+        expr->as.memory_unmap.address = read_expr(r, refs[0], ref);
+        expr->as.memory_unmap.size = read_expr(r, refs[1], ref);
+        break;
+    case CN_AST_EXPR_INLINE_ASM:
+        expr->as.inline_asm.asm_code = read_expr(r, refs[0], ref);
+        expr->as.inline_asm.outputs = read_expr_list(r, refs[1], ref, &expr->as.inline_asm.output_count);
+        expr->as.inline_asm.inputs = read_expr_list(r, refs[2], ref, &expr->as.inline_asm.input_count);
+        expr->as.inline_asm.clobbers = read_expr(r, refs[3], ref);
+        break;
+    case CN_AST_EXPR_TEMPLATE_INSTANTIATION: {
+        size_t count;
+        size_t list = read_refs(r, refs[1], ref, &count);
+
+        expr->as.template_inst.template_name = read_string(r, refs[0], ref,
+                                                           &expr->as.template_inst.template_name_length, true);
+        expr->as.template_inst.type_arg_count = count;
+        if (count > 0) {
+            CnType **type_args = (CnType **)reader_alloc(r, count * sizeof(CnType *));
+            if (!type_args) {
+                return NULL;
+            }
+            for (size_t i = 0; i < count; i++) {
+                type_args[i] = read_type(r, ref_at(r, list, i), ref);
+            }
+            expr->as.template_inst.type_args = type_args;
+        }
+        break;
+    }
+    case CN_AST_EXPR_CAST:
+        expr->as.cast.target_type = read_type(r, refs[0], ref);
+        expr->as.cast.operand = read_expr(r, refs[1], ref);
+        break;
+    case CN_AST_EXPR_EMBED:
+        expr->as.embed.path = read_string(r, refs[0], ref, &expr->as.embed.path_length, false);
+        break;
+    }
+
+    reader_remember(r, ref, RECORD_EXPR, expr);
+    return expr;
+}
+
+static CnAstBlockStmt *read_block(CnAstReader *r, uint32_t ref, uint32_t owner)
+{
+    void *found;
+    size_t count;
+    size_t list;
+    CnAstBlockStmt *block;
+
+    if (ref == 0 || r->failed || !ref_valid(r, ref, owner)) {
+        return NULL;
+    }
+    if (reader_lookup(r, ref, RECORD_BLOCK, &found)) {
+        return (CnAstBlockStmt *)found;
+    }
+
+    list = read_refs(r, ref + 1, owner, &count);  // 跳过标志字节
+    block = (CnAstBlockStmt *)reader_alloc(r, sizeof(CnAstBlockStmt));
+    if (!block) {
+        return NULL;
+    }
+    block->stmt_count = count;
+    if (count > 0) {
+        block->stmts = (CnAstStmt **)reader_alloc(r, count * sizeof(CnAstStmt *));
+        if (!block->stmts) {
+            return NULL;
+        }
+        for (size_t i = 0; i < count; i++) {
+            block->stmts[i] = read_stmt(r, ref_at(r, list, i), ref);
+        }
+    }
+
+    reader_remember(r, ref, RECORD_BLOCK, block);
+    return block;
+}
+
+static CnAstTemplateParams *read_template_params(CnAstReader *r, uint32_t ref, uint32_t owner)
+{
+    size_t count;
+    size_t list;
+    size_t param_count;
+    CnAstTemplateParams *params;
+
+    if (ref == 0) {
+        return NULL;
+    }
+    list = read_refs(r, ref, owner, &count);
+    param_count = count / 3;
+    params = (CnAstTemplateParams *)reader_alloc(r, sizeof(CnAstTemplateParams));
+    if (!params) {
+        return NULL;
+    }
+    params->param_count = param_count;
+    if (param_count > 0) {
+        params->params = (CnAstTemplateParam *)reader_alloc(r, param_count * sizeof(CnAstTemplateParam));
+        if (!params->params) {
+            return NULL;
+        }
+        for (size_t i = 0; i < param_count; i++) {
+            CnAstTemplateParam *param = &params->params[i];
+            param->name = read_string(r, ref_at(r, list, i * 3), ref, &param->name_length, true);
+            param->constraint = read_type(r, ref_at(r, list, i * 3 + 1), ref);
+            param->default_type = read_type(r, ref_at(r, list, i * 3 + 2), ref);
+        }
+    }
+    return params;
+}
+
+static CnAstStructField *read_struct_fields(CnAstReader *r, uint32_t ref, uint32_t owner, size_t *out_count)
+{
+    size_t count;
+    size_t list = read_refs(r, ref, owner, &count);
+    size_t field_count = count / 3;
+    CnAstStructField *fields;
+
+    *out_count = field_count;
+    if (field_count == 0) {
+        return NULL;
+    }
+    fields = (CnAstStructField *)reader_alloc(r, field_count * sizeof(CnAstStructField));
+    if (!fields) {
+        return NULL;
+    }
+    for (size_t i = 0; i < field_count; i++) {
+        fields[i].name = read_string(r, ref_at(r, list, i * 3), ref, &fields[i].name_length, true);
+        fields[i].field_type = read_type(r, ref_at(r, list, i * 3 + 1), ref);
+        fields[i].is_const = (int)ref_at(r, list, i * 3 + 2);
+    }
+    return fields;
+}
+
+static CnAstModulePath *read_module_path(CnAstReader *r, uint32_t ref, uint32_t owner)
+{
+    size_t count;
+    size_t list;
+    CnAstModulePath *path;
+
+    if (ref == 0) {
+        return NULL;
+    }
+    list = read_refs(r, ref, owner, &count);
+    if (count < 2) {
+        r->failed = true;
+        return NULL;
+    }
+    path = (CnAstModulePath *)reader_alloc(r, sizeof(CnAstModulePath));
+    if (!path) {
+        return NULL;
+    }
+    path->is_relative = (int)ref_at(r, list, 0);
+    path->relative_level = (int)ref_at(r, list, 1);
+    path->segment_count = count - 2;
+    if (path->segment_count > 0) {
+        path->segments = (CnAstModulePathSegment *)reader_alloc(
+            r, path->segment_count * sizeof(CnAstModulePathSegment));
+        if (!path->segments) {
+            return NULL;
+        }
+        for (size_t i = 0; i < path->segment_count; i++) {
+            path->segments[i].name = read_string(r, ref_at(r, list, i + 2), ref,
+                                                 &path->segments[i].name_length, true);
+        }
+    }
+    return path;
+}
+
+// 如果语句记录的否则块只含一条如果语句时返回该语句的引用，并给出否则块的引用（ref 已通过校验）
+static uint32_t peek_else_if(CnAstReader *r, uint32_t ref, uint32_t *out_block)
+{
+    size_t pos = ref + 1;
+    uint32_t refs[3];
+    size_t list;
+    size_t count;
+    uint32_t inner;
+
+    if (get_u8(r, &pos) != CN_AST_STMT_IF) {
+        return 0;
+    }
+    pos += 2 * sizeof(int32_t);  // 行、列
+    get_bytes(r, &pos, refs, sizeof(refs));
+    if (r->failed || refs[2] == 0 || !ref_valid(r, refs[2], ref)) {
+        return 0;
+    }
+    list = read_refs(r, refs[2] + 1, ref, &count);  // 跳过标志字节
+    if (r->failed || count != 1) {
+        return 0;
+    }
+    inner = ref_at(r, list, 0);
+    pos = (size_t)inner + 1;
+    if (inner == 0 || !ref_valid(r, inner, refs[2]) || get_u8(r, &pos) != CN_AST_STMT_IF) {
+        return 0;
+    }
+    *out_block = refs[2];
+    return inner;
+}
+
+// "否则 如果" 链：从最内层起依次读取尚未读取的各段如果语句，之后每段的否则块都可从备忘表取得
+static void read_else_if_chain(CnAstReader *r, uint32_t ref)
+{
+    CnRefList chain = {0};  // 成对保存：如果语句的引用、其所在否则块的引用
+    uint32_t block = 0;
+    uint32_t inner = peek_else_if(r, ref, &block);
+    void *found;
+
+    while (inner != 0 && !reader_lookup(r, inner, RECORD_STMT, &found)) {
+        if (!reader_ref_push(r, &chain, inner) || !reader_ref_push(r, &chain, block)) {
+            break;
+        }
+        inner = peek_else_if(r, inner, &block);
+    }
+    for (size_t i = chain.count / 2; i-- > 0 && !r->failed;) {
+        read_stmt(r, chain.items[i * 2], chain.items[i * 2 + 1]);
+    }
+    free(chain.items);
+}
+
+static CnAstStmt *read_stmt(CnAstReader *r, uint32_t ref, uint32_t owner)
+{
+    void *found;
+    size_t pos = ref;
+    CnAstStmt *stmt;
+    CnAstStmtKind kind;
+    uint8_t flags;
+    int32_t line;
+    int32_t column;
+    uint32_t refs[4] = {0, 0, 0, 0};
+    uint8_t values[4] = {0, 0, 0, 0};
+
+    if (ref == 0 || r->failed || !ref_valid(r, ref, owner)) {
+        return NULL;
+    }
+    if (reader_lookup(r, ref, RECORD_STMT, &found)) {
+        return (CnAstStmt *)found;
+    }
+
+    flags = get_u8(r, &pos);
+    kind = (CnAstStmtKind)get_u8(r, &pos);
+    line = get_i32(r, &pos);
+    column = get_i32(r, &pos);
+    if (r->failed || (unsigned)kind > CN_AST_STMT_TEMPLATE_STRUCT_DECL ||
+        kind == CN_AST_STMT_CLASS_DECL || kind == CN_AST_STMT_INTERFACE_DECL) {
+        r->failed = true;
+        return NULL;
+    }
+    get_bytes(r, &pos, refs, g_stmt_layouts[kind].ref_count * sizeof(uint32_t));
+    get_bytes(r, &pos, values, g_stmt_layouts[kind].value_count);
+    if (r->failed) {
+        return NULL;
+    }
+
+    stmt = (CnAstStmt *)reader_alloc(r, cn_frontend_ast_stmt_node_size(kind));
+    if (!stmt) {
+        return NULL;
+    }
+    stmt->kind = kind;
+    read_loc(r, flags, line, column, &stmt->loc);
+
+    switch (kind) {
+    case CN_AST_STMT_BLOCK:
+        stmt->as.block = read_block(r, refs[0], ref);
+        break;
+    case CN_AST_STMT_VAR_DECL:
+        stmt->as.var_decl.name = read_string(r, refs[0], ref, &stmt->as.var_decl.name_length, true);
+        stmt->as.var_decl.declared_type = read_type(r, refs[1], ref);
+        stmt->as.var_decl.source_type = stmt->as.var_decl.declared_type;
+        stmt->as.var_decl.initializer = read_expr(r, refs[2], ref);
+        stmt->as.var_decl.visibility = (CnVisibility)values[0];
+        stmt->as.var_decl.is_const = (int)values[1];
+        stmt->as.var_decl.is_static = (int)values[2];
+        break;
+    case CN_AST_STMT_EXPR:
+        stmt->as.expr.expr = read_expr(r, refs[0], ref);
+        break;
+    case CN_AST_STMT_RETURN:
+        stmt->as.return_stmt.expr = read_expr(r, refs[0], ref);
+        break;
+    case CN_AST_STMT_IF:
+        read_else_if_chain(r, ref);
+        stmt->as.if_stmt.condition = read_expr(r, refs[0], ref);
+        stmt->as.if_stmt.then_block = read_block(r, refs[1], ref);
+        stmt->as.if_stmt.else_block = read_block(r, refs[2], ref);
+        break;
+    case CN_AST_STMT_WHILE:
+        stmt->as.while_stmt.condition = read_expr(r, refs[0], ref);
+        stmt->as.while_stmt.body = read_block(r, refs[1], ref);
+        break;
+    case CN_AST_STMT_FOR:
+        stmt->as.for_stmt.init = read_stmt(r, refs[0], ref);
+        stmt->as.for_stmt.condition = read_expr(r, refs[1], ref);
+        stmt->as.for_stmt.update = read_expr(r, refs[2], ref);
+        stmt->as.for_stmt.body = read_block(r, refs[3], ref);
+        break;
+    case CN_AST_STMT_SWITCH: {
+        size_t count;
+        size_t list = read_refs(r, refs[1], ref, &count);
+        size_t case_count = count / 2;
+
+        stmt->as.switch_stmt.expr = read_expr(r, refs[0], ref);
+        stmt->as.switch_stmt.case_count = case_count;
+        if (case_count > 0) {
+            CnAstSwitchCase *cases = (CnAstSwitchCase *)reader_alloc(r, case_count * sizeof(CnAstSwitchCase));
+            if (!cases) {
+                return NULL;
+            }
+            for (size_t i = 0; i < case_count; i++) {
+                cases[i].value = read_expr(r, ref_at(r, list, i * 2), ref);
+                cases[i].body = read_block(r, ref_at(r, list, i * 2 + 1), ref);
+            }
+            stmt->as.switch_stmt.cases = cases;
+        }
+        break;
+    }
+    case CN_AST_STMT_STRUCT_DECL:
+        stmt->as.struct_decl.name = read_string(r, refs[0], ref, &stmt->as.struct_decl.name_length, true);
+        stmt->as.struct_decl.fields = read_struct_fields(r, refs[1], ref, &stmt->as.struct_decl.field_count);
+        break;
+    case CN_AST_STMT_ENUM_DECL: {
+        size_t count;
+        size_t list = read_refs(r, refs[1], ref, &count);
+        size_t member_count = count / 4;
+
+        stmt->as.enum_decl.name = read_string(r, refs[0], ref, &stmt->as.enum_decl.name_length, true);
+        stmt->as.enum_decl.member_count = member_count;
+        if (member_count > 0) {
+            CnAstEnumMember *members = (CnAstEnumMember *)reader_alloc(
+                r, member_count * sizeof(CnAstEnumMember));
+            if (!members) {
+                return NULL;
+            }
+            for (size_t i = 0; i < member_count; i++) {
+                uint64_t low = ref_at(r, list, i * 4 + 2);
+                uint64_t high = ref_at(r, list, i * 4 + 3);
+                members[i].name = read_string(r, ref_at(r, list, i * 4), ref, &members[i].name_length, true);
+                members[i].has_value = (int)ref_at(r, list, i * 4 + 1);
+                members[i].value = (long)(int64_t)(low | (high << 32));
+            }
+            stmt->as.enum_decl.members = members;
+        }
+        break;
+    }
+    case CN_AST_STMT_IMPORT: {
+        CnAstImportStmt *import = &stmt->as.import_stmt;
+        import->module_name = read_string(r, refs[0], ref, &import->module_name_length, true);
+        import->alias = read_string(r, refs[1], ref, &import->alias_length, true);
+        if (refs[2] != 0) {
+            size_t count;
+            size_t list = read_refs(r, refs[2], ref, &count);
+            size_t member_count = count / 2;
+
+            import->member_count = member_count;
+            import->members = (CnAstImportMember *)reader_alloc(
+                r, (member_count > 0 ? member_count : 1) * sizeof(CnAstImportMember));
+            if (!import->members) {
+                return NULL;
+            }
+            for (size_t i = 0; i < member_count; i++) {
+                CnAstImportMember *member = &import->members[i];
+                member->name = read_string(r, ref_at(r, list, i * 2), ref, &member->name_length, true);
+                member->alias = read_string(r, ref_at(r, list, i * 2 + 1), ref, &member->alias_length, true);
+            }
+        }
+        import->module_path = read_module_path(r, refs[3], ref);
+        import->kind = (CnAstImportKind)values[0];
+        import->is_wildcard = (int)values[1];
+        import->use_from_syntax = (int)values[2];
+        import->target_type = (CnAstImportTargetType)values[3];
+        break;
+    }
+    case CN_AST_STMT_TRY:
+        if (values[0]) {
+            size_t count;
+            size_t list = read_refs(r, refs[1], ref, &count);
+            size_t catch_count = count / 3;
+            CnAstTryStmt *try_stmt = (CnAstTryStmt *)reader_alloc(r, sizeof(CnAstTryStmt));
+
+            if (!try_stmt) {
+                return NULL;
+            }
+            try_stmt->try_block = read_block(r, refs[0], ref);
+            try_stmt->finally_block = read_block(r, refs[2], ref);
+            try_stmt->catch_count = catch_count;
+            if (catch_count > 0) {
+                try_stmt->catches = (CnAstCatchClause *)reader_alloc(r, catch_count * sizeof(CnAstCatchClause));
+                if (!try_stmt->catches) {
+                    return NULL;
+                }
+                for (size_t i = 0; i < catch_count; i++) {
+                    CnAstCatchClause *clause = &try_stmt->catches[i];
+                    clause->exception_type = read_string(r, ref_at(r, list, i * 3), ref,
+                                                         &clause->exception_type_length, true);
+                    clause->var_name = read_string(r, ref_at(r, list, i * 3 + 1), ref,
+                                                   &clause->var_name_length, true);
+                    clause->body = read_block(r, ref_at(r, list, i * 3 + 2), ref);
+                }
+            }
+            stmt->as.try_stmt = try_stmt;
+        }
+        break;
+    case CN_AST_STMT_THROW:
+        stmt->as.throw_stmt.exception_expr = read_expr(r, refs[0], ref);
+        stmt->as.throw_stmt.exception_type = read_string(r, refs[1], ref,
+                                                         &stmt->as.throw_stmt.exception_type_length, true);
+        stmt->as.throw_stmt.message = read_string(r, refs[2], ref, &stmt->as.throw_stmt.message_length, false);
+        break;
+    case CN_AST_STMT_FINALLY:
+        if (values[0]) {
+            stmt->as.finally_stmt = (CnAstFinallyStmt *)reader_alloc(r, sizeof(CnAstFinallyStmt));
+            if (!stmt->as.finally_stmt) {
+                return NULL;
+            }
+            stmt->as.finally_stmt->body = read_block(r, refs[0], ref);
+        }
+        break;
+    case CN_AST_STMT_TEMPLATE_FUNCTION_DECL:
+        if (values[0]) {
+            CnAstTemplateFunctionDecl *decl = (CnAstTemplateFunctionDecl *)reader_alloc(
+                r, sizeof(CnAstTemplateFunctionDecl));
+            if (!decl) {
+                return NULL;
+            }
+            decl->template_params = read_template_params(r, refs[0], ref);
+            decl->function = read_function(r, refs[1], ref);
+            stmt->as.template_func_decl = decl;
+        }
+        break;
+    case CN_AST_STMT_TEMPLATE_STRUCT_DECL:
+        if (values[0]) {
+            CnAstTemplateStructDecl *decl = (CnAstTemplateStructDecl *)reader_alloc(
+                r, sizeof(CnAstTemplateStructDecl));
+            if (!decl) {
+                return NULL;
+            }
+            decl->template_params = read_template_params(r, refs[0], ref);
+            if (values[1]) {
+                decl->struct_decl = (CnAstStructDecl *)reader_alloc(r, sizeof(CnAstStructDecl));
+                if (!decl->struct_decl) {
+                    return NULL;
+                }
+                decl->struct_decl->name = read_string(r, refs[1], ref, &decl->struct_decl->name_length, true);
+                decl->struct_decl->fields = read_struct_fields(r, refs[2], ref, &decl->struct_decl->field_count);
+            }
+            stmt->as.template_struct_decl = decl;
+        }
+        break;
+    default:
+        break;
+    }
+
+    reader_remember(r, ref, RECORD_STMT, stmt);
+    return stmt;
+}
+
+static CnAstFunctionDecl *read_function(CnAstReader *r, uint32_t ref, uint32_t owner)
+{
+    void *found;
+    size_t pos = ref;
+    uint32_t name_ref;
+    uint32_t params_ref;
+    uint32_t return_ref;
+    uint32_t body_ref;
+    CnAstFunctionDecl *function_decl;
+
+    if (ref == 0 || r->failed || !ref_valid(r, ref, owner)) {
+        return NULL;
+    }
+    if (reader_lookup(r, ref, RECORD_FUNCTION, &found)) {
+        return (CnAstFunctionDecl *)found;
+    }
+
+    function_decl = (CnAstFunctionDecl *)reader_alloc(r, sizeof(CnAstFunctionDecl));
+    if (!function_decl) {
+        return NULL;
+    }
+    get_u8(r, &pos);  // 标志
+    name_ref = get_u32(r, &pos);
+    params_ref = get_u32(r, &pos);
+    return_ref = get_u32(r, &pos);
+    body_ref = get_u32(r, &pos);
+    function_decl->visibility = (CnVisibility)get_u8(r, &pos);
+    function_decl->is_interrupt_handler = get_u8(r, &pos);
+    function_decl->interrupt_vector = get_u32(r, &pos);
+    function_decl->is_prototype = get_u8(r, &pos);
+    function_decl->is_override = get_u8(r, &pos);
+    function_decl->is_static = get_u8(r, &pos);
+
+    function_decl->name = read_string(r, name_ref, ref, &function_decl->name_length, true);
+    if (params_ref != 0) {
+        size_t count;
+        size_t list = read_refs(r, params_ref, ref, &count);
+        size_t param_count = count / 3;
+
+        function_decl->parameter_count = param_count;
+        function_decl->parameters = (CnAstParameter *)reader_alloc(
+            r, (param_count > 0 ? param_count : 1) * sizeof(CnAstParameter));
+        if (!function_decl->parameters) {
+            return NULL;
+        }
+        for (size_t i = 0; i < param_count; i++) {
+            CnAstParameter *param = &function_decl->parameters[i];
+            param->name = read_string(r, ref_at(r, list, i * 3), ref, &param->name_length, true);
+            param->declared_type = read_type(r, ref_at(r, list, i * 3 + 1), ref);
+            param->is_const = (int)ref_at(r, list, i * 3 + 2);
+        }
+    }
+    function_decl->return_type = read_type(r, return_ref, ref);
+    function_decl->body = read_block(r, body_ref, ref);
+
+    reader_remember(r, ref, RECORD_FUNCTION, function_decl);
+    return function_decl;
+}
+
+static CnAstStmt **read_stmt_list(CnAstReader *r, uint32_t ref, uint32_t owner, size_t *out_count)
+{
+    size_t count;
+    size_t list = read_refs(r, ref, owner, &count);
+    CnAstStmt **stmts;
+
+    *out_count = count;
+    if (count == 0) {
+        return NULL;
+    }
+    stmts = (CnAstStmt **)reader_alloc(r, count * sizeof(CnAstStmt *));
+    if (!stmts) {
+        return NULL;
+    }
+    for (size_t i = 0; i < count; i++) {
+        stmts[i] = read_stmt(r, ref_at(r, list, i), owner);
+    }
+    return stmts;
+}
+
+CnAstProgram *cn_ast_cache_deserialize(const void *data, size_t size, uint64_t source_key,
+                                       size_t source_length, const char *filename)
+{
+    CnAstCacheHeader header;
+    CnAstReader reader;
+    CnAstProgram *program;
+    uint32_t lists[7];
+    size_t pos;
+
+    if (!data || size < sizeof(header)) {
+        return NULL;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, CN_AST_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.format_version != CN_AST_CACHE_FORMAT_VERSION ||
+        header.byte_order != CN_AST_CACHE_BYTE_ORDER ||
+        header.source_key != source_key ||
+        header.source_length != (uint64_t)source_length ||
+        strncmp(header.compiler_version, CN_LANG_VERSION_STRING, sizeof(header.compiler_version)) != 0 ||
+        header.image_size != size ||
+        header.program_offset < sizeof(header) ||
+        header.program_offset > size - sizeof(lists) ||
+        header.string_count > size / 9) {
+        return NULL;
+    }
+
+    memset(&reader, 0, sizeof(reader));
+    reader.data = (const unsigned char *)data;
+    reader.size = size;
+    reader.filename = filename;
+    reader.string_count = header.string_count;
+    reader.names = (const char **)calloc(header.string_count ? header.string_count : 1, sizeof(const char *));
+    reader.arena = cn_arena_new(0);
+    program = (CnAstProgram *)calloc(1, sizeof(CnAstProgram));
+    if (!reader.names || !reader.arena || !program) {
+        free(reader.names);
+        cn_arena_free(reader.arena);
+        free(program);
+        return NULL;
+    }
+    program->arena = reader.arena;
+
+    pos = header.program_offset;
+    get_bytes(&reader, &pos, lists, sizeof(lists));
+
+    {
+        size_t count;
+        size_t list = read_refs(&reader, lists[0], header.program_offset, &count);
+        if (count > 0) {
+            program->functions = (CnAstFunctionDecl **)reader_alloc(&reader, count * sizeof(CnAstFunctionDecl *));
+            for (size_t i = 0; program->functions && i < count; i++) {
+                program->functions[i] = read_function(&reader, ref_at(&reader, list, i), header.program_offset);
+            }
+            program->function_count = program->functions ? count : 0;
+        }
+    }
+    program->structs = read_stmt_list(&reader, lists[1], header.program_offset, &program->struct_count);
+    program->enums = read_stmt_list(&reader, lists[2], header.program_offset, &program->enum_count);
+    program->imports = read_stmt_list(&reader, lists[3], header.program_offset, &program->import_count);
+    program->global_vars = read_stmt_list(&reader, lists[4], header.program_offset, &program->global_var_count);
+    program->template_funcs = read_stmt_list(&reader, lists[5], header.program_offset,
+                                             &program->template_func_count);
+    program->template_structs = read_stmt_list(&reader, lists[6], header.program_offset,
+                                               &program->template_struct_count);
+    ptr_map_free(&reader.loaded);
+    free(reader.names);
+
+    if (reader.failed) {
+        cn_frontend_ast_program_free(program);
+        return NULL;
+    }
+    return program;
+}
+
+// =============================================================================
+// 缓存目录
+// =============================================================================
+
+bool cn_ast_cache_set_directory(const char *directory)
+{
+    char *copy;
+    size_t length;
+
+    free(g_cache_directory);
+    g_cache_directory = NULL;
+    if (!directory || directory[0] == '\0') {
+        return false;
+    }
+
+    length = strlen(directory);
+    while (length > 1 && (directory[length - 1] == '/' || directory[length - 1] == '\\')) {
+        length--;
+    }
+    copy = (char *)malloc(length + 1);
+    if (!copy) {
+        return false;
+    }
+    memcpy(copy, directory, length);
+    copy[length] = '\0';
+
+    cache_mkdir(copy);  // 已存在时失败无妨，写入时再检查
+    g_cache_directory = copy;
+    return true;
+}
+
+const char *cn_ast_cache_get_directory(void)
+{
+    return g_cache_directory;
+}
+
+static bool cache_file_path(uint64_t key, char *buffer, size_t size)
+{
+    int written;
+
+    if (!g_cache_directory) {
+        return false;
+    }
+    written = snprintf(buffer, size, "%s/%016llx%s", g_cache_directory,
+                       (unsigned long long)key, CN_AST_CACHE_EXTENSION);
+    return written > 0 && (size_t)written < size;
+}
+
+CnAstProgram *cn_ast_cache_load(const char *source, size_t length, const char *filename)
+{
+    char path[4096];
+    uint64_t key;
+    const CnSourceFile *file;
+
+    if (!g_cache_directory || !source) {
+        return NULL;
+    }
+    key = cn_ast_cache_key(source, length);
+    if (!cache_file_path(key, path, sizeof(path))) {
+        return NULL;
+    }
+
+    file = cn_source_manager_load(cn_source_manager_default(), path);
+    if (!file) {
+        return NULL;
+    }
+    return cn_ast_cache_deserialize(file->data, file->length, key, length, filename);
+}
+
+bool cn_ast_cache_store(const char *source, size_t length, const CnAstProgram *program)
+{
+    char path[4096];
+    char temp_path[4096 + 32];
+    uint64_t key;
+    void *image;
+    size_t image_size = 0;
+    FILE *file;
+    bool ok;
+
+    if (!g_cache_directory || !source || !program) {
+        return false;
+    }
+    key = cn_ast_cache_key(source, length);
+    if (!cache_file_path(key, path, sizeof(path))) {
+        return false;
+    }
+
+    image = cn_ast_cache_serialize(program, key, length, &image_size);
+    if (!image) {
+        return false;
+    }
+
+    snprintf(temp_path, sizeof(temp_path), "%s.%ld.tmp", path, (long)cache_getpid());
+    file = fopen(temp_path, "wb");
+    if (!file) {
+        free(image);
+        return false;
+    }
+    ok = fwrite(image, 1, image_size, file) == image_size;
+    ok = fclose(file) == 0 && ok;
+    free(image);
+
+    if (ok && rename(temp_path, path) != 0) {
+        // Windows 上目标已存在时 rename 失败：其他编译进程已写入相同内容
+        ok = false;
+    }
+    if (!ok) {
+        remove(temp_path);
+    }
+    return ok;
+}
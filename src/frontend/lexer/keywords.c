@@ -1,4 +1,6 @@
 #include "cnlang/frontend/keywords.h"
+#include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 
 /**
@@ -74,16 +76,100 @@ const CnKeywordEntry *cn_frontend_get_keywords(size_t *out_count)
     return g_keywords;
 }
 
-CnTokenKind cn_frontend_lookup_keyword(const char *begin, size_t length)
+/* ==================== 关键字完美哈希表 ==================== */
+
+/*
+ * 关键字查找使用由 g_keywords 生成的完美哈希表：
+ *   1. 按词素长度位图快速拒绝（绝大多数普通标识符在此返回）；
+ *   2. 以 (长度, 首尾各3字节) 计算带种子的哈希，定位唯一候选槽位；
+ *   3. 仅对候选关键字做一次长度比较和 memcmp。
+ * 种子在首次查找时从 g_keywords 搜索得到，保证表中任意两个关键字不冲突，
+ * 因此关键字表与 cn_frontend_get_keywords 的消费者（LSP补全等）始终同步。
+ */
+#define CN_KEYWORD_HASH_SIZE 128u   /* 必须为2的幂，且大于关键字数量的2倍 */
+#define CN_KEYWORD_MAX_LENGTH 63u   /* 长度位图覆盖的最大关键字字节长度 */
+
+typedef struct CnKeywordHashTable {
+    bool initialized;
+    bool perfect;                                 /* 是否找到无冲突种子 */
+    uint32_t seed;
+    uint64_t length_mask;                         /* 第 n 位表示存在长度为 n 的关键字 */
+    uint8_t slots[CN_KEYWORD_HASH_SIZE];          /* 关键字下标 + 1，0 表示空槽 */
+    uint8_t lengths[sizeof(g_keywords) / sizeof(g_keywords[0])];
+} CnKeywordHashTable;
+
+static CnKeywordHashTable g_keyword_hash;
+
+static uint32_t keyword_hash(const unsigned char *text, size_t length, uint32_t seed)
 {
-    if (!begin || length == 0) {
-        return CN_TOKEN_INVALID;
+    /* FNV-1a 变体：混合长度、前3字节和后3字节（恰好覆盖一个CJK字符的UTF-8编码） */
+    uint32_t h = 2166136261u ^ seed;
+    size_t head = length < 3 ? length : 3;
+    size_t i;
+
+    h = (h ^ (uint32_t)length) * 16777619u;
+    for (i = 0; i < head; i++) {
+        h = (h ^ text[i]) * 16777619u;
+    }
+    for (i = length - head; i < length; i++) {
+        h = (h ^ text[i]) * 16777619u;
+    }
+    h ^= h >> 15;
+    return h & (CN_KEYWORD_HASH_SIZE - 1u);
+}
+
+static bool keyword_hash_try_seed(CnKeywordHashTable *table, uint32_t seed)
+{
+    size_t count = sizeof(g_keywords) / sizeof(g_keywords[0]);
+    size_t i;
+
+    memset(table->slots, 0, sizeof(table->slots));
+    for (i = 0; i < count; i++) {
+        uint32_t slot = keyword_hash((const unsigned char *)g_keywords[i].text,
+                                     table->lengths[i], seed);
+        if (table->slots[slot] != 0) {
+            return false;
+        }
+        table->slots[slot] = (uint8_t)(i + 1);
+    }
+    return true;
+}
+
+static void keyword_hash_build(void)
+{
+    CnKeywordHashTable table;
+    size_t count = sizeof(g_keywords) / sizeof(g_keywords[0]);
+    uint32_t seed;
+    size_t i;
+
+    memset(&table, 0, sizeof(table));
+    for (i = 0; i < count; i++) {
+        size_t len = strlen(g_keywords[i].text);
+        table.lengths[i] = (uint8_t)len;
+        if (len <= CN_KEYWORD_MAX_LENGTH) {
+            table.length_mask |= (uint64_t)1 << len;
+        }
+    }
+
+    /* 搜索结果只与 g_keywords 内容有关，因此每次构建得到的表完全相同 */
+    for (seed = 0; seed < 100000u; seed++) {
+        if (keyword_hash_try_seed(&table, seed)) {
+            table.seed = seed;
+            table.perfect = true;
+            break;
+        }
     }
 
-    // 遍历关键字表进行匹配
+    table.initialized = true;
+    g_keyword_hash = table;
+}
+
+static CnTokenKind keyword_lookup_linear(const char *begin, size_t length)
+{
+    // 遍历关键字表进行匹配（完美哈希构建失败时的后备路径）
     size_t count = sizeof(g_keywords) / sizeof(g_keywords[0]);
     for (size_t i = 0; i < count; i++) {
-        size_t keyword_len = strlen(g_keywords[i].text);
+        size_t keyword_len = g_keyword_hash.lengths[i];
         if (length == keyword_len && 
             memcmp(begin, g_keywords[i].text, length) == 0) {
             return g_keywords[i].kind;
@@ -92,3 +178,40 @@ CnTokenKind cn_frontend_lookup_keyword(const char *begin, size_t length)
 
     return CN_TOKEN_INVALID;
 }
+
+CnTokenKind cn_frontend_lookup_keyword(const char *begin, size_t length)
+{
+    uint8_t entry;
+
+    if (!begin || length == 0) {
+        return CN_TOKEN_INVALID;
+    }
+
+    if (!g_keyword_hash.initialized) {
+        keyword_hash_build();
+    }
+
+    // 长度位图快速拒绝
+    if (length > CN_KEYWORD_MAX_LENGTH ||
+        (g_keyword_hash.length_mask & ((uint64_t)1 << length)) == 0) {
+        return CN_TOKEN_INVALID;
+    }
+
+    if (!g_keyword_hash.perfect) {
+        return keyword_lookup_linear(begin, length);
+    }
+
+    entry = g_keyword_hash.slots[keyword_hash((const unsigned char *)begin, length,
+                                              g_keyword_hash.seed)];
+    if (entry == 0) {
+        return CN_TOKEN_INVALID;
+    }
+
+    entry -= 1;
+    if (g_keyword_hash.lengths[entry] != length ||
+        memcmp(begin, g_keywords[entry].text, length) != 0) {
+        return CN_TOKEN_INVALID;
+    }
+
+    return g_keywords[entry].kind;
+}
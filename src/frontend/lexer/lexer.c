@@ -3,9 +3,38 @@
 #include "cnlang/support/diagnostics.h"
 
 #include <ctype.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/*
+ * 空白、注释和字符串扫描的 SIMD 快速路径
+ *
+ * x86-64 上 SSE2 总是可用；AVX2 在运行时通过 CPUID 检测后启用。
+ * 其他平台使用标量实现。所有实现返回完全相同的结果。
+ */
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define CN_LEXER_HAVE_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define CN_LEXER_HAVE_AVX2 1
+#define CN_LEXER_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+#define CN_LEXER_HAVE_AVX2 1
+#define CN_LEXER_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
 static char current_char(const CnLexer *lexer)
 {
     if (lexer->offset >= lexer->length) {
@@ -35,6 +64,10 @@ static void advance(CnLexer *lexer)
     c = lexer->source[lexer->offset];
     lexer->offset += 1;
 
+    if (!lexer->track_positions) {
+        return;
+    }
+
     if (c == '\n') {
         lexer->line += 1;
         lexer->column = 1;
@@ -43,15 +76,263 @@ static void advance(CnLexer *lexer)
     }
 }
 
-static void skip_whitespace(CnLexer *lexer)
+// 一次前进到 target，并按跳过的字节更新行列号（与逐字节 advance 结果一致）
+static void advance_to(CnLexer *lexer, size_t target)
 {
-    char c;
+    if (target > lexer->length) {
+        target = lexer->length;
+    }
+    if (target <= lexer->offset) {
+        return;
+    }
 
-    c = current_char(lexer);
-    while (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
-        advance(lexer);
-        c = current_char(lexer);
+    if (lexer->track_positions) {
+        const char *p = lexer->source + lexer->offset;
+        const char *end = lexer->source + target;
+        const char *last_newline = NULL;
+
+        while ((p = (const char *)memchr(p, '\n', (size_t)(end - p))) != NULL) {
+            lexer->line += 1;
+            last_newline = p;
+            p++;
+        }
+
+        if (last_newline) {
+            lexer->column = (int)(end - last_newline);
+        } else {
+            lexer->column += (int)(target - lexer->offset);
+        }
+    }
+
+    lexer->offset = target;
+}
+
+/* ==================== 扫描实现 ==================== */
+
+static int is_lex_whitespace(unsigned char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static size_t scan_whitespace_scalar(const char *s, size_t pos, size_t len)
+{
+    while (pos < len && is_lex_whitespace((unsigned char)s[pos])) {
+        pos++;
+    }
+    return pos;
+}
+
+// 查找第一个等于 a、b 或 c 的字节，找不到时返回 len
+static size_t scan_any3_scalar(const char *s, size_t pos, size_t len, char a, char b, char c)
+{
+    while (pos < len) {
+        char ch = s[pos];
+        if (ch == a || ch == b || ch == c) {
+            return pos;
+        }
+        pos++;
     }
+    return len;
+}
+
+#if defined(CN_LEXER_HAVE_SSE2)
+static int lowest_set_bit(unsigned int mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+static size_t scan_whitespace_sse2(const char *s, size_t pos, size_t len)
+{
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+
+    while (pos + 16 <= len) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(s + pos));
+        __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab)),
+                                  _mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, lf)));
+        unsigned int mask = (~(unsigned int)_mm_movemask_epi8(ws)) & 0xFFFFu;
+        if (mask != 0) {
+            return pos + (size_t)lowest_set_bit(mask);
+        }
+        pos += 16;
+    }
+    return scan_whitespace_scalar(s, pos, len);
+}
+
+static size_t scan_any3_sse2(const char *s, size_t pos, size_t len, char a, char b, char c)
+{
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    const __m128i vc = _mm_set1_epi8(c);
+
+    while (pos + 16 <= len) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(s + pos));
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)),
+                                   _mm_cmpeq_epi8(v, vc));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(hit);
+        if (mask != 0) {
+            return pos + (size_t)lowest_set_bit(mask);
+        }
+        pos += 16;
+    }
+    return scan_any3_scalar(s, pos, len, a, b, c);
+}
+#endif
+
+#if defined(CN_LEXER_HAVE_AVX2)
+CN_LEXER_TARGET_AVX2
+static size_t scan_whitespace_avx2(const char *s, size_t pos, size_t len)
+{
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+
+    while (pos + 32 <= len) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(s + pos));
+        __m256i ws = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, tab)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, cr), _mm256_cmpeq_epi8(v, lf)));
+        unsigned int mask = ~(unsigned int)_mm256_movemask_epi8(ws);
+        if (mask != 0) {
+            return pos + (size_t)lowest_set_bit(mask);
+        }
+        pos += 32;
+    }
+    return scan_whitespace_sse2(s, pos, len);
+}
+
+CN_LEXER_TARGET_AVX2
+static size_t scan_any3_avx2(const char *s, size_t pos, size_t len, char a, char b, char c)
+{
+    const __m256i va = _mm256_set1_epi8(a);
+    const __m256i vb = _mm256_set1_epi8(b);
+    const __m256i vc = _mm256_set1_epi8(c);
+
+    while (pos + 32 <= len) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(s + pos));
+        __m256i hit = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, va), _mm256_cmpeq_epi8(v, vb)),
+            _mm256_cmpeq_epi8(v, vc));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(hit);
+        if (mask != 0) {
+            return pos + (size_t)lowest_set_bit(mask);
+        }
+        pos += 32;
+    }
+    return scan_any3_sse2(s, pos, len, a, b, c);
+}
+
+static int cpu_supports_avx2(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return 0;
+    }
+    __cpuid(info, 1);
+    // OSXSAVE + AVX，且操作系统已启用 YMM 状态保存
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 ||
+        (_xgetbv(0) & 0x6) != 0x6) {
+        return 0;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+typedef struct CnLexScanOps {
+    CnLexerScanLevel level;
+    size_t (*skip_whitespace)(const char *s, size_t pos, size_t len);
+    size_t (*find_any3)(const char *s, size_t pos, size_t len, char a, char b, char c);
+} CnLexScanOps;
+
+static CnLexScanOps g_scan_ops = {
+    CN_LEXER_SCAN_SCALAR, scan_whitespace_scalar, scan_any3_scalar
+};
+static int g_scan_ops_selected = 0;
+
+static CnLexerScanLevel detect_scan_level(void)
+{
+#if defined(CN_LEXER_HAVE_AVX2)
+    if (cpu_supports_avx2()) {
+        return CN_LEXER_SCAN_AVX2;
+    }
+#endif
+#if defined(CN_LEXER_HAVE_SSE2)
+    return CN_LEXER_SCAN_SSE2;
+#else
+    return CN_LEXER_SCAN_SCALAR;
+#endif
+}
+
+static void select_scan_ops(CnLexerScanLevel level)
+{
+    CnLexerScanLevel supported = detect_scan_level();
+    if (level > supported) {
+        level = supported;
+    }
+
+    switch (level) {
+#if defined(CN_LEXER_HAVE_AVX2)
+    case CN_LEXER_SCAN_AVX2:
+        g_scan_ops.skip_whitespace = scan_whitespace_avx2;
+        g_scan_ops.find_any3 = scan_any3_avx2;
+        break;
+#endif
+#if defined(CN_LEXER_HAVE_SSE2)
+    case CN_LEXER_SCAN_SSE2:
+        g_scan_ops.skip_whitespace = scan_whitespace_sse2;
+        g_scan_ops.find_any3 = scan_any3_sse2;
+        break;
+#endif
+    default:
+        level = CN_LEXER_SCAN_SCALAR;
+        g_scan_ops.skip_whitespace = scan_whitespace_scalar;
+        g_scan_ops.find_any3 = scan_any3_scalar;
+        break;
+    }
+
+    g_scan_ops.level = level;
+    g_scan_ops_selected = 1;
+}
+
+CnLexerScanLevel cn_frontend_lexer_scan_level(void)
+{
+    if (!g_scan_ops_selected) {
+        select_scan_ops(CN_LEXER_SCAN_AVX2);
+    }
+    return g_scan_ops.level;
+}
+
+CnLexerScanLevel cn_frontend_lexer_set_scan_level(CnLexerScanLevel level)
+{
+    select_scan_ops(level);
+    return g_scan_ops.level;
+}
+
+static void skip_whitespace(CnLexer *lexer)
+{
+    // 大多数词元之间只有一个空格或没有空白，先做标量判断
+    if (lexer->offset >= lexer->length ||
+        !is_lex_whitespace((unsigned char)lexer->source[lexer->offset])) {
+        return;
+    }
+
+    advance_to(lexer, g_scan_ops.skip_whitespace(lexer->source, lexer->offset + 1, lexer->length));
 }
 
 // 处理科学计数法的指数部分：e[+|-]digits
@@ -140,18 +421,62 @@ static int scan_number_suffix(CnLexer *lexer)
     return 0;  // 无后缀
 }
 
+// UTF-8 BOM: 0xEF 0xBB 0xBF
+static bool has_utf8_bom(const char *source, size_t length)
+{
+    return length >= 3 &&
+           (unsigned char)source[0] == 0xEF &&
+           (unsigned char)source[1] == 0xBB &&
+           (unsigned char)source[2] == 0xBF;
+}
+
+// 获取当前行列号；关闭逐字节跟踪时从上次查询位置向后扫描计算（仅错误路径使用）
+static void current_position(CnLexer *lexer, int *out_line, int *out_column)
+{
+    size_t i;
+
+    if (lexer->track_positions) {
+        *out_line = lexer->line;
+        *out_column = lexer->column;
+        return;
+    }
+
+    if (lexer->offset < lexer->position_hint_offset) {
+        /* 回退到缓存位置之前（罕见），从文件开头重新计算 */
+        size_t base = has_utf8_bom(lexer->source, lexer->length) ? 3 : 0;
+        lexer->position_hint_offset = base;
+        lexer->position_hint_line_start = base;
+        lexer->position_hint_line = 1;
+    }
+
+    for (i = lexer->position_hint_offset; i < lexer->offset; i++) {
+        if (lexer->source[i] == '\n') {
+            lexer->position_hint_line += 1;
+            lexer->position_hint_line_start = i + 1;
+        }
+    }
+    lexer->position_hint_offset = lexer->offset;
+
+    *out_line = lexer->position_hint_line;
+    *out_column = (int)(lexer->offset - lexer->position_hint_line_start) + 1;
+}
+
 static void report_lex_error(CnLexer *lexer, CnDiagCode code, const char *message)
 {
+    int line;
+    int column;
+
     if (!lexer || !lexer->diagnostics) {
         return;
     }
 
+    current_position(lexer, &line, &column);
     cn_support_diagnostics_report(lexer->diagnostics,
                                   CN_DIAG_SEVERITY_ERROR,
                                   code,
                                   lexer->filename,
-                                  lexer->line,
-                                  lexer->column,
+                                  line,
+                                  column,
                                   message);
 }
 
@@ -201,14 +526,20 @@ void cn_frontend_lexer_init(CnLexer *lexer, const char *source, size_t length, c
     lexer->line = 1;
     lexer->column = 1;
     lexer->diagnostics = NULL;
+    lexer->track_positions = true;
+    if (!g_scan_ops_selected) {
+        select_scan_ops(CN_LEXER_SCAN_AVX2);
+    }
+    lexer->position_hint_offset = 0;
+    lexer->position_hint_line_start = 0;
+    lexer->position_hint_line = 1;
     
     // 跳过UTF-8 BOM（如果存在）
     // UTF-8 BOM: 0xEF 0xBB 0xBF
-    if (length >= 3 &&
-        (unsigned char)source[0] == 0xEF &&
-        (unsigned char)source[1] == 0xBB &&
-        (unsigned char)source[2] == 0xBF) {
+    if (has_utf8_bom(source, length)) {
         lexer->offset = 3;  // 跳过BOM的3个字节
+        lexer->position_hint_offset = 3;
+        lexer->position_hint_line_start = 3;
     }
 }
 
@@ -237,12 +568,10 @@ bool cn_frontend_lexer_next_token(CnLexer *lexer, CnToken *out_token)
     for (;;) {
         c = current_char(lexer);
         
-        // 单行注释处理：// 注释内容
+        // 单行注释处理：// 注释内容（整段跳到行尾）
         if (c == '/' && peek_char(lexer) == '/') {
-            while (c != '\n' && c != '\0') {
-                advance(lexer);
-                c = current_char(lexer);
-            }
+            advance_to(lexer, g_scan_ops.find_any3(lexer->source, lexer->offset, lexer->length,
+                                                   '\n', '\0', '\0'));
             skip_whitespace(lexer);
             continue;
         }
@@ -253,9 +582,15 @@ bool cn_frontend_lexer_next_token(CnLexer *lexer, CnToken *out_token)
             advance(lexer);  // 跳过 '*'
             c = current_char(lexer);
             
-            // 查找块注释结束标记 */
+            // 查找块注释结束标记 */：每次跳到下一个 '*'
             while (c != '\0') {
-                if (c == '*' && peek_char(lexer) == '/') {
+                advance_to(lexer, g_scan_ops.find_any3(lexer->source, lexer->offset, lexer->length,
+                                                       '*', '\0', '\0'));
+                c = current_char(lexer);
+                if (c == '\0') {
+                    break;
+                }
+                if (peek_char(lexer) == '/') {
                     advance(lexer);  // 跳过 '*'
                     advance(lexer);  // 跳过 '/'
                     break;
@@ -289,22 +624,26 @@ bool cn_frontend_lexer_next_token(CnLexer *lexer, CnToken *out_token)
         out_token->lexeme_length = 0;
         out_token->line = start_line;
         out_token->column = start_column;
+        out_token->number_suffix = 0;
         return true;
     }
         
     if (c == '"') {
         advance(lexer);
-        c = current_char(lexer);
-        while (c != '"' && c != '\0') {
-            if (c == '\\') {
-                advance(lexer);
-                c = current_char(lexer);
-                if (c == '\0') {
-                    break;
-                }
+        // 每次跳到下一个引号、反斜杠或 NUL
+        for (;;) {
+            advance_to(lexer, g_scan_ops.find_any3(lexer->source, lexer->offset, lexer->length,
+                                                   '"', '\\', '\0'));
+            c = current_char(lexer);
+            if (c != '\\') {
+                break;
             }
             advance(lexer);
             c = current_char(lexer);
+            if (c == '\0') {
+                break;
+            }
+            advance(lexer);
         }
     
         if (c == '"') {
@@ -665,13 +1004,16 @@ bool cn_frontend_lexer_next_token(CnLexer *lexer, CnToken *out_token)
             {
                 char error_msg[256];
                 unsigned char invalid_ch = (unsigned char)c;
+                int error_line;
+                int error_column;
+                current_position(lexer, &error_line, &error_column);
                 if (invalid_ch == '#') {
                     snprintf(error_msg, sizeof(error_msg), 
                             "意外的预处理指令符 '#' (行 %d:列 %d，这可能表示预处理器未正确处理该指令)", 
-                            lexer->line, lexer->column);
+                            error_line, error_column);
                 } else if (invalid_ch >= 32 && invalid_ch < 127) {
                     snprintf(error_msg, sizeof(error_msg), "非法字符 '%c' (ASCII: %d, 行 %d:列 %d)", 
-                            invalid_ch, invalid_ch, lexer->line, lexer->column);
+                            invalid_ch, invalid_ch, error_line, error_column);
                 } else if (invalid_ch >= 0x80) {
                     /* UTF-8 多字节字符的开始 */
                     size_t remaining = lexer->length - lexer->offset;
@@ -685,10 +1027,10 @@ bool cn_frontend_lexer_next_token(CnLexer *lexer, CnToken *out_token)
                         sprintf(utf8_bytes + i*5, "0x%02X ", (unsigned char)lexer->source[lexer->offset + i]);
                     }
                     snprintf(error_msg, sizeof(error_msg), "非法UTF-8字符 [%s] (行 %d:列 %d)", 
-                            utf8_bytes, lexer->line, lexer->column);
+                            utf8_bytes, error_line, error_column);
                 } else {
                     snprintf(error_msg, sizeof(error_msg), "非法字符 0x%02X (行 %d:列 %d)", 
-                            invalid_ch, lexer->line, lexer->column);
+                            invalid_ch, error_line, error_column);
                 }
                 report_lex_error(lexer, CN_DIAG_CODE_LEX_INVALID_CHAR, error_msg);
             }
@@ -709,3 +1051,610 @@ bool cn_frontend_lexer_next_token(CnLexer *lexer, CnToken *out_token)
 
     return true;
 }
+
+/* ==================== 整文件预词法化词元流 ==================== */
+
+static bool token_stream_reserve(CnTokenStream *stream, size_t needed)
+{
+    size_t new_capacity;
+    uint8_t *kinds;
+    uint32_t *offsets;
+    uint32_t *lengths;
+    uint8_t *suffixes;
+
+    if (needed <= stream->capacity) {
+        return true;
+    }
+
+    new_capacity = stream->capacity == 0 ? 256 : stream->capacity * 2;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+
+    kinds = (uint8_t *)realloc(stream->kinds, new_capacity * sizeof(uint8_t));
+    if (!kinds) {
+        return false;
+    }
+    stream->kinds = kinds;
+
+    offsets = (uint32_t *)realloc(stream->offsets, new_capacity * sizeof(uint32_t));
+    if (!offsets) {
+        return false;
+    }
+    stream->offsets = offsets;
+
+    lengths = (uint32_t *)realloc(stream->lengths, new_capacity * sizeof(uint32_t));
+    if (!lengths) {
+        return false;
+    }
+    stream->lengths = lengths;
+
+    suffixes = (uint8_t *)realloc(stream->suffixes, new_capacity * sizeof(uint8_t));
+    if (!suffixes) {
+        return false;
+    }
+    stream->suffixes = suffixes;
+
+    stream->capacity = new_capacity;
+    return true;
+}
+
+bool cn_frontend_token_stream_build(CnTokenStream *stream, const char *source, size_t length,
+                                    const char *filename, struct CnDiagnostics *diagnostics)
+{
+    CnLexer lexer;
+    CnToken token;
+
+    if (!stream) {
+        return false;
+    }
+
+    memset(stream, 0, sizeof(*stream));
+    stream->source = source;
+    stream->filename = filename;
+    stream->length = length;
+
+    // 偏移与长度使用32位存储
+    if (!source || length > UINT32_MAX) {
+        return false;
+    }
+
+    // 预估词元数量：平均每4字节一个词元
+    if (!token_stream_reserve(stream, length / 4 + 16)) {
+        cn_frontend_token_stream_free(stream);
+        return false;
+    }
+
+    cn_frontend_lexer_init(&lexer, source, length, filename);
+    cn_frontend_lexer_set_diagnostics(&lexer, diagnostics);
+    lexer.track_positions = false;
+
+    for (;;) {
+        if (!cn_frontend_lexer_next_token(&lexer, &token)) {
+            token.kind = CN_TOKEN_EOF;
+            token.lexeme_begin = source + lexer.offset;
+            token.lexeme_length = 0;
+            token.number_suffix = 0;
+        }
+
+        if (!token_stream_reserve(stream, stream->count + 1)) {
+            cn_frontend_token_stream_free(stream);
+            return false;
+        }
+
+        stream->kinds[stream->count] = (uint8_t)token.kind;
+        stream->offsets[stream->count] = (uint32_t)(token.lexeme_begin - source);
+        stream->lengths[stream->count] = (uint32_t)token.lexeme_length;
+        stream->suffixes[stream->count] = (uint8_t)token.number_suffix;
+        stream->count++;
+
+        if (token.kind == CN_TOKEN_EOF) {
+            break;
+        }
+    }
+
+    return true;
+}
+
+void cn_frontend_token_stream_free(CnTokenStream *stream)
+{
+    if (!stream) {
+        return;
+    }
+
+    free(stream->kinds);
+    free(stream->offsets);
+    free(stream->lengths);
+    free(stream->suffixes);
+    free(stream->line_starts);
+    stream->kinds = NULL;
+    stream->offsets = NULL;
+    stream->lengths = NULL;
+    stream->suffixes = NULL;
+    stream->line_starts = NULL;
+    stream->count = 0;
+    stream->capacity = 0;
+    stream->line_count = 0;
+    stream->line_cursor = 0;
+}
+
+/* ==================== 推测式并行词法分析 ==================== */
+
+#define CN_LEX_NO_ERROR ((size_t)-1)
+
+// 一个分块的词法分析结果
+typedef struct CnLexChunk {
+    const char *source;
+    size_t length;
+    const char *filename;
+    size_t end;                 // 块结束偏移（下一块的起始行首）
+    size_t start;               // 开始词法分析的偏移（推测时为块起始行首）
+    CnTokenStream tokens;       // 起始于 [start, end) 的词元
+    size_t error_index;         // 第一个报告词法错误的词元下标
+    uint32_t next_offset;       // 越过块尾的第一个词元（探测词元）的起始偏移
+    uint32_t next_length;
+    uint8_t next_suffix;
+    bool next_is_eof;           // 探测词元为 EOF（含缓冲区中的 NUL 字节）
+    bool next_error;            // 产生探测词元时报告了词法错误
+    bool ok;                    // 内存分配成功
+} CnLexChunk;
+
+// 从 chunk->start 开始分析，直到第一个起始于块尾之后的词元（或 EOF）
+static void lex_chunk_run(CnLexChunk *chunk)
+{
+    CnLexer lexer;
+    CnToken token;
+    CnDiagnostics diagnostics;
+    size_t reported = 0;
+
+    chunk->tokens.count = 0;
+    chunk->error_index = CN_LEX_NO_ERROR;
+    chunk->next_error = false;
+    chunk->ok = false;
+
+    cn_support_diagnostics_init(&diagnostics);
+    cn_frontend_lexer_init(&lexer, chunk->source, chunk->length, chunk->filename);
+    cn_frontend_lexer_set_diagnostics(&lexer, &diagnostics);
+    lexer.track_positions = false;
+    if (chunk->start > lexer.offset) {
+        lexer.offset = chunk->start;
+    }
+    if (!token_stream_reserve(&chunk->tokens, (chunk->end - lexer.offset) / 4 + 16)) {
+        return;
+    }
+
+    for (;;) {
+        size_t offset;
+        bool error;
+
+        cn_frontend_lexer_next_token(&lexer, &token);
+        offset = (size_t)(token.lexeme_begin - chunk->source);
+        error = diagnostics.count != reported;
+        reported = diagnostics.count;
+
+        if (token.kind == CN_TOKEN_EOF || offset >= chunk->end) {
+            chunk->next_offset = (uint32_t)offset;
+            chunk->next_length = (uint32_t)token.lexeme_length;
+            chunk->next_suffix = (uint8_t)token.number_suffix;
+            chunk->next_is_eof = token.kind == CN_TOKEN_EOF;
+            chunk->next_error = error;
+            break;
+        }
+
+        if (!token_stream_reserve(&chunk->tokens, chunk->tokens.count + 1)) {
+            cn_support_diagnostics_free(&diagnostics);
+            return;
+        }
+        if (error && chunk->error_index == CN_LEX_NO_ERROR) {
+            chunk->error_index = chunk->tokens.count;
+        }
+        chunk->tokens.kinds[chunk->tokens.count] = (uint8_t)token.kind;
+        chunk->tokens.offsets[chunk->tokens.count] = (uint32_t)offset;
+        chunk->tokens.lengths[chunk->tokens.count] = (uint32_t)token.lexeme_length;
+        chunk->tokens.suffixes[chunk->tokens.count] = (uint8_t)token.number_suffix;
+        chunk->tokens.count++;
+    }
+
+    chunk->ok = true;
+    cn_support_diagnostics_free(&diagnostics);
+}
+
+// 在块的词元中查找起始于 offset 的词元，找不到返回 CN_LEX_NO_ERROR
+static size_t lex_chunk_find(const CnLexChunk *chunk, size_t offset)
+{
+    size_t lo = 0;
+    size_t hi = chunk->tokens.count;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (chunk->tokens.offsets[mid] < offset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo < chunk->tokens.count && chunk->tokens.offsets[lo] == offset) {
+        return lo;
+    }
+    return CN_LEX_NO_ERROR;
+}
+
+#ifdef _WIN32
+typedef HANDLE CnLexThread;
+
+static DWORD WINAPI lex_chunk_thread(LPVOID arg)
+{
+    lex_chunk_run((CnLexChunk *)arg);
+    return 0;
+}
+
+static bool lex_thread_start(CnLexThread *thread, CnLexChunk *chunk)
+{
+    *thread = CreateThread(NULL, 0, lex_chunk_thread, chunk, 0, NULL);
+    return *thread != NULL;
+}
+
+static void lex_thread_join(CnLexThread thread)
+{
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+
+static unsigned lex_cpu_count(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (unsigned)info.dwNumberOfProcessors : 1;
+}
+#else
+typedef pthread_t CnLexThread;
+
+static void *lex_chunk_thread(void *arg)
+{
+    lex_chunk_run((CnLexChunk *)arg);
+    return NULL;
+}
+
+static bool lex_thread_start(CnLexThread *thread, CnLexChunk *chunk)
+{
+    return pthread_create(thread, NULL, lex_chunk_thread, chunk) == 0;
+}
+
+static void lex_thread_join(CnLexThread thread)
+{
+    pthread_join(thread, NULL);
+}
+
+static unsigned lex_cpu_count(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (unsigned)count : 1;
+}
+#endif
+
+void cn_frontend_lexer_parallel_options_default(CnLexerParallelOptions *options)
+{
+    if (!options) {
+        return;
+    }
+
+    options->thread_count = 0;
+    options->min_source_length = CN_LEXER_PARALLEL_MIN_SOURCE;
+    options->min_chunk_length = CN_LEXER_PARALLEL_MIN_CHUNK;
+}
+
+// 将块 [from, count) 的词元追加到词元流
+static bool token_stream_append_chunk(CnTokenStream *stream, const CnLexChunk *chunk, size_t from)
+{
+    size_t n = chunk->tokens.count - from;
+
+    if (!token_stream_reserve(stream, stream->count + n + 1)) {
+        return false;
+    }
+    if (n == 0) {
+        return true;
+    }
+
+    memcpy(stream->kinds + stream->count, chunk->tokens.kinds + from, n * sizeof(uint8_t));
+    memcpy(stream->offsets + stream->count, chunk->tokens.offsets + from, n * sizeof(uint32_t));
+    memcpy(stream->lengths + stream->count, chunk->tokens.lengths + from, n * sizeof(uint32_t));
+    memcpy(stream->suffixes + stream->count, chunk->tokens.suffixes + from, n * sizeof(uint8_t));
+    stream->count += n;
+    return true;
+}
+
+/*
+ * 按顺序校验接缝并拼接。返回 1 表示成功，0 表示内存不足，
+ * -1 表示被采用的区域内有词法错误（调用方退回串行构建）。
+ */
+static int token_stream_stitch(CnTokenStream *stream, CnLexChunk *chunks, size_t chunk_count)
+{
+    size_t expected = 0;
+
+    for (size_t i = 0; i < chunk_count; i++) {
+        CnLexChunk *chunk = &chunks[i];
+        size_t from = 0;
+
+        if (i > 0) {
+            if (expected >= chunk->end) {
+                // 上一个词元（多行字符串或注释之后的词元）越过了整个块
+                continue;
+            }
+            from = lex_chunk_find(chunk, expected);
+            if (from == CN_LEX_NO_ERROR) {
+                // 起始状态猜错（块起点位于字符串或块注释内部），从正确位置重新分析
+                chunk->start = expected;
+                lex_chunk_run(chunk);
+                stream->relexed_chunks++;
+                from = 0;
+            }
+        }
+
+        if (!chunk->ok) {
+            return 0;
+        }
+        if ((chunk->error_index != CN_LEX_NO_ERROR && chunk->error_index >= from) ||
+            chunk->next_error) {
+            return -1;
+        }
+        if (!token_stream_append_chunk(stream, chunk, from)) {
+            return 0;
+        }
+
+        if (chunk->next_is_eof) {
+            stream->kinds[stream->count] = (uint8_t)CN_TOKEN_EOF;
+            stream->offsets[stream->count] = chunk->next_offset;
+            stream->lengths[stream->count] = chunk->next_length;
+            stream->suffixes[stream->count] = chunk->next_suffix;
+            stream->count++;
+            return 1;
+        }
+        expected = chunk->next_offset;
+    }
+
+    // 最后一块的结束偏移为缓冲区末尾，探测词元必为 EOF，不会到达此处
+    return 0;
+}
+
+bool cn_frontend_token_stream_build_parallel(CnTokenStream *stream, const char *source, size_t length,
+                                             const char *filename, struct CnDiagnostics *diagnostics,
+                                             const CnLexerParallelOptions *options)
+{
+    CnLexerParallelOptions defaults;
+    CnLexChunk *chunks;
+    CnLexThread *threads;
+    bool *started;
+    size_t chunk_count;
+    size_t max_chunks;
+    size_t begin;
+    size_t total;
+    unsigned thread_count;
+    int result;
+
+    if (!options) {
+        cn_frontend_lexer_parallel_options_default(&defaults);
+        options = &defaults;
+    }
+
+    thread_count = options->thread_count ? options->thread_count : lex_cpu_count();
+    max_chunks = options->min_chunk_length ? length / options->min_chunk_length : length;
+    if (max_chunks > thread_count) {
+        max_chunks = thread_count;
+    }
+
+    if (!stream || !source || length > UINT32_MAX ||
+        length < options->min_source_length || max_chunks < 2) {
+        return cn_frontend_token_stream_build(stream, source, length, filename, diagnostics);
+    }
+
+    chunks = (CnLexChunk *)calloc(max_chunks, sizeof(CnLexChunk));
+    threads = (CnLexThread *)calloc(max_chunks, sizeof(CnLexThread));
+    started = (bool *)calloc(max_chunks, sizeof(bool));
+    if (!chunks || !threads || !started) {
+        free(chunks);
+        free(threads);
+        free(started);
+        return cn_frontend_token_stream_build(stream, source, length, filename, diagnostics);
+    }
+
+    // 在换行之后切分：名义切分点向后找到的第一个行首作为下一块起点
+    chunk_count = 0;
+    begin = 0;
+    for (size_t split = 1; split <= max_chunks && begin < length; split++) {
+        CnLexChunk *chunk;
+        size_t end = length;
+
+        if (split < max_chunks) {
+            size_t nominal = length / max_chunks * split;
+            const char *nl;
+            if (nominal <= begin) {
+                continue;  // 上一块的行越过了这个名义切分点
+            }
+            // 不早于名义切分点的第一个行首
+            nl = (const char *)memchr(source + nominal - 1, '\n', length - nominal + 1);
+            end = nl ? (size_t)(nl - source) + 1 : length;
+        }
+
+        chunk = &chunks[chunk_count++];
+        chunk->source = source;
+        chunk->length = length;
+        chunk->filename = filename;
+        chunk->start = begin;
+        chunk->end = end;
+        begin = end;
+    }
+
+    memset(stream, 0, sizeof(*stream));
+    stream->source = source;
+    stream->filename = filename;
+    stream->length = length;
+    stream->chunk_count = chunk_count;
+
+    // 关键字哈希表与扫描实现是惰性初始化的全局状态，须在启动线程前准备好
+    (void)cn_frontend_lookup_keyword("如果", strlen("如果"));
+    if (!g_scan_ops_selected) {
+        select_scan_ops(CN_LEXER_SCAN_AVX2);
+    }
+
+    for (size_t i = 1; i < chunk_count; i++) {
+        started[i] = lex_thread_start(&threads[i], &chunks[i]);
+    }
+    lex_chunk_run(&chunks[0]);
+    for (size_t i = 1; i < chunk_count; i++) {
+        if (started[i]) {
+            lex_thread_join(threads[i]);
+        } else {
+            lex_chunk_run(&chunks[i]);
+        }
+    }
+
+    // 按各块推测得到的词元数预留，重新分析的块很少超出这一估计
+    total = 1;
+    for (size_t i = 0; i < chunk_count; i++) {
+        total += chunks[i].tokens.count;
+    }
+    result = token_stream_reserve(stream, total) ?
+             token_stream_stitch(stream, chunks, chunk_count) : 0;
+
+    for (size_t i = 0; i < chunk_count; i++) {
+        cn_frontend_token_stream_free(&chunks[i].tokens);
+    }
+    free(chunks);
+    free(threads);
+    free(started);
+
+    if (result == 1) {
+        return true;
+    }
+
+    cn_frontend_token_stream_free(stream);
+    if (result < 0) {
+        // 错误路径罕见：串行重建以得到与串行路径完全一致的诊断
+        return cn_frontend_token_stream_build(stream, source, length, filename, diagnostics);
+    }
+    return false;
+}
+
+// 构建行首偏移表：第一行从 BOM 之后开始，与逐字节跟踪的列号保持一致
+static bool token_stream_build_lines(CnTokenStream *stream)
+{
+    size_t capacity = 64;
+    size_t count = 0;
+    size_t *starts;
+    const char *p;
+    const char *end;
+
+    starts = (size_t *)malloc(capacity * sizeof(size_t));
+    if (!starts) {
+        return false;
+    }
+
+    starts[count++] = has_utf8_bom(stream->source, stream->length) ? 3 : 0;
+    p = stream->source + starts[0];
+    end = stream->source + stream->length;
+
+    while (p < end) {
+        const char *nl = (const char *)memchr(p, '\n', (size_t)(end - p));
+        if (!nl) {
+            break;
+        }
+        if (count >= capacity) {
+            size_t *new_starts;
+            capacity *= 2;
+            new_starts = (size_t *)realloc(starts, capacity * sizeof(size_t));
+            if (!new_starts) {
+                free(starts);
+                return false;
+            }
+            starts = new_starts;
+        }
+        starts[count++] = (size_t)(nl - stream->source) + 1;
+        p = nl + 1;
+    }
+
+    stream->line_starts = starts;
+    stream->line_count = count;
+    stream->line_cursor = 0;
+    return true;
+}
+
+void cn_frontend_token_stream_position(CnTokenStream *stream, size_t offset,
+                                       int *out_line, int *out_column)
+{
+    size_t line;
+
+    if (out_line) {
+        *out_line = 1;
+    }
+    if (out_column) {
+        *out_column = 1;
+    }
+
+    if (!stream || !stream->source) {
+        return;
+    }
+
+    if (!stream->line_starts && !token_stream_build_lines(stream)) {
+        return;
+    }
+
+    line = stream->line_cursor;
+    if (offset >= stream->line_starts[line] &&
+        (line + 1 >= stream->line_count || offset < stream->line_starts[line + 1])) {
+        // 命中缓存行（解析器顺序访问时的常见情况）
+    } else if (line + 1 < stream->line_count && offset >= stream->line_starts[line + 1] &&
+               (line + 2 >= stream->line_count || offset < stream->line_starts[line + 2])) {
+        line += 1;
+    } else {
+        // 二分查找最后一个不大于 offset 的行首
+        size_t lo = 0;
+        size_t hi = stream->line_count;
+        while (hi - lo > 1) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (stream->line_starts[mid] <= offset) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        line = lo;
+    }
+    stream->line_cursor = line;
+
+    if (out_line) {
+        *out_line = (int)line + 1;
+    }
+    if (out_column) {
+        size_t start = stream->line_starts[line];
+        *out_column = offset >= start ? (int)(offset - start) + 1 : 1;
+    }
+}
+
+void cn_frontend_token_stream_get(CnTokenStream *stream, size_t index, CnToken *out_token)
+{
+    if (!out_token) {
+        return;
+    }
+
+    if (!stream || stream->count == 0) {
+        out_token->kind = CN_TOKEN_EOF;
+        out_token->lexeme_begin = stream ? stream->source : NULL;
+        out_token->lexeme_length = 0;
+        out_token->line = 1;
+        out_token->column = 1;
+        out_token->number_suffix = 0;
+        return;
+    }
+
+    if (index >= stream->count) {
+        index = stream->count - 1;  // 末尾总是 EOF
+    }
+
+    out_token->kind = (CnTokenKind)stream->kinds[index];
+    out_token->lexeme_begin = stream->source + stream->offsets[index];
+    out_token->lexeme_length = stream->lengths[index];
+    out_token->number_suffix = stream->suffixes[index];
+    cn_frontend_token_stream_position(stream, stream->offsets[index],
+                                      &out_token->line, &out_token->column);
+}
@@ -2,6 +2,7 @@
 #include "cnlang/frontend/lexer.h"
 #include "cnlang/frontend/parser.h"
 #include "cnlang/frontend/semantics.h"
+#include "cnlang/frontend/ast/class_node.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -10,13 +11,37 @@ CnLspDocumentAnalysis *cn_lsp_analyze_document(
     const char *source,
     size_t source_length,
     const char *uri)
+{
+    return cn_lsp_analyze_document_with_index(source, source_length, uri, NULL);
+}
+
+// 文本编辑：旧文本中 [offset, offset + removed) 替换为 inserted 字节
+typedef struct CnLspTextEdit {
+    size_t offset;
+    size_t removed;
+    size_t inserted;
+} CnLspTextEdit;
+
+// 增量解析最多连续复用的源码副本数，超过后完整解析一次，释放较早的副本
+#define CN_LSP_MAX_SOURCE_SNAPSHOTS 16
+
+// outline 为 true 时函数体跳读，且不做语义分析
+// previous 非 NULL 时先尝试在其 AST 上按 edit 增量解析，成功则接管该 AST
+static CnLspDocumentAnalysis *analyze_document(
+    const char *source,
+    size_t source_length,
+    const char *uri,
+    const CnLineIndex *line_index,
+    bool outline,
+    CnLspDocumentAnalysis *previous,
+    const CnLspTextEdit *edit)
 {
     if (!source || !uri) {
         return NULL;
     }
 
     // 分配分析结果结构
-    CnLspDocumentAnalysis *analysis = (CnLspDocumentAnalysis *)malloc(sizeof(CnLspDocumentAnalysis));
+    CnLspDocumentAnalysis *analysis = (CnLspDocumentAnalysis *)calloc(1, sizeof(CnLspDocumentAnalysis));
     if (!analysis) {
         return NULL;
     }
@@ -28,30 +53,85 @@ CnLspDocumentAnalysis *cn_lsp_analyze_document(
     analysis->source = source;
     analysis->source_length = source_length;
 
+    // 行首索引：优先复用文档管理器随编辑增量维护的索引
+    if (line_index) {
+        analysis->line_index = line_index;
+    } else {
+        if (!cn_line_index_init(&analysis->owned_line_index, source, source_length)) {
+            free(analysis);
+            return NULL;
+        }
+        analysis->line_index = &analysis->owned_line_index;
+    }
+
     // 初始化诊断系统
     CnDiagnostics diagnostics;
     cn_support_diagnostics_init(&diagnostics);
 
-    // 词法分析
-    CnLexer lexer;
-    cn_frontend_lexer_init(&lexer, source, source_length, uri);
-    cn_frontend_lexer_set_diagnostics(&lexer, &diagnostics);
+    // AST 中的名称直接指向词元所在的文本，而文档文本随编辑原地修改；
+    // 完整分析时在副本上词法分析，增量解析复用的声明继续引用其所在的旧副本
+    const char *lex_source = source;
+    char *snapshot = NULL;
+    if (!outline) {
+        size_t reserve = (previous ? previous->snapshot_count : 0) + 1;
+        snapshot = (char *)malloc(source_length + 1);
+        analysis->source_snapshots = (char **)malloc(reserve * sizeof(char *));
+        if (!snapshot || !analysis->source_snapshots) {
+            free(snapshot);
+            cn_support_diagnostics_free(&diagnostics);
+            cn_lsp_free_analysis(analysis);
+            return NULL;
+        }
+        memcpy(snapshot, source, source_length);
+        snapshot[source_length] = '\0';
+        analysis->source_snapshots[0] = snapshot;
+        analysis->snapshot_count = 1;
+        lex_source = snapshot;
+    }
+
+    // 词法分析：整文件预词法化，词元流保留在分析结果中供后续请求使用
+    if (!cn_frontend_token_stream_build(&analysis->tokens, lex_source, source_length, uri, &diagnostics)) {
+        cn_support_diagnostics_free(&diagnostics);
+        cn_lsp_free_analysis(analysis);
+        return NULL;
+    }
 
     // 语法分析
-    CnParser *parser = cn_frontend_parser_new(&lexer);
+    CnParser *parser = cn_frontend_parser_new_from_stream(&analysis->tokens);
     if (!parser) {
         cn_support_diagnostics_free(&diagnostics);
-        free(analysis);
+        cn_lsp_free_analysis(analysis);
         return NULL;
     }
     cn_frontend_parser_set_diagnostics(parser, &diagnostics);
+    cn_frontend_parser_set_skim_bodies(parser, outline);
+    cn_frontend_parser_set_item_list(parser, &analysis->items);
 
     CnAstProgram *program = NULL;
-    cn_frontend_parse_program(parser, &program);
+    if (previous && edit && snapshot && previous->snapshot_count < CN_LSP_MAX_SOURCE_SNAPSHOTS &&
+        cn_frontend_parse_program_incremental(parser, previous->program, &previous->items,
+                                              edit->offset, edit->removed, edit->inserted)) {
+        // 接管上次的 AST 与声明区间，清除上次语义分析写入的信息
+        program = previous->program;
+        previous->program = NULL;
+        analysis->items = previous->items;
+        memset(&previous->items, 0, sizeof(previous->items));
+        memcpy(analysis->source_snapshots + 1, previous->source_snapshots,
+               previous->snapshot_count * sizeof(char *));
+        analysis->snapshot_count += previous->snapshot_count;
+        previous->snapshot_count = 0;
+        cn_frontend_ast_program_reset_semantics(program);
+    } else {
+        cn_frontend_parse_program(parser, &program);
+    }
     analysis->program = program;
+    if (outline) {
+        // 大纲分析的声明区间只用于文档符号；函数体尚未解析，不作为增量解析的基础
+        analysis->items.reusable = false;
+    }
 
     // 语义分析（如果解析成功）
-    if (program && cn_support_diagnostics_error_count(&diagnostics) == 0) {
+    if (!outline && program && cn_support_diagnostics_error_count(&diagnostics) == 0) {
         CnSemScope *global_scope = cn_sem_build_scopes(program, &diagnostics);
         if (global_scope) {
             cn_sem_resolve_names(global_scope, program, &diagnostics);
@@ -61,7 +141,7 @@ CnLspDocumentAnalysis *cn_lsp_analyze_document(
     }
 
     // 转换诊断信息
-    cn_lsp_convert_diagnostics(&diagnostics, &analysis->diagnostics, &analysis->diagnostic_count);
+    cn_lsp_convert_diagnostics(&diagnostics, analysis, &analysis->diagnostics, &analysis->diagnostic_count);
 
     // 清理
     cn_frontend_parser_free(parser);
@@ -70,6 +150,45 @@ CnLspDocumentAnalysis *cn_lsp_analyze_document(
     return analysis;
 }
 
+// 使用调用方维护的行首索引分析文档
+CnLspDocumentAnalysis *cn_lsp_analyze_document_with_index(
+    const char *source,
+    size_t source_length,
+    const char *uri,
+    const CnLineIndex *line_index)
+{
+    return analyze_document(source, source_length, uri, line_index, false, NULL, NULL);
+}
+
+// 大纲分析：函数体跳读，不做语义分析
+CnLspDocumentAnalysis *cn_lsp_analyze_document_outline(
+    const char *source,
+    size_t source_length,
+    const char *uri,
+    const CnLineIndex *line_index)
+{
+    return analyze_document(source, source_length, uri, line_index, true, NULL, NULL);
+}
+
+// 编辑后重新分析：复用未受编辑影响的顶层声明
+CnLspDocumentAnalysis *cn_lsp_reanalyze_document(
+    CnLspDocumentAnalysis *previous,
+    const char *source,
+    size_t source_length,
+    const char *uri,
+    const CnLineIndex *line_index,
+    size_t edit_offset,
+    size_t removed_length,
+    size_t inserted_length)
+{
+    CnLspTextEdit edit = {edit_offset, removed_length, inserted_length};
+    CnLspDocumentAnalysis *analysis = analyze_document(source, source_length, uri, line_index, false,
+                                                       previous, &edit);
+
+    cn_lsp_free_analysis(previous);
+    return analysis;
+}
+
 // 释放分析结果
 void cn_lsp_free_analysis(CnLspDocumentAnalysis *analysis)
 {
@@ -86,64 +205,132 @@ void cn_lsp_free_analysis(CnLspDocumentAnalysis *analysis)
     }
 
     if (analysis->diagnostics) {
-        // 释放每条诊断的消息字符串（如果是动态分配的）
+        // 释放每条诊断的消息字符串（source 是静态字符串，不需要释放）
         for (size_t i = 0; i < analysis->diagnostic_count; i++) {
-            // message 和 source 是静态字符串，不需要释放
+            free((char *)analysis->diagnostics[i].message);
         }
         free(analysis->diagnostics);
     }
 
+    cn_frontend_token_stream_free(&analysis->tokens);
+    cn_frontend_parse_item_list_free(&analysis->items);
+    for (size_t i = 0; i < analysis->snapshot_count; i++) {
+        free(analysis->source_snapshots[i]);
+    }
+    free(analysis->source_snapshots);
+    cn_line_index_free(&analysis->owned_line_index);
     free(analysis);
 }
 
-// 查找指定位置的符号定义
-bool cn_lsp_find_definition(
-    CnLspDocumentAnalysis *analysis,
+bool cn_lsp_position_to_offset(
+    const CnLspDocumentAnalysis *analysis,
     CnLspPosition position,
-    CnLspSymbolInfo *out_symbol)
+    size_t *out_offset)
 {
-    if (!analysis || !analysis->source || !out_symbol) {
+    if (!analysis || !analysis->line_index || !out_offset || position.line < 0 ||
+        (size_t)position.line >= analysis->line_index->line_count) {
         return false;
     }
 
-    CnLexer lexer;
-    cn_frontend_lexer_init(&lexer, analysis->source, analysis->source_length, "<lsp>");
+    *out_offset = cn_line_index_offset_from_utf16(
+        analysis->line_index, analysis->source, (size_t)position.line,
+        position.column > 0 ? (size_t)position.column : 0);
+    return true;
+}
 
-    CnToken token;
-    CnToken ident_token;
-    int found = 0;
+CnLspPosition cn_lsp_offset_to_position(
+    const CnLspDocumentAnalysis *analysis,
+    size_t offset)
+{
+    CnLspPosition position = {0, 0};
 
-    while (cn_frontend_lexer_next_token(&lexer, &token)) {
-        if (token.kind == CN_TOKEN_EOF) {
-            break;
-        }
+    if (!analysis || !analysis->line_index) {
+        return position;
+    }
 
-        int line0 = (token.line > 0) ? token.line - 1 : 0;
-        int col0 = (token.column > 0) ? token.column - 1 : 0;
-        int col1 = col0 + (int)token.lexeme_length;
+    CnTextPosition text_position = cn_line_index_position(analysis->line_index, analysis->source, offset);
+    position.line = (int)text_position.line;
+    position.column = (int)text_position.utf16_column;
+    return position;
+}
 
-        if (position.line == line0 && position.column >= col0 && position.column < col1) {
-            if (token.kind != CN_TOKEN_IDENT) {
-                return false;
-            }
-            ident_token = token;
-            found = 1;
-            break;
+// 二分查找覆盖字节偏移 offset 的词元下标，找不到返回 false
+static bool find_token_at(const CnLspDocumentAnalysis *analysis, size_t offset, size_t *out_index)
+{
+    const CnTokenStream *tokens = &analysis->tokens;
+    size_t lo = 0;
+    size_t hi = tokens->count;
+
+    // 最后一个起始偏移不大于 offset 的词元
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (tokens->offsets[mid] <= offset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
     }
+    if (lo == 0) {
+        return false;
+    }
+    lo -= 1;
+
+    if (offset >= (size_t)tokens->offsets[lo] + tokens->lengths[lo]) {
+        return false;
+    }
+    *out_index = lo;
+    return true;
+}
+
+// 词元的 LSP 范围（UTF-16 列）
+static CnLspRange token_range(const CnLspDocumentAnalysis *analysis, size_t index)
+{
+    CnLspRange range;
+    size_t begin = analysis->tokens.offsets[index];
+
+    range.start = cn_lsp_offset_to_position(analysis, begin);
+    range.end = cn_lsp_offset_to_position(analysis, begin + analysis->tokens.lengths[index]);
+    return range;
+}
+
+// 光标所在的标识符词元
+static bool find_identifier_at(
+    const CnLspDocumentAnalysis *analysis,
+    CnLspPosition position,
+    size_t *out_index)
+{
+    size_t offset;
+    size_t index;
+
+    if (!cn_lsp_position_to_offset(analysis, position, &offset) ||
+        !find_token_at(analysis, offset, &index) ||
+        analysis->tokens.kinds[index] != CN_TOKEN_IDENT) {
+        return false;
+    }
+    *out_index = index;
+    return true;
+}
+
+// 查找指定位置的符号定义
+bool cn_lsp_find_definition(
+    CnLspDocumentAnalysis *analysis,
+    CnLspPosition position,
+    CnLspSymbolInfo *out_symbol)
+{
+    if (!analysis || !analysis->source || !out_symbol) {
+        return false;
+    }
 
-    if (!found) {
+    size_t index;
+    if (!find_identifier_at(analysis, position, &index)) {
         return false;
     }
 
-    out_symbol->name = ident_token.lexeme_begin;
+    out_symbol->name = analysis->source + analysis->tokens.offsets[index];
+    out_symbol->name_length = analysis->tokens.lengths[index];
     out_symbol->kind = CN_SEM_SYMBOL_VARIABLE;
     out_symbol->type = NULL;
-
-    out_symbol->definition_range.start.line = (ident_token.line > 0) ? ident_token.line - 1 : 0;
-    out_symbol->definition_range.start.column = (ident_token.column > 0) ? ident_token.column - 1 : 0;
-    out_symbol->definition_range.end.line = out_symbol->definition_range.start.line;
-    out_symbol->definition_range.end.column = out_symbol->definition_range.start.column + (int)ident_token.lexeme_length;
+    out_symbol->definition_range = token_range(analysis, index);
 
     return true;
 }
@@ -162,40 +349,17 @@ bool cn_lsp_find_references(
     *out_ranges = NULL;
     *out_count = 0;
 
-    CnLexer lexer;
-    cn_frontend_lexer_init(&lexer, analysis->source, analysis->source_length, "<lsp>");
-
-    CnToken token;
-    CnToken ident_token;
-    int found = 0;
-
-    // 第一次遍历：找到光标所在的标识符
-    while (cn_frontend_lexer_next_token(&lexer, &token)) {
-        if (token.kind == CN_TOKEN_EOF) {
-            break;
-        }
-
-        int line0 = (token.line > 0) ? token.line - 1 : 0;
-        int col0 = (token.column > 0) ? token.column - 1 : 0;
-        int col1 = col0 + (int)token.lexeme_length;
-
-        if (position.line == line0 && position.column >= col0 && position.column < col1) {
-            if (token.kind != CN_TOKEN_IDENT) {
-                return false;
-            }
-            ident_token = token;
-            found = 1;
-            break;
-        }
-    }
-
-    if (!found) {
+    // 光标所在的标识符：按偏移在词元流中二分查找
+    size_t ident_index;
+    if (!find_identifier_at(analysis, position, &ident_index)) {
         return false;
     }
 
-    // 第二次遍历：收集所有同名标识符的位置
-    cn_frontend_lexer_init(&lexer, analysis->source, analysis->source_length, "<lsp>");
+    const CnTokenStream *tokens = &analysis->tokens;
+    const char *name = analysis->source + tokens->offsets[ident_index];
+    uint32_t name_length = tokens->lengths[ident_index];
 
+    // 收集所有同名标识符的位置
     size_t capacity = 4;
     CnLspRange *ranges = (CnLspRange *)malloc(capacity * sizeof(CnLspRange));
     if (!ranges) {
@@ -204,17 +368,12 @@ bool cn_lsp_find_references(
 
     size_t count = 0;
 
-    while (cn_frontend_lexer_next_token(&lexer, &token)) {
-        if (token.kind == CN_TOKEN_EOF) {
-            break;
-        }
-
-        if (token.kind != CN_TOKEN_IDENT) {
+    for (size_t i = 0; i < tokens->count; i++) {
+        if (tokens->kinds[i] != CN_TOKEN_IDENT || tokens->lengths[i] != name_length) {
             continue;
         }
 
-        if (token.lexeme_length == ident_token.lexeme_length &&
-            memcmp(token.lexeme_begin, ident_token.lexeme_begin, ident_token.lexeme_length) == 0) {
+        if (memcmp(analysis->source + tokens->offsets[i], name, name_length) == 0) {
             if (count >= capacity) {
                 capacity *= 2;
                 CnLspRange *new_ranges = (CnLspRange *)realloc(ranges, capacity * sizeof(CnLspRange));
@@ -225,11 +384,7 @@ bool cn_lsp_find_references(
                 ranges = new_ranges;
             }
 
-            CnLspRange *range = &ranges[count++];
-            range->start.line = (token.line > 0) ? token.line - 1 : 0;
-            range->start.column = (token.column > 0) ? token.column - 1 : 0;
-            range->end.line = range->start.line;
-            range->end.column = range->start.column + (int)token.lexeme_length;
+            ranges[count++] = token_range(analysis, i);
         }
     }
 
@@ -243,23 +398,167 @@ bool cn_lsp_find_references(
     return true;
 }
 
-// 获取文档符号列表
+// 顶层声明的名称与符号类别；导入等没有名称的声明返回 false
+static bool parse_item_symbol(const CnParseItem *item, const char **out_name, size_t *out_length,
+                              CnSemSymbolKind *out_kind)
+{
+    const CnAstStmt *stmt = (const CnAstStmt *)item->node;
+    const CnAstFunctionDecl *function = NULL;
+    const CnAstStructDecl *struct_decl = NULL;
+
+    if (!item->node) {
+        return false;
+    }
+
+    switch (item->kind) {
+    case CN_PARSE_ITEM_FUNCTION:
+        function = (const CnAstFunctionDecl *)item->node;
+        break;
+    case CN_PARSE_ITEM_TEMPLATE_FUNC:
+        function = stmt->as.template_func_decl ? stmt->as.template_func_decl->function : NULL;
+        break;
+    case CN_PARSE_ITEM_STRUCT:
+        struct_decl = &stmt->as.struct_decl;
+        break;
+    case CN_PARSE_ITEM_TEMPLATE_STRUCT:
+        struct_decl = stmt->as.template_struct_decl ? stmt->as.template_struct_decl->struct_decl : NULL;
+        break;
+    case CN_PARSE_ITEM_ENUM:
+        *out_name = stmt->as.enum_decl.name;
+        *out_length = stmt->as.enum_decl.name_length;
+        *out_kind = CN_SEM_SYMBOL_ENUM;
+        return *out_name != NULL;
+    case CN_PARSE_ITEM_GLOBAL_VAR:
+        *out_name = stmt->as.var_decl.name;
+        *out_length = stmt->as.var_decl.name_length;
+        *out_kind = CN_SEM_SYMBOL_VARIABLE;
+        return *out_name != NULL;
+    case CN_PARSE_ITEM_CLASS:
+        if (!stmt->as.class_decl) {
+            return false;
+        }
+        *out_name = stmt->as.class_decl->name;
+        *out_length = stmt->as.class_decl->name_length;
+        *out_kind = CN_SEM_SYMBOL_CLASS;
+        return *out_name != NULL;
+    case CN_PARSE_ITEM_INTERFACE:
+        if (!stmt->as.interface_decl) {
+            return false;
+        }
+        *out_name = stmt->as.interface_decl->name;
+        *out_length = stmt->as.interface_decl->name_length;
+        *out_kind = CN_SEM_SYMBOL_CLASS;
+        return *out_name != NULL;
+    default:
+        return false;
+    }
+
+    if (function) {
+        *out_name = function->name;
+        *out_length = function->name_length;
+        *out_kind = CN_SEM_SYMBOL_FUNCTION;
+        return *out_name != NULL;
+    }
+    if (struct_decl) {
+        *out_name = struct_decl->name;
+        *out_length = struct_decl->name_length;
+        *out_kind = CN_SEM_SYMBOL_STRUCT;
+        return *out_name != NULL;
+    }
+    return false;
+}
+
+// 声明区间 [begin, end) 内第一个与名称相同的标识符词元的范围；找不到时取区间起点
+static CnLspRange declaration_name_range(const CnLspDocumentAnalysis *analysis, const CnParseItem *item,
+                                         const char *name, size_t name_length)
+{
+    const CnTokenStream *tokens = &analysis->tokens;
+    size_t lo = 0;
+    size_t hi = tokens->count;
+    CnLspRange range;
+
+    // 第一个起始偏移不小于 begin 的词元
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (tokens->offsets[mid] < item->begin) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    for (; lo < tokens->count && tokens->offsets[lo] < item->end; lo++) {
+        if (tokens->kinds[lo] == CN_TOKEN_IDENT && tokens->lengths[lo] == name_length &&
+            memcmp(analysis->source + tokens->offsets[lo], name, name_length) == 0) {
+            return token_range(analysis, lo);
+        }
+    }
+
+    range.start = cn_lsp_offset_to_position(analysis, item->begin);
+    range.end = range.start;
+    return range;
+}
+
+// 获取文档符号列表：按顶层声明区间逐个取名称
 bool cn_lsp_get_document_symbols(
     CnLspDocumentAnalysis *analysis,
     CnLspSymbolInfo **out_symbols,
     size_t *out_count)
 {
-    // TODO: 实现文档符号列表提取（从 AST 获取所有函数和变量）
-    // 当前为最小原型，暂不实现
-    (void)analysis;
-    (void)out_symbols;
-    (void)out_count;
-    return false;
+    CnLspSymbolInfo *symbols = NULL;
+    size_t count = 0;
+
+    if (!analysis || !analysis->source || !out_symbols || !out_count) {
+        return false;
+    }
+
+    if (analysis->items.count > 0) {
+        symbols = (CnLspSymbolInfo *)malloc(analysis->items.count * sizeof(CnLspSymbolInfo));
+        if (!symbols) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < analysis->items.count; i++) {
+        const CnParseItem *item = &analysis->items.items[i];
+        CnLspSymbolInfo *symbol = &symbols[count];
+
+        if (!parse_item_symbol(item, &symbol->name, &symbol->name_length, &symbol->kind)) {
+            continue;
+        }
+        symbol->definition_range = declaration_name_range(analysis, item, symbol->name, symbol->name_length);
+        symbol->type = NULL;
+        count++;
+    }
+
+    if (count == 0) {
+        free(symbols);
+        symbols = NULL;
+    }
+    *out_symbols = symbols;
+    *out_count = count;
+    return true;
+}
+
+static char *copy_message(const char *message)
+{
+    size_t length;
+    char *copy;
+
+    if (!message) {
+        return NULL;
+    }
+    length = strlen(message);
+    copy = (char *)malloc(length + 1);
+    if (copy) {
+        memcpy(copy, message, length + 1);
+    }
+    return copy;
 }
 
 // 转换诊断信息：CnDiagnostics -> CnLspDiagnostic[]
 void cn_lsp_convert_diagnostics(
     const CnDiagnostics *diagnostics,
+    const CnLspDocumentAnalysis *analysis,
     CnLspDiagnostic **out_diagnostics,
     size_t *out_count)
 {
@@ -291,16 +590,29 @@ void cn_lsp_convert_diagnostics(
             ? CN_LSP_DIAG_ERROR
             : CN_LSP_DIAG_WARNING;
 
-        // 转换位置信息（编译器使用 1-based，LSP 使用 0-based）
-        lsp_diag->range.start.line = (diag->line > 0) ? diag->line - 1 : 0;
-        lsp_diag->range.start.column = (diag->column > 0) ? diag->column - 1 : 0;
-        
-        // 结束位置暂时设为同一位置（精确范围需要 Token 信息）
-        lsp_diag->range.end.line = lsp_diag->range.start.line;
-        lsp_diag->range.end.column = lsp_diag->range.start.column + 1;
+        // 转换位置信息（编译器使用 1-based 字节列，LSP 使用 0-based UTF-16 列）
+        if (analysis && analysis->line_index && diag->line > 0) {
+            size_t offset = cn_line_index_offset_from_diag(
+                analysis->line_index, analysis->source, diag->line, diag->column);
+            size_t index;
+
+            // 诊断位置落在词元上时范围覆盖整个词元，否则覆盖一个字符
+            if (analysis->tokens.count > 0 && find_token_at(analysis, offset, &index)) {
+                lsp_diag->range = token_range(analysis, index);
+            } else {
+                lsp_diag->range.start = cn_lsp_offset_to_position(analysis, offset);
+                lsp_diag->range.end = lsp_diag->range.start;
+                lsp_diag->range.end.column += 1;
+            }
+        } else {
+            lsp_diag->range.start.line = (diag->line > 0) ? diag->line - 1 : 0;
+            lsp_diag->range.start.column = (diag->column > 0) ? diag->column - 1 : 0;
+            lsp_diag->range.end.line = lsp_diag->range.start.line;
+            lsp_diag->range.end.column = lsp_diag->range.start.column + 1;
+        }
 
-        // 设置消息和来源
-        lsp_diag->message = diag->message;
+        // 设置消息和来源（消息复制一份：编译器诊断在分析结束后即被释放）
+        lsp_diag->message = copy_message(diag->message);
         lsp_diag->source = "CN_Language";
     }
 
@@ -1480,6 +1480,84 @@ static char *get_directory_from_path(const char *file_path)
     return dir;
 }
 
+/**
+ * @brief 在目录下查找资源文件，找到时返回完整路径（调用者负责释放）
+ */
+static char *find_resource_in_dir(const char *dir, const char *resource_path)
+{
+    char *full_path = path_join(dir, resource_path);
+    if (full_path && file_exists(full_path)) {
+        return full_path;
+    }
+    free(full_path);
+    return NULL;
+}
+
+/**
+ * @brief 定位编译时嵌入的资源文件
+ */
+int cn_module_loader_resolve_resource(CnModuleLoader *loader,
+                                      const char *importing_file,
+                                      const char *resource_path,
+                                      char **out_path)
+{
+    char *found = NULL;
+
+    if (!resource_path || !resource_path[0] || !out_path) {
+        return 0;
+    }
+
+    // 绝对路径
+#ifdef _WIN32
+    int is_absolute = resource_path[0] == '\\' || resource_path[0] == '/' ||
+                      resource_path[1] == ':';
+#else
+    int is_absolute = resource_path[0] == '/';
+#endif
+    if (is_absolute) {
+        if (!file_exists(resource_path)) {
+            return 0;
+        }
+        *out_path = strdup(resource_path);
+        return *out_path != NULL;
+    }
+
+    // 1. 引用方源文件所在目录
+    if (importing_file) {
+        char *dir = get_directory_from_path(importing_file);
+        found = find_resource_in_dir(dir, resource_path);
+        free(dir);
+    }
+
+    if (!found && loader && loader->search_config) {
+        CnModuleSearchConfig *config = loader->search_config;
+
+        // 2. 项目根目录
+        if (config->project_root) {
+            found = find_resource_in_dir(config->project_root, resource_path);
+        }
+        // 3. 自定义搜索路径（按优先级排序）
+        for (size_t i = 0; !found && i < config->path_count; i++) {
+            found = find_resource_in_dir(config->paths[i].path, resource_path);
+        }
+        // 4. 标准库路径
+        if (!found && config->stdlib_path) {
+            found = find_resource_in_dir(config->stdlib_path, resource_path);
+        }
+    }
+
+    // 没有加载器时退回到当前目录
+    if (!found && !loader && file_exists(resource_path)) {
+        found = strdup(resource_path);
+    }
+
+    if (!found) {
+        return 0;
+    }
+    *out_path = found;
+    return 1;
+}
+
 /**
  * @brief 解析相对路径
  * @param base_dir 基准目录
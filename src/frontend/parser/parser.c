@@ -1,29 +1,113 @@
 #include "cnlang/frontend/parser.h"
+#include "cnlang/frontend/preprocessor.h"
 #include "cnlang/frontend/semantics.h"
 #include "cnlang/support/diagnostics.h"
+#include "cnlang/support/string_pool.h"
+#include "cnlang/support/memory/arena.h"
 #include "cnlang/frontend/ast/class_node.h"  // 类和接口AST节点
 
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
+// 拉取模式下已消耗词元超过该数量时，在顶层声明边界处压缩词元窗口
+#define CN_PARSER_PULL_WINDOW 256
+
+// 增量解析时，结束处与编辑点之间不足该数量词元的声明也重新解析
+// （顶层声明解析到最后一个词元时，最多再向后看 current 之后的两个词元）
+#define CN_PARSER_INCREMENTAL_MARGIN 4
+
 typedef struct CnParser {
     CnLexer *lexer;
     CnToken current;
     int has_current;
+    CnTokenStream *stream;            // 预词法化词元流（为NULL时按需从 lexer 取词元）
+    size_t stream_pos;                // 下一个待读取词元的下标
+    CnLexer stream_lexer;             // 词元流模式下仅用于提供文件名等上下文
+    CnPreprocessor *preprocessor;     // 逐词元预处理器（为NULL时不从预处理器拉取）
+    int pull_mode;                    // 从 pulled 窗口读取词元（逐词元预处理器或延迟函数体）
+    CnToken *pulled;                  // 拉取模式下的词元窗口，stream_pos 为窗口内下标
+    size_t pulled_count;
+    size_t pulled_capacity;
+    int pulled_eof;                   // 窗口末尾是否已是 EOF 词元
     int error_count;
     CnDiagnostics *diagnostics;
     CnVisibility current_visibility;  // 当前可见性（用于文件级块声明）
     int in_function_body;             // 是否在函数体内（用于静态变量作用域检查）
+    CnArena *arena;                   // AST 节点 Arena（解析成功后移交给程序）
+    int skim_bodies;                  // 跳读模式：顶层函数体只保存词元，首次需要时再解析
+    CnToken *skim_tokens;             // 跳读时收集函数体词元的暂存区（复用于各函数）
+    size_t skim_capacity;
+    CnParseItemList *items;           // 记录顶层声明区间（仅词元流模式，为NULL时不记录）
+    size_t nesting;                   // 当前递归解析的嵌套层数
+    size_t max_nesting;               // 嵌套层数上限
+    int nesting_reported;             // 已在上限处报告过嵌套过深（回到上限以内前不再重复报告）
 } CnParser;
 
+// 跳读模式下尚未解析的函数体：从 '{' 到匹配的 '}' 的词元，末尾补一个 EOF 词元
+struct CnAstLazyBody {
+    CnToken *tokens;          // 位于程序的 Arena
+    size_t token_count;       // 含末尾 EOF
+    const char *filename;
+    CnArena *arena;           // 程序的 Arena，函数体节点也分配于此
+};
+
+// AST 节点、子数组与字符串副本都从解析器的 Arena 分配，随程序一次性释放，
+// 因此错误路径上直接丢弃已构造的子树即可
+// 节点清零分配：各 make_* 只设置用到的字段，其余标志（如 is_this_pointer）保持为 0
+static void *ast_alloc(CnParser *parser, size_t size)
+{
+    void *node = cn_arena_alloc(parser->arena, size);
+    if (node) {
+        memset(node, 0, size);
+    }
+    return node;
+}
+
+// 按种类分配表达式与语句节点：只分配公共头部与该种类的联合体成员
+static CnAstExpr *ast_new_expr(CnParser *parser, CnAstExprKind kind)
+{
+    CnAstExpr *expr = (CnAstExpr *)ast_alloc(parser, cn_frontend_ast_expr_node_size(kind));
+    if (expr) {
+        expr->kind = kind;
+    }
+    return expr;
+}
+
+static CnAstStmt *ast_new_stmt(CnParser *parser, CnAstStmtKind kind)
+{
+    CnAstStmt *stmt = (CnAstStmt *)ast_alloc(parser, cn_frontend_ast_stmt_node_size(kind));
+    if (stmt) {
+        stmt->kind = kind;
+    }
+    return stmt;
+}
+
+// 扩展 Arena 中的数组（旧空间随 Arena 回收）
+static void *ast_grow(CnParser *parser, void *array, size_t old_size, size_t new_size)
+{
+    return cn_arena_realloc(parser->arena, array, old_size, new_size);
+}
+
+// 为逐个追加的数组预留一个空位：容量按 2 的幂增长并由元素个数推出，不需要额外字段
+static void *ast_array_reserve(CnParser *parser, void *array, size_t count, size_t elem_size)
+{
+    if (array && (count < 4 || (count & (count - 1)) != 0)) {
+        return array;
+    }
+    return ast_grow(parser, array, count * elem_size, (count < 4 ? 4 : count * 2) * elem_size);
+}
+
 static void parser_advance(CnParser *parser);
+static CnTokenKind parser_peek_n(CnParser *parser, size_t n);
 static int parser_match(CnParser *parser, CnTokenKind kind);
 static int parser_expect(CnParser *parser, CnTokenKind kind);
 static void check_reserved_keyword(CnParser *parser);
 static int is_reserved_keyword(CnTokenKind kind);
 
 static CnAstProgram *parse_program_internal(CnParser *parser);
+static bool parse_top_level(CnParser *parser, CnAstProgram *program, size_t stop_index);
+static size_t parser_stream_index(const CnParser *parser);
 static CnAstFunctionDecl *parse_function_decl(CnParser *parser);
 static CnAstFunctionDecl *parse_interrupt_handler(CnParser *parser);
 static CnAstStmt *parse_struct_decl(CnParser *parser);
@@ -43,72 +127,66 @@ static CnClassMember *parse_class_member(CnParser *parser, CnAccessLevel default
 static CnAccessLevel parse_access_label(CnParser *parser);
 static CnType *parse_type(CnParser *parser);
 static CnAstExpr *parse_expression(CnParser *parser);
-static CnAstExpr *parse_assignment(CnParser *parser);
-static CnAstExpr *parse_ternary(CnParser *parser);
-static CnAstExpr *parse_logical_or(CnParser *parser);
-static CnAstExpr *parse_logical_and(CnParser *parser);
-static CnAstExpr *parse_bitwise_or(CnParser *parser);
-static CnAstExpr *parse_bitwise_xor(CnParser *parser);
-static CnAstExpr *parse_bitwise_and(CnParser *parser);
-static CnAstExpr *parse_comparison(CnParser *parser);
-static CnAstExpr *parse_shift(CnParser *parser);
-static CnAstExpr *parse_additive(CnParser *parser);
-static CnAstExpr *parse_term(CnParser *parser);
+static CnAstExpr *parse_binary_expression(CnParser *parser, int min_power);
+static CnAstExpr *parse_ternary_rest(CnParser *parser, CnAstExpr *condition);
 static CnAstExpr *parse_unary(CnParser *parser);
+static CnAstExpr *parse_prefix_unary(CnParser *parser);
 static CnAstExpr *parse_postfix(CnParser *parser);
 static CnAstExpr *parse_factor(CnParser *parser);
 static CnAstExpr *parse_struct_literal_with_name(CnParser *parser, const char *struct_name, size_t struct_name_length);
-
-static CnAstExpr *make_integer_literal(long value);
-static CnAstExpr *make_float_literal(double value);
-static char* process_string_escapes(const char *raw_string, size_t raw_length, size_t *out_length);
-static CnAstExpr *make_string_literal(const char *value, size_t length);
-static CnAstExpr *make_char_literal(char value);
-static CnAstExpr *make_bool_literal(int value);
-static CnAstExpr *make_identifier(const char *name, size_t length);
-static CnAstExpr *make_binary(CnAstBinaryOp op, CnAstExpr *left, CnAstExpr *right);
-static CnAstExpr *make_logical(CnAstLogicalOp op, CnAstExpr *left, CnAstExpr *right);
-static CnAstExpr *make_unary(CnAstUnaryOp op, CnAstExpr *operand);
-static CnAstExpr *make_assign(CnAstExpr *target, CnAstExpr *value);
-static CnAstExpr *make_call(CnAstExpr *callee, CnAstExpr **arguments, size_t argument_count);
-static CnAstExpr *make_array_literal(CnAstExpr **elements, size_t element_count);
-static CnAstExpr *make_index(CnAstExpr *array, CnAstExpr *index);
-static CnAstExpr *make_member_access(CnAstExpr *object, const char *member_name, size_t member_name_length, int is_arrow);
-static CnAstExpr *make_struct_literal(const char *struct_name, size_t struct_name_length, CnAstStructFieldInit *fields, size_t field_count);
-static CnAstExpr *make_cast(CnType *target_type, CnAstExpr *operand);
-static CnAstExpr *make_memory_read(CnAstExpr *address);
-static CnAstExpr *make_memory_write(CnAstExpr *address, CnAstExpr *value);
-static CnAstExpr *make_memory_copy(CnAstExpr *dest, CnAstExpr *src, CnAstExpr *size);
-static CnAstExpr *make_memory_set(CnAstExpr *address, CnAstExpr *value, CnAstExpr *size);
-static CnAstExpr *make_memory_map(CnAstExpr *address, CnAstExpr *size, CnAstExpr *prot, CnAstExpr *flags);
-static CnAstExpr *make_memory_unmap(CnAstExpr *address, CnAstExpr *size);
-static CnAstExpr *make_inline_asm(CnAstExpr *asm_code, CnAstExpr **outputs, size_t output_count, 
+static CnAstExpr *parse_struct_array_initializer(CnParser *parser, const char *struct_name, size_t struct_name_length);
+
+static CnAstExpr *make_integer_literal(CnParser *parser, long value);
+static CnAstExpr *make_float_literal(CnParser *parser, double value);
+static char* process_string_escapes(CnParser *parser, const char *raw_string, size_t raw_length, size_t *out_length);
+static CnAstExpr *make_string_literal(CnParser *parser, const char *value, size_t length);
+static CnAstExpr *make_char_literal(CnParser *parser, char value);
+static CnAstExpr *make_bool_literal(CnParser *parser, int value);
+static CnAstExpr *make_identifier(CnParser *parser, const char *name, size_t length);
+static CnAstExpr *make_binary(CnParser *parser, CnAstBinaryOp op, CnAstExpr *left, CnAstExpr *right);
+static CnAstExpr *make_logical(CnParser *parser, CnAstLogicalOp op, CnAstExpr *left, CnAstExpr *right);
+static CnAstExpr *make_unary(CnParser *parser, CnAstUnaryOp op, CnAstExpr *operand);
+static CnAstExpr *make_assign(CnParser *parser, CnAstExpr *target, CnAstExpr *value);
+static CnAstExpr *make_call(CnParser *parser, CnAstExpr *callee, CnAstExpr **arguments, size_t argument_count);
+static CnAstExpr *make_array_literal(CnParser *parser, CnAstExpr **elements, size_t element_count);
+static CnAstExpr *make_index(CnParser *parser, CnAstExpr *array, CnAstExpr *index);
+static CnAstExpr *make_member_access(CnParser *parser, CnAstExpr *object, const char *member_name, size_t member_name_length, int is_arrow);
+static CnAstExpr *make_struct_literal(CnParser *parser, const char *struct_name, size_t struct_name_length, CnAstStructFieldInit *fields, size_t field_count);
+static CnAstExpr *make_cast(CnParser *parser, CnType *target_type, CnAstExpr *operand);
+static CnAstExpr *parse_embed(CnParser *parser);
+static CnAstExpr *make_memory_read(CnParser *parser, CnAstExpr *address);
+static CnAstExpr *make_memory_write(CnParser *parser, CnAstExpr *address, CnAstExpr *value);
+static CnAstExpr *make_memory_copy(CnParser *parser, CnAstExpr *dest, CnAstExpr *src, CnAstExpr *size);
+static CnAstExpr *make_memory_set(CnParser *parser, CnAstExpr *address, CnAstExpr *value, CnAstExpr *size);
+static CnAstExpr *make_memory_map(CnParser *parser, CnAstExpr *address, CnAstExpr *size, CnAstExpr *prot, CnAstExpr *flags);
+static CnAstExpr *make_memory_unmap(CnParser *parser, CnAstExpr *address, CnAstExpr *size);
+static CnAstExpr *make_inline_asm(CnParser *parser, CnAstExpr *asm_code, CnAstExpr **outputs, size_t output_count, 
                                    CnAstExpr **inputs, size_t input_count, CnAstExpr *clobbers);
-static CnAstStmt *make_expr_stmt(CnAstExpr *expr);
-static CnAstStmt *make_return_stmt(CnAstExpr *expr);
-static CnAstStmt *make_if_stmt(CnAstExpr *condition, CnAstBlockStmt *then_block, CnAstBlockStmt *else_block);
-static CnAstStmt *make_while_stmt(CnAstExpr *condition, CnAstBlockStmt *body);
-static CnAstStmt *make_for_stmt(CnAstStmt *init, CnAstExpr *condition, CnAstExpr *update, CnAstBlockStmt *body);
-static CnAstStmt *make_switch_stmt(CnAstExpr *expr, CnAstSwitchCase *cases, size_t case_count);
-static CnAstStmt *make_break_stmt(void);
-static CnAstStmt *make_continue_stmt(void);
-static CnAstStmt *make_var_decl_stmt(const char *name, size_t name_length, CnType *declared_type, CnAstExpr *initializer, CnVisibility visibility);
-static CnAstStmt *make_struct_decl_stmt(const char *name, size_t name_length, CnAstStructField *fields, size_t field_count);
-static CnAstStmt *make_enum_decl_stmt(const char *name, size_t name_length, CnAstEnumMember *members, size_t member_count);
-static CnAstBlockStmt *make_block(void);
-static void block_add_stmt(CnAstBlockStmt *block, CnAstStmt *stmt);
-static CnAstProgram *make_program(void);
-static void program_add_function(CnAstProgram *program, CnAstFunctionDecl *function_decl);
-static void program_add_struct(CnAstProgram *program, CnAstStmt *struct_decl);
-static void program_add_enum(CnAstProgram *program, CnAstStmt *enum_decl);
-static void program_add_import(CnAstProgram *program, CnAstStmt *import_stmt);
-static void program_add_global_var(CnAstProgram *program, CnAstStmt *var_decl);
+static CnAstStmt *make_expr_stmt(CnParser *parser, CnAstExpr *expr);
+static CnAstStmt *make_return_stmt(CnParser *parser, CnAstExpr *expr);
+static CnAstStmt *make_if_stmt(CnParser *parser, CnAstExpr *condition, CnAstBlockStmt *then_block, CnAstBlockStmt *else_block);
+static CnAstStmt *make_while_stmt(CnParser *parser, CnAstExpr *condition, CnAstBlockStmt *body);
+static CnAstStmt *make_for_stmt(CnParser *parser, CnAstStmt *init, CnAstExpr *condition, CnAstExpr *update, CnAstBlockStmt *body);
+static CnAstStmt *make_switch_stmt(CnParser *parser, CnAstExpr *expr, CnAstSwitchCase *cases, size_t case_count);
+static CnAstStmt *make_break_stmt(CnParser *parser);
+static CnAstStmt *make_continue_stmt(CnParser *parser);
+static CnAstStmt *make_var_decl_stmt(CnParser *parser, const char *name, size_t name_length, CnType *declared_type, CnAstExpr *initializer, CnVisibility visibility);
+static CnAstStmt *make_struct_decl_stmt(CnParser *parser, const char *name, size_t name_length, CnAstStructField *fields, size_t field_count);
+static CnAstStmt *make_enum_decl_stmt(CnParser *parser, const char *name, size_t name_length, CnAstEnumMember *members, size_t member_count);
+static CnAstBlockStmt *make_block(CnParser *parser);
+static void block_add_stmt(CnParser *parser, CnAstBlockStmt *block, CnAstStmt *stmt);
+static CnAstProgram *make_program(CnParser *parser);
+static void program_add_function(CnParser *parser, CnAstProgram *program, CnAstFunctionDecl *function_decl);
+static void program_add_struct(CnParser *parser, CnAstProgram *program, CnAstStmt *struct_decl);
+static void program_add_enum(CnParser *parser, CnAstProgram *program, CnAstStmt *enum_decl);
+static void program_add_import(CnParser *parser, CnAstProgram *program, CnAstStmt *import_stmt);
+static void program_add_global_var(CnParser *parser, CnAstProgram *program, CnAstStmt *var_decl);
 /* 类和接口添加函数（阶段11 - 面向对象编程支持） */
-static void program_add_class(CnAstProgram *program, CnAstStmt *class_decl);
-static void program_add_interface(CnAstProgram *program, CnAstStmt *interface_decl);
+static void program_add_class(CnParser *parser, CnAstProgram *program, CnAstStmt *class_decl);
+static void program_add_interface(CnParser *parser, CnAstProgram *program, CnAstStmt *interface_decl);
 /* 模板添加函数（阶段13 - 泛型编程支持） */
-static void program_add_template_func(CnAstProgram *program, CnAstStmt *template_func_decl);
-static void program_add_template_struct(CnAstProgram *program, CnAstStmt *template_struct_decl);
+static void program_add_template_func(CnParser *parser, CnAstProgram *program, CnAstStmt *template_func_decl);
+static void program_add_template_struct(CnParser *parser, CnAstProgram *program, CnAstStmt *template_struct_decl);
 /* 模板解析函数（阶段13 - 泛型编程支持） */
 static CnAstTemplateParams *parse_template_params(CnParser *parser);
 static CnAstStmt *parse_template_declaration(CnParser *parser);
@@ -170,16 +248,120 @@ CnParser *cn_frontend_parser_new(CnLexer *lexer)
 
     parser->lexer = lexer;
     parser->has_current = 0;
+    parser->stream = NULL;
+    parser->stream_pos = 0;
+    parser->preprocessor = NULL;
+    parser->pull_mode = 0;
+    parser->pulled = NULL;
+    parser->pulled_count = 0;
+    parser->pulled_capacity = 0;
+    parser->pulled_eof = 0;
     parser->error_count = 0;
     parser->diagnostics = NULL;
     parser->current_visibility = CN_VISIBILITY_PRIVATE;  // 默认私有
     parser->in_function_body = 0;  // 初始不在函数体内
+    parser->arena = NULL;
+    parser->skim_bodies = 0;
+    parser->skim_tokens = NULL;
+    parser->skim_capacity = 0;
+    parser->items = NULL;
+    parser->nesting = 0;
+    parser->max_nesting = CN_PARSER_DEFAULT_MAX_NESTING;
+    parser->nesting_reported = 0;
+
+    return parser;
+}
+
+CnParser *cn_frontend_parser_new_from_stream(CnTokenStream *stream)
+{
+    CnParser *parser;
+
+    if (!stream || !stream->kinds || stream->count == 0) {
+        return NULL;
+    }
+
+    parser = (CnParser *)malloc(sizeof(CnParser));
+    if (!parser) {
+        return NULL;
+    }
+
+    cn_frontend_lexer_init(&parser->stream_lexer, stream->source, stream->length, stream->filename);
+    parser->lexer = &parser->stream_lexer;
+    parser->has_current = 0;
+    parser->stream = stream;
+    parser->stream_pos = 0;
+    parser->preprocessor = NULL;
+    parser->pull_mode = 0;
+    parser->pulled = NULL;
+    parser->pulled_count = 0;
+    parser->pulled_capacity = 0;
+    parser->pulled_eof = 0;
+    parser->error_count = 0;
+    parser->diagnostics = NULL;
+    parser->current_visibility = CN_VISIBILITY_PRIVATE;  // 默认私有
+    parser->in_function_body = 0;  // 初始不在函数体内
+    parser->arena = NULL;
+    parser->skim_bodies = 0;
+    parser->skim_tokens = NULL;
+    parser->skim_capacity = 0;
+    parser->items = NULL;
+    parser->nesting = 0;
+    parser->max_nesting = CN_PARSER_DEFAULT_MAX_NESTING;
+    parser->nesting_reported = 0;
+
+    return parser;
+}
+
+CnParser *cn_frontend_parser_new_from_preprocessor(CnPreprocessor *preprocessor)
+{
+    CnParser *parser;
+
+    if (!preprocessor) {
+        return NULL;
+    }
+
+    parser = (CnParser *)malloc(sizeof(CnParser));
+    if (!parser) {
+        return NULL;
+    }
+
+    cn_frontend_lexer_init(&parser->stream_lexer, preprocessor->source,
+                           preprocessor->source_length, preprocessor->filename);
+    parser->lexer = &parser->stream_lexer;
+    parser->has_current = 0;
+    parser->stream = NULL;
+    parser->stream_pos = 0;
+    parser->preprocessor = preprocessor;
+    parser->pull_mode = 1;
+    parser->pulled = NULL;
+    parser->pulled_count = 0;
+    parser->pulled_capacity = 0;
+    parser->pulled_eof = 0;
+    parser->error_count = 0;
+    parser->diagnostics = NULL;
+    parser->current_visibility = CN_VISIBILITY_PRIVATE;  // 默认私有
+    parser->in_function_body = 0;  // 初始不在函数体内
+    parser->arena = NULL;
+    parser->skim_bodies = 0;
+    parser->skim_tokens = NULL;
+    parser->skim_capacity = 0;
+    parser->items = NULL;
+    parser->nesting = 0;
+    parser->max_nesting = CN_PARSER_DEFAULT_MAX_NESTING;
+    parser->nesting_reported = 0;
 
     return parser;
 }
 
 void cn_frontend_parser_free(CnParser *parser)
 {
+    if (!parser) {
+        return;
+    }
+
+    free(parser->pulled);
+    free(parser->skim_tokens);
+    cn_arena_free(parser->arena);
     free(parser);
 }
 
@@ -192,6 +374,24 @@ void cn_frontend_parser_set_diagnostics(CnParser *parser, CnDiagnostics *diagnos
     parser->diagnostics = diagnostics;
 }
 
+void cn_frontend_parser_set_max_nesting(CnParser *parser, size_t max_nesting)
+{
+    if (!parser) {
+        return;
+    }
+
+    parser->max_nesting = max_nesting > 0 ? max_nesting : CN_PARSER_DEFAULT_MAX_NESTING;
+}
+
+void cn_frontend_parser_set_skim_bodies(CnParser *parser, bool skim)
+{
+    if (!parser) {
+        return;
+    }
+
+    parser->skim_bodies = skim ? 1 : 0;
+}
+
 bool cn_frontend_parse_program(CnParser *parser, CnAstProgram **out_program)
 {
     CnAstProgram *program;
@@ -200,21 +400,426 @@ bool cn_frontend_parse_program(CnParser *parser, CnAstProgram **out_program)
         return false;
     }
 
+    // 每次解析使用新的 Arena，结果程序拥有它
+    cn_arena_free(parser->arena);
+    parser->arena = cn_arena_new(0);
+    if (!parser->arena) {
+        return false;
+    }
+
+    if (parser->items) {
+        parser->items->count = 0;
+        parser->items->reusable = false;
+    }
+
     program = parse_program_internal(parser);
     if (!program) {
         return false;
     }
 
+    if (parser->items) {
+        cn_arena_get_stats(parser->arena, &parser->items->arena_baseline, NULL);
+    }
+    parser->arena = NULL;
     *out_program = program;
     return parser->error_count == 0;
 }
 
-static void parser_advance(CnParser *parser)
+bool cn_frontend_parse_function_body(CnAstFunctionDecl *function_decl, CnDiagnostics *diagnostics)
+{
+    CnAstLazyBody *lazy;
+    CnParser parser;
+
+    if (!function_decl || !function_decl->lazy_body) {
+        return true;
+    }
+
+    // 无论成败只解析一次；出错时与完整解析一样保留已恢复出的部分函数体
+    lazy = function_decl->lazy_body;
+    function_decl->lazy_body = NULL;
+
+    // 词元窗口直接指向保存的词元，末尾已是 EOF，不会再向预处理器拉取
+    memset(&parser, 0, sizeof(parser));
+    cn_frontend_lexer_init(&parser.stream_lexer, NULL, 0, lazy->filename);
+    parser.lexer = &parser.stream_lexer;
+    parser.pull_mode = 1;
+    parser.pulled = lazy->tokens;
+    parser.pulled_count = lazy->token_count;
+    parser.pulled_capacity = lazy->token_count;
+    parser.pulled_eof = 1;
+    parser.diagnostics = diagnostics;
+    parser.current_visibility = function_decl->visibility;
+    parser.in_function_body = 1;
+    parser.arena = lazy->arena;
+    parser.max_nesting = CN_PARSER_DEFAULT_MAX_NESTING;
+
+    parser_advance(&parser);
+    function_decl->body = parse_block(&parser);
+    return function_decl->body != NULL && parser.error_count == 0;
+}
+
+bool cn_frontend_parse_lazy_bodies(CnAstProgram *program, CnDiagnostics *diagnostics)
+{
+    bool ok = true;
+
+    if (!program) {
+        return false;
+    }
+
+    for (size_t i = 0; i < program->function_count; i++) {
+        if (!cn_frontend_parse_function_body(program->functions[i], diagnostics)) {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+void cn_frontend_parser_set_item_list(CnParser *parser, CnParseItemList *list)
 {
     if (!parser) {
         return;
     }
 
+    parser->items = list;
+}
+
+void cn_frontend_parse_item_list_free(CnParseItemList *list)
+{
+    if (!list) {
+        return;
+    }
+
+    free(list->items);
+    list->items = NULL;
+    list->count = 0;
+    list->capacity = 0;
+    list->reusable = false;
+}
+
+// 词元流中首个起始偏移不小于 offset 的词元下标（找不到时为末尾 EOF 词元）
+static size_t stream_lower_bound(const CnTokenStream *stream, size_t offset)
+{
+    size_t low = 0;
+    size_t high = stream->count - 1;
+
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (stream->offsets[mid] < offset) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// 按声明区间的顺序重建程序的各声明列表，与完整解析逐个追加的顺序一致（旧数组随 Arena 回收）
+static void program_rebuild_from_items(CnParser *parser, CnAstProgram *program, const CnParseItemList *items)
+{
+    program->function_count = 0;
+    program->functions = NULL;
+    program->struct_count = 0;
+    program->structs = NULL;
+    program->enum_count = 0;
+    program->enums = NULL;
+    program->import_count = 0;
+    program->imports = NULL;
+    program->global_var_count = 0;
+    program->global_vars = NULL;
+    program->class_count = 0;
+    program->classes = NULL;
+    program->interface_count = 0;
+    program->interfaces = NULL;
+    program->template_func_count = 0;
+    program->template_funcs = NULL;
+    program->template_struct_count = 0;
+    program->template_structs = NULL;
+
+    for (size_t i = 0; i < items->count; i++) {
+        const CnParseItem *item = &items->items[i];
+
+        switch (item->kind) {
+        case CN_PARSE_ITEM_FUNCTION:
+            program_add_function(parser, program, (CnAstFunctionDecl *)item->node);
+            break;
+        case CN_PARSE_ITEM_STRUCT:
+            program_add_struct(parser, program, (CnAstStmt *)item->node);
+            break;
+        case CN_PARSE_ITEM_ENUM:
+            program_add_enum(parser, program, (CnAstStmt *)item->node);
+            break;
+        case CN_PARSE_ITEM_IMPORT:
+            program_add_import(parser, program, (CnAstStmt *)item->node);
+            break;
+        case CN_PARSE_ITEM_GLOBAL_VAR:
+            program_add_global_var(parser, program, (CnAstStmt *)item->node);
+            break;
+        case CN_PARSE_ITEM_CLASS:
+            program_add_class(parser, program, (CnAstStmt *)item->node);
+            break;
+        case CN_PARSE_ITEM_INTERFACE:
+            program_add_interface(parser, program, (CnAstStmt *)item->node);
+            break;
+        case CN_PARSE_ITEM_TEMPLATE_FUNC:
+            program_add_template_func(parser, program, (CnAstStmt *)item->node);
+            break;
+        case CN_PARSE_ITEM_TEMPLATE_STRUCT:
+            program_add_template_struct(parser, program, (CnAstStmt *)item->node);
+            break;
+        case CN_PARSE_ITEM_OTHER:
+            break;
+        }
+    }
+}
+
+bool cn_frontend_parse_program_incremental(CnParser *parser, CnAstProgram *program, CnParseItemList *items,
+                                           size_t edit_offset, size_t removed_length, size_t inserted_length)
+{
+    CnTokenStream *stream;
+    CnParseItemList region = {0};
+    CnParseItem *merged;
+    CnDiagnostics scratch;
+    CnDiagnostics *saved_diagnostics;
+    CnArena *saved_arena;
+    CnParseItemList *saved_items;
+    size_t arena_used = 0;
+    size_t edit_end;
+    size_t edit_token;
+    size_t first;
+    size_t next;
+    size_t begin_token;
+    size_t stop_token;
+    size_t merged_count;
+    int edit_line = 0;
+    int column = 0;
+    int line_delta = 0;
+    bool ok;
+
+    if (!parser || !parser->stream || !program || !program->arena || !items || !items->reusable ||
+        items->count == 0 || parser->skim_bodies) {
+        return false;
+    }
+
+    stream = parser->stream;
+    if (edit_offset + inserted_length > stream->length) {
+        return false;
+    }
+
+    // 历次增量解析替换下来的节点留在 Arena 中，累积过多时改为完整解析以回收
+    cn_arena_get_stats(program->arena, &arena_used, NULL);
+    if (arena_used > items->arena_baseline * 2 + CN_ARENA_BLOCK_SIZE) {
+        return false;
+    }
+
+    // 受影响的声明 [first, next)：与旧文本中的编辑区间相交或相邻
+    edit_end = edit_offset + removed_length;
+    first = 0;
+    while (first < items->count && items->items[first].end < edit_offset) {
+        first++;
+    }
+    next = first;
+    while (next < items->count && items->items[next].begin <= edit_end) {
+        next++;
+    }
+
+    // 声明解析结束时会向后看几个词元，离编辑点太近的前一个声明也要重新解析
+    edit_token = stream_lower_bound(stream, edit_offset);
+    if (edit_token > 0 &&
+        (size_t)stream->offsets[edit_token - 1] + stream->lengths[edit_token - 1] >= edit_offset) {
+        edit_token--;
+    }
+    while (first > 0 &&
+           edit_token - stream_lower_bound(stream, items->items[first - 1].end) < CN_PARSER_INCREMENTAL_MARGIN) {
+        first--;
+    }
+    begin_token = first > 0 ? stream_lower_bound(stream, items->items[first - 1].end) : 0;
+
+    // 与编辑末尾同一行的后续声明列号会变化，一并重新解析，复用的声明因此只需平移行号
+    cn_frontend_token_stream_position(stream, edit_offset + inserted_length, &edit_line, &column);
+    while (next < items->count) {
+        int line = 0;
+        cn_frontend_token_stream_position(stream, items->items[next].begin - removed_length + inserted_length,
+                                          &line, &column);
+        if (line != edit_line) {
+            break;
+        }
+        next++;
+    }
+
+    // 重新解析到第一个复用声明的首个词元为止；该位置不是词元起点说明编辑改变了其后的分词
+    if (next < items->count) {
+        size_t offset = items->items[next].begin - removed_length + inserted_length;
+        int line = 0;
+
+        stop_token = stream_lower_bound(stream, offset);
+        if (stop_token + 1 >= stream->count || stream->offsets[stop_token] != offset) {
+            return false;
+        }
+        cn_frontend_token_stream_position(stream, offset, &line, &column);
+        line_delta = line - items->items[next].line;
+    } else {
+        stop_token = stream->count - 1;
+    }
+    if (begin_token > stop_token) {
+        return false;
+    }
+
+    // 重新解析的诊断先收集在暂存区：失败时调用方会完整解析并报告
+    cn_support_diagnostics_init(&scratch);
+    saved_diagnostics = parser->diagnostics;
+    saved_arena = parser->arena;
+    saved_items = parser->items;
+    parser->diagnostics = &scratch;
+    parser->arena = program->arena;
+    parser->items = &region;
+    parser->error_count = 0;
+    parser->in_function_body = 0;
+    parser->current_visibility = first > 0 ? items->items[first - 1].visibility : CN_VISIBILITY_PRIVATE;
+    parser->stream_pos = begin_token;
+    parser->has_current = 0;
+    parser_advance(parser);
+
+    // 必须恰好停在复用声明之前，且到达时的可见性与原先一致
+    ok = parse_top_level(parser, NULL, stop_token) &&
+         parser->items == &region &&
+         parser->error_count == 0 &&
+         scratch.count == 0 &&
+         parser_stream_index(parser) == stop_token &&
+         (next == items->count || parser->current_visibility == items->items[next].visibility);
+
+    // 解析器回到文件开头，失败时调用方可直接用它完整解析
+    parser->diagnostics = saved_diagnostics;
+    parser->items = saved_items;
+    parser->error_count = 0;
+    parser->in_function_body = 0;
+    parser->current_visibility = CN_VISIBILITY_PRIVATE;
+    parser->stream_pos = 0;
+    parser->has_current = 0;
+    cn_support_diagnostics_free(&scratch);
+
+    merged_count = first + region.count + (items->count - next);
+    merged = ok ? (CnParseItem *)malloc((merged_count > 0 ? merged_count : 1) * sizeof(CnParseItem)) : NULL;
+    if (!merged) {
+        parser->arena = saved_arena;
+        free(region.items);
+        return false;
+    }
+
+    // 拼接：编辑点之前的声明不变，之后的声明平移偏移与行号
+    memcpy(merged, items->items, first * sizeof(CnParseItem));
+    memcpy(merged + first, region.items, region.count * sizeof(CnParseItem));
+    for (size_t i = next; i < items->count; i++) {
+        CnParseItem *item = &merged[first + region.count + (i - next)];
+
+        *item = items->items[i];
+        item->begin = item->begin - removed_length + inserted_length;
+        item->end = item->end - removed_length + inserted_length;
+        item->line += line_delta;
+        if (item->kind == CN_PARSE_ITEM_FUNCTION) {
+            cn_frontend_ast_function_shift_lines((CnAstFunctionDecl *)item->node, line_delta);
+        } else {
+            cn_frontend_ast_stmt_shift_lines((CnAstStmt *)item->node, line_delta);
+        }
+    }
+
+    free(items->items);
+    free(region.items);
+    items->items = merged;
+    items->count = merged_count;
+    items->capacity = merged_count;
+
+    program_rebuild_from_items(parser, program, items);
+    parser->arena = saved_arena;
+    return true;
+}
+
+// 将标识符 token 的词素替换为驻留字符串，AST 中的名字因此可按指针比较
+static void parser_intern_current(CnParser *parser)
+{
+    const char *interned;
+
+    if (parser->current.kind != CN_TOKEN_IDENT || !parser->current.lexeme_begin) {
+        return;
+    }
+
+    interned = cn_string_pool_intern(cn_string_pool_default(),
+                                     parser->current.lexeme_begin,
+                                     parser->current.lexeme_length);
+    if (interned) {
+        parser->current.lexeme_begin = interned;
+    }
+}
+
+// 拉取模式：确保窗口中有下标为 index 的词元；越过 EOF 时返回 EOF 词元，内存不足返回 NULL
+static const CnToken *parser_pulled_token(CnParser *parser, size_t index)
+{
+    while (parser->pulled_count <= index && !parser->pulled_eof) {
+        if (parser->pulled_count >= parser->pulled_capacity) {
+            size_t new_capacity = parser->pulled_capacity == 0 ? 64 : parser->pulled_capacity * 2;
+            CnToken *new_pulled = (CnToken *)realloc(parser->pulled, new_capacity * sizeof(CnToken));
+            if (!new_pulled) {
+                break;
+            }
+            parser->pulled = new_pulled;
+            parser->pulled_capacity = new_capacity;
+        }
+
+        CnToken *token = &parser->pulled[parser->pulled_count++];
+        cn_frontend_preprocessor_next_token(parser->preprocessor, token);
+        if (token->kind == CN_TOKEN_EOF) {
+            parser->pulled_eof = 1;
+        }
+    }
+
+    if (parser->pulled_count == 0) {
+        return NULL;
+    }
+    if (index >= parser->pulled_count) {
+        index = parser->pulled_count - 1;
+    }
+    return &parser->pulled[index];
+}
+
+// 拉取模式：丢弃窗口中已消耗的词元（仅在没有保存回溯位置的顶层调用）
+static void parser_release_pulled(CnParser *parser)
+{
+    if (!parser->preprocessor || parser->stream_pos < CN_PARSER_PULL_WINDOW) {
+        return;
+    }
+
+    memmove(parser->pulled, parser->pulled + parser->stream_pos,
+            (parser->pulled_count - parser->stream_pos) * sizeof(CnToken));
+    parser->pulled_count -= parser->stream_pos;
+    parser->stream_pos = 0;
+}
+
+// 取下一个词元到 current（标识符不驻留，跳读函数体时使用）
+static void parser_fetch(CnParser *parser)
+{
+    if (parser->pull_mode) {
+        const CnToken *token = parser_pulled_token(parser, parser->stream_pos);
+        if (token) {
+            parser->current = *token;
+            if (token->kind != CN_TOKEN_EOF) {
+                parser->stream_pos++;
+            }
+        } else {
+            memset(&parser->current, 0, sizeof(parser->current));
+            parser->current.kind = CN_TOKEN_EOF;
+        }
+        parser->has_current = 1;
+        return;
+    }
+
+    if (parser->stream) {
+        cn_frontend_token_stream_get(parser->stream, parser->stream_pos, &parser->current);
+        if (parser->stream_pos + 1 < parser->stream->count) {
+            parser->stream_pos++;
+        }
+        parser->has_current = 1;
+        return;
+    }
+
     if (!cn_frontend_lexer_next_token(parser->lexer, &parser->current)) {
         parser->current.kind = CN_TOKEN_EOF;
     }
@@ -222,38 +827,65 @@ static void parser_advance(CnParser *parser)
     parser->has_current = 1;
 }
 
-// 向前看下一个token（不消耗当前token）
-static CnTokenKind parser_peek(CnParser *parser)
+static void parser_advance(CnParser *parser)
+{
+    if (!parser) {
+        return;
+    }
+
+    parser_fetch(parser);
+    parser_intern_current(parser);
+}
+
+// 向前看当前token之后的第 n+1 个token（不消耗当前token）
+static CnTokenKind parser_peek_n(CnParser *parser, size_t n)
 {
     if (!parser || !parser->lexer) {
         return CN_TOKEN_EOF;
     }
+
+    // 词元流模式：直接按下标读取
+    if (parser->stream) {
+        size_t index = parser->stream_pos + n;
+        if (index >= parser->stream->count) {
+            return CN_TOKEN_EOF;
+        }
+        return (CnTokenKind)parser->stream->kinds[index];
+    }
+
+    // 拉取模式：按需从预处理器补充词元窗口
+    if (parser->pull_mode) {
+        const CnToken *token = parser_pulled_token(parser, parser->stream_pos + n);
+        return token ? token->kind : CN_TOKEN_EOF;
+    }
     
     // 保存当前lexer状态
-    const char *saved_source = parser->lexer->source;
-    const char *saved_filename = parser->lexer->filename;
-    size_t saved_length = parser->lexer->length;
-    size_t saved_offset = parser->lexer->offset;
-    int saved_line = parser->lexer->line;
-    int saved_column = parser->lexer->column;
+    CnLexer saved_lexer_state = *parser->lexer;
     
-    // 读取下一个token
+    // 读取后续token
     CnToken next_token;
-    if (!cn_frontend_lexer_next_token(parser->lexer, &next_token)) {
-        next_token.kind = CN_TOKEN_EOF;
+    next_token.kind = CN_TOKEN_EOF;
+    for (size_t i = 0; i <= n; i++) {
+        if (!cn_frontend_lexer_next_token(parser->lexer, &next_token)) {
+            next_token.kind = CN_TOKEN_EOF;
+        }
+        if (next_token.kind == CN_TOKEN_EOF) {
+            break;
+        }
     }
     
     // 恢复lexer状态
-    parser->lexer->source = saved_source;
-    parser->lexer->filename = saved_filename;
-    parser->lexer->length = saved_length;
-    parser->lexer->offset = saved_offset;
-    parser->lexer->line = saved_line;
-    parser->lexer->column = saved_column;
+    *parser->lexer = saved_lexer_state;
     
     return next_token.kind;
 }
 
+// 向前看下一个token（不消耗当前token）
+static CnTokenKind parser_peek(CnParser *parser)
+{
+    return parser_peek_n(parser, 0);
+}
+
 static int parser_match(CnParser *parser, CnTokenKind kind)
 {
     if (!parser->has_current) {
@@ -287,6 +919,64 @@ static int parser_expect(CnParser *parser, CnTokenKind kind)
     return 0;
 }
 
+// 越过当前操作数或语句的剩余词元：按括号配对前进，停在同层的右括号、分号、逗号或文件末尾之前
+static void parser_skip_nested(CnParser *parser)
+{
+    size_t depth = 0;
+
+    while (parser->current.kind != CN_TOKEN_EOF) {
+        CnTokenKind kind = parser->current.kind;
+
+        if (kind == CN_TOKEN_LPAREN || kind == CN_TOKEN_LBRACKET || kind == CN_TOKEN_LBRACE) {
+            depth++;
+        } else if (kind == CN_TOKEN_RPAREN || kind == CN_TOKEN_RBRACKET || kind == CN_TOKEN_RBRACE) {
+            if (depth == 0) {
+                break;
+            }
+            depth--;
+        } else if (depth == 0 && (kind == CN_TOKEN_SEMICOLON || kind == CN_TOKEN_COMMA)) {
+            break;
+        }
+        parser_advance(parser);
+    }
+}
+
+// 进入一层递归解析；超过嵌套上限时报告错误并越过该部分，返回 0（调用方不再递归，也不调用 parser_leave_nesting）
+static int parser_enter_nesting(CnParser *parser)
+{
+    if (parser->nesting < parser->max_nesting) {
+        parser->nesting++;
+        return 1;
+    }
+
+    // 同一层上紧邻的多处超限（如条件括号与其后的代码块）只报告一次
+    if (parser->nesting_reported) {
+        parser_skip_nested(parser);
+        return 0;
+    }
+    parser->nesting_reported = 1;
+    parser->error_count++;
+    if (parser->diagnostics) {
+        char message[128];
+        snprintf(message, sizeof(message), "语法错误：嵌套层数超过上限 %zu", parser->max_nesting);
+        cn_support_diagnostics_report(parser->diagnostics,
+                                      CN_DIAG_SEVERITY_ERROR,
+                                      CN_DIAG_CODE_PARSE_NESTING_TOO_DEEP,
+                                      parser->lexer ? parser->lexer->filename : NULL,
+                                      parser->current.line,
+                                      parser->current.column,
+                                      message);
+    }
+    parser_skip_nested(parser);
+    return 0;
+}
+
+static void parser_leave_nesting(CnParser *parser)
+{
+    parser->nesting--;
+    parser->nesting_reported = 0;
+}
+
 // 检查是否为预留关键字
 static int is_reserved_keyword(CnTokenKind kind)
 {
@@ -342,12 +1032,76 @@ static void check_reserved_keyword(CnParser *parser)
 
 static CnAstProgram *parse_program_internal(CnParser *parser)
 {
-    CnAstProgram *program = make_program();
+    CnAstProgram *program = make_program(parser);
+    size_t diagnostic_count = parser->diagnostics ? parser->diagnostics->count : 0;
+    bool complete;
     // 当前可见性已在 parser 初始化时设置（默认为私有）
 
     parser_advance(parser);
+    complete = parse_top_level(parser, program, SIZE_MAX);
+
+    // 只有没有任何诊断、完整解析到文件末尾的结果才能作为增量解析的基础
+    if (parser->items) {
+        parser->items->reusable = complete && parser->error_count == 0 && !parser->skim_bodies &&
+                                  (!parser->diagnostics || parser->diagnostics->count == diagnostic_count);
+    }
+    return program;
+}
+
+// 词元流模式下 current 在词元流中的下标（取到 EOF 后 stream_pos 不再前进）
+static size_t parser_stream_index(const CnParser *parser)
+{
+    if (!parser->stream) {
+        return 0;
+    }
+    if (parser->current.kind == CN_TOKEN_EOF) {
+        return parser->stream->count - 1;
+    }
+    return parser->stream_pos - 1;
+}
+
+// 记录一个顶层声明的区间：从下标为 begin_index 的词元到 current 之前的词元
+static void parser_record_item(CnParser *parser, CnParseItemKind kind, void *node,
+                               size_t begin_index, int line, CnVisibility visibility)
+{
+    CnParseItemList *list = parser->items;
+    size_t end_index = parser_stream_index(parser);
+    CnParseItem *item;
+
+    if (!list || !parser->stream || end_index <= begin_index) {
+        return;
+    }
+
+    if (list->count == list->capacity) {
+        size_t new_capacity = list->capacity == 0 ? 64 : list->capacity * 2;
+        CnParseItem *new_items = (CnParseItem *)realloc(list->items, new_capacity * sizeof(CnParseItem));
+        if (!new_items) {
+            // 记录不完整的列表不能用于增量解析
+            list->count = 0;
+            parser->items = NULL;
+            return;
+        }
+        list->items = new_items;
+        list->capacity = new_capacity;
+    }
+
+    item = &list->items[list->count++];
+    item->begin = parser->stream->offsets[begin_index];
+    item->end = (size_t)parser->stream->offsets[end_index - 1] + parser->stream->lengths[end_index - 1];
+    item->line = line;
+    item->visibility = visibility;
+    item->kind = kind;
+    item->node = node;
+}
+
+// 解析顶层声明，直到文件末尾或（词元流模式下）current 的下标到达 stop_index
+// 遇到无法恢复的错误提前结束时返回 false
+static bool parse_top_level(CnParser *parser, CnAstProgram *program, size_t stop_index)
+{
+    while (parser->current.kind != CN_TOKEN_EOF &&
+           (!parser->stream || parser_stream_index(parser) < stop_index)) {
+        parser_release_pulled(parser);
 
-    while (parser->current.kind != CN_TOKEN_EOF) {
         // 检查是否为预留关键字
         check_reserved_keyword(parser);
         
@@ -397,74 +1151,100 @@ static CnAstProgram *parse_program_internal(CnParser *parser)
             }
         }
 
+        // 声明区间从标签之后的首个词元开始；分号与无法识别的词元不构成声明
+        CnParseItemKind item_kind = CN_PARSE_ITEM_OTHER;
+        void *item_node = NULL;
+        size_t item_begin = parser_stream_index(parser);
+        int item_line = parser->current.line;
+        CnVisibility item_visibility = parser->current_visibility;
+
         if (parser->current.kind == CN_TOKEN_KEYWORD_IMPORT) {
             // 解析导入语句
             CnAstStmt *import_stmt = parse_import_stmt(parser);
             if (!import_stmt) {
-                break;
+                return false;
             }
-            program_add_import(program, import_stmt);
+            program_add_import(parser, program, import_stmt);
+            item_kind = CN_PARSE_ITEM_IMPORT;
+            item_node = import_stmt;
         } else if (parser->current.kind == CN_TOKEN_KEYWORD_FROM) {
             // 解析 "从...导入" 语句
             CnAstStmt *import_stmt = parse_from_import_stmt(parser);
             if (!import_stmt) {
-                break;
+                return false;
             }
-            program_add_import(program, import_stmt);
+            program_add_import(parser, program, import_stmt);
+            item_kind = CN_PARSE_ITEM_IMPORT;
+            item_node = import_stmt;
         } else if (parser->current.kind == CN_TOKEN_KEYWORD_STRUCT) {
             // 解析结构体声明或结构体类型的全局变量声明
             CnAstStmt *stmt = parse_struct_decl(parser);
             if (!stmt) {
-                break;
+                return false;
             }
             if (stmt->kind == CN_AST_STMT_STRUCT_DECL) {
-                program_add_struct(program, stmt);
+                program_add_struct(parser, program, stmt);
+                item_kind = CN_PARSE_ITEM_STRUCT;
+                item_node = stmt;
             } else if (stmt->kind == CN_AST_STMT_VAR_DECL) {
-                program_add_global_var(program, stmt);
+                program_add_global_var(parser, program, stmt);
+                item_kind = CN_PARSE_ITEM_GLOBAL_VAR;
+                item_node = stmt;
             } else {
                 // 其他情况视为错误，终止解析
-                break;
+                return false;
             }
         } else if (parser->current.kind == CN_TOKEN_KEYWORD_ENUM) {
             // 解析枚举声明
             CnAstStmt *enum_decl = parse_enum_decl(parser);
             if (!enum_decl) {
-                break;
+                return false;
             }
-            program_add_enum(program, enum_decl);
+            program_add_enum(parser, program, enum_decl);
+            item_kind = CN_PARSE_ITEM_ENUM;
+            item_node = enum_decl;
         } else if (parser->current.kind == CN_TOKEN_KEYWORD_CLASS) {
             // 解析类声明（阶段11 - 面向对象编程支持）
             CnAstStmt *class_decl = parse_class_decl(parser);
             if (!class_decl) {
-                break;
+                return false;
             }
-            program_add_class(program, class_decl);
+            program_add_class(parser, program, class_decl);
+            item_kind = CN_PARSE_ITEM_CLASS;
+            item_node = class_decl;
         } else if (parser->current.kind == CN_TOKEN_KEYWORD_INTERFACE) {
             // 解析接口声明（阶段11 - 面向对象编程支持）
             CnAstStmt *interface_decl = parse_interface_decl(parser);
             if (!interface_decl) {
-                break;
+                return false;
             }
-            program_add_interface(program, interface_decl);
+            program_add_interface(parser, program, interface_decl);
+            item_kind = CN_PARSE_ITEM_INTERFACE;
+            item_node = interface_decl;
         } else if (parser->current.kind == CN_TOKEN_KEYWORD_TEMPLATE) {
             // 解析模板声明（阶段13 - 泛型编程支持）
             CnAstStmt *template_decl = parse_template_declaration(parser);
             if (!template_decl) {
-                break;
+                return false;
             }
             // 根据类型添加到对应列表
             if (template_decl->kind == CN_AST_STMT_TEMPLATE_FUNCTION_DECL) {
-                program_add_template_func(program, template_decl);
+                program_add_template_func(parser, program, template_decl);
+                item_kind = CN_PARSE_ITEM_TEMPLATE_FUNC;
             } else if (template_decl->kind == CN_AST_STMT_TEMPLATE_STRUCT_DECL) {
-                program_add_template_struct(program, template_decl);
+                program_add_template_struct(parser, program, template_decl);
+                item_kind = CN_PARSE_ITEM_TEMPLATE_STRUCT;
             }
+            item_node = template_decl;
         } else if (parser->current.kind == CN_TOKEN_KEYWORD_FN) {
             // 解析函数声明
             CnAstFunctionDecl *fn = parse_function_decl(parser);
             if (!fn) {
-                break;
+                return false;
             }
-            program_add_function(program, fn);
+            program_add_function(parser, program, fn);
+            item_kind = CN_PARSE_ITEM_FUNCTION;
+            item_node = fn;
         /* 注意:CN_TOKEN_KEYWORD_INTERRUPT_HANDLER 已删除
          * 中断处理功能将通过运行时库函数提供
          * 原语法: 中断处理 向量号 () { ... }
@@ -475,9 +1255,9 @@ static CnAstProgram *parse_program_internal(CnParser *parser)
             // 解析中断处理函数
             CnAstFunctionDecl *isr = parse_interrupt_handler(parser);
             if (!isr) {
-                break;
+                return false;
             }
-            program_add_function(program, isr);
+            program_add_function(parser, program, isr);
         */
         } else if (parser->current.kind == CN_TOKEN_KEYWORD_VAR ||
                    parser->current.kind == CN_TOKEN_KEYWORD_CONST ||
@@ -490,13 +1270,15 @@ static CnAstProgram *parse_program_internal(CnParser *parser)
             // 解析全局变量声明（使用类型关键字开头）
             CnAstStmt *var_decl = parse_statement(parser);
             if (!var_decl) {
-                break;
+                return false;
             }
             // 应用当前块的可见性
             if (var_decl->kind == CN_AST_STMT_VAR_DECL) {
                 var_decl->as.var_decl.visibility = parser->current_visibility;
             }
-            program_add_global_var(program, var_decl);
+            program_add_global_var(parser, program, var_decl);
+            item_kind = CN_PARSE_ITEM_GLOBAL_VAR;
+            item_node = var_decl;
         } else if (parser->current.kind == CN_TOKEN_IDENT) {
             // 可能是自定义类型的全局变量声明，如：MyType var = value;
             // 需要向前看判断是变量声明还是其他
@@ -505,13 +1287,15 @@ static CnAstProgram *parse_program_internal(CnParser *parser)
                 // 类型名后跟标识符或指针符号，是变量声明
                 CnAstStmt *var_decl = parse_statement(parser);
                 if (!var_decl) {
-                    break;
+                    return false;
                 }
                 // 应用当前块的可见性
                 if (var_decl->kind == CN_AST_STMT_VAR_DECL) {
                     var_decl->as.var_decl.visibility = parser->current_visibility;
                 }
-                program_add_global_var(program, var_decl);
+                program_add_global_var(parser, program, var_decl);
+                item_kind = CN_PARSE_ITEM_GLOBAL_VAR;
+                item_node = var_decl;
             } else {
                 // 无法识别的标识符开头语句
                 fprintf(stderr, "[DEBUG PARSER] 无法识别的token: kind=%d, line=%d, col=%d, error_count=%d\n",
@@ -528,11 +1312,84 @@ static CnAstProgram *parse_program_internal(CnParser *parser)
             fprintf(stderr, "[DEBUG PARSER] 无法识别的token: kind=%d, line=%d, col=%d, error_count=%d\n",
                     parser->current.kind, parser->current.line, parser->current.column, parser->error_count + 1);
             parser->error_count++;
-            parser_advance(parser);
+            parser_advance(parser);
+        }
+
+        if (item_node) {
+            parser_record_item(parser, item_kind, item_node, item_begin, item_line, item_visibility);
+        }
+    }
+
+    return true;
+}
+
+// 跳读函数体：按花括号配对越过 '{' ... '}'，把这段词元（补一个 EOF）复制到 Arena
+static CnAstLazyBody *skim_function_body(CnParser *parser)
+{
+    CnAstLazyBody *lazy;
+    size_t count = 0;
+    size_t depth = 0;
+
+    if (parser->current.kind != CN_TOKEN_LBRACE) {
+        parser_expect(parser, CN_TOKEN_LBRACE);
+        return NULL;
+    }
+
+    for (;;) {
+        if (parser->current.kind == CN_TOKEN_EOF) {
+            parser->error_count++;
+            if (parser->diagnostics) {
+                cn_support_diagnostics_report(parser->diagnostics,
+                                              CN_DIAG_SEVERITY_ERROR,
+                                              CN_DIAG_CODE_PARSE_EXPECTED_TOKEN,
+                                              parser->lexer ? parser->lexer->filename : NULL,
+                                              parser->current.line,
+                                              parser->current.column,
+                                              "语法错误：函数体缺少匹配的 '}'");
+            }
+            return NULL;
+        }
+
+        // 暂存区多留一个位置给末尾的 EOF
+        if (count + 1 >= parser->skim_capacity) {
+            size_t new_capacity = parser->skim_capacity == 0 ? 256 : parser->skim_capacity * 2;
+            CnToken *new_tokens = (CnToken *)realloc(parser->skim_tokens, new_capacity * sizeof(CnToken));
+            if (!new_tokens) {
+                return NULL;
+            }
+            parser->skim_tokens = new_tokens;
+            parser->skim_capacity = new_capacity;
+        }
+        parser->skim_tokens[count++] = parser->current;
+
+        if (parser->current.kind == CN_TOKEN_LBRACE) {
+            depth++;
+        } else if (parser->current.kind == CN_TOKEN_RBRACE && --depth == 0) {
+            break;
         }
+        parser_fetch(parser);
     }
 
-    return program;
+    parser->skim_tokens[count] = parser->current;
+    parser->skim_tokens[count].kind = CN_TOKEN_EOF;
+    parser->skim_tokens[count].lexeme_length = 0;
+    count++;
+
+    lazy = (CnAstLazyBody *)ast_alloc(parser, sizeof(CnAstLazyBody));
+    if (!lazy) {
+        return NULL;
+    }
+    lazy->tokens = (CnToken *)ast_alloc(parser, count * sizeof(CnToken));
+    if (!lazy->tokens) {
+        return NULL;
+    }
+    memcpy(lazy->tokens, parser->skim_tokens, count * sizeof(CnToken));
+    lazy->token_count = count;
+    lazy->filename = parser->lexer ? parser->lexer->filename : NULL;
+    lazy->arena = parser->arena;
+
+    parser_advance(parser);  // 越过 '}'
+    return lazy;
 }
 
 static CnAstFunctionDecl *parse_function_decl(CnParser *parser)
@@ -567,7 +1424,7 @@ static CnAstFunctionDecl *parse_function_decl(CnParser *parser)
         return NULL;
     }
 
-    fn = (CnAstFunctionDecl *)malloc(sizeof(CnAstFunctionDecl));
+    fn = (CnAstFunctionDecl *)ast_alloc(parser, sizeof(CnAstFunctionDecl));
     if (!fn) {
         return NULL;
     }
@@ -585,6 +1442,7 @@ static CnAstFunctionDecl *parse_function_decl(CnParser *parser)
     fn->is_override = 0;            // 默认非重写函数
     fn->is_static = 0;              // 默认非静态方法
     fn->owning_scope = NULL;        // 函数作用域（由 scope_builder 创建）
+    fn->lazy_body = NULL;
 
     parser_advance(parser);
 
@@ -593,9 +1451,8 @@ static CnAstFunctionDecl *parse_function_decl(CnParser *parser)
     // 解析参数列表
     if (parser->current.kind != CN_TOKEN_RPAREN) {
         param_capacity = 4;
-        params = (CnAstParameter *)malloc(sizeof(CnAstParameter) * param_capacity);
+        params = (CnAstParameter *)ast_alloc(parser, sizeof(CnAstParameter) * param_capacity);
         if (!params) {
-            free(fn);
             return NULL;
         }
 
@@ -617,8 +1474,6 @@ static CnAstFunctionDecl *parse_function_decl(CnParser *parser)
                     parser_advance(parser);
                 } else {
                     // 类型解析失败且不是 '变量' 关键字
-                    free(params);
-                    free(fn);
                     return NULL;
                 }
             }
@@ -657,8 +1512,6 @@ static CnAstFunctionDecl *parse_function_decl(CnParser *parser)
                             size_t fp_param_count = 0;
                             CnType **fp_param_types = (CnType **)malloc(sizeof(CnType*) * fp_param_capacity);
                             if (!fp_param_types) {
-                                free(params);
-                                free(fn);
                                 return NULL;
                             }
                             
@@ -668,8 +1521,6 @@ static CnAstFunctionDecl *parse_function_decl(CnParser *parser)
                                     CnType *fp_param_type = parse_type(parser);
                                     if (!fp_param_type) {
                                         free(fp_param_types);
-                                        free(params);
-                                        free(fn);
                                         return NULL;
                                     }
                                     
@@ -680,8 +1531,6 @@ static CnAstFunctionDecl *parse_function_decl(CnParser *parser)
                                             fp_param_types, sizeof(CnType*) * fp_param_capacity);
                                         if (!new_fp_param_types) {
                                             free(fp_param_types);
-                                            free(params);
-                                            free(fn);
                                             return NULL;
                                         }
                                         fp_param_types = new_fp_param_types;
@@ -701,12 +1550,11 @@ static CnAstFunctionDecl *parse_function_decl(CnParser *parser)
                             if (parser_expect(parser, CN_TOKEN_RPAREN)) {
                                 // 创建函数类型和函数指针类型
                                 CnType *func_type = cn_type_new_function(param_type, fp_param_types, fp_param_count);
+                                free(fp_param_types);
                                 param_type = cn_type_new_pointer(func_type);
                                 // 参数名可能已经在上面解析，如果没有则在后面解析
                             } else {
                                 free(fp_param_types);
-                                free(params);
-                                free(fn);
                                 return NULL;
                             }
                         } else {
@@ -747,18 +1595,14 @@ static CnAstFunctionDecl *parse_function_decl(CnParser *parser)
                                                   parser->current.column,
                                                   "语法错误：缺少参数名");
                 }
-                free(params);
-                free(fn);
                 return NULL;
             }
 
             if (param_count >= param_capacity) {
                 param_capacity *= 2;
-                CnAstParameter *new_params = (CnAstParameter *)realloc(
-                    params, sizeof(CnAstParameter) * param_capacity);
+                CnAstParameter *new_params = (CnAstParameter *)ast_grow(parser,
+                    params, sizeof(CnAstParameter) * param_count, sizeof(CnAstParameter) * param_capacity);
                 if (!new_params) {
-                    free(params);
-                    free(fn);
                     return NULL;
                 }
                 params = new_params;
@@ -792,15 +1636,11 @@ static CnAstFunctionDecl *parse_function_decl(CnParser *parser)
                                                           parser->current.column,
                                                           "语法错误：数组参数大小必须是整数字面量或省略");
                         }
-                        free(params);
-                        free(fn);
                         return NULL;
                     }
                 }
                 
                 if (!parser_expect(parser, CN_TOKEN_RBRACKET)) {
-                    free(params);
-                    free(fn);
                     return NULL;
                 }
                 
@@ -853,8 +1693,6 @@ static CnAstFunctionDecl *parse_function_decl(CnParser *parser)
                                               parser->current.column,
                                               "语法错误：'->' 后必须指定返回类型");
             }
-            free(params);
-            free(fn);
             return NULL;
         }
     }
@@ -875,6 +1713,12 @@ static CnAstFunctionDecl *parse_function_decl(CnParser *parser)
         return fn;
     }
 
+    // 跳读模式：只保存函数体词元，首次需要时由 cn_frontend_parse_function_body 解析
+    if (parser->skim_bodies) {
+        fn->lazy_body = skim_function_body(parser);
+        return fn->lazy_body ? fn : NULL;
+    }
+
     // 函数定义：解析函数体
     // 设置函数体上下文标志，用于静态变量作用域检查
     parser->in_function_body = 1;
@@ -938,15 +1782,14 @@ static CnAstFunctionDecl *parse_interrupt_handler(CnParser *parser)
         return NULL;
     }
 
-    isr = (CnAstFunctionDecl *)malloc(sizeof(CnAstFunctionDecl));
+    isr = (CnAstFunctionDecl *)ast_alloc(parser, sizeof(CnAstFunctionDecl));
     if (!isr) {
         return NULL;
     }
 
     // 中断处理函数的名称为 "__isr_<向量号>"
-    char *isr_name = (char *)malloc(32);
+    char *isr_name = (char *)ast_alloc(parser, 32);
     if (!isr_name) {
-        free(isr);
         return NULL;
     }
     snprintf(isr_name, 32, "__isr_%u", vector_num);
@@ -975,8 +1818,6 @@ static CnAstFunctionDecl *parse_interrupt_handler(CnParser *parser)
                                           parser->current.column,
                                           "语法错误：中断处理函数不允许有参数");
         }
-        free((void*)isr->name);
-        free(isr);
         return NULL;
     }
 
@@ -998,7 +1839,13 @@ static CnAstBlockStmt *parse_block(CnParser *parser)
         return NULL;
     }
 
-    block = make_block();
+    block = make_block(parser);
+
+    // 嵌套过深时越过整个块，以空块代替
+    if (!parser_enter_nesting(parser)) {
+        parser_expect(parser, CN_TOKEN_RBRACE);
+        return block;
+    }
 
     while (parser->current.kind != CN_TOKEN_RBRACE &&
            parser->current.kind != CN_TOKEN_EOF) {
@@ -1006,9 +1853,10 @@ static CnAstBlockStmt *parse_block(CnParser *parser)
         if (!stmt) {
             break;
         }
-        block_add_stmt(block, stmt);
+        block_add_stmt(parser, block, stmt);
     }
 
+    parser_leave_nesting(parser);
     parser_expect(parser, CN_TOKEN_RBRACE);
 
     return block;
@@ -1033,50 +1881,54 @@ static CnAstStmt *parse_statement(CnParser *parser)
 
         parser_expect(parser, CN_TOKEN_SEMICOLON);
 
-        return make_return_stmt(value);
+        return make_return_stmt(parser, value);
     }
 
     if (parser->current.kind == CN_TOKEN_KEYWORD_IF) {
-        CnAstExpr *condition;
-        CnAstBlockStmt *then_block;
-        CnAstBlockStmt *else_block = NULL;
+        CnAstStmt *first = NULL;
+        CnAstStmt *last = NULL;
 
-        parser_advance(parser);
+        // "否则 如果" 链逐段循环解析，每段处理为上一段的 else { if ... }，链长不占用调用栈
+        for (;;) {
+            CnAstExpr *condition;
+            CnAstBlockStmt *then_block;
+            CnAstStmt *if_stmt;
 
-        parser_expect(parser, CN_TOKEN_LPAREN);
-        condition = parse_expression(parser);
-        parser_expect(parser, CN_TOKEN_RPAREN);
+            parser_advance(parser);
+
+            parser_expect(parser, CN_TOKEN_LPAREN);
+            condition = parse_expression(parser);
+            parser_expect(parser, CN_TOKEN_RPAREN);
 
-        then_block = parse_block(parser);
+            then_block = parse_block(parser);
+
+            if_stmt = make_if_stmt(parser, condition, then_block, NULL);
+            if (!if_stmt) {
+                return NULL;
+            }
+            if (last) {
+                // 创建一个只包含 if 语句的 else 块
+                last->as.if_stmt.else_block = make_block(parser);
+                block_add_stmt(parser, last->as.if_stmt.else_block, if_stmt);
+            } else {
+                first = if_stmt;
+            }
+            last = if_stmt;
 
-        if (parser->current.kind == CN_TOKEN_KEYWORD_ELSE) {
+            if (parser->current.kind != CN_TOKEN_KEYWORD_ELSE) {
+                break;
+            }
             parser_advance(parser);
-            
+
             // 支持 "否则 如果" (else if) 语法
-            if (parser->current.kind == CN_TOKEN_KEYWORD_IF) {
-                // 将 "否则 如果" 处理为 else { if ... }
-                // 递归解析 if 语句
-                CnAstStmt *nested_if = parse_statement(parser);
-                if (nested_if && nested_if->kind == CN_AST_STMT_IF) {
-                    // 创建一个只包含 if 语句的 else 块
-                    else_block = make_block();
-                    block_add_stmt(else_block, nested_if);
-                } else {
-                    // 解析失败，返回 NULL
-                    if (nested_if) {
-                        cn_frontend_ast_stmt_free(nested_if);
-                    }
-                    cn_frontend_ast_expr_free(condition);
-                    cn_frontend_ast_block_free(then_block);
-                    return NULL;
-                }
-            } else {
+            if (parser->current.kind != CN_TOKEN_KEYWORD_IF) {
                 // 普通的 else 块
-                else_block = parse_block(parser);
+                last->as.if_stmt.else_block = parse_block(parser);
+                break;
             }
         }
 
-        return make_if_stmt(condition, then_block, else_block);
+        return first;
     }
 
     if (parser->current.kind == CN_TOKEN_KEYWORD_WHILE) {
@@ -1091,7 +1943,7 @@ static CnAstStmt *parse_statement(CnParser *parser)
 
         body = parse_block(parser);
 
-        return make_while_stmt(condition, body);
+        return make_while_stmt(parser, condition, body);
     }
 
     if (parser->current.kind == CN_TOKEN_KEYWORD_FOR) {
@@ -1122,19 +1974,19 @@ static CnAstStmt *parse_statement(CnParser *parser)
 
         body = parse_block(parser);
 
-        return make_for_stmt(init, condition, update, body);
+        return make_for_stmt(parser, init, condition, update, body);
     }
 
     if (parser->current.kind == CN_TOKEN_KEYWORD_BREAK) {
         parser_advance(parser);
         parser_expect(parser, CN_TOKEN_SEMICOLON);
-        return make_break_stmt();
+        return make_break_stmt(parser);
     }
 
     if (parser->current.kind == CN_TOKEN_KEYWORD_CONTINUE) {
         parser_advance(parser);
         parser_expect(parser, CN_TOKEN_SEMICOLON);
-        return make_continue_stmt();
+        return make_continue_stmt(parser);
     }
 
     // 解析局部结构体定义（支持在函数内部定义结构体）
@@ -1169,20 +2021,17 @@ static CnAstStmt *parse_statement(CnParser *parser)
 
         // 期望 ')'
         if (!parser_expect(parser, CN_TOKEN_RPAREN)) {
-            cn_frontend_ast_expr_free(switch_expr);
             return NULL;
         }
 
         // 期望 '{'
         if (!parser_expect(parser, CN_TOKEN_LBRACE)) {
-            cn_frontend_ast_expr_free(switch_expr);
             return NULL;
         }
 
         // 分配 case 数组
-        cases = (CnAstSwitchCase *)malloc(sizeof(CnAstSwitchCase) * case_capacity);
+        cases = (CnAstSwitchCase *)ast_alloc(parser, sizeof(CnAstSwitchCase) * case_capacity);
         if (!cases) {
-            cn_frontend_ast_expr_free(switch_expr);
             return NULL;
         }
 
@@ -1198,25 +2047,11 @@ static CnAstStmt *parse_statement(CnParser *parser)
                 // 解析 case 值表达式
                 case_value = parse_expression(parser);
                 if (!case_value) {
-                    // 清理已分配的资源
-                    for (size_t i = 0; i < case_count; i++) {
-                        cn_frontend_ast_expr_free(cases[i].value);
-                        cn_frontend_ast_block_free(cases[i].body);
-                    }
-                    free(cases);
-                    cn_frontend_ast_expr_free(switch_expr);
                     return NULL;
                 }
 
                 // 期望 ':'
                 if (!parser_expect(parser, CN_TOKEN_COLON)) {
-                    cn_frontend_ast_expr_free(case_value);
-                    for (size_t i = 0; i < case_count; i++) {
-                        cn_frontend_ast_expr_free(cases[i].value);
-                        cn_frontend_ast_block_free(cases[i].body);
-                    }
-                    free(cases);
-                    cn_frontend_ast_expr_free(switch_expr);
                     return NULL;
                 }
             } else if (parser->current.kind == CN_TOKEN_KEYWORD_DEFAULT) {
@@ -1228,12 +2063,6 @@ static CnAstStmt *parse_statement(CnParser *parser)
 
                 // 期望 ':'
                 if (!parser_expect(parser, CN_TOKEN_COLON)) {
-                    for (size_t i = 0; i < case_count; i++) {
-                        cn_frontend_ast_expr_free(cases[i].value);
-                        cn_frontend_ast_block_free(cases[i].body);
-                    }
-                    free(cases);
-                    cn_frontend_ast_expr_free(switch_expr);
                     return NULL;
                 }
             } else {
@@ -1247,25 +2076,12 @@ static CnAstStmt *parse_statement(CnParser *parser)
                                                   parser->current.column,
                                                   "语法错误：switch 语句中期望 'case' 或 'default'");
                 }
-                for (size_t i = 0; i < case_count; i++) {
-                    cn_frontend_ast_expr_free(cases[i].value);
-                    cn_frontend_ast_block_free(cases[i].body);
-                }
-                free(cases);
-                cn_frontend_ast_expr_free(switch_expr);
                 return NULL;
             }
 
             // 解析 case/default 的语句序列（不需要大括号）
-            case_body = make_block();
+            case_body = make_block(parser);
             if (!case_body) {
-                cn_frontend_ast_expr_free(case_value);
-                for (size_t i = 0; i < case_count; i++) {
-                    cn_frontend_ast_expr_free(cases[i].value);
-                    cn_frontend_ast_block_free(cases[i].body);
-                }
-                free(cases);
-                cn_frontend_ast_expr_free(switch_expr);
                 return NULL;
             }
 
@@ -1276,32 +2092,17 @@ static CnAstStmt *parse_statement(CnParser *parser)
                    parser->current.kind != CN_TOKEN_EOF) {
                 CnAstStmt *stmt = parse_statement(parser);
                 if (!stmt) {
-                    cn_frontend_ast_expr_free(case_value);
-                    cn_frontend_ast_block_free(case_body);
-                    for (size_t i = 0; i < case_count; i++) {
-                        cn_frontend_ast_expr_free(cases[i].value);
-                        cn_frontend_ast_block_free(cases[i].body);
-                    }
-                    free(cases);
-                    cn_frontend_ast_expr_free(switch_expr);
                     return NULL;
                 }
-                block_add_stmt(case_body, stmt);
+                block_add_stmt(parser, case_body, stmt);
             }
 
             // 扩容 case 数组
             if (case_count >= case_capacity) {
                 case_capacity *= 2;
-                CnAstSwitchCase *new_cases = (CnAstSwitchCase *)realloc(cases, sizeof(CnAstSwitchCase) * case_capacity);
+                CnAstSwitchCase *new_cases = (CnAstSwitchCase *)ast_grow(parser, cases, sizeof(CnAstSwitchCase) * case_count,
+                    sizeof(CnAstSwitchCase) * case_capacity);
                 if (!new_cases) {
-                    cn_frontend_ast_expr_free(case_value);
-                    cn_frontend_ast_block_free(case_body);
-                    for (size_t i = 0; i < case_count; i++) {
-                        cn_frontend_ast_expr_free(cases[i].value);
-                        cn_frontend_ast_block_free(cases[i].body);
-                    }
-                    free(cases);
-                    cn_frontend_ast_expr_free(switch_expr);
                     return NULL;
                 }
                 cases = new_cases;
@@ -1315,16 +2116,10 @@ static CnAstStmt *parse_statement(CnParser *parser)
 
         // 期望 '}'
         if (!parser_expect(parser, CN_TOKEN_RBRACE)) {
-            for (size_t i = 0; i < case_count; i++) {
-                cn_frontend_ast_expr_free(cases[i].value);
-                cn_frontend_ast_block_free(cases[i].body);
-            }
-            free(cases);
-            cn_frontend_ast_expr_free(switch_expr);
             return NULL;
         }
 
-        return make_switch_stmt(switch_expr, cases, case_count);
+        return make_switch_stmt(parser, switch_expr, cases, case_count);
     }
 
     // 解析 try-catch-finally 语句：尝试 { ... } 捕获 (类型 变量) { ... } [最终 { ... }]
@@ -1344,9 +2139,8 @@ static CnAstStmt *parse_statement(CnParser *parser)
         }
 
         // 分配 catch 数组
-        catches = (CnAstCatchClause *)malloc(sizeof(CnAstCatchClause) * catch_capacity);
+        catches = (CnAstCatchClause *)ast_alloc(parser, sizeof(CnAstCatchClause) * catch_capacity);
         if (!catches) {
-            cn_frontend_ast_block_free(try_block);
             return NULL;
         }
 
@@ -1380,12 +2174,6 @@ static CnAstStmt *parse_statement(CnParser *parser)
                 // 如果是 ')' 则表示捕获所有异常
 
                 if (!parser_expect(parser, CN_TOKEN_RPAREN)) {
-                    // 清理资源
-                    for (size_t i = 0; i < catch_count; i++) {
-                        cn_frontend_ast_block_free(catches[i].body);
-                    }
-                    free(catches);
-                    cn_frontend_ast_block_free(try_block);
                     return NULL;
                 }
             }
@@ -1393,26 +2181,15 @@ static CnAstStmt *parse_statement(CnParser *parser)
             // 解析 catch 块
             catch_body = parse_block(parser);
             if (!catch_body) {
-                for (size_t i = 0; i < catch_count; i++) {
-                    cn_frontend_ast_block_free(catches[i].body);
-                }
-                free(catches);
-                cn_frontend_ast_block_free(try_block);
                 return NULL;
             }
 
             // 扩容 catch 数组
             if (catch_count >= catch_capacity) {
                 catch_capacity *= 2;
-                CnAstCatchClause *new_catches = (CnAstCatchClause *)realloc(catches,
-                    sizeof(CnAstCatchClause) * catch_capacity);
+                CnAstCatchClause *new_catches = (CnAstCatchClause *)ast_grow(parser, catches,
+                    sizeof(CnAstCatchClause) * catch_count, sizeof(CnAstCatchClause) * catch_capacity);
                 if (!new_catches) {
-                    cn_frontend_ast_block_free(catch_body);
-                    for (size_t i = 0; i < catch_count; i++) {
-                        cn_frontend_ast_block_free(catches[i].body);
-                    }
-                    free(catches);
-                    cn_frontend_ast_block_free(try_block);
                     return NULL;
                 }
                 catches = new_catches;
@@ -1432,41 +2209,22 @@ static CnAstStmt *parse_statement(CnParser *parser)
             parser_advance(parser); // 跳过 '最终'
             finally_block = parse_block(parser);
             if (!finally_block) {
-                for (size_t i = 0; i < catch_count; i++) {
-                    cn_frontend_ast_block_free(catches[i].body);
-                }
-                free(catches);
-                cn_frontend_ast_block_free(try_block);
                 return NULL;
             }
         }
 
         // 创建 try 语句节点
-        CnAstStmt *stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+        CnAstStmt *stmt = ast_new_stmt(parser, CN_AST_STMT_TRY);
         if (!stmt) {
-            if (finally_block) cn_frontend_ast_block_free(finally_block);
-            for (size_t i = 0; i < catch_count; i++) {
-                cn_frontend_ast_block_free(catches[i].body);
-            }
-            free(catches);
-            cn_frontend_ast_block_free(try_block);
             return NULL;
         }
 
-        stmt->kind = CN_AST_STMT_TRY;
         stmt->loc.filename = parser->lexer ? parser->lexer->filename : NULL;
         stmt->loc.line = parser->current.line;
         stmt->loc.column = parser->current.column;
 
-        CnAstTryStmt *try_stmt = (CnAstTryStmt *)malloc(sizeof(CnAstTryStmt));
+        CnAstTryStmt *try_stmt = (CnAstTryStmt *)ast_alloc(parser, sizeof(CnAstTryStmt));
         if (!try_stmt) {
-            free(stmt);
-            if (finally_block) cn_frontend_ast_block_free(finally_block);
-            for (size_t i = 0; i < catch_count; i++) {
-                cn_frontend_ast_block_free(catches[i].body);
-            }
-            free(catches);
-            cn_frontend_ast_block_free(try_block);
             return NULL;
         }
 
@@ -1492,13 +2250,16 @@ static CnAstStmt *parse_statement(CnParser *parser)
         // 检查是否是字符串字面量（简单异常抛出）
         if (parser->current.kind == CN_TOKEN_STRING_LITERAL) {
             // 简单形式：抛出 "异常类型" "消息";
-            exception_type = parser->current.lexeme_begin;
+            // 字符串字面量的词素指向源码，复制到 Arena 使 AST 不依赖源码文本
+            exception_type = cn_arena_strndup(parser->arena, parser->current.lexeme_begin,
+                                              parser->current.lexeme_length);
             exception_type_length = parser->current.lexeme_length;
             parser_advance(parser);
 
             // 可选的消息
             if (parser->current.kind == CN_TOKEN_STRING_LITERAL) {
-                message = parser->current.lexeme_begin;
+                message = cn_arena_strndup(parser->arena, parser->current.lexeme_begin,
+                                           parser->current.lexeme_length);
                 message_length = parser->current.lexeme_length;
                 parser_advance(parser);
             }
@@ -1513,13 +2274,11 @@ static CnAstStmt *parse_statement(CnParser *parser)
         parser_expect(parser, CN_TOKEN_SEMICOLON);
 
         // 创建 throw 语句节点
-        CnAstStmt *stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+        CnAstStmt *stmt = ast_new_stmt(parser, CN_AST_STMT_THROW);
         if (!stmt) {
-            if (exception_expr) cn_frontend_ast_expr_free(exception_expr);
             return NULL;
         }
 
-        stmt->kind = CN_AST_STMT_THROW;
         stmt->loc.filename = parser->lexer ? parser->lexer->filename : NULL;
         stmt->loc.line = parser->current.line;
         stmt->loc.column = parser->current.column;
@@ -1559,35 +2318,11 @@ static CnAstStmt *parse_statement(CnParser *parser)
             is_var_decl = 1;
         } else if (next_kind == CN_TOKEN_STAR) {
             // 类型名后跟 *，可能是指针类型声明
-            // 需要进一步检查 * 后面是否是标识符
-            // 保存当前状态，向前看两个token
-            const char *saved_source = parser->lexer->source;
-            const char *saved_filename = parser->lexer->filename;
-            size_t saved_length = parser->lexer->length;
-            size_t saved_offset = parser->lexer->offset;
-            int saved_line = parser->lexer->line;
-            int saved_column = parser->lexer->column;
-            
-            // 跳过 * token
-            CnToken star_token;
-            if (cn_frontend_lexer_next_token(parser->lexer, &star_token)) {
-                // 检查 * 后面的token
-                CnToken after_star_token;
-                if (cn_frontend_lexer_next_token(parser->lexer, &after_star_token)) {
-                    if (after_star_token.kind == CN_TOKEN_IDENT) {
-                        // 类型名* 标识符，是指针类型变量声明
-                        is_var_decl = 1;
-                    }
-                }
+            // 需要进一步检查 * 后面是否是标识符（向前看两个token）
+            if (parser_peek_n(parser, 1) == CN_TOKEN_IDENT) {
+                // 类型名* 标识符，是指针类型变量声明
+                is_var_decl = 1;
             }
-            
-            // 恢复lexer状态
-            parser->lexer->source = saved_source;
-            parser->lexer->filename = saved_filename;
-            parser->lexer->length = saved_length;
-            parser->lexer->offset = saved_offset;
-            parser->lexer->line = saved_line;
-            parser->lexer->column = saved_column;
         }
         // 否则不是变量声明，可能是赋值语句
     }
@@ -1840,6 +2575,7 @@ static CnAstStmt *parse_statement(CnParser *parser)
                 
                 // 创建函数类型
                 CnType *func_type = cn_type_new_function(declared_type, param_types, param_count);
+                free(param_types);
                 
                 // 函数指针是指向函数类型的指针
                 declared_type = cn_type_new_pointer(func_type);
@@ -1852,7 +2588,7 @@ static CnAstStmt *parse_statement(CnParser *parser)
                 
                 parser_expect(parser, CN_TOKEN_SEMICOLON);
                 
-                CnAstStmt *stmt = make_var_decl_stmt(var_name, var_name_length, declared_type, initializer, CN_VISIBILITY_DEFAULT);
+                CnAstStmt *stmt = make_var_decl_stmt(parser, var_name, var_name_length, declared_type, initializer, CN_VISIBILITY_DEFAULT);
                 if (stmt) {
                     if (is_const) {
                         stmt->as.var_decl.is_const = 1;
@@ -1988,7 +2724,7 @@ static CnAstStmt *parse_statement(CnParser *parser)
 
             if (parser->current.kind != CN_TOKEN_RPAREN) {
                 arg_capacity = 4;
-                args = (CnAstExpr **)malloc(sizeof(CnAstExpr *) * arg_capacity);
+                args = (CnAstExpr **)ast_alloc(parser, sizeof(CnAstExpr *) * arg_capacity);
                 if (!args) {
                     return NULL;
                 }
@@ -1996,13 +2732,9 @@ static CnAstStmt *parse_statement(CnParser *parser)
                 do {
                     if (arg_count >= arg_capacity) {
                         arg_capacity *= 2;
-                        CnAstExpr **new_args = (CnAstExpr **)realloc(
-                            args, sizeof(CnAstExpr *) * arg_capacity);
+                        CnAstExpr **new_args = (CnAstExpr **)ast_grow(parser,
+                            args, sizeof(CnAstExpr *) * arg_count, sizeof(CnAstExpr *) * arg_capacity);
                         if (!new_args) {
-                            for (size_t i = 0; i < arg_count; i++) {
-                                cn_frontend_ast_expr_free(args[i]);
-                            }
-                            free(args);
                             return NULL;
                         }
                         args = new_args;
@@ -2010,10 +2742,6 @@ static CnAstStmt *parse_statement(CnParser *parser)
 
                     args[arg_count] = parse_expression(parser);
                     if (!args[arg_count]) {
-                        for (size_t i = 0; i < arg_count; i++) {
-                            cn_frontend_ast_expr_free(args[i]);
-                        }
-                        free(args);
                         return NULL;
                     }
                     arg_count++;
@@ -2031,15 +2759,10 @@ static CnAstStmt *parse_statement(CnParser *parser)
 
             // 创建构造函数调用表达式作为初始化器
             // 构造函数名为类型名，例如：学生("张三", 20, 85.5)
-            CnAstExpr *type_name_expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+            CnAstExpr *type_name_expr = ast_new_expr(parser, CN_AST_EXPR_IDENTIFIER);
             if (!type_name_expr) {
-                for (size_t i = 0; i < arg_count; i++) {
-                    cn_frontend_ast_expr_free(args[i]);
-                }
-                free(args);
                 return NULL;
             }
-            type_name_expr->kind = CN_AST_EXPR_IDENTIFIER;
             type_name_expr->type = NULL;
             type_name_expr->loc.filename = parser->lexer ? parser->lexer->filename : NULL;
             type_name_expr->loc.line = parser->current.line;
@@ -2049,14 +2772,17 @@ static CnAstStmt *parse_statement(CnParser *parser)
             type_name_expr->as.identifier.name_length = type_name_length;
 
             // 创建函数调用表达式
-            initializer = make_call(type_name_expr, args, arg_count);
+            initializer = make_call(parser, type_name_expr, args, arg_count);
         }
 
         if (parser->current.kind == CN_TOKEN_EQUAL) {
             parser_advance(parser);
             // 检查是否是结构体字面量初始化：{ ... }
             // 如果有类型名且当前是 {，则解析为结构体字面量
-            if (parser->current.kind == CN_TOKEN_LBRACE && type_name && type_name_length > 0) {
+            if (parser->current.kind == CN_TOKEN_LBRACE && type_name && type_name_length > 0 &&
+                declared_type && declared_type->kind == CN_TYPE_ARRAY) {
+                initializer = parse_struct_array_initializer(parser, type_name, type_name_length);
+            } else if (parser->current.kind == CN_TOKEN_LBRACE && type_name && type_name_length > 0) {
                 initializer = parse_struct_literal_with_name(parser, type_name, type_name_length);
             } else {
                 initializer = parse_expression(parser);
@@ -2065,7 +2791,7 @@ static CnAstStmt *parse_statement(CnParser *parser)
 
         parser_expect(parser, CN_TOKEN_SEMICOLON);
 
-        CnAstStmt *stmt = make_var_decl_stmt(var_name, var_name_length, declared_type, initializer, CN_VISIBILITY_DEFAULT);
+        CnAstStmt *stmt = make_var_decl_stmt(parser, var_name, var_name_length, declared_type, initializer, CN_VISIBILITY_DEFAULT);
         if (stmt) {
             if (is_const) {
                 stmt->as.var_decl.is_const = 1;
@@ -2084,311 +2810,253 @@ static CnAstStmt *parse_statement(CnParser *parser)
 
     parser_expect(parser, CN_TOKEN_SEMICOLON);
 
-    return make_expr_stmt(expr);
-}
-
-static CnAstExpr *parse_expression(CnParser *parser)
-{
-    return parse_assignment(parser);
+    return make_expr_stmt(parser, expr);
 }
 
-static CnAstExpr *parse_assignment(CnParser *parser)
+/*
+ * 二元/三元/赋值表达式采用 Pratt（优先级爬升）解析：
+ * 中缀运算符的绑定力按 CnTokenKind 查表，一个循环处理所有优先级，
+ * 不再为每个优先级各嵌套一层函数调用。数值越大结合越紧。
+ */
+enum {
+    CN_BP_NONE = 0,
+    CN_BP_ASSIGNMENT,       // =（右结合）
+    CN_BP_TERNARY,          // ?:（右结合）
+    CN_BP_LOGICAL_OR,       // ||
+    CN_BP_LOGICAL_AND,      // &&
+    CN_BP_BITWISE_OR,       // |
+    CN_BP_BITWISE_XOR,      // ^
+    CN_BP_BITWISE_AND,      // &
+    CN_BP_COMPARISON,       // == != < > <= >=
+    CN_BP_SHIFT,            // << >>
+    CN_BP_ADDITIVE,         // + -
+    CN_BP_MULTIPLICATIVE    // * / %
+};
+
+typedef struct CnInfixRule {
+    unsigned char power;        // 左绑定力，CN_BP_NONE 表示不是中缀运算符
+    unsigned char right_power;  // 右操作数允许的最小绑定力
+    unsigned char is_logical;   // op 为 CnAstLogicalOp 而非 CnAstBinaryOp
+    unsigned char op;
+} CnInfixRule;
+
+// 比较运算的右操作数从加减层开始解析（与原递归下降语法一致），因此 a < b << c 中的 << 不会被右操作数吸收
+static const CnInfixRule g_infix_rules[CN_TOKEN_EOF + 1] = {
+    [CN_TOKEN_EQUAL]         = {CN_BP_ASSIGNMENT, CN_BP_ASSIGNMENT, 0, 0},
+    [CN_TOKEN_QUESTION]      = {CN_BP_TERNARY, CN_BP_TERNARY, 0, 0},
+    [CN_TOKEN_LOGICAL_OR]    = {CN_BP_LOGICAL_OR, CN_BP_LOGICAL_AND, 1, CN_AST_LOGICAL_OP_OR},
+    [CN_TOKEN_LOGICAL_AND]   = {CN_BP_LOGICAL_AND, CN_BP_BITWISE_OR, 1, CN_AST_LOGICAL_OP_AND},
+    [CN_TOKEN_BITWISE_OR]    = {CN_BP_BITWISE_OR, CN_BP_BITWISE_XOR, 0, CN_AST_BINARY_OP_BITWISE_OR},
+    [CN_TOKEN_BITWISE_XOR]   = {CN_BP_BITWISE_XOR, CN_BP_BITWISE_AND, 0, CN_AST_BINARY_OP_BITWISE_XOR},
+    [CN_TOKEN_AMPERSAND]     = {CN_BP_BITWISE_AND, CN_BP_COMPARISON, 0, CN_AST_BINARY_OP_BITWISE_AND},
+    [CN_TOKEN_BITWISE_AND]   = {CN_BP_BITWISE_AND, CN_BP_COMPARISON, 0, CN_AST_BINARY_OP_BITWISE_AND},
+    [CN_TOKEN_EQUAL_EQUAL]   = {CN_BP_COMPARISON, CN_BP_ADDITIVE, 0, CN_AST_BINARY_OP_EQ},
+    [CN_TOKEN_BANG_EQUAL]    = {CN_BP_COMPARISON, CN_BP_ADDITIVE, 0, CN_AST_BINARY_OP_NE},
+    [CN_TOKEN_LESS]          = {CN_BP_COMPARISON, CN_BP_ADDITIVE, 0, CN_AST_BINARY_OP_LT},
+    [CN_TOKEN_GREATER]       = {CN_BP_COMPARISON, CN_BP_ADDITIVE, 0, CN_AST_BINARY_OP_GT},
+    [CN_TOKEN_LESS_EQUAL]    = {CN_BP_COMPARISON, CN_BP_ADDITIVE, 0, CN_AST_BINARY_OP_LE},
+    [CN_TOKEN_GREATER_EQUAL] = {CN_BP_COMPARISON, CN_BP_ADDITIVE, 0, CN_AST_BINARY_OP_GE},
+    [CN_TOKEN_LEFT_SHIFT]    = {CN_BP_SHIFT, CN_BP_ADDITIVE, 0, CN_AST_BINARY_OP_LEFT_SHIFT},
+    [CN_TOKEN_RIGHT_SHIFT]   = {CN_BP_SHIFT, CN_BP_ADDITIVE, 0, CN_AST_BINARY_OP_RIGHT_SHIFT},
+    [CN_TOKEN_PLUS]          = {CN_BP_ADDITIVE, CN_BP_MULTIPLICATIVE, 0, CN_AST_BINARY_OP_ADD},
+    [CN_TOKEN_MINUS]         = {CN_BP_ADDITIVE, CN_BP_MULTIPLICATIVE, 0, CN_AST_BINARY_OP_SUB},
+    [CN_TOKEN_STAR]          = {CN_BP_MULTIPLICATIVE, CN_BP_MULTIPLICATIVE + 1, 0, CN_AST_BINARY_OP_MUL},
+    [CN_TOKEN_SLASH]         = {CN_BP_MULTIPLICATIVE, CN_BP_MULTIPLICATIVE + 1, 0, CN_AST_BINARY_OP_DIV},
+    [CN_TOKEN_PERCENT]       = {CN_BP_MULTIPLICATIVE, CN_BP_MULTIPLICATIVE + 1, 0, CN_AST_BINARY_OP_MOD},
+};
+
+// 递归解析一个完整的子表达式或右结合运算的右操作数，计入嵌套层数
+static CnAstExpr *parse_nested_binary(CnParser *parser, int min_power)
 {
-    CnAstExpr *expr = parse_ternary(parser);  // 三元运算符优先级低于赋值
+    CnAstExpr *expr;
 
-    if (parser->current.kind == CN_TOKEN_EQUAL) {
-        // 保存赋值符号的位置信息
-        CnToken assign_token = parser->current;
-        parser_advance(parser);
-        CnAstExpr *value = parse_assignment(parser);  // 右结合
-        CnAstExpr *assign_expr = make_assign(expr, value);
-        if (assign_expr) {
-            // 设置赋值表达式的位置信息为赋值符号的位置
-            assign_expr->loc.filename = parser->lexer ? parser->lexer->filename : NULL;
-            assign_expr->loc.line = assign_token.line;
-            assign_expr->loc.column = assign_token.column;
-        }
-        return assign_expr;
+    if (!parser_enter_nesting(parser)) {
+        return NULL;
     }
-
+    expr = parse_binary_expression(parser, min_power);
+    parser_leave_nesting(parser);
     return expr;
 }
 
-// 解析三元运算符表达式 (condition ? true_expr : false_expr)
-// 三元运算符优先级介于赋值和逻辑或之间，且是右结合
-static CnAstExpr *parse_ternary(CnParser *parser)
-{
-    CnAstExpr *condition = parse_logical_or(parser);
-
-    if (parser->current.kind == CN_TOKEN_QUESTION) {
-        CnToken question_token = parser->current;
-        parser_advance(parser);
-        
-        CnAstExpr *true_expr = parse_expression(parser);  // 递归调用 parse_expression 以支持嵌套
-        
-        if (parser->current.kind != CN_TOKEN_COLON) {
-            parser->error_count++;
-            if (parser->diagnostics) {
-                cn_support_diagnostics_report(parser->diagnostics,
-                                              CN_DIAG_SEVERITY_ERROR,
-                                              CN_DIAG_CODE_PARSE_EXPECTED_TOKEN,
-                                              parser->lexer ? parser->lexer->filename : NULL,
-                                              parser->current.line,
-                                              parser->current.column,
-                                              "语法错误：三元运算符需要 \":\" 分隔真假分支");
-            }
-            return condition;
-        }
-        
-        parser_advance(parser);  // 跳过 ':'
-        
-        CnAstExpr *false_expr = parse_ternary(parser);  // 右结合，递归调用 parse_ternary
-        
-        // 创建三元表达式节点
-        CnAstExpr *ternary_expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
-        if (!ternary_expr) {
-            return condition;
-        }
-        
-        ternary_expr->kind = CN_AST_EXPR_TERNARY;
-        ternary_expr->type = NULL;
-        ternary_expr->loc.filename = parser->lexer ? parser->lexer->filename : NULL;
-        ternary_expr->loc.line = question_token.line;
-        ternary_expr->loc.column = question_token.column;
-        ternary_expr->as.ternary.condition = condition;
-        ternary_expr->as.ternary.true_expr = true_expr;
-        ternary_expr->as.ternary.false_expr = false_expr;
-        
-        return ternary_expr;
-    }
-
-    return condition;
-}
-
-static CnAstExpr *parse_logical_or(CnParser *parser)
+static CnAstExpr *parse_expression(CnParser *parser)
 {
-    CnAstExpr *left = parse_logical_and(parser);
-
-    while (parser->current.kind == CN_TOKEN_LOGICAL_OR) {
-        parser_advance(parser);
-        CnAstExpr *right = parse_logical_and(parser);
-        left = make_logical(CN_AST_LOGICAL_OP_OR, left, right);
-    }
-
-    return left;
+    return parse_nested_binary(parser, CN_BP_ASSIGNMENT);
 }
 
-static CnAstExpr *parse_logical_and(CnParser *parser)
+// 解析三元运算符的 "? 真分支 : 假分支" 部分，condition 已解析且当前标记为 '?'
+static CnAstExpr *parse_ternary_rest(CnParser *parser, CnAstExpr *condition)
 {
-    CnAstExpr *left = parse_bitwise_or(parser);
-
-    while (parser->current.kind == CN_TOKEN_LOGICAL_AND) {
-        parser_advance(parser);
-        CnAstExpr *right = parse_bitwise_or(parser);
-        left = make_logical(CN_AST_LOGICAL_OP_AND, left, right);
-    }
-
-    return left;
-}
+    CnToken question_token = parser->current;
+    parser_advance(parser);
 
-// 按位或运算：优先级低于按位异或
-static CnAstExpr *parse_bitwise_or(CnParser *parser)
-{
-    CnAstExpr *left = parse_bitwise_xor(parser);
+    CnAstExpr *true_expr = parse_expression(parser);  // 真分支可以是任意表达式（含赋值与嵌套三元）
 
-    while (parser->current.kind == CN_TOKEN_BITWISE_OR) {
-        parser_advance(parser);
-        CnAstExpr *right = parse_bitwise_xor(parser);
-        left = make_binary(CN_AST_BINARY_OP_BITWISE_OR, left, right);
+    if (parser->current.kind != CN_TOKEN_COLON) {
+        parser->error_count++;
+        if (parser->diagnostics) {
+            cn_support_diagnostics_report(parser->diagnostics,
+                                          CN_DIAG_SEVERITY_ERROR,
+                                          CN_DIAG_CODE_PARSE_EXPECTED_TOKEN,
+                                          parser->lexer ? parser->lexer->filename : NULL,
+                                          parser->current.line,
+                                          parser->current.column,
+                                          "语法错误：三元运算符需要 \":\" 分隔真假分支");
+        }
+        return condition;
     }
 
-    return left;
-}
+    parser_advance(parser);  // 跳过 ':'
 
-// 按位异或运算：优先级低于按位与
-static CnAstExpr *parse_bitwise_xor(CnParser *parser)
-{
-    CnAstExpr *left = parse_bitwise_and(parser);
+    CnAstExpr *false_expr = parse_nested_binary(parser, CN_BP_TERNARY);  // 右结合
 
-    while (parser->current.kind == CN_TOKEN_BITWISE_XOR) {
-        parser_advance(parser);
-        CnAstExpr *right = parse_bitwise_and(parser);
-        left = make_binary(CN_AST_BINARY_OP_BITWISE_XOR, left, right);
+    // 创建三元表达式节点
+    CnAstExpr *ternary_expr = ast_new_expr(parser, CN_AST_EXPR_TERNARY);
+    if (!ternary_expr) {
+        return condition;
     }
 
-    return left;
-}
-
-// 按位与运算：优先级低于比较运算
-static CnAstExpr *parse_bitwise_and(CnParser *parser)
-{
-    CnAstExpr *left = parse_comparison(parser);
-
-    while (parser->current.kind == CN_TOKEN_AMPERSAND ||
-           parser->current.kind == CN_TOKEN_BITWISE_AND) {
-        parser_advance(parser);
-        CnAstExpr *right = parse_comparison(parser);
-        left = make_binary(CN_AST_BINARY_OP_BITWISE_AND, left, right);
-    }
+    ternary_expr->type = NULL;
+    ternary_expr->loc.filename = parser->lexer ? parser->lexer->filename : NULL;
+    ternary_expr->loc.line = question_token.line;
+    ternary_expr->loc.column = question_token.column;
+    ternary_expr->as.ternary.condition = condition;
+    ternary_expr->as.ternary.true_expr = true_expr;
+    ternary_expr->as.ternary.false_expr = false_expr;
 
-    return left;
+    return ternary_expr;
 }
 
-static CnAstExpr *parse_shift(CnParser *parser)
+// 解析绑定力不低于 min_power 的中缀表达式
+static CnAstExpr *parse_binary_expression(CnParser *parser, int min_power)
 {
-    CnAstExpr *left = parse_additive(parser);
-
-    while (parser->current.kind == CN_TOKEN_LEFT_SHIFT ||
-           parser->current.kind == CN_TOKEN_RIGHT_SHIFT) {
-        CnAstBinaryOp op = (parser->current.kind == CN_TOKEN_LEFT_SHIFT)
-                               ? CN_AST_BINARY_OP_LEFT_SHIFT
-                               : CN_AST_BINARY_OP_RIGHT_SHIFT;
-        parser_advance(parser);
-        left = make_binary(op, left, parse_additive(parser));
-    }
+    CnAstExpr *left = parse_unary(parser);
+    // 已归约过某一层运算符后，只能继续接同层或更低层的运算符（左结合）
+    int max_power = CN_BP_MULTIPLICATIVE;
 
-    return left;
-}
+    for (;;) {
+        CnTokenKind kind = parser->current.kind;
+        const CnInfixRule *rule;
 
-static CnAstExpr *parse_comparison(CnParser *parser)
-{
-    CnAstExpr *left = parse_shift(parser);
-
-    while (parser->current.kind == CN_TOKEN_EQUAL_EQUAL ||
-           parser->current.kind == CN_TOKEN_BANG_EQUAL ||
-           parser->current.kind == CN_TOKEN_LESS ||
-           parser->current.kind == CN_TOKEN_GREATER ||
-           parser->current.kind == CN_TOKEN_LESS_EQUAL ||
-           parser->current.kind == CN_TOKEN_GREATER_EQUAL) {
-        CnAstBinaryOp op;
-
-        switch (parser->current.kind) {
-        case CN_TOKEN_EQUAL_EQUAL:
-            op = CN_AST_BINARY_OP_EQ;
-            break;
-        case CN_TOKEN_BANG_EQUAL:
-            op = CN_AST_BINARY_OP_NE;
-            break;
-        case CN_TOKEN_LESS:
-            op = CN_AST_BINARY_OP_LT;
+        if ((unsigned)kind > CN_TOKEN_EOF) {
             break;
-        case CN_TOKEN_GREATER:
-            op = CN_AST_BINARY_OP_GT;
-            break;
-        case CN_TOKEN_LESS_EQUAL:
-            op = CN_AST_BINARY_OP_LE;
-            break;
-        case CN_TOKEN_GREATER_EQUAL:
-            op = CN_AST_BINARY_OP_GE;
+        }
+        rule = &g_infix_rules[kind];
+        if (rule->power == CN_BP_NONE || rule->power < min_power || rule->power > max_power) {
             break;
-        default:
-            parser->error_count++;
-            if (parser->diagnostics) {
-                cn_support_diagnostics_report(parser->diagnostics,
-                                              CN_DIAG_SEVERITY_ERROR,
-                                              CN_DIAG_CODE_PARSE_INVALID_COMPARISON_OP,
-                                              parser->lexer ? parser->lexer->filename : NULL,
-                                              parser->current.line,
-                                              parser->current.column,
-                                              "语法错误：比较运算符无效");
-            }
-            return left;
         }
 
-        parser_advance(parser);
-        left = make_binary(op, left, parse_additive(parser));
-    }
-
-    return left;
-}
+        if (kind == CN_TOKEN_EQUAL) {
+            // 保存赋值符号的位置信息
+            CnToken assign_token = parser->current;
+            parser_advance(parser);
+            CnAstExpr *value = parse_nested_binary(parser, CN_BP_ASSIGNMENT);  // 右结合
+            CnAstExpr *assign_expr = make_assign(parser, left, value);
+            if (assign_expr) {
+                // 设置赋值表达式的位置信息为赋值符号的位置
+                assign_expr->loc.filename = parser->lexer ? parser->lexer->filename : NULL;
+                assign_expr->loc.line = assign_token.line;
+                assign_expr->loc.column = assign_token.column;
+            }
+            return assign_expr;
+        }
 
-static CnAstExpr *parse_additive(CnParser *parser)
-{
-    CnAstExpr *left = parse_term(parser);
+        if (kind == CN_TOKEN_QUESTION) {
+            // 三元运算符之后只可能再接赋值
+            left = parse_ternary_rest(parser, left);
+            max_power = CN_BP_ASSIGNMENT;
+            continue;
+        }
 
-    while (parser->current.kind == CN_TOKEN_PLUS ||
-           parser->current.kind == CN_TOKEN_MINUS) {
-        CnAstBinaryOp op = (parser->current.kind == CN_TOKEN_PLUS)
-                               ? CN_AST_BINARY_OP_ADD
-                               : CN_AST_BINARY_OP_SUB;
         parser_advance(parser);
-        left = make_binary(op, left, parse_term(parser));
+        // 乘除模的右操作数不会再接任何中缀运算符，直接解析一元表达式
+        CnAstExpr *right = rule->right_power > CN_BP_MULTIPLICATIVE
+                               ? parse_unary(parser)
+                               : parse_binary_expression(parser, rule->right_power);
+        if (rule->is_logical) {
+            left = make_logical(parser, (CnAstLogicalOp)rule->op, left, right);
+        } else {
+            left = make_binary(parser, (CnAstBinaryOp)rule->op, left, right);
+        }
+        max_power = rule->power;
     }
 
     return left;
 }
 
-static CnAstExpr *parse_term(CnParser *parser)
+static CnAstExpr *parse_unary(CnParser *parser)
 {
-    CnAstExpr *left = parse_unary(parser);
+    CnAstExpr *expr;
 
-    while (parser->current.kind == CN_TOKEN_STAR ||
-           parser->current.kind == CN_TOKEN_SLASH ||
-           parser->current.kind == CN_TOKEN_PERCENT) {
-        CnAstBinaryOp op;
-        if (parser->current.kind == CN_TOKEN_STAR) {
-            op = CN_AST_BINARY_OP_MUL;
-        } else if (parser->current.kind == CN_TOKEN_SLASH) {
-            op = CN_AST_BINARY_OP_DIV;
-        } else {
-            op = CN_AST_BINARY_OP_MOD;
+    switch (parser->current.kind) {
+    case CN_TOKEN_PLUS_PLUS:
+    case CN_TOKEN_MINUS_MINUS:
+    case CN_TOKEN_AMPERSAND:
+    case CN_TOKEN_STAR:
+    case CN_TOKEN_BANG:
+    case CN_TOKEN_BITWISE_NOT:
+    case CN_TOKEN_MINUS:
+        // 连续的前缀运算符逐层递归，计入嵌套层数
+        if (!parser_enter_nesting(parser)) {
+            return NULL;
         }
-        parser_advance(parser);
-        left = make_binary(op, left, parse_unary(parser));
+        expr = parse_prefix_unary(parser);
+        parser_leave_nesting(parser);
+        return expr;
+    default:
+        return parse_postfix(parser);  // 支持后缀表达式（如函数调用、数组索引）
     }
-
-    return left;
 }
 
-static CnAstExpr *parse_unary(CnParser *parser)
+// 解析以前缀运算符开头的一元表达式
+static CnAstExpr *parse_prefix_unary(CnParser *parser)
 {
     // 处理前置自增运算符 ++
     if (parser->current.kind == CN_TOKEN_PLUS_PLUS) {
         parser_advance(parser);
         CnAstExpr *operand = parse_unary(parser);
-        return make_unary(CN_AST_UNARY_OP_PRE_INC, operand);
+        return make_unary(parser, CN_AST_UNARY_OP_PRE_INC, operand);
     }
 
     // 处理前置自减运算符 --
     if (parser->current.kind == CN_TOKEN_MINUS_MINUS) {
         parser_advance(parser);
         CnAstExpr *operand = parse_unary(parser);
-        return make_unary(CN_AST_UNARY_OP_PRE_DEC, operand);
+        return make_unary(parser, CN_AST_UNARY_OP_PRE_DEC, operand);
     }
 
     // 处理取地址运算符 &
     if (parser->current.kind == CN_TOKEN_AMPERSAND) {
         parser_advance(parser);
         CnAstExpr *operand = parse_unary(parser);  // 递归支持连续 &
-        return make_unary(CN_AST_UNARY_OP_ADDRESS_OF, operand);
+        return make_unary(parser, CN_AST_UNARY_OP_ADDRESS_OF, operand);
     }
 
     // 处理解引用运算符 *
     if (parser->current.kind == CN_TOKEN_STAR) {
         parser_advance(parser);
         CnAstExpr *operand = parse_unary(parser);  // 递归支持连续 *
-        return make_unary(CN_AST_UNARY_OP_DEREFERENCE, operand);
+        return make_unary(parser, CN_AST_UNARY_OP_DEREFERENCE, operand);
     }
 
     // 处理逻辑非运算符 !
     if (parser->current.kind == CN_TOKEN_BANG) {
         parser_advance(parser);
         CnAstExpr *operand = parse_unary(parser);  // 递归处理多个 !
-        return make_unary(CN_AST_UNARY_OP_NOT, operand);
+        return make_unary(parser, CN_AST_UNARY_OP_NOT, operand);
     }
 
     // 处理按位取反运算符 ~
     if (parser->current.kind == CN_TOKEN_BITWISE_NOT) {
         parser_advance(parser);
         CnAstExpr *operand = parse_unary(parser);  // 递归处理多个 ~
-        return make_unary(CN_AST_UNARY_OP_BITWISE_NOT, operand);
+        return make_unary(parser, CN_AST_UNARY_OP_BITWISE_NOT, operand);
     }
 
     // 处理一元负号 -
     if (parser->current.kind == CN_TOKEN_MINUS) {
         parser_advance(parser);
         CnAstExpr *operand = parse_unary(parser);  // 递归处理多个 -
-        return make_unary(CN_AST_UNARY_OP_MINUS, operand);
+        return make_unary(parser, CN_AST_UNARY_OP_MINUS, operand);
     }
 
     return parse_postfix(parser);  // 支持后缀表达式（如函数调用、数组索引）
@@ -2415,23 +3083,17 @@ static CnAstExpr *parse_postfix(CnParser *parser)
 
             if (parser->current.kind != CN_TOKEN_RPAREN) {
                 arg_capacity = 4;
-                args = (CnAstExpr **)malloc(sizeof(CnAstExpr *) * arg_capacity);
+                args = (CnAstExpr **)ast_alloc(parser, sizeof(CnAstExpr *) * arg_capacity);
                 if (!args) {
-                    cn_frontend_ast_expr_free(expr);
                     return NULL;
                 }
 
                 do {
                     if (arg_count >= arg_capacity) {
                         arg_capacity *= 2;
-                        CnAstExpr **new_args = (CnAstExpr **)realloc(
-                            args, sizeof(CnAstExpr *) * arg_capacity);
+                        CnAstExpr **new_args = (CnAstExpr **)ast_grow(parser,
+                            args, sizeof(CnAstExpr *) * arg_count, sizeof(CnAstExpr *) * arg_capacity);
                         if (!new_args) {
-                            for (size_t i = 0; i < arg_count; i++) {
-                                cn_frontend_ast_expr_free(args[i]);
-                            }
-                            free(args);
-                            cn_frontend_ast_expr_free(expr);
                             return NULL;
                         }
                         args = new_args;
@@ -2439,11 +3101,6 @@ static CnAstExpr *parse_postfix(CnParser *parser)
 
                     args[arg_count] = parse_expression(parser);
                     if (!args[arg_count]) {
-                        for (size_t i = 0; i < arg_count; i++) {
-                            cn_frontend_ast_expr_free(args[i]);
-                        }
-                        free(args);
-                        cn_frontend_ast_expr_free(expr);
                         return NULL;
                     }
                     arg_count++;
@@ -2459,20 +3116,19 @@ static CnAstExpr *parse_postfix(CnParser *parser)
 
             parser_expect(parser, CN_TOKEN_RPAREN);
 
-            expr = make_call(expr, args, arg_count);
+            expr = make_call(parser, expr, args, arg_count);
         } else if (parser->current.kind == CN_TOKEN_LBRACKET) {
             // 数组索引访问 arr[index]
             parser_advance(parser);  // 跳过 [
             
             CnAstExpr *index_expr = parse_expression(parser);
             if (!index_expr) {
-                cn_frontend_ast_expr_free(expr);
                 return NULL;
             }
             
             parser_expect(parser, CN_TOKEN_RBRACKET);  // 期望 ]
             
-            expr = make_index(expr, index_expr);
+            expr = make_index(parser, expr, index_expr);
         } else if (parser->current.kind == CN_TOKEN_DOT) {
             // 结构体成员访问 obj.member
             parser_advance(parser);  // 跳过 .
@@ -2488,7 +3144,6 @@ static CnAstExpr *parse_postfix(CnParser *parser)
                                                   parser->current.column,
                                                   "语法错误：缺少成员名称");
                 }
-                cn_frontend_ast_expr_free(expr);
                 return NULL;
             }
             
@@ -2496,7 +3151,7 @@ static CnAstExpr *parse_postfix(CnParser *parser)
             size_t member_name_length = parser->current.lexeme_length;
             parser_advance(parser);
             
-            expr = make_member_access(expr, member_name, member_name_length, 0);
+            expr = make_member_access(parser, expr, member_name, member_name_length, 0);
         } else if (parser->current.kind == CN_TOKEN_ARROW) {
             // 结构体指针成员访问 ptr->member
             parser_advance(parser);  // 跳过 ->
@@ -2512,7 +3167,6 @@ static CnAstExpr *parse_postfix(CnParser *parser)
                                                   parser->current.column,
                                                   "语法错误：缺少成员名称");
                 }
-                cn_frontend_ast_expr_free(expr);
                 return NULL;
             }
             
@@ -2520,15 +3174,15 @@ static CnAstExpr *parse_postfix(CnParser *parser)
             size_t member_name_length = parser->current.lexeme_length;
             parser_advance(parser);
             
-            expr = make_member_access(expr, member_name, member_name_length, 1);
+            expr = make_member_access(parser, expr, member_name, member_name_length, 1);
         } else if (parser->current.kind == CN_TOKEN_PLUS_PLUS) {
             // 后置自增 i++
             parser_advance(parser);
-            expr = make_unary(CN_AST_UNARY_OP_POST_INC, expr);
+            expr = make_unary(parser, CN_AST_UNARY_OP_POST_INC, expr);
         } else if (parser->current.kind == CN_TOKEN_MINUS_MINUS) {
             // 后置自减 i--
             parser_advance(parser);
-            expr = make_unary(CN_AST_UNARY_OP_POST_DEC, expr);
+            expr = make_unary(parser, CN_AST_UNARY_OP_POST_DEC, expr);
         }
     }
 
@@ -2625,7 +3279,7 @@ static CnAstExpr *parse_struct_literal_with_name(CnParser *parser, const char *s
 
     size_t field_capacity = 4;
     size_t field_count = 0;
-    CnAstStructFieldInit *fields = (CnAstStructFieldInit *)malloc(
+    CnAstStructFieldInit *fields = (CnAstStructFieldInit *)ast_alloc(parser, 
         sizeof(CnAstStructFieldInit) * field_capacity);
     if (!fields) {
         return NULL;
@@ -2637,10 +3291,9 @@ static CnAstExpr *parse_struct_literal_with_name(CnParser *parser, const char *s
             // 容量检查与扩容
             if (field_count >= field_capacity) {
                 field_capacity *= 2;
-                CnAstStructFieldInit *new_fields = (CnAstStructFieldInit *)realloc(
-                    fields, sizeof(CnAstStructFieldInit) * field_capacity);
+                CnAstStructFieldInit *new_fields = (CnAstStructFieldInit *)ast_grow(parser,
+                    fields, sizeof(CnAstStructFieldInit) * field_count, sizeof(CnAstStructFieldInit) * field_capacity);
                 if (!new_fields) {
-                    free(fields);
                     return NULL;
                 }
                 fields = new_fields;
@@ -2663,7 +3316,6 @@ static CnAstExpr *parse_struct_literal_with_name(CnParser *parser, const char *s
                     parser_advance(parser); // 跳过 ':' 或 '='
                     CnAstExpr *value = parse_expression(parser);
                     if (!value) {
-                        free(fields);
                         return NULL;
                     }
                     fields[field_count].field_name = name;
@@ -2671,13 +3323,12 @@ static CnAstExpr *parse_struct_literal_with_name(CnParser *parser, const char *s
                     fields[field_count].value = value;
                 } else {
                     // 位置初始化：标识符本身作为表达式
-                    fields[field_count].value = make_identifier(name, name_length);
+                    fields[field_count].value = make_identifier(parser, name, name_length);
                 }
             } else {
                 // 其他情况统一按“表达式”解析，作为位置初始化
                 CnAstExpr *value = parse_expression(parser);
                 if (!value) {
-                    free(fields);
                     return NULL;
                 }
                 fields[field_count].value = value;
@@ -2697,16 +3348,56 @@ static CnAstExpr *parse_struct_literal_with_name(CnParser *parser, const char *s
 
     // 期望右花括号
     if (!parser_expect(parser, CN_TOKEN_RBRACE)) {
-        for (size_t i = 0; i < field_count; i++) {
-            if (fields[i].value) {
-                cn_frontend_ast_expr_free(fields[i].value);
+        return NULL;
+    }
+
+    return make_struct_literal(parser, struct_name, struct_name_length, fields, field_count);
+}
+
+// 解析结构体数组的初始化列表：{ {...}, {...} }
+// 元素中的 { ... } 按元素结构体类型解析为结构体字面量，其他元素按一般表达式解析
+static CnAstExpr *parse_struct_array_initializer(CnParser *parser, const char *struct_name, size_t struct_name_length)
+{
+    if (!parser_expect(parser, CN_TOKEN_LBRACE)) {
+        return NULL;
+    }
+
+    size_t elem_capacity = 8;
+    size_t elem_count = 0;
+    CnAstExpr **elements = (CnAstExpr **)ast_alloc(parser, sizeof(CnAstExpr *) * elem_capacity);
+    if (!elements) {
+        return NULL;
+    }
+
+    while (parser->current.kind != CN_TOKEN_RBRACE &&
+           parser->current.kind != CN_TOKEN_EOF) {
+        if (elem_count >= elem_capacity) {
+            elem_capacity *= 2;
+            CnAstExpr **new_elements = (CnAstExpr **)ast_grow(parser,
+                elements, sizeof(CnAstExpr *) * elem_count, sizeof(CnAstExpr *) * elem_capacity);
+            if (!new_elements) {
+                return NULL;
             }
+            elements = new_elements;
+        }
+
+        CnAstExpr *element = parser->current.kind == CN_TOKEN_LBRACE
+                             ? parse_struct_literal_with_name(parser, struct_name, struct_name_length)
+                             : parse_expression(parser);
+        if (!element) {
+            return NULL;
+        }
+        elements[elem_count++] = element;
+
+        if (parser->current.kind == CN_TOKEN_COMMA) {
+            parser_advance(parser);
+        } else {
+            break;
         }
-        free(fields);
-        return NULL;
     }
 
-    return make_struct_literal(struct_name, struct_name_length, fields, field_count);
+    parser_expect(parser, CN_TOKEN_RBRACE);
+    return make_array_literal(parser, elements, elem_count);
 }
 
 static CnAstExpr *parse_factor(CnParser *parser)
@@ -2745,7 +3436,7 @@ static CnAstExpr *parse_factor(CnParser *parser)
             value = strtol(str, NULL, 10);
         }
         
-        expr = make_integer_literal(value);
+        expr = make_integer_literal(parser, value);
         
         // 根据后缀设置类型
         if (parser->current.number_suffix == 0) {
@@ -2771,7 +3462,7 @@ static CnAstExpr *parse_factor(CnParser *parser)
         parser_advance(parser);
     } else if (parser->current.kind == CN_TOKEN_FLOAT_LITERAL) {
         double value = strtod(parser->current.lexeme_begin, NULL);
-        expr = make_float_literal(value);
+        expr = make_float_literal(parser, value);
         
         // 根据后缀设置类型
         if (parser->current.number_suffix == 1) {
@@ -2786,14 +3477,14 @@ static CnAstExpr *parse_factor(CnParser *parser)
     } else if (parser->current.kind == CN_TOKEN_STRING_LITERAL) {
         // 处理字符串转义序列
         size_t processed_length = 0;
-        char *processed_string = process_string_escapes(parser->current.lexeme_begin,
+        char *processed_string = process_string_escapes(parser, parser->current.lexeme_begin,
                                                          parser->current.lexeme_length,
                                                          &processed_length);
         if (processed_string) {
-            expr = make_string_literal(processed_string, processed_length);
+            expr = make_string_literal(parser, processed_string, processed_length);
         } else {
             // 处理失败，使用原始字符串
-            expr = make_string_literal(parser->current.lexeme_begin, parser->current.lexeme_length);
+            expr = make_string_literal(parser, parser->current.lexeme_begin, parser->current.lexeme_length);
         }
         parser_advance(parser);
     } else if (parser->current.kind == CN_TOKEN_CHAR_LITERAL) {
@@ -2822,30 +3513,30 @@ static CnAstExpr *parse_factor(CnParser *parser)
             }
         }
         
-        expr = make_char_literal(char_value);
+        expr = make_char_literal(parser, char_value);
         parser_advance(parser);
     } else if (parser->current.kind == CN_TOKEN_KEYWORD_TRUE) {
-        expr = make_bool_literal(1);
+        expr = make_bool_literal(parser, 1);
         parser_advance(parser);
     } else if (parser->current.kind == CN_TOKEN_KEYWORD_FALSE) {
-        expr = make_bool_literal(0);
+        expr = make_bool_literal(parser, 0);
         parser_advance(parser);
     } else if (parser->current.kind == CN_TOKEN_KEYWORD_NULL) {
         // NULL 关键字：生成空指针字面量
-        expr = make_integer_literal(0);  // 简化处理：将NULL表示为0
+        expr = make_integer_literal(parser, 0);  // 简化处理：将NULL表示为0
         parser_advance(parser);
     } else if (parser->current.kind == CN_TOKEN_KEYWORD_THIS) {
         // 自身 关键字：生成标识符表达式 "self"
         // 在代码生成阶段会转换为 C 代码中的 self 参数
         fprintf(stderr, "[DEBUG PARSER] Found CN_TOKEN_KEYWORD_THIS, creating self identifier\n");
-        expr = make_identifier("self", 4);
+        expr = make_identifier(parser, "self", 4);
         expr->is_this_pointer = 1;  // 标记为自身指针，用于语义检查
         fprintf(stderr, "[DEBUG PARSER] expr=%p, is_this_pointer=%d\n", (void*)expr, expr->is_this_pointer);
         parser_advance(parser);
     } else if (parser->current.kind == CN_TOKEN_KEYWORD_BASE) {
         // 基类 关键字：生成标识符表达式 "base"
         // 在代码生成阶段会转换为对父类方法的调用
-        expr = make_identifier("base", 4);
+        expr = make_identifier(parser, "base", 4);
         expr->is_base_pointer = 1;  // 标记为基类指针，用于语义检查和代码生成
         parser_advance(parser);
     } else if (parser->current.kind == CN_TOKEN_IDENT) {
@@ -2854,15 +3545,24 @@ static CnAstExpr *parse_factor(CnParser *parser)
         size_t ident_name_length = parser->current.lexeme_length;
         parser_advance(parser);
         
+        // 嵌入资源：嵌入("路径")，实参必须是单个字符串字面量，其余写法仍按普通调用处理
+        if (parser->current.kind == CN_TOKEN_LPAREN &&
+            ident_name_length == sizeof(CN_AST_EMBED_NAME) - 1 &&
+            memcmp(ident_name, CN_AST_EMBED_NAME, ident_name_length) == 0 &&
+            parser_peek(parser) == CN_TOKEN_STRING_LITERAL &&
+            parser_peek_n(parser, 1) == CN_TOKEN_RPAREN) {
+            expr = parse_embed(parser);
+        }
         // 检查是否是模板实例化：标识符 < ... >
         // 注意：需要区分模板实例化和比较表达式
-        if (parser->current.kind == CN_TOKEN_LESS) {
+        else if (parser->current.kind == CN_TOKEN_LESS) {
             // 前瞻判断：检查 < 后面是否是类型名
             // 如果不是类型名，则一定是比较表达式，不需要尝试模板解析
             // 需要保存词法分析器的完整状态，因为 parser_advance 会修改它
             CnToken saved_token = parser->current;
             int saved_has_current = parser->has_current;
             CnLexer saved_lexer_state = *parser->lexer;  // 保存词法分析器状态
+            size_t saved_stream_pos = parser->stream_pos;
 
             parser_advance(parser);  // 临时消耗 '<' 进行前瞻
 
@@ -2872,6 +3572,7 @@ static CnAstExpr *parse_factor(CnParser *parser)
             parser->current = saved_token;
             parser->has_current = saved_has_current;
             *parser->lexer = saved_lexer_state;  // 恢复词法分析器状态
+            parser->stream_pos = saved_stream_pos;
 
             if (is_template) {
                 // 可能是模板实例化，尝试解析
@@ -2881,19 +3582,20 @@ static CnAstExpr *parse_factor(CnParser *parser)
                     parser->current = saved_token;
                     parser->has_current = saved_has_current;
                     *parser->lexer = saved_lexer_state;
-                    expr = make_identifier(ident_name, ident_name_length);
+                    parser->stream_pos = saved_stream_pos;
+                    expr = make_identifier(parser, ident_name, ident_name_length);
                 }
             } else {
                 // 不是模板实例化（< 后面不是类型名），创建普通标识符
                 // 让后续的比较表达式解析器处理 '<' 运算符
-                expr = make_identifier(ident_name, ident_name_length);
+                expr = make_identifier(parser, ident_name, ident_name_length);
             }
         } else if (parser->current.kind == CN_TOKEN_LBRACE) {
             // 检查是否是结构体字面量：标识符 { ... }
             expr = parse_struct_literal_with_name(parser, ident_name, ident_name_length);
         } else {
             // 普通标识符
-            expr = make_identifier(ident_name, ident_name_length);
+            expr = make_identifier(parser, ident_name, ident_name_length);
         }
     /* 注意:CN_TOKEN_KEYWORD_READ/WRITE/COPY/SET/MAP/UNMAP_MEMORY 已删除
      * 内存操作功能将通过运行时库函数提供
@@ -2923,7 +3625,7 @@ static CnAstExpr *parse_factor(CnParser *parser)
             if (!address) {
                 return NULL;
             }
-            result = make_memory_read(address);
+            result = make_memory_read(parser, address);
         } else if (kind == CN_TOKEN_KEYWORD_WRITE_MEMORY) {
             // 写入内存: 写入内存(地址, 值)
             CnAstExpr *address = parse_expression(parser);
@@ -2931,15 +3633,13 @@ static CnAstExpr *parse_factor(CnParser *parser)
                 return NULL;
             }
             if (!parser_expect(parser, CN_TOKEN_COMMA)) {
-                cn_frontend_ast_expr_free(address);
                 return NULL;
             }
             CnAstExpr *value = parse_expression(parser);
             if (!value) {
-                cn_frontend_ast_expr_free(address);
                 return NULL;
             }
-            result = make_memory_write(address, value);
+            result = make_memory_write(parser, address, value);
         } else if (kind == CN_TOKEN_KEYWORD_MEMORY_COPY) {
             // 内存复制: 内存复制(目标, 源, 大小)
             CnAstExpr *dest = parse_expression(parser);
@@ -2947,26 +3647,20 @@ static CnAstExpr *parse_factor(CnParser *parser)
                 return NULL;
             }
             if (!parser_expect(parser, CN_TOKEN_COMMA)) {
-                cn_frontend_ast_expr_free(dest);
                 return NULL;
             }
             CnAstExpr *src = parse_expression(parser);
             if (!src) {
-                cn_frontend_ast_expr_free(dest);
                 return NULL;
             }
             if (!parser_expect(parser, CN_TOKEN_COMMA)) {
-                cn_frontend_ast_expr_free(dest);
-                cn_frontend_ast_expr_free(src);
                 return NULL;
             }
             CnAstExpr *size = parse_expression(parser);
             if (!size) {
-                cn_frontend_ast_expr_free(dest);
-                cn_frontend_ast_expr_free(src);
                 return NULL;
             }
-            result = make_memory_copy(dest, src, size);
+            result = make_memory_copy(parser, dest, src, size);
         } else if (kind == CN_TOKEN_KEYWORD_MEMORY_SET) {
             // 内存设置: 内存设置(地址, 值, 大小)
             CnAstExpr *address = parse_expression(parser);
@@ -2974,26 +3668,20 @@ static CnAstExpr *parse_factor(CnParser *parser)
                 return NULL;
             }
             if (!parser_expect(parser, CN_TOKEN_COMMA)) {
-                cn_frontend_ast_expr_free(address);
                 return NULL;
             }
             CnAstExpr *value = parse_expression(parser);
             if (!value) {
-                cn_frontend_ast_expr_free(address);
                 return NULL;
             }
             if (!parser_expect(parser, CN_TOKEN_COMMA)) {
-                cn_frontend_ast_expr_free(address);
-                cn_frontend_ast_expr_free(value);
                 return NULL;
             }
             CnAstExpr *size = parse_expression(parser);
             if (!size) {
-                cn_frontend_ast_expr_free(address);
-                cn_frontend_ast_expr_free(value);
                 return NULL;
             }
-            result = make_memory_set(address, value, size);
+            result = make_memory_set(parser, address, value, size);
         } else if (kind == CN_TOKEN_KEYWORD_MAP_MEMORY) {
             // 内存映射: 映射内存(地址, 大小, 保护, 标志)
             CnAstExpr *address = parse_expression(parser);
@@ -3001,39 +3689,27 @@ static CnAstExpr *parse_factor(CnParser *parser)
                 return NULL;
             }
             if (!parser_expect(parser, CN_TOKEN_COMMA)) {
-                cn_frontend_ast_expr_free(address);
                 return NULL;
             }
             CnAstExpr *size = parse_expression(parser);
             if (!size) {
-                cn_frontend_ast_expr_free(address);
                 return NULL;
             }
             if (!parser_expect(parser, CN_TOKEN_COMMA)) {
-                cn_frontend_ast_expr_free(address);
-                cn_frontend_ast_expr_free(size);
                 return NULL;
             }
             CnAstExpr *prot = parse_expression(parser);
             if (!prot) {
-                cn_frontend_ast_expr_free(address);
-                cn_frontend_ast_expr_free(size);
                 return NULL;
             }
             if (!parser_expect(parser, CN_TOKEN_COMMA)) {
-                cn_frontend_ast_expr_free(address);
-                cn_frontend_ast_expr_free(size);
-                cn_frontend_ast_expr_free(prot);
                 return NULL;
             }
             CnAstExpr *flags = parse_expression(parser);
             if (!flags) {
-                cn_frontend_ast_expr_free(address);
-                cn_frontend_ast_expr_free(size);
-                cn_frontend_ast_expr_free(prot);
                 return NULL;
             }
-            result = make_memory_map(address, size, prot, flags);
+            result = make_memory_map(parser, address, size, prot, flags);
         } else if (kind == CN_TOKEN_KEYWORD_UNMAP_MEMORY) {
             // 解除内存映射: 解除映射(地址, 大小)
             CnAstExpr *address = parse_expression(parser);
@@ -3041,21 +3717,16 @@ static CnAstExpr *parse_factor(CnParser *parser)
                 return NULL;
             }
             if (!parser_expect(parser, CN_TOKEN_COMMA)) {
-                cn_frontend_ast_expr_free(address);
                 return NULL;
             }
             CnAstExpr *size = parse_expression(parser);
             if (!size) {
-                cn_frontend_ast_expr_free(address);
                 return NULL;
             }
-            result = make_memory_unmap(address, size);
+            result = make_memory_unmap(parser, address, size);
         }
         
         if (!parser_expect(parser, CN_TOKEN_RPAREN)) {
-            if (result) {
-                cn_frontend_ast_expr_free(result);
-            }
             return NULL;
         }
         
@@ -3090,9 +3761,8 @@ static CnAstExpr *parse_factor(CnParser *parser)
             
             // 解析输出变量列表
             size_t out_capacity = 4;
-            outputs = (CnAstExpr **)malloc(sizeof(CnAstExpr *) * out_capacity);
+            outputs = (CnAstExpr **)ast_alloc(parser, sizeof(CnAstExpr *) * out_capacity);
             if (!outputs) {
-                cn_frontend_ast_expr_free(asm_code);
                 return NULL;
             }
             
@@ -3100,11 +3770,9 @@ static CnAstExpr *parse_factor(CnParser *parser)
                 do {
                     if (output_count >= out_capacity) {
                         out_capacity *= 2;
-                        CnAstExpr **new_outputs = (CnAstExpr **)realloc(
-                            outputs, sizeof(CnAstExpr *) * out_capacity);
+                        CnAstExpr **new_outputs = (CnAstExpr **)ast_grow(parser,
+                            outputs, sizeof(CnAstExpr *) * output_count, sizeof(CnAstExpr *) * out_capacity);
                         if (!new_outputs) {
-                            free(outputs);
-                            cn_frontend_ast_expr_free(asm_code);
                             return NULL;
                         }
                         outputs = new_outputs;
@@ -3131,13 +3799,8 @@ static CnAstExpr *parse_factor(CnParser *parser)
             
             // 解析输入变量列表
             size_t in_capacity = 4;
-            inputs = (CnAstExpr **)malloc(sizeof(CnAstExpr *) * in_capacity);
+            inputs = (CnAstExpr **)ast_alloc(parser, sizeof(CnAstExpr *) * in_capacity);
             if (!inputs) {
-                for (size_t i = 0; i < output_count; i++) {
-                    cn_frontend_ast_expr_free(outputs[i]);
-                }
-                free(outputs);
-                cn_frontend_ast_expr_free(asm_code);
                 return NULL;
             }
             
@@ -3145,15 +3808,9 @@ static CnAstExpr *parse_factor(CnParser *parser)
                 do {
                     if (input_count >= in_capacity) {
                         in_capacity *= 2;
-                        CnAstExpr **new_inputs = (CnAstExpr **)realloc(
-                            inputs, sizeof(CnAstExpr *) * in_capacity);
+                        CnAstExpr **new_inputs = (CnAstExpr **)ast_grow(parser,
+                            inputs, sizeof(CnAstExpr *) * input_count, sizeof(CnAstExpr *) * in_capacity);
                         if (!new_inputs) {
-                            free(inputs);
-                            for (size_t i = 0; i < output_count; i++) {
-                                cn_frontend_ast_expr_free(outputs[i]);
-                            }
-                            free(outputs);
-                            cn_frontend_ast_expr_free(asm_code);
                             return NULL;
                         }
                         inputs = new_inputs;
@@ -3180,22 +3837,10 @@ static CnAstExpr *parse_factor(CnParser *parser)
         }
         
         if (!parser_expect(parser, CN_TOKEN_RPAREN)) {
-            for (size_t i = 0; i < input_count; i++) {
-                cn_frontend_ast_expr_free(inputs[i]);
-            }
-            free(inputs);
-            for (size_t i = 0; i < output_count; i++) {
-                cn_frontend_ast_expr_free(outputs[i]);
-            }
-            free(outputs);
-            cn_frontend_ast_expr_free(asm_code);
-            if (clobbers) {
-                cn_frontend_ast_expr_free(clobbers);
-            }
             return NULL;
         }
         
-        expr = make_inline_asm(asm_code, outputs, output_count, inputs, input_count, clobbers);
+        expr = make_inline_asm(parser, asm_code, outputs, output_count, inputs, input_count, clobbers);
     */  // 结束已禁用的内联汇编解析
     } else if (parser->current.kind == CN_TOKEN_LPAREN) {
         // 可能是类型转换表达式 (类型)表达式 或 普通括号表达式 (表达式)
@@ -3205,6 +3850,7 @@ static CnAstExpr *parse_factor(CnParser *parser)
         CnToken saved_token = parser->current;
         int saved_has_current = parser->has_current;
         CnLexer saved_lexer_state = *parser->lexer;
+        size_t saved_stream_pos = parser->stream_pos;
         int saved_error_count = parser->error_count;
         
         parser_advance(parser);  // 跳过 '('
@@ -3236,12 +3882,13 @@ static CnAstExpr *parse_factor(CnParser *parser)
                     return NULL;
                 }
                 
-                expr = make_cast(cast_type, operand);
+                expr = make_cast(parser, cast_type, operand);
             } else {
                 // 不是类型转换，回退并解析普通括号表达式
                 parser->current = saved_token;
                 parser->has_current = saved_has_current;
                 *parser->lexer = saved_lexer_state;
+                parser->stream_pos = saved_stream_pos;
                 parser->error_count = saved_error_count;  // 恢复错误计数
                 
                 parser_advance(parser);  // 跳过 '('
@@ -3260,7 +3907,7 @@ static CnAstExpr *parse_factor(CnParser *parser)
         // 动态分配元素数组
         size_t elem_capacity = 8;
         size_t elem_count = 0;
-        CnAstExpr **elements = (CnAstExpr **)malloc(sizeof(CnAstExpr *) * elem_capacity);
+        CnAstExpr **elements = (CnAstExpr **)ast_alloc(parser, sizeof(CnAstExpr *) * elem_capacity);
         if (!elements) {
             return NULL;
         }
@@ -3271,10 +3918,9 @@ static CnAstExpr *parse_factor(CnParser *parser)
                 // 如果容量不够，扩容
                 if (elem_count >= elem_capacity) {
                     elem_capacity *= 2;
-                    CnAstExpr **new_elements = (CnAstExpr **)realloc(
-                        elements, sizeof(CnAstExpr *) * elem_capacity);
+                    CnAstExpr **new_elements = (CnAstExpr **)ast_grow(parser,
+                        elements, sizeof(CnAstExpr *) * elem_count, sizeof(CnAstExpr *) * elem_capacity);
                     if (!new_elements) {
-                        free(elements);
                         return NULL;
                     }
                     elements = new_elements;
@@ -3294,7 +3940,7 @@ static CnAstExpr *parse_factor(CnParser *parser)
         }
         
         parser_expect(parser, CN_TOKEN_RBRACKET);
-        expr = make_array_literal(elements, elem_count);
+        expr = make_array_literal(parser, elements, elem_count);
     } else if (parser->current.kind == CN_TOKEN_LBRACE) {
         // C风格数组初始化列表 {1, 2, 3}
         parser_advance(parser);  // 跳过 {
@@ -3302,7 +3948,7 @@ static CnAstExpr *parse_factor(CnParser *parser)
         // 动态分配元素数组
         size_t elem_capacity = 8;
         size_t elem_count = 0;
-        CnAstExpr **elements = (CnAstExpr **)malloc(sizeof(CnAstExpr *) * elem_capacity);
+        CnAstExpr **elements = (CnAstExpr **)ast_alloc(parser, sizeof(CnAstExpr *) * elem_capacity);
         if (!elements) {
             return NULL;
         }
@@ -3313,10 +3959,9 @@ static CnAstExpr *parse_factor(CnParser *parser)
                 // 如果容量不够，扩容
                 if (elem_count >= elem_capacity) {
                     elem_capacity *= 2;
-                    CnAstExpr **new_elements = (CnAstExpr **)realloc(
-                        elements, sizeof(CnAstExpr *) * elem_capacity);
+                    CnAstExpr **new_elements = (CnAstExpr **)ast_grow(parser,
+                        elements, sizeof(CnAstExpr *) * elem_count, sizeof(CnAstExpr *) * elem_capacity);
                     if (!new_elements) {
-                        free(elements);
                         return NULL;
                     }
                     elements = new_elements;
@@ -3336,7 +3981,7 @@ static CnAstExpr *parse_factor(CnParser *parser)
         }
         
         parser_expect(parser, CN_TOKEN_RBRACE);
-        expr = make_array_literal(elements, elem_count);
+        expr = make_array_literal(parser, elements, elem_count);
     } else {
         parser->error_count++;
         if (parser->diagnostics) {
@@ -3354,14 +3999,13 @@ static CnAstExpr *parse_factor(CnParser *parser)
     return expr;
 }
 
-static CnAstExpr *make_integer_literal(long value)
+static CnAstExpr *make_integer_literal(CnParser *parser, long value)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_INTEGER_LITERAL);
     if (!expr) {
         return NULL;
     }
 
-    expr->kind = CN_AST_EXPR_INTEGER_LITERAL;
     expr->type = NULL;
     expr->loc.filename = NULL;
     expr->loc.line = 0;
@@ -3370,14 +4014,13 @@ static CnAstExpr *make_integer_literal(long value)
     return expr;
 }
 
-static CnAstExpr *make_float_literal(double value)
+static CnAstExpr *make_float_literal(CnParser *parser, double value)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_FLOAT_LITERAL);
     if (!expr) {
         return NULL;
     }
 
-    expr->kind = CN_AST_EXPR_FLOAT_LITERAL;
     expr->type = NULL;
     expr->loc.filename = NULL;
     expr->loc.line = 0;
@@ -3387,7 +4030,7 @@ static CnAstExpr *make_float_literal(double value)
 }
 
 // 处理字符串转义序列
-static char* process_string_escapes(const char *raw_string, size_t raw_length, size_t *out_length)
+static char* process_string_escapes(CnParser *parser, const char *raw_string, size_t raw_length, size_t *out_length)
 {
     // 跳过开头和结尾的引号
     if (raw_length < 2 || raw_string[0] != '"' || raw_string[raw_length - 1] != '"') {
@@ -3396,7 +4039,7 @@ static char* process_string_escapes(const char *raw_string, size_t raw_length, s
     }
     
     // 分配足够的空间（最坏情况：没有转义，长度相同）
-    char *result = (char *)malloc(raw_length);
+    char *result = (char *)ast_alloc(parser, raw_length);
     if (!result) {
         *out_length = 0;
         return NULL;
@@ -3430,14 +4073,13 @@ static char* process_string_escapes(const char *raw_string, size_t raw_length, s
     return result;
 }
 
-static CnAstExpr *make_string_literal(const char *value, size_t length)
+static CnAstExpr *make_string_literal(CnParser *parser, const char *value, size_t length)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_STRING_LITERAL);
     if (!expr) {
         return NULL;
     }
 
-    expr->kind = CN_AST_EXPR_STRING_LITERAL;
     expr->type = NULL;
     expr->loc.filename = NULL;
     expr->loc.line = 0;
@@ -3447,14 +4089,13 @@ static CnAstExpr *make_string_literal(const char *value, size_t length)
     return expr;
 }
 
-static CnAstExpr *make_char_literal(char value)
+static CnAstExpr *make_char_literal(CnParser *parser, char value)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_CHAR_LITERAL);
     if (!expr) {
         return NULL;
     }
 
-    expr->kind = CN_AST_EXPR_CHAR_LITERAL;
     expr->type = cn_type_new_primitive(CN_TYPE_INT);  // 字符类型在C中本质是整数
     expr->loc.filename = NULL;
     expr->loc.line = 0;
@@ -3463,14 +4104,13 @@ static CnAstExpr *make_char_literal(char value)
     return expr;
 }
 
-static CnAstExpr *make_bool_literal(int value)
+static CnAstExpr *make_bool_literal(CnParser *parser, int value)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_BOOL_LITERAL);
     if (!expr) {
         return NULL;
     }
 
-    expr->kind = CN_AST_EXPR_BOOL_LITERAL;
     expr->type = NULL;
     expr->loc.filename = NULL;
     expr->loc.line = 0;
@@ -3479,14 +4119,13 @@ static CnAstExpr *make_bool_literal(int value)
     return expr;
 }
 
-static CnAstExpr *make_identifier(const char *name, size_t length)
+static CnAstExpr *make_identifier(CnParser *parser, const char *name, size_t length)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_IDENTIFIER);
     if (!expr) {
         return NULL;
     }
 
-    expr->kind = CN_AST_EXPR_IDENTIFIER;
     expr->type = NULL;
     expr->loc.filename = NULL;
     expr->loc.line = 0;
@@ -3498,14 +4137,13 @@ static CnAstExpr *make_identifier(const char *name, size_t length)
     return expr;
 }
 
-static CnAstExpr *make_binary(CnAstBinaryOp op, CnAstExpr *left, CnAstExpr *right)
+static CnAstExpr *make_binary(CnParser *parser, CnAstBinaryOp op, CnAstExpr *left, CnAstExpr *right)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_BINARY);
     if (!expr) {
         return NULL;
     }
 
-    expr->kind = CN_AST_EXPR_BINARY;
     expr->type = NULL;
     expr->loc.filename = NULL;
     expr->loc.line = 0;
@@ -3516,14 +4154,13 @@ static CnAstExpr *make_binary(CnAstBinaryOp op, CnAstExpr *left, CnAstExpr *righ
     return expr;
 }
 
-static CnAstExpr *make_assign(CnAstExpr *target, CnAstExpr *value)
+static CnAstExpr *make_assign(CnParser *parser, CnAstExpr *target, CnAstExpr *value)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_ASSIGN);
     if (!expr) {
         return NULL;
     }
 
-    expr->kind = CN_AST_EXPR_ASSIGN;
     expr->type = NULL;
     // 初始化位置信息为未知
     expr->loc.filename = NULL;
@@ -3534,14 +4171,13 @@ static CnAstExpr *make_assign(CnAstExpr *target, CnAstExpr *value)
     return expr;
 }
 
-static CnAstExpr *make_logical(CnAstLogicalOp op, CnAstExpr *left, CnAstExpr *right)
+static CnAstExpr *make_logical(CnParser *parser, CnAstLogicalOp op, CnAstExpr *left, CnAstExpr *right)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_LOGICAL);
     if (!expr) {
         return NULL;
     }
 
-    expr->kind = CN_AST_EXPR_LOGICAL;
     expr->type = NULL;
     expr->loc.filename = NULL;
     expr->loc.line = 0;
@@ -3552,14 +4188,13 @@ static CnAstExpr *make_logical(CnAstLogicalOp op, CnAstExpr *left, CnAstExpr *ri
     return expr;
 }
 
-static CnAstExpr *make_unary(CnAstUnaryOp op, CnAstExpr *operand)
+static CnAstExpr *make_unary(CnParser *parser, CnAstUnaryOp op, CnAstExpr *operand)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_UNARY);
     if (!expr) {
         return NULL;
     }
 
-    expr->kind = CN_AST_EXPR_UNARY;
     expr->type = NULL;
     expr->loc.filename = NULL;
     expr->loc.line = 0;
@@ -3569,14 +4204,13 @@ static CnAstExpr *make_unary(CnAstUnaryOp op, CnAstExpr *operand)
     return expr;
 }
 
-static CnAstExpr *make_call(CnAstExpr *callee, CnAstExpr **arguments, size_t argument_count)
+static CnAstExpr *make_call(CnParser *parser, CnAstExpr *callee, CnAstExpr **arguments, size_t argument_count)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_CALL);
     if (!expr) {
         return NULL;
     }
 
-    expr->kind = CN_AST_EXPR_CALL;
     expr->type = NULL;
     expr->loc.filename = NULL;
     expr->loc.line = 0;
@@ -3587,14 +4221,13 @@ static CnAstExpr *make_call(CnAstExpr *callee, CnAstExpr **arguments, size_t arg
     return expr;
 }
 
-static CnAstExpr *make_array_literal(CnAstExpr **elements, size_t element_count)
+static CnAstExpr *make_array_literal(CnParser *parser, CnAstExpr **elements, size_t element_count)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_ARRAY_LITERAL);
     if (!expr) {
         return NULL;
     }
 
-    expr->kind = CN_AST_EXPR_ARRAY_LITERAL;
     expr->type = NULL;
     expr->loc.filename = NULL;
     expr->loc.line = 0;
@@ -3604,14 +4237,13 @@ static CnAstExpr *make_array_literal(CnAstExpr **elements, size_t element_count)
     return expr;
 }
 
-static CnAstExpr *make_index(CnAstExpr *array, CnAstExpr *index)
+static CnAstExpr *make_index(CnParser *parser, CnAstExpr *array, CnAstExpr *index)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_INDEX);
     if (!expr) {
         return NULL;
     }
 
-    expr->kind = CN_AST_EXPR_INDEX;
     expr->type = NULL;
     expr->loc.filename = NULL;
     expr->loc.line = 0;
@@ -3621,14 +4253,13 @@ static CnAstExpr *make_index(CnAstExpr *array, CnAstExpr *index)
     return expr;
 }
 
-static CnAstStmt *make_expr_stmt(CnAstExpr *expr)
+static CnAstStmt *make_expr_stmt(CnParser *parser, CnAstExpr *expr)
 {
-    CnAstStmt *stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+    CnAstStmt *stmt = ast_new_stmt(parser, CN_AST_STMT_EXPR);
     if (!stmt) {
         return NULL;
     }
 
-    stmt->kind = CN_AST_STMT_EXPR;
     stmt->loc.filename = NULL;
     stmt->loc.line = 0;
     stmt->loc.column = 0;
@@ -3636,58 +4267,54 @@ static CnAstStmt *make_expr_stmt(CnAstExpr *expr)
     return stmt;
 }
 
-static CnAstStmt *make_return_stmt(CnAstExpr *expr)
+static CnAstStmt *make_return_stmt(CnParser *parser, CnAstExpr *expr)
 {
-    CnAstStmt *stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+    CnAstStmt *stmt = ast_new_stmt(parser, CN_AST_STMT_RETURN);
     if (!stmt) {
         return NULL;
     }
 
-    stmt->kind = CN_AST_STMT_RETURN;
     stmt->as.return_stmt.expr = expr;
     return stmt;
 }
 
-static CnAstStmt *make_if_stmt(CnAstExpr *condition,
+static CnAstStmt *make_if_stmt(CnParser *parser, CnAstExpr *condition,
                                CnAstBlockStmt *then_block,
                                CnAstBlockStmt *else_block)
 {
-    CnAstStmt *stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+    CnAstStmt *stmt = ast_new_stmt(parser, CN_AST_STMT_IF);
     if (!stmt) {
         return NULL;
     }
 
-    stmt->kind = CN_AST_STMT_IF;
     stmt->as.if_stmt.condition = condition;
     stmt->as.if_stmt.then_block = then_block;
     stmt->as.if_stmt.else_block = else_block;
     return stmt;
 }
 
-static CnAstStmt *make_while_stmt(CnAstExpr *condition, CnAstBlockStmt *body)
+static CnAstStmt *make_while_stmt(CnParser *parser, CnAstExpr *condition, CnAstBlockStmt *body)
 {
-    CnAstStmt *stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+    CnAstStmt *stmt = ast_new_stmt(parser, CN_AST_STMT_WHILE);
     if (!stmt) {
         return NULL;
     }
 
-    stmt->kind = CN_AST_STMT_WHILE;
     stmt->as.while_stmt.condition = condition;
     stmt->as.while_stmt.body = body;
     return stmt;
 }
 
-static CnAstStmt *make_for_stmt(CnAstStmt *init,
+static CnAstStmt *make_for_stmt(CnParser *parser, CnAstStmt *init,
                                 CnAstExpr *condition,
                                 CnAstExpr *update,
                                 CnAstBlockStmt *body)
 {
-    CnAstStmt *stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+    CnAstStmt *stmt = ast_new_stmt(parser, CN_AST_STMT_FOR);
     if (!stmt) {
         return NULL;
     }
 
-    stmt->kind = CN_AST_STMT_FOR;
     stmt->as.for_stmt.init = init;
     stmt->as.for_stmt.condition = condition;
     stmt->as.for_stmt.update = update;
@@ -3695,54 +4322,51 @@ static CnAstStmt *make_for_stmt(CnAstStmt *init,
     return stmt;
 }
 
-static CnAstStmt *make_break_stmt(void)
+static CnAstStmt *make_break_stmt(CnParser *parser)
 {
-    CnAstStmt *stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+    CnAstStmt *stmt = ast_new_stmt(parser, CN_AST_STMT_BREAK);
     if (!stmt) {
         return NULL;
     }
 
-    stmt->kind = CN_AST_STMT_BREAK;
     return stmt;
 }
 
-static CnAstStmt *make_continue_stmt(void)
+static CnAstStmt *make_continue_stmt(CnParser *parser)
 {
-    CnAstStmt *stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+    CnAstStmt *stmt = ast_new_stmt(parser, CN_AST_STMT_CONTINUE);
     if (!stmt) {
         return NULL;
     }
 
-    stmt->kind = CN_AST_STMT_CONTINUE;
     return stmt;
 }
 
 // 创建 switch 语句节点
-static CnAstStmt *make_switch_stmt(CnAstExpr *expr, CnAstSwitchCase *cases, size_t case_count)
+static CnAstStmt *make_switch_stmt(CnParser *parser, CnAstExpr *expr, CnAstSwitchCase *cases, size_t case_count)
 {
-    CnAstStmt *stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+    CnAstStmt *stmt = ast_new_stmt(parser, CN_AST_STMT_SWITCH);
     if (!stmt) {
         return NULL;
     }
 
-    stmt->kind = CN_AST_STMT_SWITCH;
     stmt->as.switch_stmt.expr = expr;
     stmt->as.switch_stmt.cases = cases;
     stmt->as.switch_stmt.case_count = case_count;
     return stmt;
 }
 
-static CnAstStmt *make_var_decl_stmt(const char *name, size_t name_length, CnType *declared_type, CnAstExpr *initializer, CnVisibility visibility)
+static CnAstStmt *make_var_decl_stmt(CnParser *parser, const char *name, size_t name_length, CnType *declared_type, CnAstExpr *initializer, CnVisibility visibility)
 {
-    CnAstStmt *stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+    CnAstStmt *stmt = ast_new_stmt(parser, CN_AST_STMT_VAR_DECL);
     if (!stmt) {
         return NULL;
     }
 
-    stmt->kind = CN_AST_STMT_VAR_DECL;
     stmt->as.var_decl.name = name;
     stmt->as.var_decl.name_length = name_length;
     stmt->as.var_decl.declared_type = declared_type;
+    stmt->as.var_decl.source_type = declared_type;
     stmt->as.var_decl.initializer = initializer;
     stmt->as.var_decl.visibility = visibility;
     stmt->as.var_decl.is_const = 0;   // 默认非常量，具体由解析器在需要时设置
@@ -3750,9 +4374,9 @@ static CnAstStmt *make_var_decl_stmt(const char *name, size_t name_length, CnTyp
     return stmt;
 }
 
-static CnAstBlockStmt *make_block(void)
+static CnAstBlockStmt *make_block(CnParser *parser)
 {
-    CnAstBlockStmt *block = (CnAstBlockStmt *)malloc(sizeof(CnAstBlockStmt));
+    CnAstBlockStmt *block = (CnAstBlockStmt *)ast_alloc(parser, sizeof(CnAstBlockStmt));
     if (!block) {
         return NULL;
     }
@@ -3763,7 +4387,7 @@ static CnAstBlockStmt *make_block(void)
     return block;
 }
 
-static void block_add_stmt(CnAstBlockStmt *block, CnAstStmt *stmt)
+static void block_add_stmt(CnParser *parser, CnAstBlockStmt *block, CnAstStmt *stmt)
 {
     size_t new_count;
     CnAstStmt **new_array;
@@ -3773,7 +4397,8 @@ static void block_add_stmt(CnAstBlockStmt *block, CnAstStmt *stmt)
     }
 
     new_count = block->stmt_count + 1;
-    new_array = (CnAstStmt **)realloc(block->stmts, new_count * sizeof(CnAstStmt *));
+    new_array = (CnAstStmt **)ast_array_reserve(parser, block->stmts, block->stmt_count,
+                                                sizeof(CnAstStmt *));
     if (!new_array) {
         return;
     }
@@ -3783,7 +4408,7 @@ static void block_add_stmt(CnAstBlockStmt *block, CnAstStmt *stmt)
     block->stmt_count = new_count;
 }
 
-static CnAstProgram *make_program(void)
+static CnAstProgram *make_program(CnParser *parser)
 {
     CnAstProgram *program = (CnAstProgram *)malloc(sizeof(CnAstProgram));
     if (!program) {
@@ -3810,10 +4435,14 @@ static CnAstProgram *make_program(void)
     program->template_funcs = NULL;
     program->template_struct_count = 0;
     program->template_structs = NULL;
+    program->arena = parser->arena;
+    program->owned_scopes = NULL;
+    program->owned_scope_count = 0;
+    program->owned_scope_capacity = 0;
     return program;
 }
 
-static void program_add_function(CnAstProgram *program, CnAstFunctionDecl *function_decl)
+static void program_add_function(CnParser *parser, CnAstProgram *program, CnAstFunctionDecl *function_decl)
 {
     size_t new_count;
     CnAstFunctionDecl **new_array;
@@ -3823,8 +4452,9 @@ static void program_add_function(CnAstProgram *program, CnAstFunctionDecl *funct
     }
 
     new_count = program->function_count + 1;
-    new_array = (CnAstFunctionDecl **)realloc(program->functions,
-                                              new_count * sizeof(CnAstFunctionDecl *));
+    new_array = (CnAstFunctionDecl **)ast_array_reserve(parser, program->functions,
+                                                        program->function_count,
+                                                        sizeof(CnAstFunctionDecl *));
     if (!new_array) {
         return;
     }
@@ -3835,7 +4465,7 @@ static void program_add_function(CnAstProgram *program, CnAstFunctionDecl *funct
 }
 
 // 添加结构体声明到program
-static void program_add_struct(CnAstProgram *program, CnAstStmt *struct_decl)
+static void program_add_struct(CnParser *parser, CnAstProgram *program, CnAstStmt *struct_decl)
 {
     size_t new_count;
     CnAstStmt **new_array;
@@ -3845,8 +4475,8 @@ static void program_add_struct(CnAstProgram *program, CnAstStmt *struct_decl)
     }
 
     new_count = program->struct_count + 1;
-    new_array = (CnAstStmt **)realloc(program->structs,
-                                      new_count * sizeof(CnAstStmt *));
+    new_array = (CnAstStmt **)ast_array_reserve(parser, program->structs, program->struct_count,
+                                                sizeof(CnAstStmt *));
     if (!new_array) {
         return;
     }
@@ -3857,7 +4487,7 @@ static void program_add_struct(CnAstProgram *program, CnAstStmt *struct_decl)
 }
 
 // 添加枚举声明到program
-static void program_add_enum(CnAstProgram *program, CnAstStmt *enum_decl)
+static void program_add_enum(CnParser *parser, CnAstProgram *program, CnAstStmt *enum_decl)
 {
     size_t new_count;
     CnAstStmt **new_array;
@@ -3867,8 +4497,8 @@ static void program_add_enum(CnAstProgram *program, CnAstStmt *enum_decl)
     }
 
     new_count = program->enum_count + 1;
-    new_array = (CnAstStmt **)realloc(program->enums,
-                                      new_count * sizeof(CnAstStmt *));
+    new_array = (CnAstStmt **)ast_array_reserve(parser, program->enums, program->enum_count,
+                                                sizeof(CnAstStmt *));
     if (!new_array) {
         return;
     }
@@ -3879,7 +4509,7 @@ static void program_add_enum(CnAstProgram *program, CnAstStmt *enum_decl)
 }
 
 // 添加类声明到program（阶段11 - 面向对象编程支持）
-static void program_add_class(CnAstProgram *program, CnAstStmt *class_decl)
+static void program_add_class(CnParser *parser, CnAstProgram *program, CnAstStmt *class_decl)
 {
     size_t new_count;
     CnAstStmt **new_array;
@@ -3889,8 +4519,8 @@ static void program_add_class(CnAstProgram *program, CnAstStmt *class_decl)
     }
 
     new_count = program->class_count + 1;
-    new_array = (CnAstStmt **)realloc(program->classes,
-                                      new_count * sizeof(CnAstStmt *));
+    new_array = (CnAstStmt **)ast_array_reserve(parser, program->classes, program->class_count,
+                                                sizeof(CnAstStmt *));
     if (!new_array) {
         return;
     }
@@ -3901,7 +4531,7 @@ static void program_add_class(CnAstProgram *program, CnAstStmt *class_decl)
 }
 
 // 添加接口声明到program（阶段11 - 面向对象编程支持）
-static void program_add_interface(CnAstProgram *program, CnAstStmt *interface_decl)
+static void program_add_interface(CnParser *parser, CnAstProgram *program, CnAstStmt *interface_decl)
 {
     size_t new_count;
     CnAstStmt **new_array;
@@ -3911,8 +4541,8 @@ static void program_add_interface(CnAstProgram *program, CnAstStmt *interface_de
     }
 
     new_count = program->interface_count + 1;
-    new_array = (CnAstStmt **)realloc(program->interfaces,
-                                      new_count * sizeof(CnAstStmt *));
+    new_array = (CnAstStmt **)ast_array_reserve(parser, program->interfaces, program->interface_count,
+                                                sizeof(CnAstStmt *));
     if (!new_array) {
         return;
     }
@@ -3923,7 +4553,7 @@ static void program_add_interface(CnAstProgram *program, CnAstStmt *interface_de
 }
 
 // 添加模板函数声明到program（阶段13 - 泛型编程支持）
-static void program_add_template_func(CnAstProgram *program, CnAstStmt *template_func_decl)
+static void program_add_template_func(CnParser *parser, CnAstProgram *program, CnAstStmt *template_func_decl)
 {
     size_t new_count;
     CnAstStmt **new_array;
@@ -3933,8 +4563,8 @@ static void program_add_template_func(CnAstProgram *program, CnAstStmt *template
     }
 
     new_count = program->template_func_count + 1;
-    new_array = (CnAstStmt **)realloc(program->template_funcs,
-                                      new_count * sizeof(CnAstStmt *));
+    new_array = (CnAstStmt **)ast_array_reserve(parser, program->template_funcs, program->template_func_count,
+                                                sizeof(CnAstStmt *));
     if (!new_array) {
         return;
     }
@@ -3945,7 +4575,7 @@ static void program_add_template_func(CnAstProgram *program, CnAstStmt *template
 }
 
 // 添加模板结构体声明到program（阶段13 - 泛型编程支持）
-static void program_add_template_struct(CnAstProgram *program, CnAstStmt *template_struct_decl)
+static void program_add_template_struct(CnParser *parser, CnAstProgram *program, CnAstStmt *template_struct_decl)
 {
     size_t new_count;
     CnAstStmt **new_array;
@@ -3955,8 +4585,8 @@ static void program_add_template_struct(CnAstProgram *program, CnAstStmt *templa
     }
 
     new_count = program->template_struct_count + 1;
-    new_array = (CnAstStmt **)realloc(program->template_structs,
-                                      new_count * sizeof(CnAstStmt *));
+    new_array = (CnAstStmt **)ast_array_reserve(parser, program->template_structs, program->template_struct_count,
+                                                sizeof(CnAstStmt *));
     if (!new_array) {
         return;
     }
@@ -3967,7 +4597,7 @@ static void program_add_template_struct(CnAstProgram *program, CnAstStmt *templa
 }
 
 // 添加导入语句到program
-static void program_add_import(CnAstProgram *program, CnAstStmt *import_stmt)
+static void program_add_import(CnParser *parser, CnAstProgram *program, CnAstStmt *import_stmt)
 {
     size_t new_count;
     CnAstStmt **new_array;
@@ -3977,8 +4607,8 @@ static void program_add_import(CnAstProgram *program, CnAstStmt *import_stmt)
     }
 
     new_count = program->import_count + 1;
-    new_array = (CnAstStmt **)realloc(program->imports,
-                                      new_count * sizeof(CnAstStmt *));
+    new_array = (CnAstStmt **)ast_array_reserve(parser, program->imports, program->import_count,
+                                                sizeof(CnAstStmt *));
     if (!new_array) {
         return;
     }
@@ -3989,7 +4619,7 @@ static void program_add_import(CnAstProgram *program, CnAstStmt *import_stmt)
 }
 
 // 添加全局变量声明到program
-static void program_add_global_var(CnAstProgram *program, CnAstStmt *var_decl)
+static void program_add_global_var(CnParser *parser, CnAstProgram *program, CnAstStmt *var_decl)
 {
     size_t new_count;
     CnAstStmt **new_array;
@@ -3999,8 +4629,8 @@ static void program_add_global_var(CnAstProgram *program, CnAstStmt *var_decl)
     }
 
     new_count = program->global_var_count + 1;
-    new_array = (CnAstStmt **)realloc(program->global_vars,
-                                      new_count * sizeof(CnAstStmt *));
+    new_array = (CnAstStmt **)ast_array_reserve(parser, program->global_vars, program->global_var_count,
+                                                sizeof(CnAstStmt *));
     if (!new_array) {
         return;
     }
@@ -4044,7 +4674,7 @@ static CnAstStmt *parse_struct_decl(CnParser *parser)
         // 解析字段列表
         size_t field_capacity = 4;
         size_t field_count = 0;
-        CnAstStructField *fields = (CnAstStructField *)malloc(sizeof(CnAstStructField) * field_capacity);
+        CnAstStructField *fields = (CnAstStructField *)ast_alloc(parser, sizeof(CnAstStructField) * field_capacity);
         if (!fields) {
             return NULL;
         }
@@ -4071,7 +4701,6 @@ static CnAstStmt *parse_struct_decl(CnParser *parser)
                                                   parser->current.column,
                                                   "语法错误：缺少字段类型");
                 }
-                free(fields);
                 return NULL;
             }
 
@@ -4102,7 +4731,6 @@ static CnAstStmt *parse_struct_decl(CnParser *parser)
                                                           parser->current.column,
                                                           "语法错误：函数指针字段名称无效");
                         }
-                        free(fields);
                         return NULL;
                     }
                     
@@ -4112,13 +4740,11 @@ static CnAstStmt *parse_struct_decl(CnParser *parser)
                     
                     // 期望 ')'
                     if (!parser_expect(parser, CN_TOKEN_RPAREN)) {
-                        free(fields);
                         return NULL;
                     }
                     
                     // 解析参数列表：'(' 类型1, 类型2, ... ')'
                     if (!parser_expect(parser, CN_TOKEN_LPAREN)) {
-                        free(fields);
                         return NULL;
                     }
                     
@@ -4126,7 +4752,6 @@ static CnAstStmt *parse_struct_decl(CnParser *parser)
                     size_t param_count = 0;
                     CnType **param_types = (CnType **)malloc(sizeof(CnType*) * param_capacity);
                     if (!param_types) {
-                        free(fields);
                         return NULL;
                     }
                     
@@ -4146,7 +4771,6 @@ static CnAstStmt *parse_struct_decl(CnParser *parser)
                                                                   "语法错误：函数指针字段参数类型无效");
                                 }
                                 free(param_types);
-                                free(fields);
                                 return NULL;
                             }
                             
@@ -4157,7 +4781,6 @@ static CnAstStmt *parse_struct_decl(CnParser *parser)
                                     param_types, sizeof(CnType*) * param_capacity);
                                 if (!new_param_types) {
                                     free(param_types);
-                                    free(fields);
                                     return NULL;
                                 }
                                 param_types = new_param_types;
@@ -4176,12 +4799,12 @@ static CnAstStmt *parse_struct_decl(CnParser *parser)
                     
                     if (!parser_expect(parser, CN_TOKEN_RPAREN)) {
                         free(param_types);
-                        free(fields);
                         return NULL;
                     }
                     
                     // 创建函数类型和函数指针类型
                     CnType *func_type = cn_type_new_function(field_type, param_types, param_count);
+                    free(param_types);
                     field_type = cn_type_new_pointer(func_type);
                 } else {
                     // 不是函数指针，回退
@@ -4195,7 +4818,6 @@ static CnAstStmt *parse_struct_decl(CnParser *parser)
                                                       parser->current.column,
                                                       "语法错误：期望函数指针字段声明或字段名称");
                     }
-                    free(fields);
                     return NULL;
                 }
             } else {
@@ -4208,7 +4830,6 @@ static CnAstStmt *parse_struct_decl(CnParser *parser)
                     size_t dimension_count = 0;
                     size_t *dimensions = (size_t *)malloc(sizeof(size_t) * dimension_capacity);
                     if (!dimensions) {
-                        free(fields);
                         return NULL;
                     }
                     
@@ -4235,14 +4856,12 @@ static CnAstStmt *parse_struct_decl(CnParser *parser)
                                                                   "语法错误：数组字段大小必须是整数字面量");
                                 }
                                 free(dimensions);
-                                free(fields);
                                 return NULL;
                             }
                         }
                         
                         if (!parser_expect(parser, CN_TOKEN_RBRACKET)) {
                             free(dimensions);
-                            free(fields);
                             return NULL;
                         }
                         
@@ -4252,7 +4871,6 @@ static CnAstStmt *parse_struct_decl(CnParser *parser)
                             size_t *new_dimensions = (size_t *)realloc(dimensions, sizeof(size_t) * dimension_capacity);
                             if (!new_dimensions) {
                                 free(dimensions);
-                                free(fields);
                                 return NULL;
                             }
                             dimensions = new_dimensions;
@@ -4281,7 +4899,6 @@ static CnAstStmt *parse_struct_decl(CnParser *parser)
                                                       parser->current.column,
                                                       "语法错误：缺少字段名称");
                     }
-                    free(fields);
                     return NULL;
                 }
                 
@@ -4293,10 +4910,9 @@ static CnAstStmt *parse_struct_decl(CnParser *parser)
             // 扩容字段数组
             if (field_count >= field_capacity) {
                 field_capacity *= 2;
-                CnAstStructField *new_fields = (CnAstStructField *)realloc(
-                    fields, sizeof(CnAstStructField) * field_capacity);
+                CnAstStructField *new_fields = (CnAstStructField *)ast_grow(parser,
+                    fields, sizeof(CnAstStructField) * field_count, sizeof(CnAstStructField) * field_capacity);
                 if (!new_fields) {
-                    free(fields);
                     return NULL;
                 }
                 fields = new_fields;
@@ -4315,7 +4931,7 @@ static CnAstStmt *parse_struct_decl(CnParser *parser)
         // 期望 } 结束结构体定义
         parser_expect(parser, CN_TOKEN_RBRACE);
 
-        return make_struct_decl_stmt(struct_name, struct_name_length, fields, field_count);
+        return make_struct_decl_stmt(parser, struct_name, struct_name_length, fields, field_count);
     }
 
     // 分支2：结构体声明 + 变量：结构体 Point p = { ... };
@@ -4416,7 +5032,9 @@ static CnAstStmt *parse_struct_decl(CnParser *parser)
     CnAstExpr *initializer = NULL;
     if (parser->current.kind == CN_TOKEN_EQUAL) {
         parser_advance(parser);
-        if (parser->current.kind == CN_TOKEN_LBRACE) {
+        if (parser->current.kind == CN_TOKEN_LBRACE && declared_type && declared_type->kind == CN_TYPE_ARRAY) {
+            initializer = parse_struct_array_initializer(parser, struct_name, struct_name_length);
+        } else if (parser->current.kind == CN_TOKEN_LBRACE) {
             // 使用已知结构体类型名解析初始化列表
             initializer = parse_struct_literal_with_name(parser, struct_name, struct_name_length);
         } else {
@@ -4426,18 +5044,17 @@ static CnAstStmt *parse_struct_decl(CnParser *parser)
 
     parser_expect(parser, CN_TOKEN_SEMICOLON);
 
-    return make_var_decl_stmt(var_name, var_name_length, declared_type, initializer, CN_VISIBILITY_DEFAULT);
+    return make_var_decl_stmt(parser, var_name, var_name_length, declared_type, initializer, CN_VISIBILITY_DEFAULT);
 }
 
 // 创建结构体声明语句
-static CnAstStmt *make_struct_decl_stmt(const char *name, size_t name_length, CnAstStructField *fields, size_t field_count)
+static CnAstStmt *make_struct_decl_stmt(CnParser *parser, const char *name, size_t name_length, CnAstStructField *fields, size_t field_count)
 {
-    CnAstStmt *stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+    CnAstStmt *stmt = ast_new_stmt(parser, CN_AST_STMT_STRUCT_DECL);
     if (!stmt) {
         return NULL;
     }
 
-    stmt->kind = CN_AST_STMT_STRUCT_DECL;
     stmt->as.struct_decl.name = name;
     stmt->as.struct_decl.name_length = name_length;
     stmt->as.struct_decl.fields = fields;
@@ -4479,7 +5096,7 @@ static CnAstStmt *parse_enum_decl(CnParser *parser)
     // 解析枚举成员列表
     size_t member_capacity = 4;
     size_t member_count = 0;
-    CnAstEnumMember *members = (CnAstEnumMember *)malloc(sizeof(CnAstEnumMember) * member_capacity);
+    CnAstEnumMember *members = (CnAstEnumMember *)ast_alloc(parser, sizeof(CnAstEnumMember) * member_capacity);
     if (!members) {
         return NULL;
     }
@@ -4499,17 +5116,15 @@ static CnAstStmt *parse_enum_decl(CnParser *parser)
                                               parser->current.column,
                                               "语法错误：缺少枚举成员名称");
             }
-            free(members);
             return NULL;
         }
 
         // 扩容成员数组
         if (member_count >= member_capacity) {
             member_capacity *= 2;
-            CnAstEnumMember *new_members = (CnAstEnumMember *)realloc(
-                members, sizeof(CnAstEnumMember) * member_capacity);
+            CnAstEnumMember *new_members = (CnAstEnumMember *)ast_grow(parser,
+                members, sizeof(CnAstEnumMember) * member_count, sizeof(CnAstEnumMember) * member_capacity);
             if (!new_members) {
-                free(members);
                 return NULL;
             }
             members = new_members;
@@ -4544,7 +5159,6 @@ static CnAstStmt *parse_enum_decl(CnParser *parser)
                                                   parser->current.column,
                                                   "语法错误：期望一个整数值");
                 }
-                free(members);
                 return NULL;
             }
 
@@ -4586,7 +5200,6 @@ static CnAstStmt *parse_enum_decl(CnParser *parser)
                                               parser->current.column,
                                               "语法错误：期望逗号或右大括号");
             }
-            free(members);
             return NULL;
         }
     }
@@ -4594,18 +5207,17 @@ static CnAstStmt *parse_enum_decl(CnParser *parser)
     // 期望 } 结束枚举定义
     parser_expect(parser, CN_TOKEN_RBRACE);
 
-    return make_enum_decl_stmt(enum_name, enum_name_length, members, member_count);
+    return make_enum_decl_stmt(parser, enum_name, enum_name_length, members, member_count);
 }
 
 // 创建枚举声明语句
-static CnAstStmt *make_enum_decl_stmt(const char *name, size_t name_length, CnAstEnumMember *members, size_t member_count)
+static CnAstStmt *make_enum_decl_stmt(CnParser *parser, const char *name, size_t name_length, CnAstEnumMember *members, size_t member_count)
 {
-    CnAstStmt *stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+    CnAstStmt *stmt = ast_new_stmt(parser, CN_AST_STMT_ENUM_DECL);
     if (!stmt) {
         return NULL;
     }
 
-    stmt->kind = CN_AST_STMT_ENUM_DECL;
     stmt->as.enum_decl.name = name;
     stmt->as.enum_decl.name_length = name_length;
     stmt->as.enum_decl.members = members;
@@ -4614,14 +5226,13 @@ static CnAstStmt *make_enum_decl_stmt(const char *name, size_t name_length, CnAs
 }
 
 // 创建结构体成员访问表达式
-static CnAstExpr *make_member_access(CnAstExpr *object, const char *member_name, size_t member_name_length, int is_arrow)
+static CnAstExpr *make_member_access(CnParser *parser, CnAstExpr *object, const char *member_name, size_t member_name_length, int is_arrow)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_MEMBER_ACCESS);
     if (!expr) {
         return NULL;
     }
 
-    expr->kind = CN_AST_EXPR_MEMBER_ACCESS;
     expr->type = NULL;
     expr->is_this_pointer = 0;  // 成员访问表达式本身不是this指针
     expr->is_base_pointer = 0;  // 成员访问表达式本身不是base指针
@@ -4637,14 +5248,13 @@ static CnAstExpr *make_member_access(CnAstExpr *object, const char *member_name,
 }
 
 // 创建结构体字面量表达式
-static CnAstExpr *make_struct_literal(const char *struct_name, size_t struct_name_length, CnAstStructFieldInit *fields, size_t field_count)
+static CnAstExpr *make_struct_literal(CnParser *parser, const char *struct_name, size_t struct_name_length, CnAstStructFieldInit *fields, size_t field_count)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_STRUCT_LITERAL);
     if (!expr) {
         return NULL;
     }
 
-    expr->kind = CN_AST_EXPR_STRUCT_LITERAL;
     expr->type = NULL;
     expr->as.struct_lit.struct_name = struct_name;
     expr->as.struct_lit.struct_name_length = struct_name_length;
@@ -4654,52 +5264,77 @@ static CnAstExpr *make_struct_literal(const char *struct_name, size_t struct_nam
 }
 
 // 创建类型转换表达式
-static CnAstExpr *make_cast(CnType *target_type, CnAstExpr *operand)
+static CnAstExpr *make_cast(CnParser *parser, CnType *target_type, CnAstExpr *operand)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_CAST);
     if (!expr) {
         return NULL;
     }
 
-    expr->kind = CN_AST_EXPR_CAST;
     expr->type = target_type;  // 类型转换表达式的类型就是目标类型
     expr->as.cast.target_type = target_type;
     expr->as.cast.operand = operand;
     return expr;
 }
 
-static CnAstExpr *make_memory_read(CnAstExpr *address)
+// 解析 嵌入("路径") 的括号部分（当前词元为 '('），只记录路径，不读取文件
+static CnAstExpr *parse_embed(CnParser *parser)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr;
+    CnToken open_token = parser->current;
+    size_t path_length = 0;
+    char *path;
+
+    parser_expect(parser, CN_TOKEN_LPAREN);
+    path = process_string_escapes(parser, parser->current.lexeme_begin,
+                                  parser->current.lexeme_length, &path_length);
+    parser_advance(parser);
+    parser_expect(parser, CN_TOKEN_RPAREN);
+
+    expr = ast_new_expr(parser, CN_AST_EXPR_EMBED);
+    if (!expr) {
+        return NULL;
+    }
+    expr->type = NULL;
+    expr->loc.filename = parser->lexer ? parser->lexer->filename : NULL;
+    expr->loc.line = open_token.line;
+    expr->loc.column = open_token.column;
+    expr->as.embed.path = path ? path : "";
+    expr->as.embed.path_length = path ? path_length : 0;
+    expr->as.embed.data = NULL;
+    expr->as.embed.size = 0;
+    return expr;
+}
+
+static CnAstExpr *make_memory_read(CnParser *parser, CnAstExpr *address)
+{
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_MEMORY_READ);
     if (!expr) {
         return NULL;
     }
-    expr->kind = CN_AST_EXPR_MEMORY_READ;
     expr->type = NULL;
     expr->as.memory_read.address = address;
     return expr;
 }
 
-static CnAstExpr *make_memory_write(CnAstExpr *address, CnAstExpr *value)
+static CnAstExpr *make_memory_write(CnParser *parser, CnAstExpr *address, CnAstExpr *value)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_MEMORY_WRITE);
     if (!expr) {
         return NULL;
     }
-    expr->kind = CN_AST_EXPR_MEMORY_WRITE;
     expr->type = NULL;
     expr->as.memory_write.address = address;
     expr->as.memory_write.value = value;
     return expr;
 }
 
-static CnAstExpr *make_memory_copy(CnAstExpr *dest, CnAstExpr *src, CnAstExpr *size)
+static CnAstExpr *make_memory_copy(CnParser *parser, CnAstExpr *dest, CnAstExpr *src, CnAstExpr *size)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_MEMORY_COPY);
     if (!expr) {
         return NULL;
     }
-    expr->kind = CN_AST_EXPR_MEMORY_COPY;
     expr->type = NULL;
     expr->as.memory_copy.dest = dest;
     expr->as.memory_copy.src = src;
@@ -4707,13 +5342,12 @@ static CnAstExpr *make_memory_copy(CnAstExpr *dest, CnAstExpr *src, CnAstExpr *s
     return expr;
 }
 
-static CnAstExpr *make_memory_set(CnAstExpr *address, CnAstExpr *value, CnAstExpr *size)
+static CnAstExpr *make_memory_set(CnParser *parser, CnAstExpr *address, CnAstExpr *value, CnAstExpr *size)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_MEMORY_SET);
     if (!expr) {
         return NULL;
     }
-    expr->kind = CN_AST_EXPR_MEMORY_SET;
     expr->type = NULL;
     expr->as.memory_set.address = address;
     expr->as.memory_set.value = value;
@@ -4721,13 +5355,12 @@ static CnAstExpr *make_memory_set(CnAstExpr *address, CnAstExpr *value, CnAstExp
     return expr;
 }
 
-static CnAstExpr *make_memory_map(CnAstExpr *address, CnAstExpr *size, CnAstExpr *prot, CnAstExpr *flags)
+static CnAstExpr *make_memory_map(CnParser *parser, CnAstExpr *address, CnAstExpr *size, CnAstExpr *prot, CnAstExpr *flags)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_MEMORY_MAP);
     if (!expr) {
         return NULL;
     }
-    expr->kind = CN_AST_EXPR_MEMORY_MAP;
     expr->type = NULL;
     expr->as.memory_map.address = address;
     expr->as.memory_map.size = size;
@@ -4736,27 +5369,25 @@ static CnAstExpr *make_memory_map(CnAstExpr *address, CnAstExpr *size, CnAstExpr
     return expr;
 }
 
-static CnAstExpr *make_memory_unmap(CnAstExpr *address, CnAstExpr *size)
+static CnAstExpr *make_memory_unmap(CnParser *parser, CnAstExpr *address, CnAstExpr *size)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_MEMORY_UNMAP);
     if (!expr) {
         return NULL;
     }
-    expr->kind = CN_AST_EXPR_MEMORY_UNMAP;
     expr->type = NULL;
     expr->as.memory_unmap.address = address;
     expr->as.memory_unmap.size = size;
     return expr;
 }
 
-static CnAstExpr *make_inline_asm(CnAstExpr *asm_code, CnAstExpr **outputs, size_t output_count, 
+static CnAstExpr *make_inline_asm(CnParser *parser, CnAstExpr *asm_code, CnAstExpr **outputs, size_t output_count, 
                                    CnAstExpr **inputs, size_t input_count, CnAstExpr *clobbers)
 {
-    CnAstExpr *expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    CnAstExpr *expr = ast_new_expr(parser, CN_AST_EXPR_INLINE_ASM);
     if (!expr) {
         return NULL;
     }
-    expr->kind = CN_AST_EXPR_INLINE_ASM;
     expr->type = NULL;
     expr->as.inline_asm.asm_code = asm_code;
     expr->as.inline_asm.outputs = outputs;
@@ -4813,16 +5444,12 @@ static CnAstStmt *parse_import_stmt(CnParser *parser)
                                                   parser->current.column,
                                                   "语法错误：缺少别名");
                 }
-                free(module_path->segments);
-                free(module_path);
                 return NULL;
             }
             alias = parser->current.lexeme_begin;
             alias_length = parser->current.lexeme_length;
             parser_advance(parser);
             if (!parser_expect(parser, CN_TOKEN_RPAREN)) {
-                free(module_path->segments);
-                free(module_path);
                 return NULL;
             }
         }
@@ -4831,14 +5458,11 @@ static CnAstStmt *parse_import_stmt(CnParser *parser)
         parser_expect(parser, CN_TOKEN_SEMICOLON);
 
         // 创建导入语句
-        CnAstStmt *stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+        CnAstStmt *stmt = ast_new_stmt(parser, CN_AST_STMT_IMPORT);
         if (!stmt) {
-            free(module_path->segments);
-            free(module_path);
             return NULL;
         }
 
-        stmt->kind = CN_AST_STMT_IMPORT;
         stmt->as.import_stmt.module_path = module_path;
         stmt->as.import_stmt.alias = alias;
         stmt->as.import_stmt.alias_length = alias_length;
@@ -4918,7 +5542,7 @@ static CnAstStmt *parse_import_stmt(CnParser *parser)
         
         // 解析成员列表
         size_t member_capacity = 4;
-        members = (CnAstImportMember *)malloc(sizeof(CnAstImportMember) * member_capacity);
+        members = (CnAstImportMember *)ast_alloc(parser, sizeof(CnAstImportMember) * member_capacity);
         if (!members) {
             return NULL;
         }
@@ -4937,17 +5561,15 @@ static CnAstStmt *parse_import_stmt(CnParser *parser)
                                                   parser->current.column,
                                                   "语法错误：缺少成员名称");
                 }
-                free(members);
                 return NULL;
             }
             
             // 扩容检查
             if (member_count >= member_capacity) {
                 member_capacity *= 2;
-                CnAstImportMember *new_members = (CnAstImportMember *)realloc(
-                    members, sizeof(CnAstImportMember) * member_capacity);
+                CnAstImportMember *new_members = (CnAstImportMember *)ast_grow(parser,
+                    members, sizeof(CnAstImportMember) * member_count, sizeof(CnAstImportMember) * member_capacity);
                 if (!new_members) {
-                    free(members);
                     return NULL;
                 }
                 members = new_members;
@@ -4974,14 +5596,12 @@ static CnAstStmt *parse_import_stmt(CnParser *parser)
                                                   parser->current.column,
                                                   "语法错误：期望 ',' 或 '}'");
                 }
-                free(members);
                 return NULL;
             }
         }
         
         // 期望右大括号
         if (!parser_expect(parser, CN_TOKEN_RBRACE)) {
-            free(members);
             return NULL;
         }
     }
@@ -4990,15 +5610,11 @@ static CnAstStmt *parse_import_stmt(CnParser *parser)
     parser_expect(parser, CN_TOKEN_SEMICOLON);
 
     // 创建导入语句
-    CnAstStmt *stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+    CnAstStmt *stmt = ast_new_stmt(parser, CN_AST_STMT_IMPORT);
     if (!stmt) {
-        if (members) {
-            free(members);
-        }
         return NULL;
     }
 
-    stmt->kind = CN_AST_STMT_IMPORT;
     stmt->as.import_stmt.module_name = module_name;
     stmt->as.import_stmt.module_name_length = module_name_length;
     stmt->as.import_stmt.alias = alias;
@@ -5020,10 +5636,10 @@ static CnAstStmt *parse_import_stmt(CnParser *parser)
 //   1. 斜杠路径：工具/数学/高级
 //   2. 点分路径：工具.数学.高级
 //   3. 相对导入：./兄弟模块、../父级模块、../../祖父模块
-// 返回值需要由调用者释放
+// 返回的路径分配在解析器的 Arena 中
 static CnAstModulePath *parse_module_path(CnParser *parser)
 {
-    CnAstModulePath *path = (CnAstModulePath *)malloc(sizeof(CnAstModulePath));
+    CnAstModulePath *path = (CnAstModulePath *)ast_alloc(parser, sizeof(CnAstModulePath));
     if (!path) {
         return NULL;
     }
@@ -5074,9 +5690,8 @@ static CnAstModulePath *parse_module_path(CnParser *parser)
     
     // 解析模块路径段
     size_t capacity = 4;
-    path->segments = (CnAstModulePathSegment *)malloc(sizeof(CnAstModulePathSegment) * capacity);
+    path->segments = (CnAstModulePathSegment *)ast_alloc(parser, sizeof(CnAstModulePathSegment) * capacity);
     if (!path->segments) {
-        free(path);
         return NULL;
     }
     
@@ -5097,8 +5712,6 @@ static CnAstModulePath *parse_module_path(CnParser *parser)
                                           parser->current.column,
                                           "语法错误：期望模块名称");
         }
-        free(path->segments);
-        free(path);
         return NULL;
     }
     
@@ -5107,11 +5720,9 @@ static CnAstModulePath *parse_module_path(CnParser *parser)
         // 扩容检查
         if (path->segment_count >= capacity) {
             capacity *= 2;
-            CnAstModulePathSegment *new_segments = (CnAstModulePathSegment *)realloc(
-                path->segments, sizeof(CnAstModulePathSegment) * capacity);
+            CnAstModulePathSegment *new_segments = (CnAstModulePathSegment *)ast_grow(parser,
+                path->segments, sizeof(CnAstModulePathSegment) * path->segment_count, sizeof(CnAstModulePathSegment) * capacity);
             if (!new_segments) {
-                free(path->segments);
-                free(path);
                 return NULL;
             }
             path->segments = new_segments;
@@ -5140,8 +5751,6 @@ static CnAstModulePath *parse_module_path(CnParser *parser)
                                                   parser->current.column,
                                                   "语法错误：路径分隔符后期望模块名称");
                 }
-                free(path->segments);
-                free(path);
                 return NULL;
             }
         } else {
@@ -5172,8 +5781,6 @@ static CnAstStmt *parse_from_import_stmt(CnParser *parser)
     
     // 期望 "导入" 关键字
     if (!parser_expect(parser, CN_TOKEN_KEYWORD_IMPORT)) {
-        free(module_path->segments);
-        free(module_path);
         return NULL;
     }
     
@@ -5194,10 +5801,8 @@ static CnAstStmt *parse_from_import_stmt(CnParser *parser)
         
         // 解析成员列表
         size_t member_capacity = 4;
-        members = (CnAstImportMember *)malloc(sizeof(CnAstImportMember) * member_capacity);
+        members = (CnAstImportMember *)ast_alloc(parser, sizeof(CnAstImportMember) * member_capacity);
         if (!members) {
-            free(module_path->segments);
-            free(module_path);
             return NULL;
         }
         
@@ -5215,21 +5820,15 @@ static CnAstStmt *parse_from_import_stmt(CnParser *parser)
                                                   parser->current.column,
                                                   "语法错误：缺少成员名称");
                 }
-                free(members);
-                free(module_path->segments);
-                free(module_path);
                 return NULL;
             }
             
             // 扩容检查
             if (member_count >= member_capacity) {
                 member_capacity *= 2;
-                CnAstImportMember *new_members = (CnAstImportMember *)realloc(
-                    members, sizeof(CnAstImportMember) * member_capacity);
+                CnAstImportMember *new_members = (CnAstImportMember *)ast_grow(parser,
+                    members, sizeof(CnAstImportMember) * member_count, sizeof(CnAstImportMember) * member_capacity);
                 if (!new_members) {
-                    free(members);
-                    free(module_path->segments);
-                    free(module_path);
                     return NULL;
                 }
                 members = new_members;
@@ -5258,9 +5857,6 @@ static CnAstStmt *parse_from_import_stmt(CnParser *parser)
                                                       parser->current.column,
                                                       "语法错误：缺少别名");
                     }
-                    free(members);
-                    free(module_path->segments);
-                    free(module_path);
                     return NULL;
                 }
                 
@@ -5269,9 +5865,6 @@ static CnAstStmt *parse_from_import_stmt(CnParser *parser)
                 parser_advance(parser);
                 
                 if (!parser_expect(parser, CN_TOKEN_RPAREN)) {
-                    free(members);
-                    free(module_path->segments);
-                    free(module_path);
                     return NULL;
                 }
             }
@@ -5292,18 +5885,12 @@ static CnAstStmt *parse_from_import_stmt(CnParser *parser)
                                                   parser->current.column,
                                                   "语法错误：期望 ',' 或 '}'");
                 }
-                free(members);
-                free(module_path->segments);
-                free(module_path);
                 return NULL;
             }
         }
         
         // 期望右大括号
         if (!parser_expect(parser, CN_TOKEN_RBRACE)) {
-            free(members);
-            free(module_path->segments);
-            free(module_path);
             return NULL;
         }
         
@@ -5312,10 +5899,8 @@ static CnAstStmt *parse_from_import_stmt(CnParser *parser)
     // 从包导入模块：从 包 导入 模块名;
     else if (parser->current.kind == CN_TOKEN_IDENT) {
         // 将当前标识符作为要导入的模块名
-        members = (CnAstImportMember *)malloc(sizeof(CnAstImportMember));
+        members = (CnAstImportMember *)ast_alloc(parser, sizeof(CnAstImportMember));
         if (!members) {
-            free(module_path->segments);
-            free(module_path);
             return NULL;
         }
         
@@ -5342,9 +5927,6 @@ static CnAstStmt *parse_from_import_stmt(CnParser *parser)
                                                   parser->current.column,
                                                   "语法错误：缺少别名");
                 }
-                free(members);
-                free(module_path->segments);
-                free(module_path);
                 return NULL;
             }
             
@@ -5353,9 +5935,6 @@ static CnAstStmt *parse_from_import_stmt(CnParser *parser)
             parser_advance(parser);
             
             if (!parser_expect(parser, CN_TOKEN_RPAREN)) {
-                free(members);
-                free(module_path->segments);
-                free(module_path);
                 return NULL;
             }
         }
@@ -5373,8 +5952,6 @@ static CnAstStmt *parse_from_import_stmt(CnParser *parser)
                                           parser->current.column,
                                           "语法错误：期望 '*'、'{' 或模块名称");
         }
-        free(module_path->segments);
-        free(module_path);
         return NULL;
     }
     
@@ -5382,17 +5959,11 @@ static CnAstStmt *parse_from_import_stmt(CnParser *parser)
     parser_expect(parser, CN_TOKEN_SEMICOLON);
     
     // 创建导入语句
-    CnAstStmt *stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+    CnAstStmt *stmt = ast_new_stmt(parser, CN_AST_STMT_IMPORT);
     if (!stmt) {
-        if (members) {
-            free(members);
-        }
-        free(module_path->segments);
-        free(module_path);
         return NULL;
     }
     
-    stmt->kind = CN_AST_STMT_IMPORT;
     stmt->as.import_stmt.kind = kind;
     
     // 从 module_path 提取模块名（最后一个路径段）
@@ -6317,13 +6888,12 @@ static CnAstStmt *parse_class_decl(CnParser *parser)
     }
     
     // 包装为语句节点
-    CnAstStmt *stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+    CnAstStmt *stmt = ast_new_stmt(parser, CN_AST_STMT_CLASS_DECL);
     if (!stmt) {
         cn_ast_class_decl_destroy(class_decl);
         return NULL;
     }
     
-    stmt->kind = CN_AST_STMT_CLASS_DECL;
     stmt->as.class_decl = class_decl;
     
     return stmt;
@@ -6547,13 +7117,12 @@ static CnAstStmt *parse_interface_decl(CnParser *parser)
     }
     
     // 包装为语句节点
-    CnAstStmt *stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+    CnAstStmt *stmt = ast_new_stmt(parser, CN_AST_STMT_INTERFACE_DECL);
     if (!stmt) {
         cn_ast_interface_decl_destroy(interface_decl);
         return NULL;
     }
     
-    stmt->kind = CN_AST_STMT_INTERFACE_DECL;
     stmt->as.interface_decl = interface_decl;
     
     return stmt;
@@ -6601,14 +7170,13 @@ static CnAstTemplateParams *parse_template_params(CnParser *parser)
     }
     
     // 分配参数列表结构
-    params = (CnAstTemplateParams *)malloc(sizeof(CnAstTemplateParams));
+    params = (CnAstTemplateParams *)ast_alloc(parser, sizeof(CnAstTemplateParams));
     if (!params) {
         return NULL;
     }
     
-    params->params = (CnAstTemplateParam *)malloc(sizeof(CnAstTemplateParam) * capacity);
+    params->params = (CnAstTemplateParam *)ast_alloc(parser, sizeof(CnAstTemplateParam) * capacity);
     if (!params->params) {
-        free(params);
         return NULL;
     }
     params->param_count = 0;
@@ -6636,19 +7204,15 @@ static CnAstTemplateParams *parse_template_params(CnParser *parser)
                                               parser->current.column,
                                               "语法错误：期望类型参数名称");
             }
-            free(params->params);
-            free(params);
             return NULL;
         }
         
         // 扩容检查
         if (params->param_count >= capacity) {
             capacity *= 2;
-            CnAstTemplateParam *new_params = (CnAstTemplateParam *)realloc(params->params,
-                                            sizeof(CnAstTemplateParam) * capacity);
+            CnAstTemplateParam *new_params = (CnAstTemplateParam *)ast_grow(parser, params->params,
+                                            sizeof(CnAstTemplateParam) * params->param_count, sizeof(CnAstTemplateParam) * capacity);
             if (!new_params) {
-                free(params->params);
-                free(params);
                 return NULL;
             }
             params->params = new_params;
@@ -6682,8 +7246,6 @@ static CnAstTemplateParams *parse_template_params(CnParser *parser)
                                           parser->current.column,
                                           "语法错误：期望 '>' 结束模板参数列表");
         }
-        free(params->params);
-        free(params);
         return NULL;
     }
     
@@ -6735,8 +7297,6 @@ static CnAstStmt *parse_template_declaration(CnParser *parser)
                                           parser->current.column,
                                           "语法错误：模板声明后期望 '函数'、'结构体' 或 '接口'");
         }
-        free(params->params);
-        free(params);
         return NULL;
     }
 }
@@ -6751,24 +7311,25 @@ static CnAstStmt *parse_template_function_decl_with_params(CnParser *parser, CnA
     CnAstFunctionDecl *function;
     CnAstTemplateFunctionDecl *template_func;
     CnAstStmt *stmt;
+    int skim_bodies;
     
     if (!parser || !params) {
         return NULL;
     }
     
     // 解析函数声明（复用现有函数解析逻辑）
+    // 模板函数体在实例化时复制，跳读模式下也完整解析
+    skim_bodies = parser->skim_bodies;
+    parser->skim_bodies = 0;
     function = parse_function_decl(parser);
+    parser->skim_bodies = skim_bodies;
     if (!function) {
-        free(params->params);
-        free(params);
         return NULL;
     }
     
     // 创建模板函数节点
-    template_func = (CnAstTemplateFunctionDecl *)malloc(sizeof(CnAstTemplateFunctionDecl));
+    template_func = (CnAstTemplateFunctionDecl *)ast_alloc(parser, sizeof(CnAstTemplateFunctionDecl));
     if (!template_func) {
-        free(params->params);
-        free(params);
         return NULL;
     }
     
@@ -6776,15 +7337,11 @@ static CnAstStmt *parse_template_function_decl_with_params(CnParser *parser, CnA
     template_func->function = function;
     
     // 包装为语句节点
-    stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+    stmt = ast_new_stmt(parser, CN_AST_STMT_TEMPLATE_FUNCTION_DECL);
     if (!stmt) {
-        free(template_func);
-        free(params->params);
-        free(params);
         return NULL;
     }
     
-    stmt->kind = CN_AST_STMT_TEMPLATE_FUNCTION_DECL;
     stmt->as.template_func_decl = template_func;
     
     return stmt;
@@ -6808,25 +7365,17 @@ static CnAstStmt *parse_template_struct_decl_with_params(CnParser *parser, CnAst
     // 解析结构体声明（复用现有结构体解析逻辑）
     struct_stmt = parse_struct_decl(parser);
     if (!struct_stmt) {
-        free(params->params);
-        free(params);
         return NULL;
     }
     
     // 确保是结构体声明
     if (struct_stmt->kind != CN_AST_STMT_STRUCT_DECL) {
-        free(struct_stmt);
-        free(params->params);
-        free(params);
         return NULL;
     }
     
     // 创建模板结构体节点
-    template_struct = (CnAstTemplateStructDecl *)malloc(sizeof(CnAstTemplateStructDecl));
+    template_struct = (CnAstTemplateStructDecl *)ast_alloc(parser, sizeof(CnAstTemplateStructDecl));
     if (!template_struct) {
-        free(struct_stmt);
-        free(params->params);
-        free(params);
         return NULL;
     }
     
@@ -6834,20 +7383,13 @@ static CnAstStmt *parse_template_struct_decl_with_params(CnParser *parser, CnAst
     template_struct->struct_decl = &struct_stmt->as.struct_decl;
     
     // 包装为语句节点
-    stmt = (CnAstStmt *)malloc(sizeof(CnAstStmt));
+    stmt = ast_new_stmt(parser, CN_AST_STMT_TEMPLATE_STRUCT_DECL);
     if (!stmt) {
-        free(template_struct);
-        free(struct_stmt);
-        free(params->params);
-        free(params);
         return NULL;
     }
     
-    stmt->kind = CN_AST_STMT_TEMPLATE_STRUCT_DECL;
     stmt->as.template_struct_decl = template_struct;
     
-    // 释放原始结构体语句节点（但保留其内容）
-    free(struct_stmt);
     
     return stmt;
 }
@@ -6879,16 +7421,15 @@ static CnAstExpr *parse_template_instantiation(CnParser *parser, const char *nam
     }
     
     // 分配实例化结构
-    inst = (CnAstTemplateInstantiationExpr *)malloc(sizeof(CnAstTemplateInstantiationExpr));
+    inst = (CnAstTemplateInstantiationExpr *)ast_alloc(parser, sizeof(CnAstTemplateInstantiationExpr));
     if (!inst) {
         return NULL;
     }
     
     inst->template_name = name;
     inst->template_name_length = name_len;
-    inst->type_args = (CnType **)malloc(sizeof(CnType *) * capacity);
+    inst->type_args = (CnType **)ast_alloc(parser, sizeof(CnType *) * capacity);
     if (!inst->type_args) {
-        free(inst);
         return NULL;
     }
     inst->type_arg_count = 0;
@@ -6917,19 +7458,15 @@ static CnAstExpr *parse_template_instantiation(CnParser *parser, const char *nam
                                               parser->current.column,
                                               "语法错误：期望类型参数");
             }
-            free(inst->type_args);
-            free(inst);
             return NULL;
         }
         
         // 扩容检查
         if (inst->type_arg_count >= capacity) {
             capacity *= 2;
-            CnType **new_args = (CnType **)realloc(inst->type_args,
-                                                    sizeof(CnType *) * capacity);
+            CnType **new_args = (CnType **)ast_grow(parser, inst->type_args,
+                                                    sizeof(CnType *) * inst->type_arg_count, sizeof(CnType *) * capacity);
             if (!new_args) {
-                free(inst->type_args);
-                free(inst);
                 return NULL;
             }
             inst->type_args = new_args;
@@ -6957,20 +7494,15 @@ static CnAstExpr *parse_template_instantiation(CnParser *parser, const char *nam
                                           parser->current.column,
                                           "语法错误：期望 '>' 结束模板实参列表");
         }
-        free(inst->type_args);
-        free(inst);
         return NULL;
     }
     
     // 包装为表达式节点
-    expr = (CnAstExpr *)malloc(sizeof(CnAstExpr));
+    expr = ast_new_expr(parser, CN_AST_EXPR_TEMPLATE_INSTANTIATION);
     if (!expr) {
-        free(inst->type_args);
-        free(inst);
         return NULL;
     }
     
-    expr->kind = CN_AST_EXPR_TEMPLATE_INSTANTIATION;
     expr->type = NULL;  // 语义分析阶段填充
     expr->is_this_pointer = 0;
     // 复制内容而不是指针（union中是值类型）
@@ -6978,7 +7510,6 @@ static CnAstExpr *parse_template_instantiation(CnParser *parser, const char *nam
     expr->as.template_inst.template_name_length = inst->template_name_length;
     expr->as.template_inst.type_args = inst->type_args;
     expr->as.template_inst.type_arg_count = inst->type_arg_count;
-    free(inst);  // 释放临时结构，但保留其内部指针指向的内容
     
     return expr;
 }
@@ -7004,16 +7535,11 @@ static CnAstStmt *parse_template_interface_decl_with_params(CnParser *parser, Cn
     // 解析接口声明（复用现有接口解析逻辑）
     interface_stmt = parse_interface_decl(parser);
     if (!interface_stmt) {
-        free(params->params);
-        free(params);
         return NULL;
     }
     
     // 确保是接口声明
     if (interface_stmt->kind != CN_AST_STMT_INTERFACE_DECL) {
-        free(interface_stmt);
-        free(params->params);
-        free(params);
         return NULL;
     }
     
@@ -1,10 +1,32 @@
 #include "cnlang/frontend/preprocessor.h"
 #include "cnlang/support/diagnostics.h"
+#include "cnlang/support/memory/arena.h"
 
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <stdio.h>
+#include <time.h>
+
+#define CN_MACRO_INITIAL_SLOTS 64
+#define CN_EXPANSION_ARENA_BLOCK 4096
+
+/* 预处理指令种类 */
+typedef enum CnDirectiveKind {
+    CN_DIRECTIVE_UNKNOWN,
+    CN_DIRECTIVE_DEFINE,
+    CN_DIRECTIVE_IFDEF,
+    CN_DIRECTIVE_IFNDEF,
+    CN_DIRECTIVE_ELSE,
+    CN_DIRECTIVE_ENDIF,
+    CN_DIRECTIVE_UNDEF
+} CnDirectiveKind;
+
+/* 函数宏实参：直接引用源码中的片段，不复制 */
+typedef struct CnMacroArg {
+    const char *text;
+    size_t length;
+} CnMacroArg;
 
 /* ========== 内部辅助函数声明 ========== */
 
@@ -19,6 +41,7 @@ static void append_output(CnPreprocessor *pp, const char *text, size_t length);
 static void append_char(CnPreprocessor *pp, char c);
 static void report_error(CnPreprocessor *pp, const char *message);
 
+static CnDirectiveKind classify_directive(const char *name, size_t length);
 static bool process_directive(CnPreprocessor *pp);
 static bool process_define(CnPreprocessor *pp);
 static bool process_ifdef(CnPreprocessor *pp, bool negate);
@@ -26,14 +49,24 @@ static bool process_else(CnPreprocessor *pp);
 static bool process_endif(CnPreprocessor *pp);
 static bool process_undef(CnPreprocessor *pp);
 
+static uint32_t hash_macro_name(const char *name, size_t name_length);
 static CnMacro* find_macro(const CnPreprocessor *pp, const char *name, size_t name_length);
+static bool rebuild_macro_slots(CnPreprocessor *pp, size_t slot_count);
 static bool add_macro(CnPreprocessor *pp, CnMacro *macro);
 static void free_macro(CnMacro *macro);
 static bool expand_macro(CnPreprocessor *pp, const char *name, size_t name_length);
-static bool parse_function_macro_args(CnPreprocessor *pp, char ***out_args, size_t *out_count);
-static char* substitute_macro_params(const CnMacro *macro, char **args, size_t arg_count);
-
+static bool parse_function_macro_args(CnPreprocessor *pp, CnMacroArg **out_args, size_t *out_count);
+static bool build_macro_template(CnMacro *macro);
+static void splice_macro_template(CnPreprocessor *pp, const CnMacro *macro, const CnMacroArg *args);
+
+static bool needs_preprocessing(const CnPreprocessor *pp);
+static void skip_layout(CnPreprocessor *pp);
+static bool at_line_start(const CnPreprocessor *pp);
+static void lex_source_token(CnPreprocessor *pp, CnToken *out_token);
+static bool begin_expansion(CnPreprocessor *pp, const CnToken *name_token);
+static void make_eof_token(const CnPreprocessor *pp, CnToken *out_token);
 static bool is_condition_active(const CnPreprocessor *pp);
+static void skip_inactive_region(CnPreprocessor *pp);
 static bool push_condition(CnPreprocessor *pp, bool active);
 static bool pop_condition(CnPreprocessor *pp);
 
@@ -56,10 +89,17 @@ void cn_frontend_preprocessor_init(
     preprocessor->output = NULL;
     preprocessor->output_length = 0;
     preprocessor->output_capacity = 0;
+    preprocessor->output_borrowed = false;
     
     preprocessor->macros = NULL;
     preprocessor->macro_count = 0;
     preprocessor->macro_capacity = 0;
+    preprocessor->macro_slots = NULL;
+    preprocessor->macro_slot_count = 0;
+    
+    preprocessor->collect_stats = false;
+    preprocessor->macro_expansion_count = 0;
+    preprocessor->macro_expansion_time_us = 0;
     
     preprocessor->condition_stack = NULL;
     preprocessor->condition_depth = 0;
@@ -69,6 +109,14 @@ void cn_frontend_preprocessor_init(
     preprocessor->current_line = 1;
     preprocessor->current_column = 1;
     
+    cn_frontend_lexer_init(&preprocessor->token_lexer, source, source_length, filename);
+    cn_frontend_lexer_init(&preprocessor->expansion_lexer, NULL, 0, filename);
+    preprocessor->in_expansion = false;
+    preprocessor->expansion_line = 0;
+    preprocessor->expansion_column = 0;
+    preprocessor->expansion_arena = NULL;
+    preprocessor->stream_failed = false;
+    
     preprocessor->diagnostics = NULL;
     
     // 跳过UTF-8 BOM（如果存在）
@@ -87,6 +135,17 @@ void cn_frontend_preprocessor_set_diagnostics(
 {
     if (preprocessor) {
         preprocessor->diagnostics = diagnostics;
+        cn_frontend_lexer_set_diagnostics(&preprocessor->token_lexer, diagnostics);
+        cn_frontend_lexer_set_diagnostics(&preprocessor->expansion_lexer, diagnostics);
+    }
+}
+
+void cn_frontend_preprocessor_set_collect_stats(
+    CnPreprocessor *preprocessor,
+    bool enabled)
+{
+    if (preprocessor) {
+        preprocessor->collect_stats = enabled;
     }
 }
 
@@ -96,6 +155,16 @@ bool cn_frontend_preprocessor_process(CnPreprocessor *preprocessor)
         return false;
     }
 
+    /* 没有指令、宏与块注释时输出与输入等价，直接引用源码（行注释与 BOM 交给词法分析器跳过） */
+    if (cn_frontend_preprocessor_is_passthrough(preprocessor)) {
+        preprocessor->output = (char *)preprocessor->source;
+        preprocessor->output_length = preprocessor->source_length;
+        preprocessor->output_capacity = 0;
+        preprocessor->output_borrowed = true;
+        preprocessor->current_offset = preprocessor->source_length;
+        return true;
+    }
+
     /* 初始化输出缓冲区 */
     preprocessor->output_capacity = preprocessor->source_length + 1024;
     preprocessor->output = (char *)malloc(preprocessor->output_capacity);
@@ -261,11 +330,7 @@ bool cn_frontend_preprocessor_process(CnPreprocessor *preprocessor)
         
         /* 跳过条件编译不活跃的代码 */
         if (!is_condition_active(preprocessor)) {
-            if (c == '\n') {
-                advance(preprocessor);
-            } else {
-                skip_line(preprocessor);
-            }
+            skip_inactive_region(preprocessor);
             continue;
         }
         
@@ -304,6 +369,84 @@ bool cn_frontend_preprocessor_process(CnPreprocessor *preprocessor)
     return true;
 }
 
+bool cn_frontend_preprocessor_next_token(CnPreprocessor *preprocessor, CnToken *out_token)
+{
+    if (!preprocessor || !out_token) {
+        return false;
+    }
+
+    for (;;) {
+        /* 先取完当前宏展开出的词元（不再重新扫描展开结果，与 process 一致） */
+        if (preprocessor->in_expansion) {
+            if (cn_frontend_lexer_next_token(&preprocessor->expansion_lexer, out_token) &&
+                out_token->kind != CN_TOKEN_EOF) {
+                out_token->line = preprocessor->expansion_line;
+                out_token->column = preprocessor->expansion_column;
+                return true;
+            }
+            preprocessor->in_expansion = false;
+        }
+
+        if (preprocessor->stream_failed) {
+            make_eof_token(preprocessor, out_token);
+            return false;
+        }
+
+        skip_layout(preprocessor);
+
+        if (preprocessor->current_offset >= preprocessor->source_length) {
+            if (preprocessor->condition_depth > 0) {
+                report_error(preprocessor, "未闭合的条件编译指令");
+                preprocessor->stream_failed = true;
+                make_eof_token(preprocessor, out_token);
+                return false;
+            }
+            make_eof_token(preprocessor, out_token);
+            return true;
+        }
+
+        /* 行首的 # 为预处理指令（# 前可以有空白） */
+        if (current_char(preprocessor) == '#' && at_line_start(preprocessor)) {
+            if (!process_directive(preprocessor)) {
+                preprocessor->stream_failed = true;
+                make_eof_token(preprocessor, out_token);
+                return false;
+            }
+            continue;
+        }
+
+        /* 跳过条件编译不活跃的代码 */
+        if (!is_condition_active(preprocessor)) {
+            skip_inactive_region(preprocessor);
+            continue;
+        }
+
+        lex_source_token(preprocessor, out_token);
+        if (out_token->kind == CN_TOKEN_EOF) {
+            /* 只剩未闭合的块注释（词法分析器已报告），回到循环开头收尾 */
+            continue;
+        }
+
+        /* 标识符形式的词元（包括关键字）可能是宏名 */
+        if (preprocessor->macro_count > 0 &&
+            out_token->lexeme_length > 0 &&
+            is_identifier_start(out_token->lexeme_begin[0]) &&
+            begin_expansion(preprocessor, out_token)) {
+            continue;
+        }
+
+        return true;
+    }
+}
+
+bool cn_frontend_preprocessor_is_passthrough(const CnPreprocessor *preprocessor)
+{
+    if (!preprocessor) {
+        return false;
+    }
+    return preprocessor->macro_count == 0 && !needs_preprocessing(preprocessor);
+}
+
 void cn_frontend_preprocessor_free(CnPreprocessor *preprocessor)
 {
     size_t i;
@@ -312,12 +455,20 @@ void cn_frontend_preprocessor_free(CnPreprocessor *preprocessor)
         return;
     }
 
-    /* 释放输出缓冲区 */
-    free(preprocessor->output);
+    /* 释放输出缓冲区（引用源码时不归本对象所有） */
+    if (!preprocessor->output_borrowed) {
+        free(preprocessor->output);
+    }
     preprocessor->output = NULL;
+    preprocessor->output_borrowed = false;
     preprocessor->output_length = 0;
     preprocessor->output_capacity = 0;
 
+    /* 释放宏展开文本（逐词元模式） */
+    cn_arena_free(preprocessor->expansion_arena);
+    preprocessor->expansion_arena = NULL;
+    preprocessor->in_expansion = false;
+
     /* 释放宏定义 */
     for (i = 0; i < preprocessor->macro_count; ++i) {
         free_macro(&preprocessor->macros[i]);
@@ -326,6 +477,9 @@ void cn_frontend_preprocessor_free(CnPreprocessor *preprocessor)
     preprocessor->macros = NULL;
     preprocessor->macro_count = 0;
     preprocessor->macro_capacity = 0;
+    free(preprocessor->macro_slots);
+    preprocessor->macro_slots = NULL;
+    preprocessor->macro_slot_count = 0;
 
     /* 释放条件栈 */
     free(preprocessor->condition_stack);
@@ -371,6 +525,8 @@ bool cn_frontend_preprocessor_define_macro(
 
     macro.params = NULL;
     macro.param_count = 0;
+    macro.segments = NULL;
+    macro.segment_count = 0;
     macro.is_function_like = false;
     macro.defined_line = preprocessor->current_line;
 
@@ -381,33 +537,33 @@ bool cn_frontend_preprocessor_undefine_macro(
     CnPreprocessor *preprocessor,
     const char *name)
 {
+    CnMacro *macro;
     size_t i;
-    size_t name_len;
 
     if (!preprocessor || !name) {
         return false;
     }
 
-    name_len = strlen(name);
+    macro = find_macro(preprocessor, name, strlen(name));
+    if (!macro) {
+        return false;
+    }
+
+    /* 找到宏,释放并移除 */
+    i = (size_t)(macro - preprocessor->macros);
+    free_macro(macro);
     
-    for (i = 0; i < preprocessor->macro_count; ++i) {
-        if (preprocessor->macros[i].name_length == name_len &&
-            memcmp(preprocessor->macros[i].name, name, name_len) == 0) {
-            /* 找到宏,释放并移除 */
-            free_macro(&preprocessor->macros[i]);
-            
-            /* 将后续元素前移 */
-            if (i + 1 < preprocessor->macro_count) {
-                memmove(&preprocessor->macros[i],
-                        &preprocessor->macros[i + 1],
-                        (preprocessor->macro_count - i - 1) * sizeof(CnMacro));
-            }
-            preprocessor->macro_count--;
-            return true;
-        }
+    /* 将后续元素前移 */
+    if (i + 1 < preprocessor->macro_count) {
+        memmove(&preprocessor->macros[i],
+                &preprocessor->macros[i + 1],
+                (preprocessor->macro_count - i - 1) * sizeof(CnMacro));
     }
+    preprocessor->macro_count--;
 
-    return false;
+    /* 下标发生了移动，重建哈希表（#undef 很少见，重建代价可以接受） */
+    rebuild_macro_slots(preprocessor, preprocessor->macro_slot_count);
+    return true;
 }
 
 bool cn_frontend_preprocessor_is_defined(
@@ -463,12 +619,23 @@ static void skip_whitespace(CnPreprocessor *pp)
 
 static void skip_line(CnPreprocessor *pp)
 {
-    while (current_char(pp) != '\n' && current_char(pp) != '\0') {
-        advance(pp);
+    const char *line_end;
+
+    if (pp->current_offset >= pp->source_length) {
+        return;
     }
-    if (current_char(pp) == '\n') {
-        advance(pp);
+
+    line_end = (const char *)memchr(pp->source + pp->current_offset, '\n',
+                                    pp->source_length - pp->current_offset);
+    if (!line_end) {
+        pp->current_column += (int)(pp->source_length - pp->current_offset);
+        pp->current_offset = pp->source_length;
+        return;
     }
+
+    pp->current_offset = (size_t)(line_end - pp->source) + 1;
+    pp->current_line++;
+    pp->current_column = 1;
 }
 
 static bool is_identifier_start(char c)
@@ -549,42 +716,61 @@ static bool process_directive(CnPreprocessor *pp)
     directive_length = pp->current_offset - start_offset;
     directive = pp->source + start_offset;
 
-    /* 处理不同的指令 (支持中英文) */
+    switch (classify_directive(directive, directive_length)) {
+        case CN_DIRECTIVE_DEFINE:
+            return process_define(pp);
+        case CN_DIRECTIVE_IFDEF:
+            return process_ifdef(pp, false);
+        case CN_DIRECTIVE_IFNDEF:
+            return process_ifdef(pp, true);
+        case CN_DIRECTIVE_ELSE:
+            return process_else(pp);
+        case CN_DIRECTIVE_ENDIF:
+            return process_endif(pp);
+        case CN_DIRECTIVE_UNDEF:
+            return process_undef(pp);
+        case CN_DIRECTIVE_UNKNOWN:
+        default:
+            report_error(pp, "未知的预处理指令");
+            skip_line(pp);
+            return false;
+    }
+}
+
+/* 识别指令名称 (支持中英文) */
+static CnDirectiveKind classify_directive(const char *name, size_t length)
+{
     /* #define / #定义 */
-    if ((directive_length == 6 && memcmp(directive, "define", 6) == 0) ||
-        (directive_length == 6 && memcmp(directive, "\xE5\xAE\x9A\xE4\xB9\x89", 6) == 0)) {  /* UTF-8: 定义 */
-        return process_define(pp);
+    if ((length == 6 && memcmp(name, "define", 6) == 0) ||
+        (length == 6 && memcmp(name, "\xE5\xAE\x9A\xE4\xB9\x89", 6) == 0)) {  /* UTF-8: 定义 */
+        return CN_DIRECTIVE_DEFINE;
     }
     /* #ifdef / #如果定义 */
-    else if ((directive_length == 5 && memcmp(directive, "ifdef", 5) == 0) ||
-             (directive_length == 12 && memcmp(directive, "\xE5\xA6\x82\xE6\x9E\x9C\xE5\xAE\x9A\xE4\xB9\x89", 12) == 0)) {  /* UTF-8: 如果定义 */
-        return process_ifdef(pp, false);
+    if ((length == 5 && memcmp(name, "ifdef", 5) == 0) ||
+        (length == 12 && memcmp(name, "\xE5\xA6\x82\xE6\x9E\x9C\xE5\xAE\x9A\xE4\xB9\x89", 12) == 0)) {  /* UTF-8: 如果定义 */
+        return CN_DIRECTIVE_IFDEF;
     }
     /* #ifndef / #如果未定义 */
-    else if ((directive_length == 6 && memcmp(directive, "ifndef", 6) == 0) ||
-             (directive_length == 15 && memcmp(directive, "\xE5\xA6\x82\xE6\x9E\x9C\xE6\x9C\xAA\xE5\xAE\x9A\xE4\xB9\x89", 15) == 0)) {  /* UTF-8: 如果未定义 */
-        return process_ifdef(pp, true);
+    if ((length == 6 && memcmp(name, "ifndef", 6) == 0) ||
+        (length == 15 && memcmp(name, "\xE5\xA6\x82\xE6\x9E\x9C\xE6\x9C\xAA\xE5\xAE\x9A\xE4\xB9\x89", 15) == 0)) {  /* UTF-8: 如果未定义 */
+        return CN_DIRECTIVE_IFNDEF;
     }
     /* #else / #否则 */
-    else if ((directive_length == 4 && memcmp(directive, "else", 4) == 0) ||
-             (directive_length == 6 && memcmp(directive, "\xE5\x90\xA6\xE5\x88\x99", 6) == 0)) {  /* UTF-8: 否则 */
-        return process_else(pp);
+    if ((length == 4 && memcmp(name, "else", 4) == 0) ||
+        (length == 6 && memcmp(name, "\xE5\x90\xA6\xE5\x88\x99", 6) == 0)) {  /* UTF-8: 否则 */
+        return CN_DIRECTIVE_ELSE;
     }
     /* #endif / #结束如果 */
-    else if ((directive_length == 5 && memcmp(directive, "endif", 5) == 0) ||
-             (directive_length == 12 && memcmp(directive, "\xE7\xBB\x93\xE6\x9D\x9F\xE5\xA6\x82\xE6\x9E\x9C", 12) == 0)) {  /* UTF-8: 结束如果 */
-        return process_endif(pp);
+    if ((length == 5 && memcmp(name, "endif", 5) == 0) ||
+        (length == 12 && memcmp(name, "\xE7\xBB\x93\xE6\x9D\x9F\xE5\xA6\x82\xE6\x9E\x9C", 12) == 0)) {  /* UTF-8: 结束如果 */
+        return CN_DIRECTIVE_ENDIF;
     }
     /* #undef / #未定义 */
-    else if ((directive_length == 5 && memcmp(directive, "undef", 5) == 0) ||
-             (directive_length == 9 && memcmp(directive, "\xE6\x9C\xAA\xE5\xAE\x9A\xE4\xB9\x89", 9) == 0)) {  /* UTF-8: 未定义 */
-        return process_undef(pp);
-    }
-    else {
-        report_error(pp, "未知的预处理指令");
-        skip_line(pp);
-        return false;
+    if ((length == 5 && memcmp(name, "undef", 5) == 0) ||
+        (length == 9 && memcmp(name, "\xE6\x9C\xAA\xE5\xAE\x9A\xE4\xB9\x89", 9) == 0)) {  /* UTF-8: 未定义 */
+        return CN_DIRECTIVE_UNDEF;
     }
+    return CN_DIRECTIVE_UNKNOWN;
 }
 
 static bool process_define(CnPreprocessor *pp)
@@ -625,6 +811,8 @@ static bool process_define(CnPreprocessor *pp)
         /* 解析参数列表 */
         macro.params = NULL;
         macro.param_count = 0;
+        macro.segments = NULL;
+        macro.segment_count = 0;
         macro.is_function_like = true;
         
         size_t param_capacity = 4;
@@ -718,6 +906,8 @@ static bool process_define(CnPreprocessor *pp)
     } else {
         macro.params = NULL;
         macro.param_count = 0;
+        macro.segments = NULL;
+        macro.segment_count = 0;
         macro.is_function_like = false;
     }
 
@@ -778,6 +968,12 @@ static bool process_define(CnPreprocessor *pp)
     macro.name_length = name_length;
     macro.defined_line = pp->current_line;
 
+    /* 函数宏在定义时预编译替换模板，展开时不再扫描替换文本 */
+    if (is_function_like && !build_macro_template(&macro)) {
+        free_macro(&macro);
+        return false;
+    }
+
     /* 跳过换行 */
     if (current_char(pp) == '\n') {
         advance(pp);
@@ -903,18 +1099,75 @@ static bool process_undef(CnPreprocessor *pp)
 
 /* ========== 宏管理 ========== */
 
+/* FNV-1a 哈希 */
+static uint32_t hash_macro_name(const char *name, size_t name_length)
+{
+    uint32_t hash = 2166136261u;
+    size_t i;
+
+    for (i = 0; i < name_length; ++i) {
+        hash ^= (unsigned char)name[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 static CnMacro* find_macro(const CnPreprocessor *pp, const char *name, size_t name_length)
 {
+    uint32_t hash;
+    size_t mask;
+    size_t index;
+
+    if (!pp || pp->macro_slot_count == 0) {
+        return NULL;
+    }
+
+    hash = hash_macro_name(name, name_length);
+    mask = pp->macro_slot_count - 1;
+    index = hash & mask;
+
+    while (pp->macro_slots[index] != 0) {
+        CnMacro *macro = &pp->macros[pp->macro_slots[index] - 1];
+        if (macro->name_hash == hash &&
+            macro->name_length == name_length &&
+            memcmp(macro->name, name, name_length) == 0) {
+            return macro;
+        }
+        index = (index + 1) & mask;
+    }
+
+    return NULL;
+}
+
+/* 以给定槽数重建宏名哈希表 */
+static bool rebuild_macro_slots(CnPreprocessor *pp, size_t slot_count)
+{
+    uint32_t *slots;
+    size_t mask;
     size_t i;
 
+    if (slot_count < CN_MACRO_INITIAL_SLOTS) {
+        slot_count = CN_MACRO_INITIAL_SLOTS;
+    }
+
+    slots = (uint32_t *)calloc(slot_count, sizeof(uint32_t));
+    if (!slots) {
+        return false;
+    }
+
+    mask = slot_count - 1;
     for (i = 0; i < pp->macro_count; ++i) {
-        if (pp->macros[i].name_length == name_length &&
-            memcmp(pp->macros[i].name, name, name_length) == 0) {
-            return &pp->macros[i];
+        size_t index = pp->macros[i].name_hash & mask;
+        while (slots[index] != 0) {
+            index = (index + 1) & mask;
         }
+        slots[index] = (uint32_t)(i + 1);
     }
 
-    return NULL;
+    free(pp->macro_slots);
+    pp->macro_slots = slots;
+    pp->macro_slot_count = slot_count;
+    return true;
 }
 
 static bool add_macro(CnPreprocessor *pp, CnMacro *macro)
@@ -922,11 +1175,14 @@ static bool add_macro(CnPreprocessor *pp, CnMacro *macro)
     CnMacro *existing;
     CnMacro *new_macros;
     size_t new_capacity;
+    size_t index;
+
+    macro->name_hash = hash_macro_name(macro->name, macro->name_length);
 
     /* 检查是否已存在同名宏 */
     existing = find_macro(pp, macro->name, macro->name_length);
     if (existing) {
-        /* 替换现有宏 */
+        /* 替换现有宏（名字相同，哈希槽位不变） */
         free_macro(existing);
         *existing = *macro;
         return true;
@@ -938,21 +1194,28 @@ static bool add_macro(CnPreprocessor *pp, CnMacro *macro)
         new_macros = (CnMacro *)realloc(pp->macros, new_capacity * sizeof(CnMacro));
         if (!new_macros) {
             /* 内存分配失败,释放宏的成员但不释放macro本身(因为它是栈变量) */
-            free(macro->name);
-            free(macro->replacement);
-            if (macro->params) {
-                for (size_t i = 0; i < macro->param_count; ++i) {
-                    free(macro->params[i]);
-                }
-                free(macro->params);
-            }
+            free_macro(macro);
             return false;
         }
         pp->macros = new_macros;
         pp->macro_capacity = new_capacity;
     }
 
+    /* 插入前保证哈希表负载因子不超过 1/2 */
+    if ((pp->macro_count + 1) * 2 > pp->macro_slot_count) {
+        if (!rebuild_macro_slots(pp, pp->macro_slot_count * 2)) {
+            free_macro(macro);
+            return false;
+        }
+    }
+
     pp->macros[pp->macro_count++] = *macro;
+
+    index = macro->name_hash & (pp->macro_slot_count - 1);
+    while (pp->macro_slots[index] != 0) {
+        index = (index + 1) & (pp->macro_slot_count - 1);
+    }
+    pp->macro_slots[index] = (uint32_t)pp->macro_count;
     return true;
 }
 
@@ -966,6 +1229,7 @@ static void free_macro(CnMacro *macro)
 
     free(macro->name);
     free(macro->replacement);
+    free(macro->segments);
     
     if (macro->params) {
         for (i = 0; i < macro->param_count; ++i) {
@@ -975,17 +1239,27 @@ static void free_macro(CnMacro *macro)
     }
 }
 
+/* 进程 CPU 时间（微秒），仅用于宏展开耗时统计 */
+static uint64_t expansion_clock_us(void)
+{
+    return (uint64_t)clock() * 1000000u / CLOCKS_PER_SEC;
+}
+
 static bool expand_macro(CnPreprocessor *pp, const char *name, size_t name_length)
 {
     CnMacro *macro = find_macro(pp, name, name_length);
-    char **args = NULL;
+    CnMacroArg *args = NULL;
     size_t arg_count = 0;
-    char *expanded = NULL;
+    uint64_t start_us = 0;
     
     if (!macro) {
         return false;
     }
 
+    if (pp->collect_stats) {
+        start_us = expansion_clock_us();
+    }
+
     /* 处理函数宏 */
     if (macro->is_function_like) {
         /* 检查后面是否有左括号 */
@@ -1003,48 +1277,34 @@ static bool expand_macro(CnPreprocessor *pp, const char *name, size_t name_lengt
         /* 检查参数数量 */
         if (arg_count != macro->param_count) {
             report_error(pp, "宏调用的参数数量不匹配");
-            /* 释放参数 */
-            for (size_t i = 0; i < arg_count; ++i) {
-                free(args[i]);
-            }
             free(args);
             return false;
         }
         
-        /* 执行参数替换 */
-        expanded = substitute_macro_params(macro, args, arg_count);
-        
-        /* 释放参数 */
-        for (size_t i = 0; i < arg_count; ++i) {
-            free(args[i]);
-        }
+        /* 按预编译模板拼接输出 */
+        splice_macro_template(pp, macro, args);
         free(args);
-        
-        if (expanded) {
-            append_output(pp, expanded, strlen(expanded));
-            free(expanded);
-            return true;
-        }
-        return false;
-    }
-
-    /* 展开对象宏 */
-    if (macro->replacement) {
+    } else if (macro->replacement) {
+        /* 展开对象宏 */
         append_output(pp, macro->replacement, macro->replacement_length);
     }
 
+    pp->macro_expansion_count++;
+    if (pp->collect_stats) {
+        pp->macro_expansion_time_us += expansion_clock_us() - start_us;
+    }
     return true;
 }
 
-/* 解析函数宏的实参列表 */
-static bool parse_function_macro_args(CnPreprocessor *pp, char ***out_args, size_t *out_count)
+/* 解析函数宏的实参列表，实参引用源码片段（已去除首尾空白） */
+static bool parse_function_macro_args(CnPreprocessor *pp, CnMacroArg **out_args, size_t *out_count)
 {
-    char **args = NULL;
+    CnMacroArg *args = NULL;
     size_t arg_count = 0;
     size_t arg_capacity = 4;
     int paren_depth = 0;
     
-    args = (char **)malloc(arg_capacity * sizeof(char *));
+    args = (CnMacroArg *)malloc(arg_capacity * sizeof(CnMacroArg));
     if (!args) {
         return false;
     }
@@ -1104,28 +1364,16 @@ static bool parse_function_macro_args(CnPreprocessor *pp, char ***out_args, size
         /* 扩展参数数组 */
         if (arg_count >= arg_capacity) {
             arg_capacity *= 2;
-            char **new_args = (char **)realloc(args, arg_capacity * sizeof(char *));
+            CnMacroArg *new_args = (CnMacroArg *)realloc(args, arg_capacity * sizeof(CnMacroArg));
             if (!new_args) {
-                for (size_t i = 0; i < arg_count; ++i) {
-                    free(args[i]);
-                }
                 free(args);
                 return false;
             }
             args = new_args;
         }
         
-        /* 复制参数 */
-        args[arg_count] = (char *)malloc(arg_length + 1);
-        if (!args[arg_count]) {
-            for (size_t i = 0; i < arg_count; ++i) {
-                free(args[i]);
-            }
-            free(args);
-            return false;
-        }
-        memcpy(args[arg_count], pp->source + arg_start, arg_length);
-        args[arg_count][arg_length] = '\0';
+        args[arg_count].text = pp->source + arg_start;
+        args[arg_count].length = arg_length;
         arg_count++;
         
         if (current_char(pp) == ',') {
@@ -1136,9 +1384,6 @@ static bool parse_function_macro_args(CnPreprocessor *pp, char ***out_args, size
             break;
         } else {
             /* 格式错误 */
-            for (size_t i = 0; i < arg_count; ++i) {
-                free(args[i]);
-            }
             free(args);
             return false;
         }
@@ -1149,151 +1394,296 @@ static bool parse_function_macro_args(CnPreprocessor *pp, char ***out_args, size
     return true;
 }
 
-/* 在宏替换文本中替换形参为实参,支持 # 字符串化 */
-static char* substitute_macro_params(const CnMacro *macro, char **args, size_t arg_count)
+/* 查找形参序号，不是形参返回 -1 */
+static int find_macro_param(const CnMacro *macro, const char *name, size_t name_length)
 {
-    size_t output_capacity = 256;
-    size_t output_length = 0;
-    char *output = (char *)malloc(output_capacity);
-    size_t i;
-    
-    if (!output) {
-        return NULL;
+    for (size_t j = 0; j < macro->param_count; ++j) {
+        if (strlen(macro->params[j]) == name_length &&
+            memcmp(macro->params[j], name, name_length) == 0) {
+            return (int)j;
+        }
     }
-    
-    if (!macro->replacement) {
-        output[0] = '\0';
-        return output;
+    return -1;
+}
+
+/* 追加模板片段，相邻文本片段合并 */
+static bool push_macro_segment(CnMacro *macro, size_t *capacity, CnMacroSegmentKind kind,
+                               size_t offset, size_t length, size_t param_index)
+{
+    if (kind == CN_MACRO_SEGMENT_TEXT && macro->segment_count > 0) {
+        CnMacroSegment *last = &macro->segments[macro->segment_count - 1];
+        if (last->kind == CN_MACRO_SEGMENT_TEXT && last->offset + last->length == offset) {
+            last->length += length;
+            return true;
+        }
     }
-    
-    /* 扫描替换文本 */
-    i = 0;
-    while (i < macro->replacement_length) {
-        char c = macro->replacement[i];
-        
+
+    if (macro->segment_count >= *capacity) {
+        size_t new_capacity = *capacity == 0 ? 8 : *capacity * 2;
+        CnMacroSegment *new_segments = (CnMacroSegment *)realloc(
+            macro->segments, new_capacity * sizeof(CnMacroSegment));
+        if (!new_segments) {
+            return false;
+        }
+        macro->segments = new_segments;
+        *capacity = new_capacity;
+    }
+
+    macro->segments[macro->segment_count].kind = kind;
+    macro->segments[macro->segment_count].offset = offset;
+    macro->segments[macro->segment_count].length = length;
+    macro->segments[macro->segment_count].param_index = param_index;
+    macro->segment_count++;
+    return true;
+}
+
+/*
+ * 将函数宏的替换文本预编译为模板：形参替换为槽位，支持 # 字符串化。
+ * 切分规则与逐字符替换一致：# 后跟非形参标识符时整体丢弃，
+ * # 后不是标识符时输出 # 并跳过其后的一个字符。
+ */
+static bool build_macro_template(CnMacro *macro)
+{
+    const char *text = macro->replacement;
+    size_t length = macro->replacement_length;
+    size_t capacity = 0;
+    size_t i = 0;
+
+    macro->segments = NULL;
+    macro->segment_count = 0;
+
+    while (i < length) {
+        char c = text[i];
+        size_t char_offset = i;
+
         /* 检查字符串化操作符 # */
-        if (c == '#' && i + 1 < macro->replacement_length) {
+        if (c == '#' && i + 1 < length) {
             i++;  /* 跳过 # */
             
             /* 跳过空白 */
-            while (i < macro->replacement_length && 
-                   (macro->replacement[i] == ' ' || macro->replacement[i] == '\t')) {
+            while (i < length && (text[i] == ' ' || text[i] == '\t')) {
                 i++;
             }
             
             /* 读取参数名 */
-            if (i < macro->replacement_length && is_identifier_start(macro->replacement[i])) {
+            if (i < length && is_identifier_start(text[i])) {
                 size_t param_start = i;
-                while (i < macro->replacement_length && 
-                       is_identifier_continue(macro->replacement[i])) {
+                while (i < length && is_identifier_continue(text[i])) {
                     i++;
                 }
-                size_t param_length = i - param_start;
-                
-                /* 查找对应的形参 */
-                int param_index = -1;
-                for (size_t j = 0; j < macro->param_count; ++j) {
-                    if (strlen(macro->params[j]) == param_length &&
-                        memcmp(macro->params[j], macro->replacement + param_start, param_length) == 0) {
-                        param_index = (int)j;
-                        break;
-                    }
-                }
-                
-                if (param_index >= 0 && (size_t)param_index < arg_count) {
-                    /* 将实参字符串化 */
-                    size_t arg_len = strlen(args[param_index]);
-                    size_t needed = output_length + arg_len + 3;  /* 包括两个引号 */
-                    
-                    if (needed >= output_capacity) {
-                        output_capacity = needed * 2;
-                        char *new_output = (char *)realloc(output, output_capacity);
-                        if (!new_output) {
-                            free(output);
-                            return NULL;
-                        }
-                        output = new_output;
-                    }
-                    
-                    output[output_length++] = '"';
-                    memcpy(output + output_length, args[param_index], arg_len);
-                    output_length += arg_len;
-                    output[output_length++] = '"';
+                int param_index = find_macro_param(macro, text + param_start, i - param_start);
+                if (param_index >= 0 &&
+                    !push_macro_segment(macro, &capacity, CN_MACRO_SEGMENT_STRINGIFY,
+                                        0, 0, (size_t)param_index)) {
+                    return false;
                 }
                 continue;
             }
+
+            /* 不是字符串化：输出 # 本身，并跳过当前位置的字符 */
+            if (!push_macro_segment(macro, &capacity, CN_MACRO_SEGMENT_TEXT, char_offset, 1, 0)) {
+                return false;
+            }
+            i++;
+            continue;
         }
         
         /* 检查是否是参数名 */
         if (is_identifier_start(c)) {
             size_t param_start = i;
-            while (i < macro->replacement_length && 
-                   is_identifier_continue(macro->replacement[i])) {
+            while (i < length && is_identifier_continue(text[i])) {
                 i++;
             }
-            size_t param_length = i - param_start;
-            
-            /* 查找对应的形参 */
-            int param_index = -1;
-            for (size_t j = 0; j < macro->param_count; ++j) {
-                if (strlen(macro->params[j]) == param_length &&
-                    memcmp(macro->params[j], macro->replacement + param_start, param_length) == 0) {
-                    param_index = (int)j;
-                    break;
-                }
-            }
-            
-            if (param_index >= 0 && (size_t)param_index < arg_count) {
-                /* 替换为实参 */
-                size_t arg_len = strlen(args[param_index]);
-                size_t needed = output_length + arg_len + 1;
-                
-                if (needed >= output_capacity) {
-                    output_capacity = needed * 2;
-                    char *new_output = (char *)realloc(output, output_capacity);
-                    if (!new_output) {
-                        free(output);
-                        return NULL;
-                    }
-                    output = new_output;
-                }
-                
-                memcpy(output + output_length, args[param_index], arg_len);
-                output_length += arg_len;
-            } else {
-                /* 不是形参,保留原文本 */
-                size_t needed = output_length + param_length + 1;
-                if (needed >= output_capacity) {
-                    output_capacity = needed * 2;
-                    char *new_output = (char *)realloc(output, output_capacity);
-                    if (!new_output) {
-                        free(output);
-                        return NULL;
-                    }
-                    output = new_output;
+            int param_index = find_macro_param(macro, text + param_start, i - param_start);
+            if (param_index >= 0) {
+                if (!push_macro_segment(macro, &capacity, CN_MACRO_SEGMENT_PARAM,
+                                        0, 0, (size_t)param_index)) {
+                    return false;
                 }
-                memcpy(output + output_length, macro->replacement + param_start, param_length);
-                output_length += param_length;
+            } else if (!push_macro_segment(macro, &capacity, CN_MACRO_SEGMENT_TEXT,
+                                           param_start, i - param_start, 0)) {
+                return false;
             }
             continue;
         }
         
         /* 普通字符 */
-        if (output_length + 1 >= output_capacity) {
-            output_capacity *= 2;
-            char *new_output = (char *)realloc(output, output_capacity);
-            if (!new_output) {
-                free(output);
-                return NULL;
-            }
-            output = new_output;
+        if (!push_macro_segment(macro, &capacity, CN_MACRO_SEGMENT_TEXT, i, 1, 0)) {
+            return false;
         }
-        output[output_length++] = c;
         i++;
     }
-    
-    output[output_length] = '\0';
-    return output;
+
+    return true;
+}
+
+/* 按模板把函数宏展开结果直接写入输出 */
+static void splice_macro_template(CnPreprocessor *pp, const CnMacro *macro, const CnMacroArg *args)
+{
+    for (size_t i = 0; i < macro->segment_count; ++i) {
+        const CnMacroSegment *segment = &macro->segments[i];
+        const CnMacroArg *arg;
+
+        switch (segment->kind) {
+            case CN_MACRO_SEGMENT_TEXT:
+                append_output(pp, macro->replacement + segment->offset, segment->length);
+                break;
+            case CN_MACRO_SEGMENT_PARAM:
+                arg = &args[segment->param_index];
+                append_output(pp, arg->text, arg->length);
+                break;
+            case CN_MACRO_SEGMENT_STRINGIFY:
+                arg = &args[segment->param_index];
+                append_char(pp, '"');
+                append_output(pp, arg->text, arg->length);
+                append_char(pp, '"');
+                break;
+        }
+    }
+}
+
+/* 源码中出现 '#' 或块注释时才需要逐字符处理：块注释被替换后列号会变化，未闭合时也不报错 */
+static bool needs_preprocessing(const CnPreprocessor *pp)
+{
+    const char *p = pp->source;
+    const char *end = pp->source + pp->source_length;
+
+    if (memchr(p, '#', pp->source_length) != NULL) {
+        return true;
+    }
+
+    while (p < end && (p = (const char *)memchr(p, '*', (size_t)(end - p))) != NULL) {
+        if (p > pp->source && p[-1] == '/') {
+            return true;
+        }
+        p++;
+    }
+    return false;
+}
+
+/* ========== 逐词元模式辅助函数 ========== */
+
+/* 跳过空白、换行与已闭合的注释；未闭合的块注释留给词法分析器报告 */
+static void skip_layout(CnPreprocessor *pp)
+{
+    for (;;) {
+        char c = current_char(pp);
+
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            advance(pp);
+            continue;
+        }
+
+        if (c == '/' && peek_char(pp, 1) == '/') {
+            while (current_char(pp) != '\n' && current_char(pp) != '\0') {
+                advance(pp);
+            }
+            continue;
+        }
+
+        if (c == '/' && peek_char(pp, 1) == '*') {
+            size_t end = pp->current_offset + 2;
+            while (end + 1 < pp->source_length &&
+                   !(pp->source[end] == '*' && pp->source[end + 1] == '/')) {
+                end++;
+            }
+            if (end + 1 >= pp->source_length) {
+                return;
+            }
+            while (pp->current_offset < end + 2) {
+                advance(pp);
+            }
+            continue;
+        }
+
+        return;
+    }
+}
+
+/* 当前位置之前（同一行内）是否只有空白 */
+static bool at_line_start(const CnPreprocessor *pp)
+{
+    size_t offset = pp->current_offset;
+
+    while (offset > 0) {
+        char prev = pp->source[offset - 1];
+        if (prev == '\n') {
+            return true;
+        }
+        if (prev != ' ' && prev != '\t' && prev != '\r') {
+            return false;
+        }
+        offset--;
+    }
+    return true;
+}
+
+/* 用词法分析器从当前位置切出一个源码词元，行列号与扫描位置双向同步 */
+static void lex_source_token(CnPreprocessor *pp, CnToken *out_token)
+{
+    CnLexer *lexer = &pp->token_lexer;
+
+    lexer->offset = pp->current_offset;
+    lexer->line = pp->current_line;
+    lexer->column = pp->current_column;
+
+    if (!cn_frontend_lexer_next_token(lexer, out_token)) {
+        make_eof_token(pp, out_token);
+        return;
+    }
+
+    pp->current_offset = lexer->offset;
+    pp->current_line = lexer->line;
+    pp->current_column = lexer->column;
+}
+
+/*
+ * 展开 name_token 对应的宏，并准备逐个取出展开词元
+ * 展开文本先写入 output（此模式下仅作暂存），再复制到 expansion_arena，
+ * 使词素在后续 #undef 或再次展开后依然有效
+ * @return true 如果 name_token 是宏且已展开（展开结果可能为空），false 表示按普通词元输出
+ */
+static bool begin_expansion(CnPreprocessor *pp, const CnToken *name_token)
+{
+    char *text;
+
+    pp->output_length = 0;
+    if (!expand_macro(pp, name_token->lexeme_begin, name_token->lexeme_length)) {
+        return false;
+    }
+    if (pp->output_length == 0) {
+        return true;
+    }
+
+    if (!pp->expansion_arena) {
+        pp->expansion_arena = cn_arena_new(CN_EXPANSION_ARENA_BLOCK);
+    }
+    text = pp->expansion_arena ? (char *)cn_arena_alloc(pp->expansion_arena, pp->output_length + 1) : NULL;
+    if (!text) {
+        pp->stream_failed = true;
+        return true;
+    }
+    memcpy(text, pp->output, pp->output_length);
+    text[pp->output_length] = '\0';
+
+    cn_frontend_lexer_init(&pp->expansion_lexer, text, pp->output_length, pp->filename);
+    cn_frontend_lexer_set_diagnostics(&pp->expansion_lexer, pp->diagnostics);
+    pp->expansion_line = name_token->line;
+    pp->expansion_column = name_token->column;
+    pp->in_expansion = true;
+    return true;
+}
+
+static void make_eof_token(const CnPreprocessor *pp, CnToken *out_token)
+{
+    size_t offset = pp->current_offset < pp->source_length ? pp->current_offset : pp->source_length;
+
+    out_token->kind = CN_TOKEN_EOF;
+    out_token->lexeme_begin = pp->source ? pp->source + offset : NULL;
+    out_token->lexeme_length = 0;
+    out_token->line = pp->current_line;
+    out_token->column = pp->current_column;
+    out_token->number_suffix = 0;
 }
 
 /* ========== 条件编译栈管理 ========== */
@@ -1309,6 +1699,111 @@ static bool is_condition_active(const CnPreprocessor *pp)
     return pp->condition_stack[pp->condition_depth - 1].active;
 }
 
+/*
+ * 快速跳过不活跃的条件编译区域
+ * 用 memchr 逐行跳转，只检查行首（可有缩进）是否为 '#' 指令：
+ * 区域内嵌套的 #ifdef/#ifndef 只计深度、不入条件栈，其中的其他指令一律忽略；
+ * 遇到同层指令 (#else、#endif 等) 时停在该指令的 '#' 处，交回主循环处理。
+ * 行首的块注释整体跳过，注释中的 '#' 不视为指令（与逐字符扫描一致）。
+ */
+static void skip_inactive_region(CnPreprocessor *pp)
+{
+    const char *source = pp->source;
+    const char *end = source + pp->source_length;
+    const char *p = source + pp->current_offset;
+    const char *start = p;
+    const char *line_begin = NULL;
+    int line = pp->current_line;
+    size_t depth = 0;
+    /* 当前位置之前只有空白时（如缩进的指令行），当前行也要检查 */
+    bool check_current_line = at_line_start(pp);
+
+    for (;;) {
+        const char *hash;
+        const char *name;
+
+        if (!check_current_line) {
+            const char *newline = (const char *)memchr(p, '\n', (size_t)(end - p));
+            if (!newline) {
+                p = end;
+                break;
+            }
+            line++;
+            p = newline + 1;
+            line_begin = p;
+        }
+        check_current_line = false;
+
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+            p++;
+        }
+        if (p >= end) {
+            break;
+        }
+
+        if (p[0] == '/' && p + 1 < end && p[1] == '*') {
+            p += 2;
+            while (p + 1 < end && !(p[0] == '*' && p[1] == '/')) {
+                if (*p == '\n') {
+                    line++;
+                    line_begin = p + 1;
+                }
+                p++;
+            }
+            if (p + 1 >= end) {
+                p = end;
+                break;
+            }
+            p += 2;
+            continue;
+        }
+
+        if (*p != '#') {
+            continue;
+        }
+
+        /* 读取指令名称 */
+        hash = p++;
+        while (p < end && (*p == ' ' || *p == '\t')) {
+            p++;
+        }
+        name = p;
+        while (p < end && is_identifier_continue(*p)) {
+            p++;
+        }
+
+        switch (classify_directive(name, (size_t)(p - name))) {
+            case CN_DIRECTIVE_IFDEF:
+            case CN_DIRECTIVE_IFNDEF:
+                depth++;
+                continue;
+            case CN_DIRECTIVE_ENDIF:
+                if (depth > 0) {
+                    depth--;
+                    continue;
+                }
+                break;
+            default:
+                if (depth > 0) {
+                    continue;
+                }
+                break;
+        }
+
+        /* 同层指令：停在 '#' 处交给主循环 */
+        p = hash;
+        break;
+    }
+
+    if (line_begin) {
+        pp->current_column = (int)(p - line_begin) + 1;
+    } else {
+        pp->current_column += (int)(p - start);
+    }
+    pp->current_line = line;
+    pp->current_offset = (size_t)(p - source);
+}
+
 static bool push_condition(CnPreprocessor *pp, bool active)
 {
     CnConditionFrame *new_stack;
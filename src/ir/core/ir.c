@@ -11,6 +11,9 @@ CnIrModule *cn_ir_module_new() {
         module->last_func = NULL;
         module->first_global = NULL;
         module->last_global = NULL;
+        module->first_const_array = NULL;
+        module->last_const_array = NULL;
+        module->const_array_count = 0;
         /* 默认将目标三元组置零，具体值由前端/CLI 在生成 IR 前设置 */
         memset(&module->target, 0, sizeof(module->target));
         /* 默认编译模式为宿主环境，freestanding 由前端/CLI 显式开启 */
@@ -39,6 +42,14 @@ void cn_ir_module_free(CnIrModule *module) {
         global = next;
     }
     
+    // 释放常量数组
+    CnIrConstArray *array = module->first_const_array;
+    while (array) {
+        CnIrConstArray *next = array->next;
+        cn_ir_const_array_free(array);
+        array = next;
+    }
+    
     // 释放函数
     CnIrFunction *func = module->first_func;
     while (func) {
@@ -193,6 +204,60 @@ CnIrInst *cn_ir_inst_new(CnIrInstKind kind, CnIrOperand dest, CnIrOperand src1,
     return inst;
 }
 
+CnIrConstArray *cn_ir_const_array_new(CnType *element_type, size_t element_count, size_t field_count) {
+    size_t value_count = element_count * (field_count ? field_count : 1);
+    CnIrConstArray *array = (CnIrConstArray *)calloc(1, sizeof(CnIrConstArray));
+    if (!array) return NULL;
+    array->element_type = element_type;
+    array->element_count = element_count;
+    array->field_count = field_count;
+    array->values = (CnIrConstValue *)calloc(value_count ? value_count : 1, sizeof(CnIrConstValue));
+    if (!array->values) {
+        free(array);
+        return NULL;
+    }
+    return array;
+}
+
+CnIrConstArray *cn_ir_const_array_new_bytes(CnType *element_type, const unsigned char *bytes, size_t size) {
+    CnIrConstArray *array = (CnIrConstArray *)calloc(1, sizeof(CnIrConstArray));
+    if (!array) return NULL;
+    array->element_type = element_type;
+    array->element_count = size;
+    array->bytes = bytes;
+    return array;
+}
+
+void cn_ir_const_array_free(CnIrConstArray *array) {
+    if (!array) return;
+    size_t value_count = array->values ? array->element_count * (array->field_count ? array->field_count : 1) : 0;
+    for (size_t i = 0; i < value_count; i++) {
+        if (array->values[i].kind == CN_IR_CONST_STR) {
+            free((void *)array->values[i].as.s);
+        }
+    }
+    if (array->field_names) {
+        for (size_t i = 0; i < array->field_count; i++) {
+            free(array->field_names[i]);
+        }
+        free(array->field_names);
+    }
+    free(array->values);
+    free(array);
+}
+
+void cn_ir_module_add_const_array(CnIrModule *module, CnIrConstArray *array) {
+    if (!module || !array) return;
+    array->id = module->const_array_count++;
+    array->next = NULL;
+    if (!module->first_const_array) {
+        module->first_const_array = array;
+    } else {
+        module->last_const_array->next = array;
+    }
+    module->last_const_array = array;
+}
+
 CnIrOperand cn_ir_op_none() {
     CnIrOperand op;
     op.kind = CN_IR_OP_NONE;
@@ -256,6 +321,14 @@ CnIrOperand cn_ir_op_ast_expr(CnAstExpr *expr, CnType *type) {
     return op;
 }
 
+CnIrOperand cn_ir_op_const_array(CnIrConstArray *array, CnType *type) {
+    CnIrOperand op;
+    op.kind = CN_IR_OP_CONST_ARRAY;
+    op.as.const_array = array;
+    op.type = type;
+    return op;
+}
+
 static const char *inst_names[] = {
     // 算术与逻辑指令 (0-11)
     "add", "sub", "mul", "div", "mod", "and", "or", "xor", "shl", "shr", "neg", "not",
@@ -288,6 +361,9 @@ void cn_ir_dump_operand_to_file(CnIrOperand op, FILE *file) {
             }
             break;
         case CN_IR_OP_LABEL: fprintf(file, "%s", op.as.label->name ? op.as.label->name : "unnamed"); break;
+        case CN_IR_OP_CONST_ARRAY:
+            fprintf(file, "const#%d[%zu]", op.as.const_array->id, op.as.const_array->element_count);
+            break;
         default: fprintf(file, "unknown"); break;
     }
 }
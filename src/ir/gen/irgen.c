@@ -1,5 +1,6 @@
 #include "cnlang/ir/irgen.h"
 #include "cnlang/frontend/semantics.h"
+#include "cnlang/frontend/parser.h"
 #include "cnlang/frontend/ast/class_node.h"  // 类AST节点定义
 #include "cnlang/semantics/vtable_builder.h" // 虚函数表支持
 #include <stdlib.h>
@@ -229,6 +230,8 @@ CnIrGenContext *cn_ir_gen_context_new() {
     ctx->current_scope = NULL;
     ctx->current_static_vars = NULL;  // 初始化静态变量列表
     ctx->local_var_map = NULL;        // 初始化局部变量映射表
+    ctx->diagnostics = NULL;
+    ctx->has_error = false;
     return ctx;
 }
 
@@ -271,6 +274,360 @@ static char *copy_name(const char *name, size_t length) {
     return buf;
 }
 
+// 常量字面量（含数值字面量取负）转为常量数组中的一个值，失败返回 0
+static int const_value_from_literal(const CnAstExpr *expr, CnIrConstValue *value) {
+    int negate = 0;
+    if (expr && expr->kind == CN_AST_EXPR_UNARY && expr->as.unary.op == CN_AST_UNARY_OP_MINUS) {
+        negate = 1;
+        expr = expr->as.unary.operand;
+    }
+    if (!expr) return 0;
+    switch (expr->kind) {
+        case CN_AST_EXPR_INTEGER_LITERAL:
+            value->kind = CN_IR_CONST_INT;
+            value->as.i = negate ? -(long long)expr->as.integer_literal.value
+                                 : (long long)expr->as.integer_literal.value;
+            return 1;
+        case CN_AST_EXPR_FLOAT_LITERAL:
+            value->kind = CN_IR_CONST_FLOAT;
+            value->as.f = negate ? -expr->as.float_literal.value : expr->as.float_literal.value;
+            return 1;
+        case CN_AST_EXPR_CHAR_LITERAL:
+            value->kind = CN_IR_CONST_INT;
+            value->as.i = expr->as.char_literal.value;
+            return !negate;
+        case CN_AST_EXPR_BOOL_LITERAL:
+            value->kind = CN_IR_CONST_INT;
+            value->as.i = expr->as.bool_literal.value ? 1 : 0;
+            return !negate;
+        case CN_AST_EXPR_STRING_LITERAL:
+            if (negate) return 0;
+            value->as.s = strdup(expr->as.string_literal.value ? expr->as.string_literal.value : "");
+            if (!value->as.s) return 0;
+            value->kind = CN_IR_CONST_STR;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// 结构体字面量 b 与 a 的字段布局相同（字段数相同，且按相同顺序指定相同字段名或都按位置初始化）
+static int struct_literal_same_layout(const CnAstExpr *a, const CnAstExpr *b) {
+    if (b->kind != CN_AST_EXPR_STRUCT_LITERAL ||
+        b->as.struct_lit.field_count != a->as.struct_lit.field_count) {
+        return 0;
+    }
+    for (size_t i = 0; i < a->as.struct_lit.field_count; i++) {
+        const CnAstStructFieldInit *fa = &a->as.struct_lit.fields[i];
+        const CnAstStructFieldInit *fb = &b->as.struct_lit.fields[i];
+        if ((fa->field_name == NULL) != (fb->field_name == NULL)) return 0;
+        if (fa->field_name && (fa->field_name_length != fb->field_name_length ||
+                               memcmp(fa->field_name, fb->field_name, fa->field_name_length) != 0)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// 把全常量的一维数组初始化列表打包为模块常量数组，所有值存放在一块连续内存中；
+// 嵌入资源直接引用已读入的文件字节，不逐字节展开。
+// 多维数组、元素多于声明长度、结构体元素字段布局不一致等情况返回 NULL，由调用方按原方式处理
+static CnIrConstArray *pack_const_array(CnIrGenContext *ctx, CnAstExpr *init, CnType *array_type) {
+    if (init && init->kind == CN_AST_EXPR_EMBED) {
+        if (!ctx->module || !array_type || array_type->kind != CN_TYPE_ARRAY || !init->as.embed.data ||
+            init->as.embed.size > array_type->as.array.length) {
+            return NULL;
+        }
+        CnIrConstArray *bytes = cn_ir_const_array_new_bytes(array_type->as.array.element_type,
+                                                            init->as.embed.data, init->as.embed.size);
+        if (bytes) {
+            cn_ir_module_add_const_array(ctx->module, bytes);
+        }
+        return bytes;
+    }
+    if (!ctx->module || !array_type || array_type->kind != CN_TYPE_ARRAY ||
+        !cn_frontend_ast_array_literal_is_constant(init)) {
+        return NULL;
+    }
+    CnType *elem_type = array_type->as.array.element_type;
+    CnAstExpr **elements = init->as.array_literal.elements;
+    size_t count = init->as.array_literal.element_count;
+    if (!elem_type || elem_type->kind == CN_TYPE_ARRAY ||
+        array_type->as.array.length == 0 || count > array_type->as.array.length) {
+        return NULL;
+    }
+
+    // 结构体元素：以首元素的字段布局为准，每个元素占一行 field_count 个值
+    const CnAstExpr *first = elements[0];
+    size_t field_count = 0;
+    if (first->kind == CN_AST_EXPR_STRUCT_LITERAL) {
+        field_count = first->as.struct_lit.field_count;
+        if (elem_type->kind != CN_TYPE_STRUCT || field_count == 0) {
+            return NULL;
+        }
+    } else if (elem_type->kind == CN_TYPE_STRUCT) {
+        return NULL;
+    }
+
+    CnIrConstArray *array = cn_ir_const_array_new(elem_type, count, field_count);
+    if (!array) return NULL;
+
+    CnIrConstValue *value = array->values;
+    for (size_t i = 0; i < count; i++) {
+        const CnAstExpr *element = elements[i];
+        if (field_count == 0) {
+            if (element->kind == CN_AST_EXPR_STRUCT_LITERAL || !const_value_from_literal(element, value++)) {
+                cn_ir_const_array_free(array);
+                return NULL;
+            }
+            continue;
+        }
+        if (!struct_literal_same_layout(first, element)) {
+            cn_ir_const_array_free(array);
+            return NULL;
+        }
+        for (size_t f = 0; f < field_count; f++) {
+            if (!const_value_from_literal(element->as.struct_lit.fields[f].value, value++)) {
+                cn_ir_const_array_free(array);
+                return NULL;
+            }
+        }
+    }
+
+    if (field_count > 0 && first->as.struct_lit.fields[0].field_name) {
+        array->field_names = (char **)calloc(field_count, sizeof(char *));
+        if (!array->field_names) {
+            cn_ir_const_array_free(array);
+            return NULL;
+        }
+        for (size_t f = 0; f < field_count; f++) {
+            array->field_names[f] = copy_name(first->as.struct_lit.fields[f].field_name,
+                                              first->as.struct_lit.fields[f].field_name_length);
+        }
+    }
+
+    cn_ir_module_add_const_array(ctx->module, array);
+    return array;
+}
+
+// 二元运算：左操作数已生成为 left，再生成右操作数与运算指令
+static CnIrOperand gen_binary_with_left(CnIrGenContext *ctx, CnAstExpr *expr, CnIrOperand left) {
+    // Round5-Fix5: 增强字符串拼接检测条件
+    // 原始条件：仅检查 expr->type == STRING，但语义分析器可能将字符串拼接
+    // 表达式类型设为INT/POINTER/UNKNOWN，导致检测失败
+    // 新增条件：任一操作数为STRING/POINTER(字符串指针)或字符串字面量时也触发
+    bool is_str_concat = false;
+    if (expr->as.binary.op == CN_AST_BINARY_OP_ADD) {
+        // 条件1：表达式类型为STRING（原始条件）
+        if (expr->type && expr->type->kind == CN_TYPE_STRING) {
+            is_str_concat = true;
+        }
+        // 条件2：左操作数为STRING类型
+        else if (expr->as.binary.left && expr->as.binary.left->type &&
+                 expr->as.binary.left->type->kind == CN_TYPE_STRING) {
+            is_str_concat = true;
+        }
+        // 条件3：右操作数为字符串字面量，且左操作数为指针类型（可能是char*）
+        else if (expr->as.binary.right &&
+                 expr->as.binary.right->kind == CN_AST_EXPR_STRING_LITERAL) {
+            if (expr->as.binary.left && expr->as.binary.left->type &&
+                (expr->as.binary.left->type->kind == CN_TYPE_STRING ||
+                 expr->as.binary.left->type->kind == CN_TYPE_POINTER)) {
+                is_str_concat = true;
+            }
+            // 左操作数类型为INT/UNKNOWN但右操作数是字符串字面量，也可能是字符串拼接
+            else if (expr->as.binary.left && expr->as.binary.left->type &&
+                     (expr->as.binary.left->type->kind == CN_TYPE_INT ||
+                      expr->as.binary.left->type->kind == CN_TYPE_UNKNOWN)) {
+                is_str_concat = true;
+            }
+        }
+        // 条件4：左操作数为字符串字面量
+        else if (expr->as.binary.left &&
+                 expr->as.binary.left->kind == CN_AST_EXPR_STRING_LITERAL) {
+            is_str_concat = true;
+        }
+        // 条件5：两个操作数都是POINTER类型（char* + char*）
+        else if (expr->as.binary.left && expr->as.binary.left->type &&
+                 expr->as.binary.right && expr->as.binary.right->type &&
+                 expr->as.binary.left->type->kind == CN_TYPE_POINTER &&
+                 expr->as.binary.right->type->kind == CN_TYPE_POINTER) {
+            is_str_concat = true;
+        }
+        // 【P1修复-F1】条件6：右操作数为字符串字面量，且左操作数不是整数/浮点类型
+        // 典型错误：r17 = r16 + "*"，r16是char*但类型被标记为INT/UNKNOWN
+        // 当右操作数是字符串字面量时，如果左操作数不是数值类型，应视为字符串拼接
+        else if (expr->as.binary.right &&
+                 expr->as.binary.right->kind == CN_AST_EXPR_STRING_LITERAL &&
+                 expr->as.binary.left) {
+            CnType *left_t = expr->as.binary.left->type;
+            /* 左操作数类型为NULL/INT/UNKNOWN/POINTER/STRING时，可能是字符串拼接 */
+            if (!left_t || left_t->kind == CN_TYPE_INT ||
+                left_t->kind == CN_TYPE_UNKNOWN || left_t->kind == CN_TYPE_VOID ||
+                left_t->kind == CN_TYPE_POINTER || left_t->kind == CN_TYPE_STRING) {
+                is_str_concat = true;
+            }
+        }
+    }
+    
+    if (is_str_concat) {
+        
+        CnIrOperand right = cn_ir_gen_expr(ctx, expr->as.binary.right);
+        
+        // 将非字符串类型转换为字符串
+        CnType *left_type = expr->as.binary.left->type;
+        CnType *right_type = expr->as.binary.right->type;
+        
+        // 转换左操作数
+        if (left_type && left_type->kind != CN_TYPE_STRING) {
+            const char *convert_func = NULL;
+            if (is_integer_type(left_type)) {
+                convert_func = "cn_rt_int_to_string";
+            } else if (left_type->kind == CN_TYPE_BOOL) {
+                convert_func = "cn_rt_bool_to_string";
+            } else if (is_float_type(left_type)) {
+                convert_func = "cn_rt_float_to_string";
+            }
+            
+            if (convert_func) {
+                CnIrInst *conv_inst = cn_ir_inst_new(CN_IR_INST_CALL, cn_ir_op_none(),
+                                                      cn_ir_op_symbol(convert_func, NULL),
+                                                      cn_ir_op_none());
+                conv_inst->extra_args_count = 1;
+                conv_inst->extra_args = malloc(sizeof(CnIrOperand));
+                conv_inst->extra_args[0] = left;
+                
+                int str_reg = alloc_reg(ctx);
+                conv_inst->dest = cn_ir_op_reg(str_reg, cn_type_new_primitive(CN_TYPE_STRING));
+                emit(ctx, conv_inst);
+                left = conv_inst->dest;
+            }
+        }
+        
+        // 转换右操作数
+        if (right_type && right_type->kind != CN_TYPE_STRING) {
+            const char *convert_func = NULL;
+            if (is_integer_type(right_type)) {
+                convert_func = "cn_rt_int_to_string";
+            } else if (right_type->kind == CN_TYPE_BOOL) {
+                convert_func = "cn_rt_bool_to_string";
+            } else if (is_float_type(right_type)) {
+                convert_func = "cn_rt_float_to_string";
+            }
+            
+            if (convert_func) {
+                CnIrInst *conv_inst = cn_ir_inst_new(CN_IR_INST_CALL, cn_ir_op_none(),
+                                                      cn_ir_op_symbol(convert_func, NULL),
+                                                      cn_ir_op_none());
+                conv_inst->extra_args_count = 1;
+                conv_inst->extra_args = malloc(sizeof(CnIrOperand));
+                conv_inst->extra_args[0] = right;
+                
+                int str_reg = alloc_reg(ctx);
+                conv_inst->dest = cn_ir_op_reg(str_reg, cn_type_new_primitive(CN_TYPE_STRING));
+                emit(ctx, conv_inst);
+                right = conv_inst->dest;
+            }
+        }
+        
+        // 调用 cn_rt_string_concat
+        CnIrInst *concat_inst = cn_ir_inst_new(CN_IR_INST_CALL, cn_ir_op_none(),
+                                                cn_ir_op_symbol("cn_rt_string_concat", NULL),
+                                                cn_ir_op_none());
+        concat_inst->extra_args_count = 2;
+        concat_inst->extra_args = malloc(2 * sizeof(CnIrOperand));
+        concat_inst->extra_args[0] = left;
+        concat_inst->extra_args[1] = right;
+        
+        int dest_reg = alloc_reg(ctx);
+        concat_inst->dest = cn_ir_op_reg(dest_reg, expr->type);
+        emit(ctx, concat_inst);
+        
+        return concat_inst->dest;
+    }
+    
+    // 普通二元运算
+    CnIrOperand right = cn_ir_gen_expr(ctx, expr->as.binary.right);
+    int dest_reg = alloc_reg(ctx);
+    CnIrOperand dest = cn_ir_op_reg(dest_reg, expr->type);
+    CnIrInstKind kind = binary_op_to_ir(expr->as.binary.op);
+    emit(ctx, cn_ir_inst_new(kind, dest, left, right));
+    return dest;
+}
+
+// 二元/逻辑运算链：左结合长链（如生成代码中的 a+b+…）不逐层递归。
+// 先自顶向下为逻辑运算建立短路用的基本块（编号顺序与逐层递归一致），
+// 再生成链底，自底向上逐个生成右操作数与运算
+static CnIrOperand gen_operator_chain(CnIrGenContext *ctx, CnAstExpr *expr) {
+    CnAstExprChain chain;
+    CnIrBasicBlock **blocks = NULL;  // 逻辑运算链：每个运算的 rhs 块与 merge 块
+    CnIrOperand left;
+
+    if (!cn_frontend_ast_expr_chain_collect(&chain, expr)) {
+        return cn_ir_op_none();
+    }
+    if (expr->kind == CN_AST_EXPR_LOGICAL) {
+        blocks = malloc(chain.count * 2 * sizeof(CnIrBasicBlock *));
+        if (!blocks) {
+            cn_frontend_ast_expr_chain_free(&chain);
+            return cn_ir_op_none();
+        }
+        for (size_t i = 0; i < chain.count; i++) {
+            blocks[i * 2] = cn_ir_basic_block_new(make_block_name(ctx, "logic_rhs"));
+            blocks[i * 2 + 1] = cn_ir_basic_block_new(make_block_name(ctx, "logic_merge"));
+            cn_ir_function_add_block(ctx->current_func, blocks[i * 2]);
+            cn_ir_function_add_block(ctx->current_func, blocks[i * 2 + 1]);
+            alloc_reg(ctx);  // 结果寄存器（PHI 预留）
+        }
+    }
+
+    left = cn_ir_gen_expr(ctx, cn_frontend_ast_expr_chain_leaf(&chain));
+    for (size_t i = chain.count; i-- > 0;) {
+        CnAstExpr *node = chain.nodes[i];
+        if (node->kind == CN_AST_EXPR_BINARY) {
+            left = gen_binary_with_left(ctx, node, left);
+            continue;
+        }
+
+        // 逻辑表达式：需要短路求值
+        CnIrBasicBlock *rhs_block = blocks[i * 2];
+        CnIrBasicBlock *merge_block = blocks[i * 2 + 1];
+        // 保存当前块，用于后续设置控制流连接
+        CnIrBasicBlock *cond_block = ctx->current_block;
+
+        if (node->as.logical.op == CN_AST_LOGICAL_OP_AND) {
+            // AND: 左为假则短路
+            emit(ctx, cn_ir_inst_new(CN_IR_INST_BRANCH, cn_ir_op_label(rhs_block),
+                                     left, cn_ir_op_label(merge_block)));
+            // 设置控制流连接：条件块 -> rhs_block 和 merge_block
+            cn_ir_basic_block_connect(cond_block, rhs_block);
+            cn_ir_basic_block_connect(cond_block, merge_block);
+        } else {
+            // OR: 左为真则短路
+            emit(ctx, cn_ir_inst_new(CN_IR_INST_BRANCH, cn_ir_op_label(merge_block),
+                                     left, cn_ir_op_label(rhs_block)));
+            // 设置控制流连接：条件块 -> merge_block 和 rhs_block
+            cn_ir_basic_block_connect(cond_block, merge_block);
+            cn_ir_basic_block_connect(cond_block, rhs_block);
+        }
+
+        switch_to_block(ctx, rhs_block);
+        CnIrOperand right = cn_ir_gen_expr(ctx, node->as.logical.right);
+        emit(ctx, cn_ir_inst_new(CN_IR_INST_JUMP, cn_ir_op_label(merge_block),
+                                 cn_ir_op_none(), cn_ir_op_none()));
+        // 设置控制流连接：rhs_block -> merge_block
+        cn_ir_basic_block_connect(rhs_block, merge_block);
+
+        switch_to_block(ctx, merge_block);
+        // 简化处理：PHI 指令预留，此处返回右操作数
+        left = right;
+    }
+
+    free(blocks);
+    cn_frontend_ast_expr_chain_free(&chain);
+    return left;
+}
+
 // 生成表达式的 IR，返回结果操作数
 CnIrOperand cn_ir_gen_expr(CnIrGenContext *ctx, CnAstExpr *expr) {
     if (!expr) return cn_ir_op_none();
@@ -312,10 +669,10 @@ CnIrOperand cn_ir_gen_expr(CnIrGenContext *ctx, CnAstExpr *expr) {
             // 【P1修复】在处理标识符之前，确保expr->type已设置
             // 这是类型传播链的源头：如果此处类型丢失，下游所有推断都会失败
             // 当expr->type为NULL/UNKNOWN/INT时，从符号表回填精确类型
+            // （当前作用域的查找结果缓存在节点上，本分支内的多次查找只沿作用域链查找一次）
             if (!expr->type || expr->type->kind == CN_TYPE_UNKNOWN ||
                 (expr->type->kind == CN_TYPE_INT && ctx->current_scope)) {
-                CnSemSymbol *p1_sym = cn_sem_scope_lookup(ctx->current_scope,
-                    expr->as.identifier.name, expr->as.identifier.name_length);
+                CnSemSymbol *p1_sym = cn_sem_scope_lookup_identifier(ctx->current_scope, expr);
                 if (p1_sym && p1_sym->type && p1_sym->type->kind != CN_TYPE_UNKNOWN) {
                     expr->type = p1_sym->type;
                 } else if (!p1_sym && ctx->global_scope) {
@@ -350,8 +707,7 @@ CnIrOperand cn_ir_gen_expr(CnIrGenContext *ctx, CnAstExpr *expr) {
                         if (!static_var_type || static_var_type->kind == CN_TYPE_UNKNOWN ||
                             static_var_type->kind == CN_TYPE_INT) {
                             if (ctx->current_scope) {
-                                CnSemSymbol *p1_sv_sym = cn_sem_scope_lookup(ctx->current_scope,
-                                    expr->as.identifier.name, expr->as.identifier.name_length);
+                                CnSemSymbol *p1_sv_sym = cn_sem_scope_lookup_identifier(ctx->current_scope, expr);
                                 if (p1_sv_sym && p1_sv_sym->type &&
                                     p1_sv_sym->type->kind != CN_TYPE_UNKNOWN &&
                                     p1_sv_sym->type->kind != CN_TYPE_INT) {
@@ -392,9 +748,7 @@ CnIrOperand cn_ir_gen_expr(CnIrGenContext *ctx, CnAstExpr *expr) {
                 if (!var_type || var_type->kind == CN_TYPE_INT || var_type->kind == CN_TYPE_UNKNOWN) {
                     // 层级1：从当前作用域符号表查找
                     if (ctx->current_scope) {
-                        CnSemSymbol *sym = cn_sem_scope_lookup(ctx->current_scope,
-                                                               expr->as.identifier.name,
-                                                               expr->as.identifier.name_length);
+                        CnSemSymbol *sym = cn_sem_scope_lookup_identifier(ctx->current_scope, expr);
                         if (sym && sym->type && sym->type->kind != CN_TYPE_UNKNOWN &&
                             sym->type->kind != CN_TYPE_INT) {
                             var_type = sym->type;
@@ -438,9 +792,7 @@ CnIrOperand cn_ir_gen_expr(CnIrGenContext *ctx, CnAstExpr *expr) {
             
             // 检查符号表中的符号类型
             if (ctx->current_scope) {
-                CnSemSymbol *sym = cn_sem_scope_lookup(ctx->current_scope,
-                                                       expr->as.identifier.name,
-                                                       expr->as.identifier.name_length);
+                CnSemSymbol *sym = cn_sem_scope_lookup_identifier(ctx->current_scope, expr);
                 
                 // 只有当符号是枚举成员且不是变量时才返回枚举值
                 // 注意：枚举成员符号的 kind 是 CN_SEM_SYMBOL_ENUM_MEMBER
@@ -577,9 +929,7 @@ CnIrOperand cn_ir_gen_expr(CnIrGenContext *ctx, CnAstExpr *expr) {
             if (!var_type || var_type->kind == CN_TYPE_INT || var_type->kind == CN_TYPE_UNKNOWN) {
                 // 层级1：从当前作用域符号表查找
                 if (ctx->current_scope) {
-                    CnSemSymbol *sym = cn_sem_scope_lookup(ctx->current_scope,
-                                                           expr->as.identifier.name,
-                                                           expr->as.identifier.name_length);
+                    CnSemSymbol *sym = cn_sem_scope_lookup_identifier(ctx->current_scope, expr);
                     if (sym && sym->type && sym->type->kind != CN_TYPE_UNKNOWN &&
                         sym->type->kind != CN_TYPE_INT) {
                         var_type = sym->type;
@@ -635,153 +985,9 @@ CnIrOperand cn_ir_gen_expr(CnIrGenContext *ctx, CnAstExpr *expr) {
             emit(ctx, cn_ir_inst_new(CN_IR_INST_LOAD, dest, src, cn_ir_op_none()));
             return dest;
         }
-        case CN_AST_EXPR_BINARY: {
-            // 二元运算：先递归生成左右操作数，再生成运算指令
-            
-            // Round5-Fix5: 增强字符串拼接检测条件
-            // 原始条件：仅检查 expr->type == STRING，但语义分析器可能将字符串拼接
-            // 表达式类型设为INT/POINTER/UNKNOWN，导致检测失败
-            // 新增条件：任一操作数为STRING/POINTER(字符串指针)或字符串字面量时也触发
-            bool is_str_concat = false;
-            if (expr->as.binary.op == CN_AST_BINARY_OP_ADD) {
-                // 条件1：表达式类型为STRING（原始条件）
-                if (expr->type && expr->type->kind == CN_TYPE_STRING) {
-                    is_str_concat = true;
-                }
-                // 条件2：左操作数为STRING类型
-                else if (expr->as.binary.left && expr->as.binary.left->type &&
-                         expr->as.binary.left->type->kind == CN_TYPE_STRING) {
-                    is_str_concat = true;
-                }
-                // 条件3：右操作数为字符串字面量，且左操作数为指针类型（可能是char*）
-                else if (expr->as.binary.right &&
-                         expr->as.binary.right->kind == CN_AST_EXPR_STRING_LITERAL) {
-                    if (expr->as.binary.left && expr->as.binary.left->type &&
-                        (expr->as.binary.left->type->kind == CN_TYPE_STRING ||
-                         expr->as.binary.left->type->kind == CN_TYPE_POINTER)) {
-                        is_str_concat = true;
-                    }
-                    // 左操作数类型为INT/UNKNOWN但右操作数是字符串字面量，也可能是字符串拼接
-                    else if (expr->as.binary.left && expr->as.binary.left->type &&
-                             (expr->as.binary.left->type->kind == CN_TYPE_INT ||
-                              expr->as.binary.left->type->kind == CN_TYPE_UNKNOWN)) {
-                        is_str_concat = true;
-                    }
-                }
-                // 条件4：左操作数为字符串字面量
-                else if (expr->as.binary.left &&
-                         expr->as.binary.left->kind == CN_AST_EXPR_STRING_LITERAL) {
-                    is_str_concat = true;
-                }
-                // 条件5：两个操作数都是POINTER类型（char* + char*）
-                else if (expr->as.binary.left && expr->as.binary.left->type &&
-                         expr->as.binary.right && expr->as.binary.right->type &&
-                         expr->as.binary.left->type->kind == CN_TYPE_POINTER &&
-                         expr->as.binary.right->type->kind == CN_TYPE_POINTER) {
-                    is_str_concat = true;
-                }
-                // 【P1修复-F1】条件6：右操作数为字符串字面量，且左操作数不是整数/浮点类型
-                // 典型错误：r17 = r16 + "*"，r16是char*但类型被标记为INT/UNKNOWN
-                // 当右操作数是字符串字面量时，如果左操作数不是数值类型，应视为字符串拼接
-                else if (expr->as.binary.right &&
-                         expr->as.binary.right->kind == CN_AST_EXPR_STRING_LITERAL &&
-                         expr->as.binary.left) {
-                    CnType *left_t = expr->as.binary.left->type;
-                    /* 左操作数类型为NULL/INT/UNKNOWN/POINTER/STRING时，可能是字符串拼接 */
-                    if (!left_t || left_t->kind == CN_TYPE_INT ||
-                        left_t->kind == CN_TYPE_UNKNOWN || left_t->kind == CN_TYPE_VOID ||
-                        left_t->kind == CN_TYPE_POINTER || left_t->kind == CN_TYPE_STRING) {
-                        is_str_concat = true;
-                    }
-                }
-            }
-            
-            if (is_str_concat) {
-                
-                CnIrOperand left = cn_ir_gen_expr(ctx, expr->as.binary.left);
-                CnIrOperand right = cn_ir_gen_expr(ctx, expr->as.binary.right);
-                
-                // 将非字符串类型转换为字符串
-                CnType *left_type = expr->as.binary.left->type;
-                CnType *right_type = expr->as.binary.right->type;
-                
-                // 转换左操作数
-                if (left_type && left_type->kind != CN_TYPE_STRING) {
-                    const char *convert_func = NULL;
-                    if (is_integer_type(left_type)) {
-                        convert_func = "cn_rt_int_to_string";
-                    } else if (left_type->kind == CN_TYPE_BOOL) {
-                        convert_func = "cn_rt_bool_to_string";
-                    } else if (is_float_type(left_type)) {
-                        convert_func = "cn_rt_float_to_string";
-                    }
-                    
-                    if (convert_func) {
-                        CnIrInst *conv_inst = cn_ir_inst_new(CN_IR_INST_CALL, cn_ir_op_none(),
-                                                              cn_ir_op_symbol(convert_func, NULL),
-                                                              cn_ir_op_none());
-                        conv_inst->extra_args_count = 1;
-                        conv_inst->extra_args = malloc(sizeof(CnIrOperand));
-                        conv_inst->extra_args[0] = left;
-                        
-                        int str_reg = alloc_reg(ctx);
-                        conv_inst->dest = cn_ir_op_reg(str_reg, cn_type_new_primitive(CN_TYPE_STRING));
-                        emit(ctx, conv_inst);
-                        left = conv_inst->dest;
-                    }
-                }
-                
-                // 转换右操作数
-                if (right_type && right_type->kind != CN_TYPE_STRING) {
-                    const char *convert_func = NULL;
-                    if (is_integer_type(right_type)) {
-                        convert_func = "cn_rt_int_to_string";
-                    } else if (right_type->kind == CN_TYPE_BOOL) {
-                        convert_func = "cn_rt_bool_to_string";
-                    } else if (is_float_type(right_type)) {
-                        convert_func = "cn_rt_float_to_string";
-                    }
-                    
-                    if (convert_func) {
-                        CnIrInst *conv_inst = cn_ir_inst_new(CN_IR_INST_CALL, cn_ir_op_none(),
-                                                              cn_ir_op_symbol(convert_func, NULL),
-                                                              cn_ir_op_none());
-                        conv_inst->extra_args_count = 1;
-                        conv_inst->extra_args = malloc(sizeof(CnIrOperand));
-                        conv_inst->extra_args[0] = right;
-                        
-                        int str_reg = alloc_reg(ctx);
-                        conv_inst->dest = cn_ir_op_reg(str_reg, cn_type_new_primitive(CN_TYPE_STRING));
-                        emit(ctx, conv_inst);
-                        right = conv_inst->dest;
-                    }
-                }
-                
-                // 调用 cn_rt_string_concat
-                CnIrInst *concat_inst = cn_ir_inst_new(CN_IR_INST_CALL, cn_ir_op_none(),
-                                                        cn_ir_op_symbol("cn_rt_string_concat", NULL),
-                                                        cn_ir_op_none());
-                concat_inst->extra_args_count = 2;
-                concat_inst->extra_args = malloc(2 * sizeof(CnIrOperand));
-                concat_inst->extra_args[0] = left;
-                concat_inst->extra_args[1] = right;
-                
-                int dest_reg = alloc_reg(ctx);
-                concat_inst->dest = cn_ir_op_reg(dest_reg, expr->type);
-                emit(ctx, concat_inst);
-                
-                return concat_inst->dest;
-            }
-            
-            // 普通二元运算
-            CnIrOperand left = cn_ir_gen_expr(ctx, expr->as.binary.left);
-            CnIrOperand right = cn_ir_gen_expr(ctx, expr->as.binary.right);
-            int dest_reg = alloc_reg(ctx);
-            CnIrOperand dest = cn_ir_op_reg(dest_reg, expr->type);
-            CnIrInstKind kind = binary_op_to_ir(expr->as.binary.op);
-            emit(ctx, cn_ir_inst_new(kind, dest, left, right));
-            return dest;
-        }
+        case CN_AST_EXPR_BINARY:
+        case CN_AST_EXPR_LOGICAL:
+            return gen_operator_chain(ctx, expr);
         case CN_AST_EXPR_ASSIGN: {
             // 赋值：先生成右值，再 STORE 到左值地址
             CnIrOperand value = cn_ir_gen_expr(ctx, expr->as.assign.value);
@@ -911,47 +1117,6 @@ CnIrOperand cn_ir_gen_expr(CnIrGenContext *ctx, CnAstExpr *expr) {
             }
             return value;
         }
-        case CN_AST_EXPR_LOGICAL: {
-            // 逻辑表达式：需要短路求值
-            CnIrBasicBlock *rhs_block = cn_ir_basic_block_new(make_block_name(ctx, "logic_rhs"));
-            CnIrBasicBlock *merge_block = cn_ir_basic_block_new(make_block_name(ctx, "logic_merge"));
-            cn_ir_function_add_block(ctx->current_func, rhs_block);
-            cn_ir_function_add_block(ctx->current_func, merge_block);
-
-            int result_reg = alloc_reg(ctx);
-            CnIrOperand result = cn_ir_op_reg(result_reg, cn_type_new_primitive(CN_TYPE_BOOL));
-            CnIrOperand left = cn_ir_gen_expr(ctx, expr->as.logical.left);
-
-            // 保存当前块，用于后续设置控制流连接
-            CnIrBasicBlock *cond_block = ctx->current_block;
-
-            if (expr->as.logical.op == CN_AST_LOGICAL_OP_AND) {
-                // AND: 左为假则短路
-                emit(ctx, cn_ir_inst_new(CN_IR_INST_BRANCH, cn_ir_op_label(rhs_block),
-                                         left, cn_ir_op_label(merge_block)));
-                // 设置控制流连接：条件块 -> rhs_block 和 merge_block
-                cn_ir_basic_block_connect(cond_block, rhs_block);
-                cn_ir_basic_block_connect(cond_block, merge_block);
-            } else {
-                // OR: 左为真则短路
-                emit(ctx, cn_ir_inst_new(CN_IR_INST_BRANCH, cn_ir_op_label(merge_block),
-                                         left, cn_ir_op_label(rhs_block)));
-                // 设置控制流连接：条件块 -> merge_block 和 rhs_block
-                cn_ir_basic_block_connect(cond_block, merge_block);
-                cn_ir_basic_block_connect(cond_block, rhs_block);
-            }
-
-            switch_to_block(ctx, rhs_block);
-            CnIrOperand right = cn_ir_gen_expr(ctx, expr->as.logical.right);
-            emit(ctx, cn_ir_inst_new(CN_IR_INST_JUMP, cn_ir_op_label(merge_block),
-                                     cn_ir_op_none(), cn_ir_op_none()));
-            // 设置控制流连接：rhs_block -> merge_block
-            cn_ir_basic_block_connect(rhs_block, merge_block);
-
-            switch_to_block(ctx, merge_block);
-            // 简化处理：PHI 指令预留，此处返回右操作数
-            return right;
-        }
         case CN_AST_EXPR_UNARY: {
             CnIrOperand operand = cn_ir_gen_expr(ctx, expr->as.unary.operand);
             int dest_reg = alloc_reg(ctx);
@@ -1163,7 +1328,7 @@ CnIrOperand cn_ir_gen_expr(CnIrGenContext *ctx, CnAstExpr *expr) {
                         // 【修复】先检查当前作用域，再检查全局作用域
                         CnSemSymbol *sym = NULL;
                         if (ctx->current_scope) {
-                            sym = cn_sem_scope_lookup(ctx->current_scope, arg_name, strlen(arg_name));
+                            sym = cn_sem_scope_lookup_identifier(ctx->current_scope, arg);
                         }
                         if (!sym && ctx->global_scope) {
                             sym = cn_sem_scope_lookup(ctx->global_scope, arg_name, strlen(arg_name));
@@ -1534,16 +1699,13 @@ CnIrOperand cn_ir_gen_expr(CnIrGenContext *ctx, CnAstExpr *expr) {
             // 【新增】如果仍然没有返回类型，尝试从当前作用域查找函数符号
             if ((!return_type || return_type->kind == CN_TYPE_VOID) &&
                 expr->as.call.callee->kind == CN_AST_EXPR_IDENTIFIER && ctx->current_scope) {
-                char *func_name = copy_name(expr->as.call.callee->as.identifier.name,
-                                            expr->as.call.callee->as.identifier.name_length);
-                CnSemSymbol *sym = cn_sem_scope_lookup(ctx->current_scope, func_name, strlen(func_name));
+                CnSemSymbol *sym = cn_sem_scope_lookup_identifier(ctx->current_scope, expr->as.call.callee);
                 if (sym && sym->kind == CN_SEM_SYMBOL_FUNCTION && sym->type) {
                     if (sym->type->kind == CN_TYPE_FUNCTION && sym->type->as.function.return_type) {
                         return_type = sym->type->as.function.return_type;
                         expr->type = return_type;
                     }
                 }
-                free(func_name);
             }
             
             // 【RC2修复-修改8】如果仍然没有返回类型，尝试从运行时API函数名推断
@@ -1803,9 +1965,7 @@ CnIrOperand cn_ir_gen_expr(CnIrGenContext *ctx, CnAstExpr *expr) {
             } else if (expr->as.member.object &&
                        expr->as.member.object->kind == CN_AST_EXPR_IDENTIFIER && ctx->current_scope) {
                 // 方式2：通过符号表查找确认是否为枚举类型
-                CnSemSymbol *sym = cn_sem_scope_lookup(ctx->current_scope,
-                    expr->as.member.object->as.identifier.name,
-                    expr->as.member.object->as.identifier.name_length);
+                CnSemSymbol *sym = cn_sem_scope_lookup_identifier(ctx->current_scope, expr->as.member.object);
                 if (sym && sym->kind == CN_SEM_SYMBOL_ENUM && sym->type) {
                     is_enum_access = true;
                     enum_sym = sym;
@@ -1921,9 +2081,7 @@ CnIrOperand cn_ir_gen_expr(CnIrGenContext *ctx, CnAstExpr *expr) {
                 CnType *obj_type = expr->as.member.object->type;
                 if (!obj_type && ctx->current_scope) {
                     // 从符号表查找变量的类型
-                    CnSemSymbol *sym = cn_sem_scope_lookup(ctx->current_scope,
-                                            expr->as.member.object->as.identifier.name,
-                                            expr->as.member.object->as.identifier.name_length);
+                    CnSemSymbol *sym = cn_sem_scope_lookup_identifier(ctx->current_scope, expr->as.member.object);
                     if (sym && sym->type) {
                         obj_type = sym->type;
                     }
@@ -2225,9 +2383,7 @@ void cn_ir_gen_stmt(CnIrGenContext *ctx, CnAstStmt *stmt) {
                 CnAstExpr *callee_expr = decl->initializer->as.call.callee;
                 CnSemSymbol *func_sym = NULL;
                 if (ctx->current_scope) {
-                    func_sym = cn_sem_scope_lookup(ctx->current_scope,
-                        callee_expr->as.identifier.name,
-                        callee_expr->as.identifier.name_length);
+                    func_sym = cn_sem_scope_lookup_identifier(ctx->current_scope, callee_expr);
                 }
                 if (!func_sym && ctx->global_scope) {
                     func_sym = cn_sem_scope_lookup(ctx->global_scope,
@@ -2289,6 +2445,7 @@ void cn_ir_gen_stmt(CnIrGenContext *ctx, CnAstStmt *stmt) {
             if (decl->is_static) {
                 // 静态变量：创建静态变量结构并添加到函数
                 CnIrStaticVar *static_var = (CnIrStaticVar *)malloc(sizeof(CnIrStaticVar));
+                CnIrConstArray *packed = NULL;
                 if (static_var) {
                     static_var->name = strdup(name);
                     static_var->name_length = decl->name_length;
@@ -2315,6 +2472,9 @@ void cn_ir_gen_stmt(CnIrGenContext *ctx, CnAstStmt *stmt) {
                         } else if (decl->initializer->kind == CN_AST_EXPR_STRING_LITERAL) {
                             static_var->initializer = cn_ir_op_imm_str(
                                 decl->initializer->as.string_literal.value, decl_type);
+                        } else if ((packed = pack_const_array(ctx, decl->initializer, decl_type)) != NULL) {
+                            // 全常量数组初始化列表：整体打包为静态数组初始化器
+                            static_var->initializer = cn_ir_op_const_array(packed, decl_type);
                         } else {
                             // 其他情况（应该已经被语义检查拒绝）
                             static_var->initializer = cn_ir_op_none();
@@ -2386,6 +2546,18 @@ void cn_ir_gen_stmt(CnIrGenContext *ctx, CnAstStmt *stmt) {
                 alloc_inst->extra_args[1] = cn_ir_op_imm_int(array_size, NULL);
                 emit(ctx, alloc_inst);
                 
+                // 全常量初始化列表：从文件作用域只读表整体复制，不逐元素生成存储指令
+                // （仅宿主模式：复制使用运行时 cn_rt_mem_copy；结构体元素的分配大小按默认值计算，不打包）
+                if (decl->initializer && ctx->module->compile_mode != CN_COMPILE_MODE_FREESTANDING &&
+                    elem_type && elem_type->kind != CN_TYPE_STRUCT) {
+                    CnIrConstArray *packed = pack_const_array(ctx, decl->initializer, decl_type);
+                    if (packed) {
+                        packed->emit_table = 1;
+                        emit(ctx, cn_ir_inst_new(CN_IR_INST_STORE, addr,
+                                                 cn_ir_op_const_array(packed, decl_type), cn_ir_op_none()));
+                    }
+                }
+                
                 free(name);
                 break;
             }
@@ -2423,39 +2595,75 @@ void cn_ir_gen_stmt(CnIrGenContext *ctx, CnAstStmt *stmt) {
             break;
         }
         case CN_AST_STMT_IF: {
+            // "否则 如果" 链按循环生成：每段的 merge 块入栈，链尾生成完毕后
+            // 由内向外补上跳转到外层 merge 块，与逐层递归生成的 IR 一致
             CnAstIfStmt *if_stmt = &stmt->as.if_stmt;
-            CnIrBasicBlock *then_block = cn_ir_basic_block_new(make_block_name(ctx, "if_then"));
-            CnIrBasicBlock *else_block = if_stmt->else_block 
-                                         ? cn_ir_basic_block_new(make_block_name(ctx, "if_else"))
-                                         : NULL;
-            CnIrBasicBlock *merge_block = cn_ir_basic_block_new(make_block_name(ctx, "if_merge"));
-
-            cn_ir_function_add_block(ctx->current_func, then_block);
-            if (else_block) cn_ir_function_add_block(ctx->current_func, else_block);
-            cn_ir_function_add_block(ctx->current_func, merge_block);
+            CnIrBasicBlock **merges = NULL;
+            size_t merge_count = 0;
+            size_t merge_capacity = 0;
+
+            while (if_stmt) {
+                CnIrBasicBlock *then_block = cn_ir_basic_block_new(make_block_name(ctx, "if_then"));
+                CnIrBasicBlock *else_block = if_stmt->else_block 
+                                             ? cn_ir_basic_block_new(make_block_name(ctx, "if_else"))
+                                             : NULL;
+                CnIrBasicBlock *merge_block = cn_ir_basic_block_new(make_block_name(ctx, "if_merge"));
+                CnAstStmt *else_if = cn_frontend_ast_else_if(if_stmt);
+
+                cn_ir_function_add_block(ctx->current_func, then_block);
+                if (else_block) cn_ir_function_add_block(ctx->current_func, else_block);
+                cn_ir_function_add_block(ctx->current_func, merge_block);
+
+                CnIrOperand cond = cn_ir_gen_expr(ctx, if_stmt->condition);
+                CnIrBasicBlock *false_target = else_block ? else_block : merge_block;
+                emit(ctx, cn_ir_inst_new(CN_IR_INST_BRANCH, cn_ir_op_label(then_block),
+                                         cond, cn_ir_op_label(false_target)));
+                cn_ir_basic_block_connect(ctx->current_block, then_block);
+                cn_ir_basic_block_connect(ctx->current_block, false_target);
+
+                switch_to_block(ctx, then_block);
+                cn_ir_gen_block(ctx, if_stmt->then_block);
+                emit(ctx, cn_ir_inst_new(CN_IR_INST_JUMP, cn_ir_op_label(merge_block),
+                                         cn_ir_op_none(), cn_ir_op_none()));
+                cn_ir_basic_block_connect(ctx->current_block, merge_block);
 
-            CnIrOperand cond = cn_ir_gen_expr(ctx, if_stmt->condition);
-            CnIrBasicBlock *false_target = else_block ? else_block : merge_block;
-            emit(ctx, cn_ir_inst_new(CN_IR_INST_BRANCH, cn_ir_op_label(then_block),
-                                     cond, cn_ir_op_label(false_target)));
-            cn_ir_basic_block_connect(ctx->current_block, then_block);
-            cn_ir_basic_block_connect(ctx->current_block, false_target);
+                if (else_if && merge_count == merge_capacity) {
+                    size_t new_capacity = merge_capacity ? merge_capacity * 2 : 16;
+                    CnIrBasicBlock **grown = realloc(merges, new_capacity * sizeof(CnIrBasicBlock *));
+                    if (grown) {
+                        merges = grown;
+                        merge_capacity = new_capacity;
+                    } else {
+                        else_if = NULL;  // 内存不足时退回递归生成
+                    }
+                }
+                if (else_if) {
+                    merges[merge_count++] = merge_block;
+                    switch_to_block(ctx, else_block);
+                    if_stmt = &else_if->as.if_stmt;
+                    continue;
+                }
 
-            switch_to_block(ctx, then_block);
-            cn_ir_gen_block(ctx, if_stmt->then_block);
-            emit(ctx, cn_ir_inst_new(CN_IR_INST_JUMP, cn_ir_op_label(merge_block),
-                                     cn_ir_op_none(), cn_ir_op_none()));
-            cn_ir_basic_block_connect(ctx->current_block, merge_block);
+                if (else_block) {
+                    switch_to_block(ctx, else_block);
+                    cn_ir_gen_block(ctx, if_stmt->else_block);
+                    emit(ctx, cn_ir_inst_new(CN_IR_INST_JUMP, cn_ir_op_label(merge_block),
+                                             cn_ir_op_none(), cn_ir_op_none()));
+                    cn_ir_basic_block_connect(ctx->current_block, merge_block);
+                }
+
+                switch_to_block(ctx, merge_block);
+                if_stmt = NULL;
+            }
 
-            if (else_block) {
-                switch_to_block(ctx, else_block);
-                cn_ir_gen_block(ctx, if_stmt->else_block);
+            while (merge_count > 0) {
+                CnIrBasicBlock *merge_block = merges[--merge_count];
                 emit(ctx, cn_ir_inst_new(CN_IR_INST_JUMP, cn_ir_op_label(merge_block),
                                          cn_ir_op_none(), cn_ir_op_none()));
                 cn_ir_basic_block_connect(ctx->current_block, merge_block);
+                switch_to_block(ctx, merge_block);
             }
-
-            switch_to_block(ctx, merge_block);
+            free(merges);
             break;
         }
         case CN_AST_STMT_WHILE: {
@@ -2711,6 +2919,13 @@ void cn_ir_gen_block(CnIrGenContext *ctx, CnAstBlockStmt *block) {
 void cn_ir_gen_function(CnIrGenContext *ctx, CnAstFunctionDecl *func, CnSemScope *parent_scope) {
     if (!func) return;
     
+    // 导入模块以跳读模式解析，函数体在首次生成 IR 时解析；
+    // 语法错误由解析器报告到诊断信息，该函数不生成 IR
+    if (!cn_frontend_parse_function_body(func, ctx->diagnostics)) {
+        ctx->has_error = true;
+        return;
+    }
+    
     // 使用 parent_scope 参数，如果没有提供则使用全局作用域
     if (!parent_scope) {
         parent_scope = ctx->global_scope;
@@ -2909,9 +3124,16 @@ void cn_ir_gen_function(CnIrGenContext *ctx, CnAstFunctionDecl *func, CnSemScope
 }
 
 CnIrModule *cn_ir_gen_program(CnAstProgram *program, CnSemScope *global_scope, CnTargetTriple target, CnCompileMode mode) {
+    return cn_ir_gen_program_with_diagnostics(program, global_scope, target, mode, NULL);
+}
+
+CnIrModule *cn_ir_gen_program_with_diagnostics(CnAstProgram *program, CnSemScope *global_scope,
+                                               CnTargetTriple target, CnCompileMode mode,
+                                               CnDiagnostics *diagnostics) {
     if (!program) return NULL;
 
     CnIrGenContext *ctx = cn_ir_gen_context_new();
+    ctx->diagnostics = diagnostics;
     ctx->global_scope = global_scope;
     ctx->current_scope = global_scope;
     ctx->program = program;  // 保存程序指针，用于查找类定义
@@ -2929,6 +3151,7 @@ CnIrModule *cn_ir_gen_program(CnAstProgram *program, CnSemScope *global_scope, C
         }
         
         CnAstVarDecl *var_decl = &var_stmt->as.var_decl;
+        CnIrConstArray *packed = NULL;
         CnIrGlobalVar *global = (CnIrGlobalVar *)malloc(sizeof(CnIrGlobalVar));
         if (global) {
             // 为变量名分配并复制字符串
@@ -2981,6 +3204,9 @@ CnIrModule *cn_ir_gen_program(CnAstProgram *program, CnSemScope *global_scope, C
                     global->initializer.kind = CN_IR_OP_AST_EXPR;
                     global->initializer.as.ast_expr = var_decl->initializer;  // 保存 AST 节点指针
                     global->initializer.type = var_type;
+                } else if ((packed = pack_const_array(ctx, var_decl->initializer, var_type)) != NULL) {
+                    // 全常量数组初始化列表：整体打包，代码生成时输出为静态数组初始化器
+                    global->initializer = cn_ir_op_const_array(packed, var_type);
                 } else {
                     // 其他类型的初始化表达式暂不支持，使用0初始化
                     global->initializer = cn_ir_op_imm_int(0, var_type);
@@ -3010,6 +3236,10 @@ CnIrModule *cn_ir_gen_program(CnAstProgram *program, CnSemScope *global_scope, C
 
     CnIrModule *module = ctx->module;
     ctx->module = NULL;
+    if (ctx->has_error) {
+        cn_ir_module_free(module);
+        module = NULL;
+    }
     cn_ir_gen_context_free(ctx);
     return module;
 }
@@ -22,7 +22,7 @@
 
 /* ========== 表达式哈希表数据结构 ========== */
 
-#define EXPR_HASH_SIZE 256  // 哈希表桶数量
+#define EXPR_HASH_SIZE 256  // 哈希表初始桶数量（表项数超过桶数时翻倍）
 
 /**
  * @brief 表达式规范化表示（用于哈希键）
@@ -50,7 +50,9 @@ typedef struct CnIrExprEntry {
  * @brief 表达式哈希表
  */
 typedef struct CnIrExprTable {
-    CnIrExprEntry *buckets[EXPR_HASH_SIZE];  // 哈希桶数组
+    CnIrExprEntry **buckets;    // 哈希桶数组
+    size_t bucket_count;        // 桶数量（2 的幂）
+    size_t entry_count;         // 表项数量
 } CnIrExprTable;
 
 /* ========== 辅助函数 ========== */
@@ -122,14 +124,14 @@ static bool is_commutative(CnIrInstKind kind) {
  * @brief 计算表达式键的哈希值
  * 
  * @param key 表达式键
- * @return unsigned int 哈希值
+ * @return unsigned int 哈希值（调用方按桶数量取模）
  */
 static unsigned int expr_key_hash(CnIrExprKey *key) {
     // 简单的哈希函数：将各字段组合
     unsigned int hash = (unsigned int)key->kind;
     hash = hash * 31 + (unsigned int)key->src1_id;
     hash = hash * 31 + (unsigned int)key->src2_id;
-    return hash % EXPR_HASH_SIZE;
+    return hash;
 }
 
 /**
@@ -182,6 +184,14 @@ static CnIrExprKey normalize_expr(CnIrInst *inst) {
  */
 static CnIrExprTable *expr_table_new(void) {
     CnIrExprTable *table = (CnIrExprTable *)calloc(1, sizeof(CnIrExprTable));
+    if (!table) return NULL;
+    
+    table->buckets = (CnIrExprEntry **)calloc(EXPR_HASH_SIZE, sizeof(CnIrExprEntry *));
+    if (!table->buckets) {
+        free(table);
+        return NULL;
+    }
+    table->bucket_count = EXPR_HASH_SIZE;
     return table;
 }
 
@@ -194,7 +204,7 @@ static void expr_table_free(CnIrExprTable *table) {
     if (!table) return;
     
     // 释放所有桶中的链表节点
-    for (int i = 0; i < EXPR_HASH_SIZE; i++) {
+    for (size_t i = 0; i < table->bucket_count; i++) {
         CnIrExprEntry *entry = table->buckets[i];
         while (entry) {
             CnIrExprEntry *next = entry->next;
@@ -203,6 +213,7 @@ static void expr_table_free(CnIrExprTable *table) {
         }
     }
     
+    free(table->buckets);
     free(table);
 }
 
@@ -216,7 +227,7 @@ static void expr_table_free(CnIrExprTable *table) {
 static CnIrExprEntry *expr_table_lookup(CnIrExprTable *table, CnIrExprKey *key) {
     if (!table || !key) return NULL;
     
-    unsigned int idx = expr_key_hash(key);
+    size_t idx = expr_key_hash(key) & (table->bucket_count - 1);
     CnIrExprEntry *entry = table->buckets[idx];
     
     // 遍历链表查找匹配项
@@ -230,6 +241,33 @@ static CnIrExprEntry *expr_table_lookup(CnIrExprTable *table, CnIrExprKey *key)
     return NULL;
 }
 
+/**
+ * @brief 哈希表桶数量翻倍并重新分布表项
+ * 
+ * 同一张表中的键互不相同，重新分布不影响查找结果；内存不足时保持原大小
+ * 
+ * @param table 哈希表
+ */
+static void expr_table_grow(CnIrExprTable *table) {
+    size_t bucket_count = table->bucket_count * 2;
+    CnIrExprEntry **buckets = (CnIrExprEntry **)calloc(bucket_count, sizeof(CnIrExprEntry *));
+    if (!buckets) return;
+    
+    for (size_t i = 0; i < table->bucket_count; i++) {
+        CnIrExprEntry *entry = table->buckets[i];
+        while (entry) {
+            CnIrExprEntry *next = entry->next;
+            size_t idx = expr_key_hash(&entry->key) & (bucket_count - 1);
+            entry->next = buckets[idx];
+            buckets[idx] = entry;
+            entry = next;
+        }
+    }
+    free(table->buckets);
+    table->buckets = buckets;
+    table->bucket_count = bucket_count;
+}
+
 /**
  * @brief 向哈希表插入表达式
  * 
@@ -242,7 +280,11 @@ static void expr_table_insert(CnIrExprTable *table, CnIrExprKey *key,
                                int result_reg, CnIrInst *inst) {
     if (!table || !key) return;
     
-    unsigned int idx = expr_key_hash(key);
+    // 表项数超过桶数时扩容，保持链表平均长度为常数（生成代码中的长表达式会在一个基本块内产生大量表项）
+    if (table->entry_count >= table->bucket_count) {
+        expr_table_grow(table);
+    }
+    size_t idx = expr_key_hash(key) & (table->bucket_count - 1);
     
     // 创建新表项
     CnIrExprEntry *entry = (CnIrExprEntry *)malloc(sizeof(CnIrExprEntry));
@@ -253,6 +295,7 @@ static void expr_table_insert(CnIrExprTable *table, CnIrExprKey *key,
     // 插入到链表头部
     entry->next = table->buckets[idx];
     table->buckets[idx] = entry;
+    table->entry_count++;
 }
 
 /**
@@ -264,7 +307,7 @@ static void expr_table_clear(CnIrExprTable *table) {
     if (!table) return;
     
     // 释放所有桶中的链表节点
-    for (int i = 0; i < EXPR_HASH_SIZE; i++) {
+    for (size_t i = 0; table->entry_count > 0 && i < table->bucket_count; i++) {
         CnIrExprEntry *entry = table->buckets[i];
         while (entry) {
             CnIrExprEntry *next = entry->next;
@@ -273,6 +316,17 @@ static void expr_table_clear(CnIrExprTable *table) {
         }
         table->buckets[i] = NULL;
     }
+    table->entry_count = 0;
+    
+    // 扩容过的表恢复初始大小，避免之后每次清空都遍历大桶数组
+    if (table->bucket_count > EXPR_HASH_SIZE) {
+        CnIrExprEntry **buckets = (CnIrExprEntry **)calloc(EXPR_HASH_SIZE, sizeof(CnIrExprEntry *));
+        if (buckets) {
+            free(table->buckets);
+            table->buckets = buckets;
+            table->bucket_count = EXPR_HASH_SIZE;
+        }
+    }
 }
 
 /* ========== CSE核心逻辑 ========== */
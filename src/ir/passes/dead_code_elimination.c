@@ -1,21 +1,48 @@
 #include "cnlang/ir/pass.h"
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdbool.h>
 
-static void mark_reachable(CnIrBasicBlock *block, bool *reachable, CnIrBasicBlock **blocks, int count) {
-    int idx = -1;
-    for (int i = 0; i < count; i++) {
-        if (blocks[i] == block) {
-            idx = i;
-            break;
-        }
-    }
-    if (idx == -1 || reachable[idx]) return;
-    reachable[idx] = true;
+// 基本块按地址排序，便于由块指针二分查找下标
+static int compare_block_address(const void *a, const void *b) {
+    uintptr_t x = (uintptr_t)*(CnIrBasicBlock *const *)a;
+    uintptr_t y = (uintptr_t)*(CnIrBasicBlock *const *)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static int find_block_index(CnIrBasicBlock *block, CnIrBasicBlock **blocks, int count) {
+    CnIrBasicBlock **found = bsearch(&block, blocks, (size_t)count, sizeof(CnIrBasicBlock *),
+                                     compare_block_address);
+    return found ? (int)(found - blocks) : -1;
+}
 
-    for (CnIrBasicBlockList *succ = block->succs; succ; succ = succ->next) {
-        mark_reachable(succ->block, reachable, blocks, count);
+// 显式栈深度优先标记：生成代码中的 "否则 如果" 长链使 CFG 深达数十万层，递归会耗尽调用栈
+static void mark_reachable(CnIrBasicBlock *entry, bool *reachable, CnIrBasicBlock **blocks, int count) {
+    CnIrBasicBlock **stack = malloc(sizeof(CnIrBasicBlock *) * count);
+    int top = 0;
+    int idx = find_block_index(entry, blocks, count);
+
+    if (!stack) {
+        // 内存不足时保守地视所有块为可达
+        for (int i = 0; i < count; i++) reachable[i] = true;
+        return;
+    }
+    if (idx != -1) {
+        reachable[idx] = true;
+        stack[top++] = entry;
+    }
+    // 每个块入栈前先标记，栈深不超过块数
+    while (top > 0) {
+        CnIrBasicBlock *block = stack[--top];
+        for (CnIrBasicBlockList *succ = block->succs; succ; succ = succ->next) {
+            idx = find_block_index(succ->block, blocks, count);
+            if (idx != -1 && !reachable[idx]) {
+                reachable[idx] = true;
+                stack[top++] = succ->block;
+            }
+        }
     }
+    free(stack);
 }
 
 void cn_ir_pass_dead_code_elimination(CnIrModule *module) {
@@ -33,6 +60,7 @@ void cn_ir_pass_dead_code_elimination(CnIrModule *module) {
         
         int i = 0;
         for (CnIrBasicBlock *b = func->first_block; b; b = b->next) blocks[i++] = b;
+        qsort(blocks, block_count, sizeof(CnIrBasicBlock *), compare_block_address);
 
         // 2. 从入口块开始标记可达性
         mark_reachable(func->first_block, reachable, blocks, block_count);
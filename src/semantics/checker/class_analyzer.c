@@ -10,6 +10,7 @@
  */
 
 #include "cnlang/semantics/class_analyzer.h"
+#include "cnlang/semantics/inheritance_resolver.h"
 #include "cnlang/frontend/ast.h"
 #include "cnlang/semantics/template.h"  // 阶段17 - 接口模板参数支持
 #include <stdlib.h>
@@ -153,6 +154,7 @@ bool cn_class_analyzer_context_init(CnClassAnalyzerContext *ctx,
     ctx->current_access = CN_ACCESS_PRIVATE;  /* 类成员默认私有 */
     ctx->diagnostics = diagnostics;
     ctx->program = program;
+    ctx->hierarchy = NULL;
     
     return true;
 }
@@ -167,6 +169,7 @@ void cn_class_analyzer_context_cleanup(CnClassAnalyzerContext *ctx)
     ctx->current_class = NULL;
     ctx->current_member = NULL;
     ctx->diagnostics = NULL;
+    ctx->hierarchy = NULL;
 }
 
 /* ============================================================================
@@ -853,6 +856,26 @@ bool cn_check_method_return_type(CnClassAnalyzerContext *ctx, CnClassMember *mem
     return true;
 }
 
+/**
+ * @brief 查找被重写的虚函数（辅助函数）
+ *
+ * 有类层次缓存时直接查当前类的方法槽位表，否则逐级在程序中查找基类
+ */
+static CnClassMember *cn_find_overridden_virtual(CnClassAnalyzerContext *ctx, CnClassMember *member)
+{
+    if (!member->name) {
+        return NULL;
+    }
+    
+    if (ctx->hierarchy && cn_inheritance_resolver_node_of(ctx->hierarchy, ctx->current_class)) {
+        const CnMethodSlot *slot = cn_inheritance_resolver_find_method_slot(
+            ctx->hierarchy, ctx->current_class, member->name, strlen(member->name));
+        return slot ? slot->virtual_method : NULL;
+    }
+    
+    return cn_find_virtual_member(ctx->current_class, member->name, ctx->program);
+}
+
 /**
  * @brief 检查方法重写有效性
  */
@@ -874,7 +897,7 @@ bool cn_check_method_override(CnClassAnalyzerContext *ctx, CnClassMember *member
     }
     
     /* 在基类中查找同名虚函数（与C++语义一致：重写必须是虚函数才能参与多态） */
-    CnClassMember *base_method = cn_find_virtual_member(ctx->current_class, member->name, ctx->program);
+    CnClassMember *base_method = cn_find_overridden_virtual(ctx, member);
     if (!base_method) {
         report_error(ctx, "重写的函数在基类中不是虚函数", member->name, member->name_length);
         return false;
@@ -1230,6 +1253,20 @@ bool cn_analyze_all_classes(CnSemScope *global_scope,
         return false;
     }
     
+    /* 一次性计算类层次缓存（祖先位集与方法槽位表），重写检查不再逐级查找基类 */
+    CnInheritanceResolver *hierarchy = cn_inheritance_resolver_create(diagnostics);
+    if (hierarchy) {
+        for (size_t i = 0; i < program->class_count; i++) {
+            CnAstStmt *stmt = program->classes[i];
+            if (stmt && stmt->kind == CN_AST_STMT_CLASS_DECL) {
+                cn_inheritance_resolver_register(hierarchy, stmt->as.class_decl);
+            }
+        }
+        if (cn_inheritance_resolver_build_hierarchy(hierarchy)) {
+            ctx.hierarchy = hierarchy;
+        }
+    }
+    
     bool all_success = true;
     
     /* 分析所有类声明 */
@@ -1254,6 +1291,7 @@ bool cn_analyze_all_classes(CnSemScope *global_scope,
     
     /* 清理上下文 */
     cn_class_analyzer_context_cleanup(&ctx);
+    cn_inheritance_resolver_destroy(hierarchy);
     
     return all_success;
 }
@@ -3,8 +3,11 @@
 #include "cnlang/semantics/class_analyzer.h"
 #include "cnlang/semantics/template.h"  // 用于 cn_type_get_name 函数
 #include "cnlang/support/diagnostics.h"
+#include "cnlang/support/string_pool.h"
+#include "cnlang/support/thread.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 static CnType *infer_expr_type(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics *diagnostics);
 static void check_stmt_types(CnSemScope *scope, CnAstStmt *stmt, CnDiagnostics *diagnostics, bool in_loop);
@@ -157,11 +160,25 @@ static void resolve_stmt_names(CnSemScope *scope, CnAstStmt *stmt, CnDiagnostics
         case CN_AST_STMT_RETURN:
             resolve_expr_names(scope, stmt->as.return_stmt.expr, diagnostics);
             break;
-        case CN_AST_STMT_IF:
-            resolve_expr_names(scope, stmt->as.if_stmt.condition, diagnostics);
-            resolve_block_names(scope, stmt->as.if_stmt.then_block, diagnostics);
-            resolve_block_names(scope, stmt->as.if_stmt.else_block, diagnostics);
+        case CN_AST_STMT_IF: {
+            // "否则 如果" 链循环处理，不逐段递归
+            CnAstIfStmt *if_stmt = &stmt->as.if_stmt;
+            for (;;) {
+                CnAstStmt *else_if = cn_frontend_ast_else_if(if_stmt);
+                resolve_expr_names(scope, if_stmt->condition, diagnostics);
+                resolve_block_names(scope, if_stmt->then_block, diagnostics);
+                if (!else_if) {
+                    resolve_block_names(scope, if_stmt->else_block, diagnostics);
+                    break;
+                }
+                // 否则块只含这条如果语句，沿用它的块作用域
+                if (if_stmt->else_block->owning_scope) {
+                    scope = if_stmt->else_block->owning_scope;
+                }
+                if_stmt = &else_if->as.if_stmt;
+            }
             break;
+        }
         case CN_AST_STMT_WHILE:
             resolve_expr_names(scope, stmt->as.while_stmt.condition, diagnostics);
             resolve_block_names(scope, stmt->as.while_stmt.body, diagnostics);
@@ -193,7 +210,7 @@ static void resolve_expr_names(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics
     if (!expr) return;
     switch (expr->kind) {
         case CN_AST_EXPR_IDENTIFIER: {
-            CnSemSymbol *sym = cn_sem_scope_lookup(scope, expr->as.identifier.name, expr->as.identifier.name_length);
+            CnSemSymbol *sym = cn_sem_scope_lookup_identifier(scope, expr);
             if (!sym) {
                 // 检查是否是类型名（结构体/枚举），用于构造函数调用
                 // 例如：点 p(10, 20); 其中 "点" 是类型名
@@ -203,9 +220,19 @@ static void resolve_expr_names(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics
             break;
         }
         case CN_AST_EXPR_BINARY:
-            resolve_expr_names(scope, expr->as.binary.left, diagnostics);
-            resolve_expr_names(scope, expr->as.binary.right, diagnostics);
+        case CN_AST_EXPR_LOGICAL: {
+            // 左结合长链先收集再自底向上处理，保持先左后右的顺序
+            CnAstExprChain chain;
+            if (!cn_frontend_ast_expr_chain_collect(&chain, expr)) {
+                break;
+            }
+            resolve_expr_names(scope, cn_frontend_ast_expr_chain_leaf(&chain), diagnostics);
+            for (size_t i = chain.count; i-- > 0;) {
+                resolve_expr_names(scope, cn_frontend_ast_expr_chain_right(&chain, i), diagnostics);
+            }
+            cn_frontend_ast_expr_chain_free(&chain);
             break;
+        }
         case CN_AST_EXPR_CALL:
             resolve_expr_names(scope, expr->as.call.callee, diagnostics);
             for (size_t i = 0; i < expr->as.call.argument_count; i++) {
@@ -216,10 +243,6 @@ static void resolve_expr_names(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics
             resolve_expr_names(scope, expr->as.assign.target, diagnostics);
             resolve_expr_names(scope, expr->as.assign.value, diagnostics);
             break;
-        case CN_AST_EXPR_LOGICAL:
-            resolve_expr_names(scope, expr->as.logical.left, diagnostics);
-            resolve_expr_names(scope, expr->as.logical.right, diagnostics);
-            break;
         case CN_AST_EXPR_UNARY:
             resolve_expr_names(scope, expr->as.unary.operand, diagnostics);
             break;
@@ -285,13 +308,11 @@ static void resolve_expr_names(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics
     }
 }
 
-// 类型检查语义 pass
-bool cn_sem_check_types(CnSemScope *global_scope,
-                        CnAstProgram *program,
-                        struct CnDiagnostics *diagnostics)
+// 类型检查的准备阶段（始终串行）：类成员、全局变量类型与函数返回类型推断
+static void check_types_prepare(CnSemScope *global_scope,
+                                CnAstProgram *program,
+                                CnDiagnostics *diagnostics)
 {
-    if (!program || !global_scope) return true;
-
     // 分析所有类的成员变量（阶段二 - 类语义分析）
     cn_analyze_all_classes(global_scope, program, diagnostics);
 
@@ -393,7 +414,9 @@ bool cn_sem_check_types(CnSemScope *global_scope,
         }
         
         // 如果没有显式类型且有初始化表达式，从初始化表达式推断类型
-        if (!var_decl->declared_type && var_decl->initializer) {
+        // （嵌入资源的声明类型已在作用域构建时检查）
+        if (!var_decl->declared_type && var_decl->initializer &&
+            var_decl->initializer->kind != CN_AST_EXPR_EMBED) {
             CnType *init_type = infer_expr_type(global_scope, var_decl->initializer, diagnostics);
             if (init_type) {
                 var_decl->declared_type = init_type;
@@ -432,29 +455,212 @@ bool cn_sem_check_types(CnSemScope *global_scope,
                 // 更新函数符号的返回类型
                 CnSemSymbol *fn_sym = cn_sem_scope_lookup(global_scope, fn->name, fn->name_length);
                 if (fn_sym && fn_sym->type && fn_sym->type->kind == CN_TYPE_FUNCTION) {
-                    fn_sym->type->as.function.return_type = inferred_return_type;
+                    // 函数类型是共享的规范节点，不能原地修改，以推断出的返回类型重新构造
+                    fn_sym->type = cn_type_new_function(inferred_return_type,
+                                                        fn_sym->type->as.function.param_types,
+                                                        fn_sym->type->as.function.param_count);
                 }
             }
         }
         // 【注意】不再释放 fn_scope，它由 AST 节点拥有
     }
+}
+
+// 阶段2：检查单个函数体
+// 只向函数自己的块作用域插入符号，全局与模块作用域只读，因此不同函数可以并行检查
+static void check_function_body(CnAstFunctionDecl *fn, CnDiagnostics *diagnostics)
+{
+    // 【关键修改】使用 AST 节点中保存的作用域（由 scope_builder 创建）
+    CnSemScope *fn_scope = fn->owning_scope;
+    if (!fn_scope) {
+        // 如果没有作用域（可能是函数原型），跳过
+        return;
+    }
+
+    check_block_types(fn_scope, fn->body, diagnostics, false);
+    // 【注意】不再释放 fn_scope，它由 AST 节点拥有
+}
+
+// 类型检查语义 pass
+bool cn_sem_check_types(CnSemScope *global_scope,
+                        CnAstProgram *program,
+                        struct CnDiagnostics *diagnostics)
+{
+    if (!program || !global_scope) return true;
+
+    check_types_prepare(global_scope, program, diagnostics);
 
     // 阶段2：进行函数体内部的完整类型检查
     // 此时所有函数的返回类型已经推断完成
-
-    // 检查全局函数
     for (size_t i = 0; i < program->function_count; ++i) {
-        CnAstFunctionDecl *fn = program->functions[i];
-        
-        // 【关键修改】使用 AST 节点中保存的作用域（由 scope_builder 创建）
-        CnSemScope *fn_scope = fn->owning_scope;
-        if (!fn_scope) {
-            // 如果没有作用域（可能是函数原型），跳过
-            continue;
+        check_function_body(program->functions[i], diagnostics);
+    }
+
+    return cn_support_diagnostics_error_count(diagnostics) == 0;
+}
+
+// 函数数少于该值时并行检查的线程开销超过收益
+#define CN_SEM_PARALLEL_MIN_FUNCTIONS 32
+
+// 并行检查的共享任务
+typedef struct CnSemParallelJob {
+    CnAstProgram *program;
+    CnDiagnostics *buffers;          // 每个函数一份诊断缓冲区
+    CnTypePatchLog **patch_logs;     // 每个函数一份类型补全日志
+    CnSemScope **last_scopes;        // 每个函数检查结束时的动态解析作用域
+    size_t next_function;            // 下一个待检查的函数下标
+    CnMutex lock;                    // 保护 next_function
+} CnSemParallelJob;
+
+// 工作线程：逐个领取函数并检查，诊断与类型补全都写入该函数自己的缓冲区
+static void check_types_worker(void *arg)
+{
+    CnSemParallelJob *job = (CnSemParallelJob *)arg;
+
+    for (;;) {
+        size_t index;
+
+        cn_mutex_lock(&job->lock);
+        index = job->next_function++;
+        cn_mutex_unlock(&job->lock);
+        if (index >= job->program->function_count) {
+            break;
         }
 
-        check_block_types(fn_scope, fn->body, diagnostics, false);
-        // 【注意】不再释放 fn_scope，它由 AST 节点拥有
+        cn_type_set_patch_log(job->patch_logs[index]);
+        cn_type_set_resolution_scope(NULL);
+        check_function_body(job->program->functions[index], &job->buffers[index]);
+        job->last_scopes[index] = cn_type_get_resolution_scope();
+    }
+    cn_type_set_patch_log(NULL);
+}
+
+// 把 src 中的诊断按顺序追加到 dst
+static void diagnostics_append(CnDiagnostics *dst, const CnDiagnostics *src)
+{
+    for (size_t i = 0; i < src->count; i++) {
+        const CnDiagnostic *item = &src->items[i];
+        cn_support_diagnostics_report(dst, item->severity, item->code, item->filename,
+                                      item->line, item->column, item->message);
+    }
+}
+
+// 在 thread_count 个线程（含调用线程）中检查全部函数体；资源不足、未开始检查时返回 false
+static bool check_functions_parallel(CnAstProgram *program,
+                                     CnDiagnostics *diagnostics,
+                                     unsigned thread_count)
+{
+    size_t count = program->function_count;
+    CnSemScope *resolution_scope = cn_type_get_resolution_scope();
+    CnSemParallelJob job;
+    CnThread *threads;
+    unsigned started = 0;
+    bool lock_ready = false;
+    bool ok;
+
+    memset(&job, 0, sizeof(job));
+    job.program = program;
+    job.buffers = (CnDiagnostics *)calloc(count, sizeof(CnDiagnostics));
+    job.patch_logs = (CnTypePatchLog **)calloc(count, sizeof(CnTypePatchLog *));
+    job.last_scopes = (CnSemScope **)calloc(count, sizeof(CnSemScope *));
+    threads = (CnThread *)calloc(thread_count - 1, sizeof(CnThread));
+    ok = job.buffers && job.patch_logs && job.last_scopes && threads;
+    for (size_t i = 0; ok && i < count; i++) {
+        cn_support_diagnostics_init(&job.buffers[i]);
+        job.patch_logs[i] = cn_type_patch_log_new();
+        ok = job.patch_logs[i] != NULL;
+    }
+    if (ok) {
+        ok = lock_ready = cn_mutex_init(&job.lock);
+    }
+
+    // 全局与模块作用域已经建好，检查期间共享的字符串池与类型上下文冻结为只读
+    if (ok) {
+        ok = cn_string_pool_begin_concurrent(cn_string_pool_default());
+        if (ok && !cn_type_context_begin_concurrent(cn_type_context_default())) {
+            cn_string_pool_end_concurrent(cn_string_pool_default());
+            ok = false;
+        }
+    }
+
+    if (ok) {
+        // 线程启动失败时由已启动的线程与调用线程完成剩余函数
+        for (unsigned i = 0; i + 1 < thread_count; i++) {
+            if (!cn_thread_start(&threads[started], check_types_worker, &job)) {
+                break;
+            }
+            started++;
+        }
+        check_types_worker(&job);
+        for (unsigned i = 0; i < started; i++) {
+            cn_thread_join(&threads[i]);
+        }
+        cn_type_context_end_concurrent(cn_type_context_default());
+        cn_string_pool_end_concurrent(cn_string_pool_default());
+
+        // 按函数顺序应用类型补全并合并诊断，结果与串行检查相同
+        for (size_t i = 0; i < count; i++) {
+            cn_type_patch_log_apply(job.patch_logs[i]);
+            diagnostics_append(diagnostics, &job.buffers[i]);
+            if (job.last_scopes[i]) {
+                resolution_scope = job.last_scopes[i];
+            }
+        }
+        cn_type_set_resolution_scope(resolution_scope);
+    }
+
+    if (lock_ready) {
+        cn_mutex_destroy(&job.lock);
+    }
+    for (size_t i = 0; job.buffers && job.patch_logs && i < count; i++) {
+        cn_support_diagnostics_free(&job.buffers[i]);
+        cn_type_patch_log_free(job.patch_logs[i]);
+    }
+    free(job.buffers);
+    free(job.patch_logs);
+    free(job.last_scopes);
+    free(threads);
+    return ok;
+}
+
+void cn_sem_parallel_options_default(CnSemParallelOptions *options)
+{
+    if (!options) {
+        return;
+    }
+    options->thread_count = 0;
+    options->min_function_count = CN_SEM_PARALLEL_MIN_FUNCTIONS;
+}
+
+// 并行类型检查语义 pass
+bool cn_sem_check_types_parallel(CnSemScope *global_scope,
+                                 CnAstProgram *program,
+                                 struct CnDiagnostics *diagnostics,
+                                 const CnSemParallelOptions *options)
+{
+    CnSemParallelOptions defaults;
+    unsigned thread_count;
+
+    if (!program || !global_scope) return true;
+    if (!options) {
+        cn_sem_parallel_options_default(&defaults);
+        options = &defaults;
+    }
+
+    thread_count = options->thread_count > 0 ? options->thread_count : cn_thread_cpu_count();
+    if (thread_count > program->function_count) {
+        thread_count = (unsigned)program->function_count;
+    }
+    if (thread_count <= 1 || program->function_count < options->min_function_count) {
+        return cn_sem_check_types(global_scope, program, diagnostics);
+    }
+
+    check_types_prepare(global_scope, program, diagnostics);
+    if (!check_functions_parallel(program, diagnostics, thread_count)) {
+        // 资源不足时退回串行检查
+        for (size_t i = 0; i < program->function_count; ++i) {
+            check_function_body(program->functions[i], diagnostics);
+        }
     }
 
     return cn_support_diagnostics_error_count(diagnostics) == 0;
@@ -684,12 +890,25 @@ static void check_stmt_types(CnSemScope *scope, CnAstStmt *stmt, CnDiagnostics *
             infer_expr_type(scope, stmt->as.return_stmt.expr, diagnostics);
             break;
         case CN_AST_STMT_IF: {
-            CnType *cond_type = infer_expr_type(scope, stmt->as.if_stmt.condition, diagnostics);
-            // 条件表达式可以是布尔、整数或指针类型（与C语言兼容）
-            // 不再强制要求布尔类型
-            (void)cond_type;  // 避免未使用警告
-            check_block_types(scope, stmt->as.if_stmt.then_block, diagnostics, in_loop);
-            check_block_types(scope, stmt->as.if_stmt.else_block, diagnostics, in_loop);
+            // "否则 如果" 链循环处理，不逐段递归
+            CnAstIfStmt *if_stmt = &stmt->as.if_stmt;
+            for (;;) {
+                CnAstStmt *else_if = cn_frontend_ast_else_if(if_stmt);
+                CnType *cond_type = infer_expr_type(scope, if_stmt->condition, diagnostics);
+                // 条件表达式可以是布尔、整数或指针类型（与C语言兼容）
+                // 不再强制要求布尔类型
+                (void)cond_type;  // 避免未使用警告
+                check_block_types(scope, if_stmt->then_block, diagnostics, in_loop);
+                if (!else_if) {
+                    check_block_types(scope, if_stmt->else_block, diagnostics, in_loop);
+                    break;
+                }
+                // 否则块只含这条如果语句，沿用它的块作用域
+                if (if_stmt->else_block->owning_scope) {
+                    scope = if_stmt->else_block->owning_scope;
+                }
+                if_stmt = &else_if->as.if_stmt;
+            }
             break;
         }
         case CN_AST_STMT_WHILE: {
@@ -807,7 +1026,7 @@ static void check_stmt_types(CnSemScope *scope, CnAstStmt *stmt, CnDiagnostics *
                         const char *name = case_stmt->value->as.identifier.name;
                         size_t name_len = case_stmt->value->as.identifier.name_length;
                         if (name && name_len > 0) {
-                            CnSemSymbol *sym = cn_sem_scope_lookup(scope, name, name_len);
+                            CnSemSymbol *sym = cn_sem_scope_lookup_identifier(scope, case_stmt->value);
                             if (sym && sym->kind == CN_SEM_SYMBOL_ENUM_MEMBER) {
                                 case_value = sym->as.enum_value;
                                 can_get_value = 1;
@@ -989,6 +1208,26 @@ static void check_stmt_types(CnSemScope *scope, CnAstStmt *stmt, CnDiagnostics *
  * @param expr 要判断的表达式
  * @return 1 表示是常量表达式，0 表示不是
  */
+// 二元/逻辑运算链：链上每个运算的两个操作数都是常量则为常量（长链循环处理，不逐层递归）
+static int cn_sem_is_const_chain(CnSemScope *scope, CnAstExpr *expr) {
+    CnAstExprChain chain;
+    int is_const;
+
+    if (!cn_frontend_ast_expr_chain_collect(&chain, expr)) {
+        return 0;
+    }
+    is_const = cn_frontend_ast_expr_chain_leaf(&chain) != NULL;
+    for (size_t i = 0; is_const && i < chain.count; i++) {
+        is_const = cn_frontend_ast_expr_chain_right(&chain, i) != NULL;
+    }
+    is_const = is_const && cn_sem_is_const_expr(scope, cn_frontend_ast_expr_chain_leaf(&chain));
+    for (size_t i = chain.count; is_const && i-- > 0;) {
+        is_const = cn_sem_is_const_expr(scope, cn_frontend_ast_expr_chain_right(&chain, i));
+    }
+    cn_frontend_ast_expr_chain_free(&chain);
+    return is_const;
+}
+
 static int cn_sem_is_const_expr(CnSemScope *scope, CnAstExpr *expr) {
     // 空表达式或空作用域不是常量
     if (!expr || !scope) return 0;
@@ -1010,7 +1249,7 @@ static int cn_sem_is_const_expr(CnSemScope *scope, CnAstExpr *expr) {
             // 空名称不是常量
             if (!name || name_len == 0) return 0;
             
-            CnSemSymbol *sym = cn_sem_scope_lookup(scope, name, name_len);
+            CnSemSymbol *sym = cn_sem_scope_lookup_identifier(scope, expr);
             
             // 未定义的符号不是常量
             if (!sym) return 0;
@@ -1031,9 +1270,7 @@ static int cn_sem_is_const_expr(CnSemScope *scope, CnAstExpr *expr) {
         // 3. 二元运算：两个操作数都是常量则为常量
         // 包括：算术运算（加减乘除取模）、位运算（与或非异或移位）、比较运算
         case CN_AST_EXPR_BINARY: {
-            return expr->as.binary.left && expr->as.binary.right &&
-                   cn_sem_is_const_expr(scope, expr->as.binary.left) &&
-                   cn_sem_is_const_expr(scope, expr->as.binary.right);
+            return cn_sem_is_const_chain(scope, expr);
         }
         
         // 4. 一元运算：操作数是常量则为常量
@@ -1067,9 +1304,7 @@ static int cn_sem_is_const_expr(CnSemScope *scope, CnAstExpr *expr) {
         
         // 6. 逻辑运算：两个操作数都是常量则为常量
         case CN_AST_EXPR_LOGICAL: {
-            return expr->as.logical.left && expr->as.logical.right &&
-                   cn_sem_is_const_expr(scope, expr->as.logical.left) &&
-                   cn_sem_is_const_expr(scope, expr->as.logical.right);
+            return cn_sem_is_const_chain(scope, expr);
         }
         
         // 7. 成员访问：枚举成员访问是常量
@@ -1079,7 +1314,7 @@ static int cn_sem_is_const_expr(CnSemScope *scope, CnAstExpr *expr) {
                 const char *name = expr->as.member.object->as.identifier.name;
                 size_t name_len = expr->as.member.object->as.identifier.name_length;
                 if (name && name_len > 0) {
-                    CnSemSymbol *obj_sym = cn_sem_scope_lookup(scope, name, name_len);
+                    CnSemSymbol *obj_sym = cn_sem_scope_lookup_identifier(scope, expr->as.member.object);
                     
                     // 如果对象是枚举类型，则成员访问是常量
                     if (obj_sym && obj_sym->kind == CN_SEM_SYMBOL_ENUM) {
@@ -1111,10 +1346,17 @@ static int cn_sem_is_const_expr(CnSemScope *scope, CnAstExpr *expr) {
             return 1;  // 所有字段都是常量
         }
         
-        // 9. 以下表达式类型不是常量
+        // 9. 数组字面量：元素全部为常量字面量时为常量（IR 中整体打包为常量数组）
+        case CN_AST_EXPR_ARRAY_LITERAL:
+            return cn_frontend_ast_array_literal_is_constant(expr);
+
+        // 嵌入资源：文件内容在编译时读入
+        case CN_AST_EXPR_EMBED:
+            return 1;
+        
+        // 10. 以下表达式类型不是常量
         case CN_AST_EXPR_CALL:           // 函数调用
         case CN_AST_EXPR_ASSIGN:         // 赋值表达式
-        case CN_AST_EXPR_ARRAY_LITERAL:  // 数组字面量（暂不认为是常量）
         case CN_AST_EXPR_INDEX:          // 数组索引
         case CN_AST_EXPR_MEMORY_READ:    // 内存读取
         case CN_AST_EXPR_MEMORY_WRITE:   // 内存写入
@@ -1131,6 +1373,173 @@ static int cn_sem_is_const_expr(CnSemScope *scope, CnAstExpr *expr) {
     }
 }
 
+// 由左右操作数的类型确定二元运算的结果类型
+static void infer_binary_result(CnAstExpr *expr, CnType *left, CnType *right) {
+    // 指针加减运算：指针 +/- 整数
+    if ((expr->as.binary.op == CN_AST_BINARY_OP_ADD ||
+         expr->as.binary.op == CN_AST_BINARY_OP_SUB) &&
+        left && right) {
+        if (left->kind == CN_TYPE_POINTER && right->kind == CN_TYPE_INT) {
+            expr->type = left;
+            return;
+        }
+        if (expr->as.binary.op == CN_AST_BINARY_OP_ADD &&
+            left->kind == CN_TYPE_INT && right->kind == CN_TYPE_POINTER) {
+            expr->type = right;
+            return;
+        }
+    }
+    
+    // 指针与整数的比较运算（特别是指针与"无"的比较）
+    // 比较运算符（==, !=, <, >, <=, >=）在指针与整数之间应该返回布尔类型
+    if ((expr->as.binary.op >= CN_AST_BINARY_OP_EQ && expr->as.binary.op <= CN_AST_BINARY_OP_GE) &&
+        left && right) {
+        bool left_is_pointer_or_int = (left->kind == CN_TYPE_POINTER || left->kind == CN_TYPE_INT);
+        bool right_is_pointer_or_int = (right->kind == CN_TYPE_POINTER || right->kind == CN_TYPE_INT);
+        bool left_is_pointer = (left->kind == CN_TYPE_POINTER);
+        bool right_is_pointer = (right->kind == CN_TYPE_POINTER);
+        
+        // 如果一个是指针，另一个是整数或指针，比较结果为布尔类型
+        if ((left_is_pointer && right_is_pointer_or_int) ||
+            (right_is_pointer && left_is_pointer_or_int)) {
+            expr->type = cn_type_new_primitive(CN_TYPE_BOOL);
+            return;
+        }
+    }
+    
+    // 整数、浮点数、枚举类型的混合运算
+    if (left && right) {
+        CnTypeKind result_kind = CN_TYPE_UNKNOWN;
+        
+        // 检查是否为数值类型（整数、浮点、枚举）
+        bool left_is_numeric = (left->kind == CN_TYPE_INT || left->kind == CN_TYPE_FLOAT || left->kind == CN_TYPE_ENUM);
+        bool right_is_numeric = (right->kind == CN_TYPE_INT || right->kind == CN_TYPE_FLOAT || right->kind == CN_TYPE_ENUM);
+        
+        if (left_is_numeric && right_is_numeric) {
+            // 如果任一操作数是 float，结果为 float；否则为 int
+            if (left->kind == CN_TYPE_FLOAT || right->kind == CN_TYPE_FLOAT) {
+                result_kind = CN_TYPE_FLOAT;
+            } else {
+                result_kind = CN_TYPE_INT;
+            }
+            
+            // 比较运算符返回布尔类型
+            if (expr->as.binary.op >= CN_AST_BINARY_OP_EQ && expr->as.binary.op <= CN_AST_BINARY_OP_GE) {
+                expr->type = cn_type_new_primitive(CN_TYPE_BOOL);
+            } else {
+                expr->type = cn_type_new_primitive(result_kind);
+            }
+            return;
+        }
+    }
+    
+    // 特殊处理：字符串比较运算（字符串 == 字符串 等）
+    if (left && right) {
+        bool left_is_string = (left->kind == CN_TYPE_STRING);
+        bool right_is_string = (right->kind == CN_TYPE_STRING);
+        
+        // 如果两个操作数都是字符串，比较运算符返回布尔类型
+        if (left_is_string && right_is_string) {
+            if (expr->as.binary.op >= CN_AST_BINARY_OP_EQ && expr->as.binary.op <= CN_AST_BINARY_OP_GE) {
+                expr->type = cn_type_new_primitive(CN_TYPE_BOOL);
+                return;
+            }
+        }
+    }
+    
+    // 特殊处理：字符串拼接（字符串 + 任何类型）
+    if (expr->as.binary.op == CN_AST_BINARY_OP_ADD) {
+        // 如果任一操作数是字符串，则结果为字符串类型
+        if ((left && left->kind == CN_TYPE_STRING) || (right && right->kind == CN_TYPE_STRING)) {
+            expr->type = cn_type_new_primitive(CN_TYPE_STRING);
+            return;
+        }
+    }
+    
+    if (left && right && cn_type_compatible(left, right)) {
+        // 简单的算术运算结果类型
+        if (expr->as.binary.op >= CN_AST_BINARY_OP_EQ && expr->as.binary.op <= CN_AST_BINARY_OP_GE) {
+            expr->type = cn_type_new_primitive(CN_TYPE_BOOL);
+        } else {
+            expr->type = left;
+        }
+    } else {
+        // 比较运算符总是返回布尔类型（即使类型不兼容）
+        if (expr->as.binary.op >= CN_AST_BINARY_OP_EQ && expr->as.binary.op <= CN_AST_BINARY_OP_GE) {
+            expr->type = cn_type_new_primitive(CN_TYPE_BOOL);
+        } else {
+            expr->type = cn_type_new_primitive(CN_TYPE_UNKNOWN);
+        }
+    }
+}
+
+// 二元/逻辑运算链自底向上推断，长链（如生成代码中的 a+b+…）不逐层递归
+// 下层节点已有类型或操作数缺失时作为链底交给 infer_expr_type，与逐层递归推断的结果一致
+static void infer_operator_chain(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics *diagnostics) {
+    CnAstExprChain chain;
+    size_t count = 0;
+    CnType *left;
+
+    if (!cn_frontend_ast_expr_chain_collect(&chain, expr)) {
+        expr->type = cn_type_new_primitive(CN_TYPE_UNKNOWN);
+        return;
+    }
+    while (count < chain.count) {
+        CnAstExpr *node = chain.nodes[count];
+        if (count > 0 && node->type && node->type->kind != CN_TYPE_UNKNOWN) {
+            break;
+        }
+        if (node->kind == CN_AST_EXPR_BINARY && (!node->as.binary.left || !node->as.binary.right)) {
+            break;
+        }
+        count++;
+    }
+    if (count == 0) {
+        // 二元表达式缺少操作数
+        expr->type = cn_type_new_primitive(CN_TYPE_UNKNOWN);
+        cn_frontend_ast_expr_chain_free(&chain);
+        return;
+    }
+
+    left = infer_expr_type(scope,
+                           count < chain.count ? chain.nodes[count] : cn_frontend_ast_expr_chain_leaf(&chain),
+                           diagnostics);
+    for (size_t i = count; i-- > 0;) {
+        CnAstExpr *node = chain.nodes[i];
+        CnType *right = infer_expr_type(scope, cn_frontend_ast_expr_chain_right(&chain, i), diagnostics);
+        if (node->kind == CN_AST_EXPR_BINARY) {
+            infer_binary_result(node, left, right);
+        } else {
+            node->type = cn_type_new_primitive(CN_TYPE_BOOL);
+        }
+        left = node->type;
+    }
+    cn_frontend_ast_expr_chain_free(&chain);
+}
+
+// 数组字面量中从首元素起与首元素同类的标量字面量个数（取负的数值字面量与对应字面量同类）
+static size_t array_literal_same_kind_prefix(const CnAstExpr *expr) {
+    CnAstExpr **elements = expr->as.array_literal.elements;
+    size_t count = 0;
+    CnAstExprKind first_kind = CN_AST_EXPR_INTEGER_LITERAL;
+
+    for (; count < expr->as.array_literal.element_count; count++) {
+        const CnAstExpr *element = elements[count];
+        CnAstExprKind kind;
+        if (!element || element->kind == CN_AST_EXPR_STRUCT_LITERAL ||
+            !cn_frontend_ast_is_constant_literal(element)) {
+            break;
+        }
+        kind = element->kind == CN_AST_EXPR_UNARY ? element->as.unary.operand->kind : element->kind;
+        if (count == 0) {
+            first_kind = kind;
+        } else if (kind != first_kind) {
+            break;
+        }
+    }
+    return count;
+}
+
 static CnType *infer_expr_type(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics *diagnostics) {
     if (!expr || !scope) return NULL;
     
@@ -1208,10 +1617,10 @@ static CnType *infer_expr_type(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics
             
             // 优先查找枚举类型符号，避免返回枚举成员符号（具有整数类型）
             // 这对于成员访问表达式（如 枚举类型.成员）至关重要
-            CnSemSymbol *sym = cn_sem_scope_lookup_by_kind(scope, name, name_len, CN_SEM_SYMBOL_ENUM);
+            CnSemSymbol *sym = cn_sem_scope_lookup_identifier_by_kind(scope, expr, CN_SEM_SYMBOL_ENUM);
             if (!sym) {
                 // 如果没有找到枚举类型符号，使用普通查找
-                sym = cn_sem_scope_lookup(scope, name, name_len);
+                sym = cn_sem_scope_lookup_identifier(scope, expr);
             }
             if (sym) {
                 // 对于枚举类型符号，需要确保返回正确的枚举类型
@@ -1245,112 +1654,10 @@ static CnType *infer_expr_type(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics
             }
             break;
         }
-        case CN_AST_EXPR_BINARY: {
-            if (!expr->as.binary.left || !expr->as.binary.right) {
-                expr->type = cn_type_new_primitive(CN_TYPE_UNKNOWN);
-                break;
-            }
-            CnType *left = infer_expr_type(scope, expr->as.binary.left, diagnostics);
-            CnType *right = infer_expr_type(scope, expr->as.binary.right, diagnostics);
-            
-            // 指针加减运算：指针 +/- 整数
-            if ((expr->as.binary.op == CN_AST_BINARY_OP_ADD ||
-                 expr->as.binary.op == CN_AST_BINARY_OP_SUB) &&
-                left && right) {
-                if (left->kind == CN_TYPE_POINTER && right->kind == CN_TYPE_INT) {
-                    expr->type = left;
-                    break;
-                }
-                if (expr->as.binary.op == CN_AST_BINARY_OP_ADD &&
-                    left->kind == CN_TYPE_INT && right->kind == CN_TYPE_POINTER) {
-                    expr->type = right;
-                    break;
-                }
-            }
-            
-            // 指针与整数的比较运算（特别是指针与"无"的比较）
-            // 比较运算符（==, !=, <, >, <=, >=）在指针与整数之间应该返回布尔类型
-            if ((expr->as.binary.op >= CN_AST_BINARY_OP_EQ && expr->as.binary.op <= CN_AST_BINARY_OP_GE) &&
-                left && right) {
-                bool left_is_pointer_or_int = (left->kind == CN_TYPE_POINTER || left->kind == CN_TYPE_INT);
-                bool right_is_pointer_or_int = (right->kind == CN_TYPE_POINTER || right->kind == CN_TYPE_INT);
-                bool left_is_pointer = (left->kind == CN_TYPE_POINTER);
-                bool right_is_pointer = (right->kind == CN_TYPE_POINTER);
-                
-                // 如果一个是指针，另一个是整数或指针，比较结果为布尔类型
-                if ((left_is_pointer && right_is_pointer_or_int) ||
-                    (right_is_pointer && left_is_pointer_or_int)) {
-                    expr->type = cn_type_new_primitive(CN_TYPE_BOOL);
-                    break;
-                }
-            }
-            
-            // 整数、浮点数、枚举类型的混合运算
-            if (left && right) {
-                CnTypeKind result_kind = CN_TYPE_UNKNOWN;
-                
-                // 检查是否为数值类型（整数、浮点、枚举）
-                bool left_is_numeric = (left->kind == CN_TYPE_INT || left->kind == CN_TYPE_FLOAT || left->kind == CN_TYPE_ENUM);
-                bool right_is_numeric = (right->kind == CN_TYPE_INT || right->kind == CN_TYPE_FLOAT || right->kind == CN_TYPE_ENUM);
-                
-                if (left_is_numeric && right_is_numeric) {
-                    // 如果任一操作数是 float，结果为 float；否则为 int
-                    if (left->kind == CN_TYPE_FLOAT || right->kind == CN_TYPE_FLOAT) {
-                        result_kind = CN_TYPE_FLOAT;
-                    } else {
-                        result_kind = CN_TYPE_INT;
-                    }
-                    
-                    // 比较运算符返回布尔类型
-                    if (expr->as.binary.op >= CN_AST_BINARY_OP_EQ && expr->as.binary.op <= CN_AST_BINARY_OP_GE) {
-                        expr->type = cn_type_new_primitive(CN_TYPE_BOOL);
-                    } else {
-                        expr->type = cn_type_new_primitive(result_kind);
-                    }
-                    break;
-                }
-            }
-            
-            // 特殊处理：字符串比较运算（字符串 == 字符串 等）
-            if (left && right) {
-                bool left_is_string = (left->kind == CN_TYPE_STRING);
-                bool right_is_string = (right->kind == CN_TYPE_STRING);
-                
-                // 如果两个操作数都是字符串，比较运算符返回布尔类型
-                if (left_is_string && right_is_string) {
-                    if (expr->as.binary.op >= CN_AST_BINARY_OP_EQ && expr->as.binary.op <= CN_AST_BINARY_OP_GE) {
-                        expr->type = cn_type_new_primitive(CN_TYPE_BOOL);
-                        break;
-                    }
-                }
-            }
-            
-            // 特殊处理：字符串拼接（字符串 + 任何类型）
-            if (expr->as.binary.op == CN_AST_BINARY_OP_ADD) {
-                // 如果任一操作数是字符串，则结果为字符串类型
-                if ((left && left->kind == CN_TYPE_STRING) || (right && right->kind == CN_TYPE_STRING)) {
-                    expr->type = cn_type_new_primitive(CN_TYPE_STRING);
-                    break;
-                }
-            }
-            
-            if (left && right && cn_type_compatible(left, right)) {
-                // 简单的算术运算结果类型
-                if (expr->as.binary.op >= CN_AST_BINARY_OP_EQ && expr->as.binary.op <= CN_AST_BINARY_OP_GE) {
-                    expr->type = cn_type_new_primitive(CN_TYPE_BOOL);
-                } else {
-                    expr->type = left;
-                }
-            } else {
-                // 比较运算符总是返回布尔类型（即使类型不兼容）
-                if (expr->as.binary.op >= CN_AST_BINARY_OP_EQ && expr->as.binary.op <= CN_AST_BINARY_OP_GE) {
-                    expr->type = cn_type_new_primitive(CN_TYPE_BOOL);
-                } else {
-                    expr->type = cn_type_new_primitive(CN_TYPE_UNKNOWN);
-                }
-            }
+        case CN_AST_EXPR_BINARY:
+        case CN_AST_EXPR_LOGICAL:
+            infer_operator_chain(scope, expr, diagnostics);
             break;
-        }
         case CN_AST_EXPR_ASSIGN: {
             // 赋值：先生成右值，再 STORE 到左值地址
             CnAstExpr *target_expr = expr->as.assign.target;
@@ -1493,16 +1800,6 @@ static CnType *infer_expr_type(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics
             }
             break;
         }
-        case CN_AST_EXPR_LOGICAL: {
-            if (expr->as.logical.left) {
-                infer_expr_type(scope, expr->as.logical.left, diagnostics);
-            }
-            if (expr->as.logical.right) {
-                infer_expr_type(scope, expr->as.logical.right, diagnostics);
-            }
-            expr->type = cn_type_new_primitive(CN_TYPE_BOOL);
-            break;
-        }
         case CN_AST_EXPR_UNARY: {
             if (!expr->as.unary.operand) {
                 expr->type = cn_type_new_primitive(CN_TYPE_UNKNOWN);
@@ -1913,8 +2210,15 @@ static CnType *infer_expr_type(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics
                     element_type = infer_expr_type(scope, expr->as.array_literal.elements[0], diagnostics);
                 }
                 
+                // 大型常量表：元素都是与首元素同类的标量字面量时共用首元素类型，
+                // 不再逐个推导（每次推导都会新建类型对象）
+                size_t same_kind_count = array_literal_same_kind_prefix(expr);
+                for (size_t i = 1; i < same_kind_count; i++) {
+                    expr->as.array_literal.elements[i]->type = element_type;
+                }
+                
                 // 检查所有元素类型一致
-                for (size_t i = 1; i < expr->as.array_literal.element_count; i++) {
+                for (size_t i = same_kind_count > 1 ? same_kind_count : 1; i < expr->as.array_literal.element_count; i++) {
                     if (!expr->as.array_literal.elements[i]) continue;
                     CnType *curr_type = infer_expr_type(scope, expr->as.array_literal.elements[i], diagnostics);
                     if (curr_type && element_type && !cn_type_compatible(curr_type, element_type)) {
@@ -1990,15 +2294,16 @@ static CnType *infer_expr_type(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics
                 // 【关键修复】在成员访问上下文中，优先查找类型符号（枚举/结构体）
                 // 因为模块符号和类型符号可能同名共存
                 // 例如：词元.词元类型枚举 - 这里"词元"应该优先匹配枚举类型，而不是模块
-                CnSemSymbol *sym = cn_sem_scope_lookup_by_kind(scope, name, name_len, CN_SEM_SYMBOL_ENUM);
+                CnAstExpr *object = expr->as.member.object;
+                CnSemSymbol *sym = cn_sem_scope_lookup_identifier_by_kind(scope, object, CN_SEM_SYMBOL_ENUM);
                 if (!sym) {
-                    sym = cn_sem_scope_lookup_by_kind(scope, name, name_len, CN_SEM_SYMBOL_STRUCT);
+                    sym = cn_sem_scope_lookup_identifier_by_kind(scope, object, CN_SEM_SYMBOL_STRUCT);
                 }
                 if (!sym) {
-                    sym = cn_sem_scope_lookup_by_kind(scope, name, name_len, CN_SEM_SYMBOL_MODULE);
+                    sym = cn_sem_scope_lookup_identifier_by_kind(scope, object, CN_SEM_SYMBOL_MODULE);
                 }
                 if (!sym) {
-                    sym = cn_sem_scope_lookup(scope, name, name_len);
+                    sym = cn_sem_scope_lookup_identifier(scope, object);
                 }
                 
                 // 【调试】检查符号查找结果
@@ -2320,7 +2625,7 @@ static CnType *infer_expr_type(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics
                     if (type_sym && type_sym->type &&
                         (type_sym->kind == CN_SEM_SYMBOL_STRUCT || type_sym->kind == CN_SEM_SYMBOL_ENUM)) {
                         // 更新字段类型为符号表中的真实类型
-                        field->field_type = type_sym->type;
+                        cn_type_patch_field_type(field, type_sym->type);
                         field_type = type_sym->type;
                     }
                 }
@@ -2333,7 +2638,7 @@ static CnType *infer_expr_type(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics
                     if (type_sym && type_sym->type &&
                         type_sym->kind == CN_SEM_SYMBOL_ENUM) {
                         // 更新字段类型为符号表中的真实枚举类型
-                        field->field_type = type_sym->type;
+                        cn_type_patch_field_type(field, type_sym->type);
                         field_type = type_sym->type;
                     }
                 }
@@ -2351,8 +2656,8 @@ static CnType *infer_expr_type(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics
                     if (type_sym && type_sym->type &&
                         (type_sym->kind == CN_SEM_SYMBOL_STRUCT || type_sym->kind == CN_SEM_SYMBOL_ENUM)) {
                         // 创建新的指针类型，指向解析后的类型
-                        field->field_type = cn_type_new_pointer(type_sym->type);
-                        field_type = field->field_type;
+                        field_type = cn_type_new_pointer(type_sym->type);
+                        cn_type_patch_field_type(field, field_type);
                     }
                 }
                 
@@ -2609,6 +2914,18 @@ static CnType *infer_expr_type(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics
             }
             break;
         }
+        case CN_AST_EXPR_EMBED: {
+            // 全局字符数组的嵌入资源在作用域构建时已读入并确定类型，不会走到这里；
+            // 其余位置（局部变量、表达式中）不允许嵌入资源
+            char message[512];
+            snprintf(message, sizeof(message), "语义错误：嵌入资源 '%.*s' 只能用作全局字符数组的初始值",
+                     (int)expr->as.embed.path_length, expr->as.embed.path);
+            cn_support_diag_semantic_error_generic(diagnostics, CN_DIAG_CODE_SEM_EMBED_INVALID_TARGET,
+                                                   expr->loc.filename, expr->loc.line, expr->loc.column,
+                                                   message);
+            expr->type = cn_type_new_primitive(CN_TYPE_UNKNOWN);
+            break;
+        }
         default:
             expr->type = cn_type_new_primitive(CN_TYPE_UNKNOWN);
             break;
@@ -2679,86 +2996,97 @@ static CnType *infer_return_from_stmt(CnSemScope *scope, CnAstStmt *stmt, CnDiag
             break;
         
         case CN_AST_STMT_IF: {
-            // 创建 if 块作用域
-            CnSemScope *if_scope = cn_sem_scope_new(CN_SEM_SCOPE_BLOCK, scope);
-            
-            // 检查then分支
-            if (stmt->as.if_stmt.then_block) {
-                for (size_t i = 0; i < stmt->as.if_stmt.then_block->stmt_count; i++) {
-                    CnAstStmt *then_stmt = stmt->as.if_stmt.then_block->stmts[i];
-                    // 处理变量声明
-                    if (then_stmt && then_stmt->kind == CN_AST_STMT_VAR_DECL) {
-                        CnAstVarDecl *decl = &then_stmt->as.var_decl;
-                        CnSemSymbol *sym = cn_sem_scope_insert_symbol(if_scope, decl->name, decl->name_length, CN_SEM_SYMBOL_VARIABLE);
-                        // 设置变量类型
-                        if (sym) {
-                            CnType *var_type = decl->declared_type;
-                            // 如果是指针类型，需要特殊处理
-                            if (var_type && var_type->kind == CN_TYPE_POINTER &&
-                                var_type->as.pointer_to && var_type->as.pointer_to->kind == CN_TYPE_STRUCT) {
-                                CnSemSymbol *type_sym = cn_sem_scope_lookup(if_scope,
-                                                        var_type->as.pointer_to->as.struct_type.name,
-                                                        var_type->as.pointer_to->as.struct_type.name_length);
-                                if (type_sym && type_sym->type && type_sym->kind == CN_SEM_SYMBOL_STRUCT) {
-                                    var_type = cn_type_new_pointer(type_sym->type);
-                                }
-                            } else if (var_type && var_type->kind == CN_TYPE_STRUCT) {
-                                CnSemSymbol *type_sym = cn_sem_scope_lookup(if_scope,
-                                                        var_type->as.struct_type.name,
-                                                        var_type->as.struct_type.name_length);
-                                if (type_sym && type_sym->type && type_sym->kind == CN_SEM_SYMBOL_STRUCT) {
-                                    var_type = type_sym->type;
+            // "否则 如果" 链逐段循环处理，每段使用独立的 if 块作用域，不逐段递归
+            CnAstIfStmt *if_stmt = &stmt->as.if_stmt;
+            while (if_stmt) {
+                // 创建 if 块作用域
+                CnSemScope *if_scope = cn_sem_scope_new(CN_SEM_SCOPE_BLOCK, scope);
+                CnAstStmt *else_if = cn_frontend_ast_else_if(if_stmt);
+                
+                // 检查then分支
+                if (if_stmt->then_block) {
+                    for (size_t i = 0; i < if_stmt->then_block->stmt_count; i++) {
+                        CnAstStmt *then_stmt = if_stmt->then_block->stmts[i];
+                        // 处理变量声明
+                        if (then_stmt && then_stmt->kind == CN_AST_STMT_VAR_DECL) {
+                            CnAstVarDecl *decl = &then_stmt->as.var_decl;
+                            CnSemSymbol *sym = cn_sem_scope_insert_symbol(if_scope, decl->name, decl->name_length, CN_SEM_SYMBOL_VARIABLE);
+                            // 设置变量类型
+                            if (sym) {
+                                CnType *var_type = decl->declared_type;
+                                // 如果是指针类型，需要特殊处理
+                                if (var_type && var_type->kind == CN_TYPE_POINTER &&
+                                    var_type->as.pointer_to && var_type->as.pointer_to->kind == CN_TYPE_STRUCT) {
+                                    CnSemSymbol *type_sym = cn_sem_scope_lookup(if_scope,
+                                                            var_type->as.pointer_to->as.struct_type.name,
+                                                            var_type->as.pointer_to->as.struct_type.name_length);
+                                    if (type_sym && type_sym->type && type_sym->kind == CN_SEM_SYMBOL_STRUCT) {
+                                        var_type = cn_type_new_pointer(type_sym->type);
+                                    }
+                                } else if (var_type && var_type->kind == CN_TYPE_STRUCT) {
+                                    CnSemSymbol *type_sym = cn_sem_scope_lookup(if_scope,
+                                                            var_type->as.struct_type.name,
+                                                            var_type->as.struct_type.name_length);
+                                    if (type_sym && type_sym->type && type_sym->kind == CN_SEM_SYMBOL_STRUCT) {
+                                        var_type = type_sym->type;
+                                    }
                                 }
+                                sym->type = var_type;
                             }
-                            sym->type = var_type;
                         }
-                    }
-                    CnType *ret = infer_return_from_stmt(if_scope, then_stmt, diagnostics);
-                    if (ret) {
-                        cn_sem_scope_free(if_scope);
-                        return ret;
+                        CnType *ret = infer_return_from_stmt(if_scope, then_stmt, diagnostics);
+                        if (ret) {
+                            cn_sem_scope_free(if_scope);
+                            return ret;
+                        }
                     }
                 }
-            }
-            // 检查else分支
-            if (stmt->as.if_stmt.else_block) {
-                for (size_t i = 0; i < stmt->as.if_stmt.else_block->stmt_count; i++) {
-                    CnAstStmt *else_stmt = stmt->as.if_stmt.else_block->stmts[i];
-                    // 处理变量声明
-                    if (else_stmt && else_stmt->kind == CN_AST_STMT_VAR_DECL) {
-                        CnAstVarDecl *decl = &else_stmt->as.var_decl;
-                        CnSemSymbol *sym = cn_sem_scope_insert_symbol(if_scope, decl->name, decl->name_length, CN_SEM_SYMBOL_VARIABLE);
-                        // 设置变量类型
-                        if (sym) {
-                            CnType *var_type = decl->declared_type;
-                            // 如果是指针类型，需要特殊处理
-                            if (var_type && var_type->kind == CN_TYPE_POINTER &&
-                                var_type->as.pointer_to && var_type->as.pointer_to->kind == CN_TYPE_STRUCT) {
-                                CnSemSymbol *type_sym = cn_sem_scope_lookup(if_scope,
-                                                        var_type->as.pointer_to->as.struct_type.name,
-                                                        var_type->as.pointer_to->as.struct_type.name_length);
-                                if (type_sym && type_sym->type && type_sym->kind == CN_SEM_SYMBOL_STRUCT) {
-                                    var_type = cn_type_new_pointer(type_sym->type);
-                                }
-                            } else if (var_type && var_type->kind == CN_TYPE_STRUCT) {
-                                CnSemSymbol *type_sym = cn_sem_scope_lookup(if_scope,
-                                                        var_type->as.struct_type.name,
-                                                        var_type->as.struct_type.name_length);
-                                if (type_sym && type_sym->type && type_sym->kind == CN_SEM_SYMBOL_STRUCT) {
-                                    var_type = type_sym->type;
+                if (else_if) {
+                    cn_sem_scope_free(if_scope);
+                    if_stmt = &else_if->as.if_stmt;
+                    continue;
+                }
+                // 检查else分支
+                if (if_stmt->else_block) {
+                    for (size_t i = 0; i < if_stmt->else_block->stmt_count; i++) {
+                        CnAstStmt *else_stmt = if_stmt->else_block->stmts[i];
+                        // 处理变量声明
+                        if (else_stmt && else_stmt->kind == CN_AST_STMT_VAR_DECL) {
+                            CnAstVarDecl *decl = &else_stmt->as.var_decl;
+                            CnSemSymbol *sym = cn_sem_scope_insert_symbol(if_scope, decl->name, decl->name_length, CN_SEM_SYMBOL_VARIABLE);
+                            // 设置变量类型
+                            if (sym) {
+                                CnType *var_type = decl->declared_type;
+                                // 如果是指针类型，需要特殊处理
+                                if (var_type && var_type->kind == CN_TYPE_POINTER &&
+                                    var_type->as.pointer_to && var_type->as.pointer_to->kind == CN_TYPE_STRUCT) {
+                                    CnSemSymbol *type_sym = cn_sem_scope_lookup(if_scope,
+                                                            var_type->as.pointer_to->as.struct_type.name,
+                                                            var_type->as.pointer_to->as.struct_type.name_length);
+                                    if (type_sym && type_sym->type && type_sym->kind == CN_SEM_SYMBOL_STRUCT) {
+                                        var_type = cn_type_new_pointer(type_sym->type);
+                                    }
+                                } else if (var_type && var_type->kind == CN_TYPE_STRUCT) {
+                                    CnSemSymbol *type_sym = cn_sem_scope_lookup(if_scope,
+                                                            var_type->as.struct_type.name,
+                                                            var_type->as.struct_type.name_length);
+                                    if (type_sym && type_sym->type && type_sym->kind == CN_SEM_SYMBOL_STRUCT) {
+                                        var_type = type_sym->type;
+                                    }
                                 }
+                                sym->type = var_type;
                             }
-                            sym->type = var_type;
                         }
-                    }
-                    CnType *ret = infer_return_from_stmt(if_scope, else_stmt, diagnostics);
-                    if (ret) {
-                        cn_sem_scope_free(if_scope);
-                        return ret;
+                        CnType *ret = infer_return_from_stmt(if_scope, else_stmt, diagnostics);
+                        if (ret) {
+                            cn_sem_scope_free(if_scope);
+                            return ret;
+                        }
                     }
                 }
+                cn_sem_scope_free(if_scope);
+                if_stmt = NULL;
             }
-            cn_sem_scope_free(if_scope);
             break;
         }
         
@@ -7,11 +7,13 @@
  * - 继承关系构建
  * - 循环继承检测
  * - 继承链遍历查询
+ * - 类层次缓存（祖先位集与方法槽位表，见 cn_inheritance_resolver_build_hierarchy）
  */
 
 #include <stdlib.h>
 #include <string.h>
 #include <cnlang/semantics/inheritance_resolver.h>
+#include "cnlang/support/string_pool.h"
 
 /* ============================================================================
  * 内部常量定义
@@ -23,6 +25,9 @@
 /** 初始派生类容量 */
 #define INITIAL_DERIVED_CAPACITY 4
 
+/** 类名哈希索引初始容量（2的幂） */
+#define INITIAL_NAME_INDEX_CAPACITY 32
+
 /* ============================================================================
  * 内部辅助函数
  * ============================================================================ */
@@ -38,21 +43,7 @@
  */
 static bool class_name_equals(const char *name1, size_t len1,
                                const char *name2, size_t len2) {
-    if (len1 != len2) return false;
-    return memcmp(name1, name2, len1) == 0;
-}
-
-/**
- * @brief 比较类名与C字符串是否相等
- * 
- * @param name 类名
- * @param len 类名长度
- * @param cstr C字符串（以NULL结尾）
- * @return bool 相等返回true
- */
-static bool class_name_equals_cstr(const char *name, size_t len, const char *cstr) {
-    size_t cstr_len = strlen(cstr);
-    return class_name_equals(name, len, cstr, cstr_len);
+    return cn_name_equals(name1, len1, name2, len2);
 }
 
 /**
@@ -71,10 +62,39 @@ static bool inheritance_node_init(CnInheritanceNode *node, CnAstClassDecl *class
     node->derived_capacity = 0;
     node->depth = 0;
     node->visited = false;
+    node->id = 0;
+    node->ancestors = NULL;
+    node->ancestor_count = 0;
+    node->ancestor_bits = NULL;
+    node->method_slots = NULL;
+    node->method_slot_count = 0;
+    node->method_index = NULL;
+    node->method_index_capacity = 0;
+    node->hierarchy_state = 0;
     
     return true;
 }
 
+/**
+ * @brief 释放节点的类层次缓存
+ *
+ * @param node 节点指针
+ */
+static void inheritance_node_clear_hierarchy(CnInheritanceNode *node) {
+    free(node->ancestors);
+    free(node->ancestor_bits);
+    free(node->method_slots);
+    free(node->method_index);
+    node->ancestors = NULL;
+    node->ancestor_count = 0;
+    node->ancestor_bits = NULL;
+    node->method_slots = NULL;
+    node->method_slot_count = 0;
+    node->method_index = NULL;
+    node->method_index_capacity = 0;
+    node->hierarchy_state = 0;
+}
+
 /**
  * @brief 清理继承节点
  * 
@@ -89,6 +109,7 @@ static void inheritance_node_cleanup(CnInheritanceNode *node) {
     }
     node->derived_count = 0;
     node->derived_capacity = 0;
+    inheritance_node_clear_hierarchy(node);
 }
 
 /**
@@ -119,6 +140,78 @@ static bool inheritance_node_add_derived(CnInheritanceNode *node,
     return true;
 }
 
+/**
+ * @brief 释放所有节点的类层次缓存
+ *
+ * @param resolver 解析器
+ */
+static void hierarchy_clear(CnInheritanceResolver *resolver) {
+    for (size_t i = 0; i < resolver->node_count; i++) {
+        inheritance_node_clear_hierarchy(&resolver->nodes[i]);
+    }
+    resolver->bitset_words = 0;
+    resolver->hierarchy_ready = false;
+}
+
+/**
+ * @brief 使类层次缓存失效（缓存只在计算完成后存在，未计算时无需遍历节点）
+ *
+ * @param resolver 解析器
+ */
+static void hierarchy_invalidate(CnInheritanceResolver *resolver) {
+    if (resolver->hierarchy_ready) {
+        hierarchy_clear(resolver);
+    }
+}
+
+/**
+ * @brief 将节点加入类名哈希索引（同名类以先注册者为准）
+ *
+ * @param resolver 解析器
+ * @param index 节点下标
+ */
+static void name_index_put(CnInheritanceResolver *resolver, size_t index) {
+    CnAstClassDecl *class_decl = resolver->nodes[index].class_decl;
+    size_t mask = resolver->name_index_capacity - 1;
+    size_t slot = cn_string_hash(class_decl->name, class_decl->name_length) & mask;
+
+    while (resolver->name_index[slot] != 0) {
+        CnAstClassDecl *existing = resolver->nodes[resolver->name_index[slot] - 1].class_decl;
+        if (class_name_equals(existing->name, existing->name_length,
+                              class_decl->name, class_decl->name_length)) {
+            return;
+        }
+        slot = (slot + 1) & mask;
+    }
+    resolver->name_index[slot] = (uint32_t)(index + 1);
+}
+
+/**
+ * @brief 登记新节点到类名哈希索引，负载超过一半时扩容重建
+ *
+ * @param resolver 解析器
+ * @param index 新节点下标
+ * @return bool 成功返回true
+ */
+static bool name_index_add(CnInheritanceResolver *resolver, size_t index) {
+    if ((index + 1) * 2 > resolver->name_index_capacity) {
+        size_t new_capacity = resolver->name_index_capacity == 0
+                              ? INITIAL_NAME_INDEX_CAPACITY
+                              : resolver->name_index_capacity * 2;
+        uint32_t *new_index = calloc(new_capacity, sizeof(uint32_t));
+        if (!new_index) return false;
+
+        free(resolver->name_index);
+        resolver->name_index = new_index;
+        resolver->name_index_capacity = new_capacity;
+        for (size_t i = 0; i < index; i++) {
+            name_index_put(resolver, i);
+        }
+    }
+    name_index_put(resolver, index);
+    return true;
+}
+
 /* ============================================================================
  * 创建和销毁函数实现
  * ============================================================================ */
@@ -136,6 +229,10 @@ CnInheritanceResolver *cn_inheritance_resolver_create(CnDiagnostics *diag) {
     resolver->node_count = 0;
     resolver->node_capacity = INITIAL_NODE_CAPACITY;
     resolver->diagnostics = diag;
+    resolver->name_index = NULL;
+    resolver->name_index_capacity = 0;
+    resolver->bitset_words = 0;
+    resolver->hierarchy_ready = false;
     
     return resolver;
 }
@@ -151,6 +248,7 @@ void cn_inheritance_resolver_destroy(CnInheritanceResolver *resolver) {
     if (resolver->nodes) {
         free(resolver->nodes);
     }
+    free(resolver->name_index);
     
     free(resolver);
 }
@@ -164,12 +262,13 @@ bool cn_inheritance_resolver_register(CnInheritanceResolver *resolver,
     if (!resolver || !class_decl) return false;
     
     /* 检查是否已注册 */
-    for (size_t i = 0; i < resolver->node_count; i++) {
-        if (resolver->nodes[i].class_decl == class_decl) {
-            return true;  /* 已注册 */
-        }
+    if (cn_inheritance_resolver_node_of(resolver, class_decl)) {
+        return true;  /* 已注册 */
     }
     
+    /* 祖先列表保存节点指针，节点数组扩容前先使缓存失效 */
+    hierarchy_invalidate(resolver);
+    
     /* 检查是否需要扩容 */
     if (resolver->node_count >= resolver->node_capacity) {
         size_t new_capacity = resolver->node_capacity * 2;
@@ -187,6 +286,9 @@ bool cn_inheritance_resolver_register(CnInheritanceResolver *resolver,
         return false;
     }
     
+    if (!name_index_add(resolver, resolver->node_count)) {
+        return false;
+    }
     resolver->node_count++;
     return true;
 }
@@ -208,17 +310,8 @@ bool cn_inheritance_resolver_resolve(CnInheritanceResolver *resolver) {
             CnInheritanceInfo *base_info = &class_decl->bases[j];
             
             /* 查找基类节点 */
-            CnInheritanceNode *base_node = NULL;
-            for (size_t k = 0; k < resolver->node_count; k++) {
-                CnAstClassDecl *potential_base = resolver->nodes[k].class_decl;
-                if (class_name_equals(base_info->base_class_name,
-                                       base_info->base_class_name_length,
-                                       potential_base->name,
-                                       potential_base->name_length)) {
-                    base_node = &resolver->nodes[k];
-                    break;
-                }
-            }
+            CnInheritanceNode *base_node = cn_inheritance_resolver_find_node(
+                resolver, base_info->base_class_name, base_info->base_class_name_length);
             
             if (base_node) {
                 /* 添加派生类关系 */
@@ -303,12 +396,42 @@ CnInheritanceNode *cn_inheritance_resolver_get_node(CnInheritanceResolver *resol
                                                      const char *class_name) {
     if (!resolver || !class_name) return NULL;
     
-    size_t name_len = strlen(class_name);
+    return cn_inheritance_resolver_find_node(resolver, class_name, strlen(class_name));
+}
+
+CnInheritanceNode *cn_inheritance_resolver_find_node(CnInheritanceResolver *resolver,
+                                                      const char *class_name,
+                                                      size_t class_name_length) {
+    if (!resolver || !class_name || !resolver->name_index) return NULL;
+    
+    size_t mask = resolver->name_index_capacity - 1;
+    size_t slot = cn_string_hash(class_name, class_name_length) & mask;
+    
+    while (resolver->name_index[slot] != 0) {
+        CnInheritanceNode *node = &resolver->nodes[resolver->name_index[slot] - 1];
+        if (class_name_equals(node->class_decl->name, node->class_decl->name_length,
+                              class_name, class_name_length)) {
+            return node;
+        }
+        slot = (slot + 1) & mask;
+    }
+    
+    return NULL;
+}
+
+CnInheritanceNode *cn_inheritance_resolver_node_of(CnInheritanceResolver *resolver,
+                                                    const CnAstClassDecl *class_decl) {
+    if (!resolver || !class_decl) return NULL;
+    
+    CnInheritanceNode *node = cn_inheritance_resolver_find_node(resolver, class_decl->name,
+                                                                class_decl->name_length);
+    if (!node || node->class_decl == class_decl) {
+        return node;
+    }
     
+    /* 同名类：逐个比较声明指针 */
     for (size_t i = 0; i < resolver->node_count; i++) {
-        CnAstClassDecl *class_decl = resolver->nodes[i].class_decl;
-        if (class_name_equals(class_decl->name, class_decl->name_length,
-                               class_name, name_len)) {
+        if (resolver->nodes[i].class_decl == class_decl) {
             return &resolver->nodes[i];
         }
     }
@@ -316,123 +439,261 @@ CnInheritanceNode *cn_inheritance_resolver_get_node(CnInheritanceResolver *resol
     return NULL;
 }
 
+/* ============================================================================
+ * 类层次缓存实现
+ * ============================================================================ */
+
+/**
+ * @brief 检查位集中是否包含指定类编号
+ */
+static bool bitset_test(const uint64_t *bits, size_t id) {
+    return bits && (bits[id / 64] >> (id % 64) & 1u) != 0;
+}
+
 /**
- * @brief 收集所有基类的辅助函数
- * 
- * @param node 当前节点
- * @param result 结果数组
- * @param result_count 结果数量
- * @param capacity 结果容量
- * @return bool 成功返回true
+ * @brief 查找基类对应的节点；基类未注册或位于正在计算的环上时返回NULL
+ */
+static CnInheritanceNode *hierarchy_base_node(CnInheritanceResolver *resolver,
+                                              const CnInheritanceInfo *base_info) {
+    CnInheritanceNode *base_node = cn_inheritance_resolver_find_node(
+        resolver, base_info->base_class_name, base_info->base_class_name_length);
+    
+    /* 循环继承：忽略环上的边，由 check_circular 报告 */
+    if (!base_node || base_node->hierarchy_state == 1) {
+        return NULL;
+    }
+    return base_node;
+}
+
+/**
+ * @brief 将祖先追加到节点的线性化列表（已存在则跳过）
  */
-static bool collect_all_bases(CnInheritanceNode *node,
-                               CnAstClassDecl **result,
-                               size_t *result_count,
-                               size_t capacity) {
-    if (!node || !result || !result_count) return false;
+static void hierarchy_add_ancestor(CnInheritanceNode *node, CnInheritanceNode *ancestor) {
+    if (ancestor == node || bitset_test(node->ancestor_bits, ancestor->id)) {
+        return;
+    }
+    node->ancestor_bits[ancestor->id / 64] |= (uint64_t)1 << (ancestor->id % 64);
+    node->ancestors[node->ancestor_count++] = ancestor;
+}
+
+/**
+ * @brief 合并一个方法槽位：新名字追加槽位，已有名字只补全尚未找到的方法与虚函数
+ *
+ * 按MRO顺序调用，因此每个字段保留的都是MRO顺序上的第一个匹配
+ */
+static void hierarchy_merge_slot(CnInheritanceNode *node, const CnMethodSlot *slot) {
+    size_t mask = node->method_index_capacity - 1;
+    size_t index = cn_string_hash(slot->name, slot->name_length) & mask;
+    
+    while (node->method_index[index] != 0) {
+        CnMethodSlot *existing = &node->method_slots[node->method_index[index] - 1];
+        if (class_name_equals(existing->name, existing->name_length,
+                              slot->name, slot->name_length)) {
+            if (!existing->method && slot->method) {
+                existing->method = slot->method;
+                existing->owner = slot->owner;
+            }
+            if (!existing->virtual_method) {
+                existing->virtual_method = slot->virtual_method;
+            }
+            return;
+        }
+        index = (index + 1) & mask;
+    }
     
+    node->method_slots[node->method_slot_count] = *slot;
+    node->method_index[index] = (uint32_t)++node->method_slot_count;
+}
+
+/**
+ * @brief 计算单个节点的类层次缓存（先递归计算各直接基类）
+ *
+ * 祖先列表：依次合并每个直接基类及其祖先列表，结果与 MRO 去掉自身一致；
+ * 方法槽位表：先登记自身的方法，再依次合并每个直接基类的槽位表
+ */
+static bool hierarchy_build_node(CnInheritanceResolver *resolver, CnInheritanceNode *node) {
     CnAstClassDecl *class_decl = node->class_decl;
+    size_t ancestor_bound = 0;
+    size_t slot_bound = 0;
+    
+    if (node->hierarchy_state == 2) return true;
+    node->hierarchy_state = 1;
     
-    /* 处理每个直接基类 */
     for (size_t i = 0; i < class_decl->base_count; i++) {
-        CnInheritanceInfo *base_info = &class_decl->bases[i];
-        
-        /* 查找基类节点 */
-        CnInheritanceNode *base_node = NULL;
-        for (size_t k = 0; k < node->derived_count + 1; k++) {
-            /* 这里需要遍历所有节点来查找基类 */
-            /* 简化实现：通过基类名查找 */
+        CnInheritanceNode *base_node = hierarchy_base_node(resolver, &class_decl->bases[i]);
+        if (!base_node) continue;
+        if (!hierarchy_build_node(resolver, base_node)) return false;
+        ancestor_bound += base_node->ancestor_count + 1;
+        slot_bound += base_node->method_slot_count;
+    }
+    for (size_t i = 0; i < class_decl->member_count; i++) {
+        CnClassMember *member = &class_decl->members[i];
+        if (member->kind == CN_MEMBER_METHOD || member->is_virtual) {
+            slot_bound++;
         }
-        
-        /* 检查是否已添加 */
-        bool already_added = false;
-        for (size_t j = 0; j < *result_count; j++) {
-            if (result[j] && class_name_equals_cstr(result[j]->name,
-                                                     result[j]->name_length,
-                                                     base_info->base_class_name)) {
-                already_added = true;
-                break;
-            }
+    }
+    
+    node->ancestor_bits = calloc(resolver->bitset_words, sizeof(uint64_t));
+    node->ancestors = malloc((ancestor_bound ? ancestor_bound : 1) * sizeof(CnInheritanceNode*));
+    if (!node->ancestor_bits || !node->ancestors) return false;
+    
+    if (slot_bound > 0) {
+        size_t capacity = 4;
+        while (capacity < slot_bound * 2) capacity *= 2;
+        node->method_slots = malloc(slot_bound * sizeof(CnMethodSlot));
+        node->method_index = calloc(capacity, sizeof(uint32_t));
+        if (!node->method_slots || !node->method_index) return false;
+        node->method_index_capacity = capacity;
+    }
+    
+    /* 自身的方法优先于基类（虚函数查找也从自身开始） */
+    for (size_t i = 0; i < class_decl->member_count; i++) {
+        CnClassMember *member = &class_decl->members[i];
+        if (member->kind == CN_MEMBER_METHOD || member->is_virtual) {
+            CnMethodSlot slot;
+            slot.name = member->name;
+            slot.name_length = member->name_length;
+            slot.method = member->kind == CN_MEMBER_METHOD ? member : NULL;
+            slot.owner = member->kind == CN_MEMBER_METHOD ? class_decl : NULL;
+            slot.virtual_method = member->is_virtual ? member : NULL;
+            hierarchy_merge_slot(node, &slot);
         }
+    }
+    
+    for (size_t i = 0; i < class_decl->base_count; i++) {
+        CnInheritanceNode *base_node = hierarchy_base_node(resolver, &class_decl->bases[i]);
+        if (!base_node) continue;
         
-        if (!already_added && *result_count < capacity) {
-            /* 这里需要实际的基类指针，简化实现中返回NULL */
+        hierarchy_add_ancestor(node, base_node);
+        for (size_t j = 0; j < base_node->ancestor_count; j++) {
+            hierarchy_add_ancestor(node, base_node->ancestors[j]);
+        }
+        for (size_t j = 0; j < base_node->method_slot_count; j++) {
+            hierarchy_merge_slot(node, &base_node->method_slots[j]);
         }
     }
     
+    node->hierarchy_state = 2;
     return true;
 }
 
+bool cn_inheritance_resolver_build_hierarchy(CnInheritanceResolver *resolver) {
+    if (!resolver) return false;
+    
+    hierarchy_invalidate(resolver);
+    resolver->bitset_words = (resolver->node_count + 63) / 64;
+    if (resolver->bitset_words == 0) {
+        resolver->bitset_words = 1;
+    }
+    for (size_t i = 0; i < resolver->node_count; i++) {
+        resolver->nodes[i].id = i;
+    }
+    
+    for (size_t i = 0; i < resolver->node_count; i++) {
+        if (!hierarchy_build_node(resolver, &resolver->nodes[i])) {
+            hierarchy_clear(resolver);
+            return false;
+        }
+    }
+    
+    resolver->hierarchy_ready = true;
+    return true;
+}
+
+/**
+ * @brief 确保类层次缓存可用
+ */
+static bool hierarchy_ensure(CnInheritanceResolver *resolver) {
+    return resolver->hierarchy_ready || cn_inheritance_resolver_build_hierarchy(resolver);
+}
+
+bool cn_inheritance_node_is_derived_from(CnInheritanceResolver *resolver,
+                                          const CnInheritanceNode *derived,
+                                          const CnInheritanceNode *base) {
+    if (!resolver || !derived || !base || !hierarchy_ensure(resolver)) return false;
+    
+    return bitset_test(derived->ancestor_bits, base->id);
+}
+
+const CnMethodSlot *cn_inheritance_resolver_find_method_slot(CnInheritanceResolver *resolver,
+                                                              const CnAstClassDecl *class_decl,
+                                                              const char *method_name,
+                                                              size_t method_name_len) {
+    if (!resolver || !method_name || !hierarchy_ensure(resolver)) return NULL;
+    
+    CnInheritanceNode *node = cn_inheritance_resolver_node_of(resolver, class_decl);
+    if (!node || node->method_slot_count == 0) return NULL;
+    
+    size_t mask = node->method_index_capacity - 1;
+    size_t index = cn_string_hash(method_name, method_name_len) & mask;
+    
+    while (node->method_index[index] != 0) {
+        const CnMethodSlot *slot = &node->method_slots[node->method_index[index] - 1];
+        if (class_name_equals(slot->name, slot->name_length, method_name, method_name_len)) {
+            return slot;
+        }
+        index = (index + 1) & mask;
+    }
+    
+    return NULL;
+}
+
 CnAstClassDecl **cn_inheritance_resolver_get_all_bases(CnInheritanceResolver *resolver,
                                                         CnAstClassDecl *class_decl,
                                                         size_t *count) {
-    if (!resolver || !class_decl || !count) {
+    if (!resolver || !class_decl || !count || !hierarchy_ensure(resolver)) {
         if (count) *count = 0;
         return NULL;
     }
     
-    /* 计算最大可能的基类数量（继承链长度） */
-    size_t max_bases = 16;  /* 假设最大继承深度 */
-    CnAstClassDecl **result = malloc(max_bases * sizeof(CnAstClassDecl*));
-    if (!result) {
-        *count = 0;
-        return NULL;
+    /* 已注册的类直接复制线性化祖先列表 */
+    CnInheritanceNode *node = cn_inheritance_resolver_node_of(resolver, class_decl);
+    if (node) {
+        CnAstClassDecl **result = malloc((node->ancestor_count + 1) * sizeof(CnAstClassDecl*));
+        if (!result) {
+            *count = 0;
+            return NULL;
+        }
+        for (size_t i = 0; i < node->ancestor_count; i++) {
+            result[i] = node->ancestors[i]->class_decl;
+        }
+        *count = node->ancestor_count;
+        return result;
     }
     
-    size_t result_count = 0;
+    /* 未注册的类：按同样的规则合并各直接基类的祖先列表 */
+    size_t bound = 0;
+    for (size_t i = 0; i < class_decl->base_count; i++) {
+        CnInheritanceNode *base_node = hierarchy_base_node(resolver, &class_decl->bases[i]);
+        if (base_node) {
+            bound += base_node->ancestor_count + 1;
+        }
+    }
     
-    /* 使用队列进行广度优先遍历收集基类 */
-    CnAstClassDecl **queue = malloc(max_bases * sizeof(CnAstClassDecl*));
-    if (!queue) {
+    CnAstClassDecl **result = malloc((bound + 1) * sizeof(CnAstClassDecl*));
+    uint64_t *seen = calloc(resolver->bitset_words, sizeof(uint64_t));
+    if (!result || !seen) {
         free(result);
+        free(seen);
         *count = 0;
         return NULL;
     }
     
-    size_t queue_head = 0;
-    size_t queue_tail = 0;
-    
-    /* 将直接基类加入队列 */
+    size_t result_count = 0;
     for (size_t i = 0; i < class_decl->base_count; i++) {
-        CnInheritanceInfo *base_info = &class_decl->bases[i];
-        CnInheritanceNode *base_node = cn_inheritance_resolver_get_node(
-            resolver, base_info->base_class_name);
-        
-        if (base_node && queue_tail < max_bases) {
-            queue[queue_tail++] = base_node->class_decl;
-        }
-    }
-    
-    /* 广度优先遍历 */
-    while (queue_head < queue_tail && result_count < max_bases) {
-        CnAstClassDecl *current = queue[queue_head++];
+        CnInheritanceNode *base_node = hierarchy_base_node(resolver, &class_decl->bases[i]);
+        if (!base_node) continue;
         
-        /* 检查是否已添加 */
-        bool already_added = false;
-        for (size_t i = 0; i < result_count; i++) {
-            if (result[i] == current) {
-                already_added = true;
-                break;
-            }
-        }
-        
-        if (!already_added) {
-            result[result_count++] = current;
-            
-            /* 将当前类的基类加入队列 */
-            for (size_t i = 0; i < current->base_count; i++) {
-                CnInheritanceInfo *base_info = &current->bases[i];
-                CnInheritanceNode *base_node = cn_inheritance_resolver_get_node(
-                    resolver, base_info->base_class_name);
-                
-                if (base_node && queue_tail < max_bases) {
-                    queue[queue_tail++] = base_node->class_decl;
-                }
+        for (size_t j = 0; j <= base_node->ancestor_count; j++) {
+            CnInheritanceNode *ancestor = j == 0 ? base_node : base_node->ancestors[j - 1];
+            if (!bitset_test(seen, ancestor->id)) {
+                seen[ancestor->id / 64] |= (uint64_t)1 << (ancestor->id % 64);
+                result[result_count++] = ancestor->class_decl;
             }
         }
     }
     
-    free(queue);
+    free(seen);
     *count = result_count;
     return result;
 }
@@ -442,33 +703,11 @@ bool cn_inheritance_resolver_is_derived_from(CnInheritanceResolver *resolver,
                                               const char *base) {
     if (!resolver || !derived || !base) return false;
     
-    /* 获取派生类节点 */
+    /* 查找两个类的节点，派生关系由祖先位集直接判断 */
     CnInheritanceNode *derived_node = cn_inheritance_resolver_get_node(resolver, derived);
-    if (!derived_node) return false;
-    
-    /* 如果派生类名和基类名相同，返回false */
-    if (strcmp(derived, base) == 0) return false;
-    
-    /* 获取所有基类 */
-    size_t base_count = 0;
-    CnAstClassDecl **all_bases = cn_inheritance_resolver_get_all_bases(
-        resolver, derived_node->class_decl, &base_count);
-    
-    if (!all_bases) return false;
-    
-    /* 检查基类是否在列表中 */
-    bool found = false;
-    for (size_t i = 0; i < base_count; i++) {
-        if (class_name_equals_cstr(all_bases[i]->name,
-                                    all_bases[i]->name_length,
-                                    base)) {
-            found = true;
-            break;
-        }
-    }
+    CnInheritanceNode *base_node = cn_inheritance_resolver_get_node(resolver, base);
     
-    free(all_bases);
-    return found;
+    return cn_inheritance_node_is_derived_from(resolver, derived_node, base_node);
 }
 
 int cn_inheritance_resolver_get_depth(CnInheritanceResolver *resolver,
@@ -777,98 +1016,28 @@ static bool mro_list_append(CnMroList *list, CnAstClassDecl *class_decl) {
     return true;
 }
 
-/**
- * @brief 检查类是否在MRO列表中
- *
- * @param list MRO列表
- * @param class_decl 要检查的类
- * @return bool 存在返回true
- */
-static bool mro_list_contains(CnMroList *list, CnAstClassDecl *class_decl) {
-    if (!list || !class_decl) return false;
-    
-    for (size_t i = 0; i < list->count; i++) {
-        if (list->classes[i] == class_decl) {
-            return true;
-        }
-    }
-    return false;
-}
-
-/**
- * @brief C3线性化合并算法
- *
- * 合并多个MRO列表为一个
- *
- * @param mro_lists MRO列表数组
- * @param list_count 列表数量
- * @param result 结果MRO列表
- * @param resolver 解析器
- * @return bool 成功返回true
- */
-static bool c3_merge(CnMroList **mro_lists, size_t list_count,
-                     CnMroList *result, CnInheritanceResolver *resolver) {
-    /* 简化实现：按顺序合并，跳过重复 */
-    for (size_t i = 0; i < list_count; i++) {
-        CnMroList *list = mro_lists[i];
-        if (!list) continue;
-        
-        for (size_t j = 0; j < list->count; j++) {
-            if (!mro_list_contains(result, list->classes[j])) {
-                mro_list_append(result, list->classes[j]);
-            }
-        }
-    }
-    return true;
-}
-
 CnMroList *cn_inheritance_resolver_compute_mro(CnInheritanceResolver *resolver,
                                                 CnAstClassDecl *class_decl) {
     if (!resolver || !class_decl) return NULL;
     
-    /* 创建结果列表 */
-    CnMroList *result = cn_mro_list_create(16);
-    if (!result) return NULL;
-    
-    /* 首先添加当前类 */
-    mro_list_append(result, class_decl);
-    
-    /* 如果没有基类，直接返回 */
-    if (class_decl->base_count == 0) {
-        return result;
-    }
+    /* MRO 即当前类加上线性化祖先列表（每个基类按深度优先首次出现的位置排列） */
+    size_t base_count = 0;
+    CnAstClassDecl **bases = cn_inheritance_resolver_get_all_bases(resolver, class_decl,
+                                                                    &base_count);
+    if (!bases) return NULL;
     
-    /* 收集所有基类的MRO */
-    CnMroList **base_mros = malloc(class_decl->base_count * sizeof(CnMroList*));
-    if (!base_mros) {
-        cn_mro_list_destroy(result);
+    CnMroList *result = cn_mro_list_create(base_count + 1);
+    if (!result) {
+        free(bases);
         return NULL;
     }
     
-    for (size_t i = 0; i < class_decl->base_count; i++) {
-        CnInheritanceInfo *base_info = &class_decl->bases[i];
-        CnInheritanceNode *base_node = cn_inheritance_resolver_get_node(
-            resolver, base_info->base_class_name);
-        
-        if (base_node) {
-            base_mros[i] = cn_inheritance_resolver_compute_mro(resolver,
-                                                                base_node->class_decl);
-        } else {
-            base_mros[i] = NULL;
-        }
-    }
-    
-    /* 使用C3线性化合并 */
-    c3_merge(base_mros, class_decl->base_count, result, resolver);
-    
-    /* 清理临时MRO列表 */
-    for (size_t i = 0; i < class_decl->base_count; i++) {
-        if (base_mros[i]) {
-            cn_mro_list_destroy(base_mros[i]);
-        }
+    mro_list_append(result, class_decl);
+    for (size_t i = 0; i < base_count; i++) {
+        mro_list_append(result, bases[i]);
     }
-    free(base_mros);
     
+    free(bases);
     return result;
 }
 
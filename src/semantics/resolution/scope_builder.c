@@ -3,7 +3,9 @@
 #include "cnlang/frontend/lexer.h"
 #include "cnlang/frontend/parser.h"
 #include "cnlang/frontend/preprocessor.h"
+#include "cnlang/frontend/ast_cache.h"
 #include "cnlang/support/diagnostics.h"
+#include "cnlang/support/source_manager.h"
 #include "cnlang/ir/ir.h"  // CnIrModule 类型定义
 
 #include <stdlib.h>
@@ -337,13 +339,10 @@ struct CnSemScope {
     CnFileModuleSemInfo *file_module_info;  // 文件模块信息（仅当kind==CN_SEM_SCOPE_FILE_MODULE时有效）
 };
 
-// 模块编译栈，用于检测循环导入
 #define MAX_MODULE_COMPILE_DEPTH 64
-static const char *g_compiling_modules[MAX_MODULE_COMPILE_DEPTH];
-static int g_compile_depth = 0;
+#define MAX_CACHED_MODULES 256
 
 // 模块缓存结构
-#define MAX_CACHED_MODULES 256
 typedef struct {
     char *file_path;
     CnSemScope *scope;
@@ -351,19 +350,54 @@ typedef struct {
     CnIrModule *ir_module;    // IR模块（用于代码生成）
 } CachedModule;
 
-static CachedModule g_module_cache[MAX_CACHED_MODULES];
-static int g_cached_module_count = 0;
+// 一次编译的作用域构建状态
+struct CnSemCompilation {
+    const char *compiling_modules[MAX_MODULE_COMPILE_DEPTH];  // 模块编译栈，用于检测循环导入
+    int compile_depth;
+    CachedModule module_cache[MAX_CACHED_MODULES];
+    int cached_module_count;
+    CnAstProgram *scope_owner;  // 正在构建作用域的程序：函数/块作用域挂到其节点上，由该程序负责释放
+};
+
+CnSemCompilation *cn_sem_compilation_new(void)
+{
+    return (CnSemCompilation *)calloc(1, sizeof(CnSemCompilation));
+}
+
+void cn_sem_compilation_free(CnSemCompilation *compilation)
+{
+    if (!compilation) {
+        return;
+    }
+    for (int i = 0; i < compilation->compile_depth; i++) {
+        free((void *)compilation->compiling_modules[i]);
+    }
+    for (int i = 0; i < compilation->cached_module_count; i++) {
+        free(compilation->module_cache[i].file_path);
+    }
+    free(compilation);
+}
+
+// 将作用域挂到 AST 节点前登记到所属程序；登记失败时释放作用域
+static CnSemScope *adopt_node_scope(CnSemCompilation *compilation, CnSemScope *scope)
+{
+    if (scope && !cn_frontend_ast_program_adopt_scope(compilation->scope_owner, scope)) {
+        cn_sem_scope_free(scope);
+        return NULL;
+    }
+    return scope;
+}
 
 // 查找缓存的模块（使用规范化路径）
-static CnSemScope *find_cached_module(const char *file_path) {
+static CnSemScope *find_cached_module(CnSemCompilation *compilation, const char *file_path) {
     // 规范化路径以确保相同文件的不同路径表示能匹配
     char *normalized = normalize_file_path(file_path);
     const char *search_path = normalized ? normalized : file_path;
     
-    for (int i = 0; i < g_cached_module_count; i++) {
-        if (strcmp(g_module_cache[i].file_path, search_path) == 0) {
+    for (int i = 0; i < compilation->cached_module_count; i++) {
+        if (strcmp(compilation->module_cache[i].file_path, search_path) == 0) {
             if (normalized) free(normalized);
-            return g_module_cache[i].scope;
+            return compilation->module_cache[i].scope;
         }
     }
     
@@ -373,14 +407,15 @@ static CnSemScope *find_cached_module(const char *file_path) {
 
 // 缓存模块（带AST，使用规范化路径）
 // 返回值：1 表示成功缓存，0 表示失败（缓存已满或已存在）
-static int cache_module_with_program(const char *file_path, CnSemScope *scope, CnAstProgram *program) {
-    if (g_cached_module_count >= MAX_CACHED_MODULES) {
+static int cache_module_with_program(CnSemCompilation *compilation, const char *file_path,
+                                     CnSemScope *scope, CnAstProgram *program) {
+    if (compilation->cached_module_count >= MAX_CACHED_MODULES) {
         fprintf(stderr, "[WARNING] 模块缓存已满，无法缓存: %s\n", file_path);
         return 0;  // 缓存已满
     }
     
     // 先检查是否已缓存（避免重复缓存）
-    CnSemScope *existing = find_cached_module(file_path);
+    CnSemScope *existing = find_cached_module(compilation, file_path);
     if (existing) {
         return 0;  // 已缓存，不重复添加
     }
@@ -391,64 +426,65 @@ static int cache_module_with_program(const char *file_path, CnSemScope *scope, C
     
     // 使用规范化路径存储
     char *normalized = normalize_file_path(file_path);
-    g_module_cache[g_cached_module_count].file_path = normalized ? normalized : strdup(file_path);
-    g_module_cache[g_cached_module_count].scope = scope;
-    g_module_cache[g_cached_module_count].program = program;  // 缓存AST
-    g_module_cache[g_cached_module_count].ir_module = NULL;   // IR稍后填充
-    g_cached_module_count++;
+    CachedModule *entry = &compilation->module_cache[compilation->cached_module_count];
+    entry->file_path = normalized ? normalized : strdup(file_path);
+    entry->scope = scope;
+    entry->program = program;  // 缓存AST
+    entry->ir_module = NULL;   // IR稍后填充
+    compilation->cached_module_count++;
     return 1;  // 缓存成功
 }
 
 // 缓存模块（兼容旧接口）
-static void cache_module(const char *file_path, CnSemScope *scope) {
-    cache_module_with_program(file_path, scope, NULL);
+static void cache_module(CnSemCompilation *compilation, const char *file_path, CnSemScope *scope) {
+    cache_module_with_program(compilation, file_path, scope, NULL);
 }
 
 // 获取缓存的模块数量
-int cn_sem_get_cached_module_count(void) {
-    return g_cached_module_count;
+int cn_sem_get_cached_module_count(const CnSemCompilation *compilation) {
+    return compilation ? compilation->cached_module_count : 0;
 }
 
 // 获取缓存的模块文件路径
-const char *cn_sem_get_cached_module_path(int index) {
-    if (index < 0 || index >= g_cached_module_count) {
+const char *cn_sem_get_cached_module_path(const CnSemCompilation *compilation, int index) {
+    if (!compilation || index < 0 || index >= compilation->cached_module_count) {
         return NULL;
     }
-    return g_module_cache[index].file_path;
+    return compilation->module_cache[index].file_path;
 }
 
 // 获取缓存的模块AST程序
-CnAstProgram *cn_sem_get_cached_module_program(int index) {
-    if (index < 0 || index >= g_cached_module_count) {
+CnAstProgram *cn_sem_get_cached_module_program(const CnSemCompilation *compilation, int index) {
+    if (!compilation || index < 0 || index >= compilation->cached_module_count) {
         return NULL;
     }
-    return g_module_cache[index].program;
+    return compilation->module_cache[index].program;
 }
 
 // 获取缓存的模块IR
-CnIrModule *cn_sem_get_cached_module_ir(int index) {
-    if (index < 0 || index >= g_cached_module_count) {
+CnIrModule *cn_sem_get_cached_module_ir(const CnSemCompilation *compilation, int index) {
+    if (!compilation || index < 0 || index >= compilation->cached_module_count) {
         return NULL;
     }
-    return g_module_cache[index].ir_module;
+    return compilation->module_cache[index].ir_module;
 }
 
 // 设置缓存的模块IR
-void cn_sem_set_cached_module_ir(int index, CnIrModule *ir_module) {
-    if (index >= 0 && index < g_cached_module_count) {
-        g_module_cache[index].ir_module = ir_module;
+void cn_sem_set_cached_module_ir(CnSemCompilation *compilation, int index, CnIrModule *ir_module) {
+    if (compilation && index >= 0 && index < compilation->cached_module_count) {
+        compilation->module_cache[index].ir_module = ir_module;
     }
 }
 
 // 检查是否正在编译该模块（循环导入检测，使用规范化路径）
-static int is_module_compiling(const char *file_path) {
+static int is_module_compiling(const CnSemCompilation *compilation, const char *file_path) {
     // 规范化路径以确保相同文件的不同路径表示能匹配
     char *normalized = normalize_file_path(file_path);
     const char *search_path = normalized ? normalized : file_path;
     
-    for (int i = 0; i < g_compile_depth; i++) {
+    for (int i = 0; i < compilation->compile_depth; i++) {
         // 编译栈中存储的已经是规范化路径
-        if (strcmp(g_compiling_modules[i], search_path) == 0) {
+        if (strcmp(compilation->compiling_modules[i], search_path) == 0) {
             if (normalized) free(normalized);
             return 1;
         }
@@ -459,44 +495,66 @@ static int is_module_compiling(const char *file_path) {
 }
 
 // 将模块压入编译栈（存储规范化路径）
-static int push_compiling_module(const char *file_path) {
-    if (g_compile_depth >= MAX_MODULE_COMPILE_DEPTH) {
+static int push_compiling_module(CnSemCompilation *compilation, const char *file_path) {
+    if (compilation->compile_depth >= MAX_MODULE_COMPILE_DEPTH) {
         return 0;  // 栈溢出
     }
     // 存储规范化路径的副本
     char *normalized = normalize_file_path(file_path);
-    g_compiling_modules[g_compile_depth++] = normalized ? normalized : strdup(file_path);
+    compilation->compiling_modules[compilation->compile_depth++] = normalized ? normalized : strdup(file_path);
     return 1;
 }
 
 // 将模块弹出编译栈
-static void pop_compiling_module(void) {
-    if (g_compile_depth > 0) {
-        g_compile_depth--;
+static void pop_compiling_module(CnSemCompilation *compilation) {
+    if (compilation->compile_depth > 0) {
+        compilation->compile_depth--;
         // 释放规范化路径的内存
-        if (g_compiling_modules[g_compile_depth]) {
-            free((void *)g_compiling_modules[g_compile_depth]);
-            g_compiling_modules[g_compile_depth] = NULL;
+        if (compilation->compiling_modules[compilation->compile_depth]) {
+            free((void *)compilation->compiling_modules[compilation->compile_depth]);
+            compilation->compiling_modules[compilation->compile_depth] = NULL;
         }
     }
 }
 
-static void cn_sem_build_function_scope(CnSemScope *parent_scope,
+static void cn_sem_build_function_scope(CnSemCompilation *compilation,
+                                        CnSemScope *parent_scope,
                                          CnAstFunctionDecl *function_decl,
                                          CnDiagnostics *diagnostics);
-static void cn_sem_build_block_scope(CnSemScope *parent_scope,
+static void cn_sem_build_block_scope(CnSemCompilation *compilation,
+                                     CnSemScope *parent_scope,
                                      CnAstBlockStmt *block,
                                      CnDiagnostics *diagnostics);
-static void cn_sem_build_module_scope(CnSemScope *parent_scope,
+static void cn_sem_build_module_scope(CnSemCompilation *compilation,
+                                      CnSemScope *parent_scope,
                                       CnAstStmt *module_stmt,
                                       CnDiagnostics *diagnostics);
-static void cn_sem_build_stmt(CnSemScope *scope, CnAstStmt *stmt, CnDiagnostics *diagnostics);
+static void cn_sem_build_stmt(CnSemCompilation *compilation, CnSemScope *scope, CnAstStmt *stmt, CnDiagnostics *diagnostics);
 static void cn_sem_build_expr(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics *diagnostics);
-static void cn_sem_build_if_stmt(CnSemScope *scope, CnAstIfStmt *if_stmt, CnDiagnostics *diagnostics);
-static void cn_sem_build_while_stmt(CnSemScope *scope, CnAstWhileStmt *while_stmt, CnDiagnostics *diagnostics);
-static void cn_sem_build_for_stmt(CnSemScope *scope, CnAstForStmt *for_stmt, CnDiagnostics *diagnostics);
+static void cn_sem_build_if_stmt(CnSemCompilation *compilation, CnSemScope *scope, CnAstIfStmt *if_stmt, CnDiagnostics *diagnostics);
+static void cn_sem_build_while_stmt(CnSemCompilation *compilation, CnSemScope *scope, CnAstWhileStmt *while_stmt, CnDiagnostics *diagnostics);
+static void cn_sem_build_for_stmt(CnSemCompilation *compilation, CnSemScope *scope, CnAstForStmt *for_stmt, CnDiagnostics *diagnostics);
+static CnSemScope *build_program_scopes(CnSemCompilation *compilation, CnAstProgram *program, CnDiagnostics *diagnostics);
+static CnSemScope *build_program_scopes_with_loader(CnSemCompilation *compilation,
+                                                    CnAstProgram *program,
+                                                    CnDiagnostics *diagnostics,
+                                                    CnModuleLoader *loader,
+                                                    const char *source_file);
+static void resolve_embedded_globals(CnAstProgram *program,
+                                     CnModuleLoader *loader,
+                                     const char *source_file,
+                                     CnDiagnostics *diagnostics);
 
 CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostics)
+{
+    // 不加载外部模块，编译上下文只在本次调用内使用
+    CnSemCompilation compilation = { 0 };
+
+    compilation.scope_owner = program;
+    return build_program_scopes(&compilation, program, diagnostics);
+}
+
+static CnSemScope *build_program_scopes(CnSemCompilation *compilation, CnAstProgram *program, CnDiagnostics *diagnostics)
 {
     CnSemScope *global_scope;
     size_t i;
@@ -513,7 +571,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：打印 (print)
     CnSemSymbol *print_sym = cn_sem_scope_insert_symbol(global_scope, "打印", strlen("打印"), CN_SEM_SYMBOL_FUNCTION);
     if (print_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_primitive(CN_TYPE_STRING);
         print_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_VOID), param_types, 1);
     }
@@ -521,7 +579,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：打印整数 (print_int)
     CnSemSymbol *print_int_sym = cn_sem_scope_insert_symbol(global_scope, "打印整数", strlen("打印整数"), CN_SEM_SYMBOL_FUNCTION);
     if (print_int_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_primitive(CN_TYPE_INT);
         print_int_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_VOID), param_types, 1);
     }
@@ -529,7 +587,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：打印字符串 (print_string)
     CnSemSymbol *print_str_sym = cn_sem_scope_insert_symbol(global_scope, "打印字符串", strlen("打印字符串"), CN_SEM_SYMBOL_FUNCTION);
     if (print_str_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_primitive(CN_TYPE_STRING);
         print_str_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_VOID), param_types, 1);
     }
@@ -593,7 +651,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 返回整数，参数为整数指针（传递地址）
     CnSemSymbol *read_int_sym = cn_sem_scope_insert_symbol(global_scope, "读取整数", strlen("读取整数"), CN_SEM_SYMBOL_FUNCTION);
     if (read_int_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_INT));
         read_int_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_INT), param_types, 1);
     }
@@ -602,7 +660,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 返回整数（成功/失败），参数为小数指针（传递地址）
     CnSemSymbol *read_float_sym = cn_sem_scope_insert_symbol(global_scope, "读取小数", strlen("读取小数"), CN_SEM_SYMBOL_FUNCTION);
     if (read_float_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_FLOAT));
         read_float_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_INT), param_types, 1);
     }
@@ -611,7 +669,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 返回整数（成功/失败），参数为字符串缓冲区和大小
     CnSemSymbol *read_string_sym = cn_sem_scope_insert_symbol(global_scope, "读取字符串", strlen("读取字符串"), CN_SEM_SYMBOL_FUNCTION);
     if (read_string_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *) * 2);
+        CnType *param_types[2];
         param_types[0] = cn_type_new_primitive(CN_TYPE_STRING);  // char* buffer
         param_types[1] = cn_type_new_primitive(CN_TYPE_INT);     // size_t size
         read_string_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_INT), param_types, 2);
@@ -621,7 +679,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 返回整数（成功/失败），参数为字符指针
     CnSemSymbol *read_char_sym = cn_sem_scope_insert_symbol(global_scope, "读取字符", strlen("读取字符"), CN_SEM_SYMBOL_FUNCTION);
     if (read_char_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_INT));  // char* 简化为 int*
         read_char_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_INT), param_types, 1);
     }
@@ -642,7 +700,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 返回整数（布尔值），参数为输入值指针
     CnSemSymbol *is_int_sym = cn_sem_scope_insert_symbol(global_scope, "是整数", strlen("是整数"), CN_SEM_SYMBOL_FUNCTION);
     if (is_int_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID));
         is_int_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_INT), param_types, 1);
     }
@@ -650,7 +708,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：是小数 (is_float)
     CnSemSymbol *is_float_sym = cn_sem_scope_insert_symbol(global_scope, "是小数", strlen("是小数"), CN_SEM_SYMBOL_FUNCTION);
     if (is_float_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID));
         is_float_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_INT), param_types, 1);
     }
@@ -658,7 +716,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：是字符串 (is_string)
     CnSemSymbol *is_string_sym = cn_sem_scope_insert_symbol(global_scope, "是字符串", strlen("是字符串"), CN_SEM_SYMBOL_FUNCTION);
     if (is_string_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID));
         is_string_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_INT), param_types, 1);
     }
@@ -666,7 +724,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：是数值 (is_number)
     CnSemSymbol *is_number_sym = cn_sem_scope_insert_symbol(global_scope, "是数值", strlen("是数值"), CN_SEM_SYMBOL_FUNCTION);
     if (is_number_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID));
         is_number_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_INT), param_types, 1);
     }
@@ -674,7 +732,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：取整数 (to_int)
     CnSemSymbol *to_int_sym = cn_sem_scope_insert_symbol(global_scope, "取整数", strlen("取整数"), CN_SEM_SYMBOL_FUNCTION);
     if (to_int_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID));
         to_int_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_INT), param_types, 1);
     }
@@ -682,7 +740,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：取小数 (to_float)
     CnSemSymbol *to_float_sym = cn_sem_scope_insert_symbol(global_scope, "取小数", strlen("取小数"), CN_SEM_SYMBOL_FUNCTION);
     if (to_float_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID));
         to_float_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_FLOAT), param_types, 1);
     }
@@ -690,7 +748,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：取文本 (to_string)
     CnSemSymbol *to_string_sym = cn_sem_scope_insert_symbol(global_scope, "取文本", strlen("取文本"), CN_SEM_SYMBOL_FUNCTION);
     if (to_string_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID));
         to_string_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_STRING), param_types, 1);
     }
@@ -702,7 +760,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：分配内存 (malloc)
     CnSemSymbol *malloc_sym = cn_sem_scope_insert_symbol(global_scope, "分配内存", strlen("分配内存"), CN_SEM_SYMBOL_FUNCTION);
     if (malloc_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_primitive(CN_TYPE_INT);  // size_t 简化为 int
         malloc_sym->type = cn_type_new_function(cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID)), param_types, 1);
     }
@@ -710,7 +768,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：释放内存 (free)
     CnSemSymbol *free_sym = cn_sem_scope_insert_symbol(global_scope, "释放内存", strlen("释放内存"), CN_SEM_SYMBOL_FUNCTION);
     if (free_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID));
         free_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_VOID), param_types, 1);
     }
@@ -718,7 +776,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：重新分配内存 (realloc)
     CnSemSymbol *realloc_sym = cn_sem_scope_insert_symbol(global_scope, "重新分配内存", strlen("重新分配内存"), CN_SEM_SYMBOL_FUNCTION);
     if (realloc_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *) * 2);
+        CnType *param_types[2];
         param_types[0] = cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID));
         param_types[1] = cn_type_new_primitive(CN_TYPE_INT);  // size_t 简化为 int
         realloc_sym->type = cn_type_new_function(cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID)), param_types, 2);
@@ -727,7 +785,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：分配清零内存 (calloc)
     CnSemSymbol *calloc_sym = cn_sem_scope_insert_symbol(global_scope, "分配清零内存", strlen("分配清零内存"), CN_SEM_SYMBOL_FUNCTION);
     if (calloc_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *) * 2);
+        CnType *param_types[2];
         param_types[0] = cn_type_new_primitive(CN_TYPE_INT);  // count
         param_types[1] = cn_type_new_primitive(CN_TYPE_INT);  // size
         calloc_sym->type = cn_type_new_function(cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID)), param_types, 2);
@@ -737,7 +795,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 参数：类型大小, 数量
     CnSemSymbol *malloc_array_sym = cn_sem_scope_insert_symbol(global_scope, "分配内存数组", strlen("分配内存数组"), CN_SEM_SYMBOL_FUNCTION);
     if (malloc_array_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *) * 2);
+        CnType *param_types[2];
         param_types[0] = cn_type_new_primitive(CN_TYPE_INT);  // type_size
         param_types[1] = cn_type_new_primitive(CN_TYPE_INT);  // count
         malloc_array_sym->type = cn_type_new_function(cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID)), param_types, 2);
@@ -749,7 +807,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     if (sizeof_sym) {
         // 类型大小 接受任意类型参数，返回整数类型
         // 使用 UNKNOWN 类型表示接受任意类型
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_primitive(CN_TYPE_UNKNOWN);  // 接受任意类型
         sizeof_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_INT), param_types, 1);
     }
@@ -757,7 +815,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：释放输入 (free_input)
     CnSemSymbol *free_input_sym = cn_sem_scope_insert_symbol(global_scope, "释放输入", strlen("释放输入"), CN_SEM_SYMBOL_FUNCTION);
     if (free_input_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID));
         free_input_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_VOID), param_types, 1);
     }
@@ -769,7 +827,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：转整数 (str_to_int)
     CnSemSymbol *str_to_int_sym = cn_sem_scope_insert_symbol(global_scope, "转整数", strlen("转整数"), CN_SEM_SYMBOL_FUNCTION);
     if (str_to_int_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_primitive(CN_TYPE_STRING);
         str_to_int_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_INT), param_types, 1);
     }
@@ -777,7 +835,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：转小数 (str_to_float)
     CnSemSymbol *str_to_float_sym = cn_sem_scope_insert_symbol(global_scope, "转小数", strlen("转小数"), CN_SEM_SYMBOL_FUNCTION);
     if (str_to_float_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_primitive(CN_TYPE_STRING);
         str_to_float_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_FLOAT), param_types, 1);
     }
@@ -785,7 +843,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：是数字文本 (is_numeric_str)
     CnSemSymbol *is_numeric_sym = cn_sem_scope_insert_symbol(global_scope, "是数字文本", strlen("是数字文本"), CN_SEM_SYMBOL_FUNCTION);
     if (is_numeric_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_primitive(CN_TYPE_STRING);
         is_numeric_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_INT), param_types, 1);
     }
@@ -793,7 +851,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：是整数文本 (is_int_str)
     CnSemSymbol *is_int_str_sym = cn_sem_scope_insert_symbol(global_scope, "是整数文本", strlen("是整数文本"), CN_SEM_SYMBOL_FUNCTION);
     if (is_int_str_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_primitive(CN_TYPE_STRING);
         is_int_str_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_INT), param_types, 1);
     }
@@ -805,7 +863,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：比较字符串 (strcmp)
     CnSemSymbol *strcmp_sym = cn_sem_scope_insert_symbol(global_scope, "比较字符串", strlen("比较字符串"), CN_SEM_SYMBOL_FUNCTION);
     if (strcmp_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *) * 2);
+        CnType *param_types[2];
         param_types[0] = cn_type_new_primitive(CN_TYPE_STRING);
         param_types[1] = cn_type_new_primitive(CN_TYPE_STRING);
         strcmp_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_INT), param_types, 2);
@@ -814,7 +872,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：字符串长度 (strlen)
     CnSemSymbol *strlen_sym = cn_sem_scope_insert_symbol(global_scope, "字符串长度", strlen("字符串长度"), CN_SEM_SYMBOL_FUNCTION);
     if (strlen_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_primitive(CN_TYPE_STRING);
         strlen_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_INT), param_types, 1);
     }
@@ -822,7 +880,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：复制字符串 (strcpy)
     CnSemSymbol *strcpy_sym = cn_sem_scope_insert_symbol(global_scope, "复制字符串", strlen("复制字符串"), CN_SEM_SYMBOL_FUNCTION);
     if (strcpy_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *) * 2);
+        CnType *param_types[2];
         param_types[0] = cn_type_new_primitive(CN_TYPE_STRING);  // dest
         param_types[1] = cn_type_new_primitive(CN_TYPE_STRING);  // src
         strcpy_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_STRING), param_types, 2);
@@ -831,7 +889,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
     // 注册内置函数：连接字符串 (strcat)
     CnSemSymbol *strcat_sym = cn_sem_scope_insert_symbol(global_scope, "连接字符串", strlen("连接字符串"), CN_SEM_SYMBOL_FUNCTION);
     if (strcat_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *) * 2);
+        CnType *param_types[2];
         param_types[0] = cn_type_new_primitive(CN_TYPE_STRING);  // dest
         param_types[1] = cn_type_new_primitive(CN_TYPE_STRING);  // src
         strcat_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_STRING), param_types, 2);
@@ -1319,6 +1377,9 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
         }
     }
 
+    // 嵌入资源决定数组长度，须在注册全局变量之前读入
+    resolve_embedded_globals(program, NULL, NULL, diagnostics);
+
     // 注册全局变量声明到全局作用域
     for (i = 0; i < program->global_var_count; ++i) {
         CnAstStmt *var_stmt = program->global_vars[i];
@@ -1500,6 +1561,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
             sym->type = cn_type_new_function(return_type,
                                             param_types,
                                             function_decl->parameter_count);
+            free(param_types);
         } else {
             // 插入失败，检查是否是导入的符号
             CnSemSymbol *existing_sym = cn_sem_scope_lookup_shallow(global_scope,
@@ -1568,6 +1630,7 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
                     existing_sym->type = cn_type_new_function(return_type,
                                                     param_types,
                                                     function_decl->parameter_count);
+                    free(param_types);
                     existing_sym->decl_scope = global_scope;  // 标记为当前模块定义
                 } else {
                     // 检查是否是导入的函数
@@ -1591,13 +1654,14 @@ CnSemScope *cn_sem_build_scopes(CnAstProgram *program, CnDiagnostics *diagnostic
             }
         }
 
-        cn_sem_build_function_scope(global_scope, function_decl, diagnostics);
+        cn_sem_build_function_scope(compilation, global_scope, function_decl, diagnostics);
     }
 
     return global_scope;
 }
 
-static void cn_sem_build_function_scope(CnSemScope *parent_scope,
+static void cn_sem_build_function_scope(CnSemCompilation *compilation,
+                                        CnSemScope *parent_scope,
                                         CnAstFunctionDecl *function_decl,
                                         CnDiagnostics *diagnostics)
 {
@@ -1608,7 +1672,7 @@ static void cn_sem_build_function_scope(CnSemScope *parent_scope,
         return;
     }
 
-    function_scope = cn_sem_scope_new(CN_SEM_SCOPE_FUNCTION, parent_scope);
+    function_scope = adopt_node_scope(compilation, cn_sem_scope_new(CN_SEM_SCOPE_FUNCTION, parent_scope));
     if (!function_scope) {
         return;
     }
@@ -1670,11 +1734,14 @@ static void cn_sem_build_function_scope(CnSemScope *parent_scope,
         }
     }
 
-    cn_sem_build_block_scope(function_scope, function_decl->body, diagnostics);
+    // 跳读模式下函数体尚未解析，语义分析首次需要时在此解析
+    cn_frontend_parse_function_body(function_decl, diagnostics);
+    cn_sem_build_block_scope(compilation, function_scope, function_decl->body, diagnostics);
     // 【注意】不再释放 function_scope，它现在由 AST 节点拥有，将在 ast_free 中释放
 }
 
-static void cn_sem_build_block_scope(CnSemScope *parent_scope,
+static void cn_sem_build_block_scope(CnSemCompilation *compilation,
+                                     CnSemScope *parent_scope,
                                      CnAstBlockStmt *block,
                                      CnDiagnostics *diagnostics)
 {
@@ -1687,7 +1754,7 @@ static void cn_sem_build_block_scope(CnSemScope *parent_scope,
 
     // 【修复】创建新的块作用域并保存到 AST 节点
     // 这样 semantic_passes 和 irgen 可以通过 block->owning_scope 访问
-    block_scope = cn_sem_scope_new(CN_SEM_SCOPE_BLOCK, parent_scope);
+    block_scope = adopt_node_scope(compilation, cn_sem_scope_new(CN_SEM_SCOPE_BLOCK, parent_scope));
     if (!block_scope) {
         return;
     }
@@ -1697,12 +1764,12 @@ static void cn_sem_build_block_scope(CnSemScope *parent_scope,
     
     // 遍历语句并构建符号表
     for (i = 0; i < block->stmt_count; ++i) {
-        cn_sem_build_stmt(block_scope, block->stmts[i], diagnostics);
+        cn_sem_build_stmt(compilation, block_scope, block->stmts[i], diagnostics);
     }
     // 【注意】不再释放 block_scope，它现在由 AST 节点拥有，将在 ast_free 中释放
 }
 
-static void cn_sem_build_stmt(CnSemScope *scope, CnAstStmt *stmt, CnDiagnostics *diagnostics)
+static void cn_sem_build_stmt(CnSemCompilation *compilation, CnSemScope *scope, CnAstStmt *stmt, CnDiagnostics *diagnostics)
 {
     if (!scope || !stmt) {
         return;
@@ -1710,7 +1777,7 @@ static void cn_sem_build_stmt(CnSemScope *scope, CnAstStmt *stmt, CnDiagnostics
 
     switch (stmt->kind) {
     case CN_AST_STMT_BLOCK:
-        cn_sem_build_block_scope(scope, stmt->as.block, diagnostics);
+        cn_sem_build_block_scope(compilation, scope, stmt->as.block, diagnostics);
         break;
     case CN_AST_STMT_VAR_DECL: {
         CnAstVarDecl *var_decl = &stmt->as.var_decl;
@@ -1876,13 +1943,13 @@ static void cn_sem_build_stmt(CnSemScope *scope, CnAstStmt *stmt, CnDiagnostics
         cn_sem_build_expr(scope, stmt->as.return_stmt.expr, diagnostics);
         break;
     case CN_AST_STMT_IF:
-        cn_sem_build_if_stmt(scope, &stmt->as.if_stmt, diagnostics);
+        cn_sem_build_if_stmt(compilation, scope, &stmt->as.if_stmt, diagnostics);
         break;
     case CN_AST_STMT_WHILE:
-        cn_sem_build_while_stmt(scope, &stmt->as.while_stmt, diagnostics);
+        cn_sem_build_while_stmt(compilation, scope, &stmt->as.while_stmt, diagnostics);
         break;
     case CN_AST_STMT_FOR:
-        cn_sem_build_for_stmt(scope, &stmt->as.for_stmt, diagnostics);
+        cn_sem_build_for_stmt(compilation, scope, &stmt->as.for_stmt, diagnostics);
         break;
     case CN_AST_STMT_SWITCH: {
         // 解析 switch 表达式
@@ -1893,7 +1960,7 @@ static void cn_sem_build_stmt(CnSemScope *scope, CnAstStmt *stmt, CnDiagnostics
             // 解析 case 值表达式（如果有）
             cn_sem_build_expr(scope, case_stmt->value, diagnostics);
             // 解析 case 体
-            cn_sem_build_block_scope(scope, case_stmt->body, diagnostics);
+            cn_sem_build_block_scope(compilation, scope, case_stmt->body, diagnostics);
         }
         break;
     }
@@ -2023,28 +2090,37 @@ static void cn_sem_build_stmt(CnSemScope *scope, CnAstStmt *stmt, CnDiagnostics
     }
 }
 
-static void cn_sem_build_if_stmt(CnSemScope *scope, CnAstIfStmt *if_stmt, CnDiagnostics *diagnostics)
+static void cn_sem_build_if_stmt(CnSemCompilation *compilation, CnSemScope *scope, CnAstIfStmt *if_stmt, CnDiagnostics *diagnostics)
 {
     if (!scope || !if_stmt) {
         return;
     }
 
-    cn_sem_build_expr(scope, if_stmt->condition, diagnostics);
-    cn_sem_build_block_scope(scope, if_stmt->then_block, diagnostics);
-    cn_sem_build_block_scope(scope, if_stmt->else_block, diagnostics);
+    // "否则 如果" 链循环处理；只含如果语句的否则块不声明符号，不为它单独建立块作用域，
+    // 避免长链形成同样深的作用域链（名字查找沿作用域链逐层向上）
+    for (;;) {
+        CnAstStmt *else_if = cn_frontend_ast_else_if(if_stmt);
+        cn_sem_build_expr(scope, if_stmt->condition, diagnostics);
+        cn_sem_build_block_scope(compilation, scope, if_stmt->then_block, diagnostics);
+        if (!else_if) {
+            cn_sem_build_block_scope(compilation, scope, if_stmt->else_block, diagnostics);
+            break;
+        }
+        if_stmt = &else_if->as.if_stmt;
+    }
 }
 
-static void cn_sem_build_while_stmt(CnSemScope *scope, CnAstWhileStmt *while_stmt, CnDiagnostics *diagnostics)
+static void cn_sem_build_while_stmt(CnSemCompilation *compilation, CnSemScope *scope, CnAstWhileStmt *while_stmt, CnDiagnostics *diagnostics)
 {
     if (!scope || !while_stmt) {
         return;
     }
 
     cn_sem_build_expr(scope, while_stmt->condition, diagnostics);
-    cn_sem_build_block_scope(scope, while_stmt->body, diagnostics);
+    cn_sem_build_block_scope(compilation, scope, while_stmt->body, diagnostics);
 }
 
-static void cn_sem_build_for_stmt(CnSemScope *scope, CnAstForStmt *for_stmt, CnDiagnostics *diagnostics)
+static void cn_sem_build_for_stmt(CnSemCompilation *compilation, CnSemScope *scope, CnAstForStmt *for_stmt, CnDiagnostics *diagnostics)
 {
     CnSemScope *for_scope;
 
@@ -2057,10 +2133,10 @@ static void cn_sem_build_for_stmt(CnSemScope *scope, CnAstForStmt *for_stmt, CnD
         return;
     }
 
-    cn_sem_build_stmt(for_scope, for_stmt->init, diagnostics);
+    cn_sem_build_stmt(compilation, for_scope, for_stmt->init, diagnostics);
     cn_sem_build_expr(for_scope, for_stmt->condition, diagnostics);
     cn_sem_build_expr(for_scope, for_stmt->update, diagnostics);
-    cn_sem_build_block_scope(for_scope, for_stmt->body, diagnostics);
+    cn_sem_build_block_scope(compilation, for_scope, for_stmt->body, diagnostics);
 }
 
 static void cn_sem_build_expr(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics *diagnostics)
@@ -2073,9 +2149,19 @@ static void cn_sem_build_expr(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics
 
     switch (expr->kind) {
     case CN_AST_EXPR_BINARY:
-        cn_sem_build_expr(scope, expr->as.binary.left, diagnostics);
-        cn_sem_build_expr(scope, expr->as.binary.right, diagnostics);
+    case CN_AST_EXPR_LOGICAL: {
+        // 左结合长链先收集再自底向上处理，不逐层递归
+        CnAstExprChain chain;
+        if (!cn_frontend_ast_expr_chain_collect(&chain, expr)) {
+            break;
+        }
+        cn_sem_build_expr(scope, cn_frontend_ast_expr_chain_leaf(&chain), diagnostics);
+        for (i = chain.count; i-- > 0;) {
+            cn_sem_build_expr(scope, cn_frontend_ast_expr_chain_right(&chain, i), diagnostics);
+        }
+        cn_frontend_ast_expr_chain_free(&chain);
         break;
+    }
     case CN_AST_EXPR_CALL:
         cn_sem_build_expr(scope, expr->as.call.callee, diagnostics);
         // 【修复P0-2】尝试设置函数调用表达式的类型
@@ -2103,10 +2189,6 @@ static void cn_sem_build_expr(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics
         cn_sem_build_expr(scope, expr->as.assign.target, diagnostics);
         cn_sem_build_expr(scope, expr->as.assign.value, diagnostics);
         break;
-    case CN_AST_EXPR_LOGICAL:
-        cn_sem_build_expr(scope, expr->as.logical.left, diagnostics);
-        cn_sem_build_expr(scope, expr->as.logical.right, diagnostics);
-        break;
     case CN_AST_EXPR_UNARY:
         cn_sem_build_expr(scope, expr->as.unary.operand, diagnostics);
         break;
@@ -2140,57 +2222,62 @@ static void cn_sem_build_expr(CnSemScope *scope, CnAstExpr *expr, CnDiagnostics
 #include <sys/stat.h>
 #endif
 
-// 读取文件内容
-static char *read_file_content(const char *filename, size_t *out_size)
+// 编译外部模块文件，返回其作用域
+// 注意：为了支持嵌套导入，需要传入loader和source_file
+static CnSemScope *compile_external_module_recursive(CnSemCompilation *compilation,
+                                                     const char *file_path,
+                                                     CnDiagnostics *diagnostics,
+                                                     CnSemScope *global_scope,
+                                                     CnModuleLoader *loader,
+                                                     const char *importing_file);
+
+// 预处理并解析模块源码，失败返回 NULL
+static CnAstProgram *parse_module_source(const char *source, size_t length, const char *file_path)
 {
-    FILE *fp = fopen(filename, "rb");
-    if (!fp) {
-        return NULL;
-    }
-    
-    fseek(fp, 0, SEEK_END);
-    long file_size = ftell(fp);
-    fseek(fp, 0, SEEK_SET);
+    // 预处理 + 词法分析：解析器从预处理器逐词元拉取，不生成展开后的整份输出
+    CnPreprocessor preprocessor;
+    cn_frontend_preprocessor_init(&preprocessor, source, length, file_path);
     
-    if (file_size <= 0) {
-        fclose(fp);
+    // 语法分析
+    CnParser *parser = cn_frontend_parser_new_from_preprocessor(&preprocessor);
+    if (!parser) {
+        cn_frontend_preprocessor_free(&preprocessor);
         return NULL;
     }
     
-    char *content = (char *)malloc((size_t)file_size + 1);
-    if (!content) {
-        fclose(fp);
-        return NULL;
-    }
+    // 导入方只需要声明与签名，函数体跳读，生成 IR 时再解析；
+    // 启用 AST 缓存时映像需要完整的树，仍然完整解析
+    cn_frontend_parser_set_skim_bodies(parser, cn_ast_cache_get_directory() == NULL);
     
-    size_t read_size = fread(content, 1, (size_t)file_size, fp);
-    fclose(fp);
+    CnAstProgram *program = NULL;
+    int ok = cn_frontend_parse_program(parser, &program);
     
-    content[read_size] = '\0';
-    if (out_size) {
-        *out_size = read_size;
+    if (!ok || !program || preprocessor.stream_failed) {
+        if (program) {
+            cn_frontend_ast_program_free(program);
+        }
+        cn_frontend_parser_free(parser);
+        cn_frontend_preprocessor_free(&preprocessor);
+        return NULL;
     }
     
-    return content;
+    cn_frontend_parser_free(parser);
+    // 注意：不能释放 preprocessor，因为 lexer 中的 token 指向 preprocessor.output！
+    // cn_frontend_preprocessor_free(&preprocessor);  // 不释放，避免悬空指针
+    return program;
 }
 
-// 编译外部模块文件，返回其作用域
-// 注意：为了支持嵌套导入，需要传入loader和source_file
-static CnSemScope *compile_external_module_recursive(const char *file_path,
-                                                     CnDiagnostics *diagnostics,
-                                                     CnSemScope *global_scope,
-                                                     CnModuleLoader *loader,
-                                                     const char *importing_file);
-
-static CnSemScope *compile_external_module(const char *file_path,
+static CnSemScope *compile_external_module(CnSemCompilation *compilation,
+                                           const char *file_path,
                                             CnDiagnostics *diagnostics,
                                             CnSemScope *global_scope)
 {
     // 调用递归版本，但不支持嵌套导入（loader=NULL）
-    return compile_external_module_recursive(file_path, diagnostics, global_scope, NULL, NULL);
+    return compile_external_module_recursive(compilation, file_path, diagnostics, global_scope, NULL, NULL);
 }
 
-static CnSemScope *compile_external_module_recursive(const char *file_path,
+static CnSemScope *compile_external_module_recursive(CnSemCompilation *compilation,
+                                                     const char *file_path,
                                                      CnDiagnostics *diagnostics,
                                                      CnSemScope *global_scope,
                                                      CnModuleLoader *loader,
@@ -2200,7 +2287,7 @@ static CnSemScope *compile_external_module_recursive(const char *file_path,
     char *normalized_path = normalize_file_path(file_path);
     const char *cache_key = normalized_path ? normalized_path : file_path;
     
-    CnSemScope *cached = find_cached_module(file_path);
+    CnSemScope *cached = find_cached_module(compilation, file_path);
     if (cached) {
         // 【调试】检查缓存的作用域中的符号是否有正确的 type 字段和 module_scope
         CnSemSymbolNode *debug_node = cached->symbols;
@@ -2212,7 +2299,7 @@ static CnSemScope *compile_external_module_recursive(const char *file_path,
     }
     
     // 检测循环导入
-    if (is_module_compiling(file_path)) {
+    if (is_module_compiling(compilation, file_path)) {
         cn_support_diag_semantic_error_generic(
             diagnostics,
             CN_DIAG_CODE_SEM_UNDEFINED_IDENTIFIER,
@@ -2222,7 +2309,7 @@ static CnSemScope *compile_external_module_recursive(const char *file_path,
     }
     
     // 压入编译栈
-    if (!push_compiling_module(file_path)) {
+    if (!push_compiling_module(compilation, file_path)) {
         cn_support_diag_semantic_error_generic(
             diagnostics,
             CN_DIAG_CODE_SEM_UNDEFINED_IDENTIFIER,
@@ -2231,57 +2318,31 @@ static CnSemScope *compile_external_module_recursive(const char *file_path,
         return NULL;
     }
     
-    // 读取文件内容
-    size_t file_size = 0;
-    char *source = read_file_content(file_path, &file_size);
-    if (!source) {
-        pop_compiling_module();
-        return NULL;
-    }
-    
-    // 预处理
-    CnPreprocessor preprocessor;
-    cn_frontend_preprocessor_init(&preprocessor, source, file_size, file_path);
-    
-    if (!cn_frontend_preprocessor_process(&preprocessor)) {
-        cn_frontend_preprocessor_free(&preprocessor);
-        free(source);
-        pop_compiling_module();
-        return NULL;
-    }
-    
-    // 词法分析
-    CnLexer lexer;
-    cn_frontend_lexer_init(&lexer, preprocessor.output, preprocessor.output_length, file_path);
-    
-    // 语法分析
-    CnParser *parser = cn_frontend_parser_new(&lexer);
-    if (!parser) {
-        cn_frontend_preprocessor_free(&preprocessor);
-        free(source);
-        pop_compiling_module();
+    // 读取文件内容（由共享源文件管理器映射并持有，模块之间按规范化路径去重）
+    const CnSourceFile *source_file = cn_source_manager_load(cn_source_manager_default(), file_path);
+    if (!source_file || source_file->length == 0) {
+        pop_compiling_module(compilation);
         return NULL;
     }
+    const char *source = source_file->data;
+    size_t file_size = source_file->length;
     
-    CnAstProgram *module_program = NULL;
-    int ok = cn_frontend_parse_program(parser, &module_program);
-    
-    if (!ok || !module_program) {
-        cn_frontend_parser_free(parser);
-        cn_frontend_preprocessor_free(&preprocessor);
-        free(source);
-        pop_compiling_module();
-        return NULL;
+    // 命中 AST 缓存（按源码内容）时跳过预处理与语法分析，未命中则解析后写回缓存
+    CnAstProgram *module_program = cn_ast_cache_load(source, file_size, file_path);
+    if (!module_program) {
+        module_program = parse_module_source(source, file_size, file_path);
+        if (!module_program) {
+            pop_compiling_module(compilation);
+            return NULL;
+        }
+        cn_ast_cache_store(source, file_size, module_program);
     }
     
     // 为外部模块创建作用域
     CnSemScope *module_scope = cn_sem_scope_new(CN_SEM_SCOPE_FILE_MODULE, global_scope);
     if (!module_scope) {
         cn_frontend_ast_program_free(module_program);
-        cn_frontend_parser_free(parser);
-        cn_frontend_preprocessor_free(&preprocessor);
-        free(source);
-        pop_compiling_module();
+        pop_compiling_module(compilation);
         return NULL;
     }
     
@@ -2310,7 +2371,7 @@ static CnSemScope *compile_external_module_recursive(const char *file_path,
                 if (metadata && metadata->file_path) {
                     // 递归加载外部模块
                     CnSemScope *nested_scope = compile_external_module_recursive(
-                        metadata->file_path, diagnostics, module_scope, loader, file_path);
+                        compilation, metadata->file_path, diagnostics, module_scope, loader, file_path);
                     
                     if (nested_scope) {
                         if (import->use_from_syntax) {
@@ -2643,11 +2704,15 @@ static CnSemScope *compile_external_module_recursive(const char *file_path,
             sym->type = cn_type_new_function(return_type,
                                             param_types,
                                             function_decl->parameter_count);
+            free(param_types);
             // 根据AST中的visibility字段设置可见性
             sym->is_public = (function_decl->visibility == CN_VISIBILITY_PUBLIC) ? 1 : 0;
         }
     }
     
+    // 嵌入资源相对模块文件定位
+    resolve_embedded_globals(module_program, loader, file_path, diagnostics);
+
     // 注册模块中的全局变量
     for (size_t i = 0; i < module_program->global_var_count; ++i) {
         CnAstStmt *var_stmt = module_program->global_vars[i];
@@ -3112,18 +3177,14 @@ static CnSemScope *compile_external_module_recursive(const char *file_path,
     }
     
     // 清理（注意：符号表需要保持，不能释放 program）
-    cn_frontend_parser_free(parser);
-    // 注意：不能释放 preprocessor，因为 lexer 中的 token 指向 preprocessor.output！
-    // cn_frontend_preprocessor_free(&preprocessor);  // 不释放，避免悬空指针
-    // 注意：不能释放 source，因为 preprocessor 可能引用 source
-    // free(source);  // 不释放，避免悬空指针
+    // 注意：source 由共享源文件管理器持有，随管理器一起释放
     // 注意：module_program 也不能释放，因为符号可能引用 AST 节点
     
     // 弹出编译栈
-    pop_compiling_module();
+    pop_compiling_module(compilation);
     
     // 缓存模块作用域和AST（用于后续代码生成）
-    int cache_result = cache_module_with_program(file_path, module_scope, module_program);
+    int cache_result = cache_module_with_program(compilation, file_path, module_scope, module_program);
     
     // 设置模块作用域中所有符号的源模块路径
     // 【修复】如果缓存成功，使用缓存中的规范化路径；否则使用当前的 cache_key
@@ -3132,7 +3193,7 @@ static CnSemScope *compile_external_module_recursive(const char *file_path,
     
     if (cache_result) {
         // 缓存成功，从缓存中获取规范化路径
-        cached_path = g_module_cache[g_cached_module_count - 1].file_path;
+        cached_path = compilation->module_cache[compilation->cached_module_count - 1].file_path;
         cached_path_len = strlen(cached_path);
     } else {
         // 缓存失败（缓存已满或已存在），使用当前的 cache_key
@@ -3192,11 +3253,98 @@ static char *get_parent_dir(const char *file_path)
     return dir;
 }
 
+// 读入全局字符数组初始值中嵌入的资源文件：经模块加载器的搜索路径定位，
+// 由共享源文件管理器读入（同一文件只读一次），节点只引用其内容；省略长度的数组取文件大小
+static void resolve_embedded_globals(CnAstProgram *program,
+                                     CnModuleLoader *loader,
+                                     const char *source_file,
+                                     CnDiagnostics *diagnostics)
+{
+    char message[512];
+
+    for (size_t i = 0; i < program->global_var_count; ++i) {
+        CnAstStmt *var_stmt = program->global_vars[i];
+        if (!var_stmt || var_stmt->kind != CN_AST_STMT_VAR_DECL) {
+            continue;
+        }
+        CnAstVarDecl *var_decl = &var_stmt->as.var_decl;
+        CnAstExpr *init = var_decl->initializer;
+        if (!init || init->kind != CN_AST_EXPR_EMBED) {
+            continue;
+        }
+
+        CnAstEmbedExpr *embed = &init->as.embed;
+        CnType *array_type = var_decl->declared_type;
+        if (!array_type || array_type->kind != CN_TYPE_ARRAY || !array_type->as.array.element_type ||
+            array_type->as.array.element_type->kind != CN_TYPE_CHAR) {
+            snprintf(message, sizeof(message), "语义错误：嵌入资源 '%.*s' 只能用作全局字符数组的初始值",
+                     (int)embed->path_length, embed->path);
+            cn_support_diag_semantic_error_generic(diagnostics, CN_DIAG_CODE_SEM_EMBED_INVALID_TARGET,
+                                                   init->loc.filename, init->loc.line,
+                                                   init->loc.column, message);
+            continue;
+        }
+
+        char *resolved_path = NULL;
+        const CnSourceFile *file = NULL;
+        if (cn_module_loader_resolve_resource(loader, source_file ? source_file : init->loc.filename,
+                                              embed->path, &resolved_path)) {
+            file = cn_source_manager_load(cn_source_manager_default(), resolved_path);
+        }
+        free(resolved_path);
+        if (!file || file->length == 0) {
+            snprintf(message, sizeof(message),
+                     file ? "语义错误：嵌入的资源文件 '%.*s' 为空" : "语义错误：找不到嵌入的资源文件 '%.*s'",
+                     (int)embed->path_length, embed->path);
+            cn_support_diag_semantic_error_generic(diagnostics, CN_DIAG_CODE_SEM_EMBED_NOT_FOUND,
+                                                   init->loc.filename, init->loc.line,
+                                                   init->loc.column, message);
+            continue;
+        }
+
+        if (array_type->as.array.length == 0) {
+            var_decl->declared_type = cn_type_new_array(array_type->as.array.element_type, file->length);
+        } else if (array_type->as.array.length < file->length) {
+            snprintf(message, sizeof(message),
+                     "语义错误：数组 '%.*s' 的长度 %zu 小于嵌入资源 '%.*s' 的大小 %zu",
+                     (int)var_decl->name_length, var_decl->name, array_type->as.array.length,
+                     (int)embed->path_length, embed->path, file->length);
+            cn_support_diag_semantic_error_generic(diagnostics, CN_DIAG_CODE_SEM_EMBED_INVALID_TARGET,
+                                                   init->loc.filename, init->loc.line,
+                                                   init->loc.column, message);
+            continue;
+        }
+        embed->data = (const unsigned char *)file->data;
+        embed->size = file->length;
+        init->type = var_decl->declared_type;
+    }
+}
+
 // 带模块加载器的作用域构建
-CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program, 
+CnSemScope *cn_sem_build_scopes_with_loader(CnSemCompilation *compilation,
+                                             CnAstProgram *program, 
                                              CnDiagnostics *diagnostics,
                                              CnModuleLoader *loader,
                                              const char *source_file)
+{
+    CnAstProgram *saved_owner;
+    CnSemScope *global_scope;
+
+    if (!compilation) {
+        return NULL;
+    }
+    saved_owner = compilation->scope_owner;
+    compilation->scope_owner = program;
+    global_scope = build_program_scopes_with_loader(compilation, program, diagnostics, loader, source_file);
+    compilation->scope_owner = saved_owner;
+    return global_scope;
+}
+
+static CnSemScope *build_program_scopes_with_loader(CnSemCompilation *compilation,
+                                                    CnAstProgram *program,
+                                                    CnDiagnostics *diagnostics,
+                                                    CnModuleLoader *loader,
+                                                    const char *source_file)
 {
     CnSemScope *global_scope;
     size_t i;
@@ -3213,7 +3361,7 @@ CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program,
     // 注册内置函数：打印 (print)
     CnSemSymbol *print_sym = cn_sem_scope_insert_symbol(global_scope, "打印", strlen("打印"), CN_SEM_SYMBOL_FUNCTION);
     if (print_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_primitive(CN_TYPE_STRING);
         print_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_VOID), param_types, 1);
     }
@@ -3221,7 +3369,7 @@ CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program,
     // 注册其他内置函数（简化，复用 cn_sem_build_scopes 的逻辑）
     CnSemSymbol *print_int_sym = cn_sem_scope_insert_symbol(global_scope, "打印整数", strlen("打印整数"), CN_SEM_SYMBOL_FUNCTION);
     if (print_int_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_primitive(CN_TYPE_INT);
         print_int_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_VOID), param_types, 1);
     }
@@ -3259,7 +3407,7 @@ CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program,
     // 注册内置函数：分配内存 (malloc)
     CnSemSymbol *malloc_sym = cn_sem_scope_insert_symbol(global_scope, "分配内存", strlen("分配内存"), CN_SEM_SYMBOL_FUNCTION);
     if (malloc_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_primitive(CN_TYPE_INT);  // size_t 简化为 int
         malloc_sym->type = cn_type_new_function(cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID)), param_types, 1);
     }
@@ -3267,7 +3415,7 @@ CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program,
     // 注册内置函数：释放内存 (free)
     CnSemSymbol *free_sym = cn_sem_scope_insert_symbol(global_scope, "释放内存", strlen("释放内存"), CN_SEM_SYMBOL_FUNCTION);
     if (free_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID));
         free_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_VOID), param_types, 1);
     }
@@ -3275,7 +3423,7 @@ CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program,
     // 注册内置函数：重新分配内存 (realloc)
     CnSemSymbol *realloc_sym = cn_sem_scope_insert_symbol(global_scope, "重新分配内存", strlen("重新分配内存"), CN_SEM_SYMBOL_FUNCTION);
     if (realloc_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *) * 2);
+        CnType *param_types[2];
         param_types[0] = cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID));
         param_types[1] = cn_type_new_primitive(CN_TYPE_INT);  // size_t 简化为 int
         realloc_sym->type = cn_type_new_function(cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID)), param_types, 2);
@@ -3284,7 +3432,7 @@ CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program,
     // 注册内置函数：分配清零内存 (calloc)
     CnSemSymbol *calloc_sym = cn_sem_scope_insert_symbol(global_scope, "分配清零内存", strlen("分配清零内存"), CN_SEM_SYMBOL_FUNCTION);
     if (calloc_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *) * 2);
+        CnType *param_types[2];
         param_types[0] = cn_type_new_primitive(CN_TYPE_INT);  // count
         param_types[1] = cn_type_new_primitive(CN_TYPE_INT);  // size
         calloc_sym->type = cn_type_new_function(cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID)), param_types, 2);
@@ -3293,7 +3441,7 @@ CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program,
     // 注册内置函数：分配内存数组 (malloc array)
     CnSemSymbol *malloc_array_sym = cn_sem_scope_insert_symbol(global_scope, "分配内存数组", strlen("分配内存数组"), CN_SEM_SYMBOL_FUNCTION);
     if (malloc_array_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *) * 2);
+        CnType *param_types[2];
         param_types[0] = cn_type_new_primitive(CN_TYPE_INT);  // type_size
         param_types[1] = cn_type_new_primitive(CN_TYPE_INT);  // count
         malloc_array_sym->type = cn_type_new_function(cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_VOID)), param_types, 2);
@@ -3303,7 +3451,7 @@ CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program,
     CnSemSymbol *sizeof_sym = cn_sem_scope_insert_symbol(global_scope, "类型大小", strlen("类型大小"), CN_SEM_SYMBOL_FUNCTION);
     if (sizeof_sym) {
         // 类型大小 接受任意类型参数，返回整数类型
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_primitive(CN_TYPE_UNKNOWN);  // 接受任意类型
         sizeof_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_INT), param_types, 1);
     }
@@ -3315,7 +3463,7 @@ CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program,
     // 注册内置函数：比较字符串 (strcmp)
     CnSemSymbol *strcmp_sym = cn_sem_scope_insert_symbol(global_scope, "比较字符串", strlen("比较字符串"), CN_SEM_SYMBOL_FUNCTION);
     if (strcmp_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *) * 2);
+        CnType *param_types[2];
         param_types[0] = cn_type_new_primitive(CN_TYPE_STRING);
         param_types[1] = cn_type_new_primitive(CN_TYPE_STRING);
         strcmp_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_INT), param_types, 2);
@@ -3324,7 +3472,7 @@ CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program,
     // 注册内置函数：字符串长度 (strlen)
     CnSemSymbol *strlen_sym = cn_sem_scope_insert_symbol(global_scope, "字符串长度", strlen("字符串长度"), CN_SEM_SYMBOL_FUNCTION);
     if (strlen_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *));
+        CnType *param_types[1];
         param_types[0] = cn_type_new_primitive(CN_TYPE_STRING);
         strlen_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_INT), param_types, 1);
     }
@@ -3332,7 +3480,7 @@ CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program,
     // 注册内置函数：复制字符串 (strcpy)
     CnSemSymbol *strcpy_sym = cn_sem_scope_insert_symbol(global_scope, "复制字符串", strlen("复制字符串"), CN_SEM_SYMBOL_FUNCTION);
     if (strcpy_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *) * 2);
+        CnType *param_types[2];
         param_types[0] = cn_type_new_primitive(CN_TYPE_STRING);  // dest
         param_types[1] = cn_type_new_primitive(CN_TYPE_STRING);  // src
         strcpy_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_STRING), param_types, 2);
@@ -3341,7 +3489,7 @@ CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program,
     // 注册内置函数：连接字符串 (strcat)
     CnSemSymbol *strcat_sym = cn_sem_scope_insert_symbol(global_scope, "连接字符串", strlen("连接字符串"), CN_SEM_SYMBOL_FUNCTION);
     if (strcat_sym) {
-        CnType **param_types = (CnType **)malloc(sizeof(CnType *) * 2);
+        CnType *param_types[2];
         param_types[0] = cn_type_new_primitive(CN_TYPE_STRING);  // dest
         param_types[1] = cn_type_new_primitive(CN_TYPE_STRING);  // src
         strcat_sym->type = cn_type_new_function(cn_type_new_primitive(CN_TYPE_STRING), param_types, 2);
@@ -3537,7 +3685,7 @@ CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program,
                 if (metadata && metadata->file_path) {
                     // 加载外部模块（支持嵌套导入）
                     CnSemScope *external_scope = compile_external_module_recursive(
-                        metadata->file_path, diagnostics, global_scope, loader, source_file);
+                        compilation, metadata->file_path, diagnostics, global_scope, loader, source_file);
                     
                     if (external_scope) {
                         // 处理导入逻辑
@@ -3791,7 +3939,8 @@ CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program,
                 char *resolved_path = NULL;
                 if (cn_module_loader_resolve_path_typed(loader, module_id, &resolved_path, import->target_type)) {
                     // 加载外部模块（支持嵌套导入）
-                    CnSemScope *external_scope = compile_external_module_recursive(resolved_path, 
+                    CnSemScope *external_scope = compile_external_module_recursive(compilation,
+                                                                          resolved_path,
                                                                           diagnostics, 
                                                                           global_scope,
                                                                           loader,
@@ -4087,6 +4236,7 @@ CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program,
                 // 3. 如果找到路径，编译外部模块
                 if (resolved_path) {
                     CnSemScope *external_scope = compile_external_module_recursive(
+                        compilation,
                         resolved_path,
                         diagnostics,
                         global_scope,
@@ -4347,6 +4497,8 @@ CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program,
         }
     }
 
+    resolve_embedded_globals(program, loader, source_file, diagnostics);
+
     // 注册全局变量
     for (i = 0; i < program->global_var_count; ++i) {
         CnAstStmt *var_stmt = program->global_vars[i];
@@ -4442,6 +4594,7 @@ CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program,
             sym->type = cn_type_new_function(return_type,
                                             param_types,
                                             function_decl->parameter_count);
+            free(param_types);
         } else {
             // 插入失败，检查是否是导入的符号
             CnSemSymbol *existing_sym = cn_sem_scope_lookup_shallow(global_scope,
@@ -4496,6 +4649,7 @@ CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program,
                     existing_sym->type = cn_type_new_function(return_type,
                                                     param_types,
                                                     function_decl->parameter_count);
+                    free(param_types);
                     existing_sym->decl_scope = global_scope;  // 标记为当前模块定义
                 } else {
                     // 检查是否是同一个符号（来自同一模块）
@@ -4525,7 +4679,7 @@ CnSemScope *cn_sem_build_scopes_with_loader(CnAstProgram *program,
             }
         }
 
-        cn_sem_build_function_scope(global_scope, function_decl, diagnostics);
+        cn_sem_build_function_scope(compilation, global_scope, function_decl, diagnostics);
     }
 
     return global_scope;
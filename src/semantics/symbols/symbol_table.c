@@ -1,46 +1,146 @@
 #include "cnlang/frontend/semantics.h"
+#include "cnlang/support/string_pool.h"
+#include "cnlang/support/thread.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+// 作用域符号数超过该值时建立哈希索引，较小的块作用域只用链表
+#define CN_SEM_SCOPE_INDEX_THRESHOLD 16
+
 // 符号链表节点，用于在作用域中维护符号列表
 typedef struct CnSemSymbolNode {
     CnSemSymbol symbol;
     struct CnSemSymbolNode *next;
+    struct CnSemSymbolNode *shadowed;  // 同一作用域中更早插入的同名符号（如模块与同名类型共存）
 } CnSemSymbolNode;
 
 // 作用域结构体的内部实现
 struct CnSemScope {
     CnSemScopeKind kind;
     CnSemScope *parent;
-    CnSemSymbolNode *symbols;
+    CnSemSymbolNode *symbols;  // 按插入逆序排列，决定遍历顺序
+    size_t symbol_count;
+    // 开放寻址哈希索引：以驻留名字指针为键，槽位指向该名字最新插入的符号，
+    // 更早的同名符号经 shadowed 链接；符号数未超过阈值时为 NULL
+    CnSemSymbolNode **index;
+    size_t index_capacity;     // 槽位数，为 2 的幂
     const char *name;          // 作用域名称(对于函数作用域为函数名)
     size_t name_length;        // 作用域名称长度
     CnFileModuleSemInfo *file_module_info;  // 文件模块信息（仅当kind==CN_SEM_SCOPE_FILE_MODULE时有效）
+    // 标识符查找缓存的有效性依据：id 在进程内唯一，stamp 为最近一次插入符号的时间戳
+    uint32_t id;
+    uint32_t stamp;
 };
 
-static int cn_sem_symbol_name_equals(const CnSemSymbol *symbol,
-                                     const char *name,
-                                     size_t name_length)
+// 作用域编号与时间戳共用一个递增计数器（0 保留为"未缓存"）；并行类型检查的线程同样会创建作用域
+static CnAtomicCounter g_scope_clock = 0;
+
+// 校验模式：命中缓存时重新计算并比较（见 cn_sem_cache_set_verify）
+static bool g_cache_verify = false;
+static CnAtomicCounter g_cache_verify_failures = 0;
+
+static uint32_t cn_sem_scope_tick(void)
 {
-    if (!symbol || !name) {
-        return 0;
+    return (uint32_t)cn_atomic_increment(&g_scope_clock);
+}
+
+// 符号名在插入时驻留到共享字符串池，查找时先把名字解析为驻留指针，
+// 之后沿作用域链只需比较指针；池中不存在该名字即说明任何作用域都没有此符号
+static const char *cn_sem_symbol_key(const char *name, size_t name_length)
+{
+    return cn_string_pool_find(cn_string_pool_default(), name, name_length);
+}
+
+static size_t cn_sem_symbol_key_hash(const char *key)
+{
+    uint64_t value = (uint64_t)(uintptr_t)key;
+
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    return (size_t)value;
+}
+
+// 返回名字在索引中的槽位：命中时槽位非空，否则为可插入的空槽
+static CnSemSymbolNode **cn_sem_scope_index_slot(CnSemScope *scope, const char *key)
+{
+    size_t mask = scope->index_capacity - 1;
+    size_t i = cn_sem_symbol_key_hash(key) & mask;
+
+    while (scope->index[i] && scope->index[i]->symbol.name != key) {
+        i = (i + 1) & mask;
     }
+    return &scope->index[i];
+}
+
+// 按新容量重建索引；链表从新到旧遍历，每个名字只登记最新的符号
+static int cn_sem_scope_index_rebuild(CnSemScope *scope, size_t capacity)
+{
+    CnSemSymbolNode **index = (CnSemSymbolNode **)calloc(capacity, sizeof(CnSemSymbolNode *));
 
-    if (symbol->name_length != name_length) {
+    if (!index) {
         return 0;
     }
+    free(scope->index);
+    scope->index = index;
+    scope->index_capacity = capacity;
 
-    if (symbol->name == name) {
-        return 1;
+    for (CnSemSymbolNode *node = scope->symbols; node; node = node->next) {
+        CnSemSymbolNode **slot = cn_sem_scope_index_slot(scope, node->symbol.name);
+        if (!*slot) {
+            *slot = node;
+        }
     }
+    return 1;
+}
 
-    if (!symbol->name) {
-        return 0;
+// 登记新插入的符号；超过阈值时建立索引，负载超过一半时扩容。
+// 内存不足时保留原状，查找退回链表遍历
+static void cn_sem_scope_index_add(CnSemScope *scope, CnSemSymbolNode *node)
+{
+    size_t capacity = 64;
+
+    if (scope->symbol_count <= CN_SEM_SCOPE_INDEX_THRESHOLD) {
+        return;
+    }
+    if (scope->index && scope->symbol_count * 2 <= scope->index_capacity) {
+        *cn_sem_scope_index_slot(scope, node->symbol.name) = node;
+        return;
+    }
+    while (scope->symbol_count * 2 > capacity) {
+        capacity *= 2;
     }
+    if (!cn_sem_scope_index_rebuild(scope, capacity)) {
+        free(scope->index);
+        scope->index = NULL;
+        scope->index_capacity = 0;
+    }
+}
+
+// 查找当前作用域中该名字最新插入的符号
+static CnSemSymbolNode *cn_sem_scope_find_node(CnSemScope *scope, const char *key)
+{
+    if (scope->index) {
+        return *cn_sem_scope_index_slot(scope, key);
+    }
+
+    CnSemSymbolNode *node = scope->symbols;
+    while (node) {
+        if (node->symbol.name == key) {
+            return node;
+        }
+        node = node->next;
+    }
+    return NULL;
+}
 
-    return memcmp(symbol->name, name, name_length) == 0;
+static CnSemSymbol *cn_sem_scope_find_key(CnSemScope *scope, const char *key)
+{
+    CnSemSymbolNode *node = cn_sem_scope_find_node(scope, key);
+    return node ? &node->symbol : NULL;
 }
 
 CnSemScope *cn_sem_scope_new(CnSemScopeKind kind, CnSemScope *parent)
@@ -55,9 +155,14 @@ CnSemScope *cn_sem_scope_new(CnSemScopeKind kind, CnSemScope *parent)
     scope->kind = kind;
     scope->parent = parent;
     scope->symbols = NULL;
+    scope->symbol_count = 0;
+    scope->index = NULL;
+    scope->index_capacity = 0;
     scope->name = NULL;
     scope->name_length = 0;
     scope->file_module_info = NULL;
+    scope->id = cn_sem_scope_tick();
+    scope->stamp = scope->id;
 
     return scope;
 }
@@ -78,6 +183,7 @@ void cn_sem_scope_free(CnSemScope *scope)
         node = next;
     }
 
+    free(scope->index);
     free(scope);
 }
 
@@ -133,10 +239,7 @@ static int cn_sem_is_same_symbol(const CnSemSymbol *sym1, const CnSemSymbol *sym
     }
     
     // 检查名字是否相同
-    if (sym1->name_length != sym2->name_length) {
-        return 0;
-    }
-    if (memcmp(sym1->name, sym2->name, sym1->name_length) != 0) {
+    if (!cn_name_equals(sym1->name, sym1->name_length, sym2->name, sym2->name_length)) {
         return 0;
     }
     
@@ -195,6 +298,11 @@ CnSemSymbol *cn_sem_scope_insert_symbol(CnSemScope *scope,
         }
     }
 
+    name = cn_string_pool_intern(cn_string_pool_default(), name, name_length);
+    if (!name) {
+        return NULL;
+    }
+
     node = (CnSemSymbolNode *)malloc(sizeof(CnSemSymbolNode));
     if (!node) {
         return NULL;
@@ -212,7 +320,11 @@ CnSemSymbol *cn_sem_scope_insert_symbol(CnSemScope *scope,
     node->symbol.as.module_scope = NULL; // 初始化 module_scope 为 NULL
 
     node->next = scope->symbols;
+    node->shadowed = (CnSemSymbolNode *)existing;
     scope->symbols = node;
+    scope->symbol_count++;
+    cn_sem_scope_index_add(scope, node);
+    scope->stamp = cn_sem_scope_tick();
 
     return &node->symbol;
 }
@@ -227,22 +339,18 @@ CnSemSymbol *cn_sem_scope_lookup_shallow(CnSemScope *scope,
                                          const char *name,
                                          size_t name_length)
 {
-    CnSemSymbolNode *node;
+    const char *key;
 
     if (!scope || !name || name_length == 0) {
         return NULL;
     }
 
-    node = scope->symbols;
-    while (node) {
-        if (cn_sem_symbol_name_equals(&node->symbol, name, name_length)) {
-            return &node->symbol;
-        }
-
-        node = node->next;
+    key = cn_sem_symbol_key(name, name_length);
+    if (!key) {
+        return NULL;
     }
 
-    return NULL;
+    return cn_sem_scope_find_key(scope, key);
 }
 
 CnSemSymbol *cn_sem_scope_lookup(CnSemScope *scope,
@@ -250,13 +358,19 @@ CnSemSymbol *cn_sem_scope_lookup(CnSemScope *scope,
                                  size_t name_length)
 {
     CnSemSymbol *symbol;
+    const char *key;
 
     if (!scope || !name || name_length == 0) {
         return NULL;
     }
 
+    key = cn_sem_symbol_key(name, name_length);
+    if (!key) {
+        return NULL;
+    }
+
     while (scope) {
-        symbol = cn_sem_scope_lookup_shallow(scope, name, name_length);
+        symbol = cn_sem_scope_find_key(scope, key);
         if (symbol) {
             return symbol;
         }
@@ -275,27 +389,30 @@ CnSemSymbol *cn_sem_scope_lookup_by_kind(CnSemScope *scope,
                                          CnSemSymbolKind preferred_kind)
 {
     CnSemSymbol *fallback = NULL;  // 用于存储非首选类型的符号
+    const char *key;
 
     if (!scope || !name || name_length == 0) {
         return NULL;
     }
 
+    key = cn_sem_symbol_key(name, name_length);
+    if (!key) {
+        return NULL;
+    }
+
     while (scope) {
-        // 遍历当前作用域的所有符号
-        CnSemSymbolNode *node = scope->symbols;
+        // 从新到旧遍历当前作用域中的同名符号
+        CnSemSymbolNode *node = cn_sem_scope_find_node(scope, key);
         while (node) {
-            if (cn_sem_symbol_name_equals(&node->symbol, name, name_length)) {
-                // 找到同名符号
-                if (node->symbol.kind == preferred_kind) {
-                    // 找到首选类型的符号，直接返回
-                    return &node->symbol;
-                }
-                // 记录第一个找到的非首选类型符号作为备选
-                if (!fallback) {
-                    fallback = &node->symbol;
-                }
+            if (node->symbol.kind == preferred_kind) {
+                // 找到首选类型的符号，直接返回
+                return &node->symbol;
             }
-            node = node->next;
+            // 记录第一个找到的非首选类型符号作为备选
+            if (!fallback) {
+                fallback = &node->symbol;
+            }
+            node = node->shadowed;
         }
         scope = scope->parent;
     }
@@ -304,6 +421,123 @@ CnSemSymbol *cn_sem_scope_lookup_by_kind(CnSemScope *scope,
     return fallback;
 }
 
+// 缓存只在从同一作用域查找、且起点到根的作用域此后都未插入符号时有效
+static bool cn_sem_identifier_cache_valid(CnSemScope *scope, const CnAstIdentifierExpr *ident)
+{
+    if (ident->symbol_scope_id == 0 || ident->symbol_scope_id != scope->id) {
+        return false;
+    }
+    for (; scope; scope = scope->parent) {
+        if (scope->stamp > ident->symbol_stamp) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static CnSemSymbol *cn_sem_identifier_lookup(CnSemScope *scope,
+                                             CnAstExpr *ident_expr,
+                                             bool by_kind,
+                                             CnSemSymbolKind preferred_kind)
+{
+    CnAstIdentifierExpr *ident;
+    CnSemSymbol *first = NULL;
+    CnSemSymbol *preferred = NULL;
+    CnSemSymbol *fresh;
+    size_t count = 0;
+    const char *key;
+
+    if (!scope || !ident_expr || ident_expr->kind != CN_AST_EXPR_IDENTIFIER) {
+        return NULL;
+    }
+    ident = &ident_expr->as.identifier;
+    if (!ident->name || ident->name_length == 0) {
+        return NULL;
+    }
+
+    if (cn_sem_identifier_cache_valid(scope, ident)) {
+        if (!g_cache_verify) {
+            return ident->symbol;
+        }
+        fresh = by_kind
+            ? cn_sem_scope_lookup_by_kind(scope, ident->name, ident->name_length, preferred_kind)
+            : cn_sem_scope_lookup(scope, ident->name, ident->name_length);
+        if (fresh != ident->symbol) {
+            cn_sem_cache_report_mismatch("符号", ident_expr);
+            ident->symbol = fresh;
+        }
+        return fresh;
+    }
+
+    // 一次遍历同时得到普通查找与按种类查找的结果，并统计链上同名符号的个数
+    key = cn_sem_symbol_key(ident->name, ident->name_length);
+    for (CnSemScope *current = key ? scope : NULL; current && count < 2; current = current->parent) {
+        for (CnSemSymbolNode *node = cn_sem_scope_find_node(current, key); node; node = node->shadowed) {
+            if (!first) {
+                first = &node->symbol;
+            }
+            if (!preferred && node->symbol.kind == preferred_kind) {
+                preferred = &node->symbol;
+            }
+            count++;
+        }
+    }
+
+    // 名字在链上唯一（或不存在）时两种查找结果相同，才写入缓存
+    if (count <= 1) {
+        ident->symbol = first;
+        ident->symbol_scope_id = scope->id;
+        ident->symbol_stamp = (uint32_t)cn_atomic_load(&g_scope_clock);
+        return first;
+    }
+    if (!by_kind) {
+        return first;
+    }
+    return cn_sem_scope_lookup_by_kind(scope, ident->name, ident->name_length, preferred_kind);
+}
+
+CnSemSymbol *cn_sem_scope_lookup_identifier(CnSemScope *scope, CnAstExpr *ident_expr)
+{
+    return cn_sem_identifier_lookup(scope, ident_expr, false, CN_SEM_SYMBOL_VARIABLE);
+}
+
+CnSemSymbol *cn_sem_scope_lookup_identifier_by_kind(CnSemScope *scope,
+                                                    CnAstExpr *ident_expr,
+                                                    CnSemSymbolKind preferred_kind)
+{
+    return cn_sem_identifier_lookup(scope, ident_expr, true, preferred_kind);
+}
+
+void cn_sem_cache_set_verify(bool enabled)
+{
+    g_cache_verify = enabled;
+}
+
+bool cn_sem_cache_verify_enabled(void)
+{
+    return g_cache_verify;
+}
+
+size_t cn_sem_cache_verify_failures(void)
+{
+    return (size_t)cn_atomic_load(&g_cache_verify_failures);
+}
+
+void cn_sem_cache_report_mismatch(const char *what, const CnAstExpr *expr)
+{
+    const char *filename = expr->loc.filename ? expr->loc.filename : "<未知>";
+
+    cn_atomic_increment(&g_cache_verify_failures);
+    if (expr->kind == CN_AST_EXPR_IDENTIFIER) {
+        fprintf(stderr, "语义缓存校验失败：%s:%d:%d 标识符 '%.*s' 缓存的%s与重新计算的结果不一致\n",
+                filename, expr->loc.line, expr->loc.column,
+                (int)expr->as.identifier.name_length, expr->as.identifier.name, what);
+    } else {
+        fprintf(stderr, "语义缓存校验失败：%s:%d:%d 表达式缓存的%s与重新计算的结果不一致\n",
+                filename, expr->loc.line, expr->loc.column, what);
+    }
+}
+
 void cn_sem_scope_foreach_symbol(CnSemScope *scope,
                                   CnSemScopeSymbolCallback callback,
                                   void *user_data)
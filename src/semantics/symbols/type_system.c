@@ -1,51 +1,438 @@
 #include "cnlang/frontend/semantics.h"
+#include "cnlang/support/string_pool.h"
+#include "cnlang/support/memory/arena.h"
+#include "cnlang/support/thread.h"
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
+/*
+ * 类型上下文：类型节点从上下文的 Arena 分配，随上下文一起释放。
+ * 基本类型每种只有一个节点；指针、数组、函数类型按组成部分的节点地址驻留在
+ * 开放寻址哈希表中（线性探测，负载因子保持在 1/2 以下），结构相同即共享同一节点。
+ * 结构体、枚举、类与接口按名字区分，且字段、枚举作用域在语义分析中才补全，不参与驻留。
+ * 并发模式下主驻留表只读，新类型在互斥锁保护下写入暂存表，退出并发模式时再并入主表。
+ */
+
+#define CN_TYPE_CONTEXT_INITIAL_SLOTS 1024
+#define CN_TYPE_CONTEXT_ARENA_BLOCK   (64 * 1024)
+#define CN_TYPE_CONTEXT_OVERFLOW_SLOTS 256
+
+struct CnTypeContext {
+    CnArena *arena;                            // 全部类型节点
+    CnType *primitives[CN_TYPE_UNKNOWN + 1];   // 每种基本类型的规范节点
+    CnType **slots;                            // 指针、数组、函数类型的驻留表
+    size_t slot_count;                         // 槽数（2 的幂）
+    size_t interned_count;                     // 驻留的复合类型数量
+    size_t node_count;                         // 已分配的类型节点数量
+    size_t intern_calls;                       // 复合类型构造次数
+    size_t hit_count;                          // 命中已有节点的次数
+    CnType **overflow_slots;                   // 并发模式下新驻留类型的暂存表
+    size_t overflow_slot_count;                // 暂存表槽数（2 的幂）
+    size_t overflow_count;                     // 暂存表中的类型数量
+    CnMutex lock;                              // 并发模式下保护 Arena 与暂存表
+    bool lock_ready;                           // lock 是否已初始化
+    bool concurrent;                           // 是否处于并发模式
+};
+
+static CnTypeContext *g_default_type_context = NULL;
+
+CnTypeContext *cn_type_context_new(void) {
+    CnTypeContext *context = (CnTypeContext *)calloc(1, sizeof(CnTypeContext));
+    if (!context) {
+        return NULL;
+    }
+    context->arena = cn_arena_new(CN_TYPE_CONTEXT_ARENA_BLOCK);
+    context->slots = (CnType **)calloc(CN_TYPE_CONTEXT_INITIAL_SLOTS, sizeof(CnType *));
+    if (!context->arena || !context->slots) {
+        cn_arena_free(context->arena);
+        free(context->slots);
+        free(context);
+        return NULL;
+    }
+    context->slot_count = CN_TYPE_CONTEXT_INITIAL_SLOTS;
+    return context;
+}
+
+void cn_type_context_free(CnTypeContext *context) {
+    if (!context) {
+        return;
+    }
+    if (context->lock_ready) {
+        cn_mutex_destroy(&context->lock);
+    }
+    free(context->overflow_slots);
+    free(context->slots);
+    cn_arena_free(context->arena);
+    free(context);
+}
+
+CnTypeContext *cn_type_context_default(void) {
+    if (!g_default_type_context) {
+        g_default_type_context = cn_type_context_new();
+    }
+    return g_default_type_context;
+}
+
+void cn_type_context_release_default(void) {
+    cn_type_context_free(g_default_type_context);
+    g_default_type_context = NULL;
+}
+
+void cn_type_context_get_stats(const CnTypeContext *context, CnTypeContextStats *stats) {
+    size_t block_count = 0;
+
+    if (!stats) {
+        return;
+    }
+    memset(stats, 0, sizeof(*stats));
+    if (!context) {
+        return;
+    }
+    stats->node_count = context->node_count;
+    stats->interned_count = context->interned_count;
+    stats->intern_calls = context->intern_calls;
+    stats->hit_count = context->hit_count;
+    stats->table_bytes = context->slot_count * sizeof(CnType *);
+    cn_arena_get_stats(context->arena, &stats->arena_bytes, &block_count);
+}
+
+// 分配一个类型节点；上下文不可用时返回 NULL
+static CnType *type_alloc(CnTypeContext *context, CnTypeKind kind) {
+    CnType *type;
+
+    if (!context) {
+        return NULL;
+    }
+    type = (CnType *)cn_arena_alloc(context->arena, sizeof(CnType));
+    if (!type) {
+        return NULL;
+    }
+    memset(type, 0, sizeof(*type));
+    type->kind = kind;
+    context->node_count++;
+    return type;
+}
+
+// 创建不参与驻留的节点：并发模式下 Arena 由多个线程共享，需要加锁
+static CnType *type_alloc_shared(CnTypeContext *context, CnTypeKind kind) {
+    CnType *type;
+
+    if (!context || !context->concurrent) {
+        return type_alloc(context, kind);
+    }
+    cn_mutex_lock(&context->lock);
+    type = type_alloc(context, kind);
+    cn_mutex_unlock(&context->lock);
+    return type;
+}
+
+// 组成部分均为规范节点且不含具名类型时，结构相等当且仅当节点相同
+static bool type_part_is_closed(const CnType *type) {
+    return !type || (type->flags & CN_TYPE_FLAG_CLOSED);
+}
+
+static size_t type_hash_pointer(size_t hash, const void *pointer) {
+    uint64_t value = (uint64_t)(uintptr_t)pointer;
+
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    return (hash ^ (size_t)value) * (size_t)0x100000001b3ULL;
+}
+
+static size_t type_hash_key(const CnType *key) {
+    size_t hash = (size_t)key->kind * (size_t)0x9e3779b97f4a7c15ULL;
+
+    switch (key->kind) {
+        case CN_TYPE_POINTER:
+            return type_hash_pointer(hash, key->as.pointer_to);
+        case CN_TYPE_ARRAY:
+            hash = type_hash_pointer(hash, key->as.array.element_type);
+            return type_hash_pointer(hash, (const void *)(uintptr_t)key->as.array.length);
+        case CN_TYPE_FUNCTION:
+            hash = type_hash_pointer(hash, key->as.function.return_type);
+            hash = type_hash_pointer(hash, (const void *)(uintptr_t)key->as.function.param_count);
+            for (size_t i = 0; i < key->as.function.param_count; i++) {
+                hash = type_hash_pointer(hash, key->as.function.param_types[i]);
+            }
+            return hash;
+        default:
+            return hash;
+    }
+}
+
+// 复合类型按组成部分的节点地址比较
+static bool type_key_equals(const CnType *a, const CnType *b) {
+    if (a->kind != b->kind) {
+        return false;
+    }
+    switch (a->kind) {
+        case CN_TYPE_POINTER:
+            return a->as.pointer_to == b->as.pointer_to;
+        case CN_TYPE_ARRAY:
+            return a->as.array.element_type == b->as.array.element_type &&
+                   a->as.array.length == b->as.array.length;
+        case CN_TYPE_FUNCTION:
+            if (a->as.function.return_type != b->as.function.return_type ||
+                a->as.function.param_count != b->as.function.param_count) {
+                return false;
+            }
+            for (size_t i = 0; i < a->as.function.param_count; i++) {
+                if (a->as.function.param_types[i] != b->as.function.param_types[i]) {
+                    return false;
+                }
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+static size_t type_find_slot(CnType *const *slots, size_t slot_count, const CnType *key, size_t hash) {
+    size_t mask = slot_count - 1;
+    size_t index = hash & mask;
+
+    while (slots[index] && !type_key_equals(slots[index], key)) {
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+// 驻留表扩容一倍（主表与暂存表共用）
+static bool type_grow_slots(CnType ***slots, size_t *slot_count) {
+    size_t new_count = *slot_count * 2;
+    CnType **new_slots = (CnType **)calloc(new_count, sizeof(CnType *));
+    if (!new_slots) {
+        return false;
+    }
+
+    size_t mask = new_count - 1;
+    for (size_t i = 0; i < *slot_count; i++) {
+        CnType *type = (*slots)[i];
+        if (!type) {
+            continue;
+        }
+        size_t index = type_hash_key(type) & mask;
+        while (new_slots[index]) {
+            index = (index + 1) & mask;
+        }
+        new_slots[index] = type;
+    }
+
+    free(*slots);
+    *slots = new_slots;
+    *slot_count = new_count;
+    return true;
+}
+
+// 按 key 创建规范节点（函数类型的参数数组复制到 Arena）
+static CnType *type_new_interned(CnTypeContext *context, const CnType *key, bool closed) {
+    CnType *type = type_alloc(context, key->kind);
+    if (!type) {
+        return NULL;
+    }
+    type->as = key->as;
+    if (key->kind == CN_TYPE_FUNCTION && key->as.function.param_count > 0) {
+        size_t bytes = key->as.function.param_count * sizeof(CnType *);
+        type->as.function.param_types = (CnType **)cn_arena_alloc(context->arena, bytes);
+        if (!type->as.function.param_types) {
+            return NULL;
+        }
+        memcpy(type->as.function.param_types, key->as.function.param_types, bytes);
+    }
+    type->flags = CN_TYPE_FLAG_INTERNED | (closed ? CN_TYPE_FLAG_CLOSED : 0);
+    return type;
+}
+
+// 并发模式下主表未命中：在暂存表中查找或创建（调用者持有 context->lock）
+static CnType *type_intern_overflow(CnTypeContext *context, const CnType *key, size_t hash, bool closed) {
+    size_t index = type_find_slot(context->overflow_slots, context->overflow_slot_count, key, hash);
+    CnType *type = context->overflow_slots[index];
+
+    if (type) {
+        return type;
+    }
+    if ((context->overflow_count + 1) * 2 > context->overflow_slot_count) {
+        if (!type_grow_slots(&context->overflow_slots, &context->overflow_slot_count)) {
+            return NULL;
+        }
+        index = type_find_slot(context->overflow_slots, context->overflow_slot_count, key, hash);
+    }
+    type = type_new_interned(context, key, closed);
+    if (!type) {
+        return NULL;
+    }
+    context->overflow_slots[index] = type;
+    context->overflow_count++;
+    return type;
+}
+
+// 返回与 key 结构相同的规范节点，不存在时按 key 创建
+static CnType *type_intern(CnTypeContext *context, const CnType *key, bool closed) {
+    size_t hash;
+    size_t index;
+    CnType *type;
+
+    if (!context) {
+        return NULL;
+    }
+    hash = type_hash_key(key);
+    index = type_find_slot(context->slots, context->slot_count, key, hash);
+    if (context->concurrent) {
+        // 主表只读：命中直接返回（不计入统计），未命中在锁内写入暂存表
+        if (context->slots[index]) {
+            return context->slots[index];
+        }
+        cn_mutex_lock(&context->lock);
+        type = type_intern_overflow(context, key, hash, closed);
+        cn_mutex_unlock(&context->lock);
+        return type;
+    }
+
+    context->intern_calls++;
+    if (context->slots[index]) {
+        context->hit_count++;
+        return context->slots[index];
+    }
+
+    if ((context->interned_count + 1) * 2 > context->slot_count) {
+        if (!type_grow_slots(&context->slots, &context->slot_count)) {
+            return NULL;
+        }
+        index = type_find_slot(context->slots, context->slot_count, key, hash);
+    }
+
+    type = type_new_interned(context, key, closed);
+    if (!type) {
+        return NULL;
+    }
+    context->slots[index] = type;
+    context->interned_count++;
+    return type;
+}
+
+bool cn_type_context_begin_concurrent(CnTypeContext *context) {
+    if (!context) {
+        return false;
+    }
+    if (context->concurrent) {
+        return true;
+    }
+    // 基本类型按需创建，进入并发模式前全部建好，之后只读
+    for (int kind = 0; kind <= CN_TYPE_UNKNOWN; kind++) {
+        if (!context->primitives[kind]) {
+            CnType *type = type_alloc(context, (CnTypeKind)kind);
+            if (!type) {
+                return false;
+            }
+            type->flags = CN_TYPE_FLAG_INTERNED | CN_TYPE_FLAG_CLOSED;
+            context->primitives[kind] = type;
+        }
+    }
+    if (!context->overflow_slots) {
+        context->overflow_slots = (CnType **)calloc(CN_TYPE_CONTEXT_OVERFLOW_SLOTS, sizeof(CnType *));
+        if (!context->overflow_slots) {
+            return false;
+        }
+        context->overflow_slot_count = CN_TYPE_CONTEXT_OVERFLOW_SLOTS;
+    }
+    if (!context->lock_ready) {
+        if (!cn_mutex_init(&context->lock)) {
+            return false;
+        }
+        context->lock_ready = true;
+    }
+    context->concurrent = true;
+    return true;
+}
+
+void cn_type_context_end_concurrent(CnTypeContext *context) {
+    if (!context || !context->concurrent) {
+        return;
+    }
+    context->concurrent = false;
+
+    // 暂存表中的节点都是主表未命中时创建的，直接并入主表
+    for (size_t i = 0; i < context->overflow_slot_count; i++) {
+        CnType *type = context->overflow_slots[i];
+        size_t index;
+
+        if (!type) {
+            continue;
+        }
+        context->overflow_slots[i] = NULL;
+        if ((context->interned_count + 1) * 2 > context->slot_count &&
+            !type_grow_slots(&context->slots, &context->slot_count)) {
+            continue;
+        }
+        index = type_find_slot(context->slots, context->slot_count, type, type_hash_key(type));
+        if (!context->slots[index]) {
+            context->slots[index] = type;
+            context->interned_count++;
+        }
+    }
+    context->overflow_count = 0;
+}
+
 CnType *cn_type_new_primitive(CnTypeKind kind) {
-    CnType *type = (CnType *)malloc(sizeof(CnType));
+    CnTypeContext *context = cn_type_context_default();
+    CnType *type = NULL;
+
+    if (context && (unsigned)kind <= CN_TYPE_UNKNOWN) {
+        type = context->primitives[kind];
+        if (!type) {
+            type = type_alloc_shared(context, kind);
+            if (type) {
+                type->flags = CN_TYPE_FLAG_INTERNED | CN_TYPE_FLAG_CLOSED;
+                context->primitives[kind] = type;
+            }
+        }
+    }
     if (!type) {
         // 内存分配失败时返回一个静态的未知类型，避免 NULL 指针
         static CnType unknown_type = { .kind = CN_TYPE_UNKNOWN };
         return &unknown_type;
     }
-    type->kind = kind;
     return type;
 }
 
 CnType *cn_type_new_pointer(CnType *base) {
-    CnType *type = (CnType *)malloc(sizeof(CnType));
-    if (!type) return NULL;
-    type->kind = CN_TYPE_POINTER;
-    type->as.pointer_to = base;
-    return type;
+    CnType key = { .kind = CN_TYPE_POINTER };
+
+    key.as.pointer_to = base;
+    return type_intern(cn_type_context_default(), &key, type_part_is_closed(base));
 }
 
 CnType *cn_type_new_array(CnType *element, size_t length) {
-    CnType *type = (CnType *)malloc(sizeof(CnType));
-    if (!type) return NULL;
-    type->kind = CN_TYPE_ARRAY;
-    type->as.array.element_type = element;
-    type->as.array.length = length;
-    return type;
+    CnType key = { .kind = CN_TYPE_ARRAY };
+
+    key.as.array.element_type = element;
+    key.as.array.length = length;
+    return type_intern(cn_type_context_default(), &key, type_part_is_closed(element));
 }
 
 CnType *cn_type_new_function(CnType *return_type, CnType **param_types, size_t param_count) {
-    CnType *type = (CnType *)malloc(sizeof(CnType));
-    if (!type) return NULL;
-    type->kind = CN_TYPE_FUNCTION;
-    type->as.function.return_type = return_type;
-    type->as.function.param_types = param_types;
-    type->as.function.param_count = param_count;
-    return type;
+    CnType key = { .kind = CN_TYPE_FUNCTION };
+    bool closed = type_part_is_closed(return_type);
+
+    if (param_count > 0 && !param_types) {
+        return NULL;
+    }
+    for (size_t i = 0; i < param_count; i++) {
+        closed = closed && type_part_is_closed(param_types[i]);
+    }
+    key.as.function.return_type = return_type;
+    key.as.function.param_types = param_types;
+    key.as.function.param_count = param_count;
+    return type_intern(cn_type_context_default(), &key, closed);
 }
 
 // 创建结构体类型
 CnType *cn_type_new_struct(const char *name, size_t name_length, CnStructField *fields, size_t field_count, CnSemScope *decl_scope, const char *owner_func_name, size_t owner_func_name_length) {
-    CnType *type = (CnType *)malloc(sizeof(CnType));
+    CnType *type = type_alloc_shared(cn_type_context_default(), CN_TYPE_STRUCT);
     if (!type) return NULL;
-    type->kind = CN_TYPE_STRUCT;
     type->as.struct_type.name = name;
     type->as.struct_type.name_length = name_length;
     type->as.struct_type.fields = fields;
@@ -58,9 +445,8 @@ CnType *cn_type_new_struct(const char *name, size_t name_length, CnStructField *
 
 // 创建枚举类型
 CnType *cn_type_new_enum(const char *name, size_t name_length) {
-    CnType *type = (CnType *)malloc(sizeof(CnType));
+    CnType *type = type_alloc_shared(cn_type_context_default(), CN_TYPE_ENUM);
     if (!type) return NULL;
-    type->kind = CN_TYPE_ENUM;
     type->as.enum_type.name = name;
     type->as.enum_type.name_length = name_length;
     type->as.enum_type.enum_scope = NULL; // 作用域将在scope_builder中创建
@@ -68,16 +454,116 @@ CnType *cn_type_new_enum(const char *name, size_t name_length) {
 }
 
 CnType *cn_type_new_memory_address(void) {
-    CnType *type = (CnType *)malloc(sizeof(CnType));
+    return cn_type_new_primitive(CN_TYPE_MEMORY_ADDRESS);
+}
+
+// 创建不参与驻留的指针类型，供深度复制先占位、补全结构体后再改写目标类型
+static CnType *type_new_pointer_placeholder(CnType *base) {
+    CnType *type = type_alloc_shared(cn_type_context_default(), CN_TYPE_POINTER);
     if (!type) return NULL;
-    type->kind = CN_TYPE_MEMORY_ADDRESS;
+    type->as.pointer_to = base;
     return type;
 }
 
+// 补全日志条目：stub 非空时把 source 的字段信息补到 stub 上，否则把 *location 从 expected 改为 value
+typedef struct CnTypePatch {
+    CnType *stub;
+    CnType *source;
+    CnType **location;
+    CnType *expected;
+    CnType *value;
+} CnTypePatch;
+
+struct CnTypePatchLog {
+    CnTypePatch *items;
+    size_t count;
+    size_t capacity;
+};
+
+// 当前线程的补全日志（NULL 表示直接修改类型节点）
+static _Thread_local CnTypePatchLog *g_patch_log = NULL;
+
+CnTypePatchLog *cn_type_patch_log_new(void) {
+    return (CnTypePatchLog *)calloc(1, sizeof(CnTypePatchLog));
+}
+
+void cn_type_patch_log_free(CnTypePatchLog *log) {
+    if (!log) {
+        return;
+    }
+    free(log->items);
+    free(log);
+}
+
+void cn_type_set_patch_log(CnTypePatchLog *log) {
+    g_patch_log = log;
+}
+
+// 追加日志条目；内存不足时丢弃，只是少补全一次，之后仍可按名字动态解析
+static void type_patch_log_push(CnTypePatchLog *log, const CnTypePatch *patch) {
+    if (log->count == log->capacity) {
+        size_t new_capacity = log->capacity == 0 ? 16 : log->capacity * 2;
+        CnTypePatch *new_items = (CnTypePatch *)realloc(log->items, new_capacity * sizeof(CnTypePatch));
+        if (!new_items) {
+            return;
+        }
+        log->items = new_items;
+        log->capacity = new_capacity;
+    }
+    log->items[log->count++] = *patch;
+}
+
+// 与串行检查一致：先补全的生效，之后的条目发现目标已被改写就跳过
+void cn_type_patch_log_apply(CnTypePatchLog *log) {
+    if (!log) {
+        return;
+    }
+    for (size_t i = 0; i < log->count; i++) {
+        CnTypePatch *patch = &log->items[i];
+        if (patch->stub) {
+            if (!patch->stub->as.struct_type.fields) {
+                patch->stub->as.struct_type.fields = patch->source->as.struct_type.fields;
+                patch->stub->as.struct_type.field_count = patch->source->as.struct_type.field_count;
+                patch->stub->as.struct_type.decl_scope = patch->source->as.struct_type.decl_scope;
+            }
+        } else if (*patch->location == patch->expected) {
+            *patch->location = patch->value;
+        }
+    }
+    log->count = 0;
+}
+
+// 改写共享类型中的类型指针：设置了补全日志时仅记录
+static void type_patch_pointer(CnType **location, CnType *value) {
+    if (g_patch_log) {
+        CnTypePatch patch = { NULL, NULL, location, *location, value };
+        type_patch_log_push(g_patch_log, &patch);
+    } else {
+        *location = value;
+    }
+}
+
+void cn_type_patch_field_type(CnStructField *field, CnType *type) {
+    if (field) {
+        type_patch_pointer(&field->field_type, type);
+    }
+}
+
+// 改写指针字段的目标类型：占位节点原地修改；驻留的规范节点可能被共享，换成新的指针类型
+static void type_retarget_pointer_field(CnType **field_type, CnType *target) {
+    if ((*field_type)->flags & CN_TYPE_FLAG_INTERNED) {
+        type_patch_pointer(field_type, cn_type_new_pointer(target));
+    } else {
+        type_patch_pointer(&(*field_type)->as.pointer_to, target);
+    }
+}
+
 bool cn_type_equals(CnType *a, CnType *b) {
     if (a == b) return true;
     if (!a || !b) return false;
     if (a->kind != b->kind) return false;
+    // 不含具名类型的规范节点结构相同即为同一节点
+    if ((a->flags & CN_TYPE_FLAG_CLOSED) && (b->flags & CN_TYPE_FLAG_CLOSED)) return false;
 
     switch (a->kind) {
         case CN_TYPE_POINTER:
@@ -92,17 +578,12 @@ bool cn_type_equals(CnType *a, CnType *b) {
             if (!a->as.struct_type.name || !b->as.struct_type.name) {
                 return false;
             }
-            if (a->as.struct_type.name_length != b->as.struct_type.name_length) {
-                return false;
-            }
-            if (memcmp(a->as.struct_type.name, b->as.struct_type.name, a->as.struct_type.name_length) != 0) {
-                return false;
-            }
-            return true;
+            return cn_name_equals(a->as.struct_type.name, a->as.struct_type.name_length,
+                                  b->as.struct_type.name, b->as.struct_type.name_length);
         case CN_TYPE_ENUM:
             if (!a->as.enum_type.name || !b->as.enum_type.name) return false;
-            if (a->as.enum_type.name_length != b->as.enum_type.name_length) return false;
-            return memcmp(a->as.enum_type.name, b->as.enum_type.name, a->as.enum_type.name_length) == 0;
+            return cn_name_equals(a->as.enum_type.name, a->as.enum_type.name_length,
+                                  b->as.enum_type.name, b->as.enum_type.name_length);
         case CN_TYPE_FUNCTION:
             if (a->as.function.param_count != b->as.function.param_count) return false;
             if (!cn_type_equals(a->as.function.return_type, b->as.function.return_type)) return false;
@@ -118,6 +599,36 @@ bool cn_type_equals(CnType *a, CnType *b) {
     }
 }
 
+size_t cn_type_hash(CnType *type) {
+    if (!type) return 0;
+
+    size_t hash = (size_t)type->kind * (size_t)0x9e3779b97f4a7c15ULL;
+    switch (type->kind) {
+        case CN_TYPE_POINTER:
+            return (hash ^ cn_type_hash(type->as.pointer_to)) * (size_t)0x100000001b3ULL;
+        case CN_TYPE_ARRAY:
+            hash = (hash ^ cn_type_hash(type->as.array.element_type)) * (size_t)0x100000001b3ULL;
+            return (hash ^ type->as.array.length) * (size_t)0x100000001b3ULL;
+        case CN_TYPE_STRUCT:
+        case CN_TYPE_CLASS:
+        case CN_TYPE_INTERFACE:
+            // 具名类型按名称比较，哈希同样只取名称
+            if (!type->as.struct_type.name) return hash;
+            return hash ^ cn_string_hash(type->as.struct_type.name, type->as.struct_type.name_length);
+        case CN_TYPE_ENUM:
+            if (!type->as.enum_type.name) return hash;
+            return hash ^ cn_string_hash(type->as.enum_type.name, type->as.enum_type.name_length);
+        case CN_TYPE_FUNCTION:
+            hash = (hash ^ cn_type_hash(type->as.function.return_type)) * (size_t)0x100000001b3ULL;
+            for (size_t i = 0; i < type->as.function.param_count; i++) {
+                hash = (hash ^ cn_type_hash(type->as.function.param_types[i])) * (size_t)0x100000001b3ULL;
+            }
+            return hash;
+        default:
+            return hash;
+    }
+}
+
 bool cn_type_compatible(CnType *a, CnType *b) {
     // 空指针检查
     if (!a || !b) return false;
@@ -338,15 +849,19 @@ bool cn_type_compatible(CnType *a, CnType *b) {
 // 前向声明：符号查找函数（来自 symbol_table.c）
 extern CnSemSymbol *cn_sem_scope_lookup(CnSemScope *scope, const char *name, size_t name_length);
 
-// 全局变量：用于动态解析的当前作用域
+// 用于动态解析的当前作用域（每个线程一份，并行类型检查时互不干扰）
 // 这是在 semantic_passes.c 中设置的
-static CnSemScope *g_current_scope_for_resolution = NULL;
+static _Thread_local CnSemScope *g_current_scope_for_resolution = NULL;
 
 // 设置当前作用域（供 semantic_passes.c 调用）
 void cn_type_set_resolution_scope(CnSemScope *scope) {
     g_current_scope_for_resolution = scope;
 }
 
+CnSemScope *cn_type_get_resolution_scope(void) {
+    return g_current_scope_for_resolution;
+}
+
 // 在结构体类型中查找成员字段
 CnStructField *cn_type_struct_find_field(CnType *struct_type,
                                          const char *field_name,
@@ -387,11 +902,18 @@ CnStructField *cn_type_struct_find_field(CnType *struct_type,
                 return NULL;  // 枚举类型没有字段
             } else if (type_sym->kind == CN_SEM_SYMBOL_STRUCT &&
                        type_sym->type->as.struct_type.fields) {
-                // 更新结构体类型的字段信息
-                struct_type->as.struct_type.fields = type_sym->type->as.struct_type.fields;
-                struct_type->as.struct_type.field_count = type_sym->type->as.struct_type.field_count;
-                // 同时更新声明作用域
-                struct_type->as.struct_type.decl_scope = type_sym->type->as.struct_type.decl_scope;
+                if (g_patch_log) {
+                    // 并行检查：占位节点可能被其他线程读取，先记录，本次直接在真实类型中查找
+                    CnTypePatch patch = { struct_type, type_sym->type, NULL, NULL, NULL };
+                    type_patch_log_push(g_patch_log, &patch);
+                    struct_type = type_sym->type;
+                } else {
+                    // 更新结构体类型的字段信息
+                    struct_type->as.struct_type.fields = type_sym->type->as.struct_type.fields;
+                    struct_type->as.struct_type.field_count = type_sym->type->as.struct_type.field_count;
+                    // 同时更新声明作用域
+                    struct_type->as.struct_type.decl_scope = type_sym->type->as.struct_type.decl_scope;
+                }
             } else {
                 return NULL;
             }
@@ -406,8 +928,8 @@ CnStructField *cn_type_struct_find_field(CnType *struct_type,
     }
     for (size_t i = 0; i < struct_type->as.struct_type.field_count; i++) {
         CnStructField *field = &struct_type->as.struct_type.fields[i];
-        if (field && field->name && field->name_length == field_name_length &&
-            memcmp(field->name, field_name, field_name_length) == 0) {
+        if (field && field->name &&
+            cn_name_equals(field->name, field->name_length, field_name, field_name_length)) {
             if (field->field_type && field->field_type->kind == CN_TYPE_POINTER &&
                 field->field_type->as.pointer_to) {
                 if (field->field_type->as.pointer_to->kind == CN_TYPE_STRUCT &&
@@ -438,7 +960,7 @@ CnStructField *cn_type_struct_find_field(CnType *struct_type,
                             pointee_sym->kind == CN_SEM_SYMBOL_STRUCT &&
                             pointee_sym->type->as.struct_type.fields) {
                             // 更新指针指向的类型
-                            field->field_type->as.pointer_to = pointee_sym->type;
+                            type_retarget_pointer_field(&field->field_type, pointee_sym->type);
                         }
                     }
                 }
@@ -830,14 +1352,7 @@ CnSemSymbol *cn_type_enum_find_member(CnType *enum_type,
  * @param expr 表达式节点
  * @return 推断出的类型，如果无法推断则返回 NULL
  */
-CnType *cn_type_infer_from_expr(CnSemScope *scope, CnAstExpr *expr) {
-    if (!expr || !scope) return NULL;
-    
-    // 如果表达式已经有类型信息，直接返回
-    if (expr->type && expr->type->kind != CN_TYPE_UNKNOWN) {
-        return expr->type;
-    }
-    
+static CnType *cn_type_infer_uncached(CnSemScope *scope, CnAstExpr *expr) {
     switch (expr->kind) {
         case CN_AST_EXPR_INTEGER_LITERAL:
             return cn_type_new_primitive(CN_TYPE_INT);
@@ -866,6 +1381,31 @@ CnType *cn_type_infer_from_expr(CnSemScope *scope, CnAstExpr *expr) {
     }
 }
 
+// 对外接口：推断结果缓存在 expr->type 上
+CnType *cn_type_infer_from_expr(CnSemScope *scope, CnAstExpr *expr) {
+    if (!expr || !scope) return NULL;
+    
+    // 如果表达式已经有类型信息，直接返回
+    // 校验模式下与重新推断的结果比较（无法推断时不比较，节点类型可能来自完整的类型检查）
+    if (expr->type && expr->type->kind != CN_TYPE_UNKNOWN) {
+        if (cn_sem_cache_verify_enabled()) {
+            CnType *fresh = cn_type_infer_uncached(scope, expr);
+            if (fresh && !cn_type_equals(fresh, expr->type)) {
+                cn_sem_cache_report_mismatch("类型", expr);
+                expr->type = fresh;
+            }
+        }
+        return expr->type;
+    }
+    
+    // 推断结果记录在节点上，之后的阶段直接读取
+    CnType *type = cn_type_infer_uncached(scope, expr);
+    if (type) {
+        expr->type = type;
+    }
+    return type;
+}
+
 /**
  * @brief 推断函数调用表达式的返回类型
  *
@@ -885,8 +1425,8 @@ CnType *cn_type_infer_call_expr(CnSemScope *scope, CnAstExpr *call_expr) {
     
     if (!func_name || func_name_len == 0) return NULL;
     
-    // 在作用域中查找函数符号
-    CnSemSymbol *func_sym = cn_sem_scope_lookup(scope, func_name, func_name_len);
+    // 在作用域中查找函数符号（结果缓存在被调用者节点上）
+    CnSemSymbol *func_sym = cn_sem_scope_lookup_identifier(scope, call_expr->as.call.callee);
     if (!func_sym || !func_sym->type) return NULL;
     
     // 检查是否为函数类型
@@ -952,8 +1492,8 @@ CnType *cn_type_infer_identifier(CnSemScope *scope, CnAstExpr *ident_expr) {
     
     if (!name || name_len == 0) return NULL;
     
-    // 在作用域中查找符号
-    CnSemSymbol *sym = cn_sem_scope_lookup(scope, name, name_len);
+    // 在作用域中查找符号（结果缓存在标识符节点上）
+    CnSemSymbol *sym = cn_sem_scope_lookup_identifier(scope, ident_expr);
     
     return sym ? sym->type : NULL;
 }
@@ -1026,7 +1566,7 @@ static CnStructField *cn_type_deep_copy_fields_ex(CnStructField *src_fields, siz
                 // 递归引用：创建指向新结构体的指针
                 // 注意：这里需要创建一个指向新结构体的指针，但新结构体还未完成
                 // 我们先创建一个浅拷贝的指针，后续会更新
-                dst_fields[i].field_type = cn_type_new_pointer(NULL);  // 暂时设为NULL
+                dst_fields[i].field_type = type_new_pointer_placeholder(NULL);  // 暂时设为NULL
                 continue;
             }
         }
@@ -1068,11 +1608,7 @@ static CnStructField *cn_type_deep_copy_fields_ex(CnStructField *src_fields, siz
                 // 深度复制源指针指向的类型
                 CnType *recovered_type = cn_type_deep_copy(src_field_type->as.pointer_to);
                 if (recovered_type) {
-                    // 释放旧的 void 类型（如果有）
-                    if (dst_pointer_to && dst_pointer_to->kind == CN_TYPE_VOID) {
-                        free(dst_pointer_to);
-                    }
-                    dst_field_type->as.pointer_to = recovered_type;
+                    type_retarget_pointer_field(&dst_fields[i].field_type, recovered_type);
                 }
             }
         }
@@ -1245,7 +1781,7 @@ CnType *cn_type_deep_copy(CnType *src) {
                                 memcmp(pointee->as.struct_type.name, src->as.struct_type.name,
                                        pointee->as.struct_type.name_length) == 0) {
                                 // 这是递归指针字段，更新为指向新结构体
-                                dst_field_type->as.pointer_to = dst;
+                                type_retarget_pointer_field(&dst->as.struct_type.fields[i].field_type, dst);
                                 }
                         }
                         // 情况2：pointer_to 为 NULL（递归引用）
@@ -1259,7 +1795,7 @@ CnType *cn_type_deep_copy(CnType *src) {
                                 memcmp(field_type->as.pointer_to->as.struct_type.name, src->as.struct_type.name,
                                        field_type->as.pointer_to->as.struct_type.name_length) == 0) {
                                 // 更新为指向新结构体
-                                dst_field_type->as.pointer_to = dst;
+                                type_retarget_pointer_field(&dst->as.struct_type.fields[i].field_type, dst);
                                 }
                         }
                     }
@@ -1312,8 +1848,10 @@ CnType *cn_type_deep_copy(CnType *src) {
             CnType **params_copy = cn_type_deep_copy_param_types(
                 src->as.function.param_types,
                 src->as.function.param_count);
+            CnType *dst = cn_type_new_function(return_copy, params_copy, src->as.function.param_count);
             
-            return cn_type_new_function(return_copy, params_copy, src->as.function.param_count);
+            free(params_copy);
+            return dst;
         }
         
         default:
@@ -6,9 +6,15 @@
  */
 
 #include "cnlang/semantics/template.h"
+#include "cnlang/support/string_pool.h"
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+#define CN_TEMPLATE_CACHE_INITIAL_SLOTS 32
+
+static CnTemplateCache *g_default_template_cache = NULL;
+
 /* ============================================================================
  * 类型映射表实现
  * ============================================================================ */
@@ -52,8 +58,8 @@ bool cn_type_map_insert(CnTypeMap *map,
     // 检查是否已存在
     for (size_t i = 0; i < map->entry_count; i++) {
         CnTypeMapEntry *entry = &map->entries[i];
-        if (entry->param_name_length == param_name_len &&
-            memcmp(entry->param_name, param_name, param_name_len) == 0) {
+        if (cn_name_equals(entry->param_name, entry->param_name_length,
+                           param_name, param_name_len)) {
             // 已存在，更新类型
             entry->concrete_type = concrete_type;
             return true;
@@ -90,8 +96,8 @@ CnType *cn_type_map_lookup(const CnTypeMap *map,
     
     for (size_t i = 0; i < map->entry_count; i++) {
         const CnTypeMapEntry *entry = &map->entries[i];
-        if (entry->param_name_length == param_name_len &&
-            memcmp(entry->param_name, param_name, param_name_len) == 0) {
+        if (cn_name_equals(entry->param_name, entry->param_name_length,
+                           param_name, param_name_len)) {
             return entry->concrete_type;
         }
     }
@@ -113,6 +119,10 @@ CnTemplateCache *cn_template_cache_new(void) {
     cache->instances = NULL;
     cache->instance_count = 0;
     cache->capacity = 0;
+    cache->slots = NULL;
+    cache->slot_count = 0;
+    cache->hit_count = 0;
+    cache->miss_count = 0;
     
     return cache;
 }
@@ -152,10 +162,29 @@ void cn_template_cache_free(CnTemplateCache *cache) {
         }
         free(cache->instances);
     }
+    free(cache->slots);
     
     free(cache);
 }
 
+/**
+ * @brief 获取进程级共享模板缓存
+ */
+CnTemplateCache *cn_template_cache_default(void) {
+    if (!g_default_template_cache) {
+        g_default_template_cache = cn_template_cache_new();
+    }
+    return g_default_template_cache;
+}
+
+/**
+ * @brief 释放进程级共享模板缓存
+ */
+void cn_template_cache_release_default(void) {
+    cn_template_cache_free(g_default_template_cache);
+    g_default_template_cache = NULL;
+}
+
 /**
  * @brief 比较两个类型数组是否相等
  */
@@ -175,32 +204,94 @@ bool cn_type_array_equals(CnType **types1, size_t count1,
 }
 
 /**
- * @brief 在缓存中查找已实例化的模板
+ * @brief 计算模板缓存键的哈希
  */
-CnTemplateInstance *cn_template_cache_find(const CnTemplateCache *cache,
-                                           const char *template_name,
-                                           size_t template_name_len,
-                                           CnType **type_args,
-                                           size_t type_arg_count) {
-    if (!cache || !template_name) return NULL;
+size_t cn_template_cache_hash(const void *template_decl,
+                              const char *template_name,
+                              size_t template_name_len,
+                              CnType **type_args,
+                              size_t type_arg_count) {
+    size_t hash = template_name ? cn_string_hash(template_name, template_name_len) : 0;
+    
+    hash = (hash ^ (size_t)(uintptr_t)template_decl) * (size_t)0x100000001b3ULL;
+    
+    for (size_t i = 0; i < type_arg_count && type_args; i++) {
+        hash = (hash ^ cn_type_hash(type_args[i])) * (size_t)0x100000001b3ULL;
+    }
+    
+    return hash ^ type_arg_count;
+}
+
+/**
+ * @brief 在哈希索引中定位键所在的槽，未找到时返回应插入的空槽
+ */
+static size_t cn_template_cache_find_slot(const CnTemplateCache *cache,
+                                          size_t hash,
+                                          const void *template_decl,
+                                          const char *template_name,
+                                          size_t template_name_len,
+                                          CnType **type_args,
+                                          size_t type_arg_count) {
+    size_t mask = cache->slot_count - 1;
+    size_t index = hash & mask;
+    
+    while (cache->slots[index]) {
+        CnTemplateInstance *instance = cache->slots[index];
+        if (instance->hash == hash &&
+            instance->template_decl == template_decl &&
+            cn_name_equals(instance->template_name, instance->template_name_length,
+                           template_name, template_name_len) &&
+            cn_type_array_equals(instance->type_args, instance->type_arg_count,
+                                 type_args, type_arg_count)) {
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+    
+    return index;
+}
+
+/**
+ * @brief 扩容哈希索引并按加入顺序重新插入全部实例
+ */
+static bool cn_template_cache_grow_slots(CnTemplateCache *cache) {
+    size_t new_count = cache->slot_count == 0 ? CN_TEMPLATE_CACHE_INITIAL_SLOTS : cache->slot_count * 2;
+    CnTemplateInstance **new_slots = (CnTemplateInstance **)calloc(new_count, sizeof(CnTemplateInstance *));
+    if (!new_slots) return false;
     
+    size_t mask = new_count - 1;
     for (size_t i = 0; i < cache->instance_count; i++) {
         CnTemplateInstance *instance = cache->instances[i];
-        
-        // 比较模板名称
-        if (instance->template_name_length != template_name_len) continue;
-        if (memcmp(instance->template_name, template_name, template_name_len) != 0) {
-            continue;
-        }
-        
-        // 比较类型实参
-        if (cn_type_array_equals(instance->type_args, instance->type_arg_count,
-                                  type_args, type_arg_count)) {
-            return instance;
+        size_t index = instance->hash & mask;
+        while (new_slots[index]) {
+            index = (index + 1) & mask;
         }
+        new_slots[index] = instance;
     }
     
-    return NULL;
+    free(cache->slots);
+    cache->slots = new_slots;
+    cache->slot_count = new_count;
+    return true;
+}
+
+/**
+ * @brief 在缓存中查找已实例化的模板
+ */
+CnTemplateInstance *cn_template_cache_find(const CnTemplateCache *cache,
+                                           const void *template_decl,
+                                           const char *template_name,
+                                           size_t template_name_len,
+                                           CnType **type_args,
+                                           size_t type_arg_count) {
+    if (!cache || !template_name || cache->slot_count == 0) return NULL;
+    
+    size_t hash = cn_template_cache_hash(template_decl, template_name, template_name_len,
+                                         type_args, type_arg_count);
+    size_t index = cn_template_cache_find_slot(cache, hash, template_decl,
+                                               template_name, template_name_len,
+                                               type_args, type_arg_count);
+    return cache->slots[index];
 }
 
 /**
@@ -209,19 +300,29 @@ CnTemplateInstance *cn_template_cache_find(const CnTemplateCache *cache,
 bool cn_template_cache_add(CnTemplateCache *cache, CnTemplateInstance *instance) {
     if (!cache || !instance) return false;
     
+    instance->hash = cn_template_cache_hash(instance->template_decl,
+                                            instance->template_name,
+                                            instance->template_name_length,
+                                            instance->type_args,
+                                            instance->type_arg_count);
+    
     // 检查是否已存在（避免重复添加）
-    CnTemplateInstance *existing = cn_template_cache_find(
-        cache,
-        instance->template_name,
-        instance->template_name_length,
-        instance->type_args,
-        instance->type_arg_count);
-    
-    if (existing) {
+    if (cache->slot_count > 0 &&
+        cache->slots[cn_template_cache_find_slot(cache, instance->hash,
+                                                 instance->template_decl,
+                                                 instance->template_name,
+                                                 instance->template_name_length,
+                                                 instance->type_args,
+                                                 instance->type_arg_count)]) {
         // 已存在，不重复添加
         return true;
     }
     
+    // 保持索引负载因子不超过 1/2
+    if ((cache->instance_count + 1) * 2 > cache->slot_count) {
+        if (!cn_template_cache_grow_slots(cache)) return false;
+    }
+    
     // 需要扩容
     if (cache->instance_count >= cache->capacity) {
         size_t new_capacity = cache->capacity == 0 ? 16 : cache->capacity * 2;
@@ -233,8 +334,15 @@ bool cn_template_cache_add(CnTemplateCache *cache, CnTemplateInstance *instance)
         cache->capacity = new_capacity;
     }
     
-    // 添加实例
+    // 添加实例并写入索引
     cache->instances[cache->instance_count++] = instance;
+    size_t index = cn_template_cache_find_slot(cache, instance->hash,
+                                               instance->template_decl,
+                                               instance->template_name,
+                                               instance->template_name_length,
+                                               instance->type_args,
+                                               instance->type_arg_count);
+    cache->slots[index] = instance;
     
     return true;
 }
@@ -279,8 +387,8 @@ static bool cn_template_registry_add_entry(CnTemplateRegistry *registry,
     // 检查是否已存在同名模板
     for (size_t i = 0; i < registry->entry_count; i++) {
         CnTemplateRegistryEntry *existing = &registry->entries[i];
-        if (existing->name_length == entry->name_length &&
-            memcmp(existing->name, entry->name, entry->name_length) == 0) {
+        if (cn_name_equals(existing->name, existing->name_length,
+                           entry->name, entry->name_length)) {
             // 已存在同名模板
             return false;
         }
@@ -351,8 +459,7 @@ CnTemplateRegistryEntry *cn_template_registry_lookup(const CnTemplateRegistry *r
     
     for (size_t i = 0; i < registry->entry_count; i++) {
         CnTemplateRegistryEntry *entry = &registry->entries[i];
-        if (entry->name_length == name_len &&
-            memcmp(entry->name, name, name_len) == 0) {
+        if (cn_name_equals(entry->name, entry->name_length, name, name_len)) {
             return entry;
         }
     }
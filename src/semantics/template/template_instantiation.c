@@ -236,6 +236,7 @@ static CnAstFunctionDecl *cn_function_decl_clone(CnAstFunctionDecl *orig) {
     clone->is_override = orig->is_override;
     clone->is_static = orig->is_static;
     clone->owning_scope = NULL;  // 实例化函数的作用域需要重新构建
+    clone->lazy_body = NULL;
     
     // 复制参数列表
     if (orig->parameter_count > 0 && orig->parameters) {
@@ -314,14 +315,17 @@ CnAstFunctionDecl *cn_template_instantiate_function(
     if (cache) {
         CnTemplateInstance *existing = cn_template_cache_find(
             cache,
+            template_func,
             orig_func->name,
             orig_func->name_length,
             type_args,
             type_arg_count);
         
         if (existing && existing->instantiated_function) {
+            cache->hit_count++;
             return existing->instantiated_function;
         }
+        cache->miss_count++;
     }
     
     // 创建类型映射表
@@ -385,6 +389,7 @@ CnAstFunctionDecl *cn_template_instantiate_function(
         if (inst_entry) {
             inst_entry->mangled_name = mangled_name;
             inst_entry->mangled_name_length = instance->name_length;
+            inst_entry->template_decl = template_func;
             inst_entry->template_name = orig_func->name;
             inst_entry->template_name_length = orig_func->name_length;
             inst_entry->type_args = cn_type_array_copy(type_args, type_arg_count);
@@ -419,14 +424,17 @@ CnAstStructDecl *cn_template_instantiate_struct(
     if (cache) {
         CnTemplateInstance *existing = cn_template_cache_find(
             cache,
+            template_struct,
             orig_struct->name,
             orig_struct->name_length,
             type_args,
             type_arg_count);
         
         if (existing && existing->instantiated_struct) {
+            cache->hit_count++;
             return existing->instantiated_struct;
         }
+        cache->miss_count++;
     }
     
     // 创建类型映射表
@@ -480,6 +488,7 @@ CnAstStructDecl *cn_template_instantiate_struct(
         if (inst_entry) {
             inst_entry->mangled_name = mangled_name;
             inst_entry->mangled_name_length = instance->name_length;
+            inst_entry->template_decl = template_struct;
             inst_entry->template_name = orig_struct->name;
             inst_entry->template_name_length = orig_struct->name_length;
             inst_entry->type_args = cn_type_array_copy(type_args, type_arg_count);
@@ -107,8 +107,10 @@ CnType *cn_type_substitute(CnType *type, const CnTypeMap *type_map) {
         }
         
         if (changed) {
-            return cn_type_new_function(ret_type, param_types, 
-                                        type->as.function.param_count);
+            CnType *result = cn_type_new_function(ret_type, param_types,
+                                                  type->as.function.param_count);
+            if (param_types) free(param_types);
+            return result;
         }
         
         if (param_types) free(param_types);
@@ -0,0 +1,268 @@
+#include "cnlang/support/string_pool.h"
+#include "cnlang/support/thread.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * CN Language 字符串驻留池实现
+ * 字符串连同 CnInternHeader 一起分配在 Arena 中，哈希表使用开放寻址（线性探测），
+ * 负载因子保持在 1/2 以下。
+ * 并发模式下主表只读，新字符串在互斥锁保护下写入暂存池，退出并发模式时再并入主表。
+ */
+
+#define CN_STRING_POOL_INITIAL_SLOTS 1024
+#define CN_STRING_POOL_ARENA_BLOCK   (64 * 1024)
+
+static CnStringPool *g_default_string_pool = NULL;
+
+uint32_t cn_string_hash(const char *str, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)str[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// 查找字符串所在槽位，未找到时返回应插入的空槽
+static size_t find_slot(const CnStringPool *pool, const char *str, size_t length, uint32_t hash)
+{
+    size_t mask = pool->slot_count - 1;
+    size_t index = hash & mask;
+
+    while (pool->slots[index].str) {
+        const CnInternSlot *slot = &pool->slots[index];
+        if (slot->hash == hash && slot->length == length &&
+            memcmp(slot->str, str, length) == 0) {
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+static bool grow_slots(CnStringPool *pool)
+{
+    size_t new_count = pool->slot_count * 2;
+    CnInternSlot *new_slots = (CnInternSlot *)calloc(new_count, sizeof(CnInternSlot));
+    if (!new_slots) {
+        return false;
+    }
+
+    size_t mask = new_count - 1;
+    for (size_t i = 0; i < pool->slot_count; i++) {
+        CnInternSlot slot = pool->slots[i];
+        if (!slot.str) {
+            continue;
+        }
+        size_t index = slot.hash & mask;
+        while (new_slots[index].str) {
+            index = (index + 1) & mask;
+        }
+        new_slots[index] = slot;
+    }
+
+    free(pool->slots);
+    pool->slots = new_slots;
+    pool->slot_count = new_count;
+    return true;
+}
+
+CnStringPool *cn_string_pool_new(void)
+{
+    CnStringPool *pool = (CnStringPool *)calloc(1, sizeof(CnStringPool));
+    if (!pool) {
+        return NULL;
+    }
+
+    pool->arena = cn_arena_new(CN_STRING_POOL_ARENA_BLOCK);
+    pool->slots = (CnInternSlot *)calloc(CN_STRING_POOL_INITIAL_SLOTS, sizeof(CnInternSlot));
+    if (!pool->arena || !pool->slots) {
+        cn_arena_free(pool->arena);
+        free(pool->slots);
+        free(pool);
+        return NULL;
+    }
+    pool->slot_count = CN_STRING_POOL_INITIAL_SLOTS;
+    return pool;
+}
+
+void cn_string_pool_free(CnStringPool *pool)
+{
+    if (!pool) {
+        return;
+    }
+    if (pool->lock) {
+        cn_mutex_destroy((CnMutex *)pool->lock);
+        free(pool->lock);
+    }
+    cn_string_pool_free(pool->overflow);
+    cn_arena_free(pool->arena);
+    free(pool->slots);
+    free(pool);
+}
+
+CnStringPool *cn_string_pool_default(void)
+{
+    if (!g_default_string_pool) {
+        g_default_string_pool = cn_string_pool_new();
+    }
+    return g_default_string_pool;
+}
+
+void cn_string_pool_release_default(void)
+{
+    cn_string_pool_free(g_default_string_pool);
+    g_default_string_pool = NULL;
+}
+
+const char *cn_string_pool_intern(CnStringPool *pool, const char *str, size_t length)
+{
+    if (!pool || (!str && length > 0) || length > UINT32_MAX) {
+        return NULL;
+    }
+    if (!str) {
+        str = "";
+    }
+
+    uint32_t hash = cn_string_hash(str, length);
+    size_t index = find_slot(pool, str, length, hash);
+    if (pool->concurrent) {
+        // 主表只读：命中直接返回，未命中在锁内写入暂存池
+        if (pool->slots[index].str) {
+            return pool->slots[index].str;
+        }
+        cn_mutex_lock((CnMutex *)pool->lock);
+        const char *result = cn_string_pool_intern(pool->overflow, str, length);
+        cn_mutex_unlock((CnMutex *)pool->lock);
+        return result;
+    }
+
+    pool->intern_calls++;
+    if (pool->slots[index].str) {
+        pool->hit_count++;
+        return pool->slots[index].str;
+    }
+
+    // 插入前保证负载因子不超过 1/2
+    if ((pool->count + 1) * 2 > pool->slot_count) {
+        if (!grow_slots(pool)) {
+            return NULL;
+        }
+        index = find_slot(pool, str, length, hash);
+    }
+
+    CnInternHeader *header = (CnInternHeader *)cn_arena_alloc_aligned(
+        pool->arena, sizeof(CnInternHeader) + length + 1, sizeof(uint32_t));
+    if (!header) {
+        return NULL;
+    }
+    header->hash = hash;
+    header->length = (uint32_t)length;
+
+    char *copy = (char *)(header + 1);
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+
+    pool->slots[index].str = copy;
+    pool->slots[index].hash = hash;
+    pool->slots[index].length = (uint32_t)length;
+    pool->count++;
+    pool->string_bytes += length;
+    return copy;
+}
+
+const char *cn_string_pool_find(const CnStringPool *pool, const char *str, size_t length)
+{
+    if (!pool || (!str && length > 0) || length > UINT32_MAX) {
+        return NULL;
+    }
+    if (!str) {
+        str = "";
+    }
+
+    size_t index = find_slot(pool, str, length, cn_string_hash(str, length));
+    if (!pool->slots[index].str && pool->concurrent) {
+        cn_mutex_lock((CnMutex *)pool->lock);
+        const char *result = cn_string_pool_find(pool->overflow, str, length);
+        cn_mutex_unlock((CnMutex *)pool->lock);
+        return result;
+    }
+    return pool->slots[index].str;
+}
+
+bool cn_string_pool_begin_concurrent(CnStringPool *pool)
+{
+    if (!pool) {
+        return false;
+    }
+    if (pool->concurrent) {
+        return true;
+    }
+    if (!pool->overflow) {
+        pool->overflow = cn_string_pool_new();
+        if (!pool->overflow) {
+            return false;
+        }
+    }
+    if (!pool->lock) {
+        CnMutex *lock = (CnMutex *)malloc(sizeof(CnMutex));
+        if (!lock || !cn_mutex_init(lock)) {
+            free(lock);
+            return false;
+        }
+        pool->lock = lock;
+    }
+    pool->concurrent = true;
+    return true;
+}
+
+void cn_string_pool_end_concurrent(CnStringPool *pool)
+{
+    if (!pool || !pool->concurrent) {
+        return;
+    }
+    pool->concurrent = false;
+
+    // 暂存池的字符串留在它自己的 Arena 中，主表只记录指针
+    const CnStringPool *overflow = pool->overflow;
+    for (size_t i = 0; i < overflow->slot_count; i++) {
+        CnInternSlot slot = overflow->slots[i];
+        if (!slot.str) {
+            continue;
+        }
+        size_t index = find_slot(pool, slot.str, slot.length, slot.hash);
+        if (pool->slots[index].str) {
+            continue;
+        }
+        if ((pool->count + 1) * 2 > pool->slot_count) {
+            if (!grow_slots(pool)) {
+                return;
+            }
+            index = find_slot(pool, slot.str, slot.length, slot.hash);
+        }
+        pool->slots[index] = slot;
+        pool->count++;
+        pool->string_bytes += slot.length;
+    }
+}
+
+void cn_string_pool_get_stats(const CnStringPool *pool, CnStringPoolStats *stats)
+{
+    if (!stats) {
+        return;
+    }
+    memset(stats, 0, sizeof(*stats));
+    if (!pool) {
+        return;
+    }
+
+    size_t block_count = 0;
+    stats->unique_count = pool->count;
+    stats->intern_calls = pool->intern_calls;
+    stats->hit_count = pool->hit_count;
+    stats->string_bytes = pool->string_bytes;
+    stats->table_bytes = pool->slot_count * sizeof(CnInternSlot);
+    cn_arena_get_stats(pool->arena, &stats->arena_bytes, &block_count);
+}
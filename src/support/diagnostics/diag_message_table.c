@@ -162,6 +162,15 @@ static const CnDiagMessageTemplate g_message_table[] = {
         "Please check if the expression syntax is correct"
     },
     
+    /* 嵌套层数超过上限 */
+    {
+        CN_DIAG_CODE_PARSE_NESTING_TOO_DEEP,
+        "嵌套层数超过上限",
+        "Nesting depth exceeds the limit",
+        "请拆分深层嵌套的表达式或代码块，或用 --max-nesting=<n> 提高上限",
+        "Split the deeply nested expression or block, or raise the limit with --max-nesting=<n>"
+    },
+    
     /* ==================== 语义错误 ==================== */
     
     /* 重复的符号 */
@@ -339,6 +348,26 @@ static const CnDiagMessageTemplate g_message_table[] = {
         "Please specify a valid data type for the static variable"
     },
     
+    /* ==================== 编译时资源嵌入语义错误 ==================== */
+    
+    /* 嵌入的资源文件不存在 */
+    {
+        CN_DIAG_CODE_SEM_EMBED_NOT_FOUND,
+        "找不到嵌入的资源文件: '{0}'",
+        "Embedded resource file not found: '{0}'",
+        "资源路径相对引用它的源文件所在目录，或位于模块搜索路径下",
+        "Resource paths are relative to the referencing source file or a module search path"
+    },
+    
+    /* 嵌入资源的使用位置无效 */
+    {
+        CN_DIAG_CODE_SEM_EMBED_INVALID_TARGET,
+        "嵌入资源 '{0}' 只能用作全局字符数组的初始值",
+        "Embedded resource '{0}' can only initialize a global character array",
+        "请写成 字符 名称[] = 嵌入(\"路径\");，数组长度省略或不小于文件大小",
+        "Write 字符 name[] = 嵌入(\"path\"); with the length omitted or at least the file size"
+    },
+    
     /* ==================== 表结束标记 ==================== */
     
     /* 未知错误（表结束标记） */
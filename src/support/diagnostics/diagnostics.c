@@ -296,8 +296,8 @@ void cn_support_diag_semantic_error_undefined_identifier(
 {
     if (!diagnostics) return;
     
-    // 使用静态缓冲区存储错误消息（避免局部变量被释放）
-    static char error_msg[256];
+    // 消息由 cn_support_diagnostics_report 复制，局部缓冲区即可（并行检查时各线程互不干扰）
+    char error_msg[256];
     
     if (identifier && identifier[0] != '\0') {
         snprintf(error_msg, sizeof(error_msg), "语义错误：未定义的标识符 '%s'", identifier);
@@ -145,6 +145,16 @@ void *cn_arena_alloc_aligned(CnArena *arena, size_t size, size_t alignment)
             return NULL;
         }
 
+        // 专用块分配后即已用满，插入到当前块之后，当前块的剩余空间继续用于小对象
+        if (size > arena->block_size) {
+            new_block->next = block->next;
+            new_block->used = size;
+            block->next = new_block;
+            arena->block_count++;
+            arena->total_allocated += size;
+            return new_block->data;
+        }
+
         // 链接新块
         block->next = new_block;
         arena->current_block = new_block;
@@ -171,6 +181,52 @@ void *cn_arena_alloc(CnArena *arena, size_t size)
     return cn_arena_alloc_aligned(arena, size, CN_ARENA_ALIGNMENT);
 }
 
+void *cn_arena_realloc(CnArena *arena, void *ptr, size_t old_size, size_t new_size)
+{
+    CnArenaBlock *block;
+    void *new_ptr;
+
+    if (!ptr) {
+        return cn_arena_alloc(arena, new_size);
+    }
+    if (!arena || new_size <= old_size) {
+        return ptr;
+    }
+
+    // 当前块中最后一次分配：原地扩展
+    block = arena->current_block;
+    if ((char *)ptr + old_size == block->data + block->used &&
+        new_size - old_size <= block->size - block->used) {
+        block->used += new_size - old_size;
+        arena->total_allocated += new_size - old_size;
+        return ptr;
+    }
+
+    new_ptr = cn_arena_alloc(arena, new_size);
+    if (!new_ptr) {
+        return NULL;
+    }
+    memcpy(new_ptr, ptr, old_size);
+    return new_ptr;
+}
+
+char *cn_arena_strndup(CnArena *arena, const char *str, size_t length)
+{
+    char *copy;
+
+    if (!str) {
+        return NULL;
+    }
+
+    copy = (char *)cn_arena_alloc_aligned(arena, length + 1, 1);
+    if (!copy) {
+        return NULL;
+    }
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+    return copy;
+}
+
 void cn_arena_reset(CnArena *arena)
 {
     CnArenaBlock *block;
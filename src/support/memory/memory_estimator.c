@@ -55,14 +55,30 @@ static size_t estimate_expr(const CnAstExpr *expr)
         return 0;
     }
     
-    size += sizeof(CnAstExpr);
+    /* 节点按种类分配，只占公共头部与该种类的联合体成员 */
+    size += cn_frontend_ast_expr_node_size(expr->kind);
     size += estimate_type(expr->type);
     
     switch (expr->kind) {
         case CN_AST_EXPR_BINARY:
-            size += estimate_expr(expr->as.binary.left);
-            size += estimate_expr(expr->as.binary.right);
+        case CN_AST_EXPR_LOGICAL: {
+            /* 左结合运算链沿左侧循环累加，求和与顺序无关，无需显式栈 */
+            const CnAstExpr *node = expr;
+            for (;;) {
+                const CnAstExpr *left = node->kind == CN_AST_EXPR_BINARY ? node->as.binary.left
+                                                                         : node->as.logical.left;
+                size += estimate_expr(node->kind == CN_AST_EXPR_BINARY ? node->as.binary.right
+                                                                       : node->as.logical.right);
+                if (!left || left->kind != expr->kind) {
+                    size += estimate_expr(left);
+                    break;
+                }
+                node = left;
+                size += cn_frontend_ast_expr_node_size(node->kind);
+                size += estimate_type(node->type);
+            }
             break;
+        }
             
         case CN_AST_EXPR_CALL:
             size += estimate_expr(expr->as.call.callee);
@@ -89,11 +105,6 @@ static size_t estimate_expr(const CnAstExpr *expr)
             size += estimate_expr(expr->as.assign.value);
             break;
             
-        case CN_AST_EXPR_LOGICAL:
-            size += estimate_expr(expr->as.logical.left);
-            size += estimate_expr(expr->as.logical.right);
-            break;
-            
         case CN_AST_EXPR_UNARY:
             size += estimate_expr(expr->as.unary.operand);
             break;
@@ -109,6 +120,23 @@ static size_t estimate_expr(const CnAstExpr *expr)
             size += estimate_expr(expr->as.index.array);
             size += estimate_expr(expr->as.index.index);
             break;
+            
+        case CN_AST_EXPR_TERNARY:
+            size += estimate_expr(expr->as.ternary.condition);
+            size += estimate_expr(expr->as.ternary.true_expr);
+            size += estimate_expr(expr->as.ternary.false_expr);
+            break;
+            
+        case CN_AST_EXPR_MEMBER_ACCESS:
+            size += estimate_expr(expr->as.member.object);
+            break;
+            
+        case CN_AST_EXPR_CAST:
+            size += estimate_expr(expr->as.cast.operand);
+            break;
+            
+        default:
+            break;
     }
     
     return size;
@@ -142,7 +170,7 @@ static size_t estimate_stmt(const CnAstStmt *stmt)
         return 0;
     }
     
-    size += sizeof(CnAstStmt);
+    size += cn_frontend_ast_stmt_node_size(stmt->kind);
     
     switch (stmt->kind) {
         case CN_AST_STMT_BLOCK:
@@ -162,11 +190,23 @@ static size_t estimate_stmt(const CnAstStmt *stmt)
             size += estimate_expr(stmt->as.return_stmt.expr);
             break;
             
-        case CN_AST_STMT_IF:
-            size += estimate_expr(stmt->as.if_stmt.condition);
-            size += estimate_block(stmt->as.if_stmt.then_block);
-            size += estimate_block(stmt->as.if_stmt.else_block);
+        case CN_AST_STMT_IF: {
+            /* "否则 如果" 链逐段累加：包装块只计块本身与 如果 语句节点 */
+            const CnAstIfStmt *if_stmt = &stmt->as.if_stmt;
+            for (;;) {
+                const CnAstStmt *else_if = cn_frontend_ast_else_if(if_stmt);
+                size += estimate_expr(if_stmt->condition);
+                size += estimate_block(if_stmt->then_block);
+                if (!else_if) {
+                    size += estimate_block(if_stmt->else_block);
+                    break;
+                }
+                size += sizeof(CnAstBlockStmt) + sizeof(CnAstStmt*);
+                size += cn_frontend_ast_stmt_node_size(else_if->kind);
+                if_stmt = &else_if->as.if_stmt;
+            }
             break;
+        }
             
         case CN_AST_STMT_WHILE:
             size += estimate_expr(stmt->as.while_stmt.condition);
@@ -352,6 +392,7 @@ size_t cn_mem_estimate_ir(const CnIrModule *module)
 {
     size_t size = 0;
     const CnIrFunction *func;
+    const CnIrConstArray *array;
     
     if (!module) {
         return 0;
@@ -364,6 +405,15 @@ size_t cn_mem_estimate_ir(const CnIrModule *module)
         size += estimate_ir_function(func);
     }
     
+    /* 常量数组：结构体加上打包的值区（嵌入资源的字节由源文件管理器持有，不计入） */
+    for (array = module->first_const_array; array != NULL; array = array->next) {
+        size += sizeof(CnIrConstArray);
+        if (array->values) {
+            size += sizeof(CnIrConstValue) * array->element_count *
+                    (array->field_count ? array->field_count : 1);
+        }
+    }
+    
     return size;
 }
 
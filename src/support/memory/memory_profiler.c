@@ -84,6 +84,8 @@ const char* cn_mem_category_name(CnMemCategory category)
             return "IR 中间表示";
         case CN_MEM_CATEGORY_DIAGNOSTICS:
             return "诊断信息";
+        case CN_MEM_CATEGORY_STRING_POOL:
+            return "字符串池";
         case CN_MEM_CATEGORY_OTHER:
             return "其他";
         default:
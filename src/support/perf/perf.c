@@ -83,6 +83,32 @@ void cn_perf_end(CnPerfStats *stats, CnPerfPhase phase)
     m->is_active = false;
 }
 
+/* 记录预处理器的宏统计 */
+void cn_perf_record_macro_stats(CnPerfStats *stats, size_t macro_count,
+                                size_t expansion_count, uint64_t expansion_time_us)
+{
+    if (!stats || !stats->enabled) {
+        return;
+    }
+
+    stats->macro_count = macro_count;
+    stats->macro_expansion_count = expansion_count;
+    stats->macro_expansion_time_us = expansion_time_us;
+}
+
+/* 记录模板实例化缓存统计 */
+void cn_perf_record_template_stats(CnPerfStats *stats, size_t instance_count,
+                                   size_t hit_count, size_t miss_count)
+{
+    if (!stats || !stats->enabled) {
+        return;
+    }
+
+    stats->template_instance_count = instance_count;
+    stats->template_cache_hits = hit_count;
+    stats->template_cache_misses = miss_count;
+}
+
 /* 获取某个阶段的耗时（微秒） */
 uint64_t cn_perf_get_duration(const CnPerfStats *stats, CnPerfPhase phase)
 {
@@ -186,6 +212,23 @@ void cn_perf_print_stats(const CnPerfStats *stats, FILE *out)
                 percentage);
     }
 
+    /* 打印宏统计 */
+    if (stats->macro_count > 0 || stats->macro_expansion_count > 0) {
+        fprintf(out, "--------------------------------------\n");
+        fprintf(out, "%-24s %12zu\n", "宏定义数", stats->macro_count);
+        fprintf(out, "%-24s %12zu\n", "宏展开次数", stats->macro_expansion_count);
+        fprintf(out, "%-24s %12.3f ms\n", "宏展开耗时",
+                (double)stats->macro_expansion_time_us / 1000.0);
+    }
+
+    /* 打印模板缓存统计 */
+    if (stats->template_cache_hits > 0 || stats->template_cache_misses > 0) {
+        fprintf(out, "--------------------------------------\n");
+        fprintf(out, "%-24s %12zu\n", "模板实例数", stats->template_instance_count);
+        fprintf(out, "%-24s %12zu\n", "模板缓存命中", stats->template_cache_hits);
+        fprintf(out, "%-24s %12zu\n", "模板缓存未命中", stats->template_cache_misses);
+    }
+
     fprintf(out, "======================================\n");
 }
 
@@ -205,6 +248,12 @@ bool cn_perf_export_json(const CnPerfStats *stats, const char *filename)
     fprintf(f, "  \"source_file\": \"%s\",\n", stats->source_file ? stats->source_file : "");
     fprintf(f, "  \"source_size\": %zu,\n", stats->source_size);
     fprintf(f, "  \"total_duration_ms\": %.3f,\n", cn_perf_get_duration_ms(stats, CN_PERF_PHASE_TOTAL));
+    fprintf(f, "  \"macro_count\": %zu,\n", stats->macro_count);
+    fprintf(f, "  \"macro_expansion_count\": %zu,\n", stats->macro_expansion_count);
+    fprintf(f, "  \"macro_expansion_ms\": %.3f,\n", (double)stats->macro_expansion_time_us / 1000.0);
+    fprintf(f, "  \"template_instance_count\": %zu,\n", stats->template_instance_count);
+    fprintf(f, "  \"template_cache_hits\": %zu,\n", stats->template_cache_hits);
+    fprintf(f, "  \"template_cache_misses\": %zu,\n", stats->template_cache_misses);
     fprintf(f, "  \"phases\": [\n");
 
     bool first = true;
@@ -0,0 +1,387 @@
+#include "cnlang/support/line_index.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * CN Language 行首索引实现
+ *
+ * 行 i 覆盖 [line_starts[i], line_starts[i + 1])，包括行尾的 '\n'。
+ * 每行额外记录是否全为 ASCII：源码中的大多数行是纯 ASCII，
+ * 此时 UTF-16 列与字节列相同，不需要扫描行内容。
+ */
+
+#define CN_LINE_INDEX_INITIAL_CAPACITY 64
+
+static bool line_index_reserve(CnLineIndex *index, size_t needed)
+{
+    size_t new_capacity;
+    uint32_t *starts;
+    uint8_t *ascii;
+
+    if (needed <= index->capacity) {
+        return true;
+    }
+
+    new_capacity = index->capacity == 0 ? CN_LINE_INDEX_INITIAL_CAPACITY : index->capacity * 2;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+
+    starts = (uint32_t *)realloc(index->line_starts, new_capacity * sizeof(uint32_t));
+    if (!starts) {
+        return false;
+    }
+    index->line_starts = starts;
+
+    ascii = (uint8_t *)realloc(index->line_ascii, new_capacity * sizeof(uint8_t));
+    if (!ascii) {
+        return false;
+    }
+    index->line_ascii = ascii;
+
+    index->capacity = new_capacity;
+    return true;
+}
+
+// 行 line 的结束偏移（下一行起点或文本末尾）
+static size_t line_limit(const CnLineIndex *index, size_t line)
+{
+    return line + 1 < index->line_count ? index->line_starts[line + 1] : index->length;
+}
+
+static uint8_t is_ascii_range(const char *text, size_t begin, size_t end)
+{
+    unsigned char bits = 0;
+    for (size_t i = begin; i < end; i++) {
+        bits |= (unsigned char)text[i];
+    }
+    return (uint8_t)((bits & 0x80) == 0);
+}
+
+// 在 [begin, end) 中查找换行，追加其后的行首；返回追加的行数，内存不足返回 (size_t)-1
+static size_t append_line_starts(CnLineIndex *index, const char *text, size_t begin, size_t end)
+{
+    const char *p = text + begin;
+    const char *limit = text + end;
+    size_t added = 0;
+
+    while (p < limit) {
+        const char *nl = (const char *)memchr(p, '\n', (size_t)(limit - p));
+        if (!nl) {
+            break;
+        }
+        if (!line_index_reserve(index, index->line_count + 1)) {
+            return (size_t)-1;
+        }
+        index->line_starts[index->line_count++] = (uint32_t)(nl - text) + 1;
+        added++;
+        p = nl + 1;
+    }
+    return added;
+}
+
+// UTF-16 代码单元数：每个非续字节开始一个字符，4 字节序列（增补平面）占两个单元
+static size_t utf16_units(const char *text, size_t begin, size_t end)
+{
+    size_t units = 0;
+    for (size_t i = begin; i < end; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if ((c & 0xC0) != 0x80) {
+            units += c >= 0xF0 ? 2 : 1;
+        }
+    }
+    return units;
+}
+
+bool cn_line_index_init(CnLineIndex *index, const char *text, size_t length)
+{
+    if (!index) {
+        return false;
+    }
+
+    memset(index, 0, sizeof(*index));
+    if ((!text && length > 0) || length > UINT32_MAX) {
+        return false;
+    }
+
+    if (!line_index_reserve(index, CN_LINE_INDEX_INITIAL_CAPACITY)) {
+        cn_line_index_free(index);
+        return false;
+    }
+
+    index->length = length;
+    index->line_starts[0] = 0;
+    index->line_count = 1;
+    if (length > 0 && append_line_starts(index, text, 0, length) == (size_t)-1) {
+        cn_line_index_free(index);
+        return false;
+    }
+
+    for (size_t line = 0; line < index->line_count; line++) {
+        index->line_ascii[line] = is_ascii_range(text, index->line_starts[line],
+                                                 line_limit(index, line));
+    }
+    return true;
+}
+
+void cn_line_index_free(CnLineIndex *index)
+{
+    if (!index) {
+        return;
+    }
+
+    free(index->line_starts);
+    free(index->line_ascii);
+    memset(index, 0, sizeof(*index));
+}
+
+bool cn_line_index_apply_edit(CnLineIndex *index, const char *text,
+                              size_t offset, size_t removed_length, size_t inserted_length)
+{
+    size_t first_line;
+    size_t tail_line;
+    size_t tail_count;
+    size_t new_length;
+    size_t inserted_lines;
+    size_t inserted_capacity;
+    size_t last_changed;
+    uint32_t *new_starts;
+    size_t new_count;
+
+    if (!index || !index->line_starts || offset > index->length ||
+        removed_length > index->length - offset) {
+        return false;
+    }
+
+    new_length = index->length - removed_length + inserted_length;
+    if (new_length > UINT32_MAX || (!text && new_length > 0)) {
+        return false;
+    }
+
+    // 编辑起点所在行及之前的行首不变；起点严格位于删除区间之后的行整体平移
+    first_line = cn_line_index_line_of(index, offset);
+    tail_line = cn_line_index_line_of(index, offset + removed_length) + 1;
+    tail_count = index->line_count - tail_line;
+
+    // 插入内容中的新行首暂存，避免覆盖尚未平移的尾部
+    inserted_lines = 0;
+    inserted_capacity = 0;
+    new_starts = NULL;
+    for (const char *p = text + offset, *end = text + offset + inserted_length; p < end;) {
+        const char *nl = (const char *)memchr(p, '\n', (size_t)(end - p));
+        if (!nl) {
+            break;
+        }
+        if (inserted_lines == inserted_capacity) {
+            size_t grow = inserted_capacity == 0 ? 8 : inserted_capacity * 2;
+            uint32_t *grown = (uint32_t *)realloc(new_starts, grow * sizeof(uint32_t));
+            if (!grown) {
+                free(new_starts);
+                return false;
+            }
+            new_starts = grown;
+            inserted_capacity = grow;
+        }
+        new_starts[inserted_lines++] = (uint32_t)(nl - text) + 1;
+        p = nl + 1;
+    }
+
+    new_count = first_line + 1 + inserted_lines + tail_count;
+    if (!line_index_reserve(index, new_count)) {
+        free(new_starts);
+        return false;
+    }
+
+    memmove(index->line_starts + first_line + 1 + inserted_lines,
+            index->line_starts + tail_line, tail_count * sizeof(uint32_t));
+    memmove(index->line_ascii + first_line + 1 + inserted_lines,
+            index->line_ascii + tail_line, tail_count * sizeof(uint8_t));
+    for (size_t i = 0; i < tail_count; i++) {
+        uint32_t *start = &index->line_starts[first_line + 1 + inserted_lines + i];
+        *start = (uint32_t)(*start - removed_length + inserted_length);
+    }
+    if (inserted_lines > 0) {
+        memcpy(index->line_starts + first_line + 1, new_starts, inserted_lines * sizeof(uint32_t));
+    }
+    free(new_starts);
+
+    index->line_count = new_count;
+    index->length = new_length;
+
+    // 编辑起点所在行到插入内容最后一行的 ASCII 标记需要重新计算
+    last_changed = first_line + inserted_lines;
+    for (size_t line = first_line; line <= last_changed; line++) {
+        index->line_ascii[line] = is_ascii_range(text, index->line_starts[line],
+                                                 line_limit(index, line));
+    }
+    return true;
+}
+
+size_t cn_line_index_line_of(const CnLineIndex *index, size_t offset)
+{
+    size_t lo = 0;
+    size_t hi;
+
+    if (!index || index->line_count == 0) {
+        return 0;
+    }
+
+    // 二分查找最后一个不大于 offset 的行首
+    hi = index->line_count;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (index->line_starts[mid] <= offset) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+bool cn_line_index_line_span(const CnLineIndex *index, const char *text, size_t line,
+                             size_t *out_begin, size_t *out_end)
+{
+    size_t begin;
+    size_t end;
+
+    if (!index || line >= index->line_count) {
+        return false;
+    }
+
+    begin = index->line_starts[line];
+    end = line_limit(index, line);
+    if (end > begin && text[end - 1] == '\n') {
+        end--;
+    }
+    if (end > begin && text[end - 1] == '\r') {
+        end--;
+    }
+
+    if (out_begin) {
+        *out_begin = begin;
+    }
+    if (out_end) {
+        *out_end = end;
+    }
+    return true;
+}
+
+CnTextPosition cn_line_index_position(const CnLineIndex *index, const char *text, size_t offset)
+{
+    CnTextPosition position = {0, 0, 0};
+    size_t line;
+    size_t begin;
+
+    if (!index || index->line_count == 0) {
+        return position;
+    }
+    if (offset > index->length) {
+        offset = index->length;
+    }
+
+    line = cn_line_index_line_of(index, offset);
+    begin = index->line_starts[line];
+
+    position.line = (uint32_t)line;
+    position.byte_column = (uint32_t)(offset - begin);
+    position.utf16_column = index->line_ascii[line]
+        ? position.byte_column
+        : (uint32_t)utf16_units(text, begin, offset);
+    return position;
+}
+
+size_t cn_line_index_offset_from_utf16(const CnLineIndex *index, const char *text,
+                                       size_t line, size_t utf16_column)
+{
+    size_t begin;
+    size_t end;
+    size_t units = 0;
+    size_t i;
+
+    if (!cn_line_index_line_span(index, text, line, &begin, &end)) {
+        return index ? index->length : 0;
+    }
+
+    if (index->line_ascii[line]) {
+        return utf16_column < end - begin ? begin + utf16_column : end;
+    }
+
+    for (i = begin; i < end; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if ((c & 0xC0) == 0x80) {
+            continue;
+        }
+        units += c >= 0xF0 ? 2 : 1;
+        if (units > utf16_column) {
+            break;
+        }
+    }
+    return i;
+}
+
+size_t cn_line_index_offset_from_byte_column(const CnLineIndex *index, const char *text,
+                                             size_t line, size_t byte_column)
+{
+    size_t begin;
+    size_t end;
+
+    if (!cn_line_index_line_span(index, text, line, &begin, &end)) {
+        return index ? index->length : 0;
+    }
+    return byte_column < end - begin ? begin + byte_column : end;
+}
+
+// 东亚宽字符（中日韩表意文字、谚文、全角符号等）在终端占两列
+static int is_wide_codepoint(uint32_t cp)
+{
+    return (cp >= 0x1100 && cp <= 0x115F) ||
+           (cp >= 0x2E80 && cp <= 0xA4CF && cp != 0x303F) ||
+           (cp >= 0xAC00 && cp <= 0xD7A3) ||
+           (cp >= 0xF900 && cp <= 0xFAFF) ||
+           (cp >= 0xFE30 && cp <= 0xFE4F) ||
+           (cp >= 0xFF00 && cp <= 0xFF60) ||
+           (cp >= 0xFFE0 && cp <= 0xFFE6) ||
+           (cp >= 0x20000 && cp <= 0x3FFFD);
+}
+
+void cn_line_index_write_padding(FILE *out, const char *line_begin, size_t prefix_length)
+{
+    size_t i = 0;
+
+    if (!out || !line_begin) {
+        return;
+    }
+
+    while (i < prefix_length) {
+        unsigned char c = (unsigned char)line_begin[i];
+        uint32_t cp;
+        size_t n;
+
+        if (c < 0x80) {
+            fputc(c == '\t' ? '\t' : ' ', out);
+            i++;
+            continue;
+        }
+
+        if (c >= 0xF0) {
+            cp = c & 0x07;
+            n = 4;
+        } else if (c >= 0xE0) {
+            cp = c & 0x0F;
+            n = 3;
+        } else if (c >= 0xC0) {
+            cp = c & 0x1F;
+            n = 2;
+        } else {
+            i++;  // 孤立的续字节
+            continue;
+        }
+        for (size_t k = 1; k < n && i + k < prefix_length; k++) {
+            cp = (cp << 6) | ((unsigned char)line_begin[i + k] & 0x3F);
+        }
+
+        fputs(is_wide_codepoint(cp) ? "  " : " ", out);
+        i += n;
+    }
+}
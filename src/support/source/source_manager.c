@@ -0,0 +1,372 @@
+#include "cnlang/support/source_manager.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+ * CN Language 源文件管理器实现
+ *
+ * 只有当文件长度不是页大小的整数倍时才使用内存映射：此时映射末页剩余部分
+ * 由操作系统填零，视图天然以 '\0' 结尾，下游按 C 字符串使用（strcmp 等）
+ * 也是安全的。其余情况（含空文件）回退为一次性读入堆缓冲区。
+ */
+
+#define CN_SOURCE_MANAGER_INITIAL_SLOTS 64
+
+static CnSourceManager *g_default_source_manager = NULL;
+
+// FNV-1a 路径哈希
+static uint32_t hash_path(const char *path)
+{
+    uint32_t hash = 2166136261u;
+    while (*path) {
+        hash ^= (unsigned char)*path++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// 规范化路径：转为绝对路径，失败（通常是文件不存在）返回 NULL
+static char *canonicalize_path(const char *path)
+{
+#ifdef _WIN32
+    char *full = _fullpath(NULL, path, 0);
+    if (!full) {
+        return NULL;
+    }
+    // 统一使用反斜杠，与模块缓存的规范化结果保持一致
+    for (char *p = full; *p; p++) {
+        if (*p == '/') {
+            *p = '\\';
+        }
+    }
+    return full;
+#else
+    return realpath(path, NULL);
+#endif
+}
+
+static size_t page_size(void)
+{
+    static size_t cached = 0;
+    if (cached == 0) {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        cached = (size_t)info.dwPageSize;
+#else
+        long size = sysconf(_SC_PAGESIZE);
+        cached = size > 0 ? (size_t)size : 4096;
+#endif
+    }
+    return cached;
+}
+
+// 回退路径：整体读入以 '\0' 结尾的堆缓冲区
+static bool read_into_buffer(CnSourceFile *file, const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        return false;
+    }
+
+    if (fseek(fp, 0, SEEK_END) != 0) {
+        fclose(fp);
+        return false;
+    }
+    long size = ftell(fp);
+    if (size < 0 || fseek(fp, 0, SEEK_SET) != 0) {
+        fclose(fp);
+        return false;
+    }
+
+    char *buffer = (char *)malloc((size_t)size + 1);
+    if (!buffer) {
+        fclose(fp);
+        return false;
+    }
+
+    size_t length = fread(buffer, 1, (size_t)size, fp);
+    fclose(fp);
+    buffer[length] = '\0';
+
+    file->data = buffer;
+    file->length = length;
+    file->is_mapped = false;
+    file->map_base = buffer;
+    file->map_size = length + 1;
+    return true;
+}
+
+#ifdef _WIN32
+static bool map_file(CnSourceFile *file, const char *path)
+{
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0 ||
+        (size_t)size.QuadPart % page_size() == 0) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    void *base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!base) {
+        CloseHandle(mapping);
+        CloseHandle(handle);
+        return false;
+    }
+
+    file->data = (const char *)base;
+    file->length = (size_t)size.QuadPart;
+    file->is_mapped = true;
+    file->map_base = base;
+    file->map_size = (size_t)size.QuadPart;
+    file->file_handle = handle;
+    file->mapping_handle = mapping;
+    return true;
+}
+
+static void unmap_file(CnSourceFile *file)
+{
+    UnmapViewOfFile(file->map_base);
+    CloseHandle((HANDLE)file->mapping_handle);
+    CloseHandle((HANDLE)file->file_handle);
+}
+#else
+static bool map_file(CnSourceFile *file, const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0 ||
+        (size_t)st.st_size % page_size() == 0) {
+        close(fd);
+        return false;
+    }
+
+    void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // 映射建立后即可关闭描述符
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    file->data = (const char *)base;
+    file->length = (size_t)st.st_size;
+    file->is_mapped = true;
+    file->map_base = base;
+    file->map_size = (size_t)st.st_size;
+    return true;
+}
+
+static void unmap_file(CnSourceFile *file)
+{
+    munmap(file->map_base, file->map_size);
+}
+#endif
+
+static void source_file_free(CnSourceFile *file)
+{
+    if (!file) {
+        return;
+    }
+
+    if (file->is_mapped) {
+        unmap_file(file);
+    } else {
+        free(file->map_base);
+    }
+    free(file->path);
+    free(file);
+}
+
+// 在哈希表中查找路径对应的槽位（命中或第一个空槽）
+static size_t find_slot(const CnSourceManager *manager, const char *path, uint32_t hash)
+{
+    size_t mask = manager->slot_count - 1;
+    size_t index = hash & mask;
+
+    while (manager->slots[index] != 0) {
+        const CnSourceFile *file = manager->files[manager->slots[index] - 1];
+        if (file->path_hash == hash && strcmp(file->path, path) == 0) {
+            break;
+        }
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+static bool grow_slots(CnSourceManager *manager)
+{
+    size_t new_count = manager->slot_count * 2;
+    uint32_t *new_slots = (uint32_t *)calloc(new_count, sizeof(uint32_t));
+    if (!new_slots) {
+        return false;
+    }
+
+    free(manager->slots);
+    manager->slots = new_slots;
+    manager->slot_count = new_count;
+
+    for (size_t i = 0; i < manager->file_count; i++) {
+        const CnSourceFile *file = manager->files[i];
+        size_t index = find_slot(manager, file->path, file->path_hash);
+        manager->slots[index] = (uint32_t)(i + 1);
+    }
+    return true;
+}
+
+// =============================================================================
+// 管理器生命周期
+// =============================================================================
+
+CnSourceManager *cn_source_manager_new(void)
+{
+    CnSourceManager *manager = (CnSourceManager *)calloc(1, sizeof(CnSourceManager));
+    if (!manager) {
+        return NULL;
+    }
+
+    manager->slot_count = CN_SOURCE_MANAGER_INITIAL_SLOTS;
+    manager->slots = (uint32_t *)calloc(manager->slot_count, sizeof(uint32_t));
+    if (!manager->slots) {
+        free(manager);
+        return NULL;
+    }
+
+    return manager;
+}
+
+void cn_source_manager_free(CnSourceManager *manager)
+{
+    if (!manager) {
+        return;
+    }
+
+    for (size_t i = 0; i < manager->file_count; i++) {
+        source_file_free(manager->files[i]);
+    }
+    free(manager->files);
+    free(manager->slots);
+    free(manager);
+}
+
+CnSourceManager *cn_source_manager_default(void)
+{
+    if (!g_default_source_manager) {
+        g_default_source_manager = cn_source_manager_new();
+    }
+    return g_default_source_manager;
+}
+
+void cn_source_manager_release_default(void)
+{
+    cn_source_manager_free(g_default_source_manager);
+    g_default_source_manager = NULL;
+}
+
+// =============================================================================
+// 文件访问
+// =============================================================================
+
+const CnSourceFile *cn_source_manager_load(CnSourceManager *manager, const char *path)
+{
+    if (!manager || !path) {
+        return NULL;
+    }
+
+    char *canonical = canonicalize_path(path);
+    if (!canonical) {
+        return NULL;
+    }
+
+    uint32_t hash = hash_path(canonical);
+    size_t index = find_slot(manager, canonical, hash);
+    if (manager->slots[index] != 0) {
+        free(canonical);
+        return manager->files[manager->slots[index] - 1];
+    }
+
+    // 负载因子保持在 1/2 以下，扩容后需重新定位空槽
+    if ((manager->file_count + 1) * 2 > manager->slot_count) {
+        if (!grow_slots(manager)) {
+            free(canonical);
+            return NULL;
+        }
+        index = find_slot(manager, canonical, hash);
+    }
+
+    CnSourceFile *file = (CnSourceFile *)calloc(1, sizeof(CnSourceFile));
+    if (!file) {
+        free(canonical);
+        return NULL;
+    }
+    file->path = canonical;
+    file->path_hash = hash;
+
+    if (!map_file(file, canonical) && !read_into_buffer(file, canonical)) {
+        source_file_free(file);
+        return NULL;
+    }
+
+    if (manager->file_count == manager->file_capacity) {
+        size_t new_capacity = manager->file_capacity ? manager->file_capacity * 2 : 16;
+        CnSourceFile **new_files = (CnSourceFile **)realloc(
+            manager->files, new_capacity * sizeof(CnSourceFile *));
+        if (!new_files) {
+            source_file_free(file);
+            return NULL;
+        }
+        manager->files = new_files;
+        manager->file_capacity = new_capacity;
+    }
+
+    manager->files[manager->file_count++] = file;
+    manager->slots[index] = (uint32_t)manager->file_count;
+    manager->total_bytes += file->length;
+
+    return file;
+}
+
+const CnSourceFile *cn_source_manager_lookup(const CnSourceManager *manager, const char *path)
+{
+    if (!manager || !path) {
+        return NULL;
+    }
+
+    char *canonical = canonicalize_path(path);
+    if (!canonical) {
+        return NULL;
+    }
+
+    size_t index = find_slot(manager, canonical, hash_path(canonical));
+    free(canonical);
+
+    if (manager->slots[index] == 0) {
+        return NULL;
+    }
+    return manager->files[manager->slots[index] - 1];
+}
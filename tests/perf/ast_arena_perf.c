@@ -0,0 +1,153 @@
+/**
+ * @file ast_arena_perf.c
+ * @brief AST Arena 分配性能基准测试
+ *
+ * 构造一个包含数万个函数的大模块，分别统计：
+ * 1. 语法分析耗时（节点、子数组与字符串副本均从程序的 Arena 分配）
+ * 2. 释放耗时（cn_frontend_ast_program_free 直接释放整个 Arena，与节点数无关）
+ *
+ * 同时输出 Arena 的分配字节数与块数量。
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "cnlang/frontend/lexer.h"
+#include "cnlang/frontend/parser.h"
+#include "cnlang/frontend/ast.h"
+#include "cnlang/support/memory/arena.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_ITERATIONS 3
+#define FUNCTION_COUNT 40000
+
+/* ============================================================================
+ * 测试辅助函数
+ * ============================================================================ */
+
+/* 获取当前时间（毫秒） */
+static double get_time_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+/* 生成大模块：每个函数包含局部变量、循环、条件、调用与数组字面量 */
+static char *build_source(size_t *out_length) {
+    size_t capacity = (size_t)FUNCTION_COUNT * 512 + 256;
+    size_t length = 0;
+    char *text = (char *)malloc(capacity);
+
+    if (!text) {
+        return NULL;
+    }
+
+    for (int i = 0; i < FUNCTION_COUNT && capacity - length > 512; i++) {
+        length += (size_t)snprintf(text + length, capacity - length,
+            "函数 计算_%d(整数 甲, 整数 乙) {\n"
+            "    变量 和 = 0;\n"
+            "    变量 表 = [甲, 乙, %d, 甲 * 乙];\n"
+            "    循环 (变量 i = 0; i < 甲; i = i + 1) {\n"
+            "        如果 (i %% 2 == 0 && 乙 > %d) {\n"
+            "            和 = 和 + 表[i %% 4] * (乙 - i);\n"
+            "        } 否则 {\n"
+            "            和 = 和 - 计算_%d(i, 乙 / 2);\n"
+            "        }\n"
+            "    }\n"
+            "    打印(\"结果\\n\");\n"
+            "    返回 和;\n"
+            "}\n",
+            i, i % 97, i % 13, i > 0 ? i - 1 : 0);
+    }
+
+    *out_length = length;
+    return text;
+}
+
+static CnAstProgram *parse_source(CnTokenStream *stream) {
+    CnParser *parser = cn_frontend_parser_new_from_stream(stream);
+    CnAstProgram *program = NULL;
+
+    if (!parser) {
+        return NULL;
+    }
+    if (!cn_frontend_parse_program(parser, &program)) {
+        cn_frontend_ast_program_free(program);
+        program = NULL;
+    }
+    cn_frontend_parser_free(parser);
+    return program;
+}
+
+/* ============================================================================
+ * 主函数
+ * ============================================================================ */
+
+int main(void) {
+    CnTokenStream stream;
+    size_t length = 0;
+    char *source = build_source(&length);
+    double parse_ms = 0.0;
+    double free_ms = 0.0;
+    size_t arena_bytes = 0;
+    size_t arena_blocks = 0;
+    size_t function_count = 0;
+
+    if (!source) {
+        return 1;
+    }
+
+    printf("========================================\n");
+    printf("CN语言 AST Arena 分配性能测试\n");
+    printf("========================================\n");
+    printf("源码大小: %zu 字节, %d 个函数 x %d 次迭代\n", length, FUNCTION_COUNT, TEST_ITERATIONS);
+
+    if (!cn_frontend_token_stream_build(&stream, source, length, "perf.cn", NULL)) {
+        free(source);
+        return 1;
+    }
+
+    for (int iter = 0; iter < TEST_ITERATIONS; iter++) {
+        double start = get_time_ms();
+        CnAstProgram *program = parse_source(&stream);
+        parse_ms += get_time_ms() - start;
+
+        if (!program) {
+            printf("  结果验证: ✗ 解析失败\n");
+            cn_frontend_token_stream_free(&stream);
+            free(source);
+            return 1;
+        }
+        function_count = program->function_count;
+        cn_arena_get_stats(program->arena, &arena_bytes, &arena_blocks);
+
+        start = get_time_ms();
+        cn_frontend_ast_program_free(program);
+        free_ms += get_time_ms() - start;
+    }
+
+    if (function_count != FUNCTION_COUNT) {
+        printf("  结果验证: ✗ 解析得到 %zu 个函数，期望 %d\n", function_count, FUNCTION_COUNT);
+        cn_frontend_token_stream_free(&stream);
+        free(source);
+        return 1;
+    }
+
+    printf("\n=== 语法分析 ===\n");
+    printf("  总耗时: %.3f ms\n", parse_ms);
+    printf("  平均耗时: %.3f ms\n", parse_ms / TEST_ITERATIONS);
+    printf("\n=== 释放 AST ===\n");
+    printf("  总耗时: %.3f ms\n", free_ms);
+    printf("  平均耗时: %.3f ms\n", free_ms / TEST_ITERATIONS);
+    printf("\n=== Arena ===\n");
+    printf("  分配字节数: %zu\n", arena_bytes);
+    printf("  块数量: %zu\n", arena_blocks);
+
+    cn_frontend_token_stream_free(&stream);
+    free(source);
+    return 0;
+}
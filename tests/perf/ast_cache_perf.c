@@ -0,0 +1,163 @@
+/**
+ * @file ast_cache_perf.c
+ * @brief 二进制 AST 缓存基准测试
+ *
+ * 构造一个大型导入模块，对比导入路径上的两种获取 AST 的方式：
+ * 预处理 + 语法分析（缓存未命中），与从缓存映像重建（缓存命中）。
+ * 同时输出映像大小与写入（序列化）耗时。
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "cnlang/frontend/preprocessor.h"
+#include "cnlang/frontend/parser.h"
+#include "cnlang/frontend/ast.h"
+#include "cnlang/frontend/ast_cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_ITERATIONS 5
+#define FUNCTION_COUNT 10000
+
+/* ============================================================================
+ * 测试辅助函数
+ * ============================================================================ */
+
+/* 获取当前时间（毫秒） */
+static double get_time_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+/* 生成模块源码：FUNCTION_COUNT 个公开函数 + 结构体与枚举声明 */
+static char *build_source(size_t *out_length) {
+    size_t capacity = (size_t)FUNCTION_COUNT * 400 + 512;
+    size_t length = 0;
+    char *text = (char *)malloc(capacity);
+
+    if (!text) {
+        return NULL;
+    }
+
+    length += (size_t)snprintf(text + length, capacity - length,
+        "公开:\n"
+        "结构体 向量 { 整数 x; 整数 y; }\n"
+        "枚举 方向 { 上, 下, 左 = 5, 右 }\n");
+    for (int i = 0; i < FUNCTION_COUNT; i++) {
+        length += (size_t)snprintf(text + length, capacity - length,
+            "函数 计算_%d(整数 a, 整数 b) -> 整数 {\n"
+            "    变量 和 = a * %d + b;\n"
+            "    循环 (变量 i = 0; i < b; i++) {\n"
+            "        如果 (和 %% 2 == 0 && i > 3) { 和 = 和 / 2; } 否则 { 和 = 和 * 3 + 1; }\n"
+            "    }\n"
+            "    打印(\"结果\");\n"
+            "    返回 和;\n"
+            "}\n",
+            i, i % 97);
+    }
+
+    *out_length = length;
+    return text;
+}
+
+/* 与导入模块相同的路径：预处理器逐词元供给解析器 */
+static CnAstProgram *parse_module(const char *source, size_t length) {
+    CnPreprocessor preprocessor;
+    CnParser *parser;
+    CnAstProgram *program = NULL;
+
+    cn_frontend_preprocessor_init(&preprocessor, source, length, "perf.cn");
+    parser = cn_frontend_parser_new_from_preprocessor(&preprocessor);
+    if (parser) {
+        if (!cn_frontend_parse_program(parser, &program)) {
+            cn_frontend_ast_program_free(program);
+            program = NULL;
+        }
+        cn_frontend_parser_free(parser);
+    }
+    cn_frontend_preprocessor_free(&preprocessor);
+    return program;
+}
+
+/* ============================================================================
+ * 主函数
+ * ============================================================================ */
+
+int main(void) {
+    size_t length = 0;
+    char *source = build_source(&length);
+    uint64_t key;
+    double parse_ms = 0.0;
+    double store_ms = 0.0;
+    double load_ms = 0.0;
+    size_t image_size = 0;
+
+    if (!source) {
+        return 1;
+    }
+    key = cn_ast_cache_key(source, length);
+
+    printf("========================================\n");
+    printf("CN语言 二进制 AST 缓存测试\n");
+    printf("========================================\n");
+    printf("模块大小: %zu 字节, %d 个函数 x %d 次迭代\n", length, FUNCTION_COUNT, TEST_ITERATIONS);
+
+    for (int iter = 0; iter < TEST_ITERATIONS; iter++) {
+        CnAstProgram *program;
+        CnAstProgram *loaded;
+        void *image;
+        double start;
+
+        start = get_time_ms();
+        program = parse_module(source, length);
+        parse_ms += get_time_ms() - start;
+        if (!program || program->function_count != FUNCTION_COUNT) {
+            printf("  结果验证: ✗ 解析失败\n");
+            cn_frontend_ast_program_free(program);
+            free(source);
+            return 1;
+        }
+
+        start = get_time_ms();
+        image = cn_ast_cache_serialize(program, key, length, &image_size);
+        store_ms += get_time_ms() - start;
+
+        start = get_time_ms();
+        loaded = image ? cn_ast_cache_deserialize(image, image_size, key, length, "perf.cn") : NULL;
+        load_ms += get_time_ms() - start;
+
+        if (!loaded || loaded->function_count != FUNCTION_COUNT) {
+            printf("  结果验证: ✗ 缓存映像重建失败\n");
+            cn_frontend_ast_program_free(loaded);
+            cn_frontend_ast_program_free(program);
+            free(image);
+            free(source);
+            return 1;
+        }
+
+        cn_frontend_ast_program_free(loaded);
+        cn_frontend_ast_program_free(program);
+        free(image);
+    }
+
+    printf("\n=== 缓存未命中：预处理 + 语法分析 ===\n");
+    printf("  平均耗时: %.3f ms\n", parse_ms / TEST_ITERATIONS);
+    printf("\n=== 写入缓存：序列化 ===\n");
+    printf("  平均耗时: %.3f ms\n", store_ms / TEST_ITERATIONS);
+    printf("  映像大小: %.2f MB（源码的 %.1f 倍）\n",
+           (double)image_size / (1024.0 * 1024.0), (double)image_size / (double)length);
+    printf("\n=== 缓存命中：从映像重建 ===\n");
+    printf("  平均耗时: %.3f ms\n", load_ms / TEST_ITERATIONS);
+    if (load_ms > 0.0) {
+        printf("  加速比: %.2fx\n", parse_ms / load_ms);
+    }
+    printf("  结果验证: ✓ 重建得到 %d 个函数\n", FUNCTION_COUNT);
+
+    free(source);
+    return 0;
+}
@@ -0,0 +1,300 @@
+/**
+ * @file class_hierarchy_perf.c
+ * @brief 类层次缓存性能基准测试
+ *
+ * 模拟大型类库：LAYER_COUNT 层、每层 LAYER_WIDTH 个类，除根层外每个类多继承上一层的两个类；
+ * 根层类声明若干虚函数，派生类各自重写其中几个（少数重写基类中并非虚函数的方法）。
+ * 1. 重写检查：对全部重写方法调用 cn_check_method_override，比较逐级在程序中查找基类
+ *    与使用类层次缓存（含缓存构建耗时）的总耗时
+ * 2. 派生关系判断：随机类对的"是否派生自"查询，比较逐级递归遍历基类列表与祖先位集
+ *
+ * 同时校验两种方式的结果一致。
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "cnlang/frontend/ast.h"
+#include "cnlang/semantics/class_analyzer.h"
+#include "cnlang/semantics/inheritance_resolver.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LAYER_COUNT 6
+#define LAYER_WIDTH 300
+#define CLASS_COUNT (LAYER_COUNT * LAYER_WIDTH)
+#define VIRTUAL_COUNT 6
+#define OVERRIDES_PER_CLASS 3
+#define QUERY_COUNT 2000
+
+typedef struct BenchClass {
+    char name[24];
+    CnAstClassDecl decl;
+    CnAstStmt stmt;
+    CnInheritanceInfo bases[2];
+    CnClassMember members[VIRTUAL_COUNT + OVERRIDES_PER_CLASS];
+} BenchClass;
+
+static char g_method_names[VIRTUAL_COUNT + 1][16];
+
+/* ============================================================================
+ * 测试辅助函数
+ * ============================================================================ */
+
+/* 获取当前时间（毫秒） */
+static double get_time_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+static CnClassMember *add_method(BenchClass *cls, const char *name, bool is_virtual, bool is_override) {
+    CnClassMember *member = &cls->members[cls->decl.member_count++];
+    member->name = name;
+    member->name_length = strlen(name);
+    member->kind = CN_MEMBER_METHOD;
+    member->access = CN_ACCESS_PUBLIC;
+    member->is_virtual = is_virtual;
+    member->is_override = is_override;
+    return member;
+}
+
+/* 构造分层类库：第 layer 层第 i 个类继承上一层第 i 与第 i+1 个类 */
+static void build_library(BenchClass *classes, CnAstStmt **stmts) {
+    for (int m = 0; m < VIRTUAL_COUNT; m++) {
+        snprintf(g_method_names[m], sizeof(g_method_names[m]), "方法%d", m);
+    }
+    /* 基类中只有非虚函数版本，重写检查会失败并遍历整个继承图 */
+    snprintf(g_method_names[VIRTUAL_COUNT], sizeof(g_method_names[VIRTUAL_COUNT]), "辅助");
+
+    for (int layer = 0; layer < LAYER_COUNT; layer++) {
+        for (int i = 0; i < LAYER_WIDTH; i++) {
+            int index = layer * LAYER_WIDTH + i;
+            BenchClass *cls = &classes[index];
+
+            snprintf(cls->name, sizeof(cls->name), "类%d_%d", layer, i);
+            cls->decl.name = cls->name;
+            cls->decl.name_length = strlen(cls->name);
+            cls->decl.bases = cls->bases;
+            cls->decl.members = cls->members;
+            cls->stmt.kind = CN_AST_STMT_CLASS_DECL;
+            cls->stmt.as.class_decl = &cls->decl;
+            stmts[index] = &cls->stmt;
+
+            if (layer == 0) {
+                for (int m = 0; m < VIRTUAL_COUNT; m++) {
+                    add_method(cls, g_method_names[m], true, false);
+                }
+                add_method(cls, g_method_names[VIRTUAL_COUNT], false, false);
+                continue;
+            }
+            for (int b = 0; b < 2; b++) {
+                BenchClass *base = &classes[(layer - 1) * LAYER_WIDTH + (i + b) % LAYER_WIDTH];
+                cls->bases[b].base_class_name = base->name;
+                cls->bases[b].base_class_name_length = strlen(base->name);
+                cls->bases[b].access = CN_ACCESS_PUBLIC;
+            }
+            cls->decl.base_count = 2;
+            for (int o = 0; o < OVERRIDES_PER_CLASS; o++) {
+                int method = (i + layer + o * 2) % VIRTUAL_COUNT;
+                if (o == 0 && i % 50 == 0) {
+                    method = VIRTUAL_COUNT;
+                }
+                add_method(cls, g_method_names[method], false, true);
+            }
+        }
+    }
+}
+
+/* 优化前的派生关系判断（作为基准）：按名字在程序中查找基类并逐级递归 */
+static bool walk_is_derived(CnAstProgram *program, CnAstClassDecl *derived, CnAstClassDecl *base) {
+    for (size_t i = 0; i < derived->base_count; i++) {
+        CnAstClassDecl *direct = cn_find_class_in_program(program, derived->bases[i].base_class_name,
+                                                          derived->bases[i].base_class_name_length);
+        if (direct == base || (direct && walk_is_derived(program, direct, base))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* ============================================================================
+ * 重写检查测试
+ * ============================================================================ */
+
+/* 检查全部重写方法，结果写入 results；返回成功数量 */
+static size_t check_overrides(CnClassAnalyzerContext *ctx, BenchClass *classes, bool *results) {
+    size_t passed = 0;
+    size_t n = 0;
+
+    for (int c = LAYER_WIDTH; c < CLASS_COUNT; c++) {
+        ctx->current_class = &classes[c].decl;
+        for (size_t m = 0; m < classes[c].decl.member_count; m++) {
+            bool ok = cn_check_method_override(ctx, &classes[c].members[m]);
+            results[n++] = ok;
+            passed += ok;
+        }
+    }
+    return passed;
+}
+
+static int run_override_check(BenchClass *classes, CnAstProgram *program) {
+    size_t total = (size_t)(CLASS_COUNT - LAYER_WIDTH) * OVERRIDES_PER_CLASS;
+    bool *walk_results = (bool *)calloc(total, sizeof(bool));
+    bool *cached_results = (bool *)calloc(total, sizeof(bool));
+    CnClassAnalyzerContext ctx;
+    CnInheritanceResolver *resolver;
+    size_t walk_passed;
+    size_t cached_passed;
+    size_t mismatches = 0;
+    double start;
+    double walk_ms;
+    double cached_ms;
+
+    if (!walk_results || !cached_results) {
+        free(walk_results);
+        free(cached_results);
+        return 0;
+    }
+    cn_class_analyzer_context_init(&ctx, NULL, NULL, program);
+
+    /* 优化前：每个重写方法都逐级在程序中查找基类 */
+    start = get_time_ms();
+    walk_passed = check_overrides(&ctx, classes, walk_results);
+    walk_ms = get_time_ms() - start;
+
+    /* 优化后：一次性构建类层次缓存，之后查方法槽位表 */
+    start = get_time_ms();
+    resolver = cn_inheritance_resolver_create(NULL);
+    for (size_t i = 0; i < program->class_count; i++) {
+        cn_inheritance_resolver_register(resolver, program->classes[i]->as.class_decl);
+    }
+    cn_inheritance_resolver_build_hierarchy(resolver);
+    ctx.hierarchy = resolver;
+    cached_passed = check_overrides(&ctx, classes, cached_results);
+    cached_ms = get_time_ms() - start;
+
+    for (size_t i = 0; i < total; i++) {
+        mismatches += walk_results[i] != cached_results[i];
+    }
+
+    printf("\n=== 重写检查（%d 个类，%zu 个重写方法） ===\n", CLASS_COUNT, total);
+    printf("  逐级查找基类: %10.3f ms（通过 %zu 个）\n", walk_ms, walk_passed);
+    printf("  类层次缓存:   %10.3f ms（通过 %zu 个，含缓存构建）\n", cached_ms, cached_passed);
+    if (cached_ms > 0.0) {
+        printf("  性能提升: %.2fx\n", walk_ms / cached_ms);
+    }
+    if (mismatches > 0) {
+        printf("  结果验证: ✗ %zu 个重写方法的检查结果不一致\n", mismatches);
+    } else {
+        printf("  结果验证: ✓ 两种方式的检查结果一致\n");
+    }
+
+    cn_class_analyzer_context_cleanup(&ctx);
+    cn_inheritance_resolver_destroy(resolver);
+    free(walk_results);
+    free(cached_results);
+    return mismatches == 0;
+}
+
+/* ============================================================================
+ * 派生关系判断测试
+ * ============================================================================ */
+
+static int run_is_derived(BenchClass *classes, CnAstProgram *program) {
+    static int pairs[QUERY_COUNT][2];
+    static bool expected[QUERY_COUNT];
+    CnInheritanceResolver *resolver = cn_inheritance_resolver_create(NULL);
+    CnInheritanceNode *nodes[CLASS_COUNT];
+    size_t positives = 0;
+    size_t mismatches = 0;
+    double start;
+    double walk_ms;
+    double cached_ms;
+
+    srand(42);
+    for (int q = 0; q < QUERY_COUNT; q++) {
+        pairs[q][0] = LAYER_WIDTH * (LAYER_COUNT - 1) + rand() % LAYER_WIDTH;
+        pairs[q][1] = rand() % (CLASS_COUNT - LAYER_WIDTH);
+    }
+
+    start = get_time_ms();
+    for (int q = 0; q < QUERY_COUNT; q++) {
+        expected[q] = walk_is_derived(program, &classes[pairs[q][0]].decl, &classes[pairs[q][1]].decl);
+        positives += expected[q];
+    }
+    walk_ms = get_time_ms() - start;
+
+    for (size_t i = 0; i < program->class_count; i++) {
+        cn_inheritance_resolver_register(resolver, program->classes[i]->as.class_decl);
+    }
+    cn_inheritance_resolver_build_hierarchy(resolver);
+    for (int i = 0; i < CLASS_COUNT; i++) {
+        nodes[i] = cn_inheritance_resolver_node_of(resolver, &classes[i].decl);
+    }
+
+    start = get_time_ms();
+    for (int q = 0; q < QUERY_COUNT; q++) {
+        bool derived = cn_inheritance_node_is_derived_from(resolver, nodes[pairs[q][0]], nodes[pairs[q][1]]);
+        mismatches += derived != expected[q];
+    }
+    cached_ms = get_time_ms() - start;
+
+    printf("\n=== 派生关系判断（%d 次查询，其中 %zu 次为真） ===\n", QUERY_COUNT, positives);
+    printf("  逐级递归遍历: %10.1f ns/次\n", walk_ms * 1000000.0 / QUERY_COUNT);
+    printf("  祖先位集:     %10.1f ns/次\n", cached_ms * 1000000.0 / QUERY_COUNT);
+    if (cached_ms > 0.0) {
+        printf("  性能提升: %.2fx\n", walk_ms / cached_ms);
+    }
+    if (mismatches > 0) {
+        printf("  结果验证: ✗ %zu 次查询结果不一致\n", mismatches);
+    } else {
+        printf("  结果验证: ✓ 两种方式的查询结果一致\n");
+    }
+
+    cn_inheritance_resolver_destroy(resolver);
+    return mismatches == 0;
+}
+
+/* ============================================================================
+ * 主函数
+ * ============================================================================ */
+
+int main(void) {
+    BenchClass *classes = (BenchClass *)calloc(CLASS_COUNT, sizeof(BenchClass));
+    CnAstStmt **stmts = (CnAstStmt **)calloc(CLASS_COUNT, sizeof(CnAstStmt *));
+    CnAstProgram program;
+    int ok = 1;
+
+    if (!classes || !stmts) {
+        fprintf(stderr, "内存分配失败\n");
+        free(classes);
+        free(stmts);
+        return 1;
+    }
+
+    printf("========================================\n");
+    printf("CN语言类层次缓存性能测试\n");
+    printf("========================================\n");
+    printf("类库: %d 层 x %d 个类，每个派生类继承两个基类并重写 %d 个方法\n",
+           LAYER_COUNT, LAYER_WIDTH, OVERRIDES_PER_CLASS);
+
+    build_library(classes, stmts);
+    memset(&program, 0, sizeof(program));
+    program.classes = stmts;
+    program.class_count = CLASS_COUNT;
+
+    ok = run_override_check(classes, &program) && ok;
+    ok = run_is_derived(classes, &program) && ok;
+
+    free(classes);
+    free(stmts);
+
+    printf("\n========================================\n");
+    printf("性能测试完成\n");
+    printf("========================================\n");
+    return ok ? 0 : 1;
+}
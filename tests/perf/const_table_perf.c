@@ -0,0 +1,126 @@
+/**
+ * @file const_table_perf.c
+ * @brief 大型常量数组表编译耗时基准测试
+ *
+ * 生成 250000、500000、1000000 个元素的全局整数表、局部整数表和全局结构体表，
+ * 分别统计语法分析、语义分析、IR 生成与优化、C 代码生成各阶段的耗时及输出大小。
+ * 全常量初始化列表打包为 C 初始化器，不再逐元素生成存储指令，
+ * 每个元素的耗时与输出字节数应基本不随规模变化。
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "perf_compile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SIZE_COUNT 3
+#define OUTPUT_PATH "const_table_perf_out.c"
+
+static const size_t g_sizes[SIZE_COUNT] = { 250000, 500000, 1000000 };
+
+typedef enum TableShape {
+    TABLE_SHAPE_GLOBAL_INT,
+    TABLE_SHAPE_LOCAL_INT,
+    TABLE_SHAPE_GLOBAL_STRUCT
+} TableShape;
+
+/* ============================================================================
+ * 测试辅助函数
+ * ============================================================================ */
+
+/* 生成 count 个元素的常量表源码 */
+static char *build_source(TableShape shape, size_t count) {
+    size_t capacity = count * 40 + 512;
+    size_t length = 0;
+    char *text = (char *)malloc(capacity);
+
+    if (!text) {
+        return NULL;
+    }
+
+    switch (shape) {
+        case TABLE_SHAPE_GLOBAL_INT:
+            length += (size_t)snprintf(text + length, capacity - length, "整数 表[%zu] = {", count);
+            break;
+        case TABLE_SHAPE_LOCAL_INT:
+            length += (size_t)snprintf(text + length, capacity - length,
+                                       "函数 查表(整数 i) -> 整数 {\n    整数 表[%zu] = {", count);
+            break;
+        case TABLE_SHAPE_GLOBAL_STRUCT:
+            length += (size_t)snprintf(text + length, capacity - length,
+                                       "结构体 项 {\n    整数 键;\n    小数 权重;\n};\n项 表[%zu] = {", count);
+            break;
+    }
+    for (size_t i = 0; i < count; i++) {
+        const char *sep = i ? ", " : "";
+        if (shape == TABLE_SHAPE_GLOBAL_STRUCT) {
+            length += (size_t)snprintf(text + length, capacity - length, "%s{键: %zu, 权重: %zu.5}", sep, i, i % 100);
+        } else {
+            length += (size_t)snprintf(text + length, capacity - length, "%s%zu", sep, (i * 7919) % 1000003);
+        }
+    }
+    length += (size_t)snprintf(text + length, capacity - length, "};\n");
+    if (shape == TABLE_SHAPE_LOCAL_INT) {
+        snprintf(text + length, capacity - length, "    返回 表[i];\n}\n");
+    } else if (shape == TABLE_SHAPE_GLOBAL_STRUCT) {
+        snprintf(text + length, capacity - length, "函数 查表(整数 i) -> 整数 {\n    返回 表[i].键;\n}\n");
+    } else {
+        snprintf(text + length, capacity - length, "函数 查表(整数 i) -> 整数 {\n    返回 表[i];\n}\n");
+    }
+    return text;
+}
+
+/* 测量一种常量表在各规模下的耗时，输出每元素耗时与输出字节数 */
+static int run_shape(TableShape shape, const char *name) {
+    double per_item_first = 0.0;
+    double per_item_last = 0.0;
+
+    printf("\n=== %s ===\n", name);
+    cn_perf_print_header("规模", "每项 us", "每项字节");
+    for (int i = 0; i < SIZE_COUNT; i++) {
+        CnPerfStageTimes times = { 0 };
+        char *source = build_source(shape, g_sizes[i]);
+        double per_item;
+
+        if (!source || !cn_perf_compile_once(source, OUTPUT_PATH, &times)) {
+            printf("  结果验证: ✗ %zu 项编译失败\n", g_sizes[i]);
+            free(source);
+            return 0;
+        }
+        free(source);
+
+        per_item = cn_perf_total_ms(&times) * 1000.0 / (double)g_sizes[i];
+        if (i == 0) {
+            per_item_first = per_item;
+        }
+        per_item_last = per_item;
+        cn_perf_print_row(g_sizes[i], &times, per_item, 1);
+    }
+    if (per_item_first > 0.0) {
+        printf("  规模扩大 %zu 倍，每项耗时变为 %.2f 倍（线性时接近 1）\n",
+               g_sizes[SIZE_COUNT - 1] / g_sizes[0], per_item_last / per_item_first);
+    }
+    return 1;
+}
+
+/* ============================================================================
+ * 主函数
+ * ============================================================================ */
+
+int main(void) {
+    printf("========================================\n");
+    printf("CN语言 大型常量数组表编译耗时测试\n");
+    printf("========================================\n");
+
+    if (!run_shape(TABLE_SHAPE_GLOBAL_INT, "全局整数表") ||
+        !run_shape(TABLE_SHAPE_LOCAL_INT, "局部整数表") ||
+        !run_shape(TABLE_SHAPE_GLOBAL_STRUCT, "全局结构体表")) {
+        return 1;
+    }
+
+    printf("\n  结果验证: ✓ 百万元素常量表全部编译完成\n");
+    return 0;
+}
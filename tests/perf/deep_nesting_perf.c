@@ -0,0 +1,123 @@
+/**
+ * @file deep_nesting_perf.c
+ * @brief 深层嵌套代码编译耗时基准测试
+ *
+ * 生成长度为 25000、50000、100000 的左结合加法链、逻辑与链和 "否则 如果" 链，
+ * 分别统计语法分析、语义分析、IR 生成与优化、C 代码生成各阶段的耗时。
+ * 各阶段按循环遍历运算链与否则如果链，规模翻倍时耗时应大致翻倍
+ * （每项耗时基本不变），且十万层输入不会耗尽调用栈。
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "perf_compile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SIZE_COUNT 3
+#define OUTPUT_PATH "deep_nesting_perf_out.c"
+
+static const size_t g_sizes[SIZE_COUNT] = { 25000, 50000, 100000 };
+
+typedef enum DeepShape {
+    DEEP_SHAPE_SUM,
+    DEEP_SHAPE_LOGICAL,
+    DEEP_SHAPE_ELSE_IF
+} DeepShape;
+
+/* ============================================================================
+ * 测试辅助函数
+ * ============================================================================ */
+
+/* 生成 count 项（段）的源码 */
+static char *build_source(DeepShape shape, size_t count) {
+    size_t capacity = count * 64 + 256;
+    size_t length = 0;
+    char *text = (char *)malloc(capacity);
+
+    if (!text) {
+        return NULL;
+    }
+
+    length += (size_t)snprintf(text + length, capacity - length, "函数 求值(整数 a) -> 整数 {\n");
+    switch (shape) {
+        case DEEP_SHAPE_SUM:
+            length += (size_t)snprintf(text + length, capacity - length, "    返回 a");
+            for (size_t i = 1; i < count; i++) {
+                length += (size_t)snprintf(text + length, capacity - length, " + a");
+            }
+            length += (size_t)snprintf(text + length, capacity - length, ";\n");
+            break;
+        case DEEP_SHAPE_LOGICAL:
+            length += (size_t)snprintf(text + length, capacity - length, "    如果 (a > 0");
+            for (size_t i = 1; i < count; i++) {
+                length += (size_t)snprintf(text + length, capacity - length, " && a > 0");
+            }
+            length += (size_t)snprintf(text + length, capacity - length, ") { 返回 1; }\n    返回 0;\n");
+            break;
+        case DEEP_SHAPE_ELSE_IF:
+            length += (size_t)snprintf(text + length, capacity - length, "    如果 (a == 0) { 返回 0; }\n");
+            for (size_t i = 1; i < count; i++) {
+                length += (size_t)snprintf(text + length, capacity - length,
+                                           "    否则 如果 (a == %zu) { 返回 %zu; }\n", i, i);
+            }
+            length += (size_t)snprintf(text + length, capacity - length, "    返回 0;\n");
+            break;
+    }
+    snprintf(text + length, capacity - length, "}\n");
+    return text;
+}
+
+/* 测量一种形状在各规模下的耗时，输出每项耗时 */
+static int run_shape(DeepShape shape, const char *name) {
+    double per_item_first = 0.0;
+    double per_item_last = 0.0;
+
+    printf("\n=== %s ===\n", name);
+    cn_perf_print_header("规模", "每项 us", NULL);
+    for (int i = 0; i < SIZE_COUNT; i++) {
+        CnPerfStageTimes times = { 0 };
+        char *source = build_source(shape, g_sizes[i]);
+        double per_item;
+
+        if (!source || !cn_perf_compile_once(source, OUTPUT_PATH, &times)) {
+            printf("  结果验证: ✗ %zu 项编译失败\n", g_sizes[i]);
+            free(source);
+            return 0;
+        }
+        free(source);
+
+        per_item = cn_perf_total_ms(&times) * 1000.0 / (double)g_sizes[i];
+        if (i == 0) {
+            per_item_first = per_item;
+        }
+        per_item_last = per_item;
+        cn_perf_print_row(g_sizes[i], &times, per_item, 0);
+    }
+    if (per_item_first > 0.0) {
+        printf("  规模扩大 %zu 倍，每项耗时变为 %.2f 倍（线性时接近 1）\n",
+               g_sizes[SIZE_COUNT - 1] / g_sizes[0], per_item_last / per_item_first);
+    }
+    return 1;
+}
+
+/* ============================================================================
+ * 主函数
+ * ============================================================================ */
+
+int main(void) {
+    printf("========================================\n");
+    printf("CN语言 深层嵌套代码编译耗时测试\n");
+    printf("========================================\n");
+
+    if (!run_shape(DEEP_SHAPE_SUM, "左结合加法链") ||
+        !run_shape(DEEP_SHAPE_LOGICAL, "逻辑与链") ||
+        !run_shape(DEEP_SHAPE_ELSE_IF, "否则如果链")) {
+        return 1;
+    }
+
+    printf("\n  结果验证: ✓ 十万项输入全部编译完成\n");
+    return 0;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file embed_resource_perf.c
+ * @brief 编译时资源嵌入耗时基准测试
+ *
+ * 对 256KB、1MB、4MB 的二进制数据，分别以 嵌入("路径") 和等价的字面量初始化列表
+ * 编译为全局字符数组，统计语法分析、语义分析、IR 生成与优化、C 代码生成各阶段的耗时及输出大小。
+ * 嵌入的资源不经词法/语法分析，只读入一次并直接输出为字符串字面量初始化器，
+ * 解析耗时应与数据大小无关，每字节总耗时应远低于字面量初始化列表。
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "cnlang/support/source_manager.h"
+#include "perf_compile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SIZE_COUNT 3
+#define RESOURCE_PATH "embed_resource_perf_blob.bin"
+#define OUTPUT_PATH "embed_resource_perf_out.c"
+
+static const size_t g_sizes[SIZE_COUNT] = { 256 * 1024, 1024 * 1024, 4 * 1024 * 1024 };
+
+typedef enum DataForm {
+    DATA_FORM_LITERAL,
+    DATA_FORM_EMBED
+} DataForm;
+
+/* ============================================================================
+ * 测试辅助函数
+ * ============================================================================ */
+
+/* 第 i 个数据字节 */
+static unsigned char data_byte(size_t i) {
+    return (unsigned char)((i * 7919u) >> 3);
+}
+
+/* 写出 size 字节的资源文件，失败返回 0 */
+static int write_resource(const char *path, size_t size) {
+    FILE *file = fopen(path, "wb");
+    unsigned char buffer[4096];
+    size_t written = 0;
+    int ok = 1;
+
+    if (!file) {
+        return 0;
+    }
+    while (ok && written < size) {
+        size_t chunk = size - written < sizeof(buffer) ? size - written : sizeof(buffer);
+        for (size_t i = 0; i < chunk; i++) {
+            buffer[i] = data_byte(written + i);
+        }
+        ok = fwrite(buffer, 1, chunk, file) == chunk;
+        written += chunk;
+    }
+    return fclose(file) == 0 && ok;
+}
+
+/* 生成以字面量初始化列表或嵌入资源定义 size 字节数据的源码 */
+static char *build_source(DataForm form, size_t size) {
+    size_t capacity = (form == DATA_FORM_LITERAL ? size * 5 : 0) + 512;
+    size_t length = 0;
+    char *text = (char *)malloc(capacity);
+
+    if (!text) {
+        return NULL;
+    }
+
+    if (form == DATA_FORM_EMBED) {
+        length += (size_t)snprintf(text, capacity, "字符 数据[] = 嵌入(\"%s\");\n", RESOURCE_PATH);
+    } else {
+        length += (size_t)snprintf(text, capacity, "字符 数据[%zu] = {", size);
+        for (size_t i = 0; i < size; i++) {
+            length += (size_t)snprintf(text + length, capacity - length, "%s%u", i ? "," : "",
+                                       (unsigned)data_byte(i));
+        }
+        length += (size_t)snprintf(text + length, capacity - length, "};\n");
+    }
+    snprintf(text + length, capacity - length, "函数 查表(整数 i) -> 整数 {\n    返回 数据[i];\n}\n");
+    return text;
+}
+
+/* 测量一种数据形式在各规模下的耗时，返回最大规模的每字节耗时（us），失败返回负数 */
+static double run_form(DataForm form, const char *name) {
+    double per_byte = 0.0;
+
+    printf("\n=== %s ===\n", name);
+    cn_perf_print_header("字节数", "每字节 ns", "每字节输出");
+    for (int i = 0; i < SIZE_COUNT; i++) {
+        CnPerfStageTimes times = { 0 };
+        char *source;
+
+        if (form == DATA_FORM_EMBED) {
+            /* 每个规模重新写出资源文件，先释放共享源文件管理器中的旧内容 */
+            cn_source_manager_release_default();
+            if (!write_resource(RESOURCE_PATH, g_sizes[i])) {
+                printf("  结果验证: ✗ 无法写出资源文件\n");
+                return -1.0;
+            }
+        }
+        source = build_source(form, g_sizes[i]);
+        if (!source || !cn_perf_compile_once(source, OUTPUT_PATH, &times)) {
+            printf("  结果验证: ✗ %zu 字节编译失败\n", g_sizes[i]);
+            free(source);
+            return -1.0;
+        }
+        free(source);
+
+        per_byte = cn_perf_total_ms(&times) * 1000000.0 / (double)g_sizes[i];
+        cn_perf_print_row(g_sizes[i], &times, per_byte, 1);
+    }
+    return per_byte;
+}
+
+/* ============================================================================
+ * 主函数
+ * ============================================================================ */
+
+int main(void) {
+    double literal_ns;
+    double embed_ns;
+
+    printf("========================================\n");
+    printf("CN语言 编译时资源嵌入耗时测试\n");
+    printf("========================================\n");
+
+    literal_ns = run_form(DATA_FORM_LITERAL, "字面量初始化列表");
+    embed_ns = run_form(DATA_FORM_EMBED, "嵌入资源文件");
+    cn_source_manager_release_default();
+    remove(RESOURCE_PATH);
+    if (literal_ns < 0.0 || embed_ns < 0.0) {
+        return 1;
+    }
+
+    if (embed_ns > 0.0) {
+        printf("\n  最大规模下嵌入资源每字节耗时为字面量初始化列表的 1/%.1f\n", literal_ns / embed_ns);
+    }
+    printf("\n  结果验证: ✓ 各规模数据全部编译完成\n");
+    return 0;
+}
@@ -0,0 +1,184 @@
+/**
+ * @file keyword_lookup_perf.c
+ * @brief 关键字查找性能基准测试
+ *
+ * 对比两种关键字识别方式的吞吐量（标识符/秒）：
+ * 1. 优化前：线性扫描关键字表，每项调用 strlen + memcmp
+ * 2. 优化后：cn_frontend_lookup_keyword 的完美哈希查找
+ *
+ * 同时校验两种方式对所有测试词素给出完全相同的结果。
+ *
+ * @version 1.0
+ * @date 2026-10-16
+ */
+
+#include "cnlang/frontend/keywords.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_ITERATIONS 200
+
+/* ============================================================================
+ * 测试辅助函数
+ * ============================================================================ */
+
+/* 获取当前时间（毫秒） */
+static double get_time_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+/* 优化前的线性扫描实现（作为基准） */
+static CnTokenKind lookup_keyword_linear(const char *begin, size_t length) {
+    size_t count = 0;
+    const CnKeywordEntry *keywords = cn_frontend_get_keywords(&count);
+
+    for (size_t i = 0; i < count; i++) {
+        size_t keyword_len = strlen(keywords[i].text);
+        if (length == keyword_len &&
+            memcmp(begin, keywords[i].text, length) == 0) {
+            return keywords[i].kind;
+        }
+    }
+    return CN_TOKEN_INVALID;
+}
+
+/* 典型生成代码中的标识符：中文标识符、ASCII标识符与关键字混合 */
+static const char *const g_sample_words[] = {
+    "变量", "计数器", "x", "索引", "如果", "结果", "返回", "数据表",
+    "i", "状态机", "整数", "字符串", "长度", "否则", "缓冲区", "value",
+    "当前节点", "循环", "下一个", "自身", "自身类型", "字符", "指针", "tmp",
+    "函数", "处理请求", "结构体", "字段", "真", "假", "无", "总和",
+};
+
+typedef struct {
+    const char *text;
+    size_t length;
+} SampleWord;
+
+/* ============================================================================
+ * 测试用例
+ * ============================================================================ */
+
+static int test_results_match(const SampleWord *words, size_t word_count) {
+    size_t keyword_count = 0;
+    const CnKeywordEntry *keywords = cn_frontend_get_keywords(&keyword_count);
+
+    /* 所有关键字本身必须被识别 */
+    for (size_t i = 0; i < keyword_count; i++) {
+        size_t len = strlen(keywords[i].text);
+        if (cn_frontend_lookup_keyword(keywords[i].text, len) != keywords[i].kind) {
+            printf("  结果验证: ✗ 关键字 '%s' 未被识别\n", keywords[i].text);
+            return 0;
+        }
+        /* 关键字前缀不能被误识别 */
+        if (len > 1 &&
+            cn_frontend_lookup_keyword(keywords[i].text, len - 1) !=
+                lookup_keyword_linear(keywords[i].text, len - 1)) {
+            printf("  结果验证: ✗ 关键字前缀 '%s' 结果不一致\n", keywords[i].text);
+            return 0;
+        }
+    }
+
+    for (size_t i = 0; i < word_count; i++) {
+        if (cn_frontend_lookup_keyword(words[i].text, words[i].length) !=
+            lookup_keyword_linear(words[i].text, words[i].length)) {
+            printf("  结果验证: ✗ 词素 '%s' 结果不一致\n", words[i].text);
+            return 0;
+        }
+    }
+
+    printf("  结果验证: ✓ 正确（%zu 个关键字，%zu 个样本词素）\n",
+           keyword_count, word_count);
+    return 1;
+}
+
+static double run_lookup(const SampleWord *words, size_t word_count, int use_hash,
+                         size_t *out_hits) {
+    volatile size_t hits = 0;
+    double start = get_time_ms();
+
+    for (int iter = 0; iter < TEST_ITERATIONS; iter++) {
+        for (size_t i = 0; i < word_count; i++) {
+            CnTokenKind kind = use_hash
+                ? cn_frontend_lookup_keyword(words[i].text, words[i].length)
+                : lookup_keyword_linear(words[i].text, words[i].length);
+            if (kind != CN_TOKEN_INVALID) {
+                hits++;
+            }
+        }
+    }
+
+    *out_hits = hits;
+    return get_time_ms() - start;
+}
+
+/* ============================================================================
+ * 主函数
+ * ============================================================================ */
+
+int main(void) {
+    const size_t sample_count = sizeof(g_sample_words) / sizeof(g_sample_words[0]);
+    const size_t word_count = 100000;
+    SampleWord *words = (SampleWord *)malloc(word_count * sizeof(SampleWord));
+    size_t linear_hits = 0;
+    size_t hash_hits = 0;
+
+    if (!words) {
+        return 1;
+    }
+
+    /* 以固定伪随机序列构造标识符流，保证结果可复现 */
+    unsigned int state = 12345u;
+    for (size_t i = 0; i < word_count; i++) {
+        state = state * 1103515245u + 12345u;
+        words[i].text = g_sample_words[(state >> 16) % sample_count];
+        words[i].length = strlen(words[i].text);
+    }
+
+    printf("========================================\n");
+    printf("CN语言关键字查找性能测试\n");
+    printf("========================================\n");
+    printf("标识符数量: %zu x %d 次迭代\n", word_count, TEST_ITERATIONS);
+
+    if (!test_results_match(words, word_count)) {
+        free(words);
+        return 1;
+    }
+
+    /* 预热：触发哈希表构建 */
+    cn_frontend_lookup_keyword("如果", strlen("如果"));
+
+    double linear_ms = run_lookup(words, word_count, 0, &linear_hits);
+    double hash_ms = run_lookup(words, word_count, 1, &hash_hits);
+    double total = (double)word_count * TEST_ITERATIONS;
+
+    printf("\n=== 优化前: 线性扫描 (strlen + memcmp) ===\n");
+    printf("  总耗时: %.3f ms\n", linear_ms);
+    printf("  吞吐量: %.0f 标识符/秒\n", total / (linear_ms / 1000.0));
+
+    printf("\n=== 优化后: 完美哈希查找 ===\n");
+    printf("  总耗时: %.3f ms\n", hash_ms);
+    printf("  吞吐量: %.0f 标识符/秒\n", total / (hash_ms / 1000.0));
+
+    if (hash_ms > 0) {
+        printf("\n  性能提升: %.2fx\n", linear_ms / hash_ms);
+    }
+
+    free(words);
+
+    if (linear_hits != hash_hits) {
+        printf("  结果验证: ✗ 命中数不一致 (%zu vs %zu)\n", linear_hits, hash_hits);
+        return 1;
+    }
+
+    printf("\n========================================\n");
+    printf("性能测试完成\n");
+    printf("========================================\n");
+
+    return 0;
+}
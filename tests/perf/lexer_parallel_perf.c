@@ -0,0 +1,168 @@
+/**
+ * @file lexer_parallel_perf.c
+ * @brief 推测式并行词法分析性能基准测试
+ *
+ * 构造一个数十 MB 的生成代码源文件（状态机转移表，夹杂多行字符串与
+ * 块注释），对比：
+ * 1. 串行：cn_frontend_token_stream_build
+ * 2. 并行：cn_frontend_token_stream_build_parallel（不同线程数）
+ *
+ * 同时校验并行结果与串行结果逐词元一致。
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "cnlang/frontend/lexer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_ITERATIONS 3
+#define TABLE_ROWS 400000
+
+/* ============================================================================
+ * 测试辅助函数
+ * ============================================================================ */
+
+/* 获取当前时间（毫秒） */
+static double get_time_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+/* 生成状态机转移表：每 64 行插入一段多行说明字符串，每 97 行插入一段块注释 */
+static char *build_source(size_t *out_length) {
+    size_t capacity = (size_t)TABLE_ROWS * 96 + 256;
+    size_t length = 0;
+    char *text = (char *)malloc(capacity);
+
+    if (!text) {
+        return NULL;
+    }
+
+    length += (size_t)snprintf(text + length, capacity - length, "变量 转移表 = [\n");
+    for (int row = 0; row < TABLE_ROWS && capacity - length > 128; row++) {
+        if (row % 64 == 0) {
+            length += (size_t)snprintf(text + length, capacity - length,
+                                       "    \"状态组 %d\n    说明 /* 不是注释 */\",\n", row / 64);
+        } else if (row % 97 == 0) {
+            length += (size_t)snprintf(text + length, capacity - length,
+                                       "    /* 自动生成\n     * \"不是字符串\n     */\n");
+        } else {
+            length += (size_t)snprintf(text + length, capacity - length,
+                                       "    [状态_%d, 事件_%d, 0x%X, %d.5f],\n",
+                                       row % 251, row % 17, row * 7, row % 1000);
+        }
+    }
+    length += (size_t)snprintf(text + length, capacity - length, "];\n");
+
+    *out_length = length;
+    return text;
+}
+
+static int streams_equal(const CnTokenStream *a, const CnTokenStream *b) {
+    if (a->count != b->count) {
+        return 0;
+    }
+    return memcmp(a->kinds, b->kinds, a->count * sizeof(uint8_t)) == 0 &&
+           memcmp(a->offsets, b->offsets, a->count * sizeof(uint32_t)) == 0 &&
+           memcmp(a->lengths, b->lengths, a->count * sizeof(uint32_t)) == 0 &&
+           memcmp(a->suffixes, b->suffixes, a->count * sizeof(uint8_t)) == 0;
+}
+
+static void print_result(const char *title, double ms, size_t length) {
+    double megabytes = (double)length * TEST_ITERATIONS / (1024.0 * 1024.0);
+
+    printf("\n=== %s ===\n", title);
+    printf("  总耗时: %.3f ms\n", ms);
+    if (ms > 0) {
+        printf("  吞吐量: %.1f MB/秒\n", megabytes / (ms / 1000.0));
+    }
+}
+
+/* ============================================================================
+ * 主函数
+ * ============================================================================ */
+
+int main(void) {
+    static const unsigned thread_counts[] = {2, 4, 8};
+    CnTokenStream reference;
+    size_t length = 0;
+    char *source = build_source(&length);
+    double serial_ms;
+    double start;
+
+    if (!source) {
+        return 1;
+    }
+
+    printf("========================================\n");
+    printf("CN语言推测式并行词法分析性能测试\n");
+    printf("========================================\n");
+    printf("源码大小: %zu 字节 x %d 次迭代\n", length, TEST_ITERATIONS);
+
+    if (!cn_frontend_token_stream_build(&reference, source, length, "perf.cn", NULL)) {
+        free(source);
+        return 1;
+    }
+    printf("词元数量: %zu\n", reference.count);
+
+    start = get_time_ms();
+    for (int iter = 0; iter < TEST_ITERATIONS; iter++) {
+        CnTokenStream stream;
+        cn_frontend_token_stream_build(&stream, source, length, "perf.cn", NULL);
+        cn_frontend_token_stream_free(&stream);
+    }
+    serial_ms = get_time_ms() - start;
+    print_result("串行词法分析", serial_ms, length);
+
+    for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+        CnLexerParallelOptions options;
+        CnTokenStream stream;
+        char title[64];
+        double ms;
+
+        cn_frontend_lexer_parallel_options_default(&options);
+        options.thread_count = thread_counts[t];
+
+        if (!cn_frontend_token_stream_build_parallel(&stream, source, length, "perf.cn", NULL,
+                                                     &options) ||
+            !streams_equal(&reference, &stream)) {
+            printf("  结果验证: ✗ %u 线程词元流与串行结果不一致\n", thread_counts[t]);
+            cn_frontend_token_stream_free(&stream);
+            cn_frontend_token_stream_free(&reference);
+            free(source);
+            return 1;
+        }
+        printf("\n  结果验证: ✓ %u 线程与串行一致（%zu 块，重新分析 %zu 块）\n",
+               thread_counts[t], stream.chunk_count, stream.relexed_chunks);
+        cn_frontend_token_stream_free(&stream);
+
+        start = get_time_ms();
+        for (int iter = 0; iter < TEST_ITERATIONS; iter++) {
+            cn_frontend_token_stream_build_parallel(&stream, source, length, "perf.cn", NULL,
+                                                    &options);
+            cn_frontend_token_stream_free(&stream);
+        }
+        ms = get_time_ms() - start;
+
+        snprintf(title, sizeof(title), "并行词法分析 (%u 线程)", thread_counts[t]);
+        print_result(title, ms, length);
+        if (ms > 0) {
+            printf("  性能提升: %.2fx\n", serial_ms / ms);
+        }
+    }
+
+    cn_frontend_token_stream_free(&reference);
+    free(source);
+
+    printf("\n========================================\n");
+    printf("性能测试完成\n");
+    printf("========================================\n");
+
+    return 0;
+}
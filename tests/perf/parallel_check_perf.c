@@ -0,0 +1,225 @@
+/**
+ * @file parallel_check_perf.c
+ * @brief 函数体并行类型检查性能基准测试
+ *
+ * 构造包含数千个函数的生成代码（每个函数数十条局部变量、算术、条件与调用语句，
+ * 少量函数带未定义标识符），对比类型检查阶段的耗时：
+ * 1. 串行：cn_sem_check_types
+ * 2. 并行：cn_sem_check_types_parallel（不同线程数）
+ *
+ * 每次检查前重新解析并构建作用域，只统计类型检查本身的耗时；
+ * 同时校验并行检查的诊断与串行结果逐条一致。
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "cnlang/frontend/lexer.h"
+#include "cnlang/frontend/parser.h"
+#include "cnlang/frontend/ast.h"
+#include "cnlang/frontend/semantics.h"
+#include "cnlang/support/diagnostics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_ITERATIONS 3
+#define FUNCTION_COUNT 4000
+#define STATEMENTS_PER_FUNCTION 24
+
+/* ============================================================================
+ * 测试辅助函数
+ * ============================================================================ */
+
+/* 获取当前时间（毫秒） */
+static double get_time_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+/* 生成函数：每个函数调用前一个函数，每 50 个函数中有一个引用未定义标识符 */
+static char *build_source(void) {
+    size_t capacity = (size_t)FUNCTION_COUNT * (STATEMENTS_PER_FUNCTION * 80 + 256) + 256;
+    size_t length = 0;
+    char *text = (char *)malloc(capacity);
+
+    if (!text) {
+        return NULL;
+    }
+
+    for (int fn = 0; fn < FUNCTION_COUNT; fn++) {
+        length += (size_t)snprintf(text + length, capacity - length,
+                                   "函数 计算%d() -> 整数 {\n    整数 累计 = %d;\n", fn, fn);
+        for (int s = 0; s < STATEMENTS_PER_FUNCTION; s++) {
+            if (s % 4 == 3) {
+                length += (size_t)snprintf(text + length, capacity - length,
+                                           "    如果 (累计 > %d) {\n        累计 = 累计 - 值%d;\n    }\n",
+                                           s * 10, s - 1);
+            } else {
+                length += (size_t)snprintf(text + length, capacity - length,
+                                           "    整数 值%d = 累计 * %d + %d;\n    累计 = 累计 + 值%d;\n",
+                                           s, s + 1, fn % 97, s);
+            }
+        }
+        if (fn > 0) {
+            length += (size_t)snprintf(text + length, capacity - length,
+                                       "    累计 = 累计 + 计算%d();\n", fn - 1);
+        }
+        if (fn % 50 == 49) {
+            length += (size_t)snprintf(text + length, capacity - length, "    累计 = 未定义%d;\n", fn);
+        }
+        length += (size_t)snprintf(text + length, capacity - length, "    返回 累计;\n}\n");
+    }
+    snprintf(text + length, capacity - length, "函数 主程序() -> 整数 {\n    返回 计算0();\n}\n");
+    return text;
+}
+
+typedef struct CheckRun {
+    CnDiagnostics diagnostics;
+    CnAstProgram *program;
+    CnSemScope *global_scope;
+    double check_ms;
+} CheckRun;
+
+/* 解析并构建作用域后执行一次类型检查；thread_count 为 0 时串行检查 */
+static int run_check(CheckRun *run, const char *source, unsigned thread_count) {
+    CnLexer lexer;
+    CnParser *parser;
+    double start;
+
+    memset(run, 0, sizeof(*run));
+    cn_support_diagnostics_init(&run->diagnostics);
+    cn_frontend_lexer_init(&lexer, source, strlen(source), "<parallel_check>");
+    parser = cn_frontend_parser_new(&lexer);
+    if (!parser) {
+        return 0;
+    }
+    cn_frontend_parser_set_diagnostics(parser, &run->diagnostics);
+    cn_frontend_parse_program(parser, &run->program);
+    cn_frontend_parser_free(parser);
+    if (!run->program) {
+        return 0;
+    }
+    run->global_scope = cn_sem_build_scopes(run->program, &run->diagnostics);
+    if (!run->global_scope) {
+        return 0;
+    }
+    cn_sem_resolve_names(run->global_scope, run->program, &run->diagnostics);
+
+    start = get_time_ms();
+    if (thread_count == 0) {
+        cn_sem_check_types(run->global_scope, run->program, &run->diagnostics);
+    } else {
+        CnSemParallelOptions options;
+        cn_sem_parallel_options_default(&options);
+        options.thread_count = thread_count;
+        cn_sem_check_types_parallel(run->global_scope, run->program, &run->diagnostics, &options);
+    }
+    run->check_ms = get_time_ms() - start;
+    return 1;
+}
+
+static void free_run(CheckRun *run) {
+    if (run->global_scope) {
+        cn_sem_scope_free(run->global_scope);
+    }
+    cn_frontend_ast_program_free(run->program);
+    cn_support_diagnostics_free(&run->diagnostics);
+}
+
+static int same_diagnostics(const CnDiagnostics *a, const CnDiagnostics *b) {
+    if (a->count != b->count) {
+        return 0;
+    }
+    for (size_t i = 0; i < a->count; i++) {
+        if (a->items[i].code != b->items[i].code ||
+            strcmp(a->items[i].message ? a->items[i].message : "",
+                   b->items[i].message ? b->items[i].message : "") != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* 多次检查取平均耗时，并与串行结果比较；失败返回负数 */
+static double measure(const char *source, unsigned thread_count, const CnDiagnostics *reference,
+                      size_t *out_count) {
+    double total = 0.0;
+
+    for (int i = 0; i < TEST_ITERATIONS; i++) {
+        CheckRun run;
+        int ok = run_check(&run, source, thread_count);
+        ok = ok && (!reference || same_diagnostics(reference, &run.diagnostics));
+        *out_count = run.diagnostics.count;
+        total += run.check_ms;
+        free_run(&run);
+        if (!ok) {
+            return -1.0;
+        }
+    }
+    return total / TEST_ITERATIONS;
+}
+
+/* ============================================================================
+ * 主函数
+ * ============================================================================ */
+
+int main(void) {
+    static const unsigned thread_counts[] = { 2, 4, 8 };
+    char *source = build_source();
+    CheckRun reference;
+    size_t count = 0;
+    double serial_ms;
+
+    if (!source) {
+        fprintf(stderr, "生成测试源码失败\n");
+        return 1;
+    }
+
+    printf("========================================\n");
+    printf("CN语言函数体并行类型检查性能测试\n");
+    printf("========================================\n");
+    printf("函数数量: %d，每个函数 %d 条语句 x %d 次迭代\n", FUNCTION_COUNT, STATEMENTS_PER_FUNCTION,
+           TEST_ITERATIONS);
+
+    if (!run_check(&reference, source, 0)) {
+        fprintf(stderr, "解析或作用域构建失败\n");
+        free_run(&reference);
+        free(source);
+        return 1;
+    }
+    printf("诊断数量: %zu\n", reference.diagnostics.count);
+
+    serial_ms = measure(source, 0, NULL, &count);
+    printf("\n=== 串行类型检查 ===\n");
+    printf("  平均耗时: %.3f ms\n", serial_ms);
+
+    for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+        double ms = measure(source, thread_counts[t], &reference.diagnostics, &count);
+        printf("\n=== 并行类型检查 (%u 线程) ===\n", thread_counts[t]);
+        if (ms < 0.0) {
+            printf("  结果验证: ✗ %u 线程诊断与串行结果不一致\n", thread_counts[t]);
+            free_run(&reference);
+            free(source);
+            cn_type_context_release_default();
+            return 1;
+        }
+        printf("  平均耗时: %.3f ms\n", ms);
+        if (ms > 0.0) {
+            printf("  性能提升: %.2fx\n", serial_ms / ms);
+        }
+        printf("  结果验证: ✓ %zu 条诊断与串行一致\n", count);
+    }
+
+    free_run(&reference);
+    free(source);
+    cn_type_context_release_default();
+
+    printf("\n========================================\n");
+    printf("性能测试完成\n");
+    printf("========================================\n");
+    return 0;
+}
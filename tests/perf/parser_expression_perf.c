@@ -0,0 +1,140 @@
+/**
+ * @file parser_expression_perf.c
+ * @brief 表达式解析吞吐量基准测试
+ *
+ * 构造以表达式为主的源码（生成的数学内核与大型数组初始化器），
+ * 只统计语法分析阶段（词元流预先构建）的耗时，输出词元/秒与 MB/秒。
+ * 此类代码中绝大多数表达式是单个标识符或字面量，最能体现
+ * Pratt 解析相对逐层递归下降所省去的调用开销。
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "cnlang/frontend/lexer.h"
+#include "cnlang/frontend/parser.h"
+#include "cnlang/frontend/ast.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_ITERATIONS 5
+#define KERNEL_COUNT 4000
+#define INITIALIZER_ELEMENTS 200000
+
+/* ============================================================================
+ * 测试辅助函数
+ * ============================================================================ */
+
+/* 获取当前时间（毫秒） */
+static double get_time_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+/* 生成源码：KERNEL_COUNT 个数学内核函数 + 一个大型数组初始化器 */
+static char *build_source(size_t *out_length) {
+    size_t capacity = (size_t)KERNEL_COUNT * 640 + (size_t)INITIALIZER_ELEMENTS * 12 + 256;
+    size_t length = 0;
+    char *text = (char *)malloc(capacity);
+
+    if (!text) {
+        return NULL;
+    }
+
+    for (int i = 0; i < KERNEL_COUNT; i++) {
+        length += (size_t)snprintf(text + length, capacity - length,
+            "函数 内核_%d() {\n"
+            "    变量 x = %d;\n"
+            "    变量 y = x * 3 + 1;\n"
+            "    变量 z = (x + y) * (x - y) / (y %% 7 + 1);\n"
+            "    变量 w = x << 2 | y >> 1 & z ^ 255;\n"
+            "    变量 r = x > y && y >= z || !(z == 0) ? x * x + y * y : z - x - y;\n"
+            "    r = r + ((x * 31 + y) * 17 + z) * 13 - (w & 65535) + -x * ~y;\n"
+            "    r = r * r - 2 * r * x + x * x + (y - z) * (y + z) / (w + 1);\n"
+            "    返回 r;\n"
+            "}\n",
+            i, i % 101);
+    }
+
+    length += (size_t)snprintf(text + length, capacity - length, "函数 表() {\n    变量 数据 = [");
+    for (int i = 0; i < INITIALIZER_ELEMENTS; i++) {
+        length += (size_t)snprintf(text + length, capacity - length, i ? ", %d" : "%d", i % 9973);
+    }
+    length += (size_t)snprintf(text + length, capacity - length, "];\n    返回 0;\n}\n");
+
+    *out_length = length;
+    return text;
+}
+
+/* ============================================================================
+ * 主函数
+ * ============================================================================ */
+
+int main(void) {
+    CnTokenStream stream;
+    size_t length = 0;
+    char *source = build_source(&length);
+    double parse_ms = 0.0;
+
+    if (!source) {
+        return 1;
+    }
+
+    printf("========================================\n");
+    printf("CN语言 表达式解析吞吐量测试\n");
+    printf("========================================\n");
+
+    if (!cn_frontend_token_stream_build(&stream, source, length, "perf.cn", NULL)) {
+        free(source);
+        return 1;
+    }
+    printf("源码大小: %zu 字节, %zu 个词元 x %d 次迭代\n", length, stream.count, TEST_ITERATIONS);
+
+    for (int iter = 0; iter < TEST_ITERATIONS; iter++) {
+        CnParser *parser = cn_frontend_parser_new_from_stream(&stream);
+        CnAstProgram *program = NULL;
+        double start;
+        bool ok;
+
+        if (!parser) {
+            cn_frontend_token_stream_free(&stream);
+            free(source);
+            return 1;
+        }
+
+        start = get_time_ms();
+        ok = cn_frontend_parse_program(parser, &program);
+        parse_ms += get_time_ms() - start;
+
+        if (!ok || !program || program->function_count != KERNEL_COUNT + 1) {
+            printf("  结果验证: ✗ 解析失败\n");
+            cn_frontend_ast_program_free(program);
+            cn_frontend_parser_free(parser);
+            cn_frontend_token_stream_free(&stream);
+            free(source);
+            return 1;
+        }
+
+        cn_frontend_ast_program_free(program);
+        cn_frontend_parser_free(parser);
+    }
+
+    printf("\n=== 语法分析 ===\n");
+    printf("  总耗时: %.3f ms\n", parse_ms);
+    printf("  平均耗时: %.3f ms\n", parse_ms / TEST_ITERATIONS);
+    if (parse_ms > 0.0) {
+        double seconds = parse_ms / 1000.0;
+        printf("  吞吐量: %.2f M 词元/秒, %.2f MB/秒\n",
+               (double)stream.count * TEST_ITERATIONS / seconds / 1e6,
+               (double)length * TEST_ITERATIONS / seconds / (1024.0 * 1024.0));
+    }
+    printf("  结果验证: ✓ 解析得到 %d 个函数\n", KERNEL_COUNT + 1);
+
+    cn_frontend_token_stream_free(&stream);
+    free(source);
+    return 0;
+}
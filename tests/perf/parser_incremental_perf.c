@@ -0,0 +1,187 @@
+/**
+ * @file parser_incremental_perf.c
+ * @brief 增量解析基准测试
+ *
+ * 构造一个数千行的文档，模拟编辑器在中部某个函数体内逐字符修改，
+ * 对比每次编辑后整份重新解析与只重新解析受影响顶层声明的耗时。
+ * 两条路径都包含整文件词法分析（LSP 每次编辑都会重建词元流）。
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "cnlang/frontend/lexer.h"
+#include "cnlang/frontend/parser.h"
+#include "cnlang/frontend/ast.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define EDIT_COUNT 200
+#define FUNCTION_COUNT 800
+
+/* ============================================================================
+ * 测试辅助函数
+ * ============================================================================ */
+
+/* 获取当前时间（毫秒） */
+static double get_time_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+/* 生成文档源码：FUNCTION_COUNT 个各 8 行的函数 */
+static char *build_source(size_t *out_length, size_t *out_lines) {
+    size_t capacity = (size_t)FUNCTION_COUNT * 400 + 512;
+    size_t length = 0;
+    char *text = (char *)malloc(capacity);
+
+    if (!text) {
+        return NULL;
+    }
+
+    for (int i = 0; i < FUNCTION_COUNT; i++) {
+        length += (size_t)snprintf(text + length, capacity - length,
+            "函数 计算_%d(整数 a, 整数 b) -> 整数 {\n"
+            "    变量 和 = a * %d + b;\n"
+            "    循环 (变量 i = 0; i < b; i++) {\n"
+            "        如果 (和 %% 2 == 0 && i > 3) { 和 = 和 / 2; } 否则 { 和 = 和 * 3 + 1; }\n"
+            "    }\n"
+            "    打印(\"结果\");\n"
+            "    返回 和;\n"
+            "}\n",
+            i, i % 97 + 100);
+    }
+
+    *out_length = length;
+    *out_lines = (size_t)FUNCTION_COUNT * 8;
+    return text;
+}
+
+/* 完整解析：每次编辑后重建词元流并从头解析 */
+static CnAstProgram *parse_full(const char *source, size_t length, CnParseItemList *items) {
+    CnTokenStream stream;
+    CnParser *parser;
+    CnAstProgram *program = NULL;
+
+    if (!cn_frontend_token_stream_build(&stream, source, length, "perf.cn", NULL)) {
+        return NULL;
+    }
+    parser = cn_frontend_parser_new_from_stream(&stream);
+    if (parser) {
+        cn_frontend_parser_set_item_list(parser, items);
+        cn_frontend_parse_program(parser, &program);
+        cn_frontend_parser_free(parser);
+    }
+    cn_frontend_token_stream_free(&stream);
+    return program;
+}
+
+/* 增量解析：重建词元流，只重新解析受影响的声明，失败时完整解析 */
+static CnAstProgram *parse_incremental(const char *source, size_t length, CnAstProgram *program,
+                                       CnParseItemList *items, size_t offset, int *out_reused) {
+    CnTokenStream stream;
+    CnParser *parser;
+
+    *out_reused = 0;
+    if (!cn_frontend_token_stream_build(&stream, source, length, "perf.cn", NULL)) {
+        return program;
+    }
+    parser = cn_frontend_parser_new_from_stream(&stream);
+    if (parser) {
+        if (cn_frontend_parse_program_incremental(parser, program, items, offset, 1, 1)) {
+            *out_reused = 1;
+        } else {
+            cn_frontend_ast_program_free(program);
+            program = NULL;
+            cn_frontend_parser_set_item_list(parser, items);
+            cn_frontend_parse_program(parser, &program);
+        }
+        cn_frontend_parser_free(parser);
+    }
+    cn_frontend_token_stream_free(&stream);
+    return program;
+}
+
+/* ============================================================================
+ * 主函数
+ * ============================================================================ */
+
+int main(void) {
+    size_t length = 0;
+    size_t lines = 0;
+    char *source = build_source(&length, &lines);
+    CnParseItemList items = {0};
+    CnAstProgram *program;
+    const char *target;
+    size_t offset;
+    double full_ms = 0.0;
+    double incremental_ms = 0.0;
+    int reused_count = 0;
+
+    if (!source) {
+        return 1;
+    }
+
+    printf("========================================\n");
+    printf("CN语言 增量解析测试\n");
+    printf("========================================\n");
+    printf("文档大小: %zu 字节, %zu 行, %d 个函数 x %d 次编辑\n", length, lines, FUNCTION_COUNT, EDIT_COUNT);
+
+    // 编辑位置：中部函数体内 "a * N" 的个位数字
+    target = strstr(source, "计算_400(");
+    target = target ? strstr(target, "a * ") : NULL;
+    if (!target) {
+        free(source);
+        return 1;
+    }
+    offset = (size_t)(target - source) + strlen("a * ") + 2;
+
+    program = parse_full(source, length, &items);
+    for (int edit = 0; edit < EDIT_COUNT && program; edit++) {
+        CnAstProgram *full;
+        int reused = 0;
+        double start;
+
+        // AST 中的字符串字面量指向源码，复用的声明要求旧文本保持有效；数字替换不影响它们
+        source[offset] = (char)('0' + (edit + 1) % 10);
+
+        start = get_time_ms();
+        full = parse_full(source, length, NULL);
+        full_ms += get_time_ms() - start;
+
+        start = get_time_ms();
+        program = parse_incremental(source, length, program, &items, offset, &reused);
+        incremental_ms += get_time_ms() - start;
+        reused_count += reused;
+
+        if (!full || !program || full->function_count != FUNCTION_COUNT ||
+            program->function_count != FUNCTION_COUNT) {
+            printf("  结果验证: ✗ 解析失败\n");
+            cn_frontend_ast_program_free(full);
+            cn_frontend_ast_program_free(program);
+            cn_frontend_parse_item_list_free(&items);
+            free(source);
+            return 1;
+        }
+        cn_frontend_ast_program_free(full);
+    }
+
+    printf("\n=== 每次编辑后完整解析 ===\n");
+    printf("  平均耗时: %.3f ms\n", full_ms / EDIT_COUNT);
+    printf("\n=== 增量解析：只重新解析被编辑的函数 ===\n");
+    printf("  平均耗时: %.3f ms\n", incremental_ms / EDIT_COUNT);
+    if (incremental_ms > 0.0) {
+        printf("  加速比: %.2fx\n", full_ms / incremental_ms);
+    }
+    printf("  增量完成: %d / %d 次（其余因废弃节点累积改为完整解析）\n", reused_count, EDIT_COUNT);
+    printf("  结果验证: ✓ %d 个函数\n", FUNCTION_COUNT);
+
+    cn_frontend_ast_program_free(program);
+    cn_frontend_parse_item_list_free(&items);
+    free(source);
+    return 0;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file parser_skim_perf.c
+ * @brief 函数体跳读基准测试
+ *
+ * 构造一个大型导入模块，对比导入路径上的完整解析与跳读解析
+ * （只建立签名，函数体保存为词元区间），并输出跳读后逐个按需解析
+ * 全部函数体的耗时，验证跳读本身不带来额外开销。
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "cnlang/frontend/preprocessor.h"
+#include "cnlang/frontend/parser.h"
+#include "cnlang/frontend/ast.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_ITERATIONS 5
+#define FUNCTION_COUNT 10000
+
+/* ============================================================================
+ * 测试辅助函数
+ * ============================================================================ */
+
+/* 获取当前时间（毫秒） */
+static double get_time_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+/* 生成模块源码：FUNCTION_COUNT 个带循环与分支的公开函数 */
+static char *build_source(size_t *out_length) {
+    size_t capacity = (size_t)FUNCTION_COUNT * 400 + 512;
+    size_t length = 0;
+    char *text = (char *)malloc(capacity);
+
+    if (!text) {
+        return NULL;
+    }
+
+    length += (size_t)snprintf(text + length, capacity - length, "公开:\n");
+    for (int i = 0; i < FUNCTION_COUNT; i++) {
+        length += (size_t)snprintf(text + length, capacity - length,
+            "函数 计算_%d(整数 a, 整数 b) -> 整数 {\n"
+            "    变量 和 = a * %d + b;\n"
+            "    循环 (变量 i = 0; i < b; i++) {\n"
+            "        如果 (和 %% 2 == 0 && i > 3) { 和 = 和 / 2; } 否则 { 和 = 和 * 3 + 1; }\n"
+            "    }\n"
+            "    打印(\"结果\");\n"
+            "    返回 和;\n"
+            "}\n",
+            i, i % 97);
+    }
+
+    *out_length = length;
+    return text;
+}
+
+/* 与导入模块相同的路径：预处理器逐词元供给解析器 */
+static CnAstProgram *parse_module(CnPreprocessor *preprocessor, const char *source, size_t length, bool skim) {
+    CnParser *parser;
+    CnAstProgram *program = NULL;
+
+    cn_frontend_preprocessor_init(preprocessor, source, length, "perf.cn");
+    parser = cn_frontend_parser_new_from_preprocessor(preprocessor);
+    if (parser) {
+        cn_frontend_parser_set_skim_bodies(parser, skim);
+        if (!cn_frontend_parse_program(parser, &program)) {
+            cn_frontend_ast_program_free(program);
+            program = NULL;
+        }
+        cn_frontend_parser_free(parser);
+    }
+    return program;
+}
+
+/* ============================================================================
+ * 主函数
+ * ============================================================================ */
+
+int main(void) {
+    size_t length = 0;
+    char *source = build_source(&length);
+    double full_ms = 0.0;
+    double skim_ms = 0.0;
+    double force_ms = 0.0;
+
+    if (!source) {
+        return 1;
+    }
+
+    printf("========================================\n");
+    printf("CN语言 函数体跳读测试\n");
+    printf("========================================\n");
+    printf("模块大小: %zu 字节, %d 个函数 x %d 次迭代\n", length, FUNCTION_COUNT, TEST_ITERATIONS);
+
+    for (int iter = 0; iter < TEST_ITERATIONS; iter++) {
+        CnPreprocessor preprocessors[2];
+        CnAstProgram *full;
+        CnAstProgram *skimmed;
+        bool forced;
+        double start;
+
+        start = get_time_ms();
+        full = parse_module(&preprocessors[0], source, length, false);
+        full_ms += get_time_ms() - start;
+
+        start = get_time_ms();
+        skimmed = parse_module(&preprocessors[1], source, length, true);
+        skim_ms += get_time_ms() - start;
+
+        // 函数体词元引用预处理器的输出，按需解析完成前不能释放预处理器
+        start = get_time_ms();
+        forced = skimmed && cn_frontend_parse_lazy_bodies(skimmed, NULL);
+        force_ms += get_time_ms() - start;
+
+        if (!full || !forced || full->function_count != FUNCTION_COUNT ||
+            skimmed->function_count != FUNCTION_COUNT || !skimmed->functions[FUNCTION_COUNT - 1]->body) {
+            printf("  结果验证: ✗ 解析失败\n");
+            cn_frontend_ast_program_free(full);
+            cn_frontend_ast_program_free(skimmed);
+            cn_frontend_preprocessor_free(&preprocessors[0]);
+            cn_frontend_preprocessor_free(&preprocessors[1]);
+            free(source);
+            return 1;
+        }
+
+        cn_frontend_ast_program_free(full);
+        cn_frontend_ast_program_free(skimmed);
+        cn_frontend_preprocessor_free(&preprocessors[0]);
+        cn_frontend_preprocessor_free(&preprocessors[1]);
+    }
+
+    printf("\n=== 完整解析 ===\n");
+    printf("  平均耗时: %.3f ms\n", full_ms / TEST_ITERATIONS);
+    printf("\n=== 跳读解析：只建立签名 ===\n");
+    printf("  平均耗时: %.3f ms\n", skim_ms / TEST_ITERATIONS);
+    if (skim_ms > 0.0) {
+        printf("  加速比: %.2fx\n", full_ms / skim_ms);
+    }
+    printf("\n=== 跳读后按需解析全部函数体 ===\n");
+    printf("  平均耗时: %.3f ms（跳读 + 按需合计 %.3f ms）\n",
+           force_ms / TEST_ITERATIONS, (skim_ms + force_ms) / TEST_ITERATIONS);
+    printf("  结果验证: ✓ %d 个函数体全部解析\n", FUNCTION_COUNT);
+
+    free(source);
+    return 0;
+}
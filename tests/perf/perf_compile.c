@@ -0,0 +1,132 @@
+/**
+ * @file perf_compile.c
+ * @brief 编译流水线基准测试共用的计时与分阶段编译辅助函数实现
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "perf_compile.h"
+
+#include "cnlang/frontend/lexer.h"
+#include "cnlang/frontend/parser.h"
+#include "cnlang/frontend/ast.h"
+#include "cnlang/frontend/semantics.h"
+#include "cnlang/support/diagnostics.h"
+#include "cnlang/ir/irgen.h"
+#include "cnlang/ir/pass.h"
+#include "cnlang/backend/cgen.h"
+#include "cnlang/support/config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+double cn_perf_time_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+double cn_perf_total_ms(const CnPerfStageTimes *times) {
+    return times->parse_ms + times->semantic_ms + times->ir_ms + times->cgen_ms;
+}
+
+/* 获取文件大小（字节），失败返回 0 */
+static long file_size(const char *path) {
+    FILE *file = fopen(path, "rb");
+    long size = 0;
+
+    if (!file) {
+        return 0;
+    }
+    if (fseek(file, 0, SEEK_END) == 0) {
+        size = ftell(file);
+    }
+    fclose(file);
+    return size < 0 ? 0 : size;
+}
+
+int cn_perf_compile_once(const char *source, const char *output_path, CnPerfStageTimes *times) {
+    CnDiagnostics diagnostics;
+    CnLexer lexer;
+    CnParser *parser;
+    CnAstProgram *program = NULL;
+    CnSemScope *global_scope = NULL;
+    CnIrModule *ir_module = NULL;
+    int ok = 0;
+    double start;
+
+    cn_support_diagnostics_init(&diagnostics);
+    cn_frontend_lexer_init(&lexer, source, strlen(source), "perf.cn");
+    parser = cn_frontend_parser_new(&lexer);
+    if (!parser) {
+        cn_support_diagnostics_free(&diagnostics);
+        return 0;
+    }
+    cn_frontend_parser_set_diagnostics(parser, &diagnostics);
+
+    start = cn_perf_time_ms();
+    cn_frontend_parse_program(parser, &program);
+    times->parse_ms = cn_perf_time_ms() - start;
+    if (!program || cn_support_diagnostics_error_count(&diagnostics) > 0) {
+        goto cleanup;
+    }
+
+    start = cn_perf_time_ms();
+    global_scope = cn_sem_build_scopes(program, &diagnostics);
+    cn_sem_resolve_names(global_scope, program, &diagnostics);
+    cn_sem_check_types(global_scope, program, &diagnostics);
+    times->semantic_ms = cn_perf_time_ms() - start;
+    if (cn_support_diagnostics_error_count(&diagnostics) > 0) {
+        goto cleanup;
+    }
+
+    start = cn_perf_time_ms();
+    ir_module = cn_ir_gen_program(program, global_scope,
+                                  cn_support_target_triple_make(CN_TARGET_ARCH_X86_64, CN_TARGET_VENDOR_PC,
+                                                                CN_TARGET_OS_NONE, CN_TARGET_ABI_ELF),
+                                  CN_COMPILE_MODE_HOSTED);
+    if (ir_module) {
+        cn_ir_run_default_passes(ir_module);
+    }
+    times->ir_ms = cn_perf_time_ms() - start;
+    if (!ir_module) {
+        goto cleanup;
+    }
+
+    start = cn_perf_time_ms();
+    ok = cn_cgen_module_to_file(ir_module, output_path) == 0;
+    times->cgen_ms = cn_perf_time_ms() - start;
+    times->output_bytes = ok ? file_size(output_path) : 0;
+    remove(output_path);
+
+cleanup:
+    if (ir_module) {
+        cn_ir_module_free(ir_module);
+    }
+    if (global_scope) {
+        cn_sem_scope_free(global_scope);
+    }
+    cn_frontend_ast_program_free(program);
+    cn_frontend_parser_free(parser);
+    cn_support_diagnostics_free(&diagnostics);
+    return ok;
+}
+
+void cn_perf_print_header(const char *size_label, const char *per_item_label, const char *bytes_label) {
+    printf("  %8s %10s %10s %10s %10s %12s", size_label, "解析ms", "语义ms", "IR ms", "C生成ms", per_item_label);
+    if (bytes_label) {
+        printf(" %12s", bytes_label);
+    }
+    printf("\n");
+}
+
+void cn_perf_print_row(size_t size, const CnPerfStageTimes *times, double per_item, int show_bytes) {
+    printf("  %8zu %10.2f %10.2f %10.2f %10.2f %12.3f", size,
+           times->parse_ms, times->semantic_ms, times->ir_ms, times->cgen_ms, per_item);
+    if (show_bytes) {
+        printf(" %12.2f", (double)times->output_bytes / (double)size);
+    }
+    printf("\n");
+}
@@ -0,0 +1,47 @@
+/**
+ * @file perf_compile.h
+ * @brief 编译流水线基准测试共用的计时与分阶段编译辅助函数
+ *
+ * 把源码依次经过语法分析、语义分析、IR 生成与优化、C 代码生成，
+ * 记录各阶段耗时与生成的 C 代码大小，并按统一格式输出各规模的结果行。
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#ifndef CN_TESTS_PERF_PERF_COMPILE_H
+#define CN_TESTS_PERF_PERF_COMPILE_H
+
+#include <stddef.h>
+
+/* 一次编译各阶段的耗时（毫秒）与生成的 C 代码字节数 */
+typedef struct CnPerfStageTimes {
+    double parse_ms;
+    double semantic_ms;
+    double ir_ms;
+    double cgen_ms;
+    long output_bytes;
+} CnPerfStageTimes;
+
+/* 获取当前时间（毫秒） */
+double cn_perf_time_ms(void);
+
+/* 各阶段耗时之和（毫秒） */
+double cn_perf_total_ms(const CnPerfStageTimes *times);
+
+/*
+ * 编译一次并记录各阶段耗时，失败返回 0
+ * C 代码写入 output_path，记录大小后删除
+ */
+int cn_perf_compile_once(const char *source, const char *output_path, CnPerfStageTimes *times);
+
+/*
+ * 输出结果表头：规模列名、各阶段耗时列，以及每项耗时列名；
+ * bytes_label 非 NULL 时追加每项输出字节数一列
+ */
+void cn_perf_print_header(const char *size_label, const char *per_item_label, const char *bytes_label);
+
+/* 输出一行结果；show_bytes 非零时追加 output_bytes / size 一列 */
+void cn_perf_print_row(size_t size, const CnPerfStageTimes *times, double per_item, int show_bytes);
+
+#endif /* CN_TESTS_PERF_PERF_COMPILE_H */
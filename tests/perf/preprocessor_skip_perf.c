@@ -0,0 +1,269 @@
+/**
+ * @file preprocessor_skip_perf.c
+ * @brief 不活跃条件编译区域跳过性能基准测试
+ *
+ * 构造一个包含大块禁用平台代码的源文件（模拟独立环境内核构建中
+ * 针对其他平台的 #ifdef 分支），对比：
+ * 1. 优化前：逐字符前进并维护行列号，逐行识别指令
+ * 2. 优化后：cn_frontend_preprocessor_process / 逐词元模式中的
+ *    memchr 行跳转快速路径
+ *
+ * 同时校验跳过区域后的输出与行号正确。
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "cnlang/frontend/preprocessor.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_ITERATIONS 20
+#define DISABLED_BLOCKS 20000
+
+/* ============================================================================
+ * 测试辅助函数
+ * ============================================================================ */
+
+/* 获取当前时间（毫秒） */
+static double get_time_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+/* 禁用平台中的一段典型代码：函数、嵌套条件块、宏定义与注释 */
+static const char *const g_disabled_block =
+    "函数 平台_初始化中断(整数 向量, 整数 优先级) {\n"
+    "    变量 寄存器 = 读端口(0x20 + 向量);\n"
+    "    // 屏蔽低优先级中断 # 注释中的井号\n"
+    "    如果 (优先级 > 3) { 寄存器 = 寄存器 | (1 << 向量); }\n"
+    "#ifdef 平台_调试\n"
+    "    打印(\"中断 #%d 初始化\", 向量);\n"
+    "#endif\n"
+    "    写端口(0x21, 寄存器);\n"
+    "    返回 寄存器;\n"
+    "}\n"
+    "#define 平台_页大小 4096\n"
+    "/* 页表项布局：\n"
+    " * #endif 不是指令\n"
+    " */\n";
+
+typedef struct {
+    char *text;
+    size_t length;
+    size_t region_offset; /* 禁用区域起始偏移（#ifdef 行之后） */
+    int expected_line;    /* #endif 之后第一行有效代码的行号 */
+} PerfSource;
+
+static int build_source(PerfSource *out) {
+    const char *prologue = "变量 启动 = 1;\n#ifdef 平台_其他架构\n";
+    const char *epilogue = "#endif\n变量 结束 = 2;\n";
+    size_t block_length = strlen(g_disabled_block);
+    size_t capacity = strlen(prologue) + block_length * DISABLED_BLOCKS + strlen(epilogue) + 1;
+    int block_lines = 0;
+
+    out->text = (char *)malloc(capacity);
+    if (!out->text) {
+        return 0;
+    }
+
+    for (const char *p = g_disabled_block; *p; p++) {
+        if (*p == '\n') {
+            block_lines++;
+        }
+    }
+
+    out->length = 0;
+    memcpy(out->text, prologue, strlen(prologue));
+    out->length += strlen(prologue);
+    out->region_offset = out->length;
+    for (int i = 0; i < DISABLED_BLOCKS; i++) {
+        memcpy(out->text + out->length, g_disabled_block, block_length);
+        out->length += block_length;
+    }
+    memcpy(out->text + out->length, epilogue, strlen(epilogue));
+    out->length += strlen(epilogue);
+    out->text[out->length] = '\0';
+
+    /* 前导 2 行 + 禁用区域 + #endif 行 */
+    out->expected_line = 2 + block_lines * DISABLED_BLOCKS + 2;
+    return 1;
+}
+
+/* 优化前的跳过方式（作为基准）：逐字符前进、维护行列号，在行首识别指令 */
+static int skip_region_bytewise(const char *source, size_t length, size_t offset, int line) {
+    int column = 1;
+    int depth = 0;
+    int at_line_start = 1;
+
+    while (offset < length) {
+        char c = source[offset];
+
+        if (at_line_start && c == '#') {
+            const char *name = source + offset + 1;
+            if (strncmp(name, "ifdef", 5) == 0 || strncmp(name, "ifndef", 6) == 0) {
+                depth++;
+            } else if (strncmp(name, "endif", 5) == 0) {
+                if (depth == 0) {
+                    return line;
+                }
+                depth--;
+            }
+        }
+        if (c != ' ' && c != '\t') {
+            at_line_start = 0;
+        }
+
+        if (c == '\n') {
+            line++;
+            column = 1;
+            at_line_start = 1;
+        } else {
+            column++;
+        }
+        offset++;
+    }
+    (void)column;
+    return line;
+}
+
+/* ============================================================================
+ * 测试用例
+ * ============================================================================ */
+
+static int test_results_match(const PerfSource *source) {
+    CnPreprocessor preprocessor;
+    CnToken token;
+    int ok = 1;
+
+    cn_frontend_preprocessor_init(&preprocessor, source->text, source->length, "perf.cn");
+    if (!cn_frontend_preprocessor_process(&preprocessor) ||
+        strstr(preprocessor.output, "变量 结束 = 2;") == NULL ||
+        strstr(preprocessor.output, "平台_初始化中断") != NULL ||
+        cn_frontend_preprocessor_is_defined(&preprocessor, "平台_页大小", strlen("平台_页大小"))) {
+        printf("  结果验证: ✗ 整体预处理输出不正确\n");
+        ok = 0;
+    }
+    cn_frontend_preprocessor_free(&preprocessor);
+
+    /* 逐词元模式：跳过区域后的第一个词元行号必须准确 */
+    cn_frontend_preprocessor_init(&preprocessor, source->text, source->length, "perf.cn");
+    for (int i = 0; i < 5; i++) {
+        cn_frontend_preprocessor_next_token(&preprocessor, &token);
+    }
+    cn_frontend_preprocessor_next_token(&preprocessor, &token);
+    if (token.kind != CN_TOKEN_KEYWORD_VAR || token.line != source->expected_line) {
+        printf("  结果验证: ✗ 逐词元模式行号 %d，期望 %d\n", token.line, source->expected_line);
+        ok = 0;
+    }
+    cn_frontend_preprocessor_free(&preprocessor);
+
+    if (skip_region_bytewise(source->text, source->length, source->region_offset, 3) !=
+        source->expected_line - 1) {
+        printf("  结果验证: ✗ 基准实现行号不一致\n");
+        ok = 0;
+    }
+
+    if (ok) {
+        printf("  结果验证: ✓ 正确（跳过区域后行号 %d）\n", source->expected_line);
+    }
+    return ok;
+}
+
+static double run_bytewise(const PerfSource *source) {
+    volatile int line = 0;
+    double start = get_time_ms();
+
+    for (int iter = 0; iter < TEST_ITERATIONS; iter++) {
+        line += skip_region_bytewise(source->text, source->length, source->region_offset, 3);
+    }
+    (void)line;
+    return get_time_ms() - start;
+}
+
+static double run_process(const PerfSource *source) {
+    double start = get_time_ms();
+
+    for (int iter = 0; iter < TEST_ITERATIONS; iter++) {
+        CnPreprocessor preprocessor;
+        cn_frontend_preprocessor_init(&preprocessor, source->text, source->length, "perf.cn");
+        cn_frontend_preprocessor_process(&preprocessor);
+        cn_frontend_preprocessor_free(&preprocessor);
+    }
+    return get_time_ms() - start;
+}
+
+static double run_token_stream(const PerfSource *source) {
+    volatile size_t tokens = 0;
+    double start = get_time_ms();
+
+    for (int iter = 0; iter < TEST_ITERATIONS; iter++) {
+        CnPreprocessor preprocessor;
+        CnToken token;
+        cn_frontend_preprocessor_init(&preprocessor, source->text, source->length, "perf.cn");
+        while (cn_frontend_preprocessor_next_token(&preprocessor, &token) &&
+               token.kind != CN_TOKEN_EOF) {
+            tokens++;
+        }
+        cn_frontend_preprocessor_free(&preprocessor);
+    }
+    (void)tokens;
+    return get_time_ms() - start;
+}
+
+static void print_result(const char *title, double ms, size_t length) {
+    double megabytes = (double)length * TEST_ITERATIONS / (1024.0 * 1024.0);
+
+    printf("\n=== %s ===\n", title);
+    printf("  总耗时: %.3f ms\n", ms);
+    if (ms > 0) {
+        printf("  吞吐量: %.1f MB/秒\n", megabytes / (ms / 1000.0));
+    }
+}
+
+/* ============================================================================
+ * 主函数
+ * ============================================================================ */
+
+int main(void) {
+    PerfSource source;
+
+    if (!build_source(&source)) {
+        return 1;
+    }
+
+    printf("========================================\n");
+    printf("CN语言预处理器不活跃区域跳过性能测试\n");
+    printf("========================================\n");
+    printf("源码大小: %zu 字节 (%d 行禁用代码) x %d 次迭代\n",
+           source.length, source.expected_line - 4, TEST_ITERATIONS);
+
+    if (!test_results_match(&source)) {
+        free(source.text);
+        return 1;
+    }
+
+    double bytewise_ms = run_bytewise(&source);
+    double process_ms = run_process(&source);
+    double stream_ms = run_token_stream(&source);
+
+    print_result("优化前: 逐字符跳过（仅扫描，不含其他预处理）", bytewise_ms, source.length);
+    print_result("优化后: 整体预处理 (memchr 行跳转)", process_ms, source.length);
+    print_result("优化后: 逐词元预处理 (memchr 行跳转)", stream_ms, source.length);
+
+    if (process_ms > 0) {
+        printf("\n  性能提升: %.2fx (整体预处理 vs 逐字符扫描)\n", bytewise_ms / process_ms);
+    }
+
+    free(source.text);
+
+    printf("\n========================================\n");
+    printf("性能测试完成\n");
+    printf("========================================\n");
+
+    return 0;
+}
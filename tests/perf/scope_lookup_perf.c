@@ -0,0 +1,155 @@
+/**
+ * @file scope_lookup_perf.c
+ * @brief 作用域符号查找性能基准测试
+ *
+ * 在全局作用域中插入 1000、10000、100000 个符号，从 4 层嵌套的块作用域中
+ * 按名字与按种类查找全部符号，统计每次插入与查找的平均耗时（纳秒）：
+ * 1. 优化前：逐个比较驻留名字指针的符号链表遍历（在本文件中模拟）
+ * 2. 优化后：符号数超过阈值的作用域使用开放寻址哈希索引
+ *
+ * 优化后每次查找的耗时应基本不随作用域规模变化，同时校验两种方式结果一致。
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "cnlang/frontend/semantics.h"
+#include "cnlang/support/string_pool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SIZE_COUNT 3
+#define BLOCK_DEPTH 4
+#define NAME_CAPACITY 32
+
+static const size_t g_sizes[SIZE_COUNT] = { 1000, 10000, 100000 };
+
+/* ============================================================================
+ * 测试辅助函数
+ * ============================================================================ */
+
+/* 获取当前时间（毫秒） */
+static double get_time_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+/* 优化前的链表查找（作为基准）：符号按插入逆序排列，逐个比较驻留指针 */
+static size_t lookup_linear(const char *const *names, size_t count, const char *key) {
+    for (size_t i = count; i > 0; i--) {
+        if (names[i - 1] == key) {
+            return i - 1;
+        }
+    }
+    return count;
+}
+
+/* 测量一种规模，失败返回 0 */
+static int run_size(size_t count) {
+    char *name_text = (char *)malloc(count * NAME_CAPACITY);
+    size_t *name_lengths = (size_t *)malloc(count * sizeof(size_t));
+    CnSemSymbol **symbols = (CnSemSymbol **)malloc(count * sizeof(CnSemSymbol *));
+    const char **interned = (const char **)malloc(count * sizeof(const char *));
+    CnSemScope *global = cn_sem_scope_new(CN_SEM_SCOPE_GLOBAL, NULL);
+    CnSemScope *blocks[BLOCK_DEPTH];
+    CnSemScope *inner = global;
+    size_t linear_count = count < 20000 ? count : 20000;
+    int ok = name_text && name_lengths && symbols && interned && global;
+    double start;
+    double insert_ns = 0.0;
+    double lookup_ns = 0.0;
+    double by_kind_ns = 0.0;
+    double linear_ns = 0.0;
+    size_t mismatches = 0;
+
+    for (int d = 0; d < BLOCK_DEPTH; d++) {
+        blocks[d] = ok ? cn_sem_scope_new(CN_SEM_SCOPE_BLOCK, inner) : NULL;
+        ok = ok && blocks[d];
+        inner = blocks[d] ? blocks[d] : inner;
+    }
+
+    if (ok) {
+        for (size_t i = 0; i < count; i++) {
+            name_lengths[i] = (size_t)snprintf(name_text + i * NAME_CAPACITY, NAME_CAPACITY, "全局符号_%zu", i);
+        }
+
+        start = get_time_ms();
+        for (size_t i = 0; i < count; i++) {
+            symbols[i] = cn_sem_scope_insert_symbol(global, name_text + i * NAME_CAPACITY, name_lengths[i],
+                                                    (i & 1) ? CN_SEM_SYMBOL_FUNCTION : CN_SEM_SYMBOL_VARIABLE);
+        }
+        insert_ns = (get_time_ms() - start) * 1000000.0 / (double)count;
+        for (size_t i = 0; i < count; i++) {
+            ok = ok && symbols[i];
+            interned[i] = symbols[i] ? symbols[i]->name : NULL;
+        }
+    }
+
+    if (ok) {
+        start = get_time_ms();
+        for (size_t i = 0; i < count; i++) {
+            mismatches += cn_sem_scope_lookup(inner, name_text + i * NAME_CAPACITY, name_lengths[i]) != symbols[i];
+        }
+        lookup_ns = (get_time_ms() - start) * 1000000.0 / (double)count;
+
+        start = get_time_ms();
+        for (size_t i = 0; i < count; i++) {
+            mismatches += cn_sem_scope_lookup_by_kind(inner, name_text + i * NAME_CAPACITY, name_lengths[i],
+                                                      CN_SEM_SYMBOL_FUNCTION) != symbols[i];
+        }
+        by_kind_ns = (get_time_ms() - start) * 1000000.0 / (double)count;
+
+        /* 链表基准只取前若干个名字，避免最大规模下耗时过长 */
+        start = get_time_ms();
+        for (size_t i = 0; i < linear_count; i++) {
+            const char *key = cn_string_pool_find(cn_string_pool_default(), name_text + i * NAME_CAPACITY,
+                                                  name_lengths[i]);
+            mismatches += lookup_linear(interned, count, key) != i;
+        }
+        linear_ns = (get_time_ms() - start) * 1000000.0 / (double)linear_count;
+    }
+
+    if (ok) {
+        printf("  %8zu %10.1f %10.1f %10.1f %12.1f %10.1fx\n", count, insert_ns, lookup_ns, by_kind_ns, linear_ns,
+               lookup_ns > 0.0 ? linear_ns / lookup_ns : 0.0);
+    }
+
+    for (int d = BLOCK_DEPTH - 1; d >= 0; d--) {
+        cn_sem_scope_free(blocks[d]);
+    }
+    cn_sem_scope_free(global);
+    free(interned);
+    free(symbols);
+    free(name_lengths);
+    free(name_text);
+
+    if (!ok || mismatches > 0) {
+        printf("  结果验证: ✗ %zu 个符号的查找结果不一致\n", count);
+        return 0;
+    }
+    return 1;
+}
+
+/* ============================================================================
+ * 主函数
+ * ============================================================================ */
+
+int main(void) {
+    printf("========================================\n");
+    printf("CN语言 作用域符号查找性能测试\n");
+    printf("========================================\n");
+    printf("  %8s %10s %10s %10s %12s %11s\n", "符号数", "插入ns", "查找ns", "按种类ns", "链表查找ns", "加速比");
+
+    for (int i = 0; i < SIZE_COUNT; i++) {
+        if (!run_size(g_sizes[i])) {
+            return 1;
+        }
+    }
+
+    printf("\n  结果验证: ✓ 哈希索引与链表查找结果一致\n");
+    return 0;
+}
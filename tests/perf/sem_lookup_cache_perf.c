@@ -0,0 +1,162 @@
+/**
+ * @file sem_lookup_cache_perf.c
+ * @brief 标识符符号缓存性能基准测试
+ *
+ * 模拟语义分析与代码生成各阶段对同一批标识符的重复查找：
+ * 全局作用域含数千个符号，函数作用域含参数，其下嵌套多层块作用域；
+ * 每个标识符节点从所在的块作用域被查找 PHASE_COUNT 次（对应名字解析、类型检查、IR 生成等阶段）。
+ * 比较每次都调用 cn_sem_scope_lookup 与使用节点缓存的 cn_sem_scope_lookup_identifier 的耗时，
+ * 并校验两者返回同一符号。
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "cnlang/frontend/semantics.h"
+#include "cnlang/support/string_pool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define GLOBAL_COUNT 4000
+#define PARAM_COUNT 8
+#define BLOCK_DEPTH 4
+#define LOCALS_PER_BLOCK 6
+#define IDENTIFIER_COUNT 200000
+#define PHASE_COUNT 5
+
+/* ============================================================================
+ * 测试辅助函数
+ * ============================================================================ */
+
+/* 获取当前时间（毫秒） */
+static double get_time_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+/* 插入符号并返回驻留后的名字，供标识符节点引用 */
+static const char *insert_named(CnSemScope *scope, const char *prefix, size_t index) {
+    char name[32];
+    CnSemSymbol *symbol;
+
+    snprintf(name, sizeof(name), "%s%zu", prefix, index);
+    symbol = cn_sem_scope_insert_symbol(scope, name, strlen(name), CN_SEM_SYMBOL_VARIABLE);
+    return symbol ? symbol->name : NULL;
+}
+
+/* ============================================================================
+ * 主函数
+ * ============================================================================ */
+
+int main(void) {
+    CnSemScope *global = cn_sem_scope_new(CN_SEM_SCOPE_GLOBAL, NULL);
+    CnSemScope *function = cn_sem_scope_new(CN_SEM_SCOPE_FUNCTION, global);
+    CnSemScope *blocks[BLOCK_DEPTH];
+    const char *globals[GLOBAL_COUNT];
+    const char *params[PARAM_COUNT];
+    const char *locals[BLOCK_DEPTH][LOCALS_PER_BLOCK];
+    CnAstExpr *nodes = (CnAstExpr *)calloc(IDENTIFIER_COUNT, sizeof(CnAstExpr));
+    CnSemScope **node_scopes = (CnSemScope **)calloc(IDENTIFIER_COUNT, sizeof(CnSemScope *));
+    CnSemSymbol **expected = (CnSemSymbol **)calloc(IDENTIFIER_COUNT, sizeof(CnSemSymbol *));
+    size_t mismatches = 0;
+    size_t lookups = (size_t)IDENTIFIER_COUNT * PHASE_COUNT;
+    double start;
+    double plain_ms;
+    double cached_ms;
+
+    if (!global || !function || !nodes || !node_scopes || !expected) {
+        fprintf(stderr, "内存分配失败\n");
+        return 1;
+    }
+
+    printf("========================================\n");
+    printf("CN语言标识符符号缓存性能测试\n");
+    printf("========================================\n");
+    printf("全局符号: %d，参数: %d，块嵌套: %d 层 x %d 个局部变量\n",
+           GLOBAL_COUNT, PARAM_COUNT, BLOCK_DEPTH, LOCALS_PER_BLOCK);
+    printf("标识符节点: %d，每个节点查找 %d 次\n", IDENTIFIER_COUNT, PHASE_COUNT);
+
+    for (size_t i = 0; i < GLOBAL_COUNT; i++) {
+        globals[i] = insert_named(global, "全局", i);
+    }
+    for (size_t i = 0; i < PARAM_COUNT; i++) {
+        params[i] = insert_named(function, "参数", i);
+    }
+    for (size_t d = 0; d < BLOCK_DEPTH; d++) {
+        blocks[d] = cn_sem_scope_new(CN_SEM_SCOPE_BLOCK, d == 0 ? function : blocks[d - 1]);
+        for (size_t i = 0; i < LOCALS_PER_BLOCK; i++) {
+            locals[d][i] = insert_named(blocks[d], d % 2 ? "临时" : "局部", d * LOCALS_PER_BLOCK + i);
+        }
+    }
+
+    /* 一半引用局部变量，其余引用参数与全局变量；节点位于随机深度的块中 */
+    srand(42);
+    for (size_t i = 0; i < IDENTIFIER_COUNT; i++) {
+        size_t depth = (size_t)rand() % BLOCK_DEPTH;
+        int choice = rand() % 10;
+        const char *name;
+
+        if (choice < 5) {
+            name = locals[(size_t)rand() % (depth + 1)][(size_t)rand() % LOCALS_PER_BLOCK];
+        } else if (choice < 8) {
+            name = params[(size_t)rand() % PARAM_COUNT];
+        } else {
+            name = globals[(size_t)rand() % GLOBAL_COUNT];
+        }
+        nodes[i].kind = CN_AST_EXPR_IDENTIFIER;
+        nodes[i].as.identifier.name = name;
+        nodes[i].as.identifier.name_length = strlen(name);
+        node_scopes[i] = blocks[depth];
+    }
+
+    /* 优化前：每个阶段都重新沿作用域链查找 */
+    start = get_time_ms();
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        for (size_t i = 0; i < IDENTIFIER_COUNT; i++) {
+            expected[i] = cn_sem_scope_lookup(node_scopes[i], nodes[i].as.identifier.name,
+                                              nodes[i].as.identifier.name_length);
+        }
+    }
+    plain_ms = get_time_ms() - start;
+
+    /* 优化后：首次查找结果缓存在节点上，之后的阶段直接命中 */
+    start = get_time_ms();
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        for (size_t i = 0; i < IDENTIFIER_COUNT; i++) {
+            CnSemSymbol *symbol = cn_sem_scope_lookup_identifier(node_scopes[i], &nodes[i]);
+            mismatches += symbol == NULL || symbol != expected[i];
+        }
+    }
+    cached_ms = get_time_ms() - start;
+
+    printf("\n=== %zu 次标识符查找 ===\n", lookups);
+    printf("  每次重新查找: %8.1f ns/次 (%8.3f ms)\n", plain_ms * 1000000.0 / (double)lookups, plain_ms);
+    printf("  节点缓存:     %8.1f ns/次 (%8.3f ms)\n", cached_ms * 1000000.0 / (double)lookups, cached_ms);
+    if (cached_ms > 0.0) {
+        printf("  性能提升: %.2fx\n", plain_ms / cached_ms);
+    }
+    if (mismatches > 0) {
+        printf("  结果验证: ✗ %zu 次查找结果不一致\n", mismatches);
+    } else {
+        printf("  结果验证: ✓ 两种查找返回同一符号\n");
+    }
+
+    for (size_t d = BLOCK_DEPTH; d-- > 0;) {
+        cn_sem_scope_free(blocks[d]);
+    }
+    cn_sem_scope_free(function);
+    cn_sem_scope_free(global);
+    free(nodes);
+    free(node_scopes);
+    free(expected);
+    cn_string_pool_release_default();
+
+    printf("\n========================================\n");
+    printf("性能测试完成\n");
+    printf("========================================\n");
+    return mismatches == 0 ? 0 : 1;
+}
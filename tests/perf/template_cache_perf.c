@@ -0,0 +1,274 @@
+/**
+ * @file template_cache_perf.c
+ * @brief 模板实例化缓存性能基准测试
+ *
+ * 模拟泛型容器密集的代码：若干模板各自以多种类型实参实例化，产生数千个实例。
+ * 1. 查找：实例数 1000、4000、16000 时，逐个按 (模板名, 类型实参) 查找全部实例，比较
+ *    优化前的线性扫描（在本文件中模拟）与哈希索引 cn_template_cache_find 的平均耗时（纳秒）
+ * 2. 跨模块：多个模块实例化同一组模板，比较每个模块各用一个缓存与共用进程级缓存时
+ *    实际执行的实例化（类型替换）次数与总耗时
+ *
+ * 同时校验两种查找方式返回同一实例。
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "cnlang/frontend/semantics.h"
+#include "cnlang/semantics/template.h"
+#include "cnlang/support/string_pool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SIZE_COUNT 3
+#define ARGS_PER_TEMPLATE 8
+#define MODULE_COUNT 8
+#define SHARED_TEMPLATE_COUNT 200
+
+static const size_t g_sizes[SIZE_COUNT] = { 1000, 4000, 16000 };
+
+/* ============================================================================
+ * 测试辅助函数
+ * ============================================================================ */
+
+/* 获取当前时间（毫秒） */
+static double get_time_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+/* 第 index 种类型实参：前四种为基本类型，其余为用户结构体（奇数再包一层指针） */
+static CnType *make_arg(size_t index) {
+    static const CnTypeKind kinds[] = { CN_TYPE_INT, CN_TYPE_FLOAT, CN_TYPE_STRING, CN_TYPE_BOOL };
+    char name[32];
+    CnType *type;
+
+    if (index < 4) {
+        return cn_type_new_primitive(kinds[index]);
+    }
+    /* 类型只保存名字指针，名字需驻留以保持有效 */
+    snprintf(name, sizeof(name), "元素%zu", index);
+    type = cn_type_new_struct(cn_string_pool_intern(cn_string_pool_default(), name, strlen(name)),
+                              strlen(name), NULL, 0, NULL, NULL, 0);
+    return index % 2 ? cn_type_new_pointer(type) : type;
+}
+
+/* 优化前的查找（作为基准）：逐个比较模板名与类型实参 */
+static CnTemplateInstance *linear_find(const CnTemplateCache *cache, const char *name,
+                                       size_t name_length, CnType **args, size_t arg_count) {
+    for (size_t i = 0; i < cache->instance_count; i++) {
+        CnTemplateInstance *instance = cache->instances[i];
+        if (cn_name_equals(instance->template_name, instance->template_name_length,
+                           name, name_length) &&
+            cn_type_array_equals(instance->type_args, instance->type_arg_count, args, arg_count)) {
+            return instance;
+        }
+    }
+    return NULL;
+}
+
+typedef struct Request {
+    char name[32];
+    CnType *args[2];
+} Request;
+
+/* 第 index 个实例化请求：模板 容器<index / 8>，类型实参 (整数, 第 index 种) */
+static void make_request(Request *request, size_t index) {
+    snprintf(request->name, sizeof(request->name), "容器%zu", index / ARGS_PER_TEMPLATE);
+    request->args[0] = cn_type_new_primitive(CN_TYPE_INT);
+    request->args[1] = make_arg(index % ARGS_PER_TEMPLATE);
+}
+
+/* ============================================================================
+ * 查找测试
+ * ============================================================================ */
+
+static int run_lookup(size_t count) {
+    CnTemplateCache *cache = cn_template_cache_new();
+    Request *requests = (Request *)calloc(count, sizeof(Request));
+    CnTemplateInstance **expected = (CnTemplateInstance **)calloc(count, sizeof(CnTemplateInstance *));
+    double start;
+    double linear_ms;
+    double hashed_ms;
+    size_t mismatches = 0;
+    int cache_count_ok;
+
+    if (!cache || !requests || !expected) {
+        cn_template_cache_free(cache);
+        free(requests);
+        free(expected);
+        return 0;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        CnTemplateInstance *instance = (CnTemplateInstance *)calloc(1, sizeof(CnTemplateInstance));
+        make_request(&requests[i], i);
+        instance->template_name = requests[i].name;
+        instance->template_name_length = strlen(requests[i].name);
+        instance->type_args = cn_type_array_copy(requests[i].args, 2);
+        instance->type_arg_count = 2;
+        cn_template_cache_add(cache, instance);
+    }
+
+    start = get_time_ms();
+    for (size_t i = 0; i < count; i++) {
+        expected[i] = linear_find(cache, requests[i].name, strlen(requests[i].name),
+                                  requests[i].args, 2);
+    }
+    linear_ms = get_time_ms() - start;
+
+    start = get_time_ms();
+    for (size_t i = 0; i < count; i++) {
+        CnTemplateInstance *found = cn_template_cache_find(cache, NULL, requests[i].name,
+                                                           strlen(requests[i].name),
+                                                           requests[i].args, 2);
+        mismatches += found == NULL || found != expected[i];
+    }
+    hashed_ms = get_time_ms() - start;
+
+    cache_count_ok = cache->instance_count == count;
+    printf("\n=== 实例数 %zu ===\n", cache->instance_count);
+    printf("  线性扫描: %10.1f ns/次\n", linear_ms * 1000000.0 / (double)count);
+    printf("  哈希索引: %10.1f ns/次\n", hashed_ms * 1000000.0 / (double)count);
+    if (hashed_ms > 0.0) {
+        printf("  性能提升: %.2fx\n", linear_ms / hashed_ms);
+    }
+    if (mismatches > 0 || !cache_count_ok) {
+        printf("  结果验证: ✗ %zu 次查找结果不一致\n", mismatches);
+    } else {
+        printf("  结果验证: ✓ 两种查找返回同一实例\n");
+    }
+
+    cn_template_cache_free(cache);
+    free(requests);
+    free(expected);
+    return mismatches == 0 && cache_count_ok;
+}
+
+/* ============================================================================
+ * 跨模块测试
+ * ============================================================================ */
+
+/* 每个模块实例化同一组结构体模板；新建的实例追加到 created（需调用者释放） */
+static void instantiate_module(CnAstTemplateStructDecl *templates, CnTemplateCache *cache,
+                               CnAstStructDecl **created, size_t *created_count) {
+    for (size_t t = 0; t < SHARED_TEMPLATE_COUNT; t++) {
+        for (size_t a = 0; a < ARGS_PER_TEMPLATE; a++) {
+            CnType *args[1] = { make_arg(a) };
+            size_t misses = cache->miss_count;
+            CnAstStructDecl *decl = cn_template_instantiate_struct(&templates[t], args, 1, cache);
+            if (decl && cache->miss_count != misses) {
+                created[(*created_count)++] = decl;
+            }
+        }
+    }
+}
+
+static void free_created(CnAstStructDecl **created, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        free(created[i]->fields);
+        free(created[i]);
+    }
+}
+
+static int run_cross_module(void) {
+    static char names[SHARED_TEMPLATE_COUNT][32];
+    static CnAstStructDecl decls[SHARED_TEMPLATE_COUNT];
+    static CnAstTemplateStructDecl templates[SHARED_TEMPLATE_COUNT];
+    size_t max_created = (size_t)MODULE_COUNT * SHARED_TEMPLATE_COUNT * ARGS_PER_TEMPLATE;
+    CnAstStructDecl **created = (CnAstStructDecl **)calloc(max_created, sizeof(CnAstStructDecl *));
+    CnType *param_type = cn_type_new_struct("T", 1, NULL, 0, NULL, NULL, 0);
+    CnAstStructField fields[2] = {
+        { "值", strlen("值"), param_type, 0 },
+        { "下一个", strlen("下一个"), NULL, 0 },
+    };
+    CnAstTemplateParam param = { "T", 1, NULL, NULL };
+    CnAstTemplateParams params = { &param, 1 };
+    size_t separate_count = 0;
+    size_t shared_count = 0;
+    size_t hits = 0;
+    double start;
+    double separate_ms;
+    double shared_ms;
+    CnTemplateCache *shared;
+
+    if (!created) {
+        return 0;
+    }
+    fields[1].field_type = cn_type_new_pointer(param_type);
+    for (size_t t = 0; t < SHARED_TEMPLATE_COUNT; t++) {
+        snprintf(names[t], sizeof(names[t]), "列表%zu", t);
+        decls[t].name = names[t];
+        decls[t].name_length = strlen(names[t]);
+        decls[t].fields = fields;
+        decls[t].field_count = 2;
+        templates[t].template_params = &params;
+        templates[t].struct_decl = &decls[t];
+    }
+
+    /* 优化前：每个模块各自的缓存，同一实例在每个模块都重新替换 */
+    start = get_time_ms();
+    for (int m = 0; m < MODULE_COUNT; m++) {
+        CnTemplateCache *cache = cn_template_cache_new();
+        instantiate_module(templates, cache, created, &separate_count);
+        cn_template_cache_free(cache);
+    }
+    separate_ms = get_time_ms() - start;
+    free_created(created, separate_count);
+
+    /* 优化后：所有模块共用进程级缓存 */
+    start = get_time_ms();
+    shared = cn_template_cache_default();
+    for (int m = 0; m < MODULE_COUNT; m++) {
+        instantiate_module(templates, shared, created, &shared_count);
+    }
+    shared_ms = get_time_ms() - start;
+    hits = shared->hit_count;
+    free_created(created, shared_count);
+    cn_template_cache_release_default();
+    free(created);
+
+    printf("\n=== %d 个模块实例化同一组模板（%d 个模板 x %d 种类型实参） ===\n",
+           MODULE_COUNT, SHARED_TEMPLATE_COUNT, ARGS_PER_TEMPLATE);
+    printf("  各模块独立缓存: %6zu 次实例化, %8.3f ms\n", separate_count, separate_ms);
+    printf("  共享缓存:       %6zu 次实例化, %8.3f ms（命中 %zu 次）\n", shared_count, shared_ms, hits);
+    if (shared_ms > 0.0) {
+        printf("  性能提升: %.2fx\n", separate_ms / shared_ms);
+    }
+
+    if (shared_count != (size_t)SHARED_TEMPLATE_COUNT * ARGS_PER_TEMPLATE) {
+        printf("  结果验证: ✗ 共享缓存下每个实例应只实例化一次\n");
+        return 0;
+    }
+    printf("  结果验证: ✓ 共享缓存下每个实例只实例化一次\n");
+    return 1;
+}
+
+/* ============================================================================
+ * 主函数
+ * ============================================================================ */
+
+int main(void) {
+    int ok = 1;
+
+    printf("========================================\n");
+    printf("CN语言模板实例化缓存性能测试\n");
+    printf("========================================\n");
+
+    for (int i = 0; i < SIZE_COUNT; i++) {
+        ok = run_lookup(g_sizes[i]) && ok;
+    }
+    ok = run_cross_module() && ok;
+
+    cn_type_context_release_default();
+    cn_string_pool_release_default();
+
+    printf("\n========================================\n");
+    printf("性能测试完成\n");
+    printf("========================================\n");
+    return ok ? 0 : 1;
+}
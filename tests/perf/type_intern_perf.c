@@ -0,0 +1,217 @@
+/**
+ * @file type_intern_perf.c
+ * @brief 类型节点驻留性能基准测试
+ *
+ * 模拟语义分析中对变量、参数与函数签名反复构造并比较类型的过程：
+ * 按声明数 10000、100000、1000000 构造指针、数组与函数类型，并与前一个同形状声明的类型比较，
+ * 统计类型节点数量、内存占用及每次构造与比较的平均耗时（纳秒）：
+ * 1. 优化前：每次构造都 malloc 新节点，按结构递归比较（在本文件中模拟）
+ * 2. 优化后：结构相同的类型共享类型上下文中的同一节点，比较退化为指针比较
+ *
+ * 优化后节点数只与不同类型的数量有关，不随声明数增长，同时校验两种方式比较结果一致。
+ *
+ * @version 1.0
+ * @date 2026-10-17
+ */
+
+#include "cnlang/frontend/semantics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SIZE_COUNT 3
+#define SHAPE_COUNT 4
+
+static const size_t g_sizes[SIZE_COUNT] = { 10000, 100000, 1000000 };
+
+/* ============================================================================
+ * 测试辅助函数
+ * ============================================================================ */
+
+/* 获取当前时间（毫秒） */
+static double get_time_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+/* 优化前的类型节点（作为基准）：每次构造独立分配 */
+typedef struct PlainType {
+    CnTypeKind kind;
+    struct PlainType *inner;
+    struct PlainType **params;
+    size_t count;   // 数组长度或参数个数
+} PlainType;
+
+static size_t g_plain_nodes = 0;
+static size_t g_plain_bytes = 0;
+
+static PlainType *plain_new(CnTypeKind kind, PlainType *inner, size_t count) {
+    PlainType *type = (PlainType *)calloc(1, sizeof(PlainType));
+    if (!type) {
+        return NULL;
+    }
+    type->kind = kind;
+    type->inner = inner;
+    type->count = count;
+    g_plain_nodes++;
+    g_plain_bytes += sizeof(PlainType);
+    return type;
+}
+
+static void plain_free(PlainType *type) {
+    if (!type) {
+        return;
+    }
+    for (size_t i = 0; type->params && i < type->count; i++) {
+        plain_free(type->params[i]);
+    }
+    free(type->params);
+    plain_free(type->inner);
+    free(type);
+}
+
+static int plain_equals(const PlainType *a, const PlainType *b) {
+    if (a == b) return 1;
+    if (!a || !b || a->kind != b->kind || a->count != b->count) return 0;
+    if (!plain_equals(a->inner, b->inner)) return 0;
+    for (size_t i = 0; a->params && i < a->count; i++) {
+        if (!plain_equals(a->params[i], b->params[i])) return 0;
+    }
+    return 1;
+}
+
+/* 第 i 个声明的类型：整数指针、二级字符指针、定长数组或函数签名 */
+static PlainType *plain_decl_type(size_t i) {
+    switch (i % SHAPE_COUNT) {
+        case 0:
+            return plain_new(CN_TYPE_POINTER, plain_new(CN_TYPE_INT, NULL, 0), 0);
+        case 1:
+            return plain_new(CN_TYPE_POINTER, plain_new(CN_TYPE_POINTER, plain_new(CN_TYPE_CHAR, NULL, 0), 0), 0);
+        case 2:
+            return plain_new(CN_TYPE_ARRAY, plain_new(CN_TYPE_INT, NULL, 0), (i / SHAPE_COUNT) % 16);
+        default: {
+            size_t count = (i / SHAPE_COUNT) % 4;
+            PlainType *type = plain_new(CN_TYPE_FUNCTION, plain_new(CN_TYPE_INT, NULL, 0), count);
+            if (type && count > 0) {
+                type->params = (PlainType **)calloc(count, sizeof(PlainType *));
+                g_plain_bytes += count * sizeof(PlainType *);
+                for (size_t p = 0; type->params && p < count; p++) {
+                    type->params[p] = plain_new(CN_TYPE_POINTER, plain_new(CN_TYPE_CHAR, NULL, 0), 0);
+                }
+            }
+            return type;
+        }
+    }
+}
+
+static CnType *interned_decl_type(size_t i) {
+    switch (i % SHAPE_COUNT) {
+        case 0:
+            return cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_INT));
+        case 1:
+            return cn_type_new_pointer(cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_CHAR)));
+        case 2:
+            return cn_type_new_array(cn_type_new_primitive(CN_TYPE_INT), (i / SHAPE_COUNT) % 16);
+        default: {
+            size_t count = (i / SHAPE_COUNT) % 4;
+            CnType *params[4];
+            for (size_t p = 0; p < count; p++) {
+                params[p] = cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_CHAR));
+            }
+            return cn_type_new_function(cn_type_new_primitive(CN_TYPE_INT), params, count);
+        }
+    }
+}
+
+/* 测量一种规模，失败返回 0 */
+static int run_size(size_t count) {
+    PlainType **plain = (PlainType **)malloc(count * sizeof(PlainType *));
+    CnType **interned = (CnType **)malloc(count * sizeof(CnType *));
+    CnTypeContextStats stats;
+    double start;
+    double plain_build_ns;
+    double plain_equal_ns;
+    double intern_build_ns;
+    double intern_equal_ns;
+    size_t plain_matches = 0;
+    size_t intern_matches = 0;
+    int ok = plain && interned;
+
+    if (!ok) {
+        free(plain);
+        free(interned);
+        return 0;
+    }
+
+    g_plain_nodes = 0;
+    g_plain_bytes = 0;
+    start = get_time_ms();
+    for (size_t i = 0; i < count; i++) {
+        plain[i] = plain_decl_type(i);
+    }
+    plain_build_ns = (get_time_ms() - start) * 1000000.0 / (double)count;
+
+    start = get_time_ms();
+    for (size_t i = SHAPE_COUNT; i < count; i++) {
+        plain_matches += (size_t)plain_equals(plain[i], plain[i - SHAPE_COUNT]);
+    }
+    plain_equal_ns = (get_time_ms() - start) * 1000000.0 / (double)count;
+
+    /* 每种规模使用新的类型上下文 */
+    cn_type_context_release_default();
+    start = get_time_ms();
+    for (size_t i = 0; i < count; i++) {
+        interned[i] = interned_decl_type(i);
+        ok = ok && interned[i];
+    }
+    intern_build_ns = (get_time_ms() - start) * 1000000.0 / (double)count;
+
+    start = get_time_ms();
+    for (size_t i = SHAPE_COUNT; i < count; i++) {
+        intern_matches += (size_t)cn_type_equals(interned[i], interned[i - SHAPE_COUNT]);
+    }
+    intern_equal_ns = (get_time_ms() - start) * 1000000.0 / (double)count;
+    cn_type_context_get_stats(cn_type_context_default(), &stats);
+
+    printf("  %8zu %10zu %10zu %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n", count, g_plain_nodes,
+           stats.node_count, (double)g_plain_bytes / 1024.0, (double)(stats.arena_bytes + stats.table_bytes) / 1024.0,
+           plain_build_ns, intern_build_ns, plain_equal_ns, intern_equal_ns);
+
+    for (size_t i = 0; i < count; i++) {
+        plain_free(plain[i]);
+    }
+    free(plain);
+    free(interned);
+
+    if (!ok || plain_matches != intern_matches) {
+        printf("  结果验证: ✗ %zu 个声明的比较结果不一致（%zu / %zu）\n", count, plain_matches, intern_matches);
+        return 0;
+    }
+    return 1;
+}
+
+/* ============================================================================
+ * 主函数
+ * ============================================================================ */
+
+int main(void) {
+    printf("========================================\n");
+    printf("CN语言 类型节点驻留性能测试\n");
+    printf("========================================\n");
+    printf("  %8s %10s %10s %10s %10s %10s %10s %10s %10s\n", "声明数", "原节点数", "驻留节点数", "原内存KB",
+           "驻留内存KB", "原构造ns", "驻留构造ns", "原比较ns", "驻留比较ns");
+
+    for (int i = 0; i < SIZE_COUNT; i++) {
+        if (!run_size(g_sizes[i])) {
+            cn_type_context_release_default();
+            return 1;
+        }
+    }
+    cn_type_context_release_default();
+
+    printf("\n  结果验证: ✓ 驻留类型与逐节点比较结果一致\n");
+    return 0;
+}
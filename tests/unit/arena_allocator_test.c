@@ -213,6 +213,46 @@ static void test_arena_stats(void)
     printf("[PASS] test_arena_stats\n");
 }
 
+// 测试数组扩展与字符串复制
+static void test_arena_realloc_and_strndup(void)
+{
+    CnArena *arena = cn_arena_new(1024);
+    assert(arena != NULL);
+
+    // 最后一次分配原地扩展
+    int *values = (int *)cn_arena_alloc(arena, 4 * sizeof(int));
+    assert(values != NULL);
+    for (int i = 0; i < 4; i++) {
+        values[i] = i;
+    }
+    int *grown = (int *)cn_arena_realloc(arena, values, 4 * sizeof(int), 8 * sizeof(int));
+    assert(grown == values);
+
+    // 中间插入其他分配后，扩展需要复制
+    void *other = cn_arena_alloc(arena, 16);
+    assert(other != NULL);
+    int *moved = (int *)cn_arena_realloc(arena, grown, 8 * sizeof(int), 64 * sizeof(int));
+    assert(moved != NULL && moved != grown);
+    for (int i = 0; i < 4; i++) {
+        assert(moved[i] == i);
+    }
+
+    // 超过块大小的扩展落入专用块，当前块继续可用
+    int *large = (int *)cn_arena_realloc(arena, moved, 64 * sizeof(int), 1024 * sizeof(int));
+    assert(large != NULL);
+    assert(large[3] == 3);
+    char *small = (char *)cn_arena_alloc(arena, 8);
+    assert(small != NULL);
+
+    char *copy = cn_arena_strndup(arena, "函数abc", 6);
+    assert(copy != NULL);
+    assert(strcmp(copy, "函数") == 0);
+    assert(cn_arena_strndup(arena, NULL, 0) == NULL);
+
+    cn_arena_free(arena);
+    printf("[PASS] test_arena_realloc_and_strndup\n");
+}
+
 int main(void)
 {
     printf("运行 Arena 分配器单元测试...\n\n");
@@ -225,6 +265,7 @@ int main(void)
     test_arena_macros();
     test_arena_edge_cases();
     test_arena_stats();
+    test_arena_realloc_and_strndup();
 
     printf("\n所有测试通过！\n");
     return 0;
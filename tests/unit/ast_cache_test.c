@@ -0,0 +1,211 @@
+#include "cnlang/frontend/lexer.h"
+#include "cnlang/frontend/parser.h"
+#include "cnlang/frontend/ast.h"
+#include "cnlang/frontend/ast_cache.h"
+#include "test_support.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * 二进制 AST 缓存测试
+ *
+ * 往返：解析 -> 序列化 -> 反序列化 -> 再序列化，两份映像逐字节相同即说明
+ * 重建的树与原树结构一致（包括共享节点）；另外抽查名字驻留与源位置。
+ * 校验：键/长度不匹配、截断、逐字节破坏的映像都不能导致崩溃，文件头破坏必须拒绝。
+ */
+
+// ============================================================================
+// 测试统计
+// ============================================================================
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static const char *g_source =
+    "导入 数学;\n"
+    "从 工具.文本 导入 { 拼接, 长度 };\n"
+    "结构体 点 { 整数 x; 整数 y; }\n"
+    "枚举 颜色 { 红, 绿 = 5, 蓝 }\n"
+    "常量 整数 上限 = 100;\n"
+    "模板<T> 函数 最大(T a, T b) { 返回 a > b ? a : b; }\n"
+    "模板<T> 结构体 盒子 { T 值; }\n"
+    "函数 计算(整数 n, 常量 小数 比例) -> 整数 {\n"
+    "    变量 总和 = 0;\n"
+    "    变量 数据 = [1, 2, 3, n * 2];\n"
+    "    变量 p = 点 { x: 1, y: 2 };\n"
+    "    循环 (变量 i = 0; i < n; i++) {\n"
+    "        如果 (i % 2 == 0 && !(i > 10)) { 总和 = 总和 + 数据[i % 4]; } 否则 { 继续; }\n"
+    "    }\n"
+    "    当 (总和 > 上限) { 总和 = 总和 >> 1; 中断; }\n"
+    "    选择 (n) { 情况 1: 总和 = -总和; 中断; 默认: 总和 = ~总和; }\n"
+    "    尝试 { 抛出 \"错误\" \"消息\"; } 捕获 (错误 e) { 打印(\"捕获\"); } 最终 { p.x = 3.5; }\n"
+    "    返回 总和 + 'a' + 真;\n"
+    "}\n";
+
+static CnAstProgram *parse(const char *source)
+{
+    CnLexer lexer;
+    CnParser *parser;
+    CnAstProgram *program = NULL;
+
+    cn_frontend_lexer_init(&lexer, source, strlen(source), "<memory>");
+    parser = cn_frontend_parser_new(&lexer);
+    if (!parser) {
+        return NULL;
+    }
+    if (!cn_frontend_parse_program(parser, &program)) {
+        cn_frontend_ast_program_free(program);
+        program = NULL;
+    }
+    cn_frontend_parser_free(parser);
+    return program;
+}
+
+static void test_round_trip(void)
+{
+    printf("测试：序列化往返与映像校验\n");
+
+    size_t length = strlen(g_source);
+    uint64_t key = cn_ast_cache_key(g_source, length);
+    CnAstProgram *program = parse(g_source);
+    CnAstProgram *loaded;
+    const CnAstFunctionDecl *fn;
+    void *image;
+    void *again;
+    size_t image_size = 0;
+    size_t again_size = 0;
+    bool same_image;
+    bool locations_ok = true;
+    bool header_rejected = true;
+    unsigned char *corrupt;
+
+    TEST_ASSERT(program != NULL, "解析失败");
+    TEST_ASSERT(program->function_count == 1 && program->struct_count == 1 && program->enum_count == 1 &&
+                program->import_count == 2 && program->global_var_count == 1 &&
+                program->template_func_count == 1 && program->template_struct_count == 1,
+                "测试源码未覆盖全部顶层声明");
+
+    image = cn_ast_cache_serialize(program, key, length, &image_size);
+    TEST_ASSERT(image != NULL && image_size > 0, "序列化失败");
+
+    loaded = cn_ast_cache_deserialize(image, image_size, key, length, "<cache>");
+    TEST_ASSERT(loaded != NULL, "反序列化失败");
+    fn = loaded->functions[0];
+
+    again = cn_ast_cache_serialize(loaded, key, length, &again_size);
+    same_image = again != NULL && again_size == image_size && memcmp(again, image, image_size) == 0;
+    free(again);
+    TEST_ASSERT(same_image, "重建的 AST 再序列化结果与原映像不一致");
+
+    // 名字驻留在同一个全局字符串池中，指针与解析器产出的相同
+    TEST_ASSERT(fn->name == program->functions[0]->name, "函数名未驻留到全局字符串池");
+    TEST_ASSERT(fn->parameter_count == 2 && fn->parameters[1].is_const, "参数丢失");
+    TEST_ASSERT(fn->body && fn->body->stmt_count == program->functions[0]->body->stmt_count, "函数体语句数不一致");
+    for (size_t i = 0; i < fn->body->stmt_count; i++) {
+        const CnSourceLocation *expected = &program->functions[0]->body->stmts[i]->loc;
+        const CnSourceLocation *actual = &fn->body->stmts[i]->loc;
+        locations_ok = locations_ok &&
+                       (expected->filename == NULL) == (actual->filename == NULL) &&
+                       (!actual->filename || strcmp(actual->filename, "<cache>") == 0) &&
+                       actual->line == expected->line && actual->column == expected->column;
+    }
+    TEST_ASSERT(locations_ok, "源位置不一致");
+    TEST_ASSERT(loaded->arena != NULL, "重建的程序应使用 Arena");
+    cn_frontend_ast_program_free(loaded);
+
+    // 键或源码长度不匹配时拒绝
+    TEST_ASSERT(cn_ast_cache_deserialize(image, image_size, key + 1, length, "<cache>") == NULL, "键不匹配未被拒绝");
+    TEST_ASSERT(cn_ast_cache_deserialize(image, image_size, key, length + 1, "<cache>") == NULL, "长度不匹配未被拒绝");
+    TEST_ASSERT(cn_ast_cache_deserialize(image, image_size - 1, key, length, "<cache>") == NULL, "截断映像未被拒绝");
+    TEST_ASSERT(cn_ast_cache_deserialize(image, 16, key, length, "<cache>") == NULL, "过短映像未被拒绝");
+
+    // 逐字节破坏：不得崩溃；文件头破坏（魔数/版本）必须拒绝
+    corrupt = (unsigned char *)malloc(image_size);
+    TEST_ASSERT(corrupt != NULL, "内存不足");
+    for (size_t i = 0; i < image_size; i++) {
+        CnAstProgram *result;
+        memcpy(corrupt, image, image_size);
+        corrupt[i] ^= 0x5A;
+        result = cn_ast_cache_deserialize(corrupt, image_size, key, length, "<cache>");
+        if (i < 12 && result != NULL) {
+            header_rejected = false;
+        }
+        cn_frontend_ast_program_free(result);
+    }
+    free(corrupt);
+    TEST_ASSERT(header_rejected, "文件头破坏未被拒绝");
+
+    free(image);
+    cn_frontend_ast_program_free(program);
+    TEST_PASS("序列化往返与映像校验");
+}
+
+static void test_class_not_cached(void)
+{
+    printf("测试：包含类声明的程序不缓存\n");
+
+    const char *source = "类 计数器 { 公开: 整数 值; }\n函数 主() { 返回 0; }\n";
+    CnAstProgram *program = parse(source);
+    size_t image_size = 0;
+    void *image;
+
+    if (!program || program->class_count == 0) {
+        cn_frontend_ast_program_free(program);
+        TEST_PASS("类语法不可用，跳过");
+        return;
+    }
+    image = cn_ast_cache_serialize(program, cn_ast_cache_key(source, strlen(source)), strlen(source),
+                                   &image_size);
+    free(image);
+    cn_frontend_ast_program_free(program);
+    TEST_ASSERT(image == NULL, "包含类声明的程序不应被缓存");
+    TEST_PASS("包含类声明的程序不缓存");
+}
+
+static void test_directory_cache(void)
+{
+    printf("测试：缓存目录读写\n");
+
+    const char *changed = "函数 主() { 返回 1; }\n";
+    size_t length = strlen(g_source);
+    CnAstProgram *program = parse(g_source);
+    CnAstProgram *loaded;
+    bool hit;
+
+    TEST_ASSERT(program != NULL, "解析失败");
+    TEST_ASSERT(cn_ast_cache_load(g_source, length, "<cache>") == NULL, "未启用缓存时不应命中");
+    TEST_ASSERT(cn_ast_cache_set_directory("ast_cache_test_dir"), "设置缓存目录失败");
+
+    TEST_ASSERT(cn_ast_cache_store(g_source, length, program), "写入缓存失败");
+    loaded = cn_ast_cache_load(g_source, length, "<cache>");
+    hit = loaded != NULL && loaded->function_count == 1;
+    cn_frontend_ast_program_free(loaded);
+    TEST_ASSERT(hit, "缓存未命中");
+
+    // 源码变化后键不同，不会命中旧缓存
+    TEST_ASSERT(cn_ast_cache_load(changed, strlen(changed), "<cache>") == NULL, "源码变化后仍命中缓存");
+
+    cn_ast_cache_set_directory(NULL);
+    TEST_ASSERT(cn_ast_cache_get_directory() == NULL, "关闭缓存失败");
+    cn_frontend_ast_program_free(program);
+    TEST_PASS("缓存目录读写");
+}
+
+int main(void)
+{
+    printf("========================================\n");
+    printf("二进制 AST 缓存测试\n");
+    printf("========================================\n\n");
+
+    test_round_trip();
+    test_class_not_cached();
+    test_directory_cache();
+
+    printf("\n========================================\n");
+    printf("测试结果: %d 通过, %d 失败\n", tests_passed, tests_failed);
+    printf("========================================\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,116 @@
+#include "cnlang/frontend/lexer.h"
+#include "cnlang/frontend/parser.h"
+#include "cnlang/frontend/ast.h"
+#include "cnlang/support/memory/arena.h"
+#include "test_support.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * 按种类分配节点测试
+ *
+ * 每种节点的分配大小介于公共头部与完整节点之间；解析器按种类分配，
+ * 表达式每多一项在 Arena 中增加的字节数不超过对应种类节点大小之和。
+ */
+
+// ============================================================================
+// 测试统计
+// ============================================================================
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static void test_node_sizes(void)
+{
+    printf("测试：各种类节点的分配大小\n");
+
+    bool sizes_ok = true;
+    for (int kind = CN_AST_EXPR_BINARY; kind <= CN_AST_EXPR_CAST; kind++) {
+        size_t size = cn_frontend_ast_expr_node_size((CnAstExprKind)kind);
+        sizes_ok = sizes_ok && size > offsetof(CnAstExpr, as) && size <= sizeof(CnAstExpr);
+    }
+    TEST_ASSERT(sizes_ok, "表达式节点大小越界");
+    for (int kind = CN_AST_STMT_BLOCK; kind <= CN_AST_STMT_TEMPLATE_STRUCT_DECL; kind++) {
+        size_t size = cn_frontend_ast_stmt_node_size((CnAstStmtKind)kind);
+        sizes_ok = sizes_ok && size >= offsetof(CnAstStmt, as) && size <= sizeof(CnAstStmt);
+    }
+    TEST_ASSERT(sizes_ok, "语句节点大小越界");
+
+    // 最常见的节点明显小于完整节点（标识符节点另带名字查找缓存）
+    TEST_ASSERT(cn_frontend_ast_expr_node_size(CN_AST_EXPR_IDENTIFIER) ==
+                offsetof(CnAstExpr, as) + sizeof(CnAstIdentifierExpr), "标识符节点未压缩");
+    TEST_ASSERT(cn_frontend_ast_expr_node_size(CN_AST_EXPR_IDENTIFIER) * 5 <= sizeof(CnAstExpr) * 4, "标识符节点未压缩");
+    TEST_ASSERT(cn_frontend_ast_expr_node_size(CN_AST_EXPR_INTEGER_LITERAL) * 2 <= sizeof(CnAstExpr), "整数字面量节点未压缩");
+    TEST_ASSERT(cn_frontend_ast_stmt_node_size(CN_AST_STMT_EXPR) * 2 <= sizeof(CnAstStmt), "表达式语句节点未压缩");
+    TEST_ASSERT(cn_frontend_ast_stmt_node_size(CN_AST_STMT_BREAK) == offsetof(CnAstStmt, as), "中断语句不应包含联合体");
+
+    TEST_PASS("各种类节点的分配大小");
+}
+
+// 解析 "返回 a + a + ... ;"（terms 项），返回程序 Arena 的用量
+static size_t arena_used_for_sum(size_t terms)
+{
+    size_t capacity = terms * 4 + 64;
+    char *source = (char *)malloc(capacity);
+    size_t length = 0;
+    CnLexer lexer;
+    CnParser *parser;
+    CnAstProgram *program = NULL;
+    size_t used = 0;
+
+    if (!source) {
+        return 0;
+    }
+    length += (size_t)snprintf(source + length, capacity - length, "函数 f(整数 a) -> 整数 { 返回 a");
+    for (size_t i = 1; i < terms; i++) {
+        length += (size_t)snprintf(source + length, capacity - length, "+a");
+    }
+    snprintf(source + length, capacity - length, "; }\n");
+
+    cn_frontend_lexer_init(&lexer, source, strlen(source), "<size>");
+    parser = cn_frontend_parser_new(&lexer);
+    if (parser && cn_frontend_parse_program(parser, &program) && program && program->arena) {
+        cn_arena_get_stats(program->arena, &used, NULL);
+    }
+    cn_frontend_parser_free(parser);
+    cn_frontend_ast_program_free(program);
+    free(source);
+    return used;
+}
+
+static void test_parser_allocation(void)
+{
+    size_t small = arena_used_for_sum(1);
+    size_t large = arena_used_for_sum(1001);
+    size_t per_term = cn_frontend_ast_expr_node_size(CN_AST_EXPR_BINARY) +
+                      cn_frontend_ast_expr_node_size(CN_AST_EXPR_IDENTIFIER);
+
+    printf("测试：解析器按种类分配节点\n");
+
+    TEST_ASSERT(small > 0 && large > small, "解析失败");
+    // 每一项新增一个二元表达式与一个标识符，另留对齐余量
+    TEST_ASSERT(large - small <= 1000 * (per_term + 16), "解析器未按种类分配节点");
+    TEST_ASSERT(large - small < 1000 * sizeof(CnAstExpr) * 2, "节点占用未减少");
+
+    TEST_PASS("解析器按种类分配节点");
+}
+
+int main(void)
+{
+    printf("========================================\n");
+    printf("按种类分配节点测试\n");
+    printf("========================================\n\n");
+
+    test_node_sizes();
+    test_parser_allocation();
+
+    printf("\n========================================\n");
+    printf("测试结果: %d 通过, %d 失败\n", tests_passed, tests_failed);
+    printf("========================================\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
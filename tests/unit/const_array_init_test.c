@@ -0,0 +1,247 @@
+#include "cnlang/frontend/semantics.h"
+#include "cnlang/support/diagnostics.h"
+#include "test_support.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * 常量数组初始化测试
+ *
+ * 元素全部为常量字面量的数组初始化列表在 IR 中打包为常量数组：
+ * 全局数组输出为带初始化器的 C 数组，局部数组从文件作用域只读表整体复制，
+ * 都不再逐元素生成存储指令；含非常量元素时保持原有处理方式。
+ */
+
+#define TABLE_SIZE 100000
+
+#define OUTPUT_PATH "const_array_init_test_out.c"
+#define SOURCE_NAME "<const_array>"
+
+// ============================================================================
+// 测试统计
+// ============================================================================
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static size_t count_instructions(CnIrModule *ir_module, CnIrInstKind kind)
+{
+    size_t count = 0;
+
+    for (CnIrFunction *func = ir_module->first_func; func; func = func->next) {
+        for (CnIrBasicBlock *block = func->first_block; block; block = block->next) {
+            for (CnIrInst *inst = block->first_inst; inst; inst = inst->next) {
+                if (inst->kind == kind) {
+                    count++;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+// 第 i 个元素：正负交替，覆盖取负的字面量
+static long long table_value(size_t i)
+{
+    return (i % 2 == 0) ? (long long)(i * 3) : -(long long)(i * 3);
+}
+
+static char *make_table_source(size_t count)
+{
+    size_t capacity = count * 24 + 256;
+    size_t length = 0;
+    char *text = (char *)malloc(capacity);
+
+    if (!text) {
+        return NULL;
+    }
+    length += (size_t)snprintf(text + length, capacity - length, "整数 表[%zu] = {", count);
+    for (size_t i = 0; i < count; i++) {
+        length += (size_t)snprintf(text + length, capacity - length, "%s%lld", i ? ", " : "", table_value(i));
+    }
+    snprintf(text + length, capacity - length, "};\n函数 主程序() -> 整数 {\n    返回 表[1];\n}\n");
+    return text;
+}
+
+
+static void test_global_int_table(void)
+{
+    printf("测试：大型全局常量表\n");
+
+    char *source = make_table_source(TABLE_SIZE);
+    TEST_ASSERT(source != NULL, "内存不足");
+
+    CnTestCompilation compiled;
+    cn_test_compile(&compiled, source, SOURCE_NAME);
+    TEST_ASSERT(compiled.ir_module != NULL, "大型常量表编译失败");
+
+    CnIrGlobalVar *global = cn_test_find_global(compiled.ir_module, "表");
+    TEST_ASSERT(global && global->initializer.kind == CN_IR_OP_CONST_ARRAY, "全局常量表未打包为常量数组");
+    CnIrConstArray *array = global->initializer.as.const_array;
+    bool values_ok = array->element_count == TABLE_SIZE && array->field_count == 0;
+    for (size_t i = 0; values_ok && i < TABLE_SIZE; i++) {
+        values_ok = array->values[i].kind == CN_IR_CONST_INT && array->values[i].as.i == table_value(i);
+    }
+    TEST_ASSERT(values_ok, "常量数组中的值不正确");
+    TEST_ASSERT(array->emit_table == 0, "全局数组不需要只读表");
+    TEST_ASSERT(count_instructions(compiled.ir_module, CN_IR_INST_CALL) == 0, "全局常量表生成了初始化调用");
+
+    char *c_code = cn_test_generate_c(compiled.ir_module, OUTPUT_PATH);
+    TEST_ASSERT(c_code != NULL, "C 代码生成失败");
+    TEST_ASSERT(strstr(c_code, "long long cn_var_表[100000] = {") != NULL, "缺少全局数组初始化器");
+    TEST_ASSERT(strstr(c_code, "-299997") != NULL, "初始化器中缺少最后一个元素");
+    TEST_ASSERT(strstr(c_code, "cn_rt_array_set_element") == NULL, "生成了逐元素初始化代码");
+
+    free(c_code);
+    cn_test_compilation_free(&compiled);
+    free(source);
+    TEST_PASS("大型全局常量表");
+}
+
+static void test_struct_array(void)
+{
+    printf("测试：结构体常量数组\n");
+
+    const char *source =
+        "结构体 点 {\n"
+        "    整数 x;\n"
+        "    整数 y;\n"
+        "    字符串 名;\n"
+        "};\n"
+        "点 命名点[3] = { {x: 1, y: -2, 名: \"甲\\n\"}, {x: 3, y: 4, 名: \"乙\"} };\n"
+        "点 位置点[2] = { {5, 6, \"丙\"}, 点 {7, 8, \"丁\"} };\n"
+        "函数 主程序() -> 整数 {\n"
+        "    返回 命名点[1].y + 位置点[0].x;\n"
+        "}\n";
+    CnTestCompilation compiled;
+
+    cn_test_compile(&compiled, source, SOURCE_NAME);
+    TEST_ASSERT(compiled.ir_module != NULL, "结构体数组编译失败");
+
+    CnIrGlobalVar *named = cn_test_find_global(compiled.ir_module, "命名点");
+    CnIrGlobalVar *positional = cn_test_find_global(compiled.ir_module, "位置点");
+    TEST_ASSERT(named && named->initializer.kind == CN_IR_OP_CONST_ARRAY, "按名初始化的结构体数组未打包");
+    TEST_ASSERT(positional && positional->initializer.kind == CN_IR_OP_CONST_ARRAY, "按位置初始化的结构体数组未打包");
+
+    CnIrConstArray *array = named->initializer.as.const_array;
+    TEST_ASSERT(array->element_count == 2 && array->field_count == 3, "结构体常量数组的形状不正确");
+    TEST_ASSERT(array->field_names && strcmp(array->field_names[1], "y") == 0, "字段名不正确");
+    TEST_ASSERT(array->values[1].as.i == -2 && array->values[3].as.i == 3, "结构体字段值不正确");
+    TEST_ASSERT(array->values[2].kind == CN_IR_CONST_STR && strcmp(array->values[2].as.s, "甲\n") == 0,
+                "字符串字段值不正确");
+    TEST_ASSERT(positional->initializer.as.const_array->field_names == NULL, "按位置初始化不应记录字段名");
+
+    char *c_code = cn_test_generate_c(compiled.ir_module, OUTPUT_PATH);
+    TEST_ASSERT(c_code != NULL, "C 代码生成失败");
+    TEST_ASSERT(strstr(c_code, "struct 点 cn_var_命名点[3] = {") != NULL, "缺少结构体数组初始化器");
+    TEST_ASSERT(strstr(c_code, "{.x = 1, .y = -2, .名 = \"甲\\n\"}") != NULL, "按名初始化的元素输出不正确");
+    TEST_ASSERT(strstr(c_code, "{5, 6, \"丙\"}, {7, 8, \"丁\"}") != NULL, "按位置初始化的元素输出不正确");
+
+    free(c_code);
+    cn_test_compilation_free(&compiled);
+    TEST_PASS("结构体常量数组");
+}
+
+static void test_local_and_static_arrays(void)
+{
+    printf("测试：局部与静态常量数组\n");
+
+    const char *source =
+        "函数 主程序() -> 整数 {\n"
+        "    整数 局部[4] = {7, 8, -9};\n"
+        "    小数 比例[2] = {0.5, -1.25};\n"
+        "    静态 整数 计数[2] = {5, 6};\n"
+        "    返回 局部[1];\n"
+        "}\n";
+    CnTestCompilation compiled;
+
+    cn_test_compile(&compiled, source, SOURCE_NAME);
+    TEST_ASSERT(compiled.ir_module != NULL, "局部常量数组编译失败");
+    TEST_ASSERT(compiled.ir_module->const_array_count == 3, "常量数组个数不正确");
+    TEST_ASSERT(compiled.ir_module->first_func->first_static_var &&
+                compiled.ir_module->first_func->first_static_var->initializer.kind == CN_IR_OP_CONST_ARRAY,
+                "静态数组未打包");
+
+    char *c_code = cn_test_generate_c(compiled.ir_module, OUTPUT_PATH);
+    TEST_ASSERT(c_code != NULL, "C 代码生成失败");
+    TEST_ASSERT(strstr(c_code, "static long long const cn_const_0[3] = {") != NULL, "缺少局部数组只读表");
+    TEST_ASSERT(strstr(c_code, "static double const cn_const_1[2] = {") != NULL, "缺少浮点数组只读表");
+    TEST_ASSERT(strstr(c_code, "cn_rt_mem_copy(cn_var_局部, cn_const_0, sizeof(cn_const_0));") != NULL,
+                "局部数组未从只读表复制");
+    TEST_ASSERT(strstr(c_code, "0.5, -1.25") != NULL, "浮点值输出不正确");
+    TEST_ASSERT(strstr(c_code, "static long long cn_static_主程序_计数[2] = {") != NULL, "静态数组缺少初始化器");
+    TEST_ASSERT(strstr(c_code, "cn_rt_array_set_element") == NULL, "生成了逐元素初始化代码");
+
+    free(c_code);
+    cn_test_compilation_free(&compiled);
+    TEST_PASS("局部与静态常量数组");
+}
+
+static void test_non_constant_initializers(void)
+{
+    printf("测试：含非常量元素的初始化列表\n");
+
+    CnTestCompilation compiled;
+    CnIrGlobalVar *global;
+
+    // 含非常量元素、元素多于声明长度时不打包
+    cn_test_compile(&compiled,
+                    "整数 基数 = 1;\n"
+                    "整数 混合[2] = {基数, 2};\n"
+                    "整数 超长[2] = {1, 2, 3};\n"
+                    "函数 主程序() -> 整数 {\n"
+                    "    返回 0;\n"
+                    "}\n",
+                    SOURCE_NAME);
+    TEST_ASSERT(compiled.ir_module != NULL, "含非常量元素的数组编译失败");
+    global = cn_test_find_global(compiled.ir_module, "混合");
+    TEST_ASSERT(global && global->initializer.kind != CN_IR_OP_CONST_ARRAY, "含非常量元素的数组不应打包");
+    global = cn_test_find_global(compiled.ir_module, "超长");
+    TEST_ASSERT(global && global->initializer.kind != CN_IR_OP_CONST_ARRAY, "元素多于声明长度的数组不应打包");
+    TEST_ASSERT(compiled.ir_module->const_array_count == 0, "不应生成常量数组");
+    cn_test_compilation_free(&compiled);
+
+    // 常量与静态数组：全常量初始化列表是编译时常量，含函数调用时不是
+    cn_test_compile(&compiled,
+                    "常量 整数 表[3] = {1, 2, 3};\n"
+                    "函数 主程序() -> 整数 {\n"
+                    "    返回 表[0];\n"
+                    "}\n",
+                    SOURCE_NAME);
+    TEST_ASSERT(compiled.ir_module != NULL && cn_support_diagnostics_error_count(&compiled.diagnostics) == 0,
+                "全常量初始化的常量数组应通过检查");
+    cn_test_compilation_free(&compiled);
+
+    cn_test_compile(&compiled,
+                    "函数 取值() -> 整数 { 返回 1; }\n"
+                    "函数 主程序() -> 整数 {\n"
+                    "    静态 整数 表[2] = {取值(), 2};\n"
+                    "    返回 0;\n"
+                    "}\n",
+                    SOURCE_NAME);
+    TEST_ASSERT(cn_test_has_diagnostic(&compiled.diagnostics, CN_DIAG_CODE_SEM_STATIC_NON_CONST_INIT),
+                "含函数调用的静态数组初始化应报告错误");
+    cn_test_compilation_free(&compiled);
+
+    TEST_PASS("含非常量元素的初始化列表");
+}
+
+int main(void)
+{
+    printf("========================================\n");
+    printf("常量数组初始化测试\n");
+    printf("========================================\n\n");
+
+    test_global_int_table();
+    test_struct_array();
+    test_local_and_static_arrays();
+    test_non_constant_initializers();
+
+    printf("\n========================================\n");
+    printf("测试结果: %d 通过, %d 失败\n", tests_passed, tests_failed);
+    printf("========================================\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,174 @@
+#include "cnlang/frontend/semantics.h"
+#include "cnlang/support/diagnostics.h"
+#include "cnlang/support/source_manager.h"
+#include "test_support.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * 编译时资源嵌入测试
+ *
+ * 全局字符数组的初始值 嵌入("路径") 在语义分析时读入文件内容（不经词法/语法分析），
+ * 省略长度的数组取文件大小；IR 中为引用文件内容的字节常量数组，
+ * C 代码中输出为字符串字面量初始化器（超过 65535 字节时输出为字符常量列表）。
+ * 找不到文件、目标不是全局字符数组或数组过短时报告错误。
+ */
+
+#define BLOB_PATH "embed_resource_test_blob.bin"
+#define TEXT_PATH "embed_resource_test_text.txt"
+#define OUTPUT_PATH "embed_resource_test_out.c"
+#define SOURCE_NAME "embed_resource_test.cn"
+#define BLOB_SIZE 1000
+#define LARGE_PATH "embed_resource_test_large.bin"
+#define LARGE_SIZE 70000
+
+// ============================================================================
+// 测试统计
+// ============================================================================
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static unsigned char blob_byte(size_t i)
+{
+    return (unsigned char)((i * 7u) & 0xFF);
+}
+
+static void test_embed_global_arrays(void)
+{
+    printf("测试：全局字符数组嵌入资源\n");
+
+    const char *source =
+        "字符 数据[] = 嵌入(\"" BLOB_PATH "\");\n"
+        "常量 字符 文本[16] = 嵌入(\"" TEXT_PATH "\");\n"
+        "函数 主程序() -> 整数 {\n"
+        "    返回 数据[1] + 文本[0];\n"
+        "}\n";
+    CnTestCompilation compiled;
+
+    cn_test_compile(&compiled, source, SOURCE_NAME);
+    TEST_ASSERT(compiled.ir_module != NULL, "嵌入资源的程序编译失败");
+
+    CnIrGlobalVar *global = cn_test_find_global(compiled.ir_module, "数据");
+    TEST_ASSERT(global && global->initializer.kind == CN_IR_OP_CONST_ARRAY, "嵌入资源未生成常量数组");
+    CnIrConstArray *array = global->initializer.as.const_array;
+    bool bytes_ok = array->bytes != NULL && array->values == NULL && array->element_count == BLOB_SIZE;
+    for (size_t i = 0; bytes_ok && i < BLOB_SIZE; i++) {
+        bytes_ok = array->bytes[i] == blob_byte(i);
+    }
+    TEST_ASSERT(bytes_ok, "字节常量数组的内容不正确");
+    TEST_ASSERT(global->type && global->type->kind == CN_TYPE_ARRAY && global->type->as.array.length == BLOB_SIZE,
+                "省略长度的数组未取文件大小");
+
+    char *c_code = cn_test_generate_c(compiled.ir_module, OUTPUT_PATH);
+    TEST_ASSERT(c_code != NULL, "C 代码生成失败");
+    TEST_ASSERT(strstr(c_code, "cn_var_数据[1000] = ") != NULL, "缺少嵌入数组的初始化器");
+    TEST_ASSERT(strstr(c_code, "\"\\000\\007\\016\\025") != NULL, "不可打印字节未按八进制转义");
+    TEST_ASSERT(strstr(c_code, "cn_var_文本[16] = ") != NULL, "缺少声明长度的嵌入数组");
+    TEST_ASSERT(strstr(c_code, "\"a\\077\\042\\134b\\012\"") != NULL, "特殊字符转义不正确");
+    TEST_ASSERT(strstr(c_code, "cn_rt_array_set_element") == NULL, "生成了逐元素初始化代码");
+
+    free(c_code);
+    cn_test_compilation_free(&compiled);
+    TEST_PASS("全局字符数组嵌入资源");
+}
+
+// 超过 MSVC 字符串字面量上限（65535 字节）的资源改用初始化列表
+static void test_embed_large_resource(void)
+{
+    printf("测试：超过字符串字面量上限的资源\n");
+
+    const char *prefix = "cn_var_大块[70000] = {";
+    CnTestCompilation compiled;
+
+    cn_test_compile(&compiled, "常量 字符 大块[] = 嵌入(\"" LARGE_PATH "\");\n", SOURCE_NAME);
+    TEST_ASSERT(compiled.ir_module != NULL, "大资源的程序编译失败");
+
+    char *c_code = cn_test_generate_c(compiled.ir_module, OUTPUT_PATH);
+    TEST_ASSERT(c_code != NULL, "C 代码生成失败");
+    const char *initializer = strstr(c_code, prefix);
+    TEST_ASSERT(initializer != NULL, "大资源未输出为初始化列表");
+    const char *end = strchr(initializer, '}');
+    TEST_ASSERT(strncmp(initializer + strlen(prefix), "\n'\\000','\\007','\\016',", 22) == 0,
+                "初始化列表的字节不正确");
+    TEST_ASSERT(end != NULL && memchr(initializer, '"', (size_t)(end - initializer)) == NULL,
+                "大资源仍输出了字符串字面量");
+    TEST_ASSERT(strncmp(end - 7, "'\\011'\n}", 8) == 0, "初始化列表末尾的字节不正确");
+
+    free(c_code);
+    cn_test_compilation_free(&compiled);
+    TEST_PASS("超过字符串字面量上限的资源");
+}
+
+static void test_embed_errors(void)
+{
+    printf("测试：嵌入资源的错误诊断\n");
+
+    CnTestCompilation compiled;
+    bool reported;
+
+    cn_test_compile(&compiled, "字符 缺失[] = 嵌入(\"embed_resource_test_missing.bin\");\n", SOURCE_NAME);
+    reported = cn_test_has_diagnostic(&compiled.diagnostics, CN_DIAG_CODE_SEM_EMBED_NOT_FOUND);
+    cn_test_compilation_free(&compiled);
+    TEST_ASSERT(reported, "找不到资源文件时未报告错误");
+
+    cn_test_compile(&compiled, "整数 错型[] = 嵌入(\"" TEXT_PATH "\");\n", SOURCE_NAME);
+    reported = cn_test_has_diagnostic(&compiled.diagnostics, CN_DIAG_CODE_SEM_EMBED_INVALID_TARGET);
+    cn_test_compilation_free(&compiled);
+    TEST_ASSERT(reported, "非字符数组嵌入资源时未报告错误");
+
+    cn_test_compile(&compiled, "字符 太短[2] = 嵌入(\"" TEXT_PATH "\");\n", SOURCE_NAME);
+    reported = cn_test_has_diagnostic(&compiled.diagnostics, CN_DIAG_CODE_SEM_EMBED_INVALID_TARGET);
+    cn_test_compilation_free(&compiled);
+    TEST_ASSERT(reported, "数组短于资源时未报告错误");
+
+    cn_test_compile(&compiled,
+                    "函数 主程序() -> 整数 {\n"
+                    "    字符 局部[] = 嵌入(\"" TEXT_PATH "\");\n"
+                    "    返回 0;\n"
+                    "}\n",
+                    SOURCE_NAME);
+    reported = cn_test_has_diagnostic(&compiled.diagnostics, CN_DIAG_CODE_SEM_EMBED_INVALID_TARGET);
+    cn_test_compilation_free(&compiled);
+    TEST_ASSERT(reported, "局部变量嵌入资源时未报告错误");
+
+    TEST_PASS("嵌入资源的错误诊断");
+}
+
+int main(void)
+{
+    static const unsigned char text[] = "a?\"\\b\n";
+    static unsigned char blob[LARGE_SIZE];
+
+    printf("========================================\n");
+    printf("编译时资源嵌入测试\n");
+    printf("========================================\n\n");
+
+    // 资源文件相对当前目录查找（源文件名不含目录）
+    for (size_t i = 0; i < LARGE_SIZE; i++) {
+        blob[i] = blob_byte(i);
+    }
+    if (!cn_test_write_file(BLOB_PATH, blob, BLOB_SIZE) ||
+        !cn_test_write_file(TEXT_PATH, text, sizeof(text) - 1) ||
+        !cn_test_write_file(LARGE_PATH, blob, LARGE_SIZE)) {
+        printf("无法创建资源文件\n");
+        return 1;
+    }
+
+    test_embed_global_arrays();
+    test_embed_large_resource();
+    test_embed_errors();
+
+    cn_source_manager_release_default();
+    remove(BLOB_PATH);
+    remove(TEXT_PATH);
+    remove(LARGE_PATH);
+
+    printf("\n========================================\n");
+    printf("测试结果: %d 通过, %d 失败\n", tests_passed, tests_failed);
+    printf("========================================\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,252 @@
+#include "cnlang/frontend/lexer.h"
+#include "cnlang/support/diagnostics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * 推测式并行词法分析确定性测试
+ *
+ * 用极小的分块（每块只有几行）对各种源码并行词法分析，让块接缝落在
+ * 多行字符串、块注释、字符字面量和行注释内部，验证生成的词元流与串行
+ * cn_frontend_token_stream_build 逐词元相同（种类、偏移、长度、后缀），
+ * 词法诊断数量也相同。
+ */
+
+static int streams_equal(const CnTokenStream *a, const CnTokenStream *b)
+{
+    if (a->count != b->count) {
+        return 0;
+    }
+    for (size_t i = 0; i < a->count; i++) {
+        if (a->kinds[i] != b->kinds[i] ||
+            a->offsets[i] != b->offsets[i] ||
+            a->lengths[i] != b->lengths[i] ||
+            a->suffixes[i] != b->suffixes[i]) {
+            fprintf(stderr, "  词元 %zu 不一致: 种类 %d/%d 偏移 %u/%u 长度 %u/%u\n",
+                    i, a->kinds[i], b->kinds[i], a->offsets[i], b->offsets[i],
+                    a->lengths[i], b->lengths[i]);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// 以给定分块参数并行构建，与串行结果比较；relexed 返回重新分析的块数
+static int check_source(const char *name, const char *source, size_t length,
+                        unsigned threads, size_t chunk_length, size_t *relexed)
+{
+    CnTokenStream serial;
+    CnTokenStream parallel;
+    CnDiagnostics serial_diagnostics;
+    CnDiagnostics parallel_diagnostics;
+    CnLexerParallelOptions options;
+    int ok = 1;
+
+    cn_frontend_lexer_parallel_options_default(&options);
+    options.thread_count = threads;
+    options.min_source_length = 0;
+    options.min_chunk_length = chunk_length;
+
+    cn_support_diagnostics_init(&serial_diagnostics);
+    cn_support_diagnostics_init(&parallel_diagnostics);
+
+    if (!cn_frontend_token_stream_build(&serial, source, length, "<parallel-test>",
+                                        &serial_diagnostics) ||
+        !cn_frontend_token_stream_build_parallel(&parallel, source, length, "<parallel-test>",
+                                                 &parallel_diagnostics, &options)) {
+        fprintf(stderr, "lexer_parallel_test: %s 构建词元流失败\n", name);
+        return 0;
+    }
+
+    if (!streams_equal(&serial, &parallel)) {
+        fprintf(stderr, "lexer_parallel_test: %s (线程 %u, 块 %zu) 词元流不一致\n",
+                name, threads, chunk_length);
+        ok = 0;
+    }
+    if (serial_diagnostics.count != parallel_diagnostics.count) {
+        fprintf(stderr, "lexer_parallel_test: %s 诊断数量不一致 (%zu/%zu)\n",
+                name, serial_diagnostics.count, parallel_diagnostics.count);
+        ok = 0;
+    }
+    if (relexed) {
+        *relexed += parallel.relexed_chunks;
+    }
+
+    cn_frontend_token_stream_free(&serial);
+    cn_frontend_token_stream_free(&parallel);
+    cn_support_diagnostics_free(&serial_diagnostics);
+    cn_support_diagnostics_free(&parallel_diagnostics);
+    return ok;
+}
+
+// 每个片段重复多次，使不同的分块大小把接缝落到片段内的不同位置
+static const char *g_fragments[] = {
+    "函数 求和(整数 a, 整数 b) {\n"
+    "    返回 a + b;  // 行注释 \"不是字符串\n"
+    "}\n",
+
+    "变量 多行 = \"第一行\n"
+    "第二行 /* 不是注释 */\n"
+    "// 也不是注释\n"
+    "\\\"转义引号\\\"\n"
+    "最后一行\";\n",
+
+    "/* 块注释跨越多行\n"
+    " * 变量 假 = \"未闭合\n"
+    " * 函数 假函数() {\n"
+    " */ 变量 真 = 0x1F;\n",
+
+    "变量 字符 = '\\'';\n"
+    "变量 浮点 = 3.5e-3f;\n"
+    "变量 无符号 = 42UL;\n"
+    "如果 (字符 != '\"') { 真 = 真 << 2; }\n",
+};
+
+static size_t build_source(char *buf, size_t cap, size_t repeat)
+{
+    size_t pos = 0;
+    size_t count = sizeof(g_fragments) / sizeof(g_fragments[0]);
+
+    for (size_t i = 0; i < repeat; i++) {
+        const char *fragment = g_fragments[i % count];
+        size_t n = strlen(fragment);
+        if (pos + n >= cap) {
+            break;
+        }
+        memcpy(buf + pos, fragment, n);
+        pos += n;
+    }
+    buf[pos] = '\0';
+    return pos;
+}
+
+// 大段多行字符串和注释：多个块的起点都落在其内部，必须重新分析
+static int test_relex_inside_literals(void)
+{
+    static char source[8192];
+    size_t pos = 0;
+    size_t relexed = 0;
+    int ok = 1;
+
+#define PUT(str) do { size_t n_ = strlen(str); memcpy(source + pos, str, n_); pos += n_; } while (0)
+    PUT("变量 长串 = \"");
+    for (int i = 0; i < 40; i++) {
+        PUT("\"引号\" 变量 假 = 1; /* 假注释 \\\"\n");
+    }
+    PUT("\";\n/*");
+    for (int i = 0; i < 40; i++) {
+        PUT(" 函数 假() { 返回 \"; }\n");
+    }
+    PUT("*/\n变量 结束 = 1;\n");
+#undef PUT
+    source[pos] = '\0';
+
+    for (size_t chunk = 16; chunk <= 512; chunk *= 2) {
+        ok &= check_source("多行字面量", source, pos, 8, chunk, &relexed);
+    }
+    if (relexed == 0) {
+        fprintf(stderr, "lexer_parallel_test: 多行字面量未触发任何重新分析\n");
+        ok = 0;
+    }
+    return ok;
+}
+
+// 接缝处的各种片段组合
+static int test_fragment_seams(void)
+{
+    static char source[65536];
+    size_t length = build_source(source, sizeof(source), 400);
+    int ok = 1;
+
+    for (unsigned threads = 2; threads <= 16; threads *= 2) {
+        for (size_t chunk = 7; chunk < 4096; chunk = chunk * 3 + 1) {
+            ok &= check_source("片段组合", source, length, threads, chunk, NULL);
+        }
+    }
+    return ok;
+}
+
+// BOM、词法错误、未闭合块注释、缓冲区中的 NUL 字节
+static int test_edge_cases(void)
+{
+    static const char *sources[] = {
+        "\xEF\xBB\xBF变量 a = 1;\n变量 b = 2;\n变量 c = 3;\n变量 d = 4;\n",
+        "变量 a = 1;\n变量 x = 1 @ 2;\n变量 b = 2;\n变量 y = 0xZZ;\n变量 c = 3;\n",
+        "变量 a = 1;\n变量 b = 2;\n/* 未闭合的块注释\n变量 c = 3;\n变量 d = 4;\n",
+        "变量 a = 1;\n变量 b = 2;\n变量 s = \"未终止的字符串\n变量 c = 3;\n",
+        "",
+        "\n\n\n\n\n\n\n\n",
+    };
+    static const char nul_source[] = "变量 a = 1;\n变量 b = 2;\n\0变量 c = 3;\n变量 d = 4;\n";
+    int ok = 1;
+
+    for (size_t i = 0; i < sizeof(sources) / sizeof(sources[0]); i++) {
+        for (size_t chunk = 1; chunk <= 32; chunk *= 2) {
+            ok &= check_source("边界情况", sources[i], strlen(sources[i]), 4, chunk, NULL);
+        }
+    }
+    for (size_t chunk = 1; chunk <= 32; chunk *= 2) {
+        ok &= check_source("NUL 字节", nul_source, sizeof(nul_source) - 1, 4, chunk, NULL);
+    }
+    return ok;
+}
+
+// 低于阈值或单线程时走串行路径
+static int test_threshold(void)
+{
+    static const char source[] = "变量 a = 1;\n变量 b = 2;\n变量 c = 3;\n";
+    CnTokenStream stream;
+    CnLexerParallelOptions options;
+    int ok = 1;
+
+    cn_frontend_lexer_parallel_options_default(&options);
+    options.thread_count = 4;
+    if (!cn_frontend_token_stream_build_parallel(&stream, source, sizeof(source) - 1,
+                                                 "<parallel-test>", NULL, &options) ||
+        stream.chunk_count != 0) {
+        fprintf(stderr, "lexer_parallel_test: 小文件应走串行路径\n");
+        ok = 0;
+    }
+    cn_frontend_token_stream_free(&stream);
+
+    options.min_source_length = 0;
+    options.min_chunk_length = 1;
+    options.thread_count = 1;
+    if (!cn_frontend_token_stream_build_parallel(&stream, source, sizeof(source) - 1,
+                                                 "<parallel-test>", NULL, &options) ||
+        stream.chunk_count != 0) {
+        fprintf(stderr, "lexer_parallel_test: 单线程应走串行路径\n");
+        ok = 0;
+    }
+    cn_frontend_token_stream_free(&stream);
+
+    options.thread_count = 3;
+    if (!cn_frontend_token_stream_build_parallel(&stream, source, sizeof(source) - 1,
+                                                 "<parallel-test>", NULL, &options) ||
+        stream.chunk_count != 3) {
+        fprintf(stderr, "lexer_parallel_test: 应按行切分为 3 块 (实际 %zu)\n", stream.chunk_count);
+        ok = 0;
+    }
+    cn_frontend_token_stream_free(&stream);
+    return ok;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    failures += !test_threshold();
+    failures += !test_fragment_seams();
+    failures += !test_relex_inside_literals();
+    failures += !test_edge_cases();
+
+    if (failures != 0) {
+        fprintf(stderr, "lexer_parallel_test: %d 个测试失败\n", failures);
+        return 1;
+    }
+
+    printf("lexer_parallel_test: 所有测试通过\n");
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include "cnlang/frontend/lexer.h"
+#include "cnlang/support/diagnostics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * 词法分析器空白/注释/字符串扫描测试
+ *
+ * 对每一种可用的扫描实现（标量、SSE2、AVX2），用跨越 16/32 字节边界的
+ * 各种长度的缩进、注释和字符串生成源码，验证词元种类、词素和行列号
+ * 与各实现之间完全一致。
+ */
+
+#define MAX_TOKENS 64
+
+typedef struct {
+    CnTokenKind kind;
+    size_t offset;
+    size_t length;
+    int line;
+    int column;
+} ScanToken;
+
+typedef struct {
+    ScanToken tokens[MAX_TOKENS];
+    size_t count;
+    size_t diag_count;
+} ScanResult;
+
+static void lex_all(const char *source, size_t length, ScanResult *result)
+{
+    CnLexer lexer;
+    CnToken token;
+    CnDiagnostics diagnostics;
+
+    cn_support_diagnostics_init(&diagnostics);
+    cn_frontend_lexer_init(&lexer, source, length, "<scan-test>");
+    cn_frontend_lexer_set_diagnostics(&lexer, &diagnostics);
+
+    result->count = 0;
+    while (result->count < MAX_TOKENS && cn_frontend_lexer_next_token(&lexer, &token)) {
+        ScanToken *out = &result->tokens[result->count++];
+        out->kind = token.kind;
+        out->offset = (size_t)(token.lexeme_begin - source);
+        out->length = token.lexeme_length;
+        out->line = token.line;
+        out->column = token.column;
+        if (token.kind == CN_TOKEN_EOF) {
+            break;
+        }
+    }
+    result->diag_count = diagnostics.count;
+    cn_support_diagnostics_free(&diagnostics);
+}
+
+static int results_equal(const ScanResult *a, const ScanResult *b)
+{
+    if (a->count != b->count || a->diag_count != b->diag_count) {
+        return 0;
+    }
+    for (size_t i = 0; i < a->count; i++) {
+        if (a->tokens[i].kind != b->tokens[i].kind ||
+            a->tokens[i].offset != b->tokens[i].offset ||
+            a->tokens[i].length != b->tokens[i].length ||
+            a->tokens[i].line != b->tokens[i].line ||
+            a->tokens[i].column != b->tokens[i].column) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// 生成带有 pad 字节填充的源码：缩进、行注释、块注释（含中文）、带转义的字符串
+static size_t build_source(char *buf, size_t cap, int pad)
+{
+    size_t pos = 0;
+    int i;
+
+#define PUT(str) do { size_t n_ = strlen(str); if (pos + n_ < cap) { memcpy(buf + pos, str, n_); pos += n_; } } while (0)
+    for (i = 0; i < pad; i++) {
+        PUT(i % 7 == 6 ? "\t" : " ");
+    }
+    PUT("变量 甲 = 1;\n");
+    PUT("//");
+    for (i = 0; i < pad; i++) {
+        PUT(i % 3 == 0 ? "注" : "x");
+    }
+    PUT("\n");
+    for (i = 0; i < pad; i++) {
+        PUT(i % 5 == 4 ? "\r\n" : " ");
+    }
+    PUT("/*");
+    for (i = 0; i < pad; i++) {
+        PUT(i % 4 == 0 ? "*" : (i % 9 == 0 ? "\n" : "释"));
+    }
+    PUT("*/ 变量 乙 = \"");
+    for (i = 0; i < pad; i++) {
+        PUT(i % 6 == 5 ? "\\\"" : (i % 11 == 10 ? "\n" : "字"));
+    }
+    PUT("\";\n");
+    PUT("变量 丙 = \"");
+    for (i = 0; i < pad; i++) {
+        PUT("\\\\");
+    }
+    PUT("\" /* 未闭合");
+    for (i = 0; i < pad; i++) {
+        PUT(" ");
+    }
+#undef PUT
+    buf[pos] = '\0';
+    return pos;
+}
+
+int main(void)
+{
+    static char source[16384];
+    CnLexerScanLevel best = cn_frontend_lexer_set_scan_level(CN_LEXER_SCAN_AVX2);
+    int failures = 0;
+
+    printf("lexer_scan_test: 可用的最高扫描级别 = %d\n", (int)best);
+
+    for (int pad = 0; pad <= 80; pad++) {
+        size_t length = build_source(source, sizeof(source), pad);
+        ScanResult reference;
+        ScanResult actual;
+
+        cn_frontend_lexer_set_scan_level(CN_LEXER_SCAN_SCALAR);
+        lex_all(source, length, &reference);
+
+        // 基本正确性：行注释、块注释被跳过，字符串词元完整，未闭合块注释报错
+        if (reference.count < 12 || reference.diag_count != 1 ||
+            reference.tokens[reference.count - 1].kind != CN_TOKEN_EOF) {
+            fprintf(stderr, "lexer_scan_test: pad=%d 标量结果异常 (tokens=%zu, diags=%zu)\n",
+                    pad, reference.count, reference.diag_count);
+            failures++;
+            continue;
+        }
+
+        for (int level = CN_LEXER_SCAN_SSE2; level <= (int)best; level++) {
+            cn_frontend_lexer_set_scan_level((CnLexerScanLevel)level);
+            lex_all(source, length, &actual);
+            if (!results_equal(&reference, &actual)) {
+                fprintf(stderr, "lexer_scan_test: pad=%d 级别 %d 与标量结果不一致\n", pad, level);
+                failures++;
+            }
+        }
+    }
+
+    cn_frontend_lexer_set_scan_level(best);
+
+    if (failures != 0) {
+        fprintf(stderr, "lexer_scan_test: %d 个测试失败\n", failures);
+        return 1;
+    }
+
+    printf("lexer_scan_test: 所有测试通过\n");
+    return 0;
+}
@@ -0,0 +1,210 @@
+#include "cnlang/frontend/lexer.h"
+#include "cnlang/frontend/parser.h"
+#include "cnlang/frontend/ast.h"
+#include "cnlang/support/diagnostics.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * 整文件预词法化词元流测试：
+ * 词元流中的每个词元（种类、词素、行列号、后缀）必须与逐个词元的词法分析结果一致，
+ * 基于词元流的解析结果也必须与基于 lexer 的解析结果一致。
+ */
+
+static const char *g_sources[] = {
+    "函数 主程序() {\n"
+    "    变量 计数 = 0;\n"
+    "    // 单行注释\n"
+    "    当 (计数 < 10) {\n"
+    "        计数 = 计数 + 1;\n"
+    "    }\n"
+    "    /* 块注释\n"
+    "       跨行 */\n"
+    "    返回 计数;\n"
+    "}\n",
+
+    /* UTF-8 BOM + 数字后缀 + 字符/字符串字面量 + \r\n 换行 */
+    "\xEF\xBB\xBF变量 a = 10UL;\r\n"
+    "变量 b = 3.5f;\r\n"
+    "变量 c = 'x';\r\n"
+    "变量 s = \"你好\\n世界\";\r\n",
+
+    /* 词法错误：非法字符、未终止字符串 */
+    "变量 x = 1 @ 2;\n"
+    "变量 y = \"未终止\n",
+
+    "",
+};
+
+static int tokens_equal(const CnToken *a, const CnToken *b)
+{
+    return a->kind == b->kind &&
+           a->lexeme_begin == b->lexeme_begin &&
+           a->lexeme_length == b->lexeme_length &&
+           a->line == b->line &&
+           a->column == b->column &&
+           (a->kind != CN_TOKEN_INTEGER && a->kind != CN_TOKEN_FLOAT_LITERAL ?
+                1 : a->number_suffix == b->number_suffix);
+}
+
+static int test_stream_matches_lexer(const char *source, size_t index)
+{
+    size_t length = strlen(source);
+    CnLexer lexer;
+    CnTokenStream stream;
+    CnToken expected;
+    CnToken actual;
+    CnDiagnostics lexer_diags;
+    CnDiagnostics stream_diags;
+    size_t i = 0;
+    int failed = 0;
+
+    cn_support_diagnostics_init(&lexer_diags);
+    cn_support_diagnostics_init(&stream_diags);
+
+    cn_frontend_lexer_init(&lexer, source, length, "<stream-test>");
+    cn_frontend_lexer_set_diagnostics(&lexer, &lexer_diags);
+
+    if (!cn_frontend_token_stream_build(&stream, source, length, "<stream-test>", &stream_diags)) {
+        fprintf(stderr, "lexer_token_stream_test: 源码 %zu 构建词元流失败\n", index);
+        cn_support_diagnostics_free(&lexer_diags);
+        cn_support_diagnostics_free(&stream_diags);
+        return 1;
+    }
+
+    for (;;) {
+        cn_frontend_lexer_next_token(&lexer, &expected);
+        cn_frontend_token_stream_get(&stream, i, &actual);
+        if (!tokens_equal(&expected, &actual)) {
+            fprintf(stderr,
+                    "lexer_token_stream_test: 源码 %zu 词元 %zu 不一致 "
+                    "(期望 kind=%d %d:%d，实际 kind=%d %d:%d)\n",
+                    index, i, expected.kind, expected.line, expected.column,
+                    actual.kind, actual.line, actual.column);
+            failed = 1;
+            break;
+        }
+        i++;
+        if (expected.kind == CN_TOKEN_EOF) {
+            break;
+        }
+    }
+
+    if (!failed && i != stream.count) {
+        fprintf(stderr, "lexer_token_stream_test: 源码 %zu 词元数量不一致 (%zu vs %zu)\n",
+                index, i, stream.count);
+        failed = 1;
+    }
+
+    // 诊断信息（含行列号）必须一致
+    if (!failed && lexer_diags.count != stream_diags.count) {
+        fprintf(stderr, "lexer_token_stream_test: 源码 %zu 诊断数量不一致 (%zu vs %zu)\n",
+                index, lexer_diags.count, stream_diags.count);
+        failed = 1;
+    }
+    for (size_t d = 0; !failed && d < lexer_diags.count; d++) {
+        if (lexer_diags.items[d].line != stream_diags.items[d].line ||
+            lexer_diags.items[d].column != stream_diags.items[d].column ||
+            lexer_diags.items[d].code != stream_diags.items[d].code) {
+            fprintf(stderr, "lexer_token_stream_test: 源码 %zu 诊断 %zu 位置不一致\n", index, d);
+            failed = 1;
+        }
+    }
+
+    // 随机访问（倒序）也必须得到相同的行列号
+    for (size_t k = stream.count; !failed && k > 0; k--) {
+        CnToken forward;
+        CnToken backward;
+        cn_frontend_token_stream_get(&stream, k - 1, &backward);
+        cn_frontend_token_stream_get(&stream, k - 1, &forward);
+        if (!tokens_equal(&forward, &backward)) {
+            fprintf(stderr, "lexer_token_stream_test: 源码 %zu 倒序访问不一致\n", index);
+            failed = 1;
+        }
+    }
+
+    cn_frontend_token_stream_free(&stream);
+    cn_support_diagnostics_free(&lexer_diags);
+    cn_support_diagnostics_free(&stream_diags);
+    return failed;
+}
+
+static int test_parser_from_stream(void)
+{
+    /* 覆盖需要前瞻与回溯的语法：指针声明、类型转换、模板前瞻判断 */
+    const char *source =
+        "结构体 点 { 整数 x; 整数 y; }\n"
+        "函数 计算(整数 a, 整数 b) {\n"
+        "    点* p = 无;\n"
+        "    整数 c = (整数)(a + b);\n"
+        "    如果 (a < b) { 返回 (a + b) * 2; }\n"
+        "    返回 c;\n"
+        "}\n";
+    size_t length = strlen(source);
+    CnLexer lexer;
+    CnTokenStream stream;
+    CnParser *lexer_parser;
+    CnParser *stream_parser;
+    CnAstProgram *lexer_program = NULL;
+    CnAstProgram *stream_program = NULL;
+    int failed = 0;
+
+    cn_frontend_lexer_init(&lexer, source, length, "<stream-parse>");
+    lexer_parser = cn_frontend_parser_new(&lexer);
+    if (!cn_frontend_token_stream_build(&stream, source, length, "<stream-parse>", NULL)) {
+        fprintf(stderr, "lexer_token_stream_test: 构建词元流失败\n");
+        cn_frontend_parser_free(lexer_parser);
+        return 1;
+    }
+    stream_parser = cn_frontend_parser_new_from_stream(&stream);
+
+    if (!lexer_parser || !stream_parser ||
+        !cn_frontend_parse_program(lexer_parser, &lexer_program) ||
+        !cn_frontend_parse_program(stream_parser, &stream_program)) {
+        fprintf(stderr, "lexer_token_stream_test: 解析失败\n");
+        failed = 1;
+    } else if (lexer_program->function_count != stream_program->function_count ||
+               lexer_program->struct_count != stream_program->struct_count ||
+               stream_program->function_count != 1 ||
+               stream_program->functions[0]->body->stmt_count !=
+                   lexer_program->functions[0]->body->stmt_count) {
+        fprintf(stderr, "lexer_token_stream_test: 词元流解析结果与 lexer 解析结果不一致\n");
+        failed = 1;
+    } else {
+        CnAstBlockStmt *expected_body = lexer_program->functions[0]->body;
+        CnAstBlockStmt *actual_body = stream_program->functions[0]->body;
+        for (size_t i = 0; i < expected_body->stmt_count; i++) {
+            if (expected_body->stmts[i]->kind != actual_body->stmts[i]->kind) {
+                fprintf(stderr, "lexer_token_stream_test: 第 %zu 条语句种类不一致\n", i);
+                failed = 1;
+                break;
+            }
+        }
+    }
+
+    cn_frontend_ast_program_free(lexer_program);
+    cn_frontend_ast_program_free(stream_program);
+    cn_frontend_parser_free(lexer_parser);
+    cn_frontend_parser_free(stream_parser);
+    cn_frontend_token_stream_free(&stream);
+    return failed;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    for (size_t i = 0; i < sizeof(g_sources) / sizeof(g_sources[0]); i++) {
+        failures += test_stream_matches_lexer(g_sources[i], i);
+    }
+    failures += test_parser_from_stream();
+
+    if (failures != 0) {
+        fprintf(stderr, "lexer_token_stream_test: %d 个测试失败\n", failures);
+        return 1;
+    }
+
+    printf("lexer_token_stream_test: 所有测试通过\n");
+    return 0;
+}
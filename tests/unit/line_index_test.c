@@ -0,0 +1,202 @@
+#include "cnlang/support/line_index.h"
+#include "test_support.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * 行首索引测试
+ *
+ * 验证字节偏移与（行，字节列，UTF-16 列）的双向换算（含中文、增补平面字符、
+ * \r\n 换行），以及随机编辑序列下增量更新的索引与整体重建的索引完全一致。
+ */
+
+// ============================================================================
+// 测试统计
+// ============================================================================
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// 逐字节扫描计算位置（对照实现）
+static CnTextPosition naive_position(const char *text, size_t offset)
+{
+    CnTextPosition position = {0, 0, 0};
+    for (size_t i = 0; i < offset; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c == '\n') {
+            position.line++;
+            position.byte_column = 0;
+            position.utf16_column = 0;
+            continue;
+        }
+        position.byte_column++;
+        if ((c & 0xC0) != 0x80) {
+            position.utf16_column += c >= 0xF0 ? 2 : 1;
+        }
+    }
+    return position;
+}
+
+static void test_positions(void)
+{
+    printf("测试：偏移与位置双向换算\n");
+
+    /* "变量" 每字 3 字节 / 1 个 UTF-16 单元；"😀" 4 字节 / 2 个单元 */
+    const char *text = "变量 a = 1;\r\n"
+                       "打印(\"😀表情\");\n"
+                       "\n"
+                       "ascii only line\n"
+                       "末行无换行";
+    size_t length = strlen(text);
+    CnLineIndex index;
+    bool positions_ok = true;
+
+    TEST_ASSERT(cn_line_index_init(&index, text, length), "构建失败");
+    TEST_ASSERT(index.line_count == 5, "行数应为 5");
+
+    for (size_t offset = 0; positions_ok && offset <= length; offset++) {
+        CnTextPosition expected = naive_position(text, offset);
+        CnTextPosition actual = cn_line_index_position(&index, text, offset);
+        if (expected.line != actual.line ||
+            expected.byte_column != actual.byte_column ||
+            expected.utf16_column != actual.utf16_column) {
+            printf("    偏移 %zu: 期望 (%u,%u,%u) 实际 (%u,%u,%u)\n", offset,
+                   expected.line, expected.byte_column, expected.utf16_column,
+                   actual.line, actual.byte_column, actual.utf16_column);
+            positions_ok = false;
+        }
+
+        // 字符起点处 UTF-16 列可以精确换算回字节偏移
+        if (positions_ok && ((unsigned char)text[offset] & 0xC0) != 0x80) {
+            size_t back = cn_line_index_offset_from_utf16(&index, text, actual.line,
+                                                          actual.utf16_column);
+            size_t end;
+            cn_line_index_line_span(&index, text, actual.line, NULL, &end);
+            if (back != (offset < end ? offset : end)) {
+                printf("    偏移 %zu 往返得到 %zu\n", offset, back);
+                positions_ok = false;
+            }
+        }
+    }
+    TEST_ASSERT(positions_ok, "偏移与位置换算不一致");
+
+    // "打印(\"😀" 之后的列：打(1) 印(1) ( " 😀(2) -> 表 位于 UTF-16 列 6
+    size_t line1 = index.line_starts[1];
+    TEST_ASSERT(cn_line_index_offset_from_utf16(&index, text, 1, 6) == line1 + strlen("打印(\"😀"), "表 的偏移");
+    // 代理对中间的列落到该字符起点
+    TEST_ASSERT(cn_line_index_offset_from_utf16(&index, text, 1, 5) == line1 + strlen("打印(\""),
+                "代理对中间");
+    // 超出行长度时截断到行内容末尾（不含换行）
+    TEST_ASSERT(cn_line_index_offset_from_utf16(&index, text, 0, 100) == strlen("变量 a = 1;"),
+                "\\r\\n 行末截断");
+    TEST_ASSERT(cn_line_index_offset_from_utf16(&index, text, 99, 0) == length, "行号越界");
+
+    // 编译器诊断位置（1 起始、字节列）
+    TEST_ASSERT(cn_line_index_offset_from_diag(&index, text, 4, 7) == index.line_starts[3] + 6, "诊断位置换算");
+
+    cn_line_index_free(&index);
+    TEST_PASS("偏移与位置双向换算");
+}
+
+static int indexes_equal(const CnLineIndex *a, const CnLineIndex *b)
+{
+    if (a->line_count != b->line_count || a->length != b->length) {
+        return 0;
+    }
+    for (size_t i = 0; i < a->line_count; i++) {
+        if (a->line_starts[i] != b->line_starts[i] || a->line_ascii[i] != b->line_ascii[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void test_incremental_edits(void)
+{
+    printf("测试：随机编辑后的增量更新\n");
+
+    static const char *pieces[] = {
+        "", "x", "\n", "中文", "a\nb", "\r\n", "函数 主程序() {\n    返回 0;\n}\n", "😀", "\n\n\n",
+    };
+    size_t piece_count = sizeof(pieces) / sizeof(pieces[0]);
+    size_t capacity = 1 << 16;
+    char *text = (char *)malloc(capacity);
+    char *scratch = (char *)malloc(capacity);
+    size_t length;
+    CnLineIndex index;
+    unsigned seed = 12345;
+    bool edits_ok = true;
+
+    TEST_ASSERT(text && scratch, "内存不足");
+
+    strcpy(text, "变量 甲 = 1;\n变量 乙 = 2;\nascii\n");
+    length = strlen(text);
+    cn_line_index_init(&index, text, length);
+
+    for (int step = 0; edits_ok && step < 2000; step++) {
+        const char *insert;
+        size_t insert_length;
+        size_t offset;
+        size_t removed;
+        CnLineIndex rebuilt;
+
+        seed = seed * 1103515245u + 12345u;
+        offset = length ? (seed >> 8) % (length + 1) : 0;
+        seed = seed * 1103515245u + 12345u;
+        removed = (seed >> 8) % 8;
+        if (removed > length - offset) {
+            removed = length - offset;
+        }
+        seed = seed * 1103515245u + 12345u;
+        insert = pieces[(seed >> 8) % piece_count];
+        insert_length = strlen(insert);
+        if (length - removed + insert_length + 1 > capacity) {
+            insert_length = 0;
+        }
+
+        memcpy(scratch, text, offset);
+        memcpy(scratch + offset, insert, insert_length);
+        memcpy(scratch + offset + insert_length, text + offset + removed, length - offset - removed);
+        length = length - removed + insert_length;
+        memcpy(text, scratch, length);
+        text[length] = '\0';
+
+        if (!cn_line_index_apply_edit(&index, text, offset, removed, insert_length)) {
+            printf("    第 %d 步增量更新失败\n", step);
+            edits_ok = false;
+            break;
+        }
+        cn_line_index_init(&rebuilt, text, length);
+        if (!indexes_equal(&index, &rebuilt)) {
+            printf("    第 %d 步（偏移 %zu 删除 %zu 插入 %zu）后与重建结果不一致\n",
+                   step, offset, removed, insert_length);
+            edits_ok = false;
+        }
+        cn_line_index_free(&rebuilt);
+    }
+    TEST_ASSERT(edits_ok, "增量更新的索引与重建结果不一致");
+    TEST_ASSERT(!cn_line_index_apply_edit(&index, text, length + 1, 0, 0), "越界编辑应失败");
+
+    cn_line_index_free(&index);
+    free(text);
+    free(scratch);
+    TEST_PASS("随机编辑后的增量更新");
+}
+
+int main(void)
+{
+    printf("========================================\n");
+    printf("行首索引测试\n");
+    printf("========================================\n\n");
+
+    test_positions();
+    test_incremental_edits();
+
+    printf("\n========================================\n");
+    printf("测试结果: %d 通过, %d 失败\n", tests_passed, tests_failed);
+    printf("========================================\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -1,5 +1,6 @@
 #include "cnlang/frontend/lsp_bridge.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
@@ -94,6 +95,181 @@ void test_lsp_diagnostic_position_conversion(void)
     printf("  ✓ 通过\n\n");
 }
 
+// 测试中文标识符的引用位置（列按 UTF-16 代码单元计）
+void test_lsp_references_utf16_columns(void)
+{
+    printf("测试：中文标识符引用位置（UTF-16 列）\n");
+
+    const char *source =
+        "函数 主程序() {\n"
+        "    变量 数值 = 1;\n"
+        "    打印(\"😀\"); 返回 数值 + 数值;\n"
+        "}\n";
+
+    CnLspDocumentAnalysis *analysis = cn_lsp_analyze_document(
+        source, strlen(source), "test://test.cn");
+    assert(analysis != NULL);
+
+    // 第 3 行 "    打印(\"😀\"); 返回 " 共 4 + 2 + 7 + 1 + 2 + 1 = 17 个 UTF-16 单元（😀 占 2 个）
+    CnLspPosition position = {2, 17};
+    CnLspRange *ranges = NULL;
+    size_t count = 0;
+    bool found = cn_lsp_find_references(analysis, position, &ranges, &count);
+    assert(found);
+    printf("  引用数量: %zu\n", count);
+    assert(count == 3);
+
+    assert(ranges[0].start.line == 1 && ranges[0].start.column == 7);
+    assert(ranges[0].end.column == 9);
+    assert(ranges[1].start.line == 2 && ranges[1].start.column == 17);
+    assert(ranges[2].start.line == 2 && ranges[2].start.column == 22);
+    assert(ranges[2].end.column == 24);
+    free(ranges);
+
+    // 位置与字节偏移互相换算
+    size_t offset = 0;
+    found = cn_lsp_position_to_offset(analysis, position, &offset);
+    assert(found);
+    assert(strncmp(source + offset, "数值 + 数值", strlen("数值 + 数值")) == 0);
+    CnLspPosition back = cn_lsp_offset_to_position(analysis, offset);
+    assert(back.line == position.line && back.column == position.column);
+
+    cn_lsp_free_analysis(analysis);
+    printf("  ✓ 通过\n\n");
+}
+
+// 对文本做一次替换，并与完整分析比较诊断
+static CnLspDocumentAnalysis *reanalyze_and_compare(
+    CnLspDocumentAnalysis *previous, char *text, const char *old_text, const char *new_text)
+{
+    size_t offset = (size_t)(strstr(text, old_text) - text);
+    size_t removed = strlen(old_text);
+    size_t inserted = strlen(new_text);
+    size_t tail = strlen(text + offset + removed) + 1;
+
+    // 与文档管理器一致：原地修改文本，旧分析结果交给增量分析接管
+    memmove(text + offset + inserted, text + offset + removed, tail);
+    memcpy(text + offset, new_text, inserted);
+
+    CnLspDocumentAnalysis *analysis = cn_lsp_reanalyze_document(
+        previous, text, strlen(text), "test://test.cn", NULL, offset, removed, inserted);
+    CnLspDocumentAnalysis *full = cn_lsp_analyze_document(text, strlen(text), "test://test.cn");
+    assert(analysis != NULL && full != NULL);
+
+    printf("  诊断数量: %zu（完整分析 %zu）\n", analysis->diagnostic_count, full->diagnostic_count);
+    assert(analysis->diagnostic_count == full->diagnostic_count);
+    for (size_t i = 0; i < full->diagnostic_count; i++) {
+        assert(analysis->diagnostics[i].range.start.line == full->diagnostics[i].range.start.line);
+        assert(analysis->diagnostics[i].range.start.column == full->diagnostics[i].range.start.column);
+        assert(strcmp(analysis->diagnostics[i].message, full->diagnostics[i].message) == 0);
+    }
+
+    cn_lsp_free_analysis(full);
+    return analysis;
+}
+
+// 测试编辑后的增量分析：诊断与完整分析一致
+void test_lsp_reanalyze_document(void)
+{
+    printf("测试：编辑后增量分析\n");
+
+    char text[1024];
+    strcpy(text,
+        "结构体 节点 { 整数 值; 节点* 下一个; }\n"
+        "函数 链长(节点* p) -> 整数 {\n"
+        "    变量 n = 0;\n"
+        "    当 (p != 无) { n = n + 1; p = p->下一个; }\n"
+        "    返回 n;\n"
+        "}\n"
+        "函数 主程序() -> 整数 {\n"
+        "    打印(\"开始\");\n"
+        "    返回 0;\n"
+        "}\n");
+
+    CnLspDocumentAnalysis *analysis = cn_lsp_analyze_document(text, strlen(text), "test://test.cn");
+    assert(analysis != NULL && analysis->diagnostic_count == 0);
+
+    // 函数体内引入未定义变量，随后在其前插入一行再修复
+    analysis = reanalyze_and_compare(analysis, text, "返回 n;", "返回 m;");
+    assert(analysis->diagnostic_count > 0);
+    analysis = reanalyze_and_compare(analysis, text, "    变量 n = 0;\n", "    变量 n = 0;\n    n = 1;\n");
+    analysis = reanalyze_and_compare(analysis, text, "返回 m;", "返回 n;");
+    assert(analysis->diagnostic_count == 0);
+
+    // 语法错误时改为完整分析
+    analysis = reanalyze_and_compare(analysis, text, "返回 0;", "返回 0");
+    assert(analysis->diagnostic_count > 0);
+    analysis = reanalyze_and_compare(analysis, text, "返回 0", "返回 链长(无);");
+    assert(analysis->diagnostic_count == 0);
+
+    cn_lsp_free_analysis(analysis);
+    printf("  ✓ 通过\n\n");
+}
+
+// 测试文档符号：大纲分析（函数体跳读）与完整分析得到相同的顶层声明
+void test_lsp_document_symbols(void)
+{
+    printf("测试：文档符号（大纲分析）\n");
+
+    const char *source =
+        "结构体 点 {\n"
+        "    整数 x;\n"
+        "    整数 y;\n"
+        "}\n"
+        "枚举 颜色 { 红色, 绿色 }\n"
+        "整数 计数 = 0;\n"
+        "函数 求和(整数 a, 整数 b) -> 整数 {\n"
+        "    返回 a + b;\n"
+        "}\n"
+        "函数 主程序() {\n"
+        "    返回 求和(1, 2);\n"
+        "}\n";
+    const char *names[] = { "点", "颜色", "计数", "求和", "主程序" };
+    const CnSemSymbolKind kinds[] = {
+        CN_SEM_SYMBOL_STRUCT, CN_SEM_SYMBOL_ENUM, CN_SEM_SYMBOL_VARIABLE,
+        CN_SEM_SYMBOL_FUNCTION, CN_SEM_SYMBOL_FUNCTION
+    };
+    const int lines[] = { 0, 4, 5, 6, 9 };
+
+    CnLspDocumentAnalysis *outline = cn_lsp_analyze_document_outline(
+        source, strlen(source), "test://test.cn", NULL);
+    CnLspDocumentAnalysis *full = cn_lsp_analyze_document(
+        source, strlen(source), "test://test.cn");
+    assert(outline != NULL && full != NULL);
+    assert(outline->global_scope == NULL);
+    assert(outline->program->functions[0]->body == NULL);
+
+    CnLspSymbolInfo *symbols = NULL;
+    CnLspSymbolInfo *full_symbols = NULL;
+    size_t count = 0;
+    size_t full_count = 0;
+    bool ok = cn_lsp_get_document_symbols(outline, &symbols, &count);
+    assert(ok);
+    ok = cn_lsp_get_document_symbols(full, &full_symbols, &full_count);
+    assert(ok);
+    printf("  符号数量: %zu\n", count);
+    assert(count == 5 && full_count == 5);
+
+    for (size_t i = 0; i < count; i++) {
+        assert(symbols[i].name_length == strlen(names[i]));
+        assert(memcmp(symbols[i].name, names[i], symbols[i].name_length) == 0);
+        assert(symbols[i].kind == kinds[i]);
+        assert(symbols[i].definition_range.start.line == lines[i]);
+        assert(full_symbols[i].kind == symbols[i].kind);
+        assert(full_symbols[i].definition_range.start.line == symbols[i].definition_range.start.line);
+        assert(full_symbols[i].definition_range.start.column == symbols[i].definition_range.start.column);
+    }
+    // "函数 求和" 中名称从第 3 个 UTF-16 单元开始，占 2 个
+    assert(symbols[3].definition_range.start.column == 3);
+    assert(symbols[3].definition_range.end.column == 5);
+
+    free(symbols);
+    free(full_symbols);
+    cn_lsp_free_analysis(outline);
+    cn_lsp_free_analysis(full);
+    printf("  ✓ 通过\n\n");
+}
+
 int main(void)
 {
     printf("=== LSP 桥接层单元测试 ===\n\n");
@@ -101,6 +277,9 @@ int main(void)
     test_lsp_analyze_document_success();
     test_lsp_analyze_document_with_errors();
     test_lsp_diagnostic_position_conversion();
+    test_lsp_references_utf16_columns();
+    test_lsp_reanalyze_document();
+    test_lsp_document_symbols();
 
     printf("=== 所有测试通过 ===\n");
     return 0;
@@ -0,0 +1,289 @@
+#include "cnlang/frontend/lexer.h"
+#include "cnlang/frontend/parser.h"
+#include "cnlang/frontend/ast.h"
+#include "cnlang/frontend/ast_cache.h"
+#include "cnlang/support/diagnostics.h"
+#include "test_support.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * 增量解析测试
+ *
+ * 对上一次解析的 AST 应用文本编辑后，只重新解析受影响的顶层声明，
+ * 整棵树序列化的映像与对新文本完整解析逐字节相同，未受影响的声明节点原样复用。
+ * 编辑引入语法错误或改变可见性划分时放弃增量解析，AST 保持不变。
+ */
+
+// ============================================================================
+// 测试统计
+// ============================================================================
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static const char *g_source =
+    "导入 数学;\n"
+    "结构体 点 { 整数 x; 整数 y; }\n"
+    "变量 计数 = 0;\n"
+    "函数 第一(整数 a) -> 整数 {\n"
+    "    返回 a + 1;\n"
+    "}\n"
+    "函数 第二(整数 n) -> 整数 {\n"
+    "    变量 总和 = 0;\n"
+    "    循环 (变量 i = 0; i < n; i++) { 总和 = 总和 + i; }\n"
+    "    返回 总和;\n"
+    "}\n"
+    "公开:\n"
+    "函数 第三() { 打印(\"第三\"); }\n"
+    "函数 第四() -> 整数 {\n"
+    "    计数 = 第一(2) * 第二(3);\n"
+    "    返回 计数;\n"
+    "}\n";
+
+// AST 中的字符串字面量指向源码，测试期间产生的所有文本保留到用例结束
+typedef struct Texts {
+    char *items[8];
+    size_t count;
+} Texts;
+
+static void texts_free(Texts *texts)
+{
+    for (size_t i = 0; i < texts->count; i++) {
+        free(texts->items[i]);
+    }
+    texts->count = 0;
+}
+
+// 在 text 的 offset 处删除 removed 字节并插入 insert
+static char *apply_edit(Texts *texts, const char *text, size_t offset, size_t removed, const char *insert)
+{
+    size_t length = strlen(text);
+    size_t insert_length = strlen(insert);
+    char *result = (char *)malloc(length - removed + insert_length + 1);
+
+    if (!result || texts->count >= sizeof(texts->items) / sizeof(texts->items[0])) {
+        free(result);
+        return NULL;
+    }
+    memcpy(result, text, offset);
+    memcpy(result + offset, insert, insert_length);
+    memcpy(result + offset + insert_length, text + offset + removed, length - offset - removed + 1);
+    texts->items[texts->count++] = result;
+    return result;
+}
+
+// 完整解析；items 非 NULL 时记录顶层声明区间
+static CnAstProgram *parse_full(const char *source, CnParseItemList *items, CnDiagnostics *diagnostics)
+{
+    CnTokenStream stream;
+    CnParser *parser;
+    CnAstProgram *program = NULL;
+
+    if (!cn_frontend_token_stream_build(&stream, source, strlen(source), "<incremental>", diagnostics)) {
+        return NULL;
+    }
+    parser = cn_frontend_parser_new_from_stream(&stream);
+    if (parser) {
+        cn_frontend_parser_set_diagnostics(parser, diagnostics);
+        cn_frontend_parser_set_item_list(parser, items);
+        cn_frontend_parse_program(parser, &program);
+        cn_frontend_parser_free(parser);
+    }
+    cn_frontend_token_stream_free(&stream);
+    return program;
+}
+
+// 对编辑后的文本增量解析 program
+static bool parse_incremental(CnAstProgram *program, CnParseItemList *items, const char *source,
+                              size_t offset, size_t removed, size_t inserted)
+{
+    CnTokenStream stream;
+    CnParser *parser;
+    bool ok = false;
+
+    if (!cn_frontend_token_stream_build(&stream, source, strlen(source), "<incremental>", NULL)) {
+        return false;
+    }
+    parser = cn_frontend_parser_new_from_stream(&stream);
+    if (parser) {
+        ok = cn_frontend_parse_program_incremental(parser, program, items, offset, removed, inserted);
+        cn_frontend_parser_free(parser);
+    }
+    cn_frontend_token_stream_free(&stream);
+    return ok;
+}
+
+// 两棵树序列化后逐字节相同即结构一致
+static bool same_tree(const CnAstProgram *a, const CnAstProgram *b)
+{
+    size_t size_a = 0;
+    size_t size_b = 0;
+    void *image_a = cn_ast_cache_serialize(a, 1, 1, &size_a);
+    void *image_b = cn_ast_cache_serialize(b, 1, 1, &size_b);
+    bool same = image_a && image_b && size_a == size_b && memcmp(image_a, image_b, size_a) == 0;
+
+    free(image_a);
+    free(image_b);
+    return same;
+}
+
+// 增量结果与对 source 完整解析一致
+static bool matches_full_parse(const CnAstProgram *program, const char *source)
+{
+    CnAstProgram *fresh = parse_full(source, NULL, NULL);
+    bool same = fresh && same_tree(program, fresh);
+
+    cn_frontend_ast_program_free(fresh);
+    return same;
+}
+
+static size_t offset_of(const char *text, const char *needle)
+{
+    const char *found = strstr(text, needle);
+    return found ? (size_t)(found - text) : 0;
+}
+
+static void test_edit_inside_body(void)
+{
+    printf("测试：函数体内的编辑\n");
+
+    CnParseItemList items = {0};
+    Texts texts = {{0}, 0};
+    CnAstProgram *program = parse_full(g_source, &items, NULL);
+    CnAstFunctionDecl *first;
+    CnAstFunctionDecl *third;
+    const char *text;
+    size_t offset;
+
+    TEST_ASSERT(program && items.reusable && items.count == 7, "完整解析未记录顶层声明");
+    first = program->functions[0];
+    third = program->functions[2];
+
+    // 只改动第二个函数体内的一个表达式
+    offset = offset_of(g_source, "总和 + i");
+    text = apply_edit(&texts, g_source, offset, strlen("总和 + i"), "总和 + i * 2");
+    TEST_ASSERT(parse_incremental(program, &items, text, offset, strlen("总和 + i"), strlen("总和 + i * 2")),
+                "函数体内的编辑应能增量解析");
+    TEST_ASSERT(matches_full_parse(program, text), "增量解析的树与完整解析不一致");
+    TEST_ASSERT(program->functions[0] == first && program->functions[2] == third, "未受影响的函数应原样复用");
+    TEST_ASSERT(program->import_count == 1 && program->struct_count == 1 && program->global_var_count == 1,
+                "其他顶层声明丢失");
+
+    cn_frontend_ast_program_free(program);
+    cn_frontend_parse_item_list_free(&items);
+    texts_free(&texts);
+    TEST_PASS("函数体内的编辑");
+}
+
+static void test_line_shift(void)
+{
+    printf("测试：插入与删除行后的位置平移\n");
+
+    CnParseItemList items = {0};
+    Texts texts = {{0}, 0};
+    CnAstProgram *program = parse_full(g_source, &items, NULL);
+    CnAstFunctionDecl *second;
+    CnAstFunctionDecl *fourth;
+    const char *text;
+    size_t offset;
+    int old_line;
+
+    TEST_ASSERT(program != NULL, "解析失败");
+    fourth = program->functions[3];
+    old_line = fourth->body->stmts[0]->as.expr.expr->loc.line;
+    TEST_ASSERT(old_line == 15, "赋值表达式缺少行号");
+
+    // 在第一个函数中插入两行，其后的声明整体下移
+    offset = offset_of(g_source, "    返回 a + 1;");
+    text = apply_edit(&texts, g_source, offset, 0, "    a = a * 2;\n    a = a - 1;\n");
+    TEST_ASSERT(parse_incremental(program, &items, text, offset, 0, strlen("    a = a * 2;\n    a = a - 1;\n")),
+                "插入行应能增量解析");
+    TEST_ASSERT(program->functions[3] == fourth, "编辑点之后的函数应原样复用");
+    TEST_ASSERT(fourth->body->stmts[0]->as.expr.expr->loc.line == old_line + 2, "复用声明的行号未平移");
+    TEST_ASSERT(matches_full_parse(program, text), "增量解析的树与完整解析不一致");
+
+    // 在增量结果上继续编辑：删除刚插入的一行
+    offset = offset_of(text, "    a = a - 1;\n");
+    text = apply_edit(&texts, text, offset, strlen("    a = a - 1;\n"), "");
+    TEST_ASSERT(parse_incremental(program, &items, text, offset, strlen("    a = a - 1;\n"), 0), "连续编辑应能增量解析");
+    TEST_ASSERT(fourth->body->stmts[0]->as.expr.expr->loc.line == old_line + 1, "连续编辑后行号不正确");
+    TEST_ASSERT(matches_full_parse(program, text), "连续编辑后的树与完整解析不一致");
+
+    // 在文件末尾追加函数（紧邻的最后一个声明一并重新解析）
+    second = program->functions[1];
+    offset = strlen(text);
+    text = apply_edit(&texts, text, offset, 0, "函数 第五() {}\n");
+    TEST_ASSERT(parse_incremental(program, &items, text, offset, 0, strlen("函数 第五() {}\n")), "末尾追加应能增量解析");
+    TEST_ASSERT(program->function_count == 5 && program->functions[1] == second, "追加的函数未加入程序");
+    TEST_ASSERT(matches_full_parse(program, text), "追加后的树与完整解析不一致");
+
+    cn_frontend_ast_program_free(program);
+    cn_frontend_parse_item_list_free(&items);
+    texts_free(&texts);
+    TEST_PASS("插入与删除行后的位置平移");
+}
+
+static void test_fallback(void)
+{
+    printf("测试：放弃增量解析的情形\n");
+
+    CnParseItemList items = {0};
+    Texts texts = {{0}, 0};
+    CnAstProgram *program = parse_full(g_source, &items, NULL);
+    CnAstProgram *original = parse_full(g_source, NULL, NULL);
+    CnDiagnostics diagnostics;
+    CnAstProgram *broken;
+    const char *text;
+    size_t offset;
+
+    TEST_ASSERT(program && original, "解析失败");
+
+    // 编辑引入语法错误：放弃增量解析，AST 不变
+    offset = offset_of(g_source, "    返回 总和;") + strlen("    返回 总和");
+    text = apply_edit(&texts, g_source, offset, 1, "");
+    TEST_ASSERT(!parse_incremental(program, &items, text, offset, 1, 0), "语法错误不应增量解析");
+    TEST_ASSERT(same_tree(program, original), "增量解析失败后 AST 被修改");
+
+    // 插入可见性标签会改变后续未重新解析的声明的可见性
+    offset = offset_of(g_source, "函数 第一");
+    text = apply_edit(&texts, g_source, offset, 0, "公开:\n");
+    TEST_ASSERT(!parse_incremental(program, &items, text, offset, 0, strlen("公开:\n")), "可见性变化不应增量解析");
+    TEST_ASSERT(same_tree(program, original), "增量解析失败后 AST 被修改");
+
+    // 带诊断的完整解析结果不能作为增量解析的基础
+    cn_support_diagnostics_init(&diagnostics);
+    cn_frontend_parse_item_list_free(&items);
+    broken = parse_full("函数 坏() { 返回 0 }\n", &items, &diagnostics);
+    TEST_ASSERT(diagnostics.count > 0 && !items.reusable, "有错误的解析不应可复用");
+    TEST_ASSERT(!parse_incremental(broken, &items, "函数 坏() { 返回 0; }\n",
+                                   strlen("函数 坏() { 返回 0"), 0, 1),
+                "有错误的基础不应增量解析");
+    cn_frontend_ast_program_free(broken);
+    cn_support_diagnostics_free(&diagnostics);
+
+    cn_frontend_ast_program_free(program);
+    cn_frontend_ast_program_free(original);
+    cn_frontend_parse_item_list_free(&items);
+    texts_free(&texts);
+    TEST_PASS("放弃增量解析的情形");
+}
+
+int main(void)
+{
+    printf("========================================\n");
+    printf("增量解析测试\n");
+    printf("========================================\n\n");
+
+    test_edit_inside_body();
+    test_line_shift();
+    test_fallback();
+
+    printf("\n========================================\n");
+    printf("测试结果: %d 通过, %d 失败\n", tests_passed, tests_failed);
+    printf("========================================\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
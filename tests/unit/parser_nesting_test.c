@@ -0,0 +1,335 @@
+#include "cnlang/frontend/lexer.h"
+#include "cnlang/frontend/parser.h"
+#include "cnlang/frontend/ast.h"
+#include "cnlang/frontend/ast_cache.h"
+#include "cnlang/support/diagnostics.h"
+#include "test_support.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * 深层嵌套测试
+ *
+ * 十万项的左结合运算链与十万段 "否则 如果" 链按循环解析与遍历，
+ * 经语义分析、IR 生成与 C 代码生成不耗尽调用栈；
+ * 括号与代码块的嵌套超过上限时报告诊断并继续解析。
+ */
+
+#define DEEP_COUNT 100000
+
+#define OUTPUT_PATH "parser_nesting_test_out.c"
+
+// ============================================================================
+// 测试统计
+// ============================================================================
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+typedef struct SourceBuffer {
+    char *data;
+    size_t length;
+    size_t capacity;
+} SourceBuffer;
+
+static void source_append(SourceBuffer *buffer, const char *format, ...)
+{
+    va_list args;
+    int written;
+
+    if (!buffer->data) {
+        return;
+    }
+    for (;;) {
+        va_start(args, format);
+        written = vsnprintf(buffer->data + buffer->length, buffer->capacity - buffer->length, format, args);
+        va_end(args);
+        if (written < 0) {
+            return;
+        }
+        if (buffer->length + (size_t)written < buffer->capacity) {
+            buffer->length += (size_t)written;
+            return;
+        }
+        char *grown = (char *)realloc(buffer->data, buffer->capacity * 2 + (size_t)written);
+        if (!grown) {
+            free(buffer->data);
+            buffer->data = NULL;
+            return;
+        }
+        buffer->data = grown;
+        buffer->capacity = buffer->capacity * 2 + (size_t)written;
+    }
+}
+
+static void source_init(SourceBuffer *buffer)
+{
+    buffer->capacity = 4096;
+    buffer->length = 0;
+    buffer->data = (char *)malloc(buffer->capacity);
+    if (buffer->data) {
+        buffer->data[0] = '\0';
+    }
+}
+
+// "返回 a + a + ... ;"（count 项），op 为运算符
+static char *make_chain_source(const char *op, size_t count)
+{
+    SourceBuffer buffer;
+
+    source_init(&buffer);
+    source_append(&buffer, "函数 求值(整数 a) -> 整数 {\n    返回 a");
+    for (size_t i = 1; i < count; i++) {
+        source_append(&buffer, " %s a", op);
+    }
+    source_append(&buffer, ";\n}\n");
+    return buffer.data;
+}
+
+// "如果 ... 否则 如果 ..." 共 count 段
+static char *make_else_if_source(size_t count)
+{
+    SourceBuffer buffer;
+
+    source_init(&buffer);
+    source_append(&buffer, "函数 求值(整数 a) -> 整数 {\n    如果 (a == 0) { 返回 0; }\n");
+    for (size_t i = 1; i < count; i++) {
+        source_append(&buffer, "    否则 如果 (a == %zu) { 返回 %zu; }\n", i, i);
+    }
+    source_append(&buffer, "    否则 { 返回 -1; }\n    返回 0;\n}\n");
+    return buffer.data;
+}
+
+// depth 层括号，或 depth 层嵌套的如果语句代码块
+static char *make_nested_source(size_t depth, bool blocks)
+{
+    SourceBuffer buffer;
+
+    source_init(&buffer);
+    source_append(&buffer, "函数 求值(整数 a) -> 整数 {\n    %s", blocks ? "" : "a = ");
+    for (size_t i = 0; i < depth; i++) {
+        source_append(&buffer, blocks ? "如果 (a > 0) { " : "(");
+    }
+    source_append(&buffer, blocks ? "a = a - 1;" : "a + 1");
+    for (size_t i = 0; i < depth; i++) {
+        source_append(&buffer, blocks ? " }" : ")");
+    }
+    source_append(&buffer, "%s\n    返回 a;\n}\n", blocks ? "" : ";");
+    return buffer.data;
+}
+
+// 解析到 compilation->program；有语法错误时仍保留恢复出的程序，由调用方检查诊断
+static void parse(CnTestCompilation *compilation, const char *source, size_t max_nesting)
+{
+    CnLexer lexer;
+    CnParser *parser;
+
+    cn_test_compilation_init(compilation);
+    cn_frontend_lexer_init(&lexer, source, strlen(source), "<nesting>");
+    parser = cn_frontend_parser_new(&lexer);
+    if (!parser) {
+        return;
+    }
+    cn_frontend_parser_set_diagnostics(parser, &compilation->diagnostics);
+    cn_frontend_parser_set_max_nesting(parser, max_nesting);
+    cn_frontend_parse_program(parser, &compilation->program);
+    cn_frontend_parser_free(parser);
+}
+
+// 语义分析、IR 生成与 C 代码生成，返回生成的 C 代码
+static char *compile_to_c(CnTestCompilation *compilation)
+{
+    if (!cn_test_compile_program(compilation)) {
+        return NULL;
+    }
+    return cn_test_generate_c(compilation->ir_module, OUTPUT_PATH);
+}
+
+static size_t count_occurrences(const char *text, const char *needle)
+{
+    size_t count = 0;
+    size_t needle_length = strlen(needle);
+
+    for (const char *p = strstr(text, needle); p; p = strstr(p + needle_length, needle)) {
+        count++;
+    }
+    return count;
+}
+
+static CnAstExpr *return_expr(CnAstProgram *program)
+{
+    CnAstBlockStmt *body = program->functions[0]->body;
+    CnAstStmt *stmt = body->stmts[body->stmt_count - 1];
+
+    return stmt->kind == CN_AST_STMT_RETURN ? stmt->as.return_stmt.expr : NULL;
+}
+
+static void test_long_binary_chain(void)
+{
+    printf("测试：十万项加法链\n");
+
+    char *source = make_chain_source("+", DEEP_COUNT);
+    TEST_ASSERT(source != NULL, "内存不足");
+
+    CnTestCompilation compilation;
+    parse(&compilation, source, 0);
+    TEST_ASSERT(compilation.program != NULL && cn_support_diagnostics_error_count(&compilation.diagnostics) == 0,
+                "长加法链解析失败");
+
+    CnAstExpr *expr = return_expr(compilation.program);
+    CnAstExprChain chain;
+    TEST_ASSERT(expr && expr->kind == CN_AST_EXPR_BINARY, "返回值不是二元表达式");
+    TEST_ASSERT(cn_frontend_ast_expr_chain_collect(&chain, expr), "收集运算链失败");
+    size_t chain_count = chain.count;
+    bool leaf_ok = cn_frontend_ast_expr_chain_leaf(&chain)->kind == CN_AST_EXPR_IDENTIFIER;
+    bool right_ok = cn_frontend_ast_expr_chain_right(&chain, 0)->kind == CN_AST_EXPR_IDENTIFIER;
+    cn_frontend_ast_expr_chain_free(&chain);
+    TEST_ASSERT(chain_count == DEEP_COUNT - 1, "运算链长度不正确");
+    TEST_ASSERT(leaf_ok, "链底不是标识符");
+    TEST_ASSERT(right_ok, "右操作数不是标识符");
+
+    // AST 缓存映像往返
+    size_t length = strlen(source);
+    uint64_t key = cn_ast_cache_key(source, length);
+    size_t image_size = 0;
+    size_t again_size = 0;
+    void *image = cn_ast_cache_serialize(compilation.program, key, length, &image_size);
+    CnAstProgram *loaded = image ? cn_ast_cache_deserialize(image, image_size, key, length, "<cache>") : NULL;
+    void *again = loaded ? cn_ast_cache_serialize(loaded, key, length, &again_size) : NULL;
+    bool loaded_ok = loaded != NULL;
+    bool same_image = again != NULL && again_size == image_size && memcmp(again, image, image_size) == 0;
+    free(again);
+    cn_frontend_ast_program_free(loaded);
+    free(image);
+    TEST_ASSERT(loaded_ok, "长运算链缓存往返失败");
+    TEST_ASSERT(same_image, "长运算链重建后再序列化不一致");
+
+    char *c_code = compile_to_c(&compilation);
+    TEST_ASSERT(c_code != NULL, "长加法链编译失败");
+    TEST_ASSERT(count_occurrences(c_code, " + ") >= DEEP_COUNT - 1, "生成代码缺少加法");
+
+    free(c_code);
+    cn_test_compilation_free(&compilation);
+    free(source);
+    TEST_PASS("十万项加法链");
+}
+
+static void test_long_logical_chain(void)
+{
+    printf("测试：十万项逻辑与链\n");
+
+    char *source = make_chain_source("&&", DEEP_COUNT);
+    TEST_ASSERT(source != NULL, "内存不足");
+
+    CnTestCompilation compilation;
+    parse(&compilation, source, 0);
+    TEST_ASSERT(compilation.program != NULL && cn_support_diagnostics_error_count(&compilation.diagnostics) == 0,
+                "长逻辑与链解析失败");
+
+    CnAstExpr *expr = return_expr(compilation.program);
+    TEST_ASSERT(expr && expr->kind == CN_AST_EXPR_LOGICAL, "返回值不是逻辑表达式");
+
+    char *c_code = compile_to_c(&compilation);
+    TEST_ASSERT(c_code != NULL, "长逻辑与链编译失败");
+
+    free(c_code);
+    cn_test_compilation_free(&compilation);
+    free(source);
+    TEST_PASS("十万项逻辑与链");
+}
+
+static void test_long_else_if_chain(void)
+{
+    printf("测试：十万段否则如果链\n");
+
+    char *source = make_else_if_source(DEEP_COUNT);
+    TEST_ASSERT(source != NULL, "内存不足");
+
+    CnTestCompilation compilation;
+    parse(&compilation, source, 0);
+    TEST_ASSERT(compilation.program != NULL && cn_support_diagnostics_error_count(&compilation.diagnostics) == 0,
+                "长否则如果链解析失败");
+
+    CnAstStmt *stmt = compilation.program->functions[0]->body->stmts[0];
+    size_t segments = 0;
+    while (stmt && stmt->kind == CN_AST_STMT_IF) {
+        segments++;
+        stmt = cn_frontend_ast_else_if(&stmt->as.if_stmt);
+    }
+    TEST_ASSERT(segments == DEEP_COUNT, "否则如果链段数不正确");
+
+    char *c_code = compile_to_c(&compilation);
+    TEST_ASSERT(c_code != NULL, "长否则如果链编译失败");
+    TEST_ASSERT(strstr(c_code, "99999") != NULL, "生成代码缺少最后一段");
+
+    free(c_code);
+    cn_test_compilation_free(&compilation);
+    free(source);
+    TEST_PASS("十万段否则如果链");
+}
+
+static void test_nesting_limit(void)
+{
+    printf("测试：嵌套深度上限\n");
+
+    CnTestCompilation compilation;
+    char *source;
+    bool ok;
+
+    // 默认上限以内正常解析
+    source = make_nested_source(CN_PARSER_DEFAULT_MAX_NESTING / 2, false);
+    TEST_ASSERT(source != NULL, "内存不足");
+    parse(&compilation, source, 0);
+    ok = compilation.program != NULL && cn_support_diagnostics_error_count(&compilation.diagnostics) == 0;
+    cn_test_compilation_free(&compilation);
+    TEST_ASSERT(ok, "上限以内的括号嵌套解析失败");
+
+    // 自定义上限低于嵌套层数时报错
+    parse(&compilation, source, 16);
+    ok = cn_test_has_diagnostic(&compilation.diagnostics, CN_DIAG_CODE_PARSE_NESTING_TOO_DEEP);
+    cn_test_compilation_free(&compilation);
+    free(source);
+    TEST_ASSERT(ok, "自定义上限未生效");
+
+    // 十万层括号与代码块：报告一条嵌套过深错误，不耗尽调用栈
+    for (int blocks = 0; blocks <= 1; blocks++) {
+        size_t count = 0;
+
+        source = make_nested_source(DEEP_COUNT, blocks != 0);
+        TEST_ASSERT(source != NULL, "内存不足");
+        parse(&compilation, source, 0);
+        for (size_t i = 0; i < compilation.diagnostics.count; i++) {
+            if (compilation.diagnostics.items[i].code == CN_DIAG_CODE_PARSE_NESTING_TOO_DEEP) {
+                count++;
+            }
+        }
+        ok = compilation.program != NULL && compilation.program->function_count == 1;
+        cn_test_compilation_free(&compilation);
+        free(source);
+        TEST_ASSERT(count == 1, blocks ? "深层代码块未报告嵌套过深" : "深层括号未报告嵌套过深");
+        TEST_ASSERT(ok, "越过过深嵌套后未继续解析");
+    }
+
+    TEST_PASS("嵌套深度上限");
+}
+
+int main(void)
+{
+    printf("========================================\n");
+    printf("深层嵌套测试\n");
+    printf("========================================\n\n");
+
+    test_long_binary_chain();
+    test_long_logical_chain();
+    test_long_else_if_chain();
+    test_nesting_limit();
+
+    printf("\n========================================\n");
+    printf("测试结果: %d 通过, %d 失败\n", tests_passed, tests_failed);
+    printf("========================================\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
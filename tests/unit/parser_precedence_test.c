@@ -0,0 +1,212 @@
+#include "cnlang/frontend/lexer.h"
+#include "cnlang/frontend/parser.h"
+#include "cnlang/frontend/ast.h"
+#include "test_support.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * 表达式优先级与结合性测试
+ *
+ * 把每条表达式语句的 AST 序列化为前缀形式，与期望的树形逐一比较，
+ * 覆盖全部中缀优先级、右结合的赋值/三元运算符以及一元运算符。
+ */
+
+// ============================================================================
+// 测试统计
+// ============================================================================
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static const char *binary_op_name(CnAstBinaryOp op)
+{
+    switch (op) {
+    case CN_AST_BINARY_OP_ADD: return "+";
+    case CN_AST_BINARY_OP_SUB: return "-";
+    case CN_AST_BINARY_OP_MUL: return "*";
+    case CN_AST_BINARY_OP_DIV: return "/";
+    case CN_AST_BINARY_OP_MOD: return "%";
+    case CN_AST_BINARY_OP_EQ: return "==";
+    case CN_AST_BINARY_OP_NE: return "!=";
+    case CN_AST_BINARY_OP_LT: return "<";
+    case CN_AST_BINARY_OP_GT: return ">";
+    case CN_AST_BINARY_OP_LE: return "<=";
+    case CN_AST_BINARY_OP_GE: return ">=";
+    case CN_AST_BINARY_OP_BITWISE_AND: return "&";
+    case CN_AST_BINARY_OP_BITWISE_OR: return "|";
+    case CN_AST_BINARY_OP_BITWISE_XOR: return "^";
+    case CN_AST_BINARY_OP_LEFT_SHIFT: return "<<";
+    case CN_AST_BINARY_OP_RIGHT_SHIFT: return ">>";
+    }
+    return "?op";
+}
+
+static const char *unary_op_name(CnAstUnaryOp op)
+{
+    switch (op) {
+    case CN_AST_UNARY_OP_NOT: return "!";
+    case CN_AST_UNARY_OP_MINUS: return "neg";
+    case CN_AST_UNARY_OP_ADDRESS_OF: return "addr";
+    case CN_AST_UNARY_OP_DEREFERENCE: return "deref";
+    case CN_AST_UNARY_OP_BITWISE_NOT: return "~";
+    case CN_AST_UNARY_OP_PRE_INC: return "++";
+    case CN_AST_UNARY_OP_PRE_DEC: return "--";
+    case CN_AST_UNARY_OP_POST_INC: return "post++";
+    case CN_AST_UNARY_OP_POST_DEC: return "post--";
+    }
+    return "?op";
+}
+
+static void append(char *out, size_t size, const char *text)
+{
+    size_t used = strlen(out);
+    if (used + 1 < size) {
+        snprintf(out + used, size - used, "%s", text);
+    }
+}
+
+// 以前缀形式输出表达式树，例如 (+ a (* b c))
+static void render(const CnAstExpr *expr, char *out, size_t size)
+{
+    char buffer[64];
+
+    if (!expr) {
+        append(out, size, "<null>");
+        return;
+    }
+
+    switch (expr->kind) {
+    case CN_AST_EXPR_IDENTIFIER:
+        snprintf(buffer, sizeof(buffer), "%.*s",
+                 (int)expr->as.identifier.name_length, expr->as.identifier.name);
+        append(out, size, buffer);
+        return;
+    case CN_AST_EXPR_INTEGER_LITERAL:
+        snprintf(buffer, sizeof(buffer), "%ld", expr->as.integer_literal.value);
+        append(out, size, buffer);
+        return;
+    case CN_AST_EXPR_BINARY:
+        append(out, size, "(");
+        append(out, size, binary_op_name(expr->as.binary.op));
+        append(out, size, " ");
+        render(expr->as.binary.left, out, size);
+        append(out, size, " ");
+        render(expr->as.binary.right, out, size);
+        append(out, size, ")");
+        return;
+    case CN_AST_EXPR_LOGICAL:
+        append(out, size, expr->as.logical.op == CN_AST_LOGICAL_OP_AND ? "(&& " : "(|| ");
+        render(expr->as.logical.left, out, size);
+        append(out, size, " ");
+        render(expr->as.logical.right, out, size);
+        append(out, size, ")");
+        return;
+    case CN_AST_EXPR_UNARY:
+        append(out, size, "(");
+        append(out, size, unary_op_name(expr->as.unary.op));
+        append(out, size, " ");
+        render(expr->as.unary.operand, out, size);
+        append(out, size, ")");
+        return;
+    case CN_AST_EXPR_ASSIGN:
+        append(out, size, "(= ");
+        render(expr->as.assign.target, out, size);
+        append(out, size, " ");
+        render(expr->as.assign.value, out, size);
+        append(out, size, ")");
+        return;
+    case CN_AST_EXPR_TERNARY:
+        append(out, size, "(? ");
+        render(expr->as.ternary.condition, out, size);
+        append(out, size, " ");
+        render(expr->as.ternary.true_expr, out, size);
+        append(out, size, " ");
+        render(expr->as.ternary.false_expr, out, size);
+        append(out, size, ")");
+        return;
+    default:
+        append(out, size, "<expr>");
+        return;
+    }
+}
+
+typedef struct {
+    const char *statement;
+    const char *expected;
+} PrecedenceCase;
+
+static const PrecedenceCase g_cases[] = {
+    {"x = a + b * c - d;", "(= x (- (+ a (* b c)) d))"},
+    {"x = a / b / c % d;", "(= x (% (/ (/ a b) c) d))"},
+    {"x = a << 1 + b;", "(= x (<< a (+ 1 b)))"},
+    {"x = a << b >> c < d;", "(= x (< (>> (<< a b) c) d))"},
+    {"x = a < b == c > d;", "(= x (> (== (< a b) c) d))"},
+    {"x = a & b == c | d ^ e;", "(= x (| (& a (== b c)) (^ d e)))"},
+    {"x = a | b ^ c & d;", "(= x (| a (^ b (& c d))))"},
+    {"x = a || b && c || d;", "(= x (|| (|| a (&& b c)) d))"},
+    {"x = a > 0 && a < 10 || !f;", "(= x (|| (&& (> a 0) (< a 10)) (! f)))"},
+    {"x = y = z;", "(= x (= y z))"},
+    {"x = a ? b : c ? d : e;", "(= x (? a b (? c d e)))"},
+    {"x = a || b ? c + 1 : d * 2;", "(= x (? (|| a b) (+ c 1) (* d 2)))"},
+    {"x = a ? y = 1 : c;", "(= x (? a (= y 1) c))"},
+    {"a ? b : c = d;", "(= (? a b c) d)"},
+    {"x = -a * !b - ~c % *p;", "(= x (- (* (neg a) (! b)) (% (~ c) (deref p))))"},
+    {"x = --a + ++b;", "(= x (+ (-- a) (++ b)))"},
+    {"x = (a + b) * (c - d);", "(= x (* (+ a b) (- c d)))"},
+};
+
+static void check_case(const PrecedenceCase *test_case)
+{
+    char source[256];
+    char actual[512];
+    CnLexer lexer;
+    CnParser *parser;
+    CnAstProgram *program = NULL;
+    const CnAstStmt *stmt;
+
+    printf("测试：%s\n", test_case->statement);
+
+    snprintf(source, sizeof(source), "函数 测试() { %s }", test_case->statement);
+    cn_frontend_lexer_init(&lexer, source, strlen(source), "<memory>");
+    parser = cn_frontend_parser_new(&lexer);
+    TEST_ASSERT(parser != NULL, "创建解析器失败");
+
+    bool parsed = cn_frontend_parse_program(parser, &program);
+    cn_frontend_parser_free(parser);
+    TEST_ASSERT(parsed && program && program->function_count == 1 && program->functions[0]->body &&
+                program->functions[0]->body->stmt_count == 1,
+                "解析失败");
+
+    stmt = program->functions[0]->body->stmts[0];
+    actual[0] = '\0';
+    if (stmt->kind == CN_AST_STMT_EXPR) {
+        render(stmt->as.expr.expr, actual, sizeof(actual));
+    }
+    cn_frontend_ast_program_free(program);
+
+    if (strcmp(actual, test_case->expected) != 0) {
+        printf("    期望: %s\n    实际: %s\n", test_case->expected, actual);
+    }
+    TEST_ASSERT(strcmp(actual, test_case->expected) == 0, "表达式树与期望不一致");
+    TEST_PASS(test_case->expected);
+}
+
+int main(void)
+{
+    printf("========================================\n");
+    printf("表达式优先级与结合性测试\n");
+    printf("========================================\n\n");
+
+    for (size_t i = 0; i < sizeof(g_cases) / sizeof(g_cases[0]); i++) {
+        check_case(&g_cases[i]);
+    }
+
+    printf("\n========================================\n");
+    printf("测试结果: %d 通过, %d 失败\n", tests_passed, tests_failed);
+    printf("========================================\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
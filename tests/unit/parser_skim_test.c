@@ -0,0 +1,268 @@
+#include "cnlang/frontend/lexer.h"
+#include "cnlang/frontend/preprocessor.h"
+#include "cnlang/frontend/parser.h"
+#include "cnlang/frontend/ast.h"
+#include "cnlang/frontend/ast_cache.h"
+#include "cnlang/ir/irgen.h"
+#include "cnlang/support/diagnostics.h"
+#include "test_support.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * 跳读模式测试
+ *
+ * 跳读得到的函数只有签名与函数体词元；按需解析后，整棵树序列化的映像
+ * 与完整解析逐字节相同。函数体内的语法错误推迟到解析函数体时报告，
+ * 花括号不配对在跳读时即报告。
+ */
+
+// ============================================================================
+// 测试统计
+// ============================================================================
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+static const char *g_source =
+    "结构体 点 { 整数 x; 整数 y; }\n"
+    "公开:\n"
+    "函数 声明(整数 a) -> 整数;\n"
+    "函数 求和(整数 n) -> 整数 {\n"
+    "    变量 总和 = 0;\n"
+    "    循环 (变量 i = 0; i < n; i++) {\n"
+    "        如果 (i % 2 == 0) { 总和 = 总和 + i; } 否则 { 继续; }\n"
+    "    }\n"
+    "    返回 总和;\n"
+    "}\n"
+    "模板<T> 函数 最大(T a, T b) { 返回 a > b ? a : b; }\n"
+    "函数 构造() {\n"
+    "    变量 p = 点 { x: 1, y: 2 };\n"
+    "    变量 数据 = [1, 2, 3];\n"
+    "    打印(\"{ 不是花括号 }\");\n"
+    "    返回 p.x + 数据[0];\n"
+    "}\n"
+    "私有:\n"
+    "函数 空() {}\n";
+
+static CnAstProgram *parse_with_lexer(const char *source, bool skim, CnDiagnostics *diagnostics, bool *out_ok)
+{
+    CnLexer lexer;
+    CnParser *parser;
+    CnAstProgram *program = NULL;
+    bool ok;
+
+    cn_frontend_lexer_init(&lexer, source, strlen(source), "<skim>");
+    parser = cn_frontend_parser_new(&lexer);
+    if (!parser) {
+        return NULL;
+    }
+    cn_frontend_parser_set_diagnostics(parser, diagnostics);
+    cn_frontend_parser_set_skim_bodies(parser, skim);
+    ok = cn_frontend_parse_program(parser, &program);
+    cn_frontend_parser_free(parser);
+    if (out_ok) {
+        *out_ok = ok;
+    }
+    return program;
+}
+
+// 两棵树序列化后逐字节相同即结构一致
+static bool same_tree(const CnAstProgram *a, const CnAstProgram *b)
+{
+    size_t size_a = 0;
+    size_t size_b = 0;
+    void *image_a = cn_ast_cache_serialize(a, 1, 1, &size_a);
+    void *image_b = cn_ast_cache_serialize(b, 1, 1, &size_b);
+    bool same = image_a && image_b && size_a == size_b && memcmp(image_a, image_b, size_a) == 0;
+
+    free(image_a);
+    free(image_b);
+    return same;
+}
+
+static void test_skim_then_parse(void)
+{
+    printf("测试：跳读后按需解析\n");
+
+    CnAstProgram *eager = parse_with_lexer(g_source, false, NULL, NULL);
+    CnAstProgram *skimmed = parse_with_lexer(g_source, true, NULL, NULL);
+    size_t image_size = 0;
+    bool skimmed_ok = true;
+
+    TEST_ASSERT(eager && skimmed, "解析失败");
+    TEST_ASSERT(skimmed->function_count == eager->function_count && skimmed->function_count == 4, "函数数量不一致");
+    TEST_ASSERT(skimmed->struct_count == 1 && skimmed->template_func_count == 1, "顶层声明丢失");
+    for (size_t i = 0; i < skimmed->function_count; i++) {
+        const CnAstFunctionDecl *fn = skimmed->functions[i];
+        const CnAstFunctionDecl *expected = eager->functions[i];
+        skimmed_ok = skimmed_ok && fn->body == NULL &&
+                     (fn->is_prototype ? fn->lazy_body == NULL : fn->lazy_body != NULL) &&
+                     fn->name == expected->name &&
+                     fn->parameter_count == expected->parameter_count &&
+                     fn->visibility == expected->visibility;
+    }
+    TEST_ASSERT(skimmed_ok, "跳读得到的函数签名或函数体不正确");
+
+    // 模板函数体在实例化时复制，始终完整解析
+    TEST_ASSERT(skimmed->template_funcs[0]->as.template_func_decl->function->body != NULL, "模板函数体不应跳读");
+
+    // 含未解析函数体的树不能写入 AST 缓存
+    TEST_ASSERT(cn_ast_cache_serialize(skimmed, 1, 1, &image_size) == NULL, "未解析的函数体被写入了映像");
+
+    // 单个函数按需解析，重复调用无副作用
+    TEST_ASSERT(cn_frontend_parse_function_body(skimmed->functions[1], NULL), "按需解析函数体失败");
+    TEST_ASSERT(skimmed->functions[1]->body && skimmed->functions[1]->lazy_body == NULL, "函数体未解析");
+    TEST_ASSERT(cn_frontend_parse_function_body(skimmed->functions[1], NULL), "重复解析应直接成功");
+    TEST_ASSERT(skimmed->functions[2]->body == NULL, "其他函数体不应被解析");
+
+    TEST_ASSERT(cn_frontend_parse_lazy_bodies(skimmed, NULL), "解析全部函数体失败");
+    TEST_ASSERT(same_tree(eager, skimmed), "按需解析的树与完整解析不一致");
+
+    cn_frontend_ast_program_free(eager);
+    cn_frontend_ast_program_free(skimmed);
+    TEST_PASS("跳读后按需解析");
+}
+
+// 导入模块路径：解析器从预处理器逐词元拉取
+static void test_skim_from_preprocessor(void)
+{
+    printf("测试：从预处理器跳读\n");
+
+    const char *source =
+        "#定义 上限 10\n"
+        "函数 计数() -> 整数 {\n"
+        "    变量 n = 0;\n"
+        "    当 (n < 上限) { n = n + 1; }\n"
+        "    返回 n;\n"
+        "}\n"
+        "函数 主程序() { 返回 计数(); }\n";
+    CnPreprocessor preprocessors[2];
+    CnAstProgram *programs[2] = {NULL, NULL};
+    bool parsed = true;
+
+    // AST 与函数体词元都引用预处理器的输出，预处理器在比较完成后再释放
+    for (int skim = 0; skim < 2; skim++) {
+        CnParser *parser;
+
+        cn_frontend_preprocessor_init(&preprocessors[skim], source, strlen(source), "<skim>");
+        parser = cn_frontend_parser_new_from_preprocessor(&preprocessors[skim]);
+        if (!parser) {
+            parsed = false;
+            continue;
+        }
+        cn_frontend_parser_set_skim_bodies(parser, skim != 0);
+        parsed = cn_frontend_parse_program(parser, &programs[skim]) && parsed;
+        cn_frontend_parser_free(parser);
+    }
+
+    TEST_ASSERT(parsed && programs[0] && programs[1], "解析失败");
+    TEST_ASSERT(programs[1]->functions[0]->lazy_body != NULL, "函数体未被跳读");
+    TEST_ASSERT(cn_frontend_parse_lazy_bodies(programs[1], NULL), "解析全部函数体失败");
+    TEST_ASSERT(same_tree(programs[0], programs[1]), "按需解析的树与完整解析不一致");
+
+    for (int i = 0; i < 2; i++) {
+        cn_frontend_ast_program_free(programs[i]);
+        cn_frontend_preprocessor_free(&preprocessors[i]);
+    }
+    TEST_PASS("从预处理器跳读");
+}
+
+static void test_deferred_errors(void)
+{
+    printf("测试：推迟报告的语法错误\n");
+
+    const char *bad_body =
+        "函数 正常() { 返回 1; }\n"
+        "函数 错误() {\n"
+        "    返回 0\n"
+        "}\n";
+    const char *unbalanced = "函数 未闭合() { 如果 (1) { 返回 0; }\n";
+    CnDiagnostics diagnostics;
+    CnAstProgram *program;
+    bool ok = false;
+
+    // 函数体内的语法错误在按需解析时报告
+    cn_support_diagnostics_init(&diagnostics);
+    program = parse_with_lexer(bad_body, true, &diagnostics, &ok);
+    TEST_ASSERT(program && ok && diagnostics.count == 0, "跳读不应报告函数体内的错误");
+    TEST_ASSERT(cn_frontend_parse_function_body(program->functions[0], &diagnostics), "正常函数体解析失败");
+    TEST_ASSERT(!cn_frontend_parse_function_body(program->functions[1], &diagnostics), "语法错误未被发现");
+    TEST_ASSERT(diagnostics.count > 0 && diagnostics.items[0].line == 4, "语法错误的位置不正确");
+    TEST_ASSERT(program->functions[1]->body != NULL, "出错时应保留恢复出的部分函数体");
+    cn_frontend_ast_program_free(program);
+    cn_support_diagnostics_free(&diagnostics);
+
+    // 花括号不配对在跳读时报告
+    cn_support_diagnostics_init(&diagnostics);
+    program = parse_with_lexer(unbalanced, true, &diagnostics, &ok);
+    TEST_ASSERT(!ok && diagnostics.count > 0, "缺少 '}' 未被报告");
+    cn_frontend_ast_program_free(program);
+    cn_support_diagnostics_free(&diagnostics);
+
+    TEST_PASS("推迟报告的语法错误");
+}
+
+// 生成 IR 时才解析的函数体：语法错误报告到诊断信息，整个模块不生成 IR
+static void test_irgen_deferred_errors(void)
+{
+    printf("测试：生成 IR 时报告函数体错误\n");
+
+    const char *bad_body =
+        "函数 正常() { 返回 1; }\n"
+        "函数 错误() {\n"
+        "    返回 0\n"
+        "}\n";
+    CnTargetTriple target = cn_support_target_triple_make(
+        CN_TARGET_ARCH_X86_64, CN_TARGET_VENDOR_PC, CN_TARGET_OS_NONE, CN_TARGET_ABI_ELF);
+    CnDiagnostics diagnostics;
+    CnAstProgram *program;
+    CnIrModule *module;
+    bool ok = false;
+
+    cn_support_diagnostics_init(&diagnostics);
+    program = parse_with_lexer(bad_body, true, &diagnostics, &ok);
+    TEST_ASSERT(program && ok && diagnostics.count == 0, "跳读不应报告函数体内的错误");
+    module = cn_ir_gen_program_with_diagnostics(program, NULL, target, CN_COMPILE_MODE_HOSTED,
+                                                &diagnostics);
+    TEST_ASSERT(module == NULL, "函数体存在语法错误时不应生成 IR");
+    TEST_ASSERT(cn_support_diagnostics_error_count(&diagnostics) > 0, "语法错误未报告到诊断信息");
+    TEST_ASSERT(diagnostics.count > 0 && diagnostics.items[0].code == CN_DIAG_CODE_PARSE_EXPECTED_TOKEN &&
+                diagnostics.items[0].line == 4, "语法错误的错误码或位置不正确");
+    cn_frontend_ast_program_free(program);
+    cn_support_diagnostics_free(&diagnostics);
+
+    // 函数体无误时照常生成
+    cn_support_diagnostics_init(&diagnostics);
+    program = parse_with_lexer("函数 正常() { 返回 1; }\n", true, &diagnostics, &ok);
+    TEST_ASSERT(program && ok, "解析失败");
+    module = cn_ir_gen_program_with_diagnostics(program, NULL, target, CN_COMPILE_MODE_HOSTED,
+                                                &diagnostics);
+    TEST_ASSERT(module != NULL && module->first_func != NULL && diagnostics.count == 0,
+                "函数体按需解析后未生成 IR");
+    cn_ir_module_free(module);
+    cn_frontend_ast_program_free(program);
+    cn_support_diagnostics_free(&diagnostics);
+
+    TEST_PASS("生成 IR 时报告函数体错误");
+}
+
+int main(void)
+{
+    printf("========================================\n");
+    printf("跳读模式测试\n");
+    printf("========================================\n\n");
+
+    test_skim_then_parse();
+    test_skim_from_preprocessor();
+    test_deferred_errors();
+    test_irgen_deferred_errors();
+
+    printf("\n========================================\n");
+    printf("测试结果: %d 通过, %d 失败\n", tests_passed, tests_failed);
+    printf("========================================\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -227,6 +227,44 @@ static void test_perf_export_csv(void)
     printf("✓ test_perf_export_csv 通过\n");
 }
 
+/* 测试宏统计记录 */
+static void test_perf_macro_stats(void)
+{
+    CnPerfStats stats;
+    cn_perf_stats_init(&stats, "test.cn", 1024);
+
+    /* 未启用时不记录 */
+    cn_perf_record_macro_stats(&stats, 10, 20, 300);
+    assert(stats.macro_expansion_count == 0);
+
+    cn_perf_stats_set_enabled(&stats, true);
+    cn_perf_record_macro_stats(&stats, 10, 20, 300);
+    assert(stats.macro_count == 10);
+    assert(stats.macro_expansion_count == 20);
+    assert(stats.macro_expansion_time_us == 300);
+
+    printf("✓ test_perf_macro_stats 通过\n");
+}
+
+/* 测试模板缓存统计记录 */
+static void test_perf_template_stats(void)
+{
+    CnPerfStats stats;
+    cn_perf_stats_init(&stats, "test.cn", 1024);
+
+    /* 未启用时不记录 */
+    cn_perf_record_template_stats(&stats, 3, 7, 3);
+    assert(stats.template_cache_hits == 0);
+
+    cn_perf_stats_set_enabled(&stats, true);
+    cn_perf_record_template_stats(&stats, 3, 7, 3);
+    assert(stats.template_instance_count == 3);
+    assert(stats.template_cache_hits == 7);
+    assert(stats.template_cache_misses == 3);
+
+    printf("✓ test_perf_template_stats 通过\n");
+}
+
 int main(void)
 {
     printf("========== 性能分析模块单元测试 ==========\n\n");
@@ -241,6 +279,8 @@ int main(void)
     test_perf_print_stats();
     test_perf_export_json();
     test_perf_export_csv();
+    test_perf_macro_stats();
+    test_perf_template_stats();
 
     printf("\n========================================\n");
     printf("所有测试通过! ✓\n");
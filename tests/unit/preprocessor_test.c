@@ -279,6 +279,247 @@ static void test_empty_macro(void)
     printf("test_empty_macro: PASSED\n");
 }
 
+/* 测试无需预处理的源码直接引用输入（零拷贝） */
+static void test_passthrough(void)
+{
+    const char *plain =
+        "// 行注释\n"
+        "变量 x = 1;\n";
+    const char *with_block_comment =
+        "变量 x = /* 注释 */ 1;\n";
+
+    CnPreprocessor preprocessor;
+
+    cn_frontend_preprocessor_init(&preprocessor, plain, strlen(plain), "test.cn");
+    TEST_ASSERT(cn_frontend_preprocessor_process(&preprocessor), "预处理失败");
+    TEST_ASSERT(preprocessor.output_borrowed, "无指令源码应直接引用输入");
+    TEST_ASSERT(preprocessor.output == plain, "输出应指向输入缓冲区");
+    TEST_ASSERT(preprocessor.output_length == strlen(plain), "输出长度应与输入一致");
+    cn_frontend_preprocessor_free(&preprocessor);
+
+    /* 块注释仍由预处理器剥离，保持原有列号与诊断行为 */
+    cn_frontend_preprocessor_init(&preprocessor, with_block_comment, strlen(with_block_comment), "test.cn");
+    TEST_ASSERT(cn_frontend_preprocessor_process(&preprocessor), "预处理失败");
+    TEST_ASSERT(!preprocessor.output_borrowed, "含块注释的源码应生成新的输出");
+    TEST_ASSERT(strstr(preprocessor.output, "注释") == NULL, "块注释应被移除");
+    cn_frontend_preprocessor_free(&preprocessor);
+
+    printf("test_passthrough: PASSED\n");
+}
+
+/* 测试大量宏定义：哈希表扩容、#undef 后重建索引、函数宏模板展开与展开计数 */
+static void test_many_macros(void)
+{
+    enum { MACRO_COUNT = 500 };
+    size_t capacity = MACRO_COUNT * 96 + 256;
+    char *source = (char *)malloc(capacity);
+    size_t length = 0;
+    
+    TEST_ASSERT(source != NULL, "内存分配失败");
+    for (int i = 0; i < MACRO_COUNT; i++) {
+        length += (size_t)snprintf(source + length, capacity - length,
+                                   "#define 配置_%d %d\n#define 取_%d(甲, 乙) (甲 + 乙 * 配置_%d)\n",
+                                   i, i, i, i);
+    }
+    length += (size_t)snprintf(source + length, capacity - length,
+                               "#undef 配置_7\n"
+                               "a = 取_499(配置_3, f(1, 2));\n"
+                               "b = 配置_7 + 配置_8;\n"
+                               "#define 串(x) #x 与 # 非参\n"
+                               "c = 串( 你好 世界 );\n");
+    
+    CnPreprocessor preprocessor;
+    CnDiagnostics diagnostics;
+    
+    cn_support_diagnostics_init(&diagnostics);
+    cn_frontend_preprocessor_init(&preprocessor, source, length, "test.cn");
+    cn_frontend_preprocessor_set_diagnostics(&preprocessor, &diagnostics);
+    cn_frontend_preprocessor_set_collect_stats(&preprocessor, true);
+    
+    TEST_ASSERT(cn_frontend_preprocessor_process(&preprocessor), "预处理失败");
+    TEST_ASSERT(preprocessor.macro_count == MACRO_COUNT * 2, "#undef 后宏数量不正确");
+    TEST_ASSERT(preprocessor.macro_slot_count >= preprocessor.macro_count * 2, "宏表负载因子应不超过 1/2");
+    TEST_ASSERT(strstr(preprocessor.output, "a = (配置_3 + f(1, 2) * 配置_499);") != NULL, "函数宏应按模板拼接实参（展开结果不再重扫描）");
+    TEST_ASSERT(strstr(preprocessor.output, "b = 配置_7 + 8;") != NULL, "#undef 后的宏不应展开");
+    TEST_ASSERT(strstr(preprocessor.output, "c = \"你好 世界\" 与 ;") != NULL, "字符串化展开错误");
+    TEST_ASSERT(preprocessor.macro_expansion_count == 3, "宏展开次数应为 3");
+    TEST_ASSERT(cn_frontend_preprocessor_is_defined(&preprocessor, "配置_499", strlen("配置_499")),
+                "配置_499 应已定义");
+    TEST_ASSERT(!cn_frontend_preprocessor_is_defined(&preprocessor, "配置_7", strlen("配置_7")),
+                "配置_7 应已取消定义");
+    
+    cn_frontend_preprocessor_free(&preprocessor);
+    cn_support_diagnostics_free(&diagnostics);
+    free(source);
+    
+    printf("test_many_macros: PASSED\n");
+}
+
+/* 检查逐词元模式取出的词元种类、词素与位置 */
+static void expect_token(CnPreprocessor *preprocessor, CnTokenKind kind, const char *lexeme,
+                         int line, int column)
+{
+    CnToken token;
+    
+    TEST_ASSERT(cn_frontend_preprocessor_next_token(preprocessor, &token), "取词元失败");
+    if (token.kind != kind || token.line != line || token.column != column ||
+        token.lexeme_length != strlen(lexeme) ||
+        memcmp(token.lexeme_begin, lexeme, token.lexeme_length) != 0) {
+        fprintf(stderr, "期望 [%s] %d:%d, 实际 [%.*s] %d:%d (kind=%d)\n",
+                lexeme, line, column, (int)token.lexeme_length, token.lexeme_begin,
+                token.line, token.column, (int)token.kind);
+        TEST_ASSERT(0, "逐词元预处理结果不正确");
+    }
+}
+
+/* 测试逐词元模式：即时处理指令与条件编译，词元保留原始源码位置 */
+static void test_token_stream(void)
+{
+    const char *source =
+        "#define 上限 100\n"
+        "#define 加(a, b) (a + b)\n"
+        "/* 注释 */ 变量 x = 上限;\n"
+        "#ifdef 未定义宏\n"
+        "变量 丢弃 = 0;\n"
+        "#else\n"
+        "变量 y = 加(x, 2);\n"
+        "#endif\n"
+        "#undef 上限\n"
+        "x = 上限;\n";
+    
+    CnPreprocessor preprocessor;
+    CnDiagnostics diagnostics;
+    CnToken token;
+    
+    cn_support_diagnostics_init(&diagnostics);
+    cn_frontend_preprocessor_init(&preprocessor, source, strlen(source), "test.cn");
+    cn_frontend_preprocessor_set_diagnostics(&preprocessor, &diagnostics);
+    TEST_ASSERT(!cn_frontend_preprocessor_is_passthrough(&preprocessor), "含指令的源码需要预处理");
+    
+    expect_token(&preprocessor, CN_TOKEN_KEYWORD_VAR, "变量", 3, 14);
+    expect_token(&preprocessor, CN_TOKEN_IDENT, "x", 3, 21);
+    expect_token(&preprocessor, CN_TOKEN_EQUAL, "=", 3, 23);
+    expect_token(&preprocessor, CN_TOKEN_INTEGER, "100", 3, 25);
+    expect_token(&preprocessor, CN_TOKEN_SEMICOLON, ";", 3, 31);
+    
+    /* 宏展开出的词元使用宏调用位置 */
+    expect_token(&preprocessor, CN_TOKEN_KEYWORD_VAR, "变量", 7, 1);
+    expect_token(&preprocessor, CN_TOKEN_IDENT, "y", 7, 8);
+    expect_token(&preprocessor, CN_TOKEN_EQUAL, "=", 7, 10);
+    expect_token(&preprocessor, CN_TOKEN_LPAREN, "(", 7, 12);
+    expect_token(&preprocessor, CN_TOKEN_IDENT, "x", 7, 12);
+    expect_token(&preprocessor, CN_TOKEN_PLUS, "+", 7, 12);
+    expect_token(&preprocessor, CN_TOKEN_INTEGER, "2", 7, 12);
+    expect_token(&preprocessor, CN_TOKEN_RPAREN, ")", 7, 12);
+    expect_token(&preprocessor, CN_TOKEN_SEMICOLON, ";", 7, 21);
+    
+    /* #undef 之后按普通标识符输出 */
+    expect_token(&preprocessor, CN_TOKEN_IDENT, "x", 10, 1);
+    expect_token(&preprocessor, CN_TOKEN_EQUAL, "=", 10, 3);
+    expect_token(&preprocessor, CN_TOKEN_IDENT, "上限", 10, 5);
+    expect_token(&preprocessor, CN_TOKEN_SEMICOLON, ";", 10, 11);
+    
+    TEST_ASSERT(cn_frontend_preprocessor_next_token(&preprocessor, &token), "末尾应正常结束");
+    TEST_ASSERT(token.kind == CN_TOKEN_EOF, "末尾应为 EOF");
+    TEST_ASSERT(cn_frontend_preprocessor_next_token(&preprocessor, &token) && token.kind == CN_TOKEN_EOF,
+                "EOF 之后应继续返回 EOF");
+    TEST_ASSERT(!preprocessor.stream_failed, "不应出现预处理错误");
+    TEST_ASSERT(preprocessor.macro_expansion_count == 2, "宏展开次数应为 2");
+    TEST_ASSERT(preprocessor.output_capacity < strlen(source), "逐词元模式不应生成整份输出");
+    
+    cn_frontend_preprocessor_free(&preprocessor);
+    cn_support_diagnostics_free(&diagnostics);
+    
+    printf("test_token_stream: PASSED\n");
+}
+
+/* 测试逐词元模式的错误：未闭合的条件块与未知指令 */
+static void test_token_stream_errors(void)
+{
+    const char *unclosed = "#ifdef 未定义宏\n变量 a = 1;\n";
+    const char *unknown = "变量 a = 1;\n#未知指令\n变量 b = 2;\n";
+    
+    CnPreprocessor preprocessor;
+    CnDiagnostics diagnostics;
+    CnToken token;
+    int count = 0;
+    
+    cn_support_diagnostics_init(&diagnostics);
+    cn_frontend_preprocessor_init(&preprocessor, unclosed, strlen(unclosed), "test.cn");
+    cn_frontend_preprocessor_set_diagnostics(&preprocessor, &diagnostics);
+    TEST_ASSERT(!cn_frontend_preprocessor_next_token(&preprocessor, &token), "未闭合的条件块应报错");
+    TEST_ASSERT(token.kind == CN_TOKEN_EOF && preprocessor.stream_failed, "出错后应返回 EOF");
+    TEST_ASSERT(diagnostics.count > 0, "应报告诊断信息");
+    cn_frontend_preprocessor_free(&preprocessor);
+    cn_support_diagnostics_free(&diagnostics);
+    
+    cn_support_diagnostics_init(&diagnostics);
+    cn_frontend_preprocessor_init(&preprocessor, unknown, strlen(unknown), "test.cn");
+    cn_frontend_preprocessor_set_diagnostics(&preprocessor, &diagnostics);
+    while (cn_frontend_preprocessor_next_token(&preprocessor, &token) && token.kind != CN_TOKEN_EOF) {
+        count++;
+    }
+    TEST_ASSERT(count == 5, "未知指令之前的词元应正常输出");
+    TEST_ASSERT(preprocessor.stream_failed, "未知指令应报错");
+    cn_frontend_preprocessor_free(&preprocessor);
+    cn_support_diagnostics_free(&diagnostics);
+    
+    printf("test_token_stream_errors: PASSED\n");
+}
+
+/* 测试快速跳过不活跃区域：嵌套条件块、缩进指令与注释中的 '#' */
+static void test_skip_inactive_region(void)
+{
+    const char *source =
+        "#ifdef 未定义平台\n"
+        "变量 a = 1;\n"
+        "  #ifdef 其他\n"
+        "  #定义 不应定义 1\n"
+        "  #else\n"
+        "  #endif\n"
+        "/* 注释中的指令\n"
+        "#endif\n"
+        "*/\n"
+        "#define 也不应定义 2\n"
+        "  #else\n"
+        "变量 b = 2;\n"
+        "#endif\n"
+        "变量 c = 3;\n";
+    
+    CnPreprocessor preprocessor;
+    CnDiagnostics diagnostics;
+    
+    cn_support_diagnostics_init(&diagnostics);
+    cn_frontend_preprocessor_init(&preprocessor, source, strlen(source), "test.cn");
+    cn_frontend_preprocessor_set_diagnostics(&preprocessor, &diagnostics);
+    
+    TEST_ASSERT(cn_frontend_preprocessor_process(&preprocessor), "预处理失败");
+    TEST_ASSERT(strstr(preprocessor.output, "a = 1") == NULL, "不活跃区域应被跳过");
+    TEST_ASSERT(strstr(preprocessor.output, "变量 b = 2;") != NULL, "缩进的 #else 分支应输出");
+    TEST_ASSERT(strstr(preprocessor.output, "变量 c = 3;") != NULL, "#endif 之后的代码应输出");
+    TEST_ASSERT(!cn_frontend_preprocessor_is_defined(&preprocessor, "不应定义", strlen("不应定义")),
+                "嵌套不活跃区域中的宏不应定义");
+    TEST_ASSERT(!cn_frontend_preprocessor_is_defined(&preprocessor, "也不应定义", strlen("也不应定义")),
+                "不活跃区域中的宏不应定义");
+    TEST_ASSERT(preprocessor.condition_depth == 0, "条件栈应已清空");
+    cn_frontend_preprocessor_free(&preprocessor);
+    
+    /* 逐词元模式下跳过区域后行号保持准确 */
+    cn_frontend_preprocessor_init(&preprocessor, source, strlen(source), "test.cn");
+    cn_frontend_preprocessor_set_diagnostics(&preprocessor, &diagnostics);
+    expect_token(&preprocessor, CN_TOKEN_KEYWORD_VAR, "变量", 12, 1);
+    expect_token(&preprocessor, CN_TOKEN_IDENT, "b", 12, 8);
+    expect_token(&preprocessor, CN_TOKEN_EQUAL, "=", 12, 10);
+    expect_token(&preprocessor, CN_TOKEN_INTEGER, "2", 12, 12);
+    expect_token(&preprocessor, CN_TOKEN_SEMICOLON, ";", 12, 13);
+    expect_token(&preprocessor, CN_TOKEN_KEYWORD_VAR, "变量", 14, 1);
+    TEST_ASSERT(diagnostics.count == 0, "不应产生诊断信息");
+    cn_frontend_preprocessor_free(&preprocessor);
+    cn_support_diagnostics_free(&diagnostics);
+    
+    printf("test_skip_inactive_region: PASSED\n");
+}
+
 int main(void)
 {
     printf("开始预处理器测试...\n\n");
@@ -292,6 +533,11 @@ int main(void)
     test_undef();
     test_multi_param_macro();
     test_empty_macro();
+    test_passthrough();
+    test_many_macros();
+    test_token_stream();
+    test_token_stream_errors();
+    test_skip_inactive_region();
     
     printf("\n所有预处理器测试通过!\n");
     return 0;
@@ -0,0 +1,252 @@
+#include "cnlang/frontend/lexer.h"
+#include "cnlang/frontend/parser.h"
+#include "cnlang/frontend/ast.h"
+#include "cnlang/frontend/semantics.h"
+#include "cnlang/support/diagnostics.h"
+#include "cnlang/support/string_pool.h"
+#include "cnlang/support/thread.h"
+#include "test_support.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * 并行类型检查测试
+ *
+ * 函数体在多个线程中检查，诊断按函数顺序合并：
+ * 同一程序串行与并行检查得到的诊断逐条一致，函数数不足阈值时退回串行；
+ * 字符串池在并发模式下新驻留的字符串退出后仍保持唯一。
+ */
+
+#define FUNCTION_COUNT 240
+#define THREAD_COUNT 4
+
+// ============================================================================
+// 测试统计
+// ============================================================================
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+typedef struct Checked {
+    CnDiagnostics diagnostics;
+    CnAstProgram *program;
+    CnSemScope *global_scope;
+    bool ok;
+} Checked;
+
+// 解析并做语义分析；options 为 NULL 时串行检查
+static void check(Checked *checked, const char *source, const CnSemParallelOptions *options)
+{
+    CnLexer lexer;
+    CnParser *parser;
+
+    memset(checked, 0, sizeof(*checked));
+    cn_support_diagnostics_init(&checked->diagnostics);
+    cn_frontend_lexer_init(&lexer, source, strlen(source), "<parallel>");
+    parser = cn_frontend_parser_new(&lexer);
+    if (!parser) {
+        return;
+    }
+    cn_frontend_parser_set_diagnostics(parser, &checked->diagnostics);
+    cn_frontend_parse_program(parser, &checked->program);
+    cn_frontend_parser_free(parser);
+    if (!checked->program || cn_support_diagnostics_error_count(&checked->diagnostics) > 0) {
+        return;
+    }
+
+    checked->global_scope = cn_sem_build_scopes(checked->program, &checked->diagnostics);
+    cn_sem_resolve_names(checked->global_scope, checked->program, &checked->diagnostics);
+    if (options) {
+        checked->ok = cn_sem_check_types_parallel(checked->global_scope, checked->program,
+                                                  &checked->diagnostics, options);
+    } else {
+        checked->ok = cn_sem_check_types(checked->global_scope, checked->program, &checked->diagnostics);
+    }
+}
+
+static void checked_free(Checked *checked)
+{
+    if (checked->global_scope) {
+        cn_sem_scope_free(checked->global_scope);
+    }
+    cn_frontend_ast_program_free(checked->program);
+    cn_support_diagnostics_free(&checked->diagnostics);
+}
+
+static bool same_text(const char *a, const char *b)
+{
+    return (!a && !b) || (a && b && strcmp(a, b) == 0);
+}
+
+static bool same_diagnostics(const CnDiagnostics *a, const CnDiagnostics *b)
+{
+    if (a->count != b->count) {
+        return false;
+    }
+    for (size_t i = 0; i < a->count; i++) {
+        const CnDiagnostic *x = &a->items[i];
+        const CnDiagnostic *y = &b->items[i];
+        if (x->severity != y->severity || x->code != y->code || x->line != y->line ||
+            x->column != y->column || !same_text(x->filename, y->filename) ||
+            !same_text(x->message, y->message)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 生成 count 个函数，每三个函数中有两个带不同的语义错误，并访问共享结构体的指针字段
+static char *build_program(size_t count)
+{
+    size_t capacity = 256 + count * 512;
+    size_t length = 0;
+    char *text = (char *)malloc(capacity);
+
+    if (!text) {
+        return NULL;
+    }
+    length += (size_t)snprintf(text + length, capacity - length,
+                               "结构体 节点 {\n    整数 值;\n    节点* 下一个;\n};\n节点 全局节点;\n");
+    for (size_t i = 0; i < count; i++) {
+        length += (size_t)snprintf(text + length, capacity - length,
+                                   "函数 函数%zu(整数 参数) -> 整数 {\n"
+                                   "    整数 局部%zu = 参数 + %zu;\n"
+                                   "    节点* 指针 = &全局节点;\n"
+                                   "    整数 值 = 指针->下一个->值;\n",
+                                   i, i, i);
+        if (i % 3 == 0) {
+            length += (size_t)snprintf(text + length, capacity - length,
+                                       "    局部%zu = 未定义%zu;\n", i, i);
+        } else if (i % 3 == 1) {
+            length += (size_t)snprintf(text + length, capacity - length,
+                                       "    整数 文本%zu = \"甲%zu\";\n", i, i);
+        }
+        length += (size_t)snprintf(text + length, capacity - length,
+                                   "    返回 局部%zu + 值;\n}\n", i);
+    }
+    snprintf(text + length, capacity - length, "函数 主程序() -> 整数 {\n    返回 函数0(1);\n}\n");
+    return text;
+}
+
+static void test_parallel_matches_serial(void)
+{
+    printf("测试：并行检查与串行检查的诊断一致\n");
+
+    char *source = build_program(FUNCTION_COUNT);
+    CnSemParallelOptions options;
+    Checked serial;
+    Checked parallel;
+
+    TEST_ASSERT(source != NULL, "生成测试程序失败");
+    cn_sem_parallel_options_default(&options);
+    options.thread_count = THREAD_COUNT;
+    options.min_function_count = 1;
+
+    check(&serial, source, NULL);
+    check(&parallel, source, &options);
+    TEST_ASSERT(serial.global_scope && parallel.global_scope, "作用域构建失败");
+    TEST_ASSERT(serial.diagnostics.count >= FUNCTION_COUNT / 3, "测试程序应产生语义错误");
+    TEST_ASSERT(!serial.ok && !parallel.ok, "串行与并行检查都应报告失败");
+    TEST_ASSERT(same_diagnostics(&serial.diagnostics, &parallel.diagnostics), "并行检查的诊断与串行不一致");
+    TEST_ASSERT(!cn_string_pool_default()->concurrent, "检查结束后字符串池仍处于并发模式");
+
+    checked_free(&serial);
+    checked_free(&parallel);
+    free(source);
+    TEST_PASS("并行检查与串行检查的诊断一致");
+}
+
+static void test_small_program_falls_back(void)
+{
+    printf("测试：函数数不足阈值时退回串行\n");
+
+    const char *source =
+        "函数 取值() -> 整数 { 返回 未知; }\n"
+        "函数 主程序() -> 整数 {\n    返回 取值();\n}\n";
+    Checked serial;
+    Checked parallel;
+
+    check(&serial, source, NULL);
+    check(&parallel, source, NULL);
+    TEST_ASSERT(serial.diagnostics.count == 1, "应报告一个未定义标识符");
+    TEST_ASSERT(same_diagnostics(&serial.diagnostics, &parallel.diagnostics), "函数数不足阈值时结果应与串行一致");
+    checked_free(&serial);
+    checked_free(&parallel);
+    TEST_PASS("函数数不足阈值时退回串行");
+}
+
+#define POOL_NAMES 2000
+
+typedef struct PoolWorker {
+    CnStringPool *pool;
+    const char *results[POOL_NAMES];
+} PoolWorker;
+
+static void pool_worker(void *arg)
+{
+    PoolWorker *worker = (PoolWorker *)arg;
+    char name[32];
+
+    for (size_t i = 0; i < POOL_NAMES; i++) {
+        int length = snprintf(name, sizeof(name), "名字%zu", i);
+        worker->results[i] = cn_string_pool_intern(worker->pool, name, (size_t)length);
+    }
+}
+
+static void test_string_pool_concurrent(void)
+{
+    printf("测试：字符串池并发驻留\n");
+
+    CnStringPool *pool = cn_string_pool_new();
+    static PoolWorker workers[THREAD_COUNT];
+    CnThread threads[THREAD_COUNT];
+    const char *existing;
+    bool ok = true;
+
+    TEST_ASSERT(pool != NULL, "创建字符串池失败");
+    existing = cn_string_pool_intern(pool, "名字0", strlen("名字0"));
+    TEST_ASSERT(cn_string_pool_begin_concurrent(pool), "进入并发模式失败");
+    for (int t = 0; t < THREAD_COUNT; t++) {
+        workers[t].pool = pool;
+        TEST_ASSERT(cn_thread_start(&threads[t], pool_worker, &workers[t]), "启动线程失败");
+    }
+    for (int t = 0; t < THREAD_COUNT; t++) {
+        cn_thread_join(&threads[t]);
+    }
+    cn_string_pool_end_concurrent(pool);
+
+    TEST_ASSERT(workers[0].results[0] == existing, "已驻留的字符串应直接命中主表");
+    for (size_t i = 0; i < POOL_NAMES; i++) {
+        char name[32];
+        int length = snprintf(name, sizeof(name), "名字%zu", i);
+        const char *found = cn_string_pool_find(pool, name, (size_t)length);
+        for (int t = 0; t < THREAD_COUNT; t++) {
+            ok = ok && workers[t].results[i] == found;
+        }
+    }
+    TEST_ASSERT(ok, "并发驻留的同名字符串应返回同一指针");
+    TEST_ASSERT(pool->count == POOL_NAMES, "退出并发模式后字符串应全部并入主表");
+    cn_string_pool_free(pool);
+    TEST_PASS("字符串池并发驻留");
+}
+
+int main(void)
+{
+    printf("========================================\n");
+    printf("并行类型检查测试\n");
+    printf("========================================\n\n");
+
+    test_parallel_matches_serial();
+    test_small_program_falls_back();
+    test_string_pool_concurrent();
+
+    cn_type_context_release_default();
+
+    printf("\n========================================\n");
+    printf("测试结果: %d 通过, %d 失败\n", tests_passed, tests_failed);
+    printf("========================================\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,266 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include "cnlang/frontend/ast.h"
+#include "cnlang/semantics/class_analyzer.h"
+#include "cnlang/semantics/inheritance_resolver.h"
+
+// 测试用的类：名字与基类名直接引用字符串常量
+typedef struct TestClass {
+    CnAstClassDecl decl;
+    CnAstStmt stmt;
+    CnInheritanceInfo bases[4];
+    CnClassMember members[4];
+} TestClass;
+
+static TestClass *new_class(const char *name, const char *base1, const char *base2) {
+    TestClass *cls = (TestClass *)calloc(1, sizeof(TestClass));
+    const char *bases[2] = { base1, base2 };
+
+    cls->decl.name = name;
+    cls->decl.name_length = strlen(name);
+    cls->decl.bases = cls->bases;
+    cls->decl.members = cls->members;
+    for (size_t i = 0; i < 2; i++) {
+        if (bases[i]) {
+            cls->bases[cls->decl.base_count].base_class_name = bases[i];
+            cls->bases[cls->decl.base_count].base_class_name_length = strlen(bases[i]);
+            cls->bases[cls->decl.base_count].access = CN_ACCESS_PUBLIC;
+            cls->decl.base_count++;
+        }
+    }
+    cls->stmt.kind = CN_AST_STMT_CLASS_DECL;
+    cls->stmt.as.class_decl = &cls->decl;
+    return cls;
+}
+
+static CnClassMember *add_method(TestClass *cls, const char *name, bool is_virtual, bool is_override) {
+    CnClassMember *member = &cls->members[cls->decl.member_count++];
+    member->name = name;
+    member->name_length = strlen(name);
+    member->kind = CN_MEMBER_METHOD;
+    member->access = CN_ACCESS_PUBLIC;
+    member->is_virtual = is_virtual;
+    member->is_override = is_override;
+    return member;
+}
+
+static CnInheritanceResolver *new_resolver(TestClass **classes, size_t count) {
+    CnInheritanceResolver *resolver = cn_inheritance_resolver_create(NULL);
+    bool ok;
+    assert(resolver != NULL);
+    for (size_t i = 0; i < count; i++) {
+        ok = cn_inheritance_resolver_register(resolver, &classes[i]->decl);
+        assert(ok);
+    }
+    ok = cn_inheritance_resolver_resolve(resolver);
+    assert(ok);
+    return resolver;
+}
+
+// 菱形继承：丁 : 乙, 丙；乙 : 甲；丙 : 甲
+void test_ancestor_linearization() {
+    TestClass *classes[5] = {
+        new_class("甲", NULL, NULL),
+        new_class("乙", "甲", NULL),
+        new_class("丙", "甲", NULL),
+        new_class("丁", "乙", "丙"),
+        new_class("戊", "丁", NULL),
+    };
+    CnInheritanceResolver *resolver = new_resolver(classes, 5);
+
+    size_t count = 0;
+    CnAstClassDecl **bases = cn_inheritance_resolver_get_all_bases(resolver, &classes[3]->decl, &count);
+    assert(bases != NULL);
+    assert(count == 3);
+    assert(bases[0] == &classes[1]->decl);
+    assert(bases[1] == &classes[0]->decl);
+    assert(bases[2] == &classes[2]->decl);
+    free(bases);
+
+    CnMroList *mro = cn_inheritance_resolver_compute_mro(resolver, &classes[4]->decl);
+    assert(mro != NULL);
+    assert(mro->count == 5);
+    assert(mro->classes[0] == &classes[4]->decl);
+    assert(mro->classes[1] == &classes[3]->decl);
+    assert(mro->classes[4] == &classes[2]->decl);
+    cn_mro_list_destroy(mro);
+
+    assert(cn_inheritance_resolver_is_derived_from(resolver, "戊", "甲"));
+    assert(cn_inheritance_resolver_is_derived_from(resolver, "丁", "丙"));
+    assert(!cn_inheritance_resolver_is_derived_from(resolver, "甲", "丁"));
+    assert(!cn_inheritance_resolver_is_derived_from(resolver, "乙", "丙"));
+    assert(!cn_inheritance_resolver_is_derived_from(resolver, "丁", "丁"));
+    assert(!cn_inheritance_resolver_is_derived_from(resolver, "丁", "不存在"));
+
+    cn_inheritance_resolver_destroy(resolver);
+    for (size_t i = 0; i < 5; i++) {
+        free(classes[i]);
+    }
+    printf("test_ancestor_linearization: PASSED\n");
+}
+
+// 超过 64 个类时祖先位集跨越多个字；注册新类后缓存自动重建
+void test_long_chain_and_invalidation() {
+    enum { CHAIN = 150 };
+    static char names[CHAIN + 1][16];
+    TestClass *classes[CHAIN + 1];
+
+    for (size_t i = 0; i < CHAIN; i++) {
+        snprintf(names[i], sizeof(names[i]), "类%zu", i);
+        classes[i] = new_class(names[i], i > 0 ? names[i - 1] : NULL, NULL);
+    }
+    CnInheritanceResolver *resolver = new_resolver(classes, CHAIN);
+
+    CnInheritanceNode *first = cn_inheritance_resolver_find_node(resolver, names[0], strlen(names[0]));
+    CnInheritanceNode *last = cn_inheritance_resolver_find_node(resolver, names[CHAIN - 1],
+                                                                strlen(names[CHAIN - 1]));
+    assert(first != NULL && last != NULL);
+    assert(last->class_decl == &classes[CHAIN - 1]->decl);
+    assert(cn_inheritance_node_is_derived_from(resolver, last, first));
+    assert(!cn_inheritance_node_is_derived_from(resolver, first, last));
+    assert(last->ancestor_count == CHAIN - 1);
+    assert(cn_inheritance_resolver_get_depth(resolver, names[CHAIN - 1]) == CHAIN - 1);
+
+    snprintf(names[CHAIN], sizeof(names[CHAIN]), "新类");
+    classes[CHAIN] = new_class(names[CHAIN], names[100], NULL);
+    bool registered = cn_inheritance_resolver_register(resolver, &classes[CHAIN]->decl);
+    assert(registered);
+    assert(!resolver->hierarchy_ready);
+    assert(cn_inheritance_resolver_is_derived_from(resolver, "新类", names[3]));
+    assert(!cn_inheritance_resolver_is_derived_from(resolver, "新类", names[101]));
+
+    cn_inheritance_resolver_destroy(resolver);
+    for (size_t i = 0; i <= CHAIN; i++) {
+        free(classes[i]);
+    }
+    printf("test_long_chain_and_invalidation: PASSED\n");
+}
+
+// 方法槽位：每个字段保留 MRO 顺序上的第一个匹配
+void test_method_slots() {
+    TestClass *classes[4] = {
+        new_class("动物", NULL, NULL),
+        new_class("鸟", "动物", NULL),
+        new_class("鱼", "动物", NULL),
+        new_class("飞鱼", "鸟", "鱼"),
+    };
+    CnClassMember *animal_speak = add_method(classes[0], "叫", true, false);
+    CnClassMember *animal_move = add_method(classes[0], "移动", false, false);
+    CnClassMember *bird_speak = add_method(classes[1], "叫", false, true);
+    CnClassMember *fish_move = add_method(classes[2], "移动", true, false);
+    CnInheritanceResolver *resolver = new_resolver(classes, 4);
+
+    const CnMethodSlot *slot = cn_inheritance_resolver_find_method_slot(resolver, &classes[3]->decl,
+                                                                         "叫", strlen("叫"));
+    assert(slot != NULL);
+    assert(slot->method == bird_speak);
+    assert(slot->owner == &classes[1]->decl);
+    assert(slot->virtual_method == animal_speak);
+
+    slot = cn_inheritance_resolver_find_method_slot(resolver, &classes[3]->decl, "移动", strlen("移动"));
+    assert(slot != NULL);
+    assert(slot->method == animal_move);
+    assert(slot->virtual_method == fish_move);
+
+    slot = cn_inheritance_resolver_find_method_slot(resolver, &classes[2]->decl, "叫", strlen("叫"));
+    assert(slot != NULL && slot->method == animal_speak);
+    assert(cn_inheritance_resolver_find_method_slot(resolver, &classes[3]->decl, "游", strlen("游")) == NULL);
+
+    // 与按 MRO 逐个类查找的结果一致
+    CnMroList *mro = cn_inheritance_resolver_compute_mro(resolver, &classes[3]->decl);
+    assert(cn_mro_find_method(mro, "叫", strlen("叫")) == bird_speak);
+    assert(cn_mro_find_method(mro, "移动", strlen("移动")) == animal_move);
+    cn_mro_list_destroy(mro);
+
+    cn_inheritance_resolver_destroy(resolver);
+    for (size_t i = 0; i < 4; i++) {
+        free(classes[i]);
+    }
+    printf("test_method_slots: PASSED\n");
+}
+
+// 循环继承不会导致无限递归，环上的类不视为自身的派生类
+void test_circular_hierarchy() {
+    TestClass *classes[3] = {
+        new_class("环甲", "环乙", NULL),
+        new_class("环乙", "环甲", NULL),
+        new_class("自环", "自环", NULL),
+    };
+    CnInheritanceResolver *resolver = new_resolver(classes, 3);
+
+    bool built = cn_inheritance_resolver_build_hierarchy(resolver);
+    assert(built);
+    assert(cn_inheritance_resolver_check_circular(resolver));
+    assert(!cn_inheritance_resolver_is_derived_from(resolver, "自环", "自环"));
+    assert(!cn_inheritance_resolver_is_derived_from(resolver, "环甲", "环甲"));
+
+    size_t count = 0;
+    CnAstClassDecl **bases = cn_inheritance_resolver_get_all_bases(resolver, &classes[2]->decl, &count);
+    assert(bases != NULL && count == 0);
+    free(bases);
+
+    cn_inheritance_resolver_destroy(resolver);
+    for (size_t i = 0; i < 3; i++) {
+        free(classes[i]);
+    }
+    printf("test_circular_hierarchy: PASSED\n");
+}
+
+// 重写检查：使用类层次缓存与逐级查找基类的结果一致
+void test_override_check_with_hierarchy() {
+    TestClass *classes[4] = {
+        new_class("形状", NULL, NULL),
+        new_class("多边形", "形状", NULL),
+        new_class("矩形", "多边形", NULL),
+        new_class("正方形", "矩形", NULL),
+    };
+    add_method(classes[0], "面积", true, false);
+    add_method(classes[0], "名称", false, false);
+    add_method(classes[1], "边数", true, false);
+    CnClassMember *overrides[3] = {
+        add_method(classes[3], "面积", false, true),
+        add_method(classes[3], "边数", false, true),
+        add_method(classes[3], "名称", false, true),
+    };
+    CnAstStmt *stmts[4];
+    for (size_t i = 0; i < 4; i++) {
+        stmts[i] = &classes[i]->stmt;
+    }
+    CnAstProgram program;
+    memset(&program, 0, sizeof(program));
+    program.classes = stmts;
+    program.class_count = 4;
+
+    CnInheritanceResolver *resolver = new_resolver(classes, 4);
+    CnClassAnalyzerContext ctx;
+    bool initialized = cn_class_analyzer_context_init(&ctx, NULL, NULL, &program);
+    assert(initialized);
+    ctx.current_class = &classes[3]->decl;
+
+    for (size_t i = 0; i < 3; i++) {
+        ctx.hierarchy = NULL;
+        bool expected = cn_check_method_override(&ctx, overrides[i]);
+        ctx.hierarchy = resolver;
+        assert(cn_check_method_override(&ctx, overrides[i]) == expected);
+        // "名称" 在基类中不是虚函数，重写检查失败
+        assert(expected == (i != 2));
+    }
+
+    cn_class_analyzer_context_cleanup(&ctx);
+    cn_inheritance_resolver_destroy(resolver);
+    for (size_t i = 0; i < 4; i++) {
+        free(classes[i]);
+    }
+    printf("test_override_check_with_hierarchy: PASSED\n");
+}
+
+int main() {
+    test_ancestor_linearization();
+    test_long_chain_and_invalidation();
+    test_method_slots();
+    test_circular_hierarchy();
+    test_override_check_with_hierarchy();
+    return 0;
+}
@@ -1,7 +1,11 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
 #include <string.h>
+#include "cnlang/frontend/lexer.h"
+#include "cnlang/frontend/parser.h"
 #include "cnlang/frontend/semantics.h"
+#include "cnlang/support/diagnostics.h"
 
 void test_scope_creation() {
     CnSemScope *global = cn_sem_scope_new(CN_SEM_SCOPE_GLOBAL, NULL);
@@ -55,8 +59,222 @@ void test_symbol_insertion_and_lookup() {
     printf("test_symbol_insertion_and_lookup: PASSED\n");
 }
 
+typedef struct CollectedNames {
+    const char *names[4096];
+    size_t count;
+} CollectedNames;
+
+static void collect_symbol_name(CnSemSymbol *symbol, void *user_data) {
+    CollectedNames *collected = (CollectedNames *)user_data;
+    if (collected->count < 4096) {
+        collected->names[collected->count++] = symbol->name;
+    }
+}
+
+// 符号数超过阈值后改用哈希索引，查找结果与遍历顺序保持不变
+void test_large_scope_index() {
+    CnSemScope *global = cn_sem_scope_new(CN_SEM_SCOPE_GLOBAL, NULL);
+    CnSemScope *local = cn_sem_scope_new(CN_SEM_SCOPE_BLOCK, global);
+    CnSemSymbol *symbols[3000];
+    CollectedNames collected = { { 0 }, 0 };
+    char name[32];
+
+    // 模块符号与同名类型符号共存
+    CnSemSymbol *module = cn_sem_scope_insert_symbol(global, "词元", strlen("词元"), CN_SEM_SYMBOL_MODULE);
+    assert(module != NULL);
+
+    for (int i = 0; i < 3000; i++) {
+        snprintf(name, sizeof(name), "符号%d", i);
+        symbols[i] = cn_sem_scope_insert_symbol(global, name, strlen(name), CN_SEM_SYMBOL_VARIABLE);
+        assert(symbols[i] != NULL);
+    }
+
+    CnSemSymbol *type = cn_sem_scope_insert_symbol(global, "词元", strlen("词元"), CN_SEM_SYMBOL_STRUCT);
+    assert(type != NULL && type != module);
+    assert(cn_sem_scope_insert_symbol(global, "符号7", strlen("符号7"), CN_SEM_SYMBOL_FUNCTION) == NULL);
+
+    for (int i = 0; i < 3000; i++) {
+        snprintf(name, sizeof(name), "符号%d", i);
+        assert(cn_sem_scope_lookup_shallow(global, name, strlen(name)) == symbols[i]);
+        assert(cn_sem_scope_lookup(local, name, strlen(name)) == symbols[i]);
+    }
+    assert(cn_sem_scope_lookup(local, "符号3000", strlen("符号3000")) == NULL);
+
+    // 同名符号：普通查找返回最新插入的，按种类查找返回首选种类
+    assert(cn_sem_scope_lookup(local, "词元", strlen("词元")) == type);
+    assert(cn_sem_scope_lookup_by_kind(local, "词元", strlen("词元"), CN_SEM_SYMBOL_MODULE) == module);
+    assert(cn_sem_scope_lookup_by_kind(local, "词元", strlen("词元"), CN_SEM_SYMBOL_STRUCT) == type);
+    assert(cn_sem_scope_lookup_by_kind(local, "词元", strlen("词元"), CN_SEM_SYMBOL_ENUM) == type);
+
+    // 局部遮蔽仍然优先
+    CnSemSymbol *shadow = cn_sem_scope_insert_symbol(local, "符号42", strlen("符号42"), CN_SEM_SYMBOL_VARIABLE);
+    assert(cn_sem_scope_lookup(local, "符号42", strlen("符号42")) == shadow);
+
+    // 遍历顺序为插入逆序
+    cn_sem_scope_foreach_symbol(global, collect_symbol_name, &collected);
+    assert(collected.count == 3002);
+    assert(collected.names[0] == type->name);
+    assert(collected.names[1] == symbols[2999]->name);
+    assert(collected.names[3000] == symbols[0]->name);
+    assert(collected.names[3001] == module->name);
+
+    cn_sem_scope_free(local);
+    cn_sem_scope_free(global);
+    printf("test_large_scope_index: PASSED\n");
+}
+
+static CnAstExpr *new_identifier(const char *name) {
+    CnAstExpr *expr = (CnAstExpr *)calloc(1, sizeof(CnAstExpr));
+    assert(expr != NULL);
+    expr->kind = CN_AST_EXPR_IDENTIFIER;
+    expr->as.identifier.name = name;
+    expr->as.identifier.name_length = strlen(name);
+    return expr;
+}
+
+// 标识符查找结果缓存在节点上：同一作用域再次查找直接命中，作用域链插入新符号或换作用域后重新查找
+void test_identifier_lookup_cache() {
+    CnSemScope *global = cn_sem_scope_new(CN_SEM_SCOPE_GLOBAL, NULL);
+    CnSemScope *function = cn_sem_scope_new(CN_SEM_SCOPE_FUNCTION, global);
+    CnSemScope *block = cn_sem_scope_new(CN_SEM_SCOPE_BLOCK, function);
+    CnSemScope *other = cn_sem_scope_new(CN_SEM_SCOPE_BLOCK, global);
+    CnAstExpr *expr = new_identifier("计数");
+    CnAstExpr *missing = new_identifier("不存在");
+
+    CnSemSymbol *global_sym = cn_sem_scope_insert_symbol(global, "计数", strlen("计数"), CN_SEM_SYMBOL_VARIABLE);
+    assert(cn_sem_scope_lookup_identifier(block, expr) == global_sym);
+    assert(expr->as.identifier.symbol == global_sym);
+    assert(cn_sem_scope_lookup_identifier(block, expr) == global_sym);
+    assert(cn_sem_scope_lookup_identifier_by_kind(block, expr, CN_SEM_SYMBOL_ENUM) == global_sym);
+
+    // 中间作用域插入同名符号后缓存失效
+    CnSemSymbol *function_sym = cn_sem_scope_insert_symbol(function, "计数", strlen("计数"), CN_SEM_SYMBOL_VARIABLE);
+    assert(cn_sem_scope_lookup_identifier(block, expr) == function_sym);
+    CnSemSymbol *block_sym = cn_sem_scope_insert_symbol(block, "计数", strlen("计数"), CN_SEM_SYMBOL_VARIABLE);
+    assert(cn_sem_scope_lookup_identifier(block, expr) == block_sym);
+
+    // 换作用域查找得到该作用域可见的符号
+    assert(cn_sem_scope_lookup_identifier(other, expr) == global_sym);
+    assert(cn_sem_scope_lookup_identifier(function, expr) == function_sym);
+
+    // 未找到的结果同样缓存，之后插入该名字时失效
+    assert(cn_sem_scope_lookup_identifier(block, missing) == NULL);
+    assert(cn_sem_scope_lookup_identifier(block, missing) == NULL);
+    CnSemSymbol *late = cn_sem_scope_insert_symbol(global, "不存在", strlen("不存在"), CN_SEM_SYMBOL_FUNCTION);
+    assert(cn_sem_scope_lookup_identifier(block, missing) == late);
+
+    free(expr);
+    free(missing);
+    cn_sem_scope_free(other);
+    cn_sem_scope_free(block);
+    cn_sem_scope_free(function);
+    cn_sem_scope_free(global);
+    printf("test_identifier_lookup_cache: PASSED\n");
+}
+
+// 同名符号共存时按种类查找与普通查找的结果不同，缓存不能混用
+void test_identifier_lookup_by_kind() {
+    CnSemScope *global = cn_sem_scope_new(CN_SEM_SCOPE_GLOBAL, NULL);
+    CnSemScope *local = cn_sem_scope_new(CN_SEM_SCOPE_BLOCK, global);
+    CnAstExpr *expr = new_identifier("词元");
+
+    CnSemSymbol *enum_sym = cn_sem_scope_insert_symbol(global, "词元", strlen("词元"), CN_SEM_SYMBOL_ENUM);
+    CnSemSymbol *module = cn_sem_scope_insert_symbol(global, "词元", strlen("词元"), CN_SEM_SYMBOL_MODULE);
+    assert(enum_sym != NULL && module != NULL);
+
+    for (int i = 0; i < 2; i++) {
+        assert(cn_sem_scope_lookup_identifier(local, expr) == module);
+        assert(cn_sem_scope_lookup_identifier_by_kind(local, expr, CN_SEM_SYMBOL_ENUM) == enum_sym);
+        assert(cn_sem_scope_lookup_identifier_by_kind(local, expr, CN_SEM_SYMBOL_STRUCT) == module);
+    }
+
+    free(expr);
+    cn_sem_scope_free(local);
+    cn_sem_scope_free(global);
+    printf("test_identifier_lookup_by_kind: PASSED\n");
+}
+
+// 校验模式下每次命中都与重新查找比较，发现不一致时返回重新查找的结果
+void test_identifier_lookup_verify() {
+    CnSemScope *global = cn_sem_scope_new(CN_SEM_SCOPE_GLOBAL, NULL);
+    CnAstExpr *expr = new_identifier("甲");
+    CnSemSymbol *a = cn_sem_scope_insert_symbol(global, "甲", strlen("甲"), CN_SEM_SYMBOL_VARIABLE);
+    CnSemSymbol *b = cn_sem_scope_insert_symbol(global, "乙", strlen("乙"), CN_SEM_SYMBOL_VARIABLE);
+    size_t failures = cn_sem_cache_verify_failures();
+
+    assert(cn_sem_scope_lookup_identifier(global, expr) == a);
+    cn_sem_cache_set_verify(true);
+    assert(cn_sem_scope_lookup_identifier(global, expr) == a);
+    assert(cn_sem_cache_verify_failures() == failures);
+
+    // 模拟缓存被破坏
+    expr->as.identifier.symbol = b;
+    fprintf(stderr, "（以下一条校验失败信息为预期输出）\n");
+    assert(cn_sem_scope_lookup_identifier(global, expr) == a);
+    assert(cn_sem_cache_verify_failures() == failures + 1);
+    cn_sem_cache_set_verify(false);
+
+    free(expr);
+    cn_sem_scope_free(global);
+    printf("test_identifier_lookup_verify: PASSED\n");
+}
+
+// 完整语义分析在校验模式下运行：局部变量遮蔽全局变量、嵌套块与未定义标识符都不应出现缓存不一致
+void test_identifier_cache_pipeline() {
+    const char *source =
+        "整数 值 = 1;\n"
+        "函数 计算(整数 参数) -> 整数 {\n"
+        "    整数 结果 = 值 + 参数;\n"
+        "    如果 (结果 > 0) {\n"
+        "        整数 值 = 结果 * 2;\n"
+        "        结果 = 值 + 参数;\n"
+        "    }\n"
+        "    循环 (整数 i = 0; i < 参数; i = i + 1) {\n"
+        "        结果 = 结果 + i + 值;\n"
+        "    }\n"
+        "    返回 结果 + 未定义;\n"
+        "}\n";
+    CnDiagnostics diagnostics;
+    CnLexer lexer;
+    CnParser *parser;
+    CnAstProgram *program = NULL;
+    CnSemScope *global;
+    bool ok;
+    size_t failures = cn_sem_cache_verify_failures();
+
+    cn_support_diagnostics_init(&diagnostics);
+    cn_frontend_lexer_init(&lexer, source, strlen(source), "<cache>");
+    parser = cn_frontend_parser_new(&lexer);
+    assert(parser != NULL);
+    cn_frontend_parser_set_diagnostics(parser, &diagnostics);
+    ok = cn_frontend_parse_program(parser, &program);
+    assert(ok && program != NULL);
+    cn_frontend_parser_free(parser);
+
+    cn_sem_cache_set_verify(true);
+    global = cn_sem_build_scopes(program, &diagnostics);
+    assert(global != NULL);
+    cn_sem_resolve_names(global, program, &diagnostics);
+    ok = cn_sem_check_types(global, program, &diagnostics);
+    assert(!ok);
+    cn_sem_cache_set_verify(false);
+
+    assert(cn_sem_cache_verify_failures() == failures);
+    assert(diagnostics.count == 1);
+
+    cn_sem_scope_free(global);
+    cn_frontend_ast_program_free(program);
+    cn_support_diagnostics_free(&diagnostics);
+    printf("test_identifier_cache_pipeline: PASSED\n");
+}
+
 int main() {
     test_scope_creation();
     test_symbol_insertion_and_lookup();
+    test_large_scope_index();
+    test_identifier_lookup_cache();
+    test_identifier_lookup_by_kind();
+    test_identifier_lookup_verify();
+    test_identifier_cache_pipeline();
     return 0;
 }
@@ -1,4 +1,6 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include "cnlang/frontend/semantics.h"
 
@@ -49,9 +51,120 @@ void test_function_types() {
     printf("test_function_types: PASSED\n");
 }
 
+void test_interned_types() {
+    CnTypeContextStats before;
+    CnTypeContextStats after;
+    CnType *t_int = cn_type_new_primitive(CN_TYPE_INT);
+    CnType *t_char = cn_type_new_primitive(CN_TYPE_CHAR);
+
+    // 结构相同的复合类型共享同一节点
+    assert(t_int == cn_type_new_primitive(CN_TYPE_INT));
+    assert(cn_type_new_pointer(t_int) == cn_type_new_pointer(t_int));
+    assert(cn_type_new_pointer(cn_type_new_pointer(t_char)) ==
+           cn_type_new_pointer(cn_type_new_pointer(t_char)));
+    assert(cn_type_new_array(t_int, 8) == cn_type_new_array(t_int, 8));
+    assert(cn_type_new_array(t_int, 8) != cn_type_new_array(t_int, 9));
+    assert(!cn_type_equals(cn_type_new_array(t_int, 8), cn_type_new_array(t_int, 9)));
+    assert(cn_type_new_memory_address() == cn_type_new_memory_address());
+
+    // 函数类型复制参数列表，调用者的数组可以随后修改或释放
+    CnType *params[] = { t_int, t_char };
+    CnType *f1 = cn_type_new_function(t_int, params, 2);
+    params[1] = t_int;
+    CnType *f2 = cn_type_new_function(t_int, params, 2);
+    assert(f1 != f2);
+    assert(f1->as.function.param_types[1] == t_char);
+    params[1] = t_char;
+    cn_type_context_get_stats(cn_type_context_default(), &before);
+    assert(cn_type_new_function(t_int, params, 2) == f1);
+    assert(cn_type_new_function(t_int, NULL, 0) == cn_type_new_function(t_int, NULL, 0));
+    cn_type_context_get_stats(cn_type_context_default(), &after);
+    assert(after.hit_count == before.hit_count + 2);
+    assert(after.interned_count == before.interned_count + 1);
+
+    // 具名类型不驻留，按名字比较；指向它们的指针仍按结构比较
+    CnType *s1 = cn_type_new_struct("点", strlen("点"), NULL, 0, NULL, NULL, 0);
+    CnType *s2 = cn_type_new_struct("点", strlen("点"), NULL, 0, NULL, NULL, 0);
+    CnType *s3 = cn_type_new_struct("线", strlen("线"), NULL, 0, NULL, NULL, 0);
+    assert(s1 != s2);
+    assert(cn_type_equals(s1, s2));
+    assert(cn_type_equals(cn_type_new_pointer(s1), cn_type_new_pointer(s2)));
+    assert(!cn_type_equals(cn_type_new_pointer(s1), cn_type_new_pointer(s3)));
+    assert(cn_type_new_pointer(s1) == cn_type_new_pointer(s1));
+
+    printf("test_interned_types: PASSED\n");
+}
+
+void test_interning_many_types() {
+    CnTypeContextStats stats;
+    CnType *t_int = cn_type_new_primitive(CN_TYPE_INT);
+    CnType *arrays[3000];
+
+    // 超过初始槽数后驻留表扩容，已有节点保持不变
+    for (size_t i = 0; i < 3000; i++) {
+        arrays[i] = cn_type_new_array(t_int, i + 1);
+    }
+    for (size_t i = 0; i < 3000; i++) {
+        assert(cn_type_new_array(t_int, i + 1) == arrays[i]);
+        assert(arrays[i]->as.array.length == i + 1);
+    }
+
+    cn_type_context_get_stats(cn_type_context_default(), &stats);
+    assert(stats.interned_count >= 3000);
+    assert(stats.table_bytes >= stats.interned_count * 2 * sizeof(CnType *));
+    assert(stats.arena_bytes >= stats.node_count * sizeof(CnType));
+
+    // 释放默认上下文后重新创建
+    cn_type_context_release_default();
+    cn_type_context_get_stats(cn_type_context_default(), &stats);
+    assert(stats.node_count == 0);
+    assert(cn_type_new_pointer(cn_type_new_primitive(CN_TYPE_INT)) != NULL);
+
+    printf("test_interning_many_types: PASSED\n");
+}
+
+// 推断出的类型记录在表达式节点上，之后直接返回；校验模式下与重新推断的结果比较
+void test_inferred_type_memo() {
+    CnSemScope *global = cn_sem_scope_new(CN_SEM_SCOPE_GLOBAL, NULL);
+    CnSemScope *local = cn_sem_scope_new(CN_SEM_SCOPE_BLOCK, global);
+    CnSemSymbol *sym = cn_sem_scope_insert_symbol(global, "长度", strlen("长度"), CN_SEM_SYMBOL_VARIABLE);
+    CnAstExpr *expr = (CnAstExpr *)calloc(1, sizeof(CnAstExpr));
+    size_t failures = cn_sem_cache_verify_failures();
+
+    assert(sym != NULL && expr != NULL);
+    sym->type = cn_type_new_primitive(CN_TYPE_FLOAT);
+    expr->kind = CN_AST_EXPR_IDENTIFIER;
+    expr->as.identifier.name = "长度";
+    expr->as.identifier.name_length = strlen("长度");
+
+    assert(cn_type_infer_from_expr(local, expr) == sym->type);
+    assert(expr->type == sym->type);
+    assert(expr->as.identifier.symbol == sym);
+
+    // 符号类型改变后仍返回记录的类型；校验模式发现不一致并返回重新推断的结果
+    sym->type = cn_type_new_primitive(CN_TYPE_INT);
+    assert(cn_type_infer_from_expr(local, expr)->kind == CN_TYPE_FLOAT);
+    cn_sem_cache_set_verify(true);
+    fprintf(stderr, "（以下一条校验失败信息为预期输出）\n");
+    assert(cn_type_infer_from_expr(local, expr)->kind == CN_TYPE_INT);
+    assert(cn_sem_cache_verify_failures() == failures + 1);
+    assert(cn_type_infer_from_expr(local, expr)->kind == CN_TYPE_INT);
+    assert(cn_sem_cache_verify_failures() == failures + 1);
+    cn_sem_cache_set_verify(false);
+
+    free(expr);
+    cn_sem_scope_free(local);
+    cn_sem_scope_free(global);
+    printf("test_inferred_type_memo: PASSED\n");
+}
+
 int main() {
     test_primitive_types();
     test_pointer_types();
     test_function_types();
+    test_interned_types();
+    test_interning_many_types();
+    test_inferred_type_memo();
+    cn_type_context_release_default();
     return 0;
 }
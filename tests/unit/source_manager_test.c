@@ -0,0 +1,175 @@
+#include "cnlang/support/source_manager.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * 源文件管理器单元测试
+ */
+
+static const char *SMALL_FILE = "source_manager_test_small.cn";
+static const char *PAGE_FILE = "source_manager_test_page.cn";
+static const char *EMPTY_FILE = "source_manager_test_empty.cn";
+
+static void write_file(const char *path, const char *content, size_t length)
+{
+    FILE *fp = fopen(path, "wb");
+    assert(fp != NULL);
+    if (length > 0) {
+        assert(fwrite(content, 1, length, fp) == length);
+    }
+    fclose(fp);
+}
+
+// 测试基本加载：内容一致且以 '\0' 结尾
+static void test_source_manager_load(void)
+{
+    const char *text = "函数 主程序() { 返回 0; }\n";
+    write_file(SMALL_FILE, text, strlen(text));
+
+    CnSourceManager *manager = cn_source_manager_new();
+    assert(manager != NULL);
+
+    const CnSourceFile *file = cn_source_manager_load(manager, SMALL_FILE);
+    assert(file != NULL);
+    assert(file->length == strlen(text));
+    assert(memcmp(file->data, text, file->length) == 0);
+    assert(file->data[file->length] == '\0');
+    assert(file->path != NULL);
+    assert(manager->file_count == 1);
+    assert(manager->total_bytes == file->length);
+
+    cn_source_manager_free(manager);
+    printf("[PASS] test_source_manager_load\n");
+}
+
+// 测试按规范化路径去重：不同写法指向同一视图
+static void test_source_manager_dedupe(void)
+{
+    CnSourceManager *manager = cn_source_manager_new();
+    assert(manager != NULL);
+
+    assert(cn_source_manager_lookup(manager, SMALL_FILE) == NULL);
+
+    const CnSourceFile *first = cn_source_manager_load(manager, SMALL_FILE);
+    char alt_path[256];
+    snprintf(alt_path, sizeof(alt_path), "./%s", SMALL_FILE);
+    const CnSourceFile *second = cn_source_manager_load(manager, alt_path);
+
+    assert(first != NULL);
+    assert(first == second);
+    assert(first->data == second->data);
+    assert(manager->file_count == 1);
+    assert(cn_source_manager_lookup(manager, alt_path) == first);
+
+    cn_source_manager_free(manager);
+    printf("[PASS] test_source_manager_dedupe\n");
+}
+
+// 测试边界：整页大小的文件与空文件同样以 '\0' 结尾，缺失文件返回 NULL
+static void test_source_manager_edge_cases(void)
+{
+    size_t page_length = 4096;
+    char *page = (char *)malloc(page_length);
+    assert(page != NULL);
+    memset(page, 'a', page_length);
+    page[page_length - 1] = '\n';
+    write_file(PAGE_FILE, page, page_length);
+    write_file(EMPTY_FILE, NULL, 0);
+
+    CnSourceManager *manager = cn_source_manager_new();
+    assert(manager != NULL);
+
+    const CnSourceFile *file = cn_source_manager_load(manager, PAGE_FILE);
+    assert(file != NULL);
+    assert(file->length == page_length);
+    assert(memcmp(file->data, page, page_length) == 0);
+    assert(file->data[file->length] == '\0');
+
+    const CnSourceFile *empty = cn_source_manager_load(manager, EMPTY_FILE);
+    assert(empty != NULL);
+    assert(empty->length == 0);
+    assert(empty->data[0] == '\0');
+
+    assert(cn_source_manager_load(manager, "source_manager_test_missing.cn") == NULL);
+    assert(cn_source_manager_load(NULL, SMALL_FILE) == NULL);
+    assert(cn_source_manager_load(manager, NULL) == NULL);
+    cn_source_manager_free(NULL);
+
+    cn_source_manager_free(manager);
+    free(page);
+    printf("[PASS] test_source_manager_edge_cases\n");
+}
+
+// 测试大量文件触发哈希表扩容后仍能正确查找
+static void test_source_manager_many_files(void)
+{
+    enum { FILE_COUNT = 100 };
+    char path[64];
+
+    for (int i = 0; i < FILE_COUNT; i++) {
+        char content[32];
+        snprintf(path, sizeof(path), "source_manager_test_%d.cn", i);
+        snprintf(content, sizeof(content), "// 模块 %d\n", i);
+        write_file(path, content, strlen(content));
+    }
+
+    CnSourceManager *manager = cn_source_manager_new();
+    assert(manager != NULL);
+
+    for (int i = 0; i < FILE_COUNT; i++) {
+        snprintf(path, sizeof(path), "source_manager_test_%d.cn", i);
+        assert(cn_source_manager_load(manager, path) != NULL);
+    }
+    assert(manager->file_count == FILE_COUNT);
+
+    for (int i = 0; i < FILE_COUNT; i++) {
+        char expected[32];
+        snprintf(path, sizeof(path), "source_manager_test_%d.cn", i);
+        snprintf(expected, sizeof(expected), "// 模块 %d\n", i);
+        const CnSourceFile *file = cn_source_manager_lookup(manager, path);
+        assert(file != NULL);
+        assert(strcmp(file->data, expected) == 0);
+    }
+
+    cn_source_manager_free(manager);
+
+    for (int i = 0; i < FILE_COUNT; i++) {
+        snprintf(path, sizeof(path), "source_manager_test_%d.cn", i);
+        remove(path);
+    }
+    printf("[PASS] test_source_manager_many_files\n");
+}
+
+// 测试进程级共享管理器
+static void test_source_manager_default(void)
+{
+    CnSourceManager *shared = cn_source_manager_default();
+    assert(shared != NULL);
+    assert(cn_source_manager_default() == shared);
+
+    const CnSourceFile *file = cn_source_manager_load(shared, SMALL_FILE);
+    assert(file != NULL);
+
+    cn_source_manager_release_default();
+    printf("[PASS] test_source_manager_default\n");
+}
+
+int main(void)
+{
+    printf("=== 源文件管理器单元测试 ===\n");
+
+    test_source_manager_load();
+    test_source_manager_dedupe();
+    test_source_manager_edge_cases();
+    test_source_manager_many_files();
+    test_source_manager_default();
+
+    remove(SMALL_FILE);
+    remove(PAGE_FILE);
+    remove(EMPTY_FILE);
+
+    printf("=== 所有测试通过 ===\n");
+    return 0;
+}
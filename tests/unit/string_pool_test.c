@@ -0,0 +1,139 @@
+#include "cnlang/support/string_pool.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * 字符串驻留池单元测试
+ */
+
+// 测试相同内容返回同一指针，不同内容返回不同指针
+static void test_string_pool_intern(void)
+{
+    CnStringPool *pool = cn_string_pool_new();
+    assert(pool != NULL);
+
+    const char source[] = "计数器 + 计数器";
+    size_t word_length = strlen("计数器");
+
+    const char *first = cn_string_pool_intern(pool, source, word_length);
+    const char *second = cn_string_pool_intern(pool, source + strlen(source) - word_length, word_length);
+    const char *other = cn_string_pool_intern(pool, "总数", strlen("总数"));
+
+    assert(first != NULL);
+    assert(first == second);
+    assert(first != source);
+    assert(other != first);
+    assert(strcmp(first, "计数器") == 0);
+    assert(first[word_length] == '\0');
+    assert(cn_interned_hash(first) == cn_string_hash("计数器", word_length));
+
+    CnStringPoolStats stats;
+    cn_string_pool_get_stats(pool, &stats);
+    assert(stats.unique_count == 2);
+    assert(stats.intern_calls == 3);
+    assert(stats.hit_count == 1);
+    assert(stats.string_bytes == word_length + strlen("总数"));
+    assert(stats.arena_bytes > 0);
+
+    cn_string_pool_free(pool);
+    printf("[PASS] test_string_pool_intern\n");
+}
+
+// 测试只查找不插入
+static void test_string_pool_find(void)
+{
+    CnStringPool *pool = cn_string_pool_new();
+    assert(pool != NULL);
+
+    assert(cn_string_pool_find(pool, "值", strlen("值")) == NULL);
+    const char *value = cn_string_pool_intern(pool, "值", strlen("值"));
+    assert(cn_string_pool_find(pool, "值", strlen("值")) == value);
+    assert(cn_string_pool_find(pool, "值x", 1) == NULL);
+
+    // 空字符串同样可以驻留
+    const char *empty = cn_string_pool_intern(pool, "", 0);
+    assert(empty != NULL && empty[0] == '\0');
+    assert(cn_string_pool_intern(pool, NULL, 0) == empty);
+
+    assert(cn_string_pool_intern(NULL, "值", 1) == NULL);
+    assert(cn_string_pool_intern(pool, NULL, 3) == NULL);
+    cn_string_pool_free(NULL);
+
+    cn_string_pool_free(pool);
+    printf("[PASS] test_string_pool_find\n");
+}
+
+// 测试大量字符串触发哈希表扩容后指针保持稳定
+static void test_string_pool_growth(void)
+{
+    enum { NAME_COUNT = 5000 };
+    static const char *interned[NAME_COUNT];
+    char name[32];
+
+    CnStringPool *pool = cn_string_pool_new();
+    assert(pool != NULL);
+
+    for (int i = 0; i < NAME_COUNT; i++) {
+        snprintf(name, sizeof(name), "变量_%d", i);
+        interned[i] = cn_string_pool_intern(pool, name, strlen(name));
+        assert(interned[i] != NULL);
+    }
+
+    for (int i = 0; i < NAME_COUNT; i++) {
+        snprintf(name, sizeof(name), "变量_%d", i);
+        assert(cn_string_pool_intern(pool, name, strlen(name)) == interned[i]);
+        assert(strcmp(interned[i], name) == 0);
+    }
+
+    CnStringPoolStats stats;
+    cn_string_pool_get_stats(pool, &stats);
+    assert(stats.unique_count == NAME_COUNT);
+    assert(stats.hit_count == NAME_COUNT);
+    assert(stats.table_bytes >= NAME_COUNT * 2 * sizeof(CnInternSlot));
+
+    cn_string_pool_free(pool);
+    printf("[PASS] test_string_pool_growth\n");
+}
+
+// 测试名字比较辅助函数
+static void test_name_equals(void)
+{
+    const char *a = "长度";
+    char b[16];
+    strcpy(b, a);
+
+    assert(cn_name_equals(a, strlen(a), a, strlen(a)));
+    assert(cn_name_equals(a, strlen(a), b, strlen(b)));
+    assert(!cn_name_equals(a, strlen(a), b, 3));
+    assert(!cn_name_equals(a, 3, NULL, 3));
+    assert(cn_name_equals(NULL, 0, NULL, 0));
+
+    printf("[PASS] test_name_equals\n");
+}
+
+// 测试进程级共享字符串池
+static void test_string_pool_default(void)
+{
+    CnStringPool *shared = cn_string_pool_default();
+    assert(shared != NULL);
+    assert(cn_string_pool_default() == shared);
+    assert(cn_string_pool_intern(shared, "主程序", strlen("主程序")) != NULL);
+
+    cn_string_pool_release_default();
+    printf("[PASS] test_string_pool_default\n");
+}
+
+int main(void)
+{
+    printf("=== 字符串驻留池单元测试 ===\n");
+
+    test_string_pool_intern();
+    test_string_pool_find();
+    test_string_pool_growth();
+    test_name_equals();
+    test_string_pool_default();
+
+    printf("=== 所有测试通过 ===\n");
+    return 0;
+}
@@ -4,7 +4,7 @@
  *
  * 测试范围：
  * - 词法分析：模板关键字识别
- * - 模板实例化：类型映射表、缓存、注册表、名称修饰
+ * - 模板实例化：类型映射表、缓存（哈希索引、命中统计）、注册表、名称修饰
  * - 类型替换：类型替换基本功能
  *
  * @version 1.0
@@ -153,6 +153,7 @@ static void test_template_cache_operations(void) {
     /* 初始化实例化项 */
     instance->mangled_name = strdup("__cn_template_测试_整数");
     instance->mangled_name_length = strlen(instance->mangled_name);
+    instance->template_decl = NULL;
     instance->template_name = "测试";
     instance->template_name_length = strlen("测试");
     instance->type_args = NULL;
@@ -170,6 +171,164 @@ static void test_template_cache_operations(void) {
     cn_template_cache_free(cache);
 }
 
+/**
+ * @brief 测试模板缓存哈希索引
+ *
+ * 大量实例下仍能按 (模板名, 类型实参) 找回各自的实例；
+ * 名称相同的另一结构体类型对象视为同一实参，重复添加不产生新实例
+ */
+static void test_template_cache_hashed_lookup(void) {
+    TEST_BEGIN("模板实例化 - 模板缓存哈希索引");
+    
+    enum { INSTANCE_COUNT = 600 };
+    static char names[INSTANCE_COUNT][32];
+    CnTemplateCache *cache = cn_template_cache_new();
+    TEST_ASSERT(cache != NULL, "模板缓存创建成功");
+    if (!cache) return;
+    
+    CnType *int_type = cn_type_new_primitive(CN_TYPE_INT);
+    CnType *elem_type = cn_type_new_struct("元素", strlen("元素"), NULL, 0, NULL, NULL, 0);
+    CnType *elem_alias = cn_type_new_struct("元素", strlen("元素"), NULL, 0, NULL, NULL, 0);
+    
+    bool all_added = true;
+    for (size_t i = 0; i < INSTANCE_COUNT; i++) {
+        CnTemplateInstance *instance = (CnTemplateInstance *)calloc(1, sizeof(CnTemplateInstance));
+        CnType *args[2] = { int_type, cn_type_new_pointer(i % 2 ? elem_type : int_type) };
+        snprintf(names[i], sizeof(names[i]), "容器%zu", i / 2);
+        instance->template_name = names[i];
+        instance->template_name_length = strlen(names[i]);
+        instance->type_args = cn_type_array_copy(args, 2);
+        instance->type_arg_count = 2;
+        all_added = all_added && cn_template_cache_add(cache, instance);
+    }
+    TEST_ASSERT(all_added, "全部实例添加成功");
+    TEST_ASSERT(cache->instance_count == INSTANCE_COUNT, "缓存实例数量应为600");
+    
+    bool all_found = true;
+    for (size_t i = 0; i < INSTANCE_COUNT; i++) {
+        char name[32];
+        CnType *args[2] = { int_type, cn_type_new_pointer(i % 2 ? elem_alias : int_type) };
+        snprintf(name, sizeof(name), "容器%zu", i / 2);
+        all_found = all_found &&
+            cn_template_cache_find(cache, NULL, name, strlen(name), args, 2) == cache->instances[i];
+    }
+    TEST_ASSERT(all_found, "每个实例都能按模板名和等价类型实参找回");
+    
+    CnType *missing_args[2] = { int_type, int_type };
+    TEST_ASSERT(cn_template_cache_find(cache, NULL, "容器0", strlen("容器0"), missing_args, 2) == NULL,
+                "类型实参不同时不应命中");
+    
+    CnTemplateInstance *duplicate = (CnTemplateInstance *)calloc(1, sizeof(CnTemplateInstance));
+    CnType *dup_args[2] = { int_type, cn_type_new_pointer(elem_alias) };
+    duplicate->template_name = "容器0";
+    duplicate->template_name_length = strlen("容器0");
+    duplicate->type_args = dup_args;
+    duplicate->type_arg_count = 2;
+    TEST_ASSERT(cn_template_cache_add(cache, duplicate), "重复添加应视为成功");
+    TEST_ASSERT(cache->instance_count == INSTANCE_COUNT, "重复添加不产生新实例");
+    free(duplicate);
+    
+    cn_template_cache_free(cache);
+}
+
+/**
+ * @brief 测试实例化请求的缓存命中统计与共享缓存
+ */
+static void test_template_cache_hit_miss(void) {
+    TEST_BEGIN("模板实例化 - 缓存命中统计与共享缓存");
+    
+    CnTemplateCache *cache = cn_template_cache_default();
+    TEST_ASSERT(cache != NULL, "共享模板缓存创建成功");
+    TEST_ASSERT(cn_template_cache_default() == cache, "多次获取应返回同一共享缓存");
+    if (!cache) return;
+    
+    CnType *param_type = cn_type_new_struct("T", 1, NULL, 0, NULL, NULL, 0);
+    CnAstStructField field = { "值", strlen("值"), param_type, 0 };
+    CnAstStructDecl decl = { "盒子", strlen("盒子"), &field, 1 };
+    CnAstTemplateParam param = { "T", 1, NULL, NULL };
+    CnAstTemplateParams params = { &param, 1 };
+    CnAstTemplateStructDecl template_struct = { &params, &decl };
+    CnType *int_args[1] = { cn_type_new_primitive(CN_TYPE_INT) };
+    CnType *float_args[1] = { cn_type_new_primitive(CN_TYPE_FLOAT) };
+    
+    CnAstStructDecl *first = cn_template_instantiate_struct(&template_struct, int_args, 1, cache);
+    CnAstStructDecl *second = cn_template_instantiate_struct(&template_struct, int_args, 1, cache);
+    CnAstStructDecl *other = cn_template_instantiate_struct(&template_struct, float_args, 1, cache);
+    
+    TEST_ASSERT(first != NULL && first == second, "相同类型实参应复用缓存中的实例");
+    TEST_ASSERT(other != NULL && other != first, "不同类型实参应生成新实例");
+    TEST_ASSERT(first && first->fields[0].field_type->kind == CN_TYPE_INT, "字段类型应替换为整数");
+    TEST_ASSERT(cache->hit_count == 1, "缓存命中次数应为1");
+    TEST_ASSERT(cache->miss_count == 2, "缓存未命中次数应为2");
+    TEST_ASSERT(cache->instance_count == 2, "共享缓存中应有2个实例");
+    
+    /* 实例化结果归调用者所有，修饰名称由缓存释放 */
+    if (first) {
+        free(first->fields);
+        free(first);
+    }
+    if (other) {
+        free(other->fields);
+        free(other);
+    }
+    cn_template_cache_release_default();
+}
+
+/**
+ * @brief 测试共享缓存区分不同模块中的同名模板
+ *
+ * 两个模块各自声明模板结构体 盒子<T>，字段不同；以相同类型实参实例化时
+ * 应各得其实例，而非取到另一模块的实例
+ */
+static void test_template_cache_same_name_modules(void) {
+    TEST_BEGIN("模板实例化 - 共享缓存区分不同模块的同名模板");
+    
+    CnTemplateCache *cache = cn_template_cache_default();
+    TEST_ASSERT(cache != NULL, "共享模板缓存创建成功");
+    if (!cache) return;
+    
+    CnType *param_type = cn_type_new_struct("T", 1, NULL, 0, NULL, NULL, 0);
+    CnAstTemplateParam param = { "T", 1, NULL, NULL };
+    CnAstTemplateParams params = { &param, 1 };
+    
+    /* 模块甲：结构体 盒子<T> { T 值; } */
+    CnAstStructField field_a = { "值", strlen("值"), param_type, 0 };
+    CnAstStructDecl decl_a = { "盒子", strlen("盒子"), &field_a, 1 };
+    CnAstTemplateStructDecl module_a = { &params, &decl_a };
+    
+    /* 模块乙：结构体 盒子<T> { T* 指针; } */
+    CnAstStructField field_b = { "指针", strlen("指针"), cn_type_new_pointer(param_type), 0 };
+    CnAstStructDecl decl_b = { "盒子", strlen("盒子"), &field_b, 1 };
+    CnAstTemplateStructDecl module_b = { &params, &decl_b };
+    
+    CnType *int_args[1] = { cn_type_new_primitive(CN_TYPE_INT) };
+    
+    CnAstStructDecl *box_a = cn_template_instantiate_struct(&module_a, int_args, 1, cache);
+    CnAstStructDecl *box_b = cn_template_instantiate_struct(&module_b, int_args, 1, cache);
+    CnAstStructDecl *box_a_again = cn_template_instantiate_struct(&module_a, int_args, 1, cache);
+    CnAstStructDecl *box_b_again = cn_template_instantiate_struct(&module_b, int_args, 1, cache);
+    
+    TEST_ASSERT(box_a != NULL && box_b != NULL && box_a != box_b, "同名模板应各自实例化");
+    TEST_ASSERT(box_a && box_a->fields[0].field_type->kind == CN_TYPE_INT, "模块甲的实例字段应为整数");
+    TEST_ASSERT(box_b && box_b->fields[0].field_type->kind == CN_TYPE_POINTER, "模块乙的实例字段应为指针");
+    TEST_ASSERT(box_a_again == box_a && box_b_again == box_b, "再次实例化应命中各自模块的实例");
+    TEST_ASSERT(cache->instance_count == 2, "共享缓存中应有2个实例");
+    CnTemplateInstance *found = cn_template_cache_find(cache, &module_a, "盒子", strlen("盒子"), int_args, 1);
+    TEST_ASSERT(found && found->instantiated_struct == box_a, "按模板声明查找应取到模块甲的实例");
+    TEST_ASSERT(cn_template_cache_find(cache, NULL, "盒子", strlen("盒子"), int_args, 1) == NULL,
+                "不带模板声明的查找不应取到已登记声明的实例");
+    
+    if (box_a) {
+        free(box_a->fields);
+        free(box_a);
+    }
+    if (box_b) {
+        free(box_b->fields);
+        free(box_b);
+    }
+    cn_template_cache_release_default();
+}
+
 /**
  * @brief 测试模板注册表操作
  *
@@ -343,6 +502,7 @@ static void test_template_function_cgen(void) {
     /* 初始化实例化项 */
     instance->mangled_name = strdup("__cn_template_最大值_整数");
     instance->mangled_name_length = strlen(instance->mangled_name);
+    instance->template_decl = NULL;
     instance->template_name = "最大值";
     instance->template_name_length = strlen("最大值");
     instance->type_args = NULL;
@@ -377,6 +537,7 @@ static void test_template_struct_cgen(void) {
     /* 初始化实例化项 */
     instance->mangled_name = strdup("__cn_template_数组容器_整数");
     instance->mangled_name_length = strlen(instance->mangled_name);
+    instance->template_decl = NULL;
     instance->template_name = "数组容器";
     instance->template_name_length = strlen("数组容器");
     instance->type_args = NULL;
@@ -451,6 +612,9 @@ int main(void) {
     printf("--- 模板实例化测试 ---\n");
     test_type_map_operations();
     test_template_cache_operations();
+    test_template_cache_hashed_lookup();
+    test_template_cache_hit_miss();
+    test_template_cache_same_name_modules();
     test_template_registry_operations();
     test_name_mangling();
     printf("\n");
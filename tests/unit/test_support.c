@@ -0,0 +1,135 @@
+/**
+ * @file test_support.c
+ * @brief 单元测试共用的编译流水线辅助函数实现
+ */
+
+#include "test_support.h"
+
+#include "cnlang/frontend/lexer.h"
+#include "cnlang/frontend/parser.h"
+#include "cnlang/ir/irgen.h"
+#include "cnlang/ir/pass.h"
+#include "cnlang/backend/cgen.h"
+#include "cnlang/support/config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void cn_test_compilation_init(CnTestCompilation *compilation)
+{
+    memset(compilation, 0, sizeof(*compilation));
+    cn_support_diagnostics_init(&compilation->diagnostics);
+}
+
+void cn_test_compile(CnTestCompilation *compilation, const char *source, const char *filename)
+{
+    CnLexer lexer;
+    CnParser *parser;
+
+    cn_test_compilation_init(compilation);
+    cn_frontend_lexer_init(&lexer, source, strlen(source), filename);
+    parser = cn_frontend_parser_new(&lexer);
+    if (!parser) {
+        return;
+    }
+    cn_frontend_parser_set_diagnostics(parser, &compilation->diagnostics);
+    cn_frontend_parse_program(parser, &compilation->program);
+    cn_frontend_parser_free(parser);
+    if (!compilation->program || cn_support_diagnostics_error_count(&compilation->diagnostics) > 0) {
+        return;
+    }
+    cn_test_compile_program(compilation);
+}
+
+bool cn_test_compile_program(CnTestCompilation *compilation)
+{
+    compilation->global_scope = cn_sem_build_scopes(compilation->program, &compilation->diagnostics);
+    cn_sem_resolve_names(compilation->global_scope, compilation->program, &compilation->diagnostics);
+    cn_sem_check_types(compilation->global_scope, compilation->program, &compilation->diagnostics);
+    if (cn_support_diagnostics_error_count(&compilation->diagnostics) > 0) {
+        return false;
+    }
+
+    compilation->ir_module = cn_ir_gen_program(compilation->program, compilation->global_scope,
+                                               cn_support_target_triple_make(CN_TARGET_ARCH_X86_64, CN_TARGET_VENDOR_PC,
+                                                                             CN_TARGET_OS_NONE, CN_TARGET_ABI_ELF),
+                                               CN_COMPILE_MODE_HOSTED);
+    return compilation->ir_module != NULL;
+}
+
+void cn_test_compilation_free(CnTestCompilation *compilation)
+{
+    if (compilation->ir_module) {
+        cn_ir_module_free(compilation->ir_module);
+    }
+    if (compilation->global_scope) {
+        cn_sem_scope_free(compilation->global_scope);
+    }
+    cn_frontend_ast_program_free(compilation->program);
+    cn_support_diagnostics_free(&compilation->diagnostics);
+    memset(compilation, 0, sizeof(*compilation));
+}
+
+char *cn_test_generate_c(CnIrModule *ir_module, const char *output_path)
+{
+    char *c_code = NULL;
+
+    cn_ir_run_default_passes(ir_module);
+    if (cn_cgen_module_to_file(ir_module, output_path) == 0) {
+        c_code = cn_test_read_file(output_path);
+    }
+    remove(output_path);
+    return c_code;
+}
+
+char *cn_test_read_file(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    char *data = NULL;
+    long size;
+
+    if (!file) {
+        return NULL;
+    }
+    if (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+        data = (char *)malloc((size_t)size + 1);
+        if (data) {
+            data[fread(data, 1, (size_t)size, file)] = '\0';
+        }
+    }
+    fclose(file);
+    return data;
+}
+
+bool cn_test_write_file(const char *path, const unsigned char *data, size_t size)
+{
+    FILE *file = fopen(path, "wb");
+    bool ok;
+
+    if (!file) {
+        return false;
+    }
+    ok = fwrite(data, 1, size, file) == size;
+    return fclose(file) == 0 && ok;
+}
+
+bool cn_test_has_diagnostic(const CnDiagnostics *diagnostics, CnDiagCode code)
+{
+    for (size_t i = 0; i < diagnostics->count; i++) {
+        if (diagnostics->items[i].code == code) {
+            return true;
+        }
+    }
+    return false;
+}
+
+CnIrGlobalVar *cn_test_find_global(CnIrModule *ir_module, const char *name)
+{
+    for (CnIrGlobalVar *global = ir_module->first_global; global; global = global->next) {
+        if (global->name && strcmp(global->name, name) == 0) {
+            return global;
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file test_support.h
+ * @brief 单元测试共用的断言宏与编译流水线辅助函数
+ *
+ * 解析、语义分析、IR 生成与 C 代码生成的完整流程，以及读写文件、
+ * 查找诊断和全局变量等小工具，供需要走完编译流程的单元测试共用。
+ */
+
+#ifndef CN_TESTS_UNIT_TEST_SUPPORT_H
+#define CN_TESTS_UNIT_TEST_SUPPORT_H
+
+#include "cnlang/frontend/ast.h"
+#include "cnlang/frontend/semantics.h"
+#include "cnlang/support/diagnostics.h"
+#include "cnlang/ir/ir.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * @brief 断言条件成立，否则记录失败并从当前（无返回值的）测试函数返回
+ *
+ * 与 TEST_PASS 一样，计数器 tests_passed / tests_failed 由包含本文件的测试定义
+ */
+#define TEST_ASSERT(cond, msg) do { \
+    if (!(cond)) { \
+        printf("    [FAIL] %s\n", msg); \
+        tests_failed++; \
+        return; \
+    } \
+} while(0)
+
+#define TEST_PASS(name) do { \
+    printf("    [PASS] %s\n", name); \
+    tests_passed++; \
+} while(0)
+
+/**
+ * @brief 一次编译的中间结果
+ *
+ * 各阶段失败时其后的字段保持 NULL，诊断信息记录在 diagnostics 中
+ */
+typedef struct CnTestCompilation {
+    CnDiagnostics diagnostics;
+    CnAstProgram *program;
+    CnSemScope *global_scope;
+    CnIrModule *ir_module;
+} CnTestCompilation;
+
+/**
+ * @brief 初始化编译结果（诊断信息为空，其余字段为 NULL）
+ */
+void cn_test_compilation_init(CnTestCompilation *compilation);
+
+/**
+ * @brief 解析源码并继续语义分析与 IR 生成（不运行优化）
+ * @param filename 源文件名，用于诊断信息与相对路径的资源查找
+ */
+void cn_test_compile(CnTestCompilation *compilation, const char *source, const char *filename);
+
+/**
+ * @brief 对 compilation->program 做语义分析并生成 IR（不运行优化）
+ * @return 生成了 IR 返回 true
+ */
+bool cn_test_compile_program(CnTestCompilation *compilation);
+
+/**
+ * @brief 释放编译结果中的 IR、作用域、AST 与诊断信息
+ */
+void cn_test_compilation_free(CnTestCompilation *compilation);
+
+/**
+ * @brief 运行默认优化并生成 C 代码
+ * @param output_path 生成 C 代码的临时文件，读回后删除
+ * @return 生成的 C 代码（调用者释放），失败返回 NULL
+ */
+char *cn_test_generate_c(CnIrModule *ir_module, const char *output_path);
+
+/**
+ * @brief 读入整个文件并以 '\0' 结尾（调用者释放），失败返回 NULL
+ */
+char *cn_test_read_file(const char *path);
+
+/**
+ * @brief 将 size 字节写入文件
+ */
+bool cn_test_write_file(const char *path, const unsigned char *data, size_t size);
+
+/**
+ * @brief 诊断信息中是否有指定错误码
+ */
+bool cn_test_has_diagnostic(const CnDiagnostics *diagnostics, CnDiagCode code);
+
+/**
+ * @brief 按名称查找 IR 全局变量，未找到返回 NULL
+ */
+CnIrGlobalVar *cn_test_find_global(CnIrModule *ir_module, const char *name);
+
+#endif /* CN_TESTS_UNIT_TEST_SUPPORT_H */